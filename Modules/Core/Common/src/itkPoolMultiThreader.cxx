@@ -208,6 +208,7 @@ PoolMultiThreader::ParallelizeArray(SizeValueType             firstIndex,
             filter->IncrementProgress(0);
           }
         } while (status != std::future_status::ready);
+        m_ThreadInfoArray[i].Future.get();
         reporter.CompletedPixel();
       });
     }
@@ -101,6 +101,21 @@ itkMultiThreaderExceptionsTest(int, char *[])
       dummySrc->SetExceptionIndex(i);
       ITK_TRY_EXPECT_EXCEPTION(dummySrc->Update());
     }
+
+    // An exception thrown by a work unit of ParallelizeArray, whether it is
+    // run by the calling thread or by another one, reaches the caller.
+    const itk::MultiThreaderBase::Pointer threader = itk::MultiThreaderBase::New();
+    threader->SetNumberOfWorkUnits(4);
+    for (const itk::SizeValueType exceptionIndex : { 0, 37, 99 })
+    {
+      const auto func = [exceptionIndex](itk::SizeValueType index) {
+        if (index == exceptionIndex)
+        {
+          itkGenericExceptionMacro("Error at index " << index);
+        }
+      };
+      ITK_TRY_EXPECT_EXCEPTION(threader->ParallelizeArray(0, 100, func, nullptr));
+    }
   }
   std::cout << "Test PASSED!" << std::endl;
   return EXIT_SUCCESS;
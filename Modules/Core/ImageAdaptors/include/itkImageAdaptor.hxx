@@ -327,11 +327,11 @@ template <typename TImage, typename TAccessor>
 void
 ImageAdaptor<TImage, TAccessor>::SetBufferedRegion(const RegionType & region)
 {
-  // call the superclass' method first, then delegate
-  Superclass::SetBufferedRegion(region);
-
-  // delegation to internal image
+  // delegate first: the superclass computes the offset table from
+  // GetBufferedRegion(), which returns the region of the internal image
   m_Image->SetBufferedRegion(region);
+
+  Superclass::SetBufferedRegion(region);
 }
 
 template <typename TImage, typename TAccessor>
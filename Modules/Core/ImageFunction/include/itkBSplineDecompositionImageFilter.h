@@ -57,6 +57,9 @@ namespace itk
  *        February 1993.
  * And code obtained from bigwww.epfl.ch by Philippe Thevenaz
  *
+ * The lines of every dimension are filtered in parallel, several neighboring
+ * lines at a time.
+ *
  * Limitations:  Spline order must be between 0 and 5.
  *               Spline order must be set before setting the image.
  *               Uses mirror boundary conditions.
@@ -66,7 +69,6 @@ namespace itk
  * \sa BSplineResampleImageFunction
  *
  * \ingroup ImageFilters
- * \ingroup SingleThreaded
  * \ingroup CannotBeStreamed
  * \ingroup ITKImageFunction
  */
@@ -146,53 +148,37 @@ protected:
   EnlargeOutputRequestedRegion(DataObject * output) override;
 
 private:
-  using CoefficientsVectorType = std::vector<CoeffType>;
-
   /** Determines the poles given the Spline Order. */
   virtual void
   SetPoles();
 
-  /** Converts a vector of data to a vector of Spline coefficients. */
-  virtual bool
-  DataToCoefficients1D();
-
-  /** Converts an N-dimension image of data to an equivalent sized image
-   *    of spline coefficients. */
+  /** Converts numberOfLines lines of data of the given length to spline
+   * coefficients, in place. The lines are interleaved: the value n of the line
+   * b is at coefficients[n * numberOfLines + b], so that the recursions are run
+   * on all the lines at once. */
   void
-  DataToCoefficientsND();
+  DataToCoefficients(CoeffType * coefficients, SizeValueType numberOfLines, SizeValueType length) const;
 
   /** Determines the first coefficient for the causal filtering of the data. */
-  virtual void
-  SetInitialCausalCoefficient(double z);
+  void
+  SetInitialCausalCoefficient(CoeffType *   coefficients,
+                              SizeValueType numberOfLines,
+                              SizeValueType length,
+                              double        z) const;
 
   /** Determines the first coefficient for the anti-causal filtering of the
     data. */
-  virtual void
-  SetInitialAntiCausalCoefficient(double z);
+  void
+  SetInitialAntiCausalCoefficient(CoeffType *   coefficients,
+                                  SizeValueType numberOfLines,
+                                  SizeValueType length,
+                                  double        z) const;
 
   /** Copy the input image into the output image.
    *  Used to initialize the Coefficients image before calculation. */
   void
   CopyImageToImage();
 
-  /** Copies a vector of data from the Coefficients image (one line of the
-   *  output image) to the scratch. */
-  void
-  CopyCoefficientsToScratch(OutputLinearIterator &);
-
-  /** Copies a vector of data from the scratch to the Coefficients image
-   *  (one line of the output image). */
-  void
-  CopyScratchToCoefficients(OutputLinearIterator &);
-
-  // Variables needed by the smoothing spline routine.
-
-  /** Temporary storage for processing of Coefficients. */
-  CoefficientsVectorType m_Scratch{};
-
-  /** Image size. */
-  typename TInputImage::SizeType m_DataLength{};
-
   /** User specified spline order (3rd or cubic is the default). */
   unsigned int m_SplineOrder{ 0 };
 
@@ -202,9 +188,6 @@ private:
 
   /** Tolerance used for determining initial causal coefficient. Default is 1e-10.*/
   double m_Tolerance{ 1e-10 };
-
-  /** Direction for iterator incrementing. Default is 0. */
-  unsigned int m_IteratorDirection{ 0 };
 };
 } // namespace itk
 
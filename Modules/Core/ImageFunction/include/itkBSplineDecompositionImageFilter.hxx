@@ -28,7 +28,7 @@
 #ifndef itkBSplineDecompositionImageFilter_hxx
 #define itkBSplineDecompositionImageFilter_hxx
 #include "itkImageAlgorithm.h"
-#include "itkProgressReporter.h"
+#include "itkTotalProgressReporter.h"
 #include "itkVector.h"
 #include "itkPrintHelper.h"
 
@@ -40,13 +40,6 @@ BSplineDecompositionImageFilter<TInputImage, TOutputImage>::BSplineDecomposition
 
 {
   this->SetSplineOrder(3);
-
-  for (unsigned int i = 0; i < m_Scratch.size(); ++i)
-  {
-    m_Scratch[i] = 0;
-  }
-
-  m_DataLength.Fill(typename TInputImage::SizeType::SizeValueType{});
 }
 
 template <typename TInputImage, typename TOutputImage>
@@ -57,29 +50,23 @@ BSplineDecompositionImageFilter<TInputImage, TOutputImage>::PrintSelf(std::ostre
 
   Superclass::PrintSelf(os, indent);
 
-  os << indent << "Scratch: " << m_Scratch << std::endl;
-  os << indent << "Data Length: " << m_DataLength << std::endl;
   os << indent << "Spline Order: " << m_SplineOrder << std::endl;
   os << indent << "SplinePoles: " << m_SplinePoles << std::endl;
   os << indent << "Number Of Poles: " << m_NumberOfPoles << std::endl;
   os << indent << "Tolerance: " << m_Tolerance << std::endl;
-  os << indent << "Iterator Direction: " << m_IteratorDirection << std::endl;
 }
 
 template <typename TInputImage, typename TOutputImage>
-bool
-BSplineDecompositionImageFilter<TInputImage, TOutputImage>::DataToCoefficients1D()
+void
+BSplineDecompositionImageFilter<TInputImage, TOutputImage>::DataToCoefficients(CoeffType *   coefficients,
+                                                                               SizeValueType numberOfLines,
+                                                                               SizeValueType length) const
 {
   // See Unser, 1993, Part II, Equation 2.5,
   // or Unser, 1999, Box 2. for an explanation.
 
   double c0 = 1.0;
 
-  if (m_DataLength[m_IteratorDirection] == 1) // Required by mirror boundaries
-  {
-    return false;
-  }
-
   // Compute over all gain
   for (unsigned int k = 0; k < m_NumberOfPoles; ++k)
   {
@@ -88,31 +75,42 @@ BSplineDecompositionImageFilter<TInputImage, TOutputImage>::DataToCoefficients1D
   }
 
   // Apply the gain
-  for (unsigned int n = 0; n < m_DataLength[m_IteratorDirection]; ++n)
+  for (SizeValueType i = 0; i < length * numberOfLines; ++i)
   {
-    m_Scratch[n] *= c0;
+    coefficients[i] *= c0;
   }
 
   // Loop over all poles
   for (unsigned int k = 0; k < m_NumberOfPoles; ++k)
   {
+    const double z = m_SplinePoles[k];
+
     // Causal initialization
-    this->SetInitialCausalCoefficient(m_SplinePoles[k]);
+    this->SetInitialCausalCoefficient(coefficients, numberOfLines, length, z);
     // Causal recursion
-    for (unsigned int n = 1; n < m_DataLength[m_IteratorDirection]; ++n)
+    for (SizeValueType n = 1; n < length; ++n)
     {
-      m_Scratch[n] += m_SplinePoles[k] * m_Scratch[n - 1];
+      CoeffType *       current = coefficients + n * numberOfLines;
+      const CoeffType * previous = current - numberOfLines;
+      for (SizeValueType b = 0; b < numberOfLines; ++b)
+      {
+        current[b] += z * previous[b];
+      }
     }
 
     // anticausal initialization
-    this->SetInitialAntiCausalCoefficient(m_SplinePoles[k]);
+    this->SetInitialAntiCausalCoefficient(coefficients, numberOfLines, length, z);
     // anticausal recursion
-    for (int n = m_DataLength[m_IteratorDirection] - 2; 0 <= n; n--)
+    for (SizeValueType n = length - 1; n-- > 0;)
     {
-      m_Scratch[n] = m_SplinePoles[k] * (m_Scratch[n + 1] - m_Scratch[n]);
+      CoeffType *       current = coefficients + n * numberOfLines;
+      const CoeffType * next = current + numberOfLines;
+      for (SizeValueType b = 0; b < numberOfLines; ++b)
+      {
+        current[b] = z * (next[b] - current[b]);
+      }
     }
   }
-  return true;
 }
 
 template <typename TInputImage, typename TOutputImage>
@@ -175,96 +173,76 @@ BSplineDecompositionImageFilter<TInputImage, TOutputImage>::SetPoles()
 
 template <typename TInputImage, typename TOutputImage>
 void
-BSplineDecompositionImageFilter<TInputImage, TOutputImage>::SetInitialCausalCoefficient(double z)
+BSplineDecompositionImageFilter<TInputImage, TOutputImage>::SetInitialCausalCoefficient(CoeffType *   coefficients,
+                                                                                        SizeValueType numberOfLines,
+                                                                                        SizeValueType length,
+                                                                                        double        z) const
 {
   // See Unser, 1999, Box 2 for explanation
 
   // Yhis initialization corresponds to mirror boundaries
-  typename TInputImage::SizeValueType horizon = m_DataLength[m_IteratorDirection];
-  double                              zn = z;
+  SizeValueType horizon = length;
+  double        zn = z;
   if (m_Tolerance > 0.0)
   {
-    horizon = (typename TInputImage::SizeValueType)std::ceil(std::log(m_Tolerance) / std::log(itk::Math::abs(z)));
+    horizon = static_cast<SizeValueType>(std::ceil(std::log(m_Tolerance) / std::log(itk::Math::abs(z))));
   }
-  if (horizon < m_DataLength[m_IteratorDirection])
+  if (horizon < length)
   {
     // Accelerated loop
-    CoeffType sum = m_Scratch[0]; // verify this
-    for (unsigned int n = 1; n < horizon; ++n)
+    for (SizeValueType n = 1; n < horizon; ++n)
     {
-      sum += zn * m_Scratch[n];
+      const CoeffType * line = coefficients + n * numberOfLines;
+      for (SizeValueType b = 0; b < numberOfLines; ++b)
+      {
+        coefficients[b] += zn * line[b];
+      }
       zn *= z;
     }
-    m_Scratch[0] = sum;
   }
   else
   {
     // Full loop
-    const double iz = 1.0 / z;
-    double       z2n = std::pow(z, static_cast<double>(m_DataLength[m_IteratorDirection] - 1L));
-    CoeffType    sum = m_Scratch[0] + z2n * m_Scratch[m_DataLength[m_IteratorDirection] - 1L];
+    const double      iz = 1.0 / z;
+    double            z2n = std::pow(z, static_cast<double>(length - 1L));
+    const CoeffType * last = coefficients + (length - 1) * numberOfLines;
+    for (SizeValueType b = 0; b < numberOfLines; ++b)
+    {
+      coefficients[b] = coefficients[b] + z2n * last[b];
+    }
     z2n *= z2n * iz;
-    for (unsigned int n = 1; n <= (m_DataLength[m_IteratorDirection] - 2); ++n)
+    for (SizeValueType n = 1; n + 1 < length; ++n)
     {
-      sum += (zn + z2n) * m_Scratch[n];
+      const CoeffType * line = coefficients + n * numberOfLines;
+      for (SizeValueType b = 0; b < numberOfLines; ++b)
+      {
+        coefficients[b] += (zn + z2n) * line[b];
+      }
       zn *= z;
       z2n *= iz;
     }
-    m_Scratch[0] = sum / (1.0 - zn * zn);
+    for (SizeValueType b = 0; b < numberOfLines; ++b)
+    {
+      coefficients[b] = coefficients[b] / (1.0 - zn * zn);
+    }
   }
 }
 
 template <typename TInputImage, typename TOutputImage>
 void
-BSplineDecompositionImageFilter<TInputImage, TOutputImage>::SetInitialAntiCausalCoefficient(double z)
+BSplineDecompositionImageFilter<TInputImage, TOutputImage>::SetInitialAntiCausalCoefficient(CoeffType *   coefficients,
+                                                                                            SizeValueType numberOfLines,
+                                                                                            SizeValueType length,
+                                                                                            double        z) const
 {
   // This initialization corresponds to mirror boundaries.
   // See Unser, 1999, Box 2 for explanation.
   // Also see erratum at http://bigwww.epfl.ch/publications/unser9902.html
-  m_Scratch[m_DataLength[m_IteratorDirection] - 1] =
-    (z / (z * z - 1.0)) *
-    (z * m_Scratch[m_DataLength[m_IteratorDirection] - 2] + m_Scratch[m_DataLength[m_IteratorDirection] - 1]);
-}
-
-template <typename TInputImage, typename TOutputImage>
-void
-BSplineDecompositionImageFilter<TInputImage, TOutputImage>::DataToCoefficientsND()
-{
-  const OutputImagePointer output = this->GetOutput();
-
-  Size<ImageDimension> size = output->GetBufferedRegion().GetSize();
-
-  const unsigned int count = output->GetBufferedRegion().GetNumberOfPixels() / size[0] * ImageDimension;
-
-  ProgressReporter progress(this, 0, count, 10);
-
-  // Initialize coefficient array
-  this->CopyImageToImage(); // Coefficients are initialized to the input data
-
-  // Loop through each dimension
-  for (unsigned int n = 0; n < ImageDimension; ++n)
+  CoeffType *       last = coefficients + (length - 1) * numberOfLines;
+  const CoeffType * previous = last - numberOfLines;
+  for (SizeValueType b = 0; b < numberOfLines; ++b)
   {
-    m_IteratorDirection = n;
-
-    // Initialize iterators
-    OutputLinearIterator CIterator(output, output->GetBufferedRegion());
-    CIterator.SetDirection(m_IteratorDirection);
-    // For each data vector
-    while (!CIterator.IsAtEnd())
-    {
-      // Copy coefficients to scratch
-      this->CopyCoefficientsToScratch(CIterator);
-
-      // Perform 1D BSpline calculations
-      this->DataToCoefficients1D();
-
-      // Copy scratch back to coefficients.
-      // Brings us back to the end of the line we were working on.
-      CIterator.GoToBeginOfLine();
-      this->CopyScratchToCoefficients(CIterator); // m_Scratch = m_Image;
-      CIterator.NextLine();
-      progress.CompletedPixel();
-    }
+    last[b] = (z / (z * z - 1.0)) * (z * previous[b] + last[b]);
   }
 }
 
@@ -277,36 +255,6 @@ BSplineDecompositionImageFilter<TInputImage, TOutputImage>::CopyImageToImage()
   ImageAlgorithm::Copy(inputImage, outputImage, inputImage->GetBufferedRegion(), outputImage->GetBufferedRegion());
 }
 
-template <typename TInputImage, typename TOutputImage>
-void
-BSplineDecompositionImageFilter<TInputImage, TOutputImage>::CopyScratchToCoefficients(OutputLinearIterator & Iter)
-{
-  using OutputPixelType = typename TOutputImage::PixelType;
-  typename TOutputImage::SizeValueType j = 0;
-  while (!Iter.IsAtEndOfLine())
-  {
-    Iter.Set(static_cast<OutputPixelType>(m_Scratch[j]));
-    ++Iter;
-    ++j;
-  }
-}
-
-/**
- */
-template <typename TInputImage, typename TOutputImage>
-void
-BSplineDecompositionImageFilter<TInputImage, TOutputImage>::CopyCoefficientsToScratch(OutputLinearIterator & Iter)
-{
-  typename TOutputImage::SizeValueType j = 0;
-
-  while (!Iter.IsAtEndOfLine())
-  {
-    m_Scratch[j] = static_cast<CoeffType>(Iter.Get());
-    ++Iter;
-    ++j;
-  }
-}
-
 template <typename TInputImage, typename TOutputImage>
 void
 BSplineDecompositionImageFilter<TInputImage, TOutputImage>::GenerateInputRequestedRegion()
@@ -336,31 +284,94 @@ template <typename TInputImage, typename TOutputImage>
 void
 BSplineDecompositionImageFilter<TInputImage, TOutputImage>::GenerateData()
 {
-  // Allocate scratch memory
-  const InputImageConstPointer inputPtr = this->GetInput();
+  // Allocate memory for output image
+  const OutputImagePointer outputPtr = this->GetOutput();
+  outputPtr->SetBufferedRegion(outputPtr->GetRequestedRegion());
+  outputPtr->Allocate();
+
+  // Initialize coefficient array
+  this->CopyImageToImage(); // Coefficients are initialized to the input data
 
-  m_DataLength = inputPtr->GetBufferedRegion().GetSize();
+  if (m_NumberOfPoles == 0)
+  {
+    // the coefficients of the splines of order 0 and 1 are the data
+    return;
+  }
 
-  typename TOutputImage::SizeValueType maxLength = 0;
+  using OutputPixelType = typename TOutputImage::PixelType;
+  OutputPixelType * const               buffer = outputPtr->GetBufferPointer();
+  const OffsetValueType * const         offsetTable = outputPtr->GetOffsetTable();
+  const typename TOutputImage::SizeType size = outputPtr->GetBufferedRegion().GetSize();
+  const SizeValueType                   numberOfPixels = outputPtr->GetBufferedRegion().GetNumberOfPixels();
+
+  // The lines along a dimension are filtered by groups of neighbors along
+  // another dimension, in which the values at a given position in the lines
+  // are close in memory.
+  constexpr SizeValueType maximumNumberOfLines = 8;
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+
+  // Loop through each dimension
   for (unsigned int n = 0; n < ImageDimension; ++n)
   {
-    if (m_DataLength[n] > maxLength)
+    const SizeValueType length = size[n];
+    if (length == 1 || numberOfPixels == 0) // Required by mirror boundaries
     {
-      maxLength = m_DataLength[n];
+      continue;
     }
-  }
-  m_Scratch.resize(maxLength);
-
-  // Allocate memory for output image
-  const OutputImagePointer outputPtr = this->GetOutput();
-  outputPtr->SetBufferedRegion(outputPtr->GetRequestedRegion());
-  outputPtr->Allocate();
 
-  // Calculate actual output
-  this->DataToCoefficientsND();
-
-  // Clean up
-  m_Scratch.clear();
+    const unsigned int    neighborDimension = n == 0 ? 1 : 0;
+    const SizeValueType   numberOfNeighbors = ImageDimension > 1 ? size[neighborDimension] : 1;
+    const SizeValueType   numberOfGroups = numberOfPixels / (length * numberOfNeighbors);
+    const OffsetValueType stride = offsetTable[n];
+    const OffsetValueType neighborStride = offsetTable[neighborDimension];
+
+    this->GetMultiThreader()->ParallelizeArray(
+      0,
+      numberOfGroups,
+      [&](SizeValueType group) {
+        // offset of the first line of the group
+        OffsetValueType first = 0;
+        for (unsigned int d = 0; d < ImageDimension; ++d)
+        {
+          if (d != n && d != neighborDimension)
+          {
+            first += static_cast<OffsetValueType>(group % size[d]) * offsetTable[d];
+            group /= size[d];
+          }
+        }
+
+        TotalProgressReporter  progress(this, numberOfPixels / length * ImageDimension);
+        std::vector<CoeffType> coefficients(length * std::min(numberOfNeighbors, maximumNumberOfLines));
+        for (SizeValueType neighbor = 0; neighbor < numberOfNeighbors; neighbor += maximumNumberOfLines)
+        {
+          const SizeValueType numberOfLines = std::min(numberOfNeighbors - neighbor, maximumNumberOfLines);
+          OutputPixelType *   lines = buffer + first + static_cast<OffsetValueType>(neighbor) * neighborStride;
+
+          for (SizeValueType i = 0; i < length; ++i)
+          {
+            const OutputPixelType * pixel = lines + static_cast<OffsetValueType>(i) * stride;
+            for (SizeValueType b = 0; b < numberOfLines; ++b, pixel += neighborStride)
+            {
+              coefficients[i * numberOfLines + b] = static_cast<CoeffType>(*pixel);
+            }
+          }
+
+          this->DataToCoefficients(coefficients.data(), numberOfLines, length);
+
+          for (SizeValueType i = 0; i < length; ++i)
+          {
+            OutputPixelType * pixel = lines + static_cast<OffsetValueType>(i) * stride;
+            for (SizeValueType b = 0; b < numberOfLines; ++b, pixel += neighborStride)
+            {
+              *pixel = static_cast<OutputPixelType>(coefficients[i * numberOfLines + b]);
+            }
+          }
+          progress.Completed(numberOfLines);
+        }
+      },
+      nullptr);
+  }
 }
 } // namespace itk
 
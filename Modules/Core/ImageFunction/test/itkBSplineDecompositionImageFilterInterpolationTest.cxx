@@ -0,0 +1,163 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBSplineDecompositionImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkIndexRange.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<float, Dimension>;
+using CoefficientImageType = itk::Image<double, Dimension>;
+using FilterType = itk::BSplineDecompositionImageFilter<ImageType, CoefficientImageType>;
+
+// Values of the B-spline of the given order at the integers -2 to 2.
+std::vector<double>
+SplineAtIntegers(unsigned int splineOrder)
+{
+  switch (splineOrder)
+  {
+    case 2:
+      return { 0.0, 1.0 / 8.0, 6.0 / 8.0, 1.0 / 8.0, 0.0 };
+    case 3:
+      return { 0.0, 1.0 / 6.0, 4.0 / 6.0, 1.0 / 6.0, 0.0 };
+    case 4:
+      return { 1.0 / 384.0, 76.0 / 384.0, 230.0 / 384.0, 76.0 / 384.0, 1.0 / 384.0 };
+    case 5:
+      return { 1.0 / 120.0, 26.0 / 120.0, 66.0 / 120.0, 26.0 / 120.0, 1.0 / 120.0 };
+    default:
+      return { 0.0, 0.0, 1.0, 0.0, 0.0 };
+  }
+}
+
+// Index of the coefficient of the mirror boundary condition.
+itk::IndexValueType
+Mirror(itk::IndexValueType index, itk::IndexValueType size)
+{
+  if (size == 1)
+  {
+    return 0;
+  }
+  const itk::IndexValueType period = 2 * (size - 1);
+  index = std::abs(index) % period;
+  return index < size ? index : period - index;
+}
+
+// Evaluates the spline at the grid points, which must give back the samples.
+bool
+InterpolatesSamples(const ImageType * image, const CoefficientImageType * coefficients, unsigned int splineOrder)
+{
+  const std::vector<double>   weights = SplineAtIntegers(splineOrder);
+  const ImageType::SizeType & size = image->GetLargestPossibleRegion().GetSize();
+
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd();
+       ++it)
+  {
+    double value = 0.0;
+    for (const ImageType::IndexType & k : itk::ZeroBasedIndexRange<Dimension>(ImageType::SizeType::Filled(5)))
+    {
+      double               weight = 1.0;
+      ImageType::IndexType index;
+      for (unsigned int d = 0; d < Dimension; ++d)
+      {
+        weight *= weights[k[d]];
+        index[d] = Mirror(it.GetIndex()[d] + k[d] - 2, size[d]);
+      }
+      value += weight * coefficients->GetPixel(index);
+    }
+    if (std::abs(value - it.Get()) > 1e-5 * (1.0 + std::abs(it.Get())))
+    {
+      std::cerr << "Spline of order " << splineOrder << " at " << it.GetIndex() << " is " << value << " instead of "
+                << it.Get() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkBSplineDecompositionImageFilterInterpolationTest(int, char *[])
+{
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 21, 13, 10 } });
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType & index = it.GetIndex();
+    it.Set(static_cast<float>((index[0] * 7 + index[1] * index[1] * 3 + index[2] * 11) % 23) - 10.0f);
+  }
+
+  // An image with a single line along the first dimension.
+  auto flatImage = ImageType::New();
+  flatImage->SetRegions(ImageType::SizeType{ { 1, 9, 1 } });
+  flatImage->Allocate();
+  flatImage->FillBuffer(1.0f);
+  flatImage->SetPixel({ { 0, 4, 0 } }, 5.0f);
+
+  bool success = true;
+  for (unsigned int splineOrder = 0; splineOrder <= 5; ++splineOrder)
+  {
+    auto sequential = FilterType::New();
+    sequential->SetInput(image);
+    sequential->SetSplineOrder(splineOrder);
+    sequential->SetNumberOfWorkUnits(1);
+    ITK_TRY_EXPECT_NO_EXCEPTION(sequential->Update());
+    success &= InterpolatesSamples(image, sequential->GetOutput(), splineOrder);
+
+    for (const unsigned int numberOfWorkUnits : { 2, 5 })
+    {
+      auto parallel = FilterType::New();
+      parallel->SetInput(image);
+      parallel->SetSplineOrder(splineOrder);
+      parallel->SetNumberOfWorkUnits(numberOfWorkUnits);
+      ITK_TRY_EXPECT_NO_EXCEPTION(parallel->Update());
+
+      itk::ImageRegionConstIterator<CoefficientImageType> sIt(sequential->GetOutput(),
+                                                              sequential->GetOutput()->GetBufferedRegion());
+      itk::ImageRegionConstIterator<CoefficientImageType> pIt(parallel->GetOutput(),
+                                                              parallel->GetOutput()->GetBufferedRegion());
+      for (; !sIt.IsAtEnd(); ++sIt, ++pIt)
+      {
+        if (sIt.Get() != pIt.Get())
+        {
+          std::cerr << "Coefficients computed with " << numberOfWorkUnits << " work units differ." << std::endl;
+          success = false;
+          break;
+        }
+      }
+    }
+
+    auto flatFilter = FilterType::New();
+    flatFilter->SetInput(flatImage);
+    flatFilter->SetSplineOrder(splineOrder);
+    ITK_TRY_EXPECT_NO_EXCEPTION(flatFilter->Update());
+    success &= InterpolatesSamples(flatImage, flatFilter->GetOutput(), splineOrder);
+  }
+
+  if (!success)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -111,6 +111,20 @@ public:
   itkSetMacro(SizeGreatestPrimeFactor, SizeValueType);
   itkGetMacro(SizeGreatestPrimeFactor, SizeValueType);
 
+  /** Set/Get the size of the output tiles computed independently.
+   *
+   * By default the tile size is zero, and the whole requested region,
+   * padded by the kernel radius, is transformed at once. Otherwise the
+   * output is computed by overlap-save: each tile, padded by the kernel
+   * radius, is transformed on its own and multiplied by a kernel spectrum
+   * computed once for all the tiles, and the tiles are processed in
+   * parallel. The memory used by the Fourier transforms then depends on the
+   * tile size instead of the image size. A zero component means the whole
+   * requested region along that dimension. Tiles a few times larger than
+   * the kernel are usually a good choice. */
+  itkSetMacro(TileSize, OutputSizeType);
+  itkGetConstReferenceMacro(TileSize, OutputSizeType);
+
 protected:
   FFTConvolutionImageFilter();
   ~FFTConvolutionImageFilter() override = default;
@@ -133,6 +147,10 @@ protected:
   void
   GenerateData() override;
 
+  /** Compute the output tile by tile when a TileSize is set. */
+  void
+  GenerateTiledData();
+
   /** Prepare the input images for operations in the Fourier
    * domain. This includes resizing the input and kernel images,
    * normalizing the kernel if requested, shifting the kernel, and
@@ -207,6 +225,7 @@ protected:
 
 private:
   SizeValueType      m_SizeGreatestPrimeFactor{};
+  OutputSizeType     m_TileSize{ { 0 } };
   InternalSizeType   m_FFTPadSize{ { 0 } };
   InternalRegionType m_PaddedInputRegion{};
 };
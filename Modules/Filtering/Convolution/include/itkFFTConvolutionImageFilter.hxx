@@ -25,11 +25,14 @@
 #include "itkCyclicShiftImageFilter.h"
 #include "itkExtractImageFilter.h"
 #include "itkFFTPadImageFilter.h"
+#include "itkImageAlgorithm.h"
 #include "itkImageBase.h"
+#include "itkImageRegionIteratorWithIndex.h"
 #include "itkMultiplyImageFilter.h"
 #include "itkNormalizeToConstantImageFilter.h"
 #include "itkMath.h"
 #include "itkRegionOfInterestImageFilter.h"
+#include "itkTotalProgressReporter.h"
 
 namespace itk
 {
@@ -82,6 +85,15 @@ template <typename TInputImage, typename TKernelImage, typename TOutputImage, ty
 void
 FFTConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrecision>::GenerateData()
 {
+  for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+  {
+    if (m_TileSize[dim] > 0)
+    {
+      this->GenerateTiledData();
+      return;
+    }
+  }
+
   // Create a process accumulator for tracking the progress of this minipipeline
   auto progress = ProgressAccumulator::New();
   progress->SetMiniPipelineFilter(this);
@@ -112,6 +124,142 @@ FFTConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrec
   this->ProduceOutput(multiplyFilter->GetOutput(), progress, 0.2);
 }
 
+template <typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision>
+void
+FFTConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrecision>::GenerateTiledData()
+{
+  this->AllocateOutputs();
+
+  const InputImageType * input = this->GetInput();
+  OutputImageType *      output = this->GetOutput();
+  const OutputRegionType outputRegion = output->GetRequestedRegion();
+  const KernelSizeType   kernelRadius = this->GetKernelRadius();
+
+  // Each tile is padded by the kernel radius on both sides, and the blocks
+  // are then padded for the FFT. Blocks of the same size make it possible
+  // to use the same kernel spectrum for all the tiles. The FFT padding is
+  // used to enlarge the tiles.
+  InternalSizeType blockSize;
+  OutputSizeType   tileSize;
+  OutputSizeType   numberOfTiles;
+  SizeValueType    totalNumberOfTiles = 1;
+  for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+  {
+    const SizeValueType regionSize = outputRegion.GetSize(dim);
+    const SizeValueType requestedTileSize =
+      m_TileSize[dim] > 0 ? std::min<SizeValueType>(m_TileSize[dim], regionSize) : regionSize;
+    blockSize[dim] = requestedTileSize + 2 * kernelRadius[dim];
+    if (m_SizeGreatestPrimeFactor > 1)
+    {
+      while (Math::GreatestPrimeFactor(blockSize[dim]) > m_SizeGreatestPrimeFactor)
+      {
+        ++blockSize[dim];
+      }
+    }
+    else if (m_SizeGreatestPrimeFactor == 1)
+    {
+      // make sure the total size is even
+      blockSize[dim] += blockSize[dim] % 2;
+    }
+    tileSize[dim] = std::min<SizeValueType>(blockSize[dim] - 2 * kernelRadius[dim], regionSize);
+    numberOfTiles[dim] = (regionSize + tileSize[dim] - 1) / tileSize[dim];
+    totalNumberOfTiles *= numberOfTiles[dim];
+  }
+
+  // The kernel spectrum is computed once, for the block size.
+  auto progress = ProgressAccumulator::New();
+  progress->SetMiniPipelineFilter(this);
+  m_PaddedInputRegion = InternalRegionType(blockSize);
+  InternalComplexImagePointerType kernelSpectrum;
+  this->PrepareKernel(this->GetKernelImage(), kernelSpectrum, progress, 0.1f);
+
+  const BoundaryConditionType * boundaryCondition = this->GetBoundaryCondition();
+  const InputRegionType         inputBufferedRegion = input->GetBufferedRegion();
+  const SizeValueType           numberOfOutputPixels = outputRegion.GetNumberOfPixels();
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    totalNumberOfTiles,
+    [&](SizeValueType tile) {
+      TotalProgressReporter reporter(this, numberOfOutputPixels, 100, 0.9f);
+
+      OutputRegionType   tileRegion;
+      InternalRegionType blockRegion;
+      for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+      {
+        const SizeValueType tilePosition = tile % numberOfTiles[dim];
+        tile /= numberOfTiles[dim];
+        const IndexValueType tileStart =
+          outputRegion.GetIndex(dim) + static_cast<IndexValueType>(tilePosition * tileSize[dim]);
+        const IndexValueType regionEnd =
+          outputRegion.GetIndex(dim) + static_cast<IndexValueType>(outputRegion.GetSize(dim));
+        tileRegion.SetIndex(dim, tileStart);
+        tileRegion.SetSize(dim, std::min<SizeValueType>(tileSize[dim], regionEnd - tileStart));
+        blockRegion.SetIndex(dim, tileStart - static_cast<IndexValueType>(kernelRadius[dim]));
+        blockRegion.SetSize(dim, blockSize[dim]);
+      }
+
+      // Fill the block from the input, and from the boundary condition
+      // outside of the input buffer.
+      auto block = InternalImageType::New();
+      block->SetRegions(blockRegion);
+      block->Allocate();
+      if (inputBufferedRegion.IsInside(blockRegion))
+      {
+        ImageAlgorithm::Copy(input, block.GetPointer(), blockRegion, blockRegion);
+      }
+      else
+      {
+        for (ImageRegionIteratorWithIndex<InternalImageType> it(block, blockRegion); !it.IsAtEnd(); ++it)
+        {
+          const InputIndexType & index = it.GetIndex();
+          it.Set(static_cast<TInternalPrecision>(inputBufferedRegion.IsInside(index)
+                                                   ? input->GetPixel(index)
+                                                   : boundaryCondition->GetPixel(index, input)));
+        }
+      }
+
+      // The tile filters are not threaded, as the tiles already are.
+      auto fftFilter = FFTFilterType::New();
+      fftFilter->SetNumberOfWorkUnits(1);
+      fftFilter->SetInput(block);
+      fftFilter->Update();
+      const InternalComplexImagePointerType spectrum = fftFilter->GetOutput();
+      spectrum->DisconnectPipeline();
+      block = nullptr;
+
+      InternalComplexType *       spectrumBuffer = spectrum->GetBufferPointer();
+      const InternalComplexType * kernelBuffer = kernelSpectrum->GetBufferPointer();
+      const SizeValueType         numberOfFrequencies = spectrum->GetBufferedRegion().GetNumberOfPixels();
+      for (SizeValueType i = 0; i < numberOfFrequencies; ++i)
+      {
+        spectrumBuffer[i] *= kernelBuffer[i];
+      }
+
+      auto ifftFilter = IFFTFilterType::New();
+      ifftFilter->SetActualXDimensionIsOdd(blockSize[0] % 2 != 0);
+      ifftFilter->SetNumberOfWorkUnits(1);
+      ifftFilter->SetInput(spectrum);
+      ifftFilter->Update();
+
+      // Only the center of the block, away from the circular wrap around, is
+      // kept.
+      const InternalImageType * convolvedBlock = ifftFilter->GetOutput();
+      InternalRegionType        validRegion(tileRegion.GetSize());
+      for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+      {
+        validRegion.SetIndex(dim,
+                             convolvedBlock->GetLargestPossibleRegion().GetIndex(dim) +
+                               static_cast<IndexValueType>(kernelRadius[dim]));
+      }
+      ImageAlgorithm::Copy(convolvedBlock, output, validRegion, tileRegion);
+
+      reporter.Completed(tileRegion.GetNumberOfPixels());
+    },
+    nullptr);
+}
+
 template <typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision>
 void
 FFTConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrecision>::PrepareInputs(
@@ -524,6 +672,8 @@ FFTConvolutionImageFilter<TInputImage, TKernelImage, TOutputImage, TInternalPrec
 {
   Superclass::PrintSelf(os, indent);
   os << indent << "SizeGreatestPrimeFactor: " << m_SizeGreatestPrimeFactor << std::endl;
+  os << indent << "TileSize: " << static_cast<typename NumericTraits<OutputSizeType>::PrintType>(m_TileSize)
+     << std::endl;
 }
 
 } // namespace itk
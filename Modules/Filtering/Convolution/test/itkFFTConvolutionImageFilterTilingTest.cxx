@@ -0,0 +1,148 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFFTConvolutionImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkPeriodicBoundaryCondition.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+using FilterType = itk::FFTConvolutionImageFilter<ImageType>;
+
+ImageType::Pointer
+MakeImage(const ImageType::SizeType & size, unsigned int seed)
+{
+  auto image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType & index = it.GetIndex();
+    it.Set(static_cast<float>((index[0] * 7 + index[1] * 13 + index[2] * 5 + seed) % 17) - 8.0f);
+  }
+  return image;
+}
+
+// Compares the values of the buffered region of image with the same pixels
+// of baseline.
+bool
+AreClose(const ImageType * image, const ImageType * baseline)
+{
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const float expected = baseline->GetPixel(it.GetIndex());
+    if (std::abs(it.Get() - expected) > 1e-3f * (1.0f + std::abs(expected)))
+    {
+      std::cerr << "Tiled convolution differs at " << it.GetIndex() << ": " << it.Get() << " != " << expected
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Convolves the image tile by tile and compares the result with a
+// convolution of the whole image.
+bool
+TestTiling(const ImageType *                  image,
+           const ImageType *                  kernel,
+           const FilterType::OutputSizeType & tileSize,
+           bool                               normalize,
+           FilterType::BoundaryConditionType * boundaryCondition)
+{
+  auto wholeFilter = FilterType::New();
+  wholeFilter->SetInput(image);
+  wholeFilter->SetKernelImage(kernel);
+  wholeFilter->SetNormalize(normalize);
+  if (boundaryCondition)
+  {
+    wholeFilter->SetBoundaryCondition(boundaryCondition);
+  }
+  wholeFilter->Update();
+
+  auto tiledFilter = FilterType::New();
+  tiledFilter->SetInput(image);
+  tiledFilter->SetKernelImage(kernel);
+  tiledFilter->SetNormalize(normalize);
+  if (boundaryCondition)
+  {
+    tiledFilter->SetBoundaryCondition(boundaryCondition);
+  }
+  tiledFilter->SetTileSize(tileSize);
+  tiledFilter->SetNumberOfWorkUnits(4);
+  tiledFilter->Update();
+
+  std::cout << "Tile size " << tileSize << ", normalize " << normalize << std::endl;
+  if (!AreClose(tiledFilter->GetOutput(), wholeFilter->GetOutput()))
+  {
+    return false;
+  }
+
+  // Tiles of an output requested region.
+  auto regionFilter = FilterType::New();
+  regionFilter->SetInput(image);
+  regionFilter->SetKernelImage(kernel);
+  regionFilter->SetNormalize(normalize);
+  if (boundaryCondition)
+  {
+    regionFilter->SetBoundaryCondition(boundaryCondition);
+  }
+  regionFilter->SetTileSize(tileSize);
+  const ImageType::RegionType requestedRegion({ { 3, 2, 5 } }, { { 20, 9, 11 } });
+  regionFilter->GetOutput()->SetRequestedRegion(requestedRegion);
+  regionFilter->Update();
+  if (regionFilter->GetOutput()->GetBufferedRegion() != requestedRegion)
+  {
+    std::cerr << "Unexpected buffered region " << regionFilter->GetOutput()->GetBufferedRegion() << std::endl;
+    return false;
+  }
+  return AreClose(regionFilter->GetOutput(), wholeFilter->GetOutput());
+}
+} // namespace
+
+int
+itkFFTConvolutionImageFilterTilingTest(int, char *[])
+{
+  const ImageType::Pointer image = MakeImage({ { 41, 23, 19 } }, 0);
+  const ImageType::Pointer kernel = MakeImage({ { 5, 4, 3 } }, 3);
+
+  auto filter = FilterType::New();
+  ITK_TEST_SET_GET_VALUE(FilterType::OutputSizeType::Filled(0), filter->GetTileSize());
+  const FilterType::OutputSizeType tileSize{ { 8, 0, 6 } };
+  filter->SetTileSize(tileSize);
+  ITK_TEST_SET_GET_VALUE(tileSize, filter->GetTileSize());
+
+  itk::PeriodicBoundaryCondition<ImageType> periodicBoundaryCondition;
+
+  bool success = true;
+  success &= TestTiling(image, kernel, { { 8, 8, 8 } }, false, nullptr);
+  success &= TestTiling(image, kernel, { { 8, 0, 6 } }, true, nullptr);
+  success &= TestTiling(image, kernel, { { 1, 1, 1 } }, false, nullptr);
+  success &= TestTiling(image, kernel, { { 100, 5, 0 } }, false, &periodicBoundaryCondition);
+
+  if (!success)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
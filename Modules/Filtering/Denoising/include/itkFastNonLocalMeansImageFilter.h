@@ -0,0 +1,170 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFastNonLocalMeansImageFilter_h
+#define itkFastNonLocalMeansImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkNumericTraits.h"
+#include <vector>
+
+namespace itk
+{
+/**
+ * \class FastNonLocalMeansImageFilter
+ * \brief Denoises a scalar image with the nonlocal means algorithm, computing
+ * the patch distances of all the pixels for one displacement at a time.
+ *
+ * The intensity at each pixel \f$x\f$ is replaced by the weighted average of
+ * the intensities of the pixels \f$y\f$ of its search window,
+ * \f[ w(x,y) = \exp\left(-\frac{\max(d^2(x,y) - 2\sigma^2, 0)}{h^2}\right) \f]
+ * where \f$d^2(x,y)\f$ is the mean squared difference between the patches
+ * centered at \f$x\f$ and \f$y\f$, \f$\sigma\f$ is the NoiseSigma and \f$h\f$
+ * is the KernelBandwidth (Buades, Coll and Morel, Non-Local Means Denoising,
+ * Image Processing On Line, 2011).
+ *
+ * Instead of extracting the patches of every pair of pixels, the filter
+ * computes, for each displacement of the search window, the squared
+ * differences between the image and the displaced image once, and then the
+ * patch distances of all the pixels as separable box sums of these squared
+ * differences (Darbon et al., Fast nonlocal filtering applied to electron
+ * cryomicroscopy, ISBI 2008). The sums run over contiguous buffers, so that the
+ * compiler vectorizes them, and the cost per pixel and displacement no longer
+ * grows with the number of pixels of the patches but with the sum of their
+ * lengths. The distance between the patches of x and x + o is also the one
+ * between the patches of x + o and x, so the weights are computed once for
+ * both displacements o and -o.
+ *
+ * The output is processed in parallel in tiles of a bounded number of pixels,
+ * whose buffers are reused from one tile to the next. A pixel is processed in
+ * the same way whatever its tile, so the output does not depend on the number
+ * of work units. Patches are extended at the border of the image with the
+ * values of the nearest pixels of the image, and the search window is
+ * restricted to the image.
+ *
+ * \sa PatchBasedDenoisingImageFilter
+ *
+ * \ingroup MultiThreaded
+ * \ingroup ITKDenoising
+ */
+template <typename TInputImage, typename TOutputImage = TInputImage>
+class ITK_TEMPLATE_EXPORT FastNonLocalMeansImageFilter : public ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(FastNonLocalMeansImageFilter);
+
+  /** Standard class type aliases. */
+  using Self = FastNonLocalMeansImageFilter;
+  using Superclass = ImageToImageFilter<TInputImage, TOutputImage>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(FastNonLocalMeansImageFilter);
+
+  /** Image type alias support */
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using InputPixelType = typename InputImageType::PixelType;
+  using OutputPixelType = typename OutputImageType::PixelType;
+  using RealType = typename NumericTraits<InputPixelType>::RealType;
+
+  using InputImageRegionType = typename InputImageType::RegionType;
+  using OutputImageRegionType = typename OutputImageType::RegionType;
+
+  /** Image dimension, assumed to be the same for input and output data. */
+  static constexpr unsigned int ImageDimension = TInputImage::ImageDimension;
+
+  /** Type of the radii of the patches and of the search window, in pixels. */
+  using RadiusType = Size<ImageDimension>;
+
+  /** Set/Get the radius of the patches, in pixels. Default is 1 in each
+   * dimension. */
+  itkSetMacro(PatchRadius, RadiusType);
+  itkGetConstReferenceMacro(PatchRadius, RadiusType);
+
+  /** Set/Get the radius of the search window, in pixels. Default is 5 in
+   * each dimension. */
+  itkSetMacro(SearchRadius, RadiusType);
+  itkGetConstReferenceMacro(SearchRadius, RadiusType);
+
+  /** Set/Get the kernel bandwidth h, which controls the decay of the weights
+   * with the patch distances. Default is 1. */
+  itkSetClampMacro(KernelBandwidth, double, NumericTraits<double>::min(), NumericTraits<double>::max());
+  itkGetConstMacro(KernelBandwidth, double);
+
+  /** Set/Get the standard deviation of the noise, twice the square of which
+   * is subtracted from the patch distances. Default is 0. */
+  itkSetClampMacro(NoiseSigma, double, 0.0, NumericTraits<double>::max());
+  itkGetConstMacro(NoiseSigma, double);
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  // Begin concept checking
+  itkConceptMacro(InputHasNumericTraitsCheck, (Concept::HasNumericTraits<InputPixelType>));
+  itkConceptMacro(InputIsScalarCheck,
+                  (Concept::SameType<InputPixelType, typename NumericTraits<InputPixelType>::ValueType>));
+  // End concept checking
+#endif
+
+protected:
+  FastNonLocalMeansImageFilter();
+  ~FastNonLocalMeansImageFilter() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** The filter needs the patches of the pixels of the search windows of
+   * the output pixels. */
+  void
+  GenerateInputRequestedRegion() override;
+
+  void
+  DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
+
+private:
+  /** Maximum number of pixels of the tiles in which the output is processed. */
+  static constexpr SizeValueType MaximumTileSize = 32768;
+
+  /** Buffers of a tile, reused from one tile to the next. */
+  struct TileBuffers
+  {
+    std::vector<RealType> m_Values{};
+    std::vector<RealType> m_Distances{};
+    std::vector<RealType> m_BoxSums{};
+    std::vector<RealType> m_WeightedValueSums{};
+    std::vector<RealType> m_WeightSums{};
+  };
+
+  /** Denoise the pixels of a tile. */
+  void
+  DenoiseTile(const OutputImageRegionType & tile, TileBuffers & buffers);
+
+  RadiusType m_PatchRadius{ RadiusType::Filled(1) };
+  RadiusType m_SearchRadius{ RadiusType::Filled(5) };
+  double     m_KernelBandwidth{ 1.0 };
+  double     m_NoiseSigma{ 0.0 };
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkFastNonLocalMeansImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,427 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFastNonLocalMeansImageFilter_hxx
+#define itkFastNonLocalMeansImageFilter_hxx
+
+#include "itkImageRegionSplitterMultidimensional.h"
+#include "itkTotalProgressReporter.h"
+#include <algorithm>
+#include <cmath>
+
+namespace itk
+{
+
+template <typename TInputImage, typename TOutputImage>
+FastNonLocalMeansImageFilter<TInputImage, TOutputImage>::FastNonLocalMeansImageFilter()
+{
+  this->DynamicMultiThreadingOn();
+  this->ThreaderUpdateProgressOff();
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+FastNonLocalMeansImageFilter<TInputImage, TOutputImage>::GenerateInputRequestedRegion()
+{
+  // call the superclass' implementation of this method
+  Superclass::GenerateInputRequestedRegion();
+
+  // get pointers to the input and output
+  const typename Superclass::InputImagePointer inputPtr = const_cast<TInputImage *>(this->GetInput());
+
+  if (!inputPtr)
+  {
+    return;
+  }
+
+  // get a copy of the input requested region (should equal the output
+  // requested region)
+  InputImageRegionType inputRequestedRegion = inputPtr->GetRequestedRegion();
+
+  // pad the input requested region by the radii of the patches and of the
+  // search window
+  inputRequestedRegion.PadByRadius(m_PatchRadius + m_SearchRadius);
+
+  // crop the input requested region at the input's largest possible region
+  if (inputRequestedRegion.Crop(inputPtr->GetLargestPossibleRegion()))
+  {
+    inputPtr->SetRequestedRegion(inputRequestedRegion);
+    return;
+  }
+
+  // Couldn't crop the region (requested region is outside the largest
+  // possible region).  Throw an exception.
+
+  // store what we tried to request (prior to trying to crop)
+  inputPtr->SetRequestedRegion(inputRequestedRegion);
+
+  // build an exception
+  InvalidRequestedRegionError e(__FILE__, __LINE__);
+  std::ostringstream          msg;
+  msg << static_cast<const char *>(this->GetNameOfClass()) << "::GenerateInputRequestedRegion()";
+  e.SetLocation(msg.str().c_str());
+  e.SetDescription("Requested region is (at least partially) outside the largest possible region.");
+  e.SetDataObject(inputPtr);
+  throw e;
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+FastNonLocalMeansImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
+  const OutputImageRegionType & outputRegionForThread)
+{
+  TotalProgressReporter progress(this, this->GetOutput()->GetRequestedRegion().GetNumberOfPixels());
+
+  // Process the region in tiles of a bounded number of pixels, so that the
+  // buffers of a tile stay small whatever the size of the region
+  const auto          splitter = ImageRegionSplitterMultidimensional::New();
+  const SizeValueType numberOfPixels = outputRegionForThread.GetNumberOfPixels();
+  const unsigned int  numberOfTiles = splitter->GetNumberOfSplits(
+    outputRegionForThread, static_cast<unsigned int>((numberOfPixels + MaximumTileSize - 1) / MaximumTileSize));
+
+  TileBuffers buffers;
+  for (unsigned int i = 0; i < numberOfTiles; ++i)
+  {
+    OutputImageRegionType tile = outputRegionForThread;
+    splitter->GetSplit(i, numberOfTiles, tile);
+    this->DenoiseTile(tile, buffers);
+    progress.Completed(tile.GetNumberOfPixels());
+  }
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+FastNonLocalMeansImageFilter<TInputImage, TOutputImage>::DenoiseTile(const OutputImageRegionType & tile,
+                                                                     TileBuffers &                 buffers)
+{
+  using IndexType = typename InputImageType::IndexType;
+
+  const InputImageType * input = this->GetInput();
+  OutputImageType *      output = this->GetOutput();
+
+  const InputImageRegionType & largestRegion = input->GetLargestPossibleRegion();
+  const IndexType              lowerIndex = largestRegion.GetIndex();
+  const IndexType              upperIndex = largestRegion.GetUpperIndex();
+  const IndexType &            tileIndex = tile.GetIndex();
+  const auto &                 tileSize = tile.GetSize();
+
+  // Calls a function with the position of the first pixel of each line, along
+  // the first dimension, of a box of the given size
+  const auto forEachLine = [](const SizeValueType * size, const auto & function) {
+    SizeValueType numberOfLines = 1;
+    for (unsigned int i = 1; i < ImageDimension; ++i)
+    {
+      numberOfLines *= size[i];
+    }
+    IndexValueType position[ImageDimension] = {};
+    for (SizeValueType line = 0; line < numberOfLines; ++line)
+    {
+      SizeValueType remainder = line;
+      for (unsigned int i = 1; i < ImageDimension; ++i)
+      {
+        position[i] = static_cast<IndexValueType>(remainder % size[i]);
+        remainder /= size[i];
+      }
+      function(position);
+    }
+  };
+
+  // Values of the tile padded by the radii of the patches and of the search
+  // window, with the values of the nearest pixels of the image outside of it
+  IndexValueType  padding[ImageDimension];
+  SizeValueType   paddedSize[ImageDimension];
+  OffsetValueType paddedStrides[ImageDimension];
+  SizeValueType   numberOfPaddedPixels = 1;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    padding[i] = static_cast<IndexValueType>(m_PatchRadius[i] + m_SearchRadius[i]);
+    paddedSize[i] = tileSize[i] + 2 * static_cast<SizeValueType>(padding[i]);
+    paddedStrides[i] = static_cast<OffsetValueType>(numberOfPaddedPixels);
+    numberOfPaddedPixels *= paddedSize[i];
+  }
+  std::vector<RealType> & values = buffers.m_Values;
+  values.resize(numberOfPaddedPixels);
+  {
+    RealType * value = values.data();
+    forEachLine(paddedSize, [&](const IndexValueType * position) {
+      IndexType index;
+      for (unsigned int i = 0; i < ImageDimension; ++i)
+      {
+        index[i] = std::clamp(tileIndex[i] - padding[i] + position[i], lowerIndex[i], upperIndex[i]);
+      }
+      const IndexValueType   firstIndex = index[0];
+      const InputPixelType * row = input->GetBufferPointer() + input->ComputeOffset(index);
+      for (SizeValueType q = 0; q < paddedSize[0]; ++q)
+      {
+        const IndexValueType index0 =
+          std::clamp(tileIndex[0] - padding[0] + static_cast<IndexValueType>(q), lowerIndex[0], upperIndex[0]);
+        *value++ = static_cast<RealType>(row[index0 - firstIndex]);
+      }
+    });
+  }
+
+  SizeValueType   numberOfPatchPixels = 1;
+  SizeValueType   numberOfDisplacements = 1;
+  OffsetValueType tileStrides[ImageDimension];
+  SizeValueType   numberOfTilePixels = 1;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    numberOfPatchPixels *= 2 * m_PatchRadius[i] + 1;
+    numberOfDisplacements *= 2 * m_SearchRadius[i] + 1;
+    tileStrides[i] = static_cast<OffsetValueType>(numberOfTilePixels);
+    numberOfTilePixels *= tileSize[i];
+  }
+  const RealType inversePatchSize = 1.0 / static_cast<RealType>(numberOfPatchPixels);
+  const RealType noiseDistance = 2.0 * m_NoiseSigma * m_NoiseSigma;
+  const RealType inverseSquaredBandwidth = 1.0 / (m_KernelBandwidth * m_KernelBandwidth);
+
+  // Offset in the padded values of a position of the tile
+  const auto valueOffset = [&padding, &paddedStrides](const IndexValueType * position) {
+    OffsetValueType offset = 0;
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      offset += (position[i] + padding[i]) * paddedStrides[i];
+    }
+    return offset;
+  };
+
+  // The null displacement has a weight of one, so the sums of the weights
+  // are positive
+  std::vector<RealType> & weightedValueSums = buffers.m_WeightedValueSums;
+  std::vector<RealType> & weightSums = buffers.m_WeightSums;
+  weightedValueSums.resize(numberOfTilePixels);
+  weightSums.assign(numberOfTilePixels, 1.0);
+  {
+    RealType * weightedValueSum = weightedValueSums.data();
+    forEachLine(tileSize.data(), [&](const IndexValueType * position) {
+      const RealType * value = values.data() + valueOffset(position);
+      std::copy(value, value + tileSize[0], weightedValueSum);
+      weightedValueSum += tileSize[0];
+    });
+  }
+
+  // The weight of a pixel x for a displacement o is the one of the pixel
+  // x + o for the displacement -o, so the weights are computed once for each
+  // pair of opposite displacements, for the pixels of the tile whose
+  // displaced pixel is in the image and for the pixels displaced by -o from
+  // the ones of the tile whose pixel displaced by -o is in the image
+  for (SizeValueType displacement = numberOfDisplacements / 2 + 1; displacement < numberOfDisplacements;
+       ++displacement)
+  {
+    IndexValueType  offset[ImageDimension];
+    IndexValueType  forwardIndex[ImageDimension];
+    SizeValueType   forwardSize[ImageDimension];
+    IndexValueType  backwardIndex[ImageDimension];
+    SizeValueType   backwardSize[ImageDimension];
+    OffsetValueType displacementOffset = 0;
+    bool            hasForward = true;
+    bool            hasBackward = true;
+    SizeValueType   remainder = displacement;
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      const SizeValueType searchSize = 2 * m_SearchRadius[i] + 1;
+      offset[i] = static_cast<IndexValueType>(remainder % searchSize) - static_cast<IndexValueType>(m_SearchRadius[i]);
+      remainder /= searchSize;
+      displacementOffset += offset[i] * paddedStrides[i];
+
+      const auto tileEnd = static_cast<IndexValueType>(tileSize[i]);
+      forwardIndex[i] = std::max(IndexValueType{ 0 }, lowerIndex[i] - offset[i] - tileIndex[i]);
+      const IndexValueType forwardEnd = std::min(tileEnd, upperIndex[i] - offset[i] - tileIndex[i] + 1);
+      hasForward = hasForward && forwardIndex[i] < forwardEnd;
+      forwardSize[i] = hasForward ? static_cast<SizeValueType>(forwardEnd - forwardIndex[i]) : 0;
+
+      backwardIndex[i] = std::max(IndexValueType{ 0 }, lowerIndex[i] + offset[i] - tileIndex[i]);
+      const IndexValueType backwardEnd = std::min(tileEnd, upperIndex[i] + offset[i] - tileIndex[i] + 1);
+      hasBackward = hasBackward && backwardIndex[i] < backwardEnd;
+      backwardSize[i] = hasBackward ? static_cast<SizeValueType>(backwardEnd - backwardIndex[i]) : 0;
+    }
+    if (!hasForward && !hasBackward)
+    {
+      continue;
+    }
+
+    // The box of the weights, which contains the pixels of the tile with a
+    // forward displacement, and the ones displaced by -o with a backward one
+    IndexValueType weightIndex[ImageDimension];
+    SizeValueType  weightSize[ImageDimension];
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      IndexValueType lower = NumericTraits<IndexValueType>::max();
+      IndexValueType upper = NumericTraits<IndexValueType>::min();
+      if (hasForward)
+      {
+        lower = forwardIndex[i];
+        upper = forwardIndex[i] + static_cast<IndexValueType>(forwardSize[i]);
+      }
+      if (hasBackward)
+      {
+        lower = std::min(lower, backwardIndex[i] - offset[i]);
+        upper = std::max(upper, backwardIndex[i] - offset[i] + static_cast<IndexValueType>(backwardSize[i]));
+      }
+      weightIndex[i] = lower;
+      weightSize[i] = static_cast<SizeValueType>(upper - lower);
+    }
+
+    // Squared differences between the values and the displaced values, over
+    // the box of the weights padded by the radius of the patches
+    SizeValueType   sumSize[ImageDimension];
+    SizeValueType   numberOfDistances = 1;
+    OffsetValueType firstOffset = 0;
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      sumSize[i] = weightSize[i] + 2 * m_PatchRadius[i];
+      numberOfDistances *= sumSize[i];
+      firstOffset += (weightIndex[i] + static_cast<IndexValueType>(m_SearchRadius[i])) * paddedStrides[i];
+    }
+    buffers.m_Distances.resize(numberOfDistances);
+    buffers.m_BoxSums.resize(numberOfDistances);
+    {
+      RealType * distance = buffers.m_Distances.data();
+      forEachLine(sumSize, [&](const IndexValueType * position) {
+        OffsetValueType rowOffset = firstOffset;
+        for (unsigned int i = 1; i < ImageDimension; ++i)
+        {
+          rowOffset += position[i] * paddedStrides[i];
+        }
+        const RealType * row = values.data() + rowOffset;
+        const RealType * displacedRow = row + displacementOffset;
+        for (SizeValueType q = 0; q < sumSize[0]; ++q)
+        {
+          const RealType difference = row[q] - displacedRow[q];
+          distance[q] = difference * difference;
+        }
+        distance += sumSize[0];
+      });
+    }
+
+    // Sums of the squared differences over the patches, as box sums along
+    // each dimension in turn. Along a dimension, the buffer is a sequence of
+    // blocks, each one a sequence of contiguous slices orthogonal to that
+    // dimension, so that each sum adds contiguous runs of pixels.
+    RealType *    sums = buffers.m_Distances.data();
+    RealType *    nextSums = buffers.m_BoxSums.data();
+    SizeValueType sliceSize = 1;
+    for (unsigned int d = 0; d < ImageDimension; ++d)
+    {
+      SizeValueType numberOfBlocks = 1;
+      for (unsigned int i = d + 1; i < ImageDimension; ++i)
+      {
+        numberOfBlocks *= sumSize[i];
+      }
+      const SizeValueType inputBlockSize = sumSize[d] * sliceSize;
+      const SizeValueType outputBlockSize = weightSize[d] * sliceSize;
+      const SizeValueType boxSize = 2 * m_PatchRadius[d] + 1;
+      for (SizeValueType block = 0; block < numberOfBlocks; ++block)
+      {
+        const RealType * inputBlock = sums + block * inputBlockSize;
+        RealType *       outputBlock = nextSums + block * outputBlockSize;
+        std::copy(inputBlock, inputBlock + outputBlockSize, outputBlock);
+        for (SizeValueType k = 1; k < boxSize; ++k)
+        {
+          const RealType * inputSlices = inputBlock + k * sliceSize;
+          for (SizeValueType j = 0; j < outputBlockSize; ++j)
+          {
+            outputBlock[j] += inputSlices[j];
+          }
+        }
+      }
+      sumSize[d] = weightSize[d];
+      sliceSize *= weightSize[d];
+      std::swap(sums, nextSums);
+    }
+
+    // Weights from the mean squared differences of the patches
+    RealType * weights = sums;
+    for (SizeValueType j = 0; j < sliceSize; ++j)
+    {
+      const RealType patchDistance = std::max(weights[j] * inversePatchSize - noiseDistance, RealType{});
+      weights[j] = std::exp(-patchDistance * inverseSquaredBandwidth);
+    }
+
+    // Add the weighted values of the pixels displaced by o and by -o
+    const auto accumulate = [&](const IndexValueType * index,
+                                const SizeValueType *  size,
+                                IndexValueType         weightShift,
+                                OffsetValueType        valueShift) {
+      forEachLine(size, [&](const IndexValueType * position) {
+        IndexValueType  tilePosition[ImageDimension];
+        OffsetValueType tileOffset = 0;
+        OffsetValueType weightOffset = 0;
+        SizeValueType   weightStride = 1;
+        for (unsigned int i = 0; i < ImageDimension; ++i)
+        {
+          tilePosition[i] = index[i] + position[i];
+          tileOffset += tilePosition[i] * tileStrides[i];
+          weightOffset += (tilePosition[i] - weightShift * offset[i] - weightIndex[i]) *
+                          static_cast<OffsetValueType>(weightStride);
+          weightStride *= weightSize[i];
+        }
+        const RealType * weight = weights + weightOffset;
+        const RealType * displacedValue = values.data() + valueOffset(tilePosition) + valueShift;
+        RealType *       weightedValueSum = weightedValueSums.data() + tileOffset;
+        RealType *       weightSum = weightSums.data() + tileOffset;
+        for (SizeValueType q = 0; q < size[0]; ++q)
+        {
+          weightedValueSum[q] += weight[q] * displacedValue[q];
+          weightSum[q] += weight[q];
+        }
+      });
+    };
+    if (hasForward)
+    {
+      accumulate(forwardIndex, forwardSize, 0, displacementOffset);
+    }
+    if (hasBackward)
+    {
+      accumulate(backwardIndex, backwardSize, 1, -displacementOffset);
+    }
+  }
+
+  const RealType * weightedValueSum = weightedValueSums.data();
+  const RealType * weightSum = weightSums.data();
+  forEachLine(tileSize.data(), [&](const IndexValueType * position) {
+    IndexType index;
+    index[0] = tileIndex[0];
+    for (unsigned int i = 1; i < ImageDimension; ++i)
+    {
+      index[i] = tileIndex[i] + position[i];
+    }
+    OutputPixelType * row = output->GetBufferPointer() + output->ComputeOffset(index);
+    for (SizeValueType q = 0; q < tileSize[0]; ++q)
+    {
+      row[q] = static_cast<OutputPixelType>(weightedValueSum[q] / weightSum[q]);
+    }
+    weightedValueSum += tileSize[0];
+    weightSum += tileSize[0];
+  });
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+FastNonLocalMeansImageFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "PatchRadius: " << m_PatchRadius << std::endl;
+  os << indent << "SearchRadius: " << m_SearchRadius << std::endl;
+  os << indent << "KernelBandwidth: " << m_KernelBandwidth << std::endl;
+  os << indent << "NoiseSigma: " << m_NoiseSigma << std::endl;
+}
+
+} // end namespace itk
+
+#endif
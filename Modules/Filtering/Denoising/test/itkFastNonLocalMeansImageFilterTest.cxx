@@ -0,0 +1,228 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFastNonLocalMeansImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkIndexRange.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkMath.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+
+namespace
+{
+// Create a noisy image of blocks of constant intensities, and the image
+// without noise.
+template <typename TImage>
+void
+CreateNoisyImage(const typename TImage::RegionType & region,
+                 unsigned int                        seed,
+                 typename TImage::Pointer &          image,
+                 typename TImage::Pointer &          noiselessImage)
+{
+  auto randomGenerator = itk::Statistics::MersenneTwisterRandomVariateGenerator::New();
+  randomGenerator->Initialize(seed);
+
+  image = TImage::New();
+  image->SetRegions(region);
+  image->Allocate();
+  noiselessImage = TImage::New();
+  noiselessImage->SetRegions(region);
+  noiselessImage->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<TImage> noiselessIt(noiselessImage, region);
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, region); !it.IsAtEnd(); ++it, ++noiselessIt)
+  {
+    unsigned int block = 0;
+    for (unsigned int i = 0; i < TImage::ImageDimension; ++i)
+    {
+      block += static_cast<unsigned int>(it.GetIndex()[i] - region.GetIndex(i)) / 7;
+    }
+    const double value = 40.0 * (block % 3);
+    noiselessIt.Set(value);
+    it.Set(static_cast<typename TImage::PixelType>(randomGenerator->GetNormalVariate(value, 100.0)));
+  }
+}
+
+// Denoise a pixel directly from the patches of the pixels of its search
+// window.
+template <typename TImage, typename TFilter>
+double
+DenoisePixel(const TImage * image, const typename TImage::IndexType & index, const TFilter * filter)
+{
+  constexpr unsigned int               Dimension = TImage::ImageDimension;
+  const typename TImage::RegionType    region = image->GetLargestPossibleRegion();
+  const typename TFilter::RadiusType & patchRadius = filter->GetPatchRadius();
+  const typename TFilter::RadiusType & searchRadius = filter->GetSearchRadius();
+
+  const auto clampedPixel = [&region, image](typename TImage::IndexType pixelIndex) {
+    for (unsigned int i = 0; i < Dimension; ++i)
+    {
+      pixelIndex[i] = std::clamp(pixelIndex[i], region.GetIndex(i), region.GetUpperIndex()[i]);
+    }
+    return static_cast<double>(image->GetPixel(pixelIndex));
+  };
+
+  typename TImage::RegionType searchRegion(index, itk::Size<Dimension>::Filled(1));
+  searchRegion.PadByRadius(searchRadius);
+  searchRegion.Crop(region);
+  typename TImage::RegionType patchRegion(itk::Size<Dimension>::Filled(1));
+  patchRegion.PadByRadius(patchRadius);
+
+  double weightedValueSum = 0.0;
+  double weightSum = 0.0;
+  for (itk::ImageRegionConstIteratorWithIndex<TImage> searchIt(image, searchRegion); !searchIt.IsAtEnd(); ++searchIt)
+  {
+    double squaredDistance = 0.0;
+    for (const typename TImage::IndexType & patchIndex : itk::ImageRegionIndexRange<Dimension>(patchRegion))
+    {
+      const typename TImage::OffsetType offset = patchIndex - typename TImage::IndexType();
+      squaredDistance += itk::Math::sqr(clampedPixel(index + offset) - clampedPixel(searchIt.GetIndex() + offset));
+    }
+    squaredDistance /= static_cast<double>(patchRegion.GetNumberOfPixels());
+    const double weight =
+      std::exp(-std::max(squaredDistance - 2.0 * itk::Math::sqr(filter->GetNoiseSigma()), 0.0) /
+               itk::Math::sqr(filter->GetKernelBandwidth()));
+    weightedValueSum += weight * static_cast<double>(searchIt.Get());
+    weightSum += weight;
+  }
+  return weightedValueSum / weightSum;
+}
+
+// Compare the output of the filter with the denoised pixels, check that the
+// output does not depend on the number of work units nor on the requested
+// region, and that the filter reduces the noise.
+template <typename TImage>
+bool
+CheckFilter(const typename TImage::RegionType &                                    region,
+            const typename itk::FastNonLocalMeansImageFilter<TImage>::RadiusType & patchRadius,
+            const typename itk::FastNonLocalMeansImageFilter<TImage>::RadiusType & searchRadius,
+            double                                                                 tolerance)
+{
+  using FilterType = itk::FastNonLocalMeansImageFilter<TImage>;
+
+  typename TImage::Pointer image;
+  typename TImage::Pointer noiselessImage;
+  CreateNoisyImage<TImage>(region, 20250701, image, noiselessImage);
+
+  auto filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetPatchRadius(patchRadius);
+  filter->SetSearchRadius(searchRadius);
+  filter->SetKernelBandwidth(15.0);
+  filter->SetNoiseSigma(8.0);
+
+  filter->SetNumberOfWorkUnits(1);
+  filter->Update();
+  const typename TImage::Pointer output = filter->GetOutput();
+  output->DisconnectPipeline();
+
+  double noisySquaredError = 0.0;
+  double denoisedSquaredError = 0.0;
+  itk::ImageRegionConstIterator<TImage> noiselessIt(noiselessImage, region);
+  itk::ImageRegionConstIterator<TImage> imageIt(image, region);
+  for (itk::ImageRegionConstIteratorWithIndex<TImage> it(output, region); !it.IsAtEnd();
+       ++it, ++noiselessIt, ++imageIt)
+  {
+    const double expected = DenoisePixel(image.GetPointer(), it.GetIndex(), filter.GetPointer());
+    if (itk::Math::abs(it.Get() - expected) > tolerance * (1.0 + itk::Math::abs(expected)))
+    {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Error in the denoised pixel " << it.GetIndex() << std::endl;
+      std::cerr << "Expected " << expected << ", but got " << it.Get() << std::endl;
+      return false;
+    }
+    noisySquaredError += itk::Math::sqr(imageIt.Get() - noiselessIt.Get());
+    denoisedSquaredError += itk::Math::sqr(it.Get() - noiselessIt.Get());
+  }
+  std::cout << "Mean squared error of the noisy image: " << noisySquaredError / region.GetNumberOfPixels()
+            << ", of the denoised image: " << denoisedSquaredError / region.GetNumberOfPixels() << std::endl;
+  if (denoisedSquaredError > 0.5 * noisySquaredError)
+  {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "The noise is not reduced" << std::endl;
+    return false;
+  }
+
+  // Same output with several work units, and for a requested region at the
+  // border of the image
+  typename TImage::RegionType requestedRegion = region;
+  requestedRegion.ShrinkByRadius(3);
+  requestedRegion.SetIndex(region.GetIndex());
+  for (const typename TImage::RegionType & outputRegion : { region, requestedRegion })
+  {
+    filter->SetNumberOfWorkUnits(5);
+    filter->GetOutput()->SetRequestedRegion(outputRegion);
+    filter->Update();
+    itk::ImageRegionConstIterator<TImage> expectedIt(output, outputRegion);
+    for (itk::ImageRegionConstIterator<TImage> it(filter->GetOutput(), outputRegion); !it.IsAtEnd();
+         ++it, ++expectedIt)
+    {
+      if (it.Get() != expectedIt.Get())
+      {
+        std::cerr << "Test failed!" << std::endl;
+        std::cerr << "Error in the output with 5 work units in the region " << outputRegion << std::endl;
+        return false;
+      }
+    }
+    filter->Modified();
+  }
+  return true;
+}
+} // namespace
+
+/* Denoise two- and three-dimensional images, larger than the tiles of the
+ * filter, with patches and search windows of different radii along each
+ * dimension, and compare the output with the nonlocal means of each pixel. */
+int
+itkFastNonLocalMeansImageFilterTest(int, char *[])
+{
+  using ImageType2D = itk::Image<double, 2>;
+  using ImageType3D = itk::Image<float, 3>;
+  using FilterType = itk::FastNonLocalMeansImageFilter<ImageType3D>;
+
+  auto filter = FilterType::New();
+
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(filter, FastNonLocalMeansImageFilter, ImageToImageFilter);
+
+  ITK_TEST_SET_GET_VALUE(FilterType::RadiusType::Filled(1), filter->GetPatchRadius());
+  ITK_TEST_SET_GET_VALUE(FilterType::RadiusType::Filled(5), filter->GetSearchRadius());
+  ITK_TEST_SET_GET_VALUE(1.0, filter->GetKernelBandwidth());
+  ITK_TEST_SET_GET_VALUE(0.0, filter->GetNoiseSigma());
+  filter->SetKernelBandwidth(0.0);
+  ITK_TEST_EXPECT_TRUE(filter->GetKernelBandwidth() > 0.0);
+  filter->SetNoiseSigma(-1.0);
+  ITK_TEST_SET_GET_VALUE(0.0, filter->GetNoiseSigma());
+
+  std::cout << "Two-dimensional image" << std::endl;
+  if (!CheckFilter<ImageType2D>({ { -3, 5 }, { 230, 190 } }, { { 2, 1 } }, { { 3, 4 } }, 1e-12))
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Three-dimensional image" << std::endl;
+  if (!CheckFilter<ImageType3D>({ { 0, 0, 0 }, { 41, 37, 29 } }, { { 1, 2, 1 } }, { { 2, 1, 3 } }, 1e-5))
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
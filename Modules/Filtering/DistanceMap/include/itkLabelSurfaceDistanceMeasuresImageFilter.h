@@ -0,0 +1,244 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkLabelSurfaceDistanceMeasuresImageFilter_h
+#define itkLabelSurfaceDistanceMeasuresImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkNumericTraits.h"
+#include <unordered_map>
+#include <vector>
+
+namespace itk
+{
+/**
+ * \class LabelSurfaceDistanceMeasuresImageFilter
+ * \brief Computes surface distance and overlap measures between the same
+ * set of labels of pixels of two images. Background is assumed to be 0.
+ *
+ * The surface of a label in an image is the set of its pixels that have a
+ * face neighbor with another label, or that are on the border of the image.
+ * For each label, the filter computes from the surfaces \f$S\f$ and \f$T\f$
+ * of the label in the source and target images:
+ * - the Hausdorff distance \f[ H(S,T) = \max(h(S,T),h(T,S)) \f] where
+ *   \f[ h(S,T) = \max_{s \in S} \min_{t \in T} \| s - t\| \f] is the directed
+ *   Hausdorff distance,
+ * - the percentile Hausdorff distance, the largest of the Percentile-th
+ *   percentiles of the distances from the pixels of a surface to the other
+ *   surface, which is the 95th percentile Hausdorff distance by default,
+ * - the average surface distance, the mean of the distances from the pixels
+ *   of both surfaces to the other surface,
+ *
+ * along with the pixel counts of LabelOverlapMeasuresImageFilter, from which
+ * the Dice and Jaccard coefficients of the label are computed.
+ *
+ * The surfaces of all the labels are extracted, and the overlaps counted,
+ * in one parallel pass over the images. The distances to a surface are then
+ * computed with an exact Euclidean distance transform, restricted to the
+ * bounding box of both surfaces of the label. The labels are processed in
+ * parallel, from the largest bounding box to the smallest, and the transforms
+ * of a label whose bounding box is larger than the share of a work unit are
+ * computed by all the work units together.
+ *
+ * The distances of a label that is missing from one of the images are set to
+ * NumericTraits<RealType>::max().
+ *
+ * This filter requires the largest possible region of the source image
+ * and the same corresponding region in the target image. The filter passes
+ * the source image through unmodified.
+ *
+ * \sa HausdorffDistanceImageFilter
+ * \sa LabelOverlapMeasuresImageFilter
+ *
+ * \ingroup MultiThreaded
+ * \ingroup ITKDistanceMap
+ */
+template <typename TLabelImage>
+class ITK_TEMPLATE_EXPORT LabelSurfaceDistanceMeasuresImageFilter : public ImageToImageFilter<TLabelImage, TLabelImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(LabelSurfaceDistanceMeasuresImageFilter);
+
+  /** Standard Self type alias */
+  using Self = LabelSurfaceDistanceMeasuresImageFilter;
+  using Superclass = ImageToImageFilter<TLabelImage, TLabelImage>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(LabelSurfaceDistanceMeasuresImageFilter);
+
+  /** Image related type alias. */
+  using LabelImageType = TLabelImage;
+  using LabelImagePointer = typename TLabelImage::Pointer;
+  using LabelImageConstPointer = typename TLabelImage::ConstPointer;
+
+  using RegionType = typename TLabelImage::RegionType;
+  using SizeType = typename TLabelImage::SizeType;
+  using IndexType = typename TLabelImage::IndexType;
+
+  using LabelType = typename TLabelImage::PixelType;
+
+  /** Image related type alias. */
+  static constexpr unsigned int ImageDimension = TLabelImage::ImageDimension;
+
+  /** Type to use for computations. */
+  using RealType = typename NumericTraits<LabelType>::RealType;
+
+  /** \class LabelSetMeasures
+   * \brief Measures stored per label
+   * \ingroup ITKDistanceMap
+   */
+  class LabelSetMeasures
+  {
+  public:
+    // default constructor/copy/move etc...
+
+    SizeValueType m_Source{ 0 };
+    SizeValueType m_Target{ 0 };
+    SizeValueType m_Union{ 0 };
+    SizeValueType m_Intersection{ 0 };
+    SizeValueType m_SourceComplement{ 0 };
+    SizeValueType m_TargetComplement{ 0 };
+    SizeValueType m_SourceSurface{ 0 };
+    SizeValueType m_TargetSurface{ 0 };
+    RealType      m_HausdorffDistance{ 0.0 };
+    RealType      m_PercentileHausdorffDistance{ 0.0 };
+    RealType      m_AverageSurfaceDistance{ 0.0 };
+  };
+
+  /** Type of the map used to store data per label */
+  using MapType = std::unordered_map<LabelType, LabelSetMeasures>;
+
+  /** Set the label images */
+  itkSetInputMacro(SourceImage, LabelImageType);
+  itkGetInputMacro(SourceImage, LabelImageType);
+  itkSetInputMacro(TargetImage, LabelImageType);
+  itkGetInputMacro(TargetImage, LabelImageType);
+
+  /** Set/Get if image spacing should be used in computing distances. */
+  itkSetMacro(UseImageSpacing, bool);
+  itkGetConstMacro(UseImageSpacing, bool);
+  itkBooleanMacro(UseImageSpacing);
+
+  /** Set/Get the percentile of the percentile Hausdorff distance, between 0
+   * and 100. Default value is 95. */
+  itkSetClampMacro(Percentile, double, 0.0, 100.0);
+  itkGetConstMacro(Percentile, double);
+
+  /** Get the measures of the labels other than the background. */
+  const MapType &
+  GetLabelSetMeasures() const
+  {
+    return m_LabelSetMeasures;
+  }
+
+  /** Get the Hausdorff distance between the surfaces of a label. */
+  RealType GetHausdorffDistance(LabelType) const;
+
+  /** Get the percentile Hausdorff distance between the surfaces of a
+   * label. */
+  RealType GetPercentileHausdorffDistance(LabelType) const;
+
+  /** Get the average surface distance between the surfaces of a label. */
+  RealType GetAverageSurfaceDistance(LabelType) const;
+
+  /** Get the mean overlap (Dice coefficient) of a label. */
+  RealType GetDiceCoefficient(LabelType) const;
+
+  /** Get the union overlap (Jaccard coefficient) of a label. */
+  RealType GetJaccardCoefficient(LabelType) const;
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  // Begin concept checking
+  itkConceptMacro(InputHasNumericTraitsCheck, (Concept::HasNumericTraits<LabelType>));
+  // End concept checking
+#endif
+
+protected:
+  LabelSurfaceDistanceMeasuresImageFilter();
+  ~LabelSurfaceDistanceMeasuresImageFilter() override = default;
+
+  /** Type to use for printing label values (e.g. in warnings). */
+  using PrintType = typename NumericTraits<LabelType>::PrintType;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  void
+  GenerateData() override;
+
+  // Override since the filter needs all the data for the algorithm
+  void
+  GenerateInputRequestedRegion() override;
+
+  // Override since the filter produces all of its output
+  void
+  EnlargeOutputRequestedRegion(DataObject * data) override;
+
+private:
+  /** Minimum number of pixels of the bounding box of a label processed by
+   * all the work units together. */
+  static constexpr SizeValueType MinimumLargeLabelBoxSize = 65536;
+
+  /** The counts, the surface pixels and the bounding box of the surfaces of
+   * a label. */
+  struct LabelSurfaces
+  {
+    LabelSetMeasures       m_Measures{};
+    std::vector<IndexType> m_SourceSurface{};
+    std::vector<IndexType> m_TargetSurface{};
+    RegionType             m_BoundingBox{};
+  };
+  using LabelSurfacesMapType = std::unordered_map<LabelType, LabelSurfaces>;
+
+  /** Count the overlaps and extract the surfaces in a region. */
+  void
+  ExtractSurfaces(const RegionType & region, LabelSurfacesMapType & labelSurfaces) const;
+
+  /** Compute the surface distances of a label, in parallel if requested. */
+  void
+  ComputeSurfaceDistances(LabelSurfaces & labelSurfaces, bool parallel);
+
+  /** Compute the distances from the pixels of a surface to the pixels of
+   * another one, in a region that contains both. */
+  void
+  ComputeDistancesToSurface(const RegionType &             region,
+                            const std::vector<IndexType> & fromSurface,
+                            const std::vector<IndexType> & toSurface,
+                            bool                           parallel,
+                            std::vector<RealType> &        distances);
+
+  /** Get the measures of a label, or warn and return nullptr if the label
+   * is not found. */
+  const LabelSetMeasures *
+  FindLabelSetMeasures(LabelType label) const;
+
+  MapType m_LabelSetMeasures{};
+  bool    m_UseImageSpacing{ true };
+  double  m_Percentile{ 95.0 };
+}; // end of class
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkLabelSurfaceDistanceMeasuresImageFilter.hxx"
+#endif
+
+#endif
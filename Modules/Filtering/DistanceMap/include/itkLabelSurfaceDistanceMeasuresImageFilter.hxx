@@ -0,0 +1,550 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkLabelSurfaceDistanceMeasuresImageFilter_hxx
+#define itkLabelSurfaceDistanceMeasuresImageFilter_hxx
+
+#include "itkCompensatedSummation.h"
+#include "itkImageScanlineConstIterator.h"
+#include "itkMath.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+namespace itk
+{
+
+template <typename TLabelImage>
+LabelSurfaceDistanceMeasuresImageFilter<TLabelImage>::LabelSurfaceDistanceMeasuresImageFilter()
+{
+  // Primary input is source image, secondary input is target image
+  Self::SetPrimaryInputName("SourceImage");
+  Self::AddRequiredInputName("TargetImage", 1);
+  this->SetNumberOfRequiredInputs(2);
+}
+
+template <typename TLabelImage>
+void
+LabelSurfaceDistanceMeasuresImageFilter<TLabelImage>::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  // This filter needs all of the source image, and the same region of the
+  // target image
+  if (this->GetSourceImage())
+  {
+    auto * source = const_cast<LabelImageType *>(this->GetSourceImage());
+    source->SetRequestedRegionToLargestPossibleRegion();
+
+    if (this->GetTargetImage())
+    {
+      auto * target = const_cast<LabelImageType *>(this->GetTargetImage());
+      target->SetRequestedRegion(source->GetRequestedRegion());
+    }
+  }
+}
+
+template <typename TLabelImage>
+void
+LabelSurfaceDistanceMeasuresImageFilter<TLabelImage>::EnlargeOutputRequestedRegion(DataObject * data)
+{
+  Superclass::EnlargeOutputRequestedRegion(data);
+  data->SetRequestedRegionToLargestPossibleRegion();
+}
+
+template <typename TLabelImage>
+void
+LabelSurfaceDistanceMeasuresImageFilter<TLabelImage>::GenerateData()
+{
+  const LabelImageType * sourceImage = this->GetSourceImage();
+
+  // Pass the source image through as the output
+  this->GraftOutput(const_cast<LabelImageType *>(sourceImage));
+
+  m_LabelSetMeasures.clear();
+
+  MultiThreaderBase * multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+
+  // Count the overlaps and extract the surfaces of all the labels in one pass
+  LabelSurfacesMapType labelSurfaces;
+  std::mutex           mutex;
+  multiThreader->template ParallelizeImageRegion<ImageDimension>(
+    sourceImage->GetRequestedRegion(),
+    [this, &labelSurfaces, &mutex](const RegionType & region) {
+      LabelSurfacesMapType regionLabelSurfaces;
+      this->ExtractSurfaces(region, regionLabelSurfaces);
+
+      const std::lock_guard<std::mutex> lockGuard(mutex);
+      for (auto & regionLabel : regionLabelSurfaces)
+      {
+        LabelSurfaces &          surfaces = labelSurfaces[regionLabel.first];
+        const LabelSetMeasures & regionMeasures = regionLabel.second.m_Measures;
+        surfaces.m_Measures.m_Source += regionMeasures.m_Source;
+        surfaces.m_Measures.m_Target += regionMeasures.m_Target;
+        surfaces.m_Measures.m_Union += regionMeasures.m_Union;
+        surfaces.m_Measures.m_Intersection += regionMeasures.m_Intersection;
+        surfaces.m_Measures.m_SourceComplement += regionMeasures.m_SourceComplement;
+        surfaces.m_Measures.m_TargetComplement += regionMeasures.m_TargetComplement;
+        surfaces.m_SourceSurface.insert(surfaces.m_SourceSurface.end(),
+                                        regionLabel.second.m_SourceSurface.begin(),
+                                        regionLabel.second.m_SourceSurface.end());
+        surfaces.m_TargetSurface.insert(surfaces.m_TargetSurface.end(),
+                                        regionLabel.second.m_TargetSurface.begin(),
+                                        regionLabel.second.m_TargetSurface.end());
+      }
+    },
+    nullptr);
+
+  // Compute the bounding boxes of the surfaces of the labels, and process the
+  // labels from the largest bounding box to the smallest
+  std::vector<std::pair<SizeValueType, LabelSurfaces *>> labels;
+  labels.reserve(labelSurfaces.size());
+  SizeValueType totalSize = 0;
+  for (auto & label : labelSurfaces)
+  {
+    LabelSurfaces & surfaces = label.second;
+    SizeValueType   boxSize = 0;
+    if (!surfaces.m_SourceSurface.empty() && !surfaces.m_TargetSurface.empty())
+    {
+      IndexType minimum = surfaces.m_SourceSurface.front();
+      IndexType maximum = minimum;
+      for (const std::vector<IndexType> * surface : { &surfaces.m_SourceSurface, &surfaces.m_TargetSurface })
+      {
+        for (const IndexType & index : *surface)
+        {
+          for (unsigned int i = 0; i < ImageDimension; ++i)
+          {
+            minimum[i] = std::min(minimum[i], index[i]);
+            maximum[i] = std::max(maximum[i], index[i]);
+          }
+        }
+      }
+      surfaces.m_BoundingBox.SetIndex(minimum);
+      surfaces.m_BoundingBox.SetUpperIndex(maximum);
+      boxSize = surfaces.m_BoundingBox.GetNumberOfPixels();
+    }
+    totalSize += boxSize;
+    labels.emplace_back(boxSize, &surfaces);
+  }
+  std::stable_sort(labels.begin(), labels.end(), [](const auto & a, const auto & b) { return a.first > b.first; });
+
+  // The labels whose bounding box is larger than the share of a work unit
+  // are processed one at a time by all the work units together, and the
+  // others are each processed by a single work unit
+  const ThreadIdType numberOfWorkUnits = multiThreader->GetNumberOfWorkUnits();
+  SizeValueType      numberOfLargeLabels = 0;
+  while (numberOfLargeLabels < labels.size() && numberOfWorkUnits > 1 &&
+         labels[numberOfLargeLabels].first >= MinimumLargeLabelBoxSize &&
+         labels[numberOfLargeLabels].first * numberOfWorkUnits > totalSize)
+  {
+    this->ComputeSurfaceDistances(*labels[numberOfLargeLabels].second, true);
+    ++numberOfLargeLabels;
+  }
+
+  std::atomic<SizeValueType> nextLabel{ numberOfLargeLabels };
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfWorkUnits,
+    [this, &labels, &nextLabel](SizeValueType) {
+      for (SizeValueType i = nextLabel++; i < labels.size(); i = nextLabel++)
+      {
+        this->ComputeSurfaceDistances(*labels[i].second, false);
+      }
+    },
+    nullptr);
+
+  for (const auto & label : labelSurfaces)
+  {
+    m_LabelSetMeasures.emplace(label.first, label.second.m_Measures);
+  }
+}
+
+template <typename TLabelImage>
+void
+LabelSurfaceDistanceMeasuresImageFilter<TLabelImage>::ExtractSurfaces(const RegionType &     region,
+                                                                      LabelSurfacesMapType & labelSurfaces) const
+{
+  const LabelImageType * sourceImage = this->GetSourceImage();
+  const LabelImageType * targetImage = this->GetTargetImage();
+
+  const RegionType & largestRegion = sourceImage->GetLargestPossibleRegion();
+  const IndexType    lowerIndex = largestRegion.GetIndex();
+  const IndexType    upperIndex = largestRegion.GetUpperIndex();
+
+  // A pixel is on the surface of its label if it is on the border of the
+  // image, or if one of its face neighbors has another label
+  const auto isOnSurface = [&lowerIndex, &upperIndex](
+                             const LabelImageType * image, const LabelType * pixel, const IndexType & index) {
+    const OffsetValueType * offsetTable = image->GetOffsetTable();
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      if (index[i] == lowerIndex[i] || index[i] == upperIndex[i] || pixel[-offsetTable[i]] != *pixel ||
+          pixel[offsetTable[i]] != *pixel)
+      {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  // Runs of pixels mostly have the same label, so the last label is cached
+  const auto findLabelSurfaces = [&labelSurfaces](LabelType label, LabelType & cachedLabel, LabelSurfaces *& cached) {
+    if (cached == nullptr || label != cachedLabel)
+    {
+      cachedLabel = label;
+      cached = &labelSurfaces[label];
+    }
+    return cached;
+  };
+  LabelType       cachedSourceLabel{};
+  LabelType       cachedTargetLabel{};
+  LabelSurfaces * cachedSource = nullptr;
+  LabelSurfaces * cachedTarget = nullptr;
+
+  const LabelType backgroundLabel{};
+  for (ImageScanlineConstIterator<LabelImageType> it(sourceImage, region); !it.IsAtEnd(); it.NextLine())
+  {
+    IndexType            index = it.GetIndex();
+    const LabelType *    sourcePixel = sourceImage->GetBufferPointer() + sourceImage->ComputeOffset(index);
+    const LabelType *    targetPixel = targetImage->GetBufferPointer() + targetImage->ComputeOffset(index);
+    const IndexValueType endIndex = index[0] + static_cast<IndexValueType>(region.GetSize(0));
+    for (; index[0] < endIndex; ++index[0], ++sourcePixel, ++targetPixel)
+    {
+      const LabelType sourceLabel = *sourcePixel;
+      const LabelType targetLabel = *targetPixel;
+      if (sourceLabel != backgroundLabel)
+      {
+        LabelSurfaces * surfaces = findLabelSurfaces(sourceLabel, cachedSourceLabel, cachedSource);
+        ++surfaces->m_Measures.m_Source;
+        ++surfaces->m_Measures.m_Union;
+        if (sourceLabel == targetLabel)
+        {
+          ++surfaces->m_Measures.m_Intersection;
+        }
+        else
+        {
+          ++surfaces->m_Measures.m_SourceComplement;
+        }
+        if (isOnSurface(sourceImage, sourcePixel, index))
+        {
+          surfaces->m_SourceSurface.push_back(index);
+        }
+      }
+      if (targetLabel != backgroundLabel)
+      {
+        LabelSurfaces * surfaces = findLabelSurfaces(targetLabel, cachedTargetLabel, cachedTarget);
+        ++surfaces->m_Measures.m_Target;
+        if (sourceLabel != targetLabel)
+        {
+          ++surfaces->m_Measures.m_Union;
+          ++surfaces->m_Measures.m_TargetComplement;
+        }
+        if (isOnSurface(targetImage, targetPixel, index))
+        {
+          surfaces->m_TargetSurface.push_back(index);
+        }
+      }
+    }
+  }
+}
+
+template <typename TLabelImage>
+void
+LabelSurfaceDistanceMeasuresImageFilter<TLabelImage>::ComputeSurfaceDistances(LabelSurfaces & labelSurfaces,
+                                                                              bool            parallel)
+{
+  LabelSetMeasures & measures = labelSurfaces.m_Measures;
+  measures.m_SourceSurface = labelSurfaces.m_SourceSurface.size();
+  measures.m_TargetSurface = labelSurfaces.m_TargetSurface.size();
+
+  if (labelSurfaces.m_SourceSurface.empty() || labelSurfaces.m_TargetSurface.empty())
+  {
+    measures.m_HausdorffDistance = NumericTraits<RealType>::max();
+    measures.m_PercentileHausdorffDistance = NumericTraits<RealType>::max();
+    measures.m_AverageSurfaceDistance = NumericTraits<RealType>::max();
+    return;
+  }
+
+  std::vector<RealType> sourceDistances;
+  std::vector<RealType> targetDistances;
+  this->ComputeDistancesToSurface(labelSurfaces.m_BoundingBox,
+                                  labelSurfaces.m_SourceSurface,
+                                  labelSurfaces.m_TargetSurface,
+                                  parallel,
+                                  sourceDistances);
+  this->ComputeDistancesToSurface(labelSurfaces.m_BoundingBox,
+                                  labelSurfaces.m_TargetSurface,
+                                  labelSurfaces.m_SourceSurface,
+                                  parallel,
+                                  targetDistances);
+  std::vector<IndexType>().swap(labelSurfaces.m_SourceSurface);
+  std::vector<IndexType>().swap(labelSurfaces.m_TargetSurface);
+
+  // The distances are sorted, so that the measures do not depend on the order
+  // in which the surface pixels were extracted
+  std::sort(sourceDistances.begin(), sourceDistances.end());
+  std::sort(targetDistances.begin(), targetDistances.end());
+
+  const auto percentile = [this](const std::vector<RealType> & sortedDistances) {
+    const double position = m_Percentile / 100.0 * static_cast<double>(sortedDistances.size() - 1);
+    const auto   lower = static_cast<size_t>(position);
+    if (lower + 1 >= sortedDistances.size())
+    {
+      return sortedDistances.back();
+    }
+    return static_cast<RealType>(sortedDistances[lower] + (position - static_cast<double>(lower)) *
+                                                            (sortedDistances[lower + 1] - sortedDistances[lower]));
+  };
+
+  CompensatedSummation<RealType> sum;
+  for (const std::vector<RealType> * distances : { &sourceDistances, &targetDistances })
+  {
+    for (const RealType distance : *distances)
+    {
+      sum += distance;
+    }
+  }
+
+  measures.m_HausdorffDistance = std::max(sourceDistances.back(), targetDistances.back());
+  measures.m_PercentileHausdorffDistance = std::max(percentile(sourceDistances), percentile(targetDistances));
+  measures.m_AverageSurfaceDistance =
+    sum.GetSum() / static_cast<RealType>(sourceDistances.size() + targetDistances.size());
+}
+
+template <typename TLabelImage>
+void
+LabelSurfaceDistanceMeasuresImageFilter<TLabelImage>::ComputeDistancesToSurface(
+  const RegionType &             region,
+  const std::vector<IndexType> & fromSurface,
+  const std::vector<IndexType> & toSurface,
+  bool                           parallel,
+  std::vector<RealType> &        distances)
+{
+  const SizeType &  size = region.GetSize();
+  const IndexType & start = region.GetIndex();
+
+  OffsetValueType strides[ImageDimension];
+  strides[0] = 1;
+  for (unsigned int i = 1; i < ImageDimension; ++i)
+  {
+    strides[i] = strides[i - 1] * static_cast<OffsetValueType>(size[i - 1]);
+  }
+  const auto computeOffset = [&start, &strides](const IndexType & index) {
+    OffsetValueType offset = 0;
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      offset += (index[i] - start[i]) * strides[i];
+    }
+    return offset;
+  };
+
+  double spacing[ImageDimension];
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    spacing[i] = m_UseImageSpacing ? this->GetSourceImage()->GetSpacing()[i] : 1.0;
+  }
+
+  // Squared distance transform of the surface: zero on its pixels, infinite
+  // elsewhere, and then the lower envelope of the parabolas rooted at the
+  // finite values along the lines of each dimension in turn (Felzenszwalb and
+  // Huttenlocher, Distance Transforms of Sampled Functions, 2012)
+  constexpr double    infinity = std::numeric_limits<double>::infinity();
+  std::vector<double> squaredDistances(region.GetNumberOfPixels(), infinity);
+  for (const IndexType & index : toSurface)
+  {
+    squaredDistances[computeOffset(index)] = 0.0;
+  }
+
+  const ThreadIdType numberOfWorkUnits = this->GetMultiThreader()->GetNumberOfWorkUnits();
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+  {
+    const SizeValueType   lineSize = size[d];
+    const SizeValueType   numberOfLines = region.GetNumberOfPixels() / lineSize;
+    const OffsetValueType stride = strides[d];
+    const double          lineSpacing = spacing[d];
+
+    const auto transformLines = [&, d, lineSize, stride, lineSpacing](SizeValueType firstLine, SizeValueType endLine) {
+      std::vector<double>        values(lineSize);
+      std::vector<SizeValueType> parabolas(lineSize);
+      std::vector<double>        boundaries(lineSize);
+      for (SizeValueType line = firstLine; line < endLine; ++line)
+      {
+        // Offset of the first pixel of the line
+        OffsetValueType lineOffset = 0;
+        SizeValueType   remainder = line;
+        for (unsigned int i = 0; i < ImageDimension; ++i)
+        {
+          if (i != d)
+          {
+            lineOffset += static_cast<OffsetValueType>(remainder % size[i]) * strides[i];
+            remainder /= size[i];
+          }
+        }
+        double * lineDistances = squaredDistances.data() + lineOffset;
+
+        // Lower envelope of the parabolas, each one starting at its left
+        // boundary with the previous one
+        SizeValueType numberOfParabolas = 0;
+        for (SizeValueType q = 0; q < lineSize; ++q)
+        {
+          values[q] = lineDistances[static_cast<OffsetValueType>(q) * stride];
+          if (values[q] == infinity)
+          {
+            continue;
+          }
+          const double x = static_cast<double>(q) * lineSpacing;
+          double       boundary = -infinity;
+          while (numberOfParabolas > 0)
+          {
+            const SizeValueType p = parabolas[numberOfParabolas - 1];
+            const double        xp = static_cast<double>(p) * lineSpacing;
+            boundary = ((values[q] + x * x) - (values[p] + xp * xp)) / (2.0 * (x - xp));
+            if (boundary > boundaries[numberOfParabolas - 1])
+            {
+              break;
+            }
+            --numberOfParabolas;
+            boundary = -infinity;
+          }
+          parabolas[numberOfParabolas] = q;
+          boundaries[numberOfParabolas] = boundary;
+          ++numberOfParabolas;
+        }
+        if (numberOfParabolas == 0)
+        {
+          continue;
+        }
+
+        SizeValueType k = 0;
+        for (SizeValueType q = 0; q < lineSize; ++q)
+        {
+          const double x = static_cast<double>(q) * lineSpacing;
+          while (k + 1 < numberOfParabolas && boundaries[k + 1] < x)
+          {
+            ++k;
+          }
+          const double dx = x - static_cast<double>(parabolas[k]) * lineSpacing;
+          lineDistances[static_cast<OffsetValueType>(q) * stride] = dx * dx + values[parabolas[k]];
+        }
+      }
+    };
+
+    if (parallel)
+    {
+      const SizeValueType numberOfChunks = std::min(numberOfLines, static_cast<SizeValueType>(4 * numberOfWorkUnits));
+      this->GetMultiThreader()->ParallelizeArray(
+        0,
+        numberOfChunks,
+        [&transformLines, numberOfLines, numberOfChunks](SizeValueType chunk) {
+          transformLines(chunk * numberOfLines / numberOfChunks, (chunk + 1) * numberOfLines / numberOfChunks);
+        },
+        nullptr);
+    }
+    else
+    {
+      transformLines(0, numberOfLines);
+    }
+  }
+
+  distances.resize(fromSurface.size());
+  for (size_t i = 0; i < fromSurface.size(); ++i)
+  {
+    distances[i] = static_cast<RealType>(std::sqrt(squaredDistances[computeOffset(fromSurface[i])]));
+  }
+}
+
+template <typename TLabelImage>
+auto
+LabelSurfaceDistanceMeasuresImageFilter<TLabelImage>::FindLabelSetMeasures(LabelType label) const
+  -> const LabelSetMeasures *
+{
+  auto mapIt = m_LabelSetMeasures.find(label);
+  if (mapIt == m_LabelSetMeasures.end())
+  {
+    itkWarningMacro("Label " << static_cast<PrintType>(label) << " not found.");
+    return nullptr;
+  }
+  return &mapIt->second;
+}
+
+template <typename TLabelImage>
+auto
+LabelSurfaceDistanceMeasuresImageFilter<TLabelImage>::GetHausdorffDistance(LabelType label) const -> RealType
+{
+  const LabelSetMeasures * measures = this->FindLabelSetMeasures(label);
+  return measures ? measures->m_HausdorffDistance : 0.0;
+}
+
+template <typename TLabelImage>
+auto
+LabelSurfaceDistanceMeasuresImageFilter<TLabelImage>::GetPercentileHausdorffDistance(LabelType label) const
+  -> RealType
+{
+  const LabelSetMeasures * measures = this->FindLabelSetMeasures(label);
+  return measures ? measures->m_PercentileHausdorffDistance : 0.0;
+}
+
+template <typename TLabelImage>
+auto
+LabelSurfaceDistanceMeasuresImageFilter<TLabelImage>::GetAverageSurfaceDistance(LabelType label) const -> RealType
+{
+  const LabelSetMeasures * measures = this->FindLabelSetMeasures(label);
+  return measures ? measures->m_AverageSurfaceDistance : 0.0;
+}
+
+template <typename TLabelImage>
+auto
+LabelSurfaceDistanceMeasuresImageFilter<TLabelImage>::GetDiceCoefficient(LabelType label) const -> RealType
+{
+  const LabelSetMeasures * measures = this->FindLabelSetMeasures(label);
+  if (measures == nullptr)
+  {
+    return 0.0;
+  }
+  return 2.0 * static_cast<RealType>(measures->m_Intersection) /
+         static_cast<RealType>(measures->m_Source + measures->m_Target);
+}
+
+template <typename TLabelImage>
+auto
+LabelSurfaceDistanceMeasuresImageFilter<TLabelImage>::GetJaccardCoefficient(LabelType label) const -> RealType
+{
+  const LabelSetMeasures * measures = this->FindLabelSetMeasures(label);
+  if (measures == nullptr)
+  {
+    return 0.0;
+  }
+  return static_cast<RealType>(measures->m_Intersection) / static_cast<RealType>(measures->m_Union);
+}
+
+template <typename TLabelImage>
+void
+LabelSurfaceDistanceMeasuresImageFilter<TLabelImage>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "UseImageSpacing: " << (m_UseImageSpacing ? "On" : "Off") << std::endl;
+  os << indent << "Percentile: " << m_Percentile << std::endl;
+  os << indent << "Number of labels: " << m_LabelSetMeasures.size() << std::endl;
+}
+
+} // end namespace itk
+
+#endif
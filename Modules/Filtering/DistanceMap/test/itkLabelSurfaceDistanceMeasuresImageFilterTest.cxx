@@ -0,0 +1,327 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkLabelSurfaceDistanceMeasuresImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkMath.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+#include <map>
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using LabelType = unsigned short;
+using ImageType = itk::Image<LabelType, Dimension>;
+using FilterType = itk::LabelSurfaceDistanceMeasuresImageFilter<ImageType>;
+
+// Draw a ball of a label, and boxes of other labels, and scatter pixels of
+// another label.
+void
+DrawLabels(ImageType * image, const itk::Index<Dimension> & center, double radius, unsigned int seed)
+{
+  auto randomGenerator = itk::Statistics::MersenneTwisterRandomVariateGenerator::New();
+  randomGenerator->Initialize(seed);
+
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType index = it.GetIndex();
+    double                     squaredDistance = 0.0;
+    for (unsigned int i = 0; i < Dimension; ++i)
+    {
+      squaredDistance += itk::Math::sqr(static_cast<double>(index[i] - center[i]));
+    }
+    LabelType label = 0;
+    if (squaredDistance <= radius * radius)
+    {
+      label = 1;
+    }
+    else if (index[0] >= 2 && index[0] < 9 + static_cast<int>(seed % 3) && index[1] < 12 && index[2] >= 30)
+    {
+      label = 2;
+    }
+    else if (index[0] >= 62 && index[1] >= 50 - static_cast<int>(seed % 4) && index[2] < 10)
+    {
+      label = 3;
+    }
+    else if (randomGenerator->GetIntegerVariate(199) == 0)
+    {
+      label = 5;
+    }
+    it.Set(label);
+  }
+}
+
+// Surface pixels of the labels, as defined by the filter.
+std::map<LabelType, std::vector<ImageType::IndexType>>
+ExtractSurfaces(const ImageType * image)
+{
+  const ImageType::RegionType                            region = image->GetLargestPossibleRegion();
+  std::map<LabelType, std::vector<ImageType::IndexType>> surfaces;
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() == 0)
+    {
+      continue;
+    }
+    bool onSurface = false;
+    for (unsigned int i = 0; i < Dimension; ++i)
+    {
+      for (const int step : { -1, 1 })
+      {
+        ImageType::IndexType neighbor = it.GetIndex();
+        neighbor[i] += step;
+        onSurface = onSurface || !region.IsInside(neighbor) || image->GetPixel(neighbor) != it.Get();
+      }
+    }
+    if (onSurface)
+    {
+      surfaces[it.Get()].push_back(it.GetIndex());
+    }
+  }
+  return surfaces;
+}
+
+// Sorted distances from the pixels of a surface to another surface.
+std::vector<double>
+ComputeDistances(const std::vector<ImageType::IndexType> & fromSurface,
+                 const std::vector<ImageType::IndexType> & toSurface,
+                 const double *                            spacing)
+{
+  std::vector<double> distances;
+  for (const ImageType::IndexType & from : fromSurface)
+  {
+    double minimum = itk::NumericTraits<double>::max();
+    for (const ImageType::IndexType & to : toSurface)
+    {
+      double squaredDistance = 0.0;
+      for (unsigned int i = 0; i < Dimension; ++i)
+      {
+        squaredDistance += itk::Math::sqr(static_cast<double>(from[i] - to[i]) * spacing[i]);
+      }
+      minimum = std::min(minimum, squaredDistance);
+    }
+    distances.push_back(std::sqrt(minimum));
+  }
+  std::sort(distances.begin(), distances.end());
+  return distances;
+}
+
+double
+ComputePercentile(const std::vector<double> & sortedDistances, double percentile)
+{
+  const double position = percentile / 100.0 * static_cast<double>(sortedDistances.size() - 1);
+  const auto   lower = static_cast<size_t>(position);
+  if (lower + 1 >= sortedDistances.size())
+  {
+    return sortedDistances.back();
+  }
+  return sortedDistances[lower] +
+         (position - static_cast<double>(lower)) * (sortedDistances[lower + 1] - sortedDistances[lower]);
+}
+
+bool
+CheckValue(double value, double expected, const char * name, LabelType label)
+{
+  if (itk::Math::abs(value - expected) > 1e-9 * (1.0 + itk::Math::abs(expected)))
+  {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "Error in the " << name << " of the label " << label << std::endl;
+    std::cerr << "Expected " << expected << ", but got " << value << std::endl;
+    return false;
+  }
+  return true;
+}
+} // namespace
+
+/* Compute the measures of labels of two images, one of which is only in the
+ * source image, and compare them with the ones computed directly from the
+ * surface pixels, with and without image spacing, and with one or several
+ * work units. The bounding box of the ball is large enough for its distance
+ * transforms to be computed by all the work units together. */
+int
+itkLabelSurfaceDistanceMeasuresImageFilterTest(int, char *[])
+{
+  const ImageType::RegionType  region({ 0, 0, 0 }, { 71, 63, 41 });
+  const ImageType::SpacingType spacing(itk::MakeVector(1.0, 0.7, 1.8));
+
+  auto sourceImage = ImageType::New();
+  sourceImage->SetRegions(region);
+  sourceImage->SetSpacing(spacing);
+  sourceImage->Allocate();
+  DrawLabels(sourceImage, { { 34, 30, 20 } }, 25.0, 1);
+
+  auto targetImage = ImageType::New();
+  targetImage->SetRegions(region);
+  targetImage->SetSpacing(spacing);
+  targetImage->Allocate();
+  DrawLabels(targetImage, { { 37, 28, 19 } }, 22.5, 2);
+
+  // A label that is only in the source image
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(sourceImage, { { 60, 2, 35 }, { 5, 4, 3 } }); !it.IsAtEnd();
+       ++it)
+  {
+    it.Set(4);
+  }
+
+  auto filter = FilterType::New();
+
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(filter, LabelSurfaceDistanceMeasuresImageFilter, ImageToImageFilter);
+
+  ITK_TEST_SET_GET_BOOLEAN(filter, UseImageSpacing, true);
+  ITK_TEST_SET_GET_VALUE(95.0, filter->GetPercentile());
+  filter->SetPercentile(150.0);
+  ITK_TEST_SET_GET_VALUE(100.0, filter->GetPercentile());
+  filter->SetPercentile(90.0);
+  ITK_TEST_SET_GET_VALUE(90.0, filter->GetPercentile());
+
+  filter->SetSourceImage(sourceImage);
+  filter->SetTargetImage(targetImage);
+
+  const std::map<LabelType, std::vector<ImageType::IndexType>> sourceSurfaces = ExtractSurfaces(sourceImage);
+  const std::map<LabelType, std::vector<ImageType::IndexType>> targetSurfaces = ExtractSurfaces(targetImage);
+
+  for (const bool useImageSpacing : { true, false })
+  {
+    const double unitSpacing[Dimension] = { 1.0, 1.0, 1.0 };
+    const double * distanceSpacing = useImageSpacing ? spacing.GetDataPointer() : unitSpacing;
+
+    FilterType::MapType firstMeasures;
+    for (const itk::ThreadIdType numberOfWorkUnits : { 1, 4 })
+    {
+      std::cout << "UseImageSpacing: " << useImageSpacing << ", number of work units: " << numberOfWorkUnits
+                << std::endl;
+      filter->SetUseImageSpacing(useImageSpacing);
+      filter->SetNumberOfWorkUnits(numberOfWorkUnits);
+      ITK_TRY_EXPECT_NO_EXCEPTION(filter->Update());
+
+      const FilterType::MapType & measures = filter->GetLabelSetMeasures();
+      ITK_TEST_EXPECT_EQUAL(measures.size(), 5u);
+
+      // The overlap counts are the ones of the pixels
+      std::map<LabelType, FilterType::LabelSetMeasures> expectedCounts;
+      itk::ImageRegionConstIterator<ImageType>          targetIt(targetImage, region);
+      for (itk::ImageRegionConstIterator<ImageType> sourceIt(sourceImage, region); !sourceIt.IsAtEnd();
+           ++sourceIt, ++targetIt)
+      {
+        const LabelType sourceLabel = sourceIt.Get();
+        const LabelType targetLabel = targetIt.Get();
+        ++expectedCounts[sourceLabel].m_Source;
+        ++expectedCounts[targetLabel].m_Target;
+        ++expectedCounts[sourceLabel].m_Union;
+        if (sourceLabel == targetLabel)
+        {
+          ++expectedCounts[sourceLabel].m_Intersection;
+        }
+        else
+        {
+          ++expectedCounts[targetLabel].m_Union;
+          ++expectedCounts[sourceLabel].m_SourceComplement;
+          ++expectedCounts[targetLabel].m_TargetComplement;
+        }
+      }
+
+      for (const auto & labelMeasures : measures)
+      {
+        const LabelType                      label = labelMeasures.first;
+        const FilterType::LabelSetMeasures & actual = labelMeasures.second;
+        const FilterType::LabelSetMeasures & expected = expectedCounts[label];
+        ITK_TEST_EXPECT_EQUAL(actual.m_Source, expected.m_Source);
+        ITK_TEST_EXPECT_EQUAL(actual.m_Target, expected.m_Target);
+        ITK_TEST_EXPECT_EQUAL(actual.m_Union, expected.m_Union);
+        ITK_TEST_EXPECT_EQUAL(actual.m_Intersection, expected.m_Intersection);
+        ITK_TEST_EXPECT_EQUAL(actual.m_SourceComplement, expected.m_SourceComplement);
+        ITK_TEST_EXPECT_EQUAL(actual.m_TargetComplement, expected.m_TargetComplement);
+        if (!CheckValue(filter->GetDiceCoefficient(label),
+                        2.0 * expected.m_Intersection / (expected.m_Source + expected.m_Target),
+                        "Dice coefficient",
+                        label) ||
+            !CheckValue(filter->GetJaccardCoefficient(label),
+                        static_cast<double>(expected.m_Intersection) / expected.m_Union,
+                        "Jaccard coefficient",
+                        label))
+        {
+          return EXIT_FAILURE;
+        }
+
+        const auto sourceSurface = sourceSurfaces.find(label);
+        const auto targetSurface = targetSurfaces.find(label);
+        if (targetSurface == targetSurfaces.end())
+        {
+          ITK_TEST_EXPECT_EQUAL(actual.m_SourceSurface, sourceSurface->second.size());
+          ITK_TEST_EXPECT_EQUAL(actual.m_TargetSurface, 0u);
+          ITK_TEST_EXPECT_EQUAL(filter->GetHausdorffDistance(label), itk::NumericTraits<double>::max());
+          ITK_TEST_EXPECT_EQUAL(filter->GetAverageSurfaceDistance(label), itk::NumericTraits<double>::max());
+          continue;
+        }
+        ITK_TEST_EXPECT_EQUAL(actual.m_SourceSurface, sourceSurface->second.size());
+        ITK_TEST_EXPECT_EQUAL(actual.m_TargetSurface, targetSurface->second.size());
+
+        const std::vector<double> sourceDistances =
+          ComputeDistances(sourceSurface->second, targetSurface->second, distanceSpacing);
+        const std::vector<double> targetDistances =
+          ComputeDistances(targetSurface->second, sourceSurface->second, distanceSpacing);
+        double sum = 0.0;
+        for (const double distance : sourceDistances)
+        {
+          sum += distance;
+        }
+        for (const double distance : targetDistances)
+        {
+          sum += distance;
+        }
+        const double expectedHausdorff = std::max(sourceDistances.back(), targetDistances.back());
+        const double expectedPercentile =
+          std::max(ComputePercentile(sourceDistances, 90.0), ComputePercentile(targetDistances, 90.0));
+        const double expectedAverage = sum / static_cast<double>(sourceDistances.size() + targetDistances.size());
+        if (!CheckValue(filter->GetHausdorffDistance(label), expectedHausdorff, "Hausdorff distance", label) ||
+            !CheckValue(filter->GetPercentileHausdorffDistance(label),
+                        expectedPercentile,
+                        "percentile Hausdorff distance",
+                        label) ||
+            !CheckValue(filter->GetAverageSurfaceDistance(label), expectedAverage, "average surface distance", label))
+        {
+          return EXIT_FAILURE;
+        }
+      }
+
+      // The measures do not depend on the number of work units
+      if (firstMeasures.empty())
+      {
+        firstMeasures = measures;
+      }
+      for (const auto & labelMeasures : firstMeasures)
+      {
+        const FilterType::LabelSetMeasures & actual = measures.at(labelMeasures.first);
+        ITK_TEST_EXPECT_EQUAL(actual.m_HausdorffDistance, labelMeasures.second.m_HausdorffDistance);
+        ITK_TEST_EXPECT_EQUAL(actual.m_PercentileHausdorffDistance,
+                              labelMeasures.second.m_PercentileHausdorffDistance);
+        ITK_TEST_EXPECT_EQUAL(actual.m_AverageSurfaceDistance, labelMeasures.second.m_AverageSurfaceDistance);
+      }
+    }
+  }
+
+  // A label that is in neither image
+  ITK_TEST_EXPECT_EQUAL(filter->GetHausdorffDistance(7), 0.0);
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
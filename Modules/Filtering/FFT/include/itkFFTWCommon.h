@@ -34,11 +34,40 @@
 #endif
 
 #include <mutex>
+#include <sstream>
+#include <string>
 
 namespace itk
 {
 namespace fftw
 {
+#if (defined(ITK_USE_FFTWF) || defined(ITK_USE_FFTWD)) && !defined(ITK_USE_CUFFTW)
+/** Build the key of a plan in the plan cache of FFTWGlobalConfiguration.
+ * A plan can only be executed on new arrays with the same alignment and
+ * the same in-place or out-of-place layout as the arrays it was created
+ * with, so these are part of the key. */
+inline std::string
+PlanCacheKey(const char * transform,
+             int          rank,
+             const int *  n,
+             int          sign,
+             unsigned int flags,
+             int          threads,
+             bool         inPlace,
+             int          inAlignment,
+             int          outAlignment)
+{
+  std::ostringstream key;
+  key << transform << ' ' << sign << ' ' << flags << ' ' << threads << ' ' << inPlace << ' ' << inAlignment << ' '
+      << outAlignment;
+  for (int i = 0; i < rank; ++i)
+  {
+    key << ' ' << n[i];
+  }
+  return key.str();
+}
+#endif
+
 /**
  * \class Interface
  * \brief Wrapper for FFTW API
@@ -373,6 +402,114 @@ public:
   }
 
 
+  /** Compute the transform planned by Plan_dft_c2r() on the given arrays.
+   * The plan is taken from the plan cache of FFTWGlobalConfiguration when
+   * an equivalent one is available, and is given back to it afterwards, so
+   * that transforming many images of the same size creates a single plan. */
+  static void
+  Execute_dft_c2r(int           rank,
+                  const int *   n,
+                  ComplexType * in,
+                  PixelType *   out,
+                  unsigned int  flags,
+                  int           threads = 1,
+                  bool          canDestroyInput = false)
+  {
+#  ifndef ITK_USE_CUFFTW
+    const std::string key = PlanCacheKey("fc2r",
+                                         rank,
+                                         n,
+                                         0,
+                                         flags,
+                                         threads,
+                                         static_cast<void *>(in) == static_cast<void *>(out),
+                                         fftwf_alignment_of(reinterpret_cast<PixelType *>(in)),
+                                         fftwf_alignment_of(out));
+    auto              plan = static_cast<PlanType>(FFTWGlobalConfiguration::TakeCachedPlan(key));
+    if (plan == nullptr)
+    {
+      plan = Plan_dft_c2r(rank, n, in, out, flags, threads, canDestroyInput);
+    }
+    fftwf_execute_dft_c2r(plan, in, out);
+    FFTWGlobalConfiguration::ReturnCachedPlan(key, plan, &DestroyCachedPlan);
+#  else
+    PlanType plan = Plan_dft_c2r(rank, n, in, out, flags, threads, canDestroyInput);
+    Execute(plan);
+    DestroyPlan(plan);
+#  endif
+  }
+
+  /** Compute the transform planned by Plan_dft_r2c() on the given arrays,
+   * reusing a cached plan as Execute_dft_c2r() does. */
+  static void
+  Execute_dft_r2c(int           rank,
+                  const int *   n,
+                  PixelType *   in,
+                  ComplexType * out,
+                  unsigned int  flags,
+                  int           threads = 1,
+                  bool          canDestroyInput = false)
+  {
+#  ifndef ITK_USE_CUFFTW
+    const std::string key = PlanCacheKey("fr2c",
+                                         rank,
+                                         n,
+                                         0,
+                                         flags,
+                                         threads,
+                                         static_cast<void *>(in) == static_cast<void *>(out),
+                                         fftwf_alignment_of(in),
+                                         fftwf_alignment_of(reinterpret_cast<PixelType *>(out)));
+    auto              plan = static_cast<PlanType>(FFTWGlobalConfiguration::TakeCachedPlan(key));
+    if (plan == nullptr)
+    {
+      plan = Plan_dft_r2c(rank, n, in, out, flags, threads, canDestroyInput);
+    }
+    fftwf_execute_dft_r2c(plan, in, out);
+    FFTWGlobalConfiguration::ReturnCachedPlan(key, plan, &DestroyCachedPlan);
+#  else
+    PlanType plan = Plan_dft_r2c(rank, n, in, out, flags, threads, canDestroyInput);
+    Execute(plan);
+    DestroyPlan(plan);
+#  endif
+  }
+
+  /** Compute the transform planned by Plan_dft() on the given arrays,
+   * reusing a cached plan as Execute_dft_c2r() does. */
+  static void
+  Execute_dft(int           rank,
+              const int *   n,
+              ComplexType * in,
+              ComplexType * out,
+              int           sign,
+              unsigned int  flags,
+              int           threads = 1,
+              bool          canDestroyInput = false)
+  {
+#  ifndef ITK_USE_CUFFTW
+    const std::string key = PlanCacheKey("fdft",
+                                         rank,
+                                         n,
+                                         sign,
+                                         flags,
+                                         threads,
+                                         in == out,
+                                         fftwf_alignment_of(reinterpret_cast<PixelType *>(in)),
+                                         fftwf_alignment_of(reinterpret_cast<PixelType *>(out)));
+    auto              plan = static_cast<PlanType>(FFTWGlobalConfiguration::TakeCachedPlan(key));
+    if (plan == nullptr)
+    {
+      plan = Plan_dft(rank, n, in, out, sign, flags, threads, canDestroyInput);
+    }
+    fftwf_execute_dft(plan, in, out);
+    FFTWGlobalConfiguration::ReturnCachedPlan(key, plan, &DestroyCachedPlan);
+#  else
+    PlanType plan = Plan_dft(rank, n, in, out, sign, flags, threads, canDestroyInput);
+    Execute(plan);
+    DestroyPlan(plan);
+#  endif
+  }
+
   static void
   Execute(PlanType p)
   {
@@ -386,6 +523,16 @@ public:
 #  endif
     fftwf_destroy_plan(p);
   }
+
+#  ifndef ITK_USE_CUFFTW
+private:
+  // Called by the plan cache, which already holds the FFTW lock.
+  static void
+  DestroyCachedPlan(void * p)
+  {
+    fftwf_destroy_plan(static_cast<PlanType>(p));
+  }
+#  endif
 };
 
 #endif // ITK_USE_FFTWF
@@ -702,6 +849,114 @@ public:
   }
 
 
+  /** Compute the transform planned by Plan_dft_c2r() on the given arrays.
+   * The plan is taken from the plan cache of FFTWGlobalConfiguration when
+   * an equivalent one is available, and is given back to it afterwards, so
+   * that transforming many images of the same size creates a single plan. */
+  static void
+  Execute_dft_c2r(int           rank,
+                  const int *   n,
+                  ComplexType * in,
+                  PixelType *   out,
+                  unsigned int  flags,
+                  int           threads = 1,
+                  bool          canDestroyInput = false)
+  {
+#  ifndef ITK_USE_CUFFTW
+    const std::string key = PlanCacheKey("dc2r",
+                                         rank,
+                                         n,
+                                         0,
+                                         flags,
+                                         threads,
+                                         static_cast<void *>(in) == static_cast<void *>(out),
+                                         fftw_alignment_of(reinterpret_cast<PixelType *>(in)),
+                                         fftw_alignment_of(out));
+    auto              plan = static_cast<PlanType>(FFTWGlobalConfiguration::TakeCachedPlan(key));
+    if (plan == nullptr)
+    {
+      plan = Plan_dft_c2r(rank, n, in, out, flags, threads, canDestroyInput);
+    }
+    fftw_execute_dft_c2r(plan, in, out);
+    FFTWGlobalConfiguration::ReturnCachedPlan(key, plan, &DestroyCachedPlan);
+#  else
+    PlanType plan = Plan_dft_c2r(rank, n, in, out, flags, threads, canDestroyInput);
+    Execute(plan);
+    DestroyPlan(plan);
+#  endif
+  }
+
+  /** Compute the transform planned by Plan_dft_r2c() on the given arrays,
+   * reusing a cached plan as Execute_dft_c2r() does. */
+  static void
+  Execute_dft_r2c(int           rank,
+                  const int *   n,
+                  PixelType *   in,
+                  ComplexType * out,
+                  unsigned int  flags,
+                  int           threads = 1,
+                  bool          canDestroyInput = false)
+  {
+#  ifndef ITK_USE_CUFFTW
+    const std::string key = PlanCacheKey("dr2c",
+                                         rank,
+                                         n,
+                                         0,
+                                         flags,
+                                         threads,
+                                         static_cast<void *>(in) == static_cast<void *>(out),
+                                         fftw_alignment_of(in),
+                                         fftw_alignment_of(reinterpret_cast<PixelType *>(out)));
+    auto              plan = static_cast<PlanType>(FFTWGlobalConfiguration::TakeCachedPlan(key));
+    if (plan == nullptr)
+    {
+      plan = Plan_dft_r2c(rank, n, in, out, flags, threads, canDestroyInput);
+    }
+    fftw_execute_dft_r2c(plan, in, out);
+    FFTWGlobalConfiguration::ReturnCachedPlan(key, plan, &DestroyCachedPlan);
+#  else
+    PlanType plan = Plan_dft_r2c(rank, n, in, out, flags, threads, canDestroyInput);
+    Execute(plan);
+    DestroyPlan(plan);
+#  endif
+  }
+
+  /** Compute the transform planned by Plan_dft() on the given arrays,
+   * reusing a cached plan as Execute_dft_c2r() does. */
+  static void
+  Execute_dft(int           rank,
+              const int *   n,
+              ComplexType * in,
+              ComplexType * out,
+              int           sign,
+              unsigned int  flags,
+              int           threads = 1,
+              bool          canDestroyInput = false)
+  {
+#  ifndef ITK_USE_CUFFTW
+    const std::string key = PlanCacheKey("ddft",
+                                         rank,
+                                         n,
+                                         sign,
+                                         flags,
+                                         threads,
+                                         in == out,
+                                         fftw_alignment_of(reinterpret_cast<PixelType *>(in)),
+                                         fftw_alignment_of(reinterpret_cast<PixelType *>(out)));
+    auto              plan = static_cast<PlanType>(FFTWGlobalConfiguration::TakeCachedPlan(key));
+    if (plan == nullptr)
+    {
+      plan = Plan_dft(rank, n, in, out, sign, flags, threads, canDestroyInput);
+    }
+    fftw_execute_dft(plan, in, out);
+    FFTWGlobalConfiguration::ReturnCachedPlan(key, plan, &DestroyCachedPlan);
+#  else
+    PlanType plan = Plan_dft(rank, n, in, out, sign, flags, threads, canDestroyInput);
+    Execute(plan);
+    DestroyPlan(plan);
+#  endif
+  }
+
   static void
   Execute(PlanType p)
   {
@@ -715,6 +970,16 @@ public:
 #  endif
     fftw_destroy_plan(p);
   }
+
+#  ifndef ITK_USE_CUFFTW
+private:
+  // Called by the plan cache, which already holds the FFTW lock.
+  static void
+  DestroyCachedPlan(void * p)
+  {
+    fftw_destroy_plan(static_cast<PlanType>(p));
+  }
+#  endif
 };
 
 #endif
@@ -35,6 +35,7 @@
 #  endif
 #  include <algorithm>
 #  include <cctype>
+#  include <list>
 
 struct FFTWGlobalConfigurationGlobals;
 
@@ -56,6 +57,9 @@ struct FFTWGlobalConfigurationGlobals;
 //                             file to be generated.  If this is
 //                             set, then ITK_FFTW_WISDOM_CACHE_BASE
 //                             is ignored.
+// ITK_FFTW_PLAN_CACHE_SIZE - Defines the maximum number of plans kept
+//                           for reuse by the FFT filters (16 by default,
+//                           0 disables the plan cache)
 //
 // The above behaviors can also be controlled by the application.
 //
@@ -348,6 +352,37 @@ public:
   static bool
   ExportDefaultWisdomFile();
 
+  /**
+   * \brief Set/Get the maximum number of plans kept in the plan cache
+   *
+   * The FFTW filters take their plans from a process-wide cache, and give
+   * them back once the transform is computed, so that transforming many
+   * images of the same size, type and number of threads creates a single
+   * plan. The least recently used plans are destroyed when the cache is
+   * full. A size of 0 disables the cache.
+   * If the environmental variable "ITK_FFTW_PLAN_CACHE_SIZE", is set,
+   * then the environmental setting overrides the default size.
+   */
+  static void
+  SetPlanCacheSize(const SizeValueType v);
+  static SizeValueType
+  GetPlanCacheSize();
+
+  /** Destroy all the plans of the plan cache. */
+  static void
+  ClearPlanCache();
+
+  /** Take the plan matching \c key out of the plan cache, or return
+   * nullptr if there is none. The plan is owned by the caller until it is
+   * given back with ReturnCachedPlan(). */
+  static void *
+  TakeCachedPlan(const std::string & key);
+
+  /** Give a plan back to the plan cache. \c destroyPlan is called with the
+   * lock held when the plan is evicted from the cache. */
+  static void
+  ReturnCachedPlan(const std::string & key, void * plan, void (*destroyPlan)(void *));
+
 private:
   FFTWGlobalConfiguration();           // This will process env variables
   ~FFTWGlobalConfiguration() override; // This will write cache file if requested.
@@ -367,6 +402,18 @@ private:
 
   static FFTWGlobalConfigurationGlobals * m_PimplGlobals;
 
+  /** Destroy the least recently used plans until at most maximumSize are
+   * left in the plan cache. The lock must be held. */
+  void
+  TrimPlanCache(SizeValueType maximumSize);
+
+  struct CachedPlan
+  {
+    std::string m_Key;
+    void *      m_Plan;
+    void (*m_DestroyPlan)(void *);
+  };
+
   std::mutex  m_Mutex;
   bool        m_NewWisdomAvailable{ false };
   int         m_PlanRigor{ 0 };
@@ -376,6 +423,9 @@ private:
   // m_WriteWisdomCache Controls the behavior of default
   // wisdom file creation policies.
   WisdomFilenameGeneratorBase * m_WisdomFilenameGenerator;
+  // Most recently used plans first.
+  std::list<CachedPlan> m_PlanCache;
+  SizeValueType         m_PlanCacheSize{ 16 };
 };
 } // namespace itk
 #endif
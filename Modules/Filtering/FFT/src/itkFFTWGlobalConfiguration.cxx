@@ -469,6 +469,21 @@ FFTWGlobalConfiguration::FFTWGlobalConfiguration()
     }
   }
 
+  {
+    std::string planCacheSizeString;
+    if (itksys::SystemTools::GetEnv("ITK_FFTW_PLAN_CACHE_SIZE", planCacheSizeString))
+    {
+      try
+      {
+        this->m_PlanCacheSize = std::stoul(planCacheSizeString);
+      }
+      catch (...)
+      {
+        itkWarningMacro("Warning: Invalid FFTW PLAN CACHE SIZE: " << planCacheSizeString);
+      }
+    }
+  }
+
   if (this->m_ReadWisdomCache)
   {
     const std::string cachePath = m_WisdomFilenameGenerator->GenerateWisdomFilename(m_WisdomCacheBase);
@@ -503,6 +518,8 @@ FFTWGlobalConfiguration::~FFTWGlobalConfiguration()
     }
 #  endif
   }
+  // The cached plans must be destroyed before cleaning up FFTW.
+  this->TrimPlanCache(0);
 #  if defined(ITK_USE_FFTWF)
 #    if !defined(_WIN32) || defined(ITK_STATIC)
   // Cannot be called with shared libs on Windows because FFTW does not check
@@ -824,6 +841,72 @@ FFTWGlobalConfiguration::GetWisdomCacheBase()
   return GetInstance()->m_WisdomCacheBase;
 }
 
+void
+FFTWGlobalConfiguration::SetPlanCacheSize(const SizeValueType v)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const Pointer                     instance = GetInstance();
+  const std::lock_guard<std::mutex> lockGuard(instance->m_Mutex);
+  instance->m_PlanCacheSize = v;
+  instance->TrimPlanCache(v);
+}
+
+SizeValueType
+FFTWGlobalConfiguration::GetPlanCacheSize()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  return GetInstance()->m_PlanCacheSize;
+}
+
+void
+FFTWGlobalConfiguration::ClearPlanCache()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const Pointer                     instance = GetInstance();
+  const std::lock_guard<std::mutex> lockGuard(instance->m_Mutex);
+  instance->TrimPlanCache(0);
+}
+
+void *
+FFTWGlobalConfiguration::TakeCachedPlan(const std::string & key)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const Pointer                     instance = GetInstance();
+  const std::lock_guard<std::mutex> lockGuard(instance->m_Mutex);
+  auto &                            cache = instance->m_PlanCache;
+  const auto it = std::find_if(cache.begin(), cache.end(), [&key](const CachedPlan & cached) {
+    return cached.m_Key == key;
+  });
+  if (it == cache.end())
+  {
+    return nullptr;
+  }
+  void * plan = it->m_Plan;
+  cache.erase(it);
+  return plan;
+}
+
+void
+FFTWGlobalConfiguration::ReturnCachedPlan(const std::string & key, void * plan, void (*destroyPlan)(void *))
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  const Pointer                     instance = GetInstance();
+  const std::lock_guard<std::mutex> lockGuard(instance->m_Mutex);
+  instance->m_PlanCache.push_front(CachedPlan{ key, plan, destroyPlan });
+  instance->TrimPlanCache(instance->m_PlanCacheSize);
+}
+
+void
+FFTWGlobalConfiguration::TrimPlanCache(SizeValueType maximumSize)
+{
+  while (m_PlanCache.size() > maximumSize)
+  {
+    const CachedPlan & cached = m_PlanCache.back();
+    cached.m_DestroyPlan(cached.m_Plan);
+    m_PlanCache.pop_back();
+  }
+}
+
 } // end namespace itk
 
 #endif
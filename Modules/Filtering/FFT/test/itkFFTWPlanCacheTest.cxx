@@ -0,0 +1,144 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFFTWComplexToComplexFFTImageFilter.h"
+#include "itkFFTWForwardFFTImageFilter.h"
+#include "itkFFTWGlobalConfiguration.h"
+#include "itkFFTWHalfHermitianToRealInverseFFTImageFilter.h"
+#include "itkFFTWInverseFFTImageFilter.h"
+#include "itkFFTWRealToHalfHermitianForwardFFTImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+template <typename TImage>
+bool
+AreClose(const TImage * image1, const TImage * image2, double tolerance)
+{
+  itk::ImageRegionConstIterator<TImage> it1(image1, image1->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<TImage> it2(image2, image2->GetLargestPossibleRegion());
+  for (; !it1.IsAtEnd(); ++it1, ++it2)
+  {
+    if (std::abs(it1.Get() - it2.Get()) > tolerance)
+    {
+      std::cerr << "Values differ: " << it1.Get() << " != " << it2.Get() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Transforms many images of the same size back and forth through new
+// filter instances, which share their plans through the plan cache.
+template <typename TPixel>
+int
+TestPlanCache()
+{
+  using RealImageType = itk::Image<TPixel, 2>;
+  using ComplexImageType = itk::Image<std::complex<TPixel>, 2>;
+
+  auto image = RealImageType::New();
+  image->SetRegions(typename RealImageType::SizeType{ { 24, 15 } });
+  image->Allocate();
+
+  typename ComplexImageType::Pointer firstTransform;
+  for (unsigned int iteration = 0; iteration < 6; ++iteration)
+  {
+    for (itk::ImageRegionIteratorWithIndex<RealImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd();
+         ++it)
+    {
+      it.Set(static_cast<TPixel>((it.GetIndex()[0] * 7 + it.GetIndex()[1] * 3) % 11 + iteration % 2));
+    }
+    image->Modified();
+
+    auto forward = itk::FFTWForwardFFTImageFilter<RealImageType, ComplexImageType>::New();
+    forward->SetInput(image);
+    auto complexInverse = itk::FFTWComplexToComplexFFTImageFilter<ComplexImageType>::New();
+    complexInverse->SetInput(forward->GetOutput());
+    complexInverse->SetTransformDirection(
+      itk::FFTWComplexToComplexFFTImageFilter<ComplexImageType>::TransformDirectionEnum::INVERSE);
+    auto complexForward = itk::FFTWComplexToComplexFFTImageFilter<ComplexImageType>::New();
+    complexForward->SetInput(complexInverse->GetOutput());
+    auto inverse = itk::FFTWInverseFFTImageFilter<ComplexImageType, RealImageType>::New();
+    inverse->SetInput(complexForward->GetOutput());
+    ITK_TRY_EXPECT_NO_EXCEPTION(inverse->Update());
+
+    if (!AreClose(image.GetPointer(), inverse->GetOutput(), 1e-3))
+    {
+      return EXIT_FAILURE;
+    }
+
+    auto halfForward = itk::FFTWRealToHalfHermitianForwardFFTImageFilter<RealImageType, ComplexImageType>::New();
+    halfForward->SetInput(image);
+    auto halfInverse = itk::FFTWHalfHermitianToRealInverseFFTImageFilter<ComplexImageType, RealImageType>::New();
+    halfInverse->SetInput(halfForward->GetOutput());
+    halfInverse->SetActualXDimensionIsOdd(false);
+    ITK_TRY_EXPECT_NO_EXCEPTION(halfInverse->Update());
+
+    if (!AreClose(image.GetPointer(), halfInverse->GetOutput(), 1e-3))
+    {
+      return EXIT_FAILURE;
+    }
+
+    // The transforms of the same image must not depend on whether the plan
+    // was taken from the cache.
+    if (iteration == 0)
+    {
+      firstTransform = forward->GetOutput();
+      firstTransform->DisconnectPipeline();
+    }
+    else if (iteration % 2 == 0 && !AreClose(firstTransform.GetPointer(), forward->GetOutput(), 1e-2))
+    {
+      return EXIT_FAILURE;
+    }
+
+    if (iteration == 3)
+    {
+      // Plans are not reused anymore.
+      itk::FFTWGlobalConfiguration::SetPlanCacheSize(0);
+    }
+  }
+  itk::FFTWGlobalConfiguration::SetPlanCacheSize(16);
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+int
+itkFFTWPlanCacheTest(int, char *[])
+{
+  // The default size may be overridden by ITK_FFTW_PLAN_CACHE_SIZE.
+  itk::FFTWGlobalConfiguration::SetPlanCacheSize(16);
+  ITK_TEST_EXPECT_EQUAL(itk::FFTWGlobalConfiguration::GetPlanCacheSize(), 16u);
+  itk::FFTWGlobalConfiguration::SetPlanCacheSize(4);
+  ITK_TEST_EXPECT_EQUAL(itk::FFTWGlobalConfiguration::GetPlanCacheSize(), 4u);
+
+  int status = EXIT_SUCCESS;
+#if defined(ITK_USE_FFTWF)
+  status |= TestPlanCache<float>();
+#endif
+#if defined(ITK_USE_FFTWD)
+  status |= TestPlanCache<double>();
+#endif
+
+  itk::FFTWGlobalConfiguration::ClearPlanCache();
+
+  std::cout << "Test finished." << std::endl;
+  return status;
+}
@@ -22,9 +22,9 @@
 #include "itkIntTypes.h"
 #include "itkFastMarchingStoppingCriterionBase.h"
 #include "itkFastMarchingTraits.h"
+#include "itkFastMarchingIndexedHeap.h"
 #include "ITKFastMarchingExport.h"
 
-#include <queue>
 #include <functional>
 
 namespace itk
@@ -46,10 +46,22 @@ public:
     NoHandles,
     Strict
   };
+
+  /**
+   * \class Solver
+   * \ingroup ITKFastMarching
+   * */
+  enum class Solver : uint8_t
+  {
+    FastMarching = 0,
+    FastIterative
+  };
 };
 // Define how to print enumeration
 extern ITKFastMarching_EXPORT std::ostream &
                               operator<<(std::ostream & out, const FastMarchingTraitsEnums::TopologyCheck value);
+extern ITKFastMarching_EXPORT std::ostream &
+                              operator<<(std::ostream & out, const FastMarchingTraitsEnums::Solver value);
 
 /**
  * \class FastMarchingBase
@@ -63,8 +75,9 @@ extern ITKFastMarching_EXPORT std::ostream &
  *
  * Updates are performed using an entropy satisfy scheme where only
  * "upwind" neighborhoods are used. This implementation of Fast Marching
- * uses a std::priority_queue to locate the next proper node to
- * update.
+ * uses a FastMarchingIndexedHeap to locate the next proper node to
+ * update. Domains which provide node identifiers update the value of a
+ * trial node in the heap instead of inserting it again.
  *
  * Fast Marching sweeps through N points in (N log N) steps to obtain
  * the arrival time value as the front propagates through the domain.
@@ -91,9 +104,19 @@ extern ITKFastMarching_EXPORT std::ostream &
  *    \li Superclass (itk::ImageToImageFilter or
  * itk::QuadEdgeMeshToQuadEdgeMeshFilter )
  *
- * \todo In the current implementation, std::priority_queue only allows
- * taking nodes out from the front and putting nodes in from the back.
- * Use itk::PriorityQueueContainer instead.
+ * \par Solvers:
+ * The Solver selects how the equation is solved. FastMarching (the default)
+ * processes the nodes one at a time in increasing order of arrival time.
+ * FastIterative uses the Fast Iterative Method, which updates all the nodes
+ * of an active list in parallel until convergence, then processes the nodes
+ * in increasing order of arrival time to apply the stopping criterion. It
+ * computes the same arrival times as FastMarching up to rounding errors, and
+ * is faster on multi-core machines when the front spans a large part of the
+ * domain. It does not support topology checks, and is only available for the
+ * domains which override GenerateDataWithFastIterativeMethod(). See
+ *
+ * W.-K. Jeong, R.T. Whitaker. "A Fast Iterative Method for Eikonal
+ * Equations", SIAM Journal on Scientific Computing, 30(5):2512-2534, 2008.
  *
  * \par Topology constraints:
  * Additional flexibility in this class includes the implementation of
@@ -176,6 +199,7 @@ public:
   */
 
   using TopologyCheckEnum = FastMarchingTraitsEnums::TopologyCheck;
+  using SolverEnum = FastMarchingTraitsEnums::Solver;
 #if !defined(ITK_LEGACY_REMOVE)
   using TopologyCheckType = FastMarchingTraitsEnums::TopologyCheck;
   /**Exposes enums values for backwards compatibility*/
@@ -189,6 +213,11 @@ public:
   itkSetEnumMacro(TopologyCheck, TopologyCheckEnum);
   itkGetConstReferenceMacro(TopologyCheck, TopologyCheckEnum);
 
+  /** Set/Get the method used to solve the equation. Defaults to
+   * FastMarching. */
+  itkSetEnumMacro(Solver, SolverEnum);
+  itkGetConstReferenceMacro(Solver, SolverEnum);
+
   /** Set/Get TrialPoints */
   itkSetObjectMacro(TrialPoints, NodePairContainerType);
   itkGetModifiableObjectMacro(TrialPoints, NodePairContainerType);
@@ -254,16 +283,20 @@ protected:
 
   bool m_CollectPoints{};
 
-  // PriorityQueuePointer m_Heap;
+#ifndef ITK_FUTURE_LEGACY_REMOVE
+  /** \deprecated The trial nodes are kept in a FastMarchingIndexedHeap. */
   using HeapContainerType = std::vector<NodePairType>;
   using NodeComparerType = std::greater<NodePairType>;
+#endif
 
-  using PriorityQueueType = std::priority_queue<NodePairType, HeapContainerType, NodeComparerType>;
+  using PriorityQueueType = FastMarchingIndexedHeap<NodePairType>;
 
   PriorityQueueType m_Heap{};
 
   TopologyCheckEnum m_TopologyCheck{};
 
+  SolverEnum m_Solver{ SolverEnum::FastMarching };
+
   /** \brief Get the total number of nodes in the domain */
   virtual IdentifierType
   GetTotalNumberOfNodes() const = 0;
@@ -321,6 +354,13 @@ protected:
   void
   GenerateData() override;
 
+  /** \brief Solve the equation with the Fast Iterative Method. The domain is
+   * initialized. The default implementation throws an exception.
+    \param[in] oDomain
+  */
+  virtual void
+  GenerateDataWithFastIterativeMethod(OutputDomainType * oDomain);
+
   /** \brief PrintSelf method  */
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
@@ -56,6 +56,7 @@ FastMarchingBase<TInput, TOutput>::PrintSelf(std::ostream & os, Indent indent) c
   Superclass::PrintSelf(os, indent);
   os << indent << "Speed constant: " << m_SpeedConstant << std::endl;
   os << indent << "Topology check: " << m_TopologyCheck << std::endl;
+  os << indent << "Solver: " << m_Solver << std::endl;
   os << indent << "Normalization Factor: " << m_NormalizationFactor << std::endl;
 }
 
@@ -90,17 +91,13 @@ FastMarchingBase<TInput, TOutput>::Initialize(OutputDomainType * oDomain)
     }
   }
 
-  // make sure the heap is empty
-  while (!m_Heap.empty())
+  if (m_Solver == SolverEnum::FastIterative && m_TopologyCheck != TopologyCheckEnum::Nothing)
   {
-    m_Heap.pop();
+    itkExceptionMacro("Topology checks are not supported by the " << m_Solver << " solver");
   }
-  /*
-  while ( !m_Heap->Empty() )
-    {
-    m_Heap->Pop();
-    }
-  */
+
+  // make sure the heap is empty
+  m_Heap.clear();
 
   this->InitializeOutput(oDomain);
 
@@ -119,6 +116,14 @@ FastMarchingBase<TInput, TOutput>::GenerateData()
 
   Initialize(output);
 
+  if (m_Solver == SolverEnum::FastIterative)
+  {
+    m_StoppingCriterion->Reinitialize();
+    m_Heap.SetNumberOfIdentifiers(0);
+    this->GenerateDataWithFastIterativeMethod(output);
+    return;
+  }
+
   OutputPixelType current_value = 0.;
 
   ProgressReporter progress(this, 0, this->GetTotalNumberOfNodes());
@@ -181,14 +186,7 @@ FastMarchingBase<TInput, TOutput>::GenerateData()
     // it.
     //
     // RELEASE MEMORY!!!
-    while (!m_Heap.empty())
-    {
-      m_Heap.pop();
-    }
-    /*while( !m_Heap->Empty() )
-      {
-      m_Heap->Pop();
-      }*/
+    m_Heap.SetNumberOfIdentifiers(0);
 
     throw ProcessAborted(__FILE__, __LINE__);
   }
@@ -196,14 +194,16 @@ FastMarchingBase<TInput, TOutput>::GenerateData()
   m_TargetReachedValue = current_value;
 
   // let's release some useless memory...
-  while (!m_Heap.empty())
-  {
-    m_Heap.pop();
-  }
-  /*while( !m_Heap->Empty() )
-    {
-    m_Heap->Pop();
-    }*/
+  m_Heap.SetNumberOfIdentifiers(0);
+}
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+template <typename TInput, typename TOutput>
+void
+FastMarchingBase<TInput, TOutput>::GenerateDataWithFastIterativeMethod(OutputDomainType * itkNotUsed(oDomain))
+{
+  itkExceptionMacro("The " << m_Solver << " solver is not supported by " << this->GetNameOfClass());
 }
 // -----------------------------------------------------------------------------
 
@@ -137,6 +137,10 @@ protected:
   void
   UpdateValue(OutputImageType * oImage, const NodeType & iNode) override;
 
+  /** The auxiliary values are only extended by the fast marching method */
+  void
+  GenerateDataWithFastIterativeMethod(OutputImageType * oImage) override;
+
   /** Generate the output image meta information */
   void
   GenerateOutputInformation() override;
@@ -193,6 +193,15 @@ FastMarchingExtensionImageFilterBase<TInput, TOutput, TAuxValue, VAuxDimension>:
   } // if AuxTrialValues set
 }
 
+template <typename TInput, typename TOutput, typename TAuxValue, unsigned int VAuxDimension>
+void
+FastMarchingExtensionImageFilterBase<TInput, TOutput, TAuxValue, VAuxDimension>::GenerateDataWithFastIterativeMethod(
+  OutputImageType * itkNotUsed(oImage))
+{
+  itkExceptionMacro("The auxiliary values are only extended by the " << FastMarchingTraitsEnums::Solver::FastMarching
+                                                                      << " solver");
+}
+
 template <typename TInput, typename TOutput, typename TAuxValue, unsigned int VAuxDimension>
 void
 FastMarchingExtensionImageFilterBase<TInput, TOutput, TAuxValue, VAuxDimension>::UpdateValue(OutputImageType * oImage,
@@ -229,7 +238,7 @@ FastMarchingExtensionImageFilterBase<TInput, TOutput, TAuxValue, VAuxDimension>:
     // node.SetValue( outputPixel );
     // node.SetIndex( index );
     // m_TrialHeap.push(node);
-    this->m_Heap.push(NodePairType(iNode, outputPixel));
+    this->PushTrialNode(NodePairType(iNode, outputPixel));
 
     // update auxiliary values
     for (unsigned int k = 0; k < AuxDimension; ++k)
@@ -61,6 +61,11 @@ namespace itk
  * "Level Set Methods and Fast Marching Methods", J.A. Sethian,
  * Cambridge Press, Second edition, 1999.
  *
+ * The trial nodes are identified in the heap by their offset in the output
+ * buffer, so that the value of a trial node is updated in place rather than
+ * pushed again. The Fast Iterative Method (see FastMarchingBase::SetSolver())
+ * updates the active nodes with the work units of the filter.
+ *
  * For an alternative implementation, see itk::FastMarchingImageFilter.
  *
  * \tparam TTraits traits
@@ -213,6 +218,15 @@ protected:
   void
   UpdateValue(OutputImageType * oImage, const NodeType & iNode) override;
 
+  /** Insert a node into the trial heap, or update its value if it is already
+   * in the heap */
+  void
+  PushTrialNode(const NodePairType & iNodePair);
+
+  /** Solve the equation with the Fast Iterative Method */
+  void
+  GenerateDataWithFastIterativeMethod(OutputImageType * oImage) override;
+
   /** Make sure the given node does not violate any topological constraint*/
   bool
   CheckTopology(OutputImageType * oImage, const NodeType & iNode) override;
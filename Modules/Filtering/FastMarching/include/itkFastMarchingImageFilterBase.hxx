@@ -23,6 +23,11 @@
 #include "itkImageRegionIterator.h"
 #include "itkConnectedComponentImageFilter.h"
 #include "itkRelabelComponentImageFilter.h"
+#include "itkProgressReporter.h"
+
+#include <algorithm>
+#include <exception>
+#include <mutex>
 
 namespace itk
 {
@@ -189,10 +194,17 @@ FastMarchingImageFilterBase<TInput, TOutput>::UpdateValue(OutputImageType * oIma
     this->SetLabelValueForGivenNode(iNode, Traits::Trial);
 
     // Insert point into trial heap
-    this->m_Heap.push(NodePairType(iNode, outputPixel));
+    this->PushTrialNode(NodePairType(iNode, outputPixel));
   }
 }
 
+template <typename TInput, typename TOutput>
+void
+FastMarchingImageFilterBase<TInput, TOutput>::PushTrialNode(const NodePairType & iNodePair)
+{
+  this->m_Heap.push(iNodePair, static_cast<SizeValueType>(m_LabelImage->ComputeOffset(iNodePair.GetNode())));
+}
+
 template <typename TInput, typename TOutput>
 void
 FastMarchingImageFilterBase<TInput, TOutput>::GetInternalNodesUsed(OutputImageType *            oImage,
@@ -512,6 +524,7 @@ FastMarchingImageFilterBase<TInput, TOutput>::InitializeOutput(OutputImageType *
   }
 
   // Process the input trial points
+  this->m_Heap.SetNumberOfIdentifiers(m_BufferedRegion.GetNumberOfPixels());
   if (this->m_TrialPoints)
   {
     NodePairContainerConstIterator       pointsIter = this->m_TrialPoints->Begin();
@@ -531,8 +544,7 @@ FastMarchingImageFilterBase<TInput, TOutput>::InitializeOutput(OutputImageType *
         outputPixel = pointsIter->Value().GetValue();
         this->SetOutputValue(oImage, idx, outputPixel);
 
-        // this->m_Heap->Push( PriorityQueueElementType( idx, pointsIter->second ) );
-        this->m_Heap.push(pointsIter->Value());
+        this->PushTrialNode(pointsIter->Value());
       }
       ++pointsIter;
     }
@@ -561,6 +573,354 @@ FastMarchingImageFilterBase<TInput, TOutput>::InitializeOutput(OutputImageType *
   m_InputCache = this->GetInput();
 }
 
+template <typename TInput, typename TOutput>
+void
+FastMarchingImageFilterBase<TInput, TOutput>::GenerateDataWithFastIterativeMethod(OutputImageType * oImage)
+{
+  // Fast Iterative Method: the nodes of the active list are updated in
+  // parallel from the current values of their neighbors. A node whose value
+  // does not decrease anymore leaves the list, and adds the neighbors whose
+  // value it decreases. The updates are computed before they are written, so
+  // that the work units never read a value which is being written.
+  using ReachedNodeType = std::pair<OutputPixelType, OffsetValueType>;
+
+  constexpr SizeValueType blockSize = 4096;
+
+  OutputPixelType *       values = oImage->GetBufferPointer();
+  unsigned char *         labels = m_LabelImage->GetBufferPointer();
+  const OffsetValueType * strides = m_LabelImage->GetOffsetTable();
+  const SizeValueType     numberOfNodes = m_BufferedRegion.GetNumberOfPixels();
+  const OutputPixelType   largeValue = this->m_LargeValue;
+  const auto              tolerance = static_cast<OutputPixelType>(4 * NumericTraits<OutputPixelType>::epsilon());
+
+  MultiThreaderBase * multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+
+  const auto getNumberOfBlocks = [](SizeValueType numberOfItems) {
+    return (numberOfItems + blockSize - 1) / blockSize;
+  };
+
+  // Value of a node computed from all the neighbors which are not forbidden,
+  // or only from the alive ones.
+  const auto solve = [&](OffsetValueType offset, const NodeType & node, bool onlyAlive = false) -> OutputPixelType {
+    InternalNodeStructureArray nodesUsed;
+    bool                       hasReachedNeighbor = false;
+    for (unsigned int j = 0; j < ImageDimension; ++j)
+    {
+      InternalNodeStructure & nodeUsed = nodesUsed[j];
+      nodeUsed.m_Node = node;
+      nodeUsed.m_Value = largeValue;
+      nodeUsed.m_Axis = j;
+      for (int s = -1; s < 2; s += 2)
+      {
+        const typename NodeType::IndexValueType neighbor = node[j] + s;
+        if (neighbor >= m_StartIndex[j] && neighbor <= m_LastIndex[j])
+        {
+          const OffsetValueType neighborOffset = offset + s * strides[j];
+          const unsigned char   label = labels[neighborOffset];
+          if ((onlyAlive ? label == Traits::Alive : label != Traits::Forbidden) &&
+              values[neighborOffset] < nodeUsed.m_Value)
+          {
+            nodeUsed.m_Value = values[neighborOffset];
+            nodeUsed.m_Node[j] = neighbor;
+            hasReachedNeighbor = true;
+          }
+        }
+      }
+    }
+    if (!hasReachedNeighbor)
+    {
+      return largeValue;
+    }
+    const double solution = this->Solve(oImage, node, nodesUsed);
+    return solution < static_cast<double>(largeValue) ? static_cast<OutputPixelType>(solution) : largeValue;
+  };
+
+  const auto decreases = [tolerance](OutputPixelType newValue, OutputPixelType value) {
+    return newValue < value - tolerance * value;
+  };
+
+  // The initial active list is made of the free neighbors of the initial
+  // trial nodes. As with the fast marching method, the alive nodes given as
+  // input are used by the neighbors of the front, but do not propagate.
+  SizeValueType                             numberOfBlocks = getNumberOfBlocks(numberOfNodes);
+  std::vector<std::vector<OffsetValueType>> blockNodes(numberOfBlocks);
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfBlocks,
+    [&](SizeValueType block) {
+      const SizeValueType last = std::min(numberOfNodes, (block + 1) * blockSize);
+      for (auto offset = static_cast<OffsetValueType>(block * blockSize); offset < static_cast<OffsetValueType>(last);
+           ++offset)
+      {
+        if (labels[offset] != Traits::Far)
+        {
+          continue;
+        }
+        const NodeType node = m_LabelImage->ComputeIndex(offset);
+        bool           isNextToTrial = false;
+        for (unsigned int j = 0; j < ImageDimension && !isNextToTrial; ++j)
+        {
+          isNextToTrial = (node[j] > m_StartIndex[j] && labels[offset - strides[j]] == Traits::InitialTrial) ||
+                          (node[j] < m_LastIndex[j] && labels[offset + strides[j]] == Traits::InitialTrial);
+        }
+        if (isNextToTrial)
+        {
+          blockNodes[block].push_back(offset);
+        }
+      }
+    },
+    nullptr);
+
+  std::vector<OffsetValueType> activeNodes;
+  for (const auto & nodes : blockNodes)
+  {
+    activeNodes.insert(activeNodes.end(), nodes.begin(), nodes.end());
+  }
+  for (const OffsetValueType offset : activeNodes)
+  {
+    labels[offset] = Traits::Trial;
+  }
+
+  std::vector<OutputPixelType>                                          newValues;
+  std::vector<std::vector<OffsetValueType>>                             keptNodes;
+  std::vector<std::vector<OffsetValueType>>                             convergedNodes;
+  std::vector<std::vector<std::pair<OffsetValueType, OutputPixelType>>> candidates;
+  while (!activeNodes.empty())
+  {
+    const auto numberOfActiveNodes = static_cast<SizeValueType>(activeNodes.size());
+    numberOfBlocks = getNumberOfBlocks(numberOfActiveNodes);
+    newValues.resize(numberOfActiveNodes);
+    keptNodes.assign(numberOfBlocks, {});
+    convergedNodes.assign(numberOfBlocks, {});
+    candidates.assign(numberOfBlocks, {});
+
+    // Compute the new values of the active nodes.
+    multiThreader->ParallelizeArray(
+      0,
+      numberOfBlocks,
+      [&](SizeValueType block) {
+        const SizeValueType last = std::min(numberOfActiveNodes, (block + 1) * blockSize);
+        for (SizeValueType i = block * blockSize; i < last; ++i)
+        {
+          newValues[i] = solve(activeNodes[i], m_LabelImage->ComputeIndex(activeNodes[i]));
+        }
+      },
+      nullptr);
+
+    // Write them, and remove the converged nodes from the active list.
+    multiThreader->ParallelizeArray(
+      0,
+      numberOfBlocks,
+      [&](SizeValueType block) {
+        const SizeValueType last = std::min(numberOfActiveNodes, (block + 1) * blockSize);
+        for (SizeValueType i = block * blockSize; i < last; ++i)
+        {
+          const OffsetValueType offset = activeNodes[i];
+          const OutputPixelType value = values[offset];
+          if (newValues[i] < value)
+          {
+            values[offset] = newValues[i];
+          }
+          if (decreases(newValues[i], value))
+          {
+            keptNodes[block].push_back(offset);
+          }
+          else
+          {
+            labels[offset] = Traits::Far;
+            convergedNodes[block].push_back(offset);
+          }
+        }
+      },
+      nullptr);
+
+    // Find the neighbors of the converged nodes whose value decreases.
+    multiThreader->ParallelizeArray(
+      0,
+      numberOfBlocks,
+      [&](SizeValueType block) {
+        for (const OffsetValueType offset : convergedNodes[block])
+        {
+          const NodeType node = m_LabelImage->ComputeIndex(offset);
+          for (unsigned int j = 0; j < ImageDimension; ++j)
+          {
+            for (int s = -1; s < 2; s += 2)
+            {
+              const typename NodeType::IndexValueType neighbor = node[j] + s;
+              if (neighbor < m_StartIndex[j] || neighbor > m_LastIndex[j])
+              {
+                continue;
+              }
+              const OffsetValueType neighborOffset = offset + s * strides[j];
+              if (labels[neighborOffset] == Traits::Far)
+              {
+                NodeType neighborNode = node;
+                neighborNode[j] = neighbor;
+                const OutputPixelType newValue = solve(neighborOffset, neighborNode);
+                if (decreases(newValue, values[neighborOffset]))
+                {
+                  candidates[block].emplace_back(neighborOffset, newValue);
+                }
+              }
+            }
+          }
+        }
+      },
+      nullptr);
+
+    activeNodes.clear();
+    for (const auto & nodes : keptNodes)
+    {
+      activeNodes.insert(activeNodes.end(), nodes.begin(), nodes.end());
+    }
+    for (const auto & blockCandidates : candidates)
+    {
+      for (const auto & candidate : blockCandidates)
+      {
+        if (candidate.second < values[candidate.first])
+        {
+          values[candidate.first] = candidate.second;
+        }
+        if (labels[candidate.first] != Traits::Trial)
+        {
+          labels[candidate.first] = Traits::Trial;
+          activeNodes.push_back(candidate.first);
+        }
+      }
+    }
+  }
+
+  // Sort the reached nodes by increasing value.
+  numberOfBlocks = getNumberOfBlocks(numberOfNodes);
+  std::vector<std::vector<ReachedNodeType>> reachedNodes(numberOfBlocks);
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfBlocks,
+    [&](SizeValueType block) {
+      const SizeValueType last = std::min(numberOfNodes, (block + 1) * blockSize);
+      for (auto offset = static_cast<OffsetValueType>(block * blockSize); offset < static_cast<OffsetValueType>(last);
+           ++offset)
+      {
+        if ((labels[offset] == Traits::Far && values[offset] < largeValue) || labels[offset] == Traits::InitialTrial)
+        {
+          if (labels[offset] == Traits::Far)
+          {
+            labels[offset] = Traits::Trial;
+          }
+          reachedNodes[block].emplace_back(values[offset], offset);
+        }
+      }
+      std::sort(reachedNodes[block].begin(), reachedNodes[block].end());
+    },
+    nullptr);
+  for (SizeValueType width = 1; width < numberOfBlocks; width *= 2)
+  {
+    multiThreader->ParallelizeArray(
+      0,
+      (numberOfBlocks + 2 * width - 1) / (2 * width),
+      [&](SizeValueType pair) {
+        const SizeValueType first = 2 * width * pair;
+        if (first + width < numberOfBlocks)
+        {
+          std::vector<ReachedNodeType> merged(reachedNodes[first].size() + reachedNodes[first + width].size());
+          std::merge(reachedNodes[first].begin(),
+                     reachedNodes[first].end(),
+                     reachedNodes[first + width].begin(),
+                     reachedNodes[first + width].end(),
+                     merged.begin());
+          reachedNodes[first].swap(merged);
+          std::vector<ReachedNodeType>().swap(reachedNodes[first + width]);
+        }
+      },
+      nullptr);
+  }
+  const std::vector<ReachedNodeType> sortedNodes =
+    numberOfBlocks > 0 ? std::move(reachedNodes.front()) : std::vector<ReachedNodeType>();
+
+  // Process the reached nodes in the order of the fast marching method, until
+  // the stopping criterion is satisfied.
+  ProgressReporter progress(this, 0, this->GetTotalNumberOfNodes());
+
+  OutputPixelType current_value{};
+  SizeValueType   numberOfAliveNodes = 0;
+  for (; numberOfAliveNodes < sortedNodes.size(); ++numberOfAliveNodes)
+  {
+    const ReachedNodeType & reachedNode = sortedNodes[numberOfAliveNodes];
+    const NodePairType      current_node_pair(m_LabelImage->ComputeIndex(reachedNode.second), reachedNode.first);
+    current_value = reachedNode.first;
+
+    this->m_StoppingCriterion->SetCurrentNodePair(current_node_pair);
+    if (this->m_StoppingCriterion->IsSatisfied())
+    {
+      break;
+    }
+    if (this->m_CollectPoints)
+    {
+      this->m_ProcessedPoints->push_back(current_node_pair);
+    }
+    labels[reachedNode.second] = Traits::Alive;
+    progress.CompletedPixel();
+  }
+  this->m_TargetReachedValue = current_value;
+
+  // As with the fast marching method, the nodes beyond the stopping criterion
+  // are trial nodes, whose value is computed from their alive neighbors, if
+  // they are next to an alive node which updates them. A node on the border of
+  // the image does not update its neighbors along the axis normal to the
+  // border. The other nodes are not reached.
+  const SizeValueType          numberOfSortedNodes = sortedNodes.size();
+  std::vector<OutputPixelType> trialValues(numberOfSortedNodes - numberOfAliveNodes);
+  multiThreader->ParallelizeArray(
+    0,
+    getNumberOfBlocks(trialValues.size()),
+    [&](SizeValueType block) {
+      const SizeValueType first = numberOfAliveNodes + block * blockSize;
+      const SizeValueType last = std::min(numberOfSortedNodes, first + blockSize);
+      for (SizeValueType i = first; i < last; ++i)
+      {
+        const OffsetValueType offset = sortedNodes[i].second;
+        if (labels[offset] != Traits::Trial)
+        {
+          continue;
+        }
+        const NodeType node = m_LabelImage->ComputeIndex(offset);
+        bool           isUpdated = false;
+        for (unsigned int j = 0; j < ImageDimension && !isUpdated; ++j)
+        {
+          for (int s = -1; s < 2 && !isUpdated; s += 2)
+          {
+            const typename NodeType::IndexValueType neighbor = node[j] + s;
+            isUpdated = neighbor > m_StartIndex[j] && neighbor < m_LastIndex[j] &&
+                        labels[offset + s * strides[j]] == Traits::Alive;
+          }
+        }
+        trialValues[i - numberOfAliveNodes] = isUpdated ? solve(offset, node, true) : largeValue;
+      }
+    },
+    nullptr);
+  multiThreader->ParallelizeArray(
+    0,
+    getNumberOfBlocks(trialValues.size()),
+    [&](SizeValueType block) {
+      const SizeValueType first = numberOfAliveNodes + block * blockSize;
+      const SizeValueType last = std::min(numberOfSortedNodes, first + blockSize);
+      for (SizeValueType i = first; i < last; ++i)
+      {
+        const OffsetValueType offset = sortedNodes[i].second;
+        if (labels[offset] == Traits::Trial)
+        {
+          values[offset] = trialValues[i - numberOfAliveNodes];
+          if (values[offset] == largeValue)
+          {
+            labels[offset] = Traits::Far;
+          }
+        }
+      }
+    },
+    nullptr);
+}
+
 template <typename TInput, typename TOutput>
 bool
 FastMarchingImageFilterBase<TInput, TOutput>::DoesVoxelChangeViolateWellComposedness(const NodeType & idx) const
@@ -0,0 +1,258 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef itkFastMarchingIndexedHeap_h
+#define itkFastMarchingIndexedHeap_h
+
+#include "itkIntTypes.h"
+#include "itkNumericTraits.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace itk
+{
+/**
+ * \class FastMarchingIndexedHeap
+ * \brief Min d-ary heap of node pairs supporting the update of the value of
+ * a node already in the heap.
+ *
+ * The heap offers the subset of the std::priority_queue interface used by the
+ * fast marching filters, ordered on the smallest value first. Node pairs
+ * pushed without an identifier behave as with std::priority_queue: a node
+ * pushed several times appears several times in the heap.
+ *
+ * When the heap is given the number of node identifiers with
+ * SetNumberOfIdentifiers(), a node pair can be pushed along with a dense
+ * identifier in [0, NumberOfIdentifiers). If a node with the same identifier
+ * is already in the heap, its value is updated in place (decrease-key) instead
+ * of inserting a duplicate entry, so the heap never holds more entries than
+ * trial nodes.
+ *
+ * \tparam TNodePair node pair type (see NodePair).
+ * \tparam VArity number of children of a heap node. A 4-ary heap has a smaller
+ * depth than a binary heap and accesses the children of a node contiguously.
+ *
+ * \sa FastMarchingBase
+ *
+ * \ingroup ITKFastMarching
+ */
+template <typename TNodePair, unsigned int VArity = 4>
+class FastMarchingIndexedHeap
+{
+public:
+  static_assert(VArity >= 2, "The arity of the heap must be at least 2.");
+
+  using Self = FastMarchingIndexedHeap;
+  using NodePairType = TNodePair;
+  using OutputPixelType = typename NodePairType::OutputPixelType;
+  using IdentifierType = SizeValueType;
+
+  /** Identifier of the node pairs pushed without an identifier. */
+  static constexpr IdentifierType InvalidIdentifier = NumericTraits<IdentifierType>::max();
+
+  bool
+  empty() const
+  {
+    return m_Entries.empty();
+  }
+
+  SizeValueType
+  size() const
+  {
+    return static_cast<SizeValueType>(m_Entries.size());
+  }
+
+  /** Node pair with the smallest value. The heap must not be empty. */
+  const NodePairType &
+  top() const
+  {
+    return m_Entries.front().m_NodePair;
+  }
+
+  /** Insert a node pair without identifier. */
+  void
+  push(const NodePairType & iNodePair)
+  {
+    this->push(iNodePair, InvalidIdentifier);
+  }
+
+  /** Insert a node pair with the given identifier, or update the value of the
+   * node pair with the same identifier if it is already in the heap. */
+  void
+  push(const NodePairType & iNodePair, IdentifierType iIdentifier)
+  {
+    if (iIdentifier < m_Positions.size())
+    {
+      const PositionType position = m_Positions[iIdentifier];
+      if (position != NotInHeap)
+      {
+        const OutputPixelType previousValue = m_Entries[position].m_NodePair.GetValue();
+        m_Entries[position].m_NodePair = iNodePair;
+        if (iNodePair.GetValue() < previousValue)
+        {
+          this->SiftUp(position);
+        }
+        else
+        {
+          this->SiftDown(position);
+        }
+        return;
+      }
+    }
+    else
+    {
+      iIdentifier = InvalidIdentifier;
+    }
+    m_Entries.push_back(EntryType{ iNodePair, iIdentifier });
+    this->SiftUp(static_cast<PositionType>(m_Entries.size() - 1));
+  }
+
+  /** Remove the node pair with the smallest value. The heap must not be empty. */
+  void
+  pop()
+  {
+    this->SetPosition(m_Entries.front().m_Identifier, NotInHeap);
+    if (m_Entries.size() > 1)
+    {
+      m_Entries.front() = m_Entries.back();
+      m_Entries.pop_back();
+      this->SiftDown(0);
+    }
+    else
+    {
+      m_Entries.pop_back();
+    }
+  }
+
+  /** Remove all the node pairs, and release the memory of the heap. */
+  void
+  clear()
+  {
+    for (const EntryType & entry : m_Entries)
+    {
+      this->SetPosition(entry.m_Identifier, NotInHeap);
+    }
+    std::vector<EntryType>().swap(m_Entries);
+  }
+
+  /** Set the number of node identifiers. Identifiers must be smaller than this
+   * number; 0 disables the update of the node pairs in place. The heap is
+   * cleared. */
+  void
+  SetNumberOfIdentifiers(IdentifierType iNumberOfIdentifiers)
+  {
+    this->clear();
+    if (iNumberOfIdentifiers >= static_cast<IdentifierType>(NotInHeap))
+    {
+      // Positions are stored on 32 bits to limit the memory footprint.
+      iNumberOfIdentifiers = 0;
+    }
+    std::vector<PositionType>(iNumberOfIdentifiers, NotInHeap).swap(m_Positions);
+  }
+
+  IdentifierType
+  GetNumberOfIdentifiers() const
+  {
+    return static_cast<IdentifierType>(m_Positions.size());
+  }
+
+  /** Whether a node pair with the given identifier is in the heap. */
+  bool
+  Contains(IdentifierType iIdentifier) const
+  {
+    return iIdentifier < m_Positions.size() && m_Positions[iIdentifier] != NotInHeap;
+  }
+
+private:
+  using PositionType = uint32_t;
+  static constexpr PositionType NotInHeap = NumericTraits<PositionType>::max();
+
+  struct EntryType
+  {
+    NodePairType   m_NodePair;
+    IdentifierType m_Identifier;
+  };
+
+  void
+  SetPosition(IdentifierType iIdentifier, PositionType iPosition)
+  {
+    if (iIdentifier != InvalidIdentifier)
+    {
+      m_Positions[iIdentifier] = iPosition;
+    }
+  }
+
+  void
+  SiftUp(PositionType iPosition)
+  {
+    const EntryType entry = m_Entries[iPosition];
+    while (iPosition > 0)
+    {
+      const PositionType parent = (iPosition - 1) / VArity;
+      if (!(entry.m_NodePair.GetValue() < m_Entries[parent].m_NodePair.GetValue()))
+      {
+        break;
+      }
+      m_Entries[iPosition] = m_Entries[parent];
+      this->SetPosition(m_Entries[iPosition].m_Identifier, iPosition);
+      iPosition = parent;
+    }
+    m_Entries[iPosition] = entry;
+    this->SetPosition(entry.m_Identifier, iPosition);
+  }
+
+  void
+  SiftDown(PositionType iPosition)
+  {
+    const auto      numberOfEntries = static_cast<PositionType>(m_Entries.size());
+    const EntryType entry = m_Entries[iPosition];
+    while (true)
+    {
+      const SizeValueType firstChild = static_cast<SizeValueType>(iPosition) * VArity + 1;
+      if (firstChild >= numberOfEntries)
+      {
+        break;
+      }
+      const auto   lastChild = static_cast<PositionType>(std::min<SizeValueType>(firstChild + VArity, numberOfEntries));
+      PositionType smallestChild = static_cast<PositionType>(firstChild);
+      for (PositionType child = smallestChild + 1; child < lastChild; ++child)
+      {
+        if (m_Entries[child].m_NodePair.GetValue() < m_Entries[smallestChild].m_NodePair.GetValue())
+        {
+          smallestChild = child;
+        }
+      }
+      if (!(m_Entries[smallestChild].m_NodePair.GetValue() < entry.m_NodePair.GetValue()))
+      {
+        break;
+      }
+      m_Entries[iPosition] = m_Entries[smallestChild];
+      this->SetPosition(m_Entries[iPosition].m_Identifier, iPosition);
+      iPosition = smallestChild;
+    }
+    m_Entries[iPosition] = entry;
+    this->SetPosition(entry.m_Identifier, iPosition);
+  }
+
+  std::vector<EntryType>    m_Entries{};
+  std::vector<PositionType> m_Positions{};
+};
+} // end namespace itk
+
+#endif // itkFastMarchingIndexedHeap_h
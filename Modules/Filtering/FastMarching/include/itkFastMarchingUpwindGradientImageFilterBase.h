@@ -104,6 +104,10 @@ protected:
   void
   UpdateNeighbors(OutputImageType * oImage, const NodeType & iNode) override;
 
+  /** Compute the gradient at the alive nodes once the arrival times are known */
+  void
+  GenerateDataWithFastIterativeMethod(OutputImageType * oImage) override;
+
   virtual void
   ComputeGradient(OutputImageType * oImage, const NodeType & iNode);
 };
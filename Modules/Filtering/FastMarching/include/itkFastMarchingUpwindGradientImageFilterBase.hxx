@@ -94,6 +94,49 @@ FastMarchingUpwindGradientImageFilterBase<TInput, TOutput>::UpdateNeighbors(Outp
   this->ComputeGradient(oImage, iNode);
 }
 
+template <typename TInput, typename TOutput>
+void
+FastMarchingUpwindGradientImageFilterBase<TInput, TOutput>::GenerateDataWithFastIterativeMethod(
+  OutputImageType * oImage)
+{
+  Superclass::GenerateDataWithFastIterativeMethod(oImage);
+
+  // The neighbors used by the fast marching method when a node becomes alive
+  // are the alive neighbors with a smaller value, which are the ones selected
+  // by the upwind differences.
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    this->m_BufferedRegion,
+    [this, oImage](const typename Superclass::OutputRegionType & region) {
+      using LabelIteratorType = ImageRegionConstIteratorWithIndex<typename Superclass::LabelImageType>;
+      for (LabelIteratorType it(this->m_LabelImage, region); !it.IsAtEnd(); ++it)
+      {
+        if (it.Get() == Traits::Alive)
+        {
+          this->ComputeGradient(oImage, it.GetIndex());
+        }
+      }
+    },
+    nullptr);
+
+  // The gradient is not computed at the alive points given as input.
+  if (this->m_AlivePoints)
+  {
+    GradientPixelType zeroGradient;
+    zeroGradient.Fill(typename GradientPixelType::ValueType{});
+    const GradientImagePointer gradientImage = this->GetGradientImage();
+    for (auto pointsIter = this->m_AlivePoints->Begin(); pointsIter != this->m_AlivePoints->End(); ++pointsIter)
+    {
+      const NodeType node = pointsIter->Value().GetNode();
+      if (this->m_BufferedRegion.IsInside(node))
+      {
+        gradientImage->SetPixel(node, zeroGradient);
+      }
+    }
+  }
+}
+
 /**
  *
  */
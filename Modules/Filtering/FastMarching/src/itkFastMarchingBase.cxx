@@ -37,4 +37,20 @@ operator<<(std::ostream & out, const FastMarchingTraitsEnums::TopologyCheck valu
     }
   }();
 }
+
+std::ostream &
+operator<<(std::ostream & out, const FastMarchingTraitsEnums::Solver value)
+{
+  return out << [value] {
+    switch (value)
+    {
+      case FastMarchingTraitsEnums::Solver::FastMarching:
+        return "itk::FastMarchingTraitsEnums::Solver::FastMarching";
+      case FastMarchingTraitsEnums::Solver::FastIterative:
+        return "itk::FastMarchingTraitsEnums::Solver::FastIterative";
+      default:
+        return "INVALID VALUE FOR itk::FastMarchingTraitsEnums::Solver";
+    }
+  }();
+}
 } // end namespace itk
@@ -0,0 +1,283 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFastMarchingExtensionImageFilterBase.h"
+#include "itkFastMarchingIndexedHeap.h"
+#include "itkFastMarchingNumberOfElementsStoppingCriterion.h"
+#include "itkFastMarchingThresholdStoppingCriterion.h"
+#include "itkFastMarchingUpwindGradientImageFilterBase.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<float, Dimension>;
+using FilterType = itk::FastMarchingUpwindGradientImageFilterBase<ImageType, ImageType>;
+using NodePairType = FilterType::NodePairType;
+using NodePairContainerType = FilterType::NodePairContainerType;
+using SolverEnum = FilterType::SolverEnum;
+
+bool
+TestIndexedHeap()
+{
+  using HeapType = itk::FastMarchingIndexedHeap<NodePairType>;
+  HeapType heap;
+  heap.SetNumberOfIdentifiers(100);
+
+  const ImageType::IndexType index{};
+  for (unsigned int i = 0; i < 100; ++i)
+  {
+    heap.push(NodePairType(index, static_cast<float>((i * 37) % 100)), i);
+  }
+  // Decrease the value of some nodes, and push a duplicate without identifier.
+  heap.push(NodePairType(index, -1.0f), 50);
+  heap.push(NodePairType(index, 0.5f), 99);
+  heap.push(NodePairType(index, 0.5f));
+  heap.push(NodePairType(index, 200.0f), 0);
+
+  if (heap.size() != 101 || !heap.Contains(50))
+  {
+    std::cerr << "Unexpected heap size " << heap.size() << std::endl;
+    return false;
+  }
+
+  float previousValue = -2.0f;
+  while (!heap.empty())
+  {
+    if (heap.top().GetValue() < previousValue)
+    {
+      std::cerr << "Heap is not ordered: " << heap.top().GetValue() << " < " << previousValue << std::endl;
+      return false;
+    }
+    previousValue = heap.top().GetValue();
+    heap.pop();
+  }
+  if (heap.Contains(50) || previousValue != 200.0f)
+  {
+    std::cerr << "Unexpected last value " << previousValue << std::endl;
+    return false;
+  }
+  return true;
+}
+
+ImageType::Pointer
+MakeSpeedImage()
+{
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::RegionType({ { 2, -3, 1 } }, { { 37, 29, 23 } }));
+  image->SetSpacing(itk::MakeVector(1.0, 0.75, 1.5));
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType & index = it.GetIndex();
+    it.Set(1.0f + 0.5f * std::sin(0.3f * index[0]) * std::cos(0.2f * index[1]) + 0.01f * index[2]);
+  }
+  return image;
+}
+
+FilterType::Pointer
+MakeFilter(const ImageType *                                                    speedImage,
+           itk::FastMarchingStoppingCriterionBase<ImageType, ImageType> *       criterion,
+           SolverEnum                                                           solver,
+           itk::ThreadIdType                                                    numberOfWorkUnits)
+{
+  auto trialPoints = NodePairContainerType::New();
+  trialPoints->push_back(NodePairType({ { 12, 5, 12 } }, 0.0f));
+  trialPoints->push_back(NodePairType({ { 28, 15, 10 } }, 2.0f));
+  // An alive point surrounded by trial points.
+  constexpr ImageType::IndexType alivePoint{ { 22, 8, 14 } };
+  auto                           alivePoints = NodePairContainerType::New();
+  alivePoints->push_back(NodePairType(alivePoint, 0.0f));
+  for (unsigned int d = 0; d < Dimension; ++d)
+  {
+    for (const int s : { -1, 1 })
+    {
+      ImageType::IndexType neighbor = alivePoint;
+      neighbor[d] += s;
+      trialPoints->push_back(NodePairType(neighbor, 0.5f));
+    }
+  }
+  auto forbiddenPoints = NodePairContainerType::New();
+  for (itk::IndexValueType y = -3; y < 12; ++y)
+  {
+    for (itk::IndexValueType z = 5; z < 20; ++z)
+    {
+      forbiddenPoints->push_back(NodePairType({ { 18, y, z } }, 0.0f));
+    }
+  }
+
+  auto filter = FilterType::New();
+  filter->SetInput(speedImage);
+  filter->SetTrialPoints(trialPoints);
+  filter->SetAlivePoints(alivePoints);
+  filter->SetForbiddenPoints(forbiddenPoints);
+  filter->SetStoppingCriterion(criterion);
+  filter->SetSolver(solver);
+  filter->SetNumberOfWorkUnits(numberOfWorkUnits);
+  filter->CollectPointsOn();
+  return filter;
+}
+
+bool
+AreClose(float value, float expected)
+{
+  return std::abs(value - expected) <= 1e-4f * (1.0f + std::abs(expected));
+}
+} // namespace
+
+int
+itkFastMarchingFastIterativeTest(int, char *[])
+{
+  if (!TestIndexedHeap())
+  {
+    return EXIT_FAILURE;
+  }
+
+  const ImageType::Pointer speedImage = MakeSpeedImage();
+  const float              largeValue = itk::NumericTraits<float>::max();
+
+  auto filter = FilterType::New();
+  ITK_TEST_SET_GET_VALUE(SolverEnum::FastMarching, filter->GetSolver());
+  filter->SetSolver(SolverEnum::FastIterative);
+  ITK_TEST_SET_GET_VALUE(SolverEnum::FastIterative, filter->GetSolver());
+  std::cout << SolverEnum::FastIterative << std::endl;
+
+  // Arrival times and gradients over the whole image.
+  using ThresholdCriterionType = itk::FastMarchingThresholdStoppingCriterion<ImageType, ImageType>;
+  auto fullCriterion = ThresholdCriterionType::New();
+  fullCriterion->SetThreshold(largeValue);
+
+  const FilterType::Pointer marching = MakeFilter(speedImage, fullCriterion, SolverEnum::FastMarching, 1);
+  ITK_TRY_EXPECT_NO_EXCEPTION(marching->Update());
+
+  // The fast marching method does not update the neighbors of a node on the
+  // border of the image along the axis normal to the border, so the solutions
+  // are compared on the nodes reached before any node of the border.
+  const ImageType *           expectedOutput = marching->GetOutput();
+  const ImageType::RegionType region = expectedOutput->GetBufferedRegion();
+  float                       frontLimit = largeValue;
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(expectedOutput, region); !it.IsAtEnd(); ++it)
+  {
+    bool isOnBorder = false;
+    for (unsigned int d = 0; d < Dimension; ++d)
+    {
+      isOnBorder |= it.GetIndex()[d] == region.GetIndex()[d] || it.GetIndex()[d] == region.GetUpperIndex()[d];
+    }
+    if (isOnBorder && marching->GetLabelImage()->GetPixel(it.GetIndex()) != FilterType::Traits::Forbidden)
+    {
+      frontLimit = std::min(frontLimit, it.Get());
+    }
+  }
+  std::cout << "Comparing the nodes reached before " << frontLimit << std::endl;
+
+  for (const itk::ThreadIdType numberOfWorkUnits : { 1, 4 })
+  {
+    const FilterType::Pointer iterative =
+      MakeFilter(speedImage, fullCriterion, SolverEnum::FastIterative, numberOfWorkUnits);
+    ITK_TRY_EXPECT_NO_EXCEPTION(iterative->Update());
+
+    for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(expectedOutput, region); !it.IsAtEnd(); ++it)
+    {
+      if (it.Get() >= frontLimit)
+      {
+        continue;
+      }
+      const float value = iterative->GetOutput()->GetPixel(it.GetIndex());
+      const auto  gradient = iterative->GetGradientImage()->GetPixel(it.GetIndex());
+      const auto  expectedGradient = marching->GetGradientImage()->GetPixel(it.GetIndex());
+      bool        gradientsAreClose = true;
+      for (unsigned int d = 0; d < Dimension; ++d)
+      {
+        gradientsAreClose &= AreClose(gradient[d], expectedGradient[d]);
+      }
+      if (!AreClose(value, it.Get()) || !gradientsAreClose)
+      {
+        std::cerr << "Fast iterative solution differs at " << it.GetIndex() << ": " << value << " != " << it.Get()
+                  << ", " << gradient << " != " << expectedGradient << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    ITK_TEST_EXPECT_EQUAL(iterative->GetProcessedPoints()->size(), marching->GetProcessedPoints()->size());
+  }
+
+  // The output beyond the threshold is the one of the fast marching method:
+  // the trial nodes keep the value computed from their alive neighbors, and
+  // the other nodes are not reached.
+  const float threshold = 0.75f * frontLimit;
+  auto        thresholdCriterion = ThresholdCriterionType::New();
+  thresholdCriterion->SetThreshold(threshold);
+  const FilterType::Pointer stopped = MakeFilter(speedImage, thresholdCriterion, SolverEnum::FastIterative, 3);
+  ITK_TRY_EXPECT_NO_EXCEPTION(stopped->Update());
+  const FilterType::Pointer expectedStopped = MakeFilter(speedImage, thresholdCriterion, SolverEnum::FastMarching, 1);
+  ITK_TRY_EXPECT_NO_EXCEPTION(expectedStopped->Update());
+  itk::SizeValueType numberOfTrialNodes = 0;
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(expectedStopped->GetOutput(), region); !it.IsAtEnd(); ++it)
+  {
+    const float value = stopped->GetOutput()->GetPixel(it.GetIndex());
+    if ((it.Get() == largeValue) != (value == largeValue) || !AreClose(value, it.Get()))
+    {
+      std::cerr << "Unexpected value " << value << " at " << it.GetIndex() << ", expected " << it.Get() << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (expectedStopped->GetLabelImage()->GetPixel(it.GetIndex()) == FilterType::Traits::Trial)
+    {
+      ++numberOfTrialNodes;
+      ITK_TEST_EXPECT_TRUE(it.Get() >= threshold - 1e-3f && it.Get() < largeValue);
+    }
+  }
+  ITK_TEST_EXPECT_TRUE(numberOfTrialNodes > 0);
+  ITK_TEST_EXPECT_TRUE(stopped->GetTargetReachedValue() >= threshold);
+
+  // The number of processed nodes is the one of the fast marching method.
+  using NumberOfElementsCriterionType = itk::FastMarchingNumberOfElementsStoppingCriterion<ImageType, ImageType>;
+  auto numberOfElementsCriterion = NumberOfElementsCriterionType::New();
+  numberOfElementsCriterion->SetTargetNumberOfElements(1000);
+  const FilterType::Pointer counted = MakeFilter(speedImage, numberOfElementsCriterion, SolverEnum::FastIterative, 2);
+  ITK_TRY_EXPECT_NO_EXCEPTION(counted->Update());
+  const FilterType::Pointer expectedCounted =
+    MakeFilter(speedImage, numberOfElementsCriterion, SolverEnum::FastMarching, 1);
+  ITK_TRY_EXPECT_NO_EXCEPTION(expectedCounted->Update());
+  ITK_TEST_EXPECT_EQUAL(counted->GetProcessedPoints()->size(), expectedCounted->GetProcessedPoints()->size());
+  ITK_TEST_EXPECT_TRUE(AreClose(counted->GetTargetReachedValue(), expectedCounted->GetTargetReachedValue()));
+
+  // The topology checks and the extension of auxiliary values require the
+  // fast marching method.
+  const FilterType::Pointer topology = MakeFilter(speedImage, fullCriterion, SolverEnum::FastIterative, 2);
+  topology->SetTopologyCheck(FilterType::TopologyCheckEnum::Strict);
+  ITK_TRY_EXPECT_EXCEPTION(topology->Update());
+
+  using ExtensionFilterType = itk::FastMarchingExtensionImageFilterBase<ImageType, ImageType, float, 1>;
+  auto extension = ExtensionFilterType::New();
+  extension->SetInput(speedImage);
+  extension->SetTrialPoints(marching->GetTrialPoints());
+  extension->SetAlivePoints(marching->GetAlivePoints());
+  auto auxiliaryTrialValues = ExtensionFilterType::AuxValueContainerType::New();
+  auxiliaryTrialValues->resize(marching->GetTrialPoints()->size(), ExtensionFilterType::AuxValueVectorType(1.0f));
+  extension->SetAuxiliaryTrialValues(auxiliaryTrialValues);
+  auto auxiliaryAliveValues = ExtensionFilterType::AuxValueContainerType::New();
+  auxiliaryAliveValues->resize(marching->GetAlivePoints()->size(), ExtensionFilterType::AuxValueVectorType(1.0f));
+  extension->SetAuxiliaryAliveValues(auxiliaryAliveValues);
+  extension->SetStoppingCriterion(fullCriterion);
+  extension->SetSolver(SolverEnum::FastIterative);
+  ITK_TRY_EXPECT_EXCEPTION(extension->Update());
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
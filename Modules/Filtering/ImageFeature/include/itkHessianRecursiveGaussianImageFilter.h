@@ -36,7 +36,6 @@ namespace itk
  *
  *
  * \ingroup GradientFilters
- * \ingroup SingleThreaded
  * \ingroup ITKImageFeature
  */
 template <typename TInputImage,
@@ -126,6 +125,10 @@ public:
   itkGetConstMacro(NormalizeAcrossScale, bool);
   itkBooleanMacro(NormalizeAcrossScale);
 
+  /** Set the number of work units to create. */
+  void
+  SetNumberOfWorkUnits(ThreadIdType nb) override;
+
   /** HessianRecursiveGaussianImageFilter needs all of the input to produce an
    * output. Therefore, HessianRecursiveGaussianImageFilter needs to provide
    * an implementation for GenerateInputRequestedRegion in order to inform
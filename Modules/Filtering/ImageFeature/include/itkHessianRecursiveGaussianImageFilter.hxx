@@ -19,6 +19,7 @@
 #define itkHessianRecursiveGaussianImageFilter_hxx
 
 #include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionConstIterator.h"
 #include "itkProgressAccumulator.h"
 
 namespace itk
@@ -114,6 +115,19 @@ HessianRecursiveGaussianImageFilter<TInputImage, TOutputImage>::SetNormalizeAcro
   this->Modified();
 }
 
+template <typename TInputImage, typename TOutputImage>
+void
+HessianRecursiveGaussianImageFilter<TInputImage, TOutputImage>::SetNumberOfWorkUnits(ThreadIdType nb)
+{
+  Superclass::SetNumberOfWorkUnits(nb);
+  for (const auto & smoothingFilter : m_SmoothingFilters)
+  {
+    smoothingFilter->SetNumberOfWorkUnits(nb);
+  }
+  m_DerivativeFilterA->SetNumberOfWorkUnits(nb);
+  m_DerivativeFilterB->SetNumberOfWorkUnits(nb);
+}
+
 template <typename TInputImage, typename TOutputImage>
 void
 HessianRecursiveGaussianImageFilter<TInputImage, TOutputImage>::GenerateInputRequestedRegion()
@@ -295,23 +309,26 @@ HessianRecursiveGaussianImageFilter<TInputImage, TOutputImage>::GenerateData()
       // on the output image of vectors
       m_ImageAdaptor->SelectNthElement(element++);
 
-      ImageRegionIteratorWithIndex<RealImageType> it(derivativeImage, derivativeImage->GetRequestedRegion());
-
-      ImageRegionIteratorWithIndex<OutputImageAdaptorType> ot(m_ImageAdaptor, m_ImageAdaptor->GetRequestedRegion());
-
       const RealType spacingA = inputImage->GetSpacing()[dima];
       const RealType spacingB = inputImage->GetSpacing()[dimb];
 
       const RealType factor = spacingA * spacingB;
 
-      it.GoToBegin();
-      ot.GoToBegin();
-      while (!it.IsAtEnd())
-      {
-        ot.Set(it.Get() / factor);
-        ++it;
-        ++ot;
-      }
+      this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+      this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+        m_ImageAdaptor->GetRequestedRegion(),
+        [this, factor, &derivativeImage](const typename TOutputImage::RegionType & region) {
+          ImageRegionConstIterator<RealImageType>              it(derivativeImage, region);
+          ImageRegionIteratorWithIndex<OutputImageAdaptorType> ot(m_ImageAdaptor, region);
+
+          while (!it.IsAtEnd())
+          {
+            ot.Set(it.Get() / factor);
+            ++it;
+            ++ot;
+          }
+        },
+        nullptr);
 
       derivativeImage->ReleaseData();
     }
@@ -39,10 +39,11 @@ namespace itk
  * filters.
  *
  * This filter supports both scalar and vector pixel types
- * within the input image, including VectorImage type.
+ * within the input image, including VectorImage type. The derivative
+ * along each direction is computed once for all the components of the
+ * input, and the internal filters run with the work units of this filter.
  *
  * \ingroup GradientFilters
- * \ingroup SingleThreaded
  * \ingroup ITKImageGradient
  *
  * \sphinx
@@ -149,6 +150,10 @@ public:
   SetNormalizeAcrossScale(bool normalize);
   itkGetConstMacro(NormalizeAcrossScale, bool);
 
+  /** Set the number of work units to create. */
+  void
+  SetNumberOfWorkUnits(ThreadIdType nb) override;
+
   /** GradientRecursiveGaussianImageFilter needs all of the input to produce an
    * output. Therefore, GradientRecursiveGaussianImageFilter needs to provide
    * an implementation for GenerateInputRequestedRegion in order to inform
@@ -202,11 +207,21 @@ private:
   TransformOutputPixel(ImageRegionIterator<VectorImage<TValue, ImageDimension>> & it)
   {
     // To transform Variable length vector we need to convert to and
-    // from the CovariantVectorType
-    const CovariantVectorType gradient(it.Get().GetDataPointer());
-    CovariantVectorType       physicalGradient;
-    it.GetImage()->TransformLocalVectorToPhysicalVector(gradient, physicalGradient);
-    it.Set(OutputPixelType(physicalGradient.GetDataPointer(), ImageDimension, false));
+    // from the CovariantVectorType, one input component at a time
+    OutputPixelType    gradient = it.Get();
+    const unsigned int nComponents = gradient.GetSize() / ImageDimension;
+
+    for (unsigned int nc = 0; nc < nComponents; ++nc)
+    {
+      const CovariantVectorType componentGradient(gradient.GetDataPointer() + nc * ImageDimension);
+      CovariantVectorType       physicalGradient;
+      it.GetImage()->TransformLocalVectorToPhysicalVector(componentGradient, physicalGradient);
+      for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+      {
+        gradient[nc * ImageDimension + dim] = physicalGradient[dim];
+      }
+    }
+    it.Set(gradient);
   }
 
   template <typename T>
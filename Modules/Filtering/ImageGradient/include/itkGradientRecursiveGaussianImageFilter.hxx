@@ -131,6 +131,18 @@ GradientRecursiveGaussianImageFilter<TInputImage, TOutputImage>::SetNormalizeAcr
   this->Modified();
 }
 
+template <typename TInputImage, typename TOutputImage>
+void
+GradientRecursiveGaussianImageFilter<TInputImage, TOutputImage>::SetNumberOfWorkUnits(ThreadIdType nb)
+{
+  Superclass::SetNumberOfWorkUnits(nb);
+  for (const auto & smoothingFilter : m_SmoothingFilters)
+  {
+    smoothingFilter->SetNumberOfWorkUnits(nb);
+  }
+  m_DerivativeFilter->SetNumberOfWorkUnits(nb);
+}
+
 template <typename TInputImage, typename TOutputImage>
 void
 GradientRecursiveGaussianImageFilter<TInputImage, TOutputImage>::GenerateInputRequestedRegion()
@@ -212,59 +224,66 @@ GradientRecursiveGaussianImageFilter<TInputImage, TOutputImage>::GenerateData()
                                                                  this->m_ImageAdaptor->GetRequestedRegion());
 
 
-  for (unsigned int nc = 0; nc < nComponents; ++nc)
+  // Every derivative direction is computed once for all the components
+  // of the input, then copied to the output in parallel.
+  using OutputRegionType = typename TOutputImage::RegionType;
+  this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+
+  for (unsigned int dim = 0; dim < ImageDimension; ++dim)
   {
-    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    unsigned int i = 0;
+    int          j = 0;
+    while (i != imageDimensionMinus1)
     {
-      unsigned int i = 0;
-      int          j = 0;
-      while (i != imageDimensionMinus1)
+      if (i == dim)
       {
-        if (i == dim)
-        {
-          ++j;
-        }
-        m_SmoothingFilters[i]->SetDirection(j);
-        ++i;
         ++j;
       }
-      m_DerivativeFilter->SetDirection(dim);
+      m_SmoothingFilters[i]->SetDirection(j);
+      ++i;
+      ++j;
+    }
+    m_DerivativeFilter->SetDirection(dim);
 
 
-      typename RealImageType::Pointer derivativeImage;
-      if constexpr (ImageDimension > 1)
-      {
-        const auto                  imageDimensionMinus2 = static_cast<unsigned int>(ImageDimension - 2);
-        const GaussianFilterPointer lastFilter = m_SmoothingFilters[imageDimensionMinus2];
-        lastFilter->UpdateLargestPossibleRegion();
-        derivativeImage = lastFilter->GetOutput();
-      }
-      else
-      {
-        m_DerivativeFilter->UpdateLargestPossibleRegion();
-        derivativeImage = m_DerivativeFilter->GetOutput();
-      }
+    typename RealImageType::Pointer derivativeImage;
+    if constexpr (ImageDimension > 1)
+    {
+      const auto                  imageDimensionMinus2 = static_cast<unsigned int>(ImageDimension - 2);
+      const GaussianFilterPointer lastFilter = m_SmoothingFilters[imageDimensionMinus2];
+      lastFilter->UpdateLargestPossibleRegion();
+      derivativeImage = lastFilter->GetOutput();
+    }
+    else
+    {
+      m_DerivativeFilter->UpdateLargestPossibleRegion();
+      derivativeImage = m_DerivativeFilter->GetOutput();
+    }
+
+    const ScalarRealType spacing = inputImage->GetSpacing()[dim];
 
+    for (unsigned int nc = 0; nc < nComponents; ++nc)
+    {
       // Copy the results to the corresponding component
       // on the output image of vectors
       m_ImageAdaptor->SelectNthElement(nc * ImageDimension + dim);
 
-      ImageRegionIteratorWithIndex<RealImageType> it(derivativeImage, derivativeImage->GetRequestedRegion());
-
-      ImageRegionIteratorWithIndex<OutputImageAdaptorType> ot(m_ImageAdaptor, m_ImageAdaptor->GetRequestedRegion());
-
-      const ScalarRealType spacing = inputImage->GetSpacing()[dim];
-
-      it.GoToBegin();
-      ot.GoToBegin();
-      while (!it.IsAtEnd())
-      {
-        auto outValue = static_cast<OutputComponentType>(
-          DefaultConvertPixelTraits<InternalRealType>::GetNthComponent(nc, it.Get() / spacing));
-        ot.Set(outValue);
-        ++it;
-        ++ot;
-      }
+      this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+        m_ImageAdaptor->GetRequestedRegion(),
+        [this, nc, spacing, &derivativeImage](const OutputRegionType & region) {
+          ImageRegionConstIterator<RealImageType>              it(derivativeImage, region);
+          ImageRegionIteratorWithIndex<OutputImageAdaptorType> ot(m_ImageAdaptor, region);
+
+          while (!it.IsAtEnd())
+          {
+            auto outValue = static_cast<OutputComponentType>(
+              DefaultConvertPixelTraits<InternalRealType>::GetNthComponent(nc, it.Get() / spacing));
+            ot.Set(outValue);
+            ++it;
+            ++ot;
+          }
+        },
+        nullptr);
     }
   }
 
@@ -284,16 +303,19 @@ GradientRecursiveGaussianImageFilter<TInputImage, TOutputImage>::GenerateData()
   // of the output gradient image.
   if (this->m_UseImageDirection)
   {
+    OutputImageType * gradientImage = outputImage;
+    this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+      gradientImage->GetRequestedRegion(),
+      [this, gradientImage](const OutputRegionType & region) {
+        ImageRegionIterator<OutputImageType> itr(gradientImage, region);
 
-    OutputImageType *                    gradientImage = outputImage;
-    ImageRegionIterator<OutputImageType> itr(gradientImage, gradientImage->GetRequestedRegion());
-
-    while (!itr.IsAtEnd())
-    {
-
-      TransformOutputPixel(itr);
-      ++itr;
-    }
+        while (!itr.IsAtEnd())
+        {
+          TransformOutputPixel(itr);
+          ++itr;
+        }
+      },
+      nullptr);
   }
 }
 
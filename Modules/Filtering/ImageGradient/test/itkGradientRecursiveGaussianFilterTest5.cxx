@@ -0,0 +1,134 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkGradientRecursiveGaussianImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkVectorImage.h"
+#include "itkTestingMacros.h"
+
+/*
+ * Test that the gradient of a VectorImage, whose derivatives are computed
+ * once for all components, matches the gradients of the components computed
+ * separately, for any number of work units.
+ */
+
+int
+itkGradientRecursiveGaussianFilterTest5(int, char *[])
+{
+  constexpr unsigned int Dimension = 3;
+  constexpr unsigned int NumberOfComponents = 3;
+
+  using ScalarImageType = itk::Image<float, Dimension>;
+  using VectorImageType = itk::VectorImage<float, Dimension>;
+  using ScalarGradientImageType = itk::Image<itk::CovariantVector<double, Dimension>, Dimension>;
+  using VectorGradientImageType = itk::VectorImage<double, Dimension>;
+
+  const ScalarImageType::SizeType size{ { 13, 9, 7 } };
+  ScalarImageType::DirectionType  direction;
+  direction.SetIdentity();
+  direction[0][0] = 0.0;
+  direction[0][1] = -1.0;
+  direction[1][0] = 1.0;
+  direction[1][1] = 0.0;
+  ScalarImageType::SpacingType spacing;
+  spacing[0] = 0.5;
+  spacing[1] = 1.0;
+  spacing[2] = 2.0;
+
+  auto vectorImage = VectorImageType::New();
+  vectorImage->SetRegions(size);
+  vectorImage->SetNumberOfComponentsPerPixel(NumberOfComponents);
+  vectorImage->SetSpacing(spacing);
+  vectorImage->SetDirection(direction);
+  vectorImage->Allocate();
+
+  std::vector<ScalarImageType::Pointer> componentImages;
+  for (unsigned int c = 0; c < NumberOfComponents; ++c)
+  {
+    auto componentImage = ScalarImageType::New();
+    componentImage->SetRegions(size);
+    componentImage->SetSpacing(spacing);
+    componentImage->SetDirection(direction);
+    componentImage->Allocate();
+    componentImages.push_back(componentImage);
+  }
+
+  for (itk::ImageRegionIteratorWithIndex<VectorImageType> it(vectorImage, vectorImage->GetLargestPossibleRegion());
+       !it.IsAtEnd();
+       ++it)
+  {
+    const VectorImageType::IndexType & index = it.GetIndex();
+    VectorImageType::PixelType         value(NumberOfComponents);
+    for (unsigned int c = 0; c < NumberOfComponents; ++c)
+    {
+      value[c] = static_cast<float>((index[0] * (c + 1) + index[1] * index[1] * c + index[2] * 3) % 11);
+      componentImages[c]->SetPixel(index, value[c]);
+    }
+    it.Set(value);
+  }
+
+  using VectorFilterType = itk::GradientRecursiveGaussianImageFilter<VectorImageType, VectorGradientImageType>;
+  using ScalarFilterType = itk::GradientRecursiveGaussianImageFilter<ScalarImageType, ScalarGradientImageType>;
+
+  std::vector<ScalarGradientImageType::Pointer> componentGradients;
+  for (unsigned int c = 0; c < NumberOfComponents; ++c)
+  {
+    auto scalarFilter = ScalarFilterType::New();
+    scalarFilter->SetInput(componentImages[c]);
+    scalarFilter->SetSigma(1.5);
+    ITK_TRY_EXPECT_NO_EXCEPTION(scalarFilter->Update());
+    componentGradients.push_back(scalarFilter->GetOutput());
+  }
+
+  for (const itk::ThreadIdType numberOfWorkUnits : { 1u, 3u, 8u })
+  {
+    auto vectorFilter = VectorFilterType::New();
+    vectorFilter->SetInput(vectorImage);
+    vectorFilter->SetSigma(1.5);
+    vectorFilter->SetNumberOfWorkUnits(numberOfWorkUnits);
+    ITK_TEST_SET_GET_VALUE(numberOfWorkUnits, vectorFilter->GetNumberOfWorkUnits());
+    ITK_TRY_EXPECT_NO_EXCEPTION(vectorFilter->Update());
+
+    const VectorGradientImageType * gradient = vectorFilter->GetOutput();
+    ITK_TEST_EXPECT_EQUAL(gradient->GetNumberOfComponentsPerPixel(), NumberOfComponents * Dimension);
+
+    using IteratorType = itk::ImageRegionConstIteratorWithIndex<VectorGradientImageType>;
+    for (IteratorType it(gradient, gradient->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+    {
+      const VectorGradientImageType::PixelType value = it.Get();
+      for (unsigned int c = 0; c < NumberOfComponents; ++c)
+      {
+        const ScalarGradientImageType::PixelType & expected = componentGradients[c]->GetPixel(it.GetIndex());
+        for (unsigned int d = 0; d < Dimension; ++d)
+        {
+          if (std::abs(value[c * Dimension + d] - expected[d]) > 1e-6 * (1.0 + std::abs(expected[d])))
+          {
+            std::cerr << "Gradient component " << c * Dimension + d << " at " << it.GetIndex() << " is "
+                      << value[c * Dimension + d] << ", expected " << expected[d] << " with " << numberOfWorkUnits
+                      << " work units." << std::endl;
+            return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -23,7 +23,11 @@
 #include "itkSimpleDataObjectDecorator.h"
 #include "itkHistogram.h"
 #include "itkPrintHelper.h"
+#include <algorithm>
+#include <array>
+#include <memory>
 #include <mutex>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -44,13 +48,18 @@ namespace itk
  * Optionally, the filter also computes intensity histograms on each
  * object. If histograms are enabled, a median intensity value can
  * also be computed, although its accuracy is limited to the bin width
- * of the histogram. If histograms are not enabled, the median returns
- * zero.
+ * of the histogram. If exact quantiles are enabled, the filter keeps the
+ * intensities of each object, and the median and the other quantiles are
+ * computed exactly, by selection. If neither histograms nor exact
+ * quantiles are enabled, the median returns zero.
  *
  * This filter is automatically multi-threaded and can stream its
  * input when NumberOfStreamDivisions is set to more than
- * 1. Statistics are independently computed for each streamed and
- * threaded region then merged.
+ * 1. Statistics are independently accumulated by each work unit, then
+ * merged once, after the last streamed region, in parallel over the labels.
+ * A work unit stores the statistics of the labels from zero to
+ * MaximumDenseLabel in a table indexed by the label, and the other labels
+ * in a hash map.
  *
  * \ingroup MathematicalStatisticsImageFilters
  * \ingroup ITKImageStatistics
@@ -198,6 +207,8 @@ public:
       m_Variance = l.m_Variance;
       m_BoundingBox = l.m_BoundingBox;
       m_Histogram = l.m_Histogram;
+      m_Median = l.m_Median;
+      m_Values = l.m_Values;
     }
 
     LabelStatistics(LabelStatistics &&) = default;
@@ -218,6 +229,8 @@ public:
         m_Variance = l.m_Variance;
         m_BoundingBox = l.m_BoundingBox;
         m_Histogram = l.m_Histogram;
+        m_Median = l.m_Median;
+        m_Values = l.m_Values;
       }
       return *this;
     }
@@ -241,6 +254,8 @@ public:
       os << "Variance: " << static_cast<typename NumericTraits<RealType>::PrintType>(labelStatistics.m_Variance)
          << std::endl;
       os << "BoundingBox: " << labelStatistics.m_BoundingBox << std::endl;
+      os << "Median: " << static_cast<typename NumericTraits<RealType>::PrintType>(labelStatistics.m_Median)
+         << std::endl;
 
       os << "Histogram: ";
       if (labelStatistics.m_Histogram)
@@ -265,6 +280,11 @@ public:
     RealType                        m_Variance;
     BoundingBoxType                 m_BoundingBox;
     typename HistogramType::Pointer m_Histogram;
+
+    /** Exact median, and intensities of the label, when exact quantiles are
+     * enabled. */
+    RealType              m_Median{};
+    std::vector<RealType> m_Values{};
   };
 
   /** Type of the map used to store data per label */
@@ -281,6 +301,16 @@ public:
   itkGetConstMacro(UseHistograms, bool);
   itkBooleanMacro(UseHistograms);
 
+  /** Set/Get whether the intensities of each label are kept, so that the
+   * median and the other quantiles are exact. This needs as much memory as
+   * the input image. Default is off. */
+  itkSetMacro(UseExactQuantiles, bool);
+  itkGetConstMacro(UseExactQuantiles, bool);
+  itkBooleanMacro(UseExactQuantiles);
+
+  /** The work units store the statistics of the labels from zero to
+   * MaximumDenseLabel in a table indexed by the label. */
+  static constexpr SizeValueType MaximumDenseLabel = 65535;
 
   virtual const ValidLabelValuesContainerType &
   GetValidLabelValues() const
@@ -325,11 +355,20 @@ public:
   RealType
   GetMean(LabelPixelType label) const;
 
-  /** Return the computed Median for a label. Requires histograms to be enabled!
+  /** Return the computed Median for a label. Requires exact quantiles or
+   * histograms to be enabled! The median of an even number of intensities is
+   * the mean of the two middle ones.
    */
   RealType
   GetMedian(LabelPixelType label) const;
 
+  /** Return the quantile of probability p, between 0 and 1, of the
+   * intensities of a label, interpolated linearly between the closest
+   * intensities. Requires exact quantiles to be enabled, otherwise returns
+   * zero. Each call selects the quantile from a copy of the intensities. */
+  RealType
+  GetQuantile(LabelPixelType label, double p) const;
+
   /** Return the computed Standard Deviation for a label. */
   RealType
   GetSigma(LabelPixelType label) const;
@@ -391,13 +430,10 @@ protected:
   PrintSelf(std::ostream & os, Indent indent) const override;
 
   void
-  BeforeStreamedGenerateData() override
-  {
-    this->AllocateOutputs();
-    m_LabelStatistics.clear();
-  }
+  BeforeStreamedGenerateData() override;
 
-  /** Do final mean and variance computation from data accumulated in threads.
+  /** Merge the statistics accumulated by the work units, and do final mean,
+   * variance and median computation.
    */
   void
   AfterStreamedGenerateData() override;
@@ -406,13 +442,141 @@ protected:
   ThreadedStreamedGenerateData(const RegionType &) override;
 
 private:
+  using AbsoluteFrequencyType = typename HistogramType::AbsoluteFrequencyType;
+
+  /** Statistics of a label accumulated by a work unit. */
+  struct LabelAccumulator
+  {
+    LabelAccumulator()
+    {
+      for (unsigned int i = 0; i < ImageDimension; ++i)
+      {
+        m_BoundingBox[2 * i] = NumericTraits<IndexValueType>::max();
+        m_BoundingBox[2 * i + 1] = NumericTraits<IndexValueType>::NonpositiveMin();
+      }
+    }
+
+    IdentifierType                                 m_Count{};
+    RealType                                       m_Sum{};
+    RealType                                       m_SumOfSquares{};
+    RealType                                       m_Minimum{ NumericTraits<RealType>::max() };
+    RealType                                       m_Maximum{ NumericTraits<RealType>::NonpositiveMin() };
+    std::array<IndexValueType, 2 * ImageDimension> m_BoundingBox{};
+    std::vector<AbsoluteFrequencyType>             m_Frequencies{};
+    std::vector<RealType>                          m_Values{};
+  };
+
+  /** Statistics of the labels accumulated by a work unit: the labels from
+   * zero to MaximumDenseLabel in a table indexed by the label, which grows
+   * as needed, and the other labels in a hash map. A label of the table is
+   * present when its count is not zero. */
+  class ThreadAccumulators
+  {
+  public:
+    LabelAccumulator &
+    Get(LabelPixelType label)
+    {
+      SizeValueType index;
+      if (IsDenseLabel(label, index))
+      {
+        if (index >= m_Dense.size())
+        {
+          m_Dense.resize(std::min(MaximumDenseLabel + 1, std::max(index + 1, 2 * m_Dense.size())));
+        }
+        return m_Dense[index];
+      }
+      return m_Sparse[label];
+    }
+
+    const LabelAccumulator *
+    Find(LabelPixelType label) const
+    {
+      SizeValueType index;
+      if (IsDenseLabel(label, index))
+      {
+        return index < m_Dense.size() && m_Dense[index].m_Count > 0 ? &m_Dense[index] : nullptr;
+      }
+      const auto it = m_Sparse.find(label);
+      return it != m_Sparse.end() ? &it->second : nullptr;
+    }
+
+    /** Call f(label) for each label present. */
+    template <typename TFunction>
+    void
+    ForEachLabel(TFunction f) const
+    {
+      for (SizeValueType index = 0; index < m_Dense.size(); ++index)
+      {
+        if (m_Dense[index].m_Count > 0)
+        {
+          f(static_cast<LabelPixelType>(index));
+        }
+      }
+      for (const auto & labelAccumulator : m_Sparse)
+      {
+        f(labelAccumulator.first);
+      }
+    }
+
+  private:
+    static bool
+    IsDenseLabel(LabelPixelType label, SizeValueType & index)
+    {
+      if constexpr (std::is_integral_v<LabelPixelType> && !std::is_same_v<LabelPixelType, bool>)
+      {
+        if constexpr (std::is_signed_v<LabelPixelType>)
+        {
+          if (label < 0)
+          {
+            return false;
+          }
+        }
+        if (static_cast<std::make_unsigned_t<LabelPixelType>>(label) <= MaximumDenseLabel)
+        {
+          index = static_cast<SizeValueType>(label);
+          return true;
+        }
+      }
+      return false;
+    }
+
+    std::vector<LabelAccumulator>                        m_Dense{};
+    std::unordered_map<LabelPixelType, LabelAccumulator> m_Sparse{};
+  };
+  using ThreadAccumulatorsPointer = std::unique_ptr<ThreadAccumulators>;
+
+  /** Get accumulators which are not used by another work unit, to
+   * accumulate the statistics of a region, and give them back once the
+   * region is processed. The mutex is only held to take or give back the
+   * accumulators: they are merged after the last streamed region. */
+  ThreadAccumulatorsPointer
+  AcquireThreadAccumulators();
   void
-  MergeMap(MapType &, MapType &) const;
+  ReleaseThreadAccumulators(ThreadAccumulatorsPointer && accumulators);
+
+  /** Find the bin of an intensity in the label histograms, as
+   * Histogram::GetIndex() does: the bin is computed from the uniform bin
+   * width, then corrected with the bin bounds. Return false when the
+   * intensity is outside of the bins. */
+  bool
+  ComputeHistogramBin(RealType value, SizeValueType & bin) const;
+
+  /** Select the quantile of probability p of values, whose order changes. */
+  static RealType
+  SelectQuantile(std::vector<RealType> & values, double p);
 
   MapType                       m_LabelStatistics{};
   ValidLabelValuesContainerType m_ValidLabelValues{};
 
   bool m_UseHistograms{};
+  bool m_UseExactQuantiles{};
+
+  /** Histogram with the bins of the label histograms, to find the bin of an
+   * intensity. */
+  HistogramPointer m_BinHistogram{};
+  double           m_BinScale{};
+
+  std::vector<ThreadAccumulatorsPointer> m_ThreadAccumulators{};
 
   typename HistogramType::SizeType m_NumBins{};
 
@@ -18,9 +18,9 @@
 #ifndef itkLabelStatisticsImageFilter_hxx
 #define itkLabelStatisticsImageFilter_hxx
 
-#include "itkImageLinearConstIteratorWithIndex.h"
 #include "itkImageScanlineConstIterator.h"
 #include "itkTotalProgressReporter.h"
+#include "itkMath.h"
 #include <algorithm> // For min and max.
 
 namespace itk
@@ -53,59 +53,105 @@ LabelStatisticsImageFilter<TInputImage, TLabelImage>::SetHistogramParameters(con
 
 template <typename TInputImage, typename TLabelImage>
 void
-LabelStatisticsImageFilter<TInputImage, TLabelImage>::MergeMap(MapType & m1, MapType & m2) const
+LabelStatisticsImageFilter<TInputImage, TLabelImage>::BeforeStreamedGenerateData()
 {
+  this->AllocateOutputs();
+  m_LabelStatistics.clear();
+  m_ThreadAccumulators.clear();
 
-  for (auto & m2_value : m2)
+  m_BinHistogram = nullptr;
+  if (m_UseHistograms)
   {
-    // does this label exist in the cumulative structure yet?
-    auto m1It = m1.find(m2_value.first);
-    if (m1It == m1.end())
-    {
-      // move m2 entry into m1, this reuses the histogram if needed.
-      m1.emplace(m2_value.first, std::move(m2_value.second));
-    }
-    else
-    {
+    m_BinHistogram = LabelStatistics(m_NumBins[0], m_LowerBound, m_UpperBound).m_Histogram;
+    m_BinScale = static_cast<double>(m_NumBins[0]) /
+                 static_cast<double>(m_BinHistogram->GetBinMax(0, m_NumBins[0] - 1) - m_BinHistogram->GetBinMin(0, 0));
+  }
+}
 
+template <typename TInputImage, typename TLabelImage>
+bool
+LabelStatisticsImageFilter<TInputImage, TLabelImage>::ComputeHistogramBin(RealType value, SizeValueType & bin) const
+{
+  const auto &        minimums = m_BinHistogram->GetDimensionMins(0);
+  const auto &        maximums = m_BinHistogram->GetDimensionMaxs(0);
+  const SizeValueType last = minimums.size() - 1;
 
-      typename MapType::mapped_type & labelStats = m1It->second;
+  if (value < minimums[0])
+  {
+    return false;
+  }
+  if (value >= maximums[last])
+  {
+    // Need to include the last endpoint in the last bin.
+    bin = last;
+    return Math::AlmostEquals(value, maximums[last]);
+  }
+  if (Math::isnan(value))
+  {
+    // The bin where the binary search of Histogram::GetIndex() stops
+    bin = (last + 1) / 2;
+    return true;
+  }
 
-      // accumulate the information from this thread
-      labelStats.m_Count += m2_value.second.m_Count;
-      labelStats.m_Sum += m2_value.second.m_Sum;
-      labelStats.m_SumOfSquares += m2_value.second.m_SumOfSquares;
+  const double approximateBin = static_cast<double>(value - minimums[0]) * m_BinScale;
+  bin = std::isfinite(approximateBin) ? std::min(last, static_cast<SizeValueType>(approximateBin)) : 0;
+  while (value < minimums[bin])
+  {
+    --bin;
+  }
+  while (value >= maximums[bin])
+  {
+    ++bin;
+  }
+  return true;
+}
 
-      if (labelStats.m_Minimum > m2_value.second.m_Minimum)
-      {
-        labelStats.m_Minimum = m2_value.second.m_Minimum;
-      }
-      if (labelStats.m_Maximum < m2_value.second.m_Maximum)
-      {
-        labelStats.m_Maximum = m2_value.second.m_Maximum;
-      }
+template <typename TInputImage, typename TLabelImage>
+auto
+LabelStatisticsImageFilter<TInputImage, TLabelImage>::AcquireThreadAccumulators() -> ThreadAccumulatorsPointer
+{
+  {
+    const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+    if (!m_ThreadAccumulators.empty())
+    {
+      ThreadAccumulatorsPointer accumulators = std::move(m_ThreadAccumulators.back());
+      m_ThreadAccumulators.pop_back();
+      return accumulators;
+    }
+  }
+  return std::make_unique<ThreadAccumulators>();
+}
 
-      // bounding box is min,max pairs
-      for (unsigned int ii = 0; ii < (ImageDimension * 2); ii += 2)
-      {
-        labelStats.m_BoundingBox[ii] = std::min(labelStats.m_BoundingBox[ii], m2_value.second.m_BoundingBox[ii]);
-        labelStats.m_BoundingBox[ii + 1] =
-          std::max(labelStats.m_BoundingBox[ii + 1], m2_value.second.m_BoundingBox[ii + 1]);
-      }
+template <typename TInputImage, typename TLabelImage>
+void
+LabelStatisticsImageFilter<TInputImage, TLabelImage>::ReleaseThreadAccumulators(
+  ThreadAccumulatorsPointer && accumulators)
+{
+  const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+  m_ThreadAccumulators.push_back(std::move(accumulators));
+}
 
-      // if enabled, update the histogram for this label
-      if (m_UseHistograms)
-      {
-        typename HistogramType::IndexType index;
-        index.SetSize(1);
-        for (unsigned int bin = 0; bin < m_NumBins[0]; ++bin)
-        {
-          index[0] = bin;
-          labelStats.m_Histogram->IncreaseFrequency(bin, m2_value.second.m_Histogram->GetFrequency(bin));
-        }
-      }
-    }
+template <typename TInputImage, typename TLabelImage>
+auto
+LabelStatisticsImageFilter<TInputImage, TLabelImage>::SelectQuantile(std::vector<RealType> & values, double p)
+  -> RealType
+{
+  if (values.empty())
+  {
+    return RealType{};
   }
+
+  // Linear interpolation between the closest order statistics.
+  const double position = std::clamp(p, 0.0, 1.0) * static_cast<double>(values.size() - 1);
+  const auto   lower = static_cast<size_t>(position);
+  std::nth_element(values.begin(), values.begin() + lower, values.end());
+  const RealType lowerValue = values[lower];
+  if (lower + 1 == values.size())
+  {
+    return lowerValue;
+  }
+  const RealType upperValue = *std::min_element(values.begin() + lower + 1, values.end());
+  return lowerValue + static_cast<RealType>(position - static_cast<double>(lower)) * (upperValue - lowerValue);
 }
 
 template <typename TInputImage, typename TLabelImage>
@@ -114,45 +160,110 @@ LabelStatisticsImageFilter<TInputImage, TLabelImage>::AfterStreamedGenerateData(
 {
   Superclass::AfterStreamedGenerateData();
 
-  // compute the remainder of the statistics
+  // Create the statistics of all the labels, so that they are merged in
+  // parallel without changing the map.
+  for (const ThreadAccumulatorsPointer & accumulators : m_ThreadAccumulators)
+  {
+    accumulators->ForEachLabel([this](LabelPixelType label) {
+      if (m_LabelStatistics.find(label) == m_LabelStatistics.end())
+      {
+        if (m_UseHistograms)
+        {
+          m_LabelStatistics.emplace(label, LabelStatistics(m_NumBins[0], m_LowerBound, m_UpperBound));
+        }
+        else
+        {
+          m_LabelStatistics.emplace(label, LabelStatistics());
+        }
+      }
+    });
+  }
+
+  // Now update the cached vector of valid labels.
+  m_ValidLabelValues.resize(0);
+  m_ValidLabelValues.reserve(m_LabelStatistics.size());
+  std::vector<LabelStatistics *> labelStatistics;
+  labelStatistics.reserve(m_LabelStatistics.size());
   for (auto & mapValue : m_LabelStatistics)
   {
-    typename MapType::mapped_type & labelStats = mapValue.second;
+    m_ValidLabelValues.push_back(mapValue.first);
+    labelStatistics.push_back(&mapValue.second);
+  }
 
-    labelStats.m_Mean = labelStats.m_Sum / static_cast<RealType>(labelStats.m_Count);
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    m_ValidLabelValues.size(),
+    [this, &labelStatistics](SizeValueType i) {
+      LabelStatistics & labelStats = *labelStatistics[i];
 
-    // variance
-    if (labelStats.m_Count > 1)
-    {
-      // unbiased estimate of variance
-      LabelStatistics & ls = mapValue.second;
-      const RealType    sumSquared = ls.m_Sum * ls.m_Sum;
-      const auto        count = static_cast<RealType>(ls.m_Count);
+      // accumulate the information of the work units
+      for (const ThreadAccumulatorsPointer & accumulators : m_ThreadAccumulators)
+      {
+        const LabelAccumulator * accumulator = accumulators->Find(m_ValidLabelValues[i]);
+        if (accumulator == nullptr)
+        {
+          continue;
+        }
+        labelStats.m_Count += accumulator->m_Count;
+        labelStats.m_Sum += accumulator->m_Sum;
+        labelStats.m_SumOfSquares += accumulator->m_SumOfSquares;
+        labelStats.m_Minimum = std::min(labelStats.m_Minimum, accumulator->m_Minimum);
+        labelStats.m_Maximum = std::max(labelStats.m_Maximum, accumulator->m_Maximum);
+
+        // bounding box is min,max pairs
+        for (unsigned int ii = 0; ii < (ImageDimension * 2); ii += 2)
+        {
+          labelStats.m_BoundingBox[ii] = std::min(labelStats.m_BoundingBox[ii], accumulator->m_BoundingBox[ii]);
+          labelStats.m_BoundingBox[ii + 1] =
+            std::max(labelStats.m_BoundingBox[ii + 1], accumulator->m_BoundingBox[ii + 1]);
+        }
 
-      ls.m_Variance = (ls.m_SumOfSquares - sumSquared / count) / (count - 1.0);
-    }
-    else
-    {
-      labelStats.m_Variance = RealType{};
-    }
+        // if enabled, update the histogram for this label
+        for (SizeValueType bin = 0; bin < accumulator->m_Frequencies.size(); ++bin)
+        {
+          if (accumulator->m_Frequencies[bin] != 0)
+          {
+            labelStats.m_Histogram->IncreaseFrequency(bin, accumulator->m_Frequencies[bin]);
+          }
+        }
 
-    // sigma
-    labelStats.m_Sigma = 0.0;
-    if (labelStats.m_Variance >= 0.0)
-    {
-      labelStats.m_Sigma = std::sqrt(labelStats.m_Variance);
-    }
-  }
+        labelStats.m_Values.insert(
+          labelStats.m_Values.end(), accumulator->m_Values.begin(), accumulator->m_Values.end());
+      }
 
-  {
-    // Now update the cached vector of valid labels.
-    m_ValidLabelValues.resize(0);
-    m_ValidLabelValues.reserve(m_LabelStatistics.size());
-    for (auto & mapValue : m_LabelStatistics)
-    {
-      m_ValidLabelValues.push_back(mapValue.first);
-    }
-  }
+      // compute the remainder of the statistics
+      labelStats.m_Mean = labelStats.m_Sum / static_cast<RealType>(labelStats.m_Count);
+
+      // variance
+      if (labelStats.m_Count > 1)
+      {
+        // unbiased estimate of variance
+        const RealType sumSquared = labelStats.m_Sum * labelStats.m_Sum;
+        const auto     count = static_cast<RealType>(labelStats.m_Count);
+
+        labelStats.m_Variance = (labelStats.m_SumOfSquares - sumSquared / count) / (count - 1.0);
+      }
+      else
+      {
+        labelStats.m_Variance = RealType{};
+      }
+
+      // sigma
+      labelStats.m_Sigma = 0.0;
+      if (labelStats.m_Variance >= 0.0)
+      {
+        labelStats.m_Sigma = std::sqrt(labelStats.m_Variance);
+      }
+
+      if (m_UseExactQuantiles)
+      {
+        labelStats.m_Median = SelectQuantile(labelStats.m_Values, 0.5);
+      }
+    },
+    nullptr);
+
+  m_ThreadAccumulators.clear();
+  m_BinHistogram = nullptr;
 }
 
 template <typename TInputImage, typename TLabelImage>
@@ -160,11 +271,8 @@ void
 LabelStatisticsImageFilter<TInputImage, TLabelImage>::ThreadedStreamedGenerateData(
   const RegionType & outputRegionForThread)
 {
-
-  MapType localStatistics;
-
-  typename HistogramType::IndexType             histogramIndex(1);
-  typename HistogramType::MeasurementVectorType histogramMeasurement(1);
+  const bool useHistograms = m_UseHistograms;
+  const bool useExactQuantiles = m_UseExactQuantiles;
 
   const SizeValueType size0 = outputRegionForThread.GetSize(0);
   if (size0 == 0)
@@ -172,69 +280,74 @@ LabelStatisticsImageFilter<TInputImage, TLabelImage>::ThreadedStreamedGenerateDa
     return;
   }
 
-  ImageLinearConstIteratorWithIndex<TInputImage> it(this->GetInput(), outputRegionForThread);
+  ThreadAccumulatorsPointer accumulators = this->AcquireThreadAccumulators();
 
-  ImageScanlineConstIterator labelIt(this->GetLabelInput(), outputRegionForThread);
+  ImageScanlineConstIterator it(this->GetInput(), outputRegionForThread);
 
-  auto mapIt = localStatistics.end();
+  ImageScanlineConstIterator labelIt(this->GetLabelInput(), outputRegionForThread);
 
   // do the work
   while (!it.IsAtEnd())
   {
+    const IndexType lineIndex = it.GetIndex();
+    IndexValueType  x = lineIndex[0];
+
+    // The accumulator of the current run of pixels with the same label.
+    LabelAccumulator * accumulator = nullptr;
+    LabelPixelType     runLabel{};
+
     while (!it.IsAtEndOfLine())
     {
-      const RealType & value = static_cast<RealType>(it.Get());
+      const auto value = static_cast<RealType>(it.Get());
 
       const LabelPixelType & label = labelIt.Get();
 
-      // is the label already in this thread?
-      mapIt = localStatistics.find(label);
-      if (mapIt == localStatistics.end())
+      if (accumulator == nullptr || label != runLabel)
       {
-        // create a new statistics object
-        if (m_UseHistograms)
-        {
-          mapIt = localStatistics.emplace(label, LabelStatistics(m_NumBins[0], m_LowerBound, m_UpperBound)).first;
-        }
-        else
+        accumulator = &accumulators->Get(label);
+        runLabel = label;
+
+        // The bounding box along the other axes is the same for the run.
+        for (unsigned int i = 1; i < ImageDimension; ++i)
         {
-          mapIt = localStatistics.emplace(label, LabelStatistics()).first;
+          accumulator->m_BoundingBox[2 * i] = std::min(accumulator->m_BoundingBox[2 * i], lineIndex[i]);
+          accumulator->m_BoundingBox[2 * i + 1] = std::max(accumulator->m_BoundingBox[2 * i + 1], lineIndex[i]);
         }
       }
 
-      typename MapType::mapped_type & labelStats = mapIt->second;
-
       // update the values for this label and this thread
-      if (value < labelStats.m_Minimum)
+      if (value < accumulator->m_Minimum)
       {
-        labelStats.m_Minimum = value;
+        accumulator->m_Minimum = value;
       }
-      if (value > labelStats.m_Maximum)
+      if (value > accumulator->m_Maximum)
       {
-        labelStats.m_Maximum = value;
+        accumulator->m_Maximum = value;
       }
+      accumulator->m_BoundingBox[0] = std::min(accumulator->m_BoundingBox[0], x);
+      accumulator->m_BoundingBox[1] = std::max(accumulator->m_BoundingBox[1], x);
 
-      // bounding box is min,max pairs
-      for (unsigned int i = 0; i < (2 * TInputImage::ImageDimension); i += 2)
-      {
-        const IndexType & index = it.GetIndex();
-        labelStats.m_BoundingBox[i] = std::min(labelStats.m_BoundingBox[i], index[i / 2]);
-        labelStats.m_BoundingBox[i + 1] = std::max(labelStats.m_BoundingBox[i + 1], index[i / 2]);
-      }
-
-      labelStats.m_Sum += value;
-      labelStats.m_SumOfSquares += (value * value);
-      labelStats.m_Count++;
+      accumulator->m_Sum += value;
+      accumulator->m_SumOfSquares += (value * value);
+      accumulator->m_Count++;
 
       // if enabled, update the histogram for this label
-      if (m_UseHistograms)
+      SizeValueType bin;
+      if (useHistograms && this->ComputeHistogramBin(value, bin))
       {
-        histogramMeasurement[0] = value;
-        labelStats.m_Histogram->GetIndex(histogramMeasurement, histogramIndex);
-        labelStats.m_Histogram->IncreaseFrequencyOfIndex(histogramIndex, 1);
+        if (accumulator->m_Frequencies.empty())
+        {
+          accumulator->m_Frequencies.resize(m_NumBins[0]);
+        }
+        ++accumulator->m_Frequencies[bin];
       }
 
+      if (useExactQuantiles)
+      {
+        accumulator->m_Values.push_back(value);
+      }
 
+      ++x;
       ++labelIt;
       ++it;
     }
@@ -242,29 +355,7 @@ LabelStatisticsImageFilter<TInputImage, TLabelImage>::ThreadedStreamedGenerateDa
     it.NextLine();
   }
 
-
-  // Merge localStatistics and m_LabelStatistics concurrently safe in a
-  // local copy, this thread may do multiple merges.
-  while (true)
-  {
-    MapType tomerge{};
-    {
-      const std::lock_guard<std::mutex> lockGuard(m_Mutex);
-
-      if (m_LabelStatistics.empty())
-      {
-        swap(m_LabelStatistics, localStatistics);
-        break;
-      }
-
-      // Move the data of the output map to the local `tomerge` and clear the output map.
-      swap(m_LabelStatistics, tomerge);
-
-    } // release lock, allow other threads to merge data
-
-    // Merge tomerge into localStatistics, locally
-    MergeMap(localStatistics, tomerge);
-  }
+  this->ReleaseThreadAccumulators(std::move(accumulators));
 }
 
 template <typename TInputImage, typename TLabelImage>
@@ -413,6 +504,10 @@ LabelStatisticsImageFilter<TInputImage, TLabelImage>::GetMedian(LabelPixelType l
 {
   RealType   median = 0.0;
   const auto mapIt = m_LabelStatistics.find(label);
+  if (mapIt != m_LabelStatistics.end() && m_UseExactQuantiles)
+  {
+    return mapIt->second.m_Median;
+  }
   if (mapIt == m_LabelStatistics.end() || !m_UseHistograms)
   {
     // label does not exist OR histograms not enabled, return the default value
@@ -442,6 +537,21 @@ LabelStatisticsImageFilter<TInputImage, TLabelImage>::GetMedian(LabelPixelType l
   return median;
 }
 
+template <typename TInputImage, typename TLabelImage>
+auto
+LabelStatisticsImageFilter<TInputImage, TLabelImage>::GetQuantile(LabelPixelType label, double p) const -> RealType
+{
+  const auto mapIt = m_LabelStatistics.find(label);
+  if (mapIt == m_LabelStatistics.end() || !m_UseExactQuantiles)
+  {
+    // label does not exist OR exact quantiles not enabled, return the default value
+    return RealType{};
+  }
+
+  std::vector<RealType> values = mapIt->second.m_Values;
+  return SelectQuantile(values, p);
+}
+
 template <typename TInputImage, typename TLabelImage>
 auto
 LabelStatisticsImageFilter<TInputImage, TLabelImage>::GetHistogram(LabelPixelType label) const -> HistogramPointer
@@ -473,6 +583,7 @@ LabelStatisticsImageFilter<TImage, TLabelImage>::PrintSelf(std::ostream & os, In
 
   os << indent << "ValidLabelValues: " << m_ValidLabelValues << std::endl;
   itkPrintSelfBooleanMacro(UseHistograms);
+  itkPrintSelfBooleanMacro(UseExactQuantiles);
   os << indent << "NumBins: " << m_NumBins << std::endl;
   os << indent << "LowerBound: " << static_cast<typename NumericTraits<RealType>::PrintType>(m_LowerBound) << std::endl;
   os << indent << "UpperBound: " << static_cast<typename NumericTraits<RealType>::PrintType>(m_UpperBound) << std::endl;
@@ -0,0 +1,212 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkGTest.h"
+
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkLabelStatisticsImageFilter.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+namespace
+{
+
+// Statistics of a label computed directly from its pixels.
+struct ExpectedStatistics
+{
+  std::vector<double>              m_Values{};
+  double                           m_Sum{ 0.0 };
+  std::vector<itk::IndexValueType> m_BoundingBox{};
+};
+
+template <typename TLabelPixel>
+void
+CheckLabelStatistics(const std::vector<TLabelPixel> & labelValues)
+{
+  constexpr unsigned int Dimension = 3;
+  using ImageType = itk::Image<short, Dimension>;
+  using LabelImageType = itk::Image<TLabelPixel, Dimension>;
+  using FilterType = itk::LabelStatisticsImageFilter<ImageType, LabelImageType>;
+
+  auto randomGenerator = itk::Statistics::MersenneTwisterRandomVariateGenerator::New();
+  randomGenerator->Initialize(20250601);
+
+  const typename ImageType::RegionType region({ 3, -2, 0 }, { 37, 29, 11 });
+  auto                                 image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  auto labelImage = LabelImageType::New();
+  labelImage->SetRegions(region);
+  labelImage->Allocate();
+
+  // Runs of pixels with the same label, and random intensities with ties,
+  // partly outside of the histogram bins.
+  std::map<TLabelPixel, ExpectedStatistics> expectedStatistics;
+  itk::ImageRegionIterator<ImageType>       it(image, region);
+  itk::ImageRegionIterator<LabelImageType>  labelIt(labelImage, region);
+  TLabelPixel                               label = labelValues[0];
+  for (; !it.IsAtEnd(); ++it, ++labelIt)
+  {
+    if (randomGenerator->GetIntegerVariate(3) == 0)
+    {
+      label = labelValues[randomGenerator->GetIntegerVariate(labelValues.size() - 1)];
+    }
+    const auto value = static_cast<short>(static_cast<int>(randomGenerator->GetIntegerVariate(220)) - 105);
+    it.Set(value);
+    labelIt.Set(label);
+
+    ExpectedStatistics & expected = expectedStatistics[label];
+    expected.m_Values.push_back(value);
+    expected.m_Sum += value;
+    if (expected.m_BoundingBox.empty())
+    {
+      for (unsigned int i = 0; i < Dimension; ++i)
+      {
+        expected.m_BoundingBox.push_back(it.GetIndex()[i]);
+        expected.m_BoundingBox.push_back(it.GetIndex()[i]);
+      }
+    }
+    for (unsigned int i = 0; i < Dimension; ++i)
+    {
+      expected.m_BoundingBox[2 * i] = std::min(expected.m_BoundingBox[2 * i], it.GetIndex()[i]);
+      expected.m_BoundingBox[2 * i + 1] = std::max(expected.m_BoundingBox[2 * i + 1], it.GetIndex()[i]);
+    }
+  }
+  for (auto & labelStatistics : expectedStatistics)
+  {
+    std::sort(labelStatistics.second.m_Values.begin(), labelStatistics.second.m_Values.end());
+  }
+
+  const auto quantile = [](const std::vector<double> & sortedValues, double p) {
+    const double position = p * static_cast<double>(sortedValues.size() - 1);
+    const auto   lower = static_cast<size_t>(position);
+    if (lower + 1 == sortedValues.size())
+    {
+      return sortedValues[lower];
+    }
+    return sortedValues[lower] +
+           (position - static_cast<double>(lower)) * (sortedValues[lower + 1] - sortedValues[lower]);
+  };
+
+  for (const unsigned int numberOfWorkUnits : { 1, 7 })
+  {
+    for (const unsigned int numberOfStreamDivisions : { 1, 3 })
+    {
+      auto filter = FilterType::New();
+      filter->SetInput(image);
+      filter->SetLabelInput(labelImage);
+      filter->SetNumberOfWorkUnits(numberOfWorkUnits);
+      filter->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+      filter->SetHistogramParameters(40, -100.0, 100.0);
+      filter->UseExactQuantilesOn();
+      filter->Update();
+
+      ASSERT_EQ(filter->GetNumberOfLabels(), expectedStatistics.size());
+      ASSERT_EQ(filter->GetValidLabelValues().size(), expectedStatistics.size());
+      for (const auto & labelStatistics : expectedStatistics)
+      {
+        const TLabelPixel          label = labelStatistics.first;
+        const ExpectedStatistics & expected = labelStatistics.second;
+        const auto                 count = static_cast<double>(expected.m_Values.size());
+        const double               mean = expected.m_Sum / count;
+        double                     variance = 0.0;
+        for (const double value : expected.m_Values)
+        {
+          variance += (value - mean) * (value - mean);
+        }
+        variance = count > 1 ? variance / (count - 1.0) : 0.0;
+
+        ASSERT_TRUE(filter->HasLabel(label));
+        EXPECT_EQ(filter->GetCount(label), expected.m_Values.size());
+        EXPECT_EQ(filter->GetMinimum(label), expected.m_Values.front());
+        EXPECT_EQ(filter->GetMaximum(label), expected.m_Values.back());
+        EXPECT_EQ(filter->GetSum(label), expected.m_Sum);
+        EXPECT_NEAR(filter->GetMean(label), mean, 1e-9);
+        EXPECT_NEAR(filter->GetVariance(label), variance, 1e-7 * (1.0 + variance));
+        EXPECT_EQ(filter->GetBoundingBox(label), expected.m_BoundingBox);
+
+        EXPECT_EQ(filter->GetMedian(label), quantile(expected.m_Values, 0.5));
+        for (const double p : { 0.0, 0.1, 0.25, 0.9, 1.0 })
+        {
+          EXPECT_DOUBLE_EQ(filter->GetQuantile(label, p), quantile(expected.m_Values, p));
+        }
+
+        // The histogram has the frequencies of the bins of the intensities.
+        const typename FilterType::HistogramPointer histogram = filter->GetHistogram(label);
+        ASSERT_NE(histogram, nullptr);
+        std::vector<typename FilterType::HistogramType::AbsoluteFrequencyType> frequencies(histogram->Size(), 0);
+        typename FilterType::HistogramType::MeasurementVectorType              measurement(1);
+        typename FilterType::HistogramType::IndexType                          index(1);
+        for (const double value : expected.m_Values)
+        {
+          measurement[0] = value;
+          if (histogram->GetIndex(measurement, index))
+          {
+            ++frequencies[index[0]];
+          }
+        }
+        for (unsigned int bin = 0; bin < histogram->Size(); ++bin)
+        {
+          EXPECT_EQ(histogram->GetFrequency(bin), frequencies[bin]);
+        }
+      }
+
+      // Without exact quantiles, the median is the center of a histogram bin.
+      filter->UseExactQuantilesOff();
+      filter->Update();
+      for (const auto & labelStatistics : expectedStatistics)
+      {
+        const double bin = (filter->GetMedian(labelStatistics.first) + 100.0) / 5.0 - 0.5;
+        EXPECT_EQ(bin, std::round(bin));
+        EXPECT_EQ(filter->GetQuantile(labelStatistics.first, 0.5), 0.0);
+      }
+    }
+  }
+}
+
+} // namespace
+
+// Labels in the table of the work units.
+TEST(LabelStatisticsImageFilter, DenseLabels)
+{
+  CheckLabelStatistics<unsigned char>({ 0, 1, 2, 3, 7, 255 });
+}
+
+// Labels in the table and in the hash map of the work units.
+TEST(LabelStatisticsImageFilter, DenseAndSparseLabels)
+{
+  std::vector<unsigned int> labels;
+  for (unsigned int label = 0; label < 300; label += 3)
+  {
+    labels.push_back(label);
+  }
+  labels.push_back(65535);
+  labels.push_back(65536);
+  labels.push_back(1000000);
+  CheckLabelStatistics<unsigned int>(labels);
+}
+
+// Negative labels are in the hash map of the work units.
+TEST(LabelStatisticsImageFilter, NegativeLabels)
+{
+  CheckLabelStatistics<short>({ -32768, -5, -1, 0, 4, 1000 });
+}
@@ -20,6 +20,8 @@
 
 #include "itkInPlaceLabelMapFilter.h"
 #include "itkLexicographicCompare.h"
+#include <atomic>
+#include <vector>
 
 namespace itk
 {
@@ -30,12 +32,20 @@ namespace itk
  * ShapeLabelMapFilter can be used to set the attributes values of the
  * ShapeLabelObject in a LabelMap.
  *
- * ShapeLabelMapFilter takes an optional parameter, used only to
- * optimize the computation time and the memory usage when the
- * perimeter or the feret diameter is used: the exact copy of the
- * input LabelMap is stored in an Image.
- * It can be set with SetLabelImage(). It is cleared at the end of the
- * computation, so must be reset before running Update() again. It is
+ * The label objects are processed from the largest to the smallest, so
+ * that the work units finish at about the same time. A label object
+ * with more pixels than the share of a work unit is processed before
+ * the others, by all the work units together.
+ *
+ * The Feret diameter is searched among the vertices of the convex
+ * hull of the object, which are found from the first and last pixels
+ * of its rows. In 2D, the antipodal vertices are enumerated with
+ * rotating calipers.
+ *
+ * ShapeLabelMapFilter takes an optional parameter, the exact copy of
+ * the input LabelMap stored in an Image, which can be set with
+ * SetLabelImage(). It is no longer required to compute the Feret
+ * diameter. It is cleared at the end of the computation. It is
  * not part of the pipeline management design, to let the subclasses
  * of ShapeLabelMapFilter use the pipeline design to specify truly
  * required inputs.
@@ -73,6 +83,7 @@ public:
   using LabelObjectType = typename ImageType::LabelObjectType;
   using MatrixType = typename LabelObjectType::MatrixType;
   using VectorType = typename LabelObjectType::VectorType;
+  using OutputImageRegionType = typename Superclass::OutputImageRegionType;
 
   using LabelImageType = TLabelImage;
   using LabelImagePointer = typename LabelImageType::Pointer;
@@ -135,6 +146,16 @@ protected:
   ShapeLabelMapFilter();
   ~ShapeLabelMapFilter() override = default;
 
+  /** Process the large label objects one after the other, each with all
+   * the work units, and then the other label objects in parallel. */
+  void
+  GenerateData() override;
+
+  /** Process the label objects that are not large, from the largest to the
+   * smallest. */
+  void
+  DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
+
   void
   ThreadedProcessLabelObject(LabelObjectType * labelObject) override;
 
@@ -148,13 +169,61 @@ protected:
   PrintSelf(std::ostream & os, Indent indent) const override;
 
 private:
+  /** Number of lines accumulated together. The sums over the ranges of
+   * lines are added in order, so that the attributes do not depend on the
+   * number of work units. */
+  static constexpr SizeValueType LinesPerRange = 4096;
+
+  /** Minimum number of pixels of a label object processed by all the work
+   * units together. */
+  static constexpr SizeValueType MinimumLargeLabelObjectSize = 16384;
+
+  /** Sums over a range of lines of a label object. */
+  struct LineAccumulator
+  {
+    SizeValueType                           m_NumberOfPixels{ 0 };
+    ContinuousIndex<double, ImageDimension> m_Centroid{};
+    IndexType                               m_Minimum{ IndexType::Filled(NumericTraits<IndexValueType>::max()) };
+    IndexType                               m_Maximum{ IndexType::Filled(NumericTraits<IndexValueType>::min()) };
+    SizeValueType                           m_NumberOfPixelsOnBorder{ 0 };
+    double                                  m_PerimeterOnBorder{ 0.0 };
+    MatrixType                              m_CentralMoments{};
+  };
+
   bool                   m_ComputeFeretDiameter{};
   bool                   m_ComputePerimeter{};
   bool                   m_ComputeOrientedBoundingBox{};
   LabelImageConstPointer m_LabelImage{};
 
+  /** The label objects sorted by decreasing size. The first
+   * m_NumberOfLargeLabelObjects ones are processed by all the work units
+   * together, and the others are taken by the work units from
+   * m_NextLabelObject on. */
+  std::vector<LabelObjectType *> m_LabelObjects{};
+  SizeValueType                  m_NumberOfLargeLabelObjects{ 0 };
+  std::atomic<SizeValueType>     m_NextLabelObject{ 0 };
+  bool                           m_ParallelizeLabelObject{ false };
+
+  void
+  AccumulateLines(const LabelObjectType * labelObject,
+                  SizeValueType           firstLine,
+                  SizeValueType           endLine,
+                  LineAccumulator &       accumulator) const;
+
   void
   ComputeFeretDiameter(LabelObjectType * labelObject);
+
+  /** Vertices of the convex hull, in the plane of the axes 0 and k, of the
+   * points points[order[begin]], ..., points[order[end - 1]], sorted along
+   * the axis k and then along the axis 0. The vertices are listed along the
+   * boundary of the hull, without the points in the middle of its edges. */
+  static void
+  ComputePlaneConvexHull(const std::vector<IndexType> &     points,
+                         const std::vector<SizeValueType> & order,
+                         SizeValueType                      begin,
+                         SizeValueType                      end,
+                         unsigned int                       k,
+                         std::vector<SizeValueType> &       hull);
   void
   ComputePerimeter(LabelObjectType * labelObject);
   void
@@ -29,8 +29,12 @@
 #include "vnl/algo/vnl_symmetric_eigensystem.h"
 #include "itkMath.h"
 #include "itkLexicographicCompare.h"
+#include "itkTotalProgressReporter.h"
+#include <algorithm>
 #include <deque>
 #include <map>
+#include <mutex>
+#include <numeric>
 
 namespace itk
 {
@@ -48,21 +52,83 @@ ShapeLabelMapFilter<TImage, TLabelImage>::BeforeThreadedGenerateData()
 {
   Superclass::BeforeThreadedGenerateData();
 
-  // Generate the label image, if needed
-  if (m_ComputeFeretDiameter)
+  // Sort the label objects by decreasing size, so that the work units end
+  // with the small ones
+  std::vector<std::pair<SizeValueType, LabelObjectType *>> sizes;
+  SizeValueType                                            totalSize = 0;
+  for (typename ImageType::Iterator it(this->GetLabelMap()); !it.IsAtEnd(); ++it)
+  {
+    LabelObjectType * labelObject = it.GetLabelObject();
+    sizes.emplace_back(labelObject->Size(), labelObject);
+    totalSize += sizes.back().first;
+  }
+  std::stable_sort(sizes.begin(), sizes.end(), [](const auto & a, const auto & b) { return a.first > b.first; });
+
+  // A label object larger than the share of a work unit would keep one work
+  // unit busy after the others are done
+  const ThreadIdType numberOfWorkUnits = this->GetNumberOfWorkUnits();
+  m_LabelObjects.clear();
+  m_NumberOfLargeLabelObjects = 0;
+  for (const auto & size : sizes)
   {
-    if (!m_LabelImage)
+    m_LabelObjects.push_back(size.second);
+    if (numberOfWorkUnits > 1 && size.first >= MinimumLargeLabelObjectSize &&
+        size.first * numberOfWorkUnits > totalSize)
     {
-      // generate an image of the labelized image
-      using LCI2IType = LabelMapToLabelImageFilter<TImage, LabelImageType>;
-      auto lci2i = LCI2IType::New();
-      lci2i->SetInput(this->GetOutput());
-      // Respect the number of threads of the filter
-      lci2i->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
-      lci2i->Update();
-      m_LabelImage = lci2i->GetOutput();
+      ++m_NumberOfLargeLabelObjects;
     }
   }
+  m_ParallelizeLabelObject = false;
+}
+
+template <typename TImage, typename TLabelImage>
+void
+ShapeLabelMapFilter<TImage, TLabelImage>::GenerateData()
+{
+  this->AllocateOutputs();
+
+  this->BeforeThreadedGenerateData();
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  this->GetMultiThreader()->SetUpdateProgress(this->GetThreaderUpdateProgress());
+
+  const auto numberOfLabelObjects = static_cast<SizeValueType>(m_LabelObjects.size());
+  {
+    TotalProgressReporter progress(this, numberOfLabelObjects, numberOfLabelObjects);
+    m_ParallelizeLabelObject = true;
+    for (SizeValueType i = 0; i < m_NumberOfLargeLabelObjects; ++i)
+    {
+      this->ThreadedProcessLabelObject(m_LabelObjects[i]);
+      progress.CompletedPixel();
+    }
+    m_ParallelizeLabelObject = false;
+  }
+
+  m_NextLabelObject = m_NumberOfLargeLabelObjects;
+  if (m_NumberOfLargeLabelObjects < numberOfLabelObjects)
+  {
+    this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+      this->GetOutput()->GetRequestedRegion(),
+      [this](const OutputImageRegionType & outputRegionForThread) {
+        this->DynamicThreadedGenerateData(outputRegionForThread);
+      },
+      this);
+  }
+
+  this->AfterThreadedGenerateData();
+}
+
+template <typename TImage, typename TLabelImage>
+void
+ShapeLabelMapFilter<TImage, TLabelImage>::DynamicThreadedGenerateData(const OutputImageRegionType &)
+{
+  const auto            numberOfLabelObjects = static_cast<SizeValueType>(m_LabelObjects.size());
+  TotalProgressReporter progress(this, numberOfLabelObjects, numberOfLabelObjects);
+  for (SizeValueType i = m_NextLabelObject++; i < numberOfLabelObjects; i = m_NextLabelObject++)
+  {
+    this->ThreadedProcessLabelObject(m_LabelObjects[i]);
+    progress.CompletedPixel();
+  }
 }
 
 template <typename TImage, typename TLabelImage>
@@ -79,6 +145,201 @@ ShapeLabelMapFilter<TImage, TLabelImage>::ThreadedProcessLabelObject(LabelObject
     sizePerPixel *= output->GetSpacing()[i];
   }
 
+  // Accumulate the lines by ranges, in parallel for a large object, and add
+  // the sums of the ranges in order
+  const SizeValueType          numberOfLines = labelObject->GetNumberOfLines();
+  const SizeValueType          numberOfRanges = numberOfLines > 0 ? (numberOfLines - 1) / LinesPerRange + 1 : 1;
+  std::vector<LineAccumulator> accumulators(numberOfRanges);
+  const auto accumulateRange = [this, labelObject, numberOfLines, &accumulators](SizeValueType range) {
+    const SizeValueType firstLine = range * LinesPerRange;
+    this->AccumulateLines(
+      labelObject, firstLine, std::min(numberOfLines, firstLine + LinesPerRange), accumulators[range]);
+  };
+  if (m_ParallelizeLabelObject && numberOfRanges > 1)
+  {
+    this->GetMultiThreader()->ParallelizeArray(0, numberOfRanges, accumulateRange, nullptr);
+  }
+  else
+  {
+    for (SizeValueType range = 0; range < numberOfRanges; ++range)
+    {
+      accumulateRange(range);
+    }
+  }
+
+  LineAccumulator & sums = accumulators[0];
+  for (SizeValueType range = 1; range < numberOfRanges; ++range)
+  {
+    const LineAccumulator & rangeSums = accumulators[range];
+    sums.m_NumberOfPixels += rangeSums.m_NumberOfPixels;
+    sums.m_NumberOfPixelsOnBorder += rangeSums.m_NumberOfPixelsOnBorder;
+    sums.m_PerimeterOnBorder += rangeSums.m_PerimeterOnBorder;
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      sums.m_Centroid[i] += rangeSums.m_Centroid[i];
+      sums.m_Minimum[i] = std::min(sums.m_Minimum[i], rangeSums.m_Minimum[i]);
+      sums.m_Maximum[i] = std::max(sums.m_Maximum[i], rangeSums.m_Maximum[i]);
+    }
+    sums.m_CentralMoments += rangeSums.m_CentralMoments;
+  }
+
+  const SizeValueType                       nbOfPixels = sums.m_NumberOfPixels;
+  ContinuousIndex<double, ImageDimension> & centroid = sums.m_Centroid;
+  const IndexType &                         mins = sums.m_Minimum;
+  const IndexType &                         maxs = sums.m_Maximum;
+  const SizeValueType                       nbOfPixelsOnBorder = sums.m_NumberOfPixelsOnBorder;
+  const double                              perimeterOnBorder = sums.m_PerimeterOnBorder;
+  MatrixType &                              centralMoments = sums.m_CentralMoments;
+
+
+  // final computation
+  typename LabelObjectType::RegionType::SizeType boundingBoxSize;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    centroid[i] /= nbOfPixels;
+    boundingBoxSize[i] = maxs[i] - mins[i] + 1;
+    for (unsigned int j = 0; j < ImageDimension; ++j)
+    {
+      centralMoments[i][j] /= nbOfPixels;
+    }
+  }
+  const typename LabelObjectType::RegionType boundingBox(mins, boundingBoxSize);
+  typename LabelObjectType::CentroidType     physicalCentroid;
+  output->TransformContinuousIndexToPhysicalPoint(centroid, physicalCentroid);
+
+  // Center the second order moments
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    for (unsigned int j = 0; j < ImageDimension; ++j)
+    {
+      centralMoments[i][j] -= physicalCentroid[i] * physicalCentroid[j];
+    }
+  }
+
+  // Compute principal moments and axes
+  VectorType                              principalMoments;
+  const vnl_symmetric_eigensystem<double> eigen{ centralMoments.GetVnlMatrix().as_matrix() };
+  vnl_diag_matrix<double>                 pm = eigen.D;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    principalMoments[i] = pm(i);
+  }
+  MatrixType principalAxes(eigen.V.transpose());
+
+  // Add a final reflection if needed for a proper rotation,
+  // by multiplying the last row by the determinant
+  const vnl_real_eigensystem            eigenrot{ principalAxes.GetVnlMatrix().as_matrix() };
+  vnl_diag_matrix<std::complex<double>> eigenval{ eigenrot.D };
+  std::complex<double>                  det(1.0, 0.0);
+
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    det *= eigenval(i);
+  }
+
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    principalAxes[ImageDimension - 1][i] *= std::real(det);
+  }
+
+  double elongation = 0;
+  double flatness = 0;
+  if constexpr (ImageDimension < 2)
+  {
+    elongation = 1;
+    flatness = 1;
+  }
+  else
+  {
+    if (Math::NotAlmostEquals(principalMoments[0], typename VectorType::ValueType{}))
+    {
+      const double flatnessRatio = principalMoments[1] / principalMoments[0];
+      flatness = 0.0;
+      if (flatnessRatio > 0.0)
+      {
+        flatness = std::sqrt(flatnessRatio);
+      }
+    }
+    if (Math::NotAlmostEquals(principalMoments[ImageDimension - 2], typename VectorType::ValueType{}))
+    {
+      const double elongationRatio = principalMoments[ImageDimension - 1] / principalMoments[ImageDimension - 2];
+      elongation = 0.0;
+      if (elongationRatio > 0.0)
+      {
+        elongation = std::sqrt(elongationRatio);
+      }
+    }
+  }
+
+  const double physicalSize = nbOfPixels * sizePerPixel;
+  const double equivalentRadius = GeometryUtilities::HyperSphereRadiusFromVolume(ImageDimension, physicalSize);
+  const double equivalentPerimeter = GeometryUtilities::HyperSpherePerimeter(ImageDimension, equivalentRadius);
+
+  // Compute equivalent ellipsoid radius
+  VectorType ellipsoidDiameter;
+  double     edet = 1.0;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    edet *= principalMoments[i];
+  }
+  edet = std::pow(edet, 1.0 / ImageDimension);
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    ellipsoidDiameter[i] = 0.0;
+    if (edet != 0.0 && principalMoments[i] / edet > 0.0)
+    {
+      ellipsoidDiameter[i] = 2.0 * equivalentRadius * std::sqrt(principalMoments[i] / edet);
+    }
+  }
+
+  // Set the values in the object
+  labelObject->SetNumberOfPixels(nbOfPixels);
+  labelObject->SetPhysicalSize(physicalSize);
+  labelObject->SetBoundingBox(boundingBox);
+  labelObject->SetCentroid(physicalCentroid);
+  labelObject->SetNumberOfPixelsOnBorder(nbOfPixelsOnBorder);
+  labelObject->SetPerimeterOnBorder(perimeterOnBorder);
+  labelObject->SetPrincipalMoments(principalMoments);
+  labelObject->SetPrincipalAxes(principalAxes);
+  labelObject->SetElongation(elongation);
+  labelObject->SetEquivalentSphericalRadius(equivalentRadius);
+  labelObject->SetEquivalentSphericalPerimeter(equivalentPerimeter);
+  labelObject->SetEquivalentEllipsoidDiameter(ellipsoidDiameter);
+  labelObject->SetFlatness(flatness);
+
+  if (m_ComputeFeretDiameter)
+  {
+    this->ComputeFeretDiameter(labelObject);
+  }
+
+  if (m_ComputePerimeter)
+  {
+    this->ComputePerimeter(labelObject);
+  }
+
+  if (m_ComputeOrientedBoundingBox)
+  {
+    this->ComputeOrientedBoundingBox(labelObject);
+  }
+}
+
+template <typename TImage, typename TLabelImage>
+void
+ShapeLabelMapFilter<TImage, TLabelImage>::AccumulateLines(const LabelObjectType * labelObject,
+                                                          SizeValueType           firstLine,
+                                                          SizeValueType           endLine,
+                                                          LineAccumulator &       accumulator) const
+{
+  const ImageType * output = this->GetOutput();
+
+  // Compute the size per pixel, to be used later
+  double sizePerPixel = 1;
+
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    sizePerPixel *= output->GetSpacing()[i];
+  }
+
   typename std::vector<double> sizePerPixelPerDimension;
   for (unsigned int i = 0; i < ImageDimension; ++i)
   {
@@ -93,23 +354,21 @@ ShapeLabelMapFilter<TImage, TLabelImage>::ThreadedProcessLabelObject(LabelObject
     borderMax[i] += output->GetLargestPossibleRegion().GetSize()[i] - 1;
   }
 
-  // Init the vars
-  SizeValueType                           nbOfPixels = 0;
-  ContinuousIndex<double, ImageDimension> centroid{};
-  auto                                    mins = IndexType::Filled(NumericTraits<IndexValueType>::max());
-  auto                                    maxs = IndexType::Filled(NumericTraits<IndexValueType>::NonpositiveMin());
-  SizeValueType                           nbOfPixelsOnBorder = 0;
-  double                                  perimeterOnBorder = 0;
-  MatrixType                              centralMoments{};
+  SizeValueType &                           nbOfPixels = accumulator.m_NumberOfPixels;
+  ContinuousIndex<double, ImageDimension> & centroid = accumulator.m_Centroid;
+  IndexType &                               mins = accumulator.m_Minimum;
+  IndexType &                               maxs = accumulator.m_Maximum;
+  SizeValueType &                           nbOfPixelsOnBorder = accumulator.m_NumberOfPixelsOnBorder;
+  double &                                  perimeterOnBorder = accumulator.m_PerimeterOnBorder;
+  MatrixType &                              centralMoments = accumulator.m_CentralMoments;
 
   using LengthType = typename LabelObjectType::LengthType;
 
-  // Iterate over all the lines
-  typename LabelObjectType::ConstLineIterator lit(labelObject);
-  while (!lit.IsAtEnd())
+  // Iterate over the lines of the range
+  for (SizeValueType l = firstLine; l < endLine; ++l)
   {
-    const IndexType & idx = lit.GetLine().GetIndex();
-    const LengthType  length = lit.GetLine().GetLength();
+    const IndexType & idx = labelObject->GetLine(l).GetIndex();
+    const LengthType  length = labelObject->GetLine(l).GetLength();
 
     // Update the nbOfPixels
     nbOfPixels += length;
@@ -284,210 +543,247 @@ ShapeLabelMapFilter<TImage, TLabelImage>::ThreadedProcessLabelObject(LabelObject
         }
       }
     }
-
-    ++lit;
   }
+}
 
-
-  // final computation
-  typename LabelObjectType::RegionType::SizeType boundingBoxSize;
-  for (unsigned int i = 0; i < ImageDimension; ++i)
-  {
-    centroid[i] /= nbOfPixels;
-    boundingBoxSize[i] = maxs[i] - mins[i] + 1;
-    for (unsigned int j = 0; j < ImageDimension; ++j)
+template <typename TImage, typename TLabelImage>
+void
+ShapeLabelMapFilter<TImage, TLabelImage>::ComputeFeretDiameter(LabelObjectType * labelObject)
+{
+  // The Feret diameter is the distance between two vertices of the convex
+  // hull of the object. A vertex of the convex hull is an extreme point of
+  // every subset of the object that contains it: it is the first or the last
+  // pixel of its row, and a vertex of the convex hull of these points in each
+  // plane parallel to the axis 0 and to another axis.
+
+  // Sort the lines by row, the axis 0 last
+  const auto comparePoints = [](const IndexType & a, const IndexType & b, unsigned int k) {
+    for (unsigned int i = ImageDimension - 1; i > 0; --i)
     {
-      centralMoments[i][j] /= nbOfPixels;
+      if (i != k && a[i] != b[i])
+      {
+        return a[i] < b[i];
+      }
     }
-  }
-  const typename LabelObjectType::RegionType boundingBox(mins, boundingBoxSize);
-  typename LabelObjectType::CentroidType     physicalCentroid;
-  output->TransformContinuousIndexToPhysicalPoint(centroid, physicalCentroid);
-
-  // Center the second order moments
-  for (unsigned int i = 0; i < ImageDimension; ++i)
-  {
-    for (unsigned int j = 0; j < ImageDimension; ++j)
+    if (a[k] != b[k])
     {
-      centralMoments[i][j] -= physicalCentroid[i] * physicalCentroid[j];
+      return a[k] < b[k];
     }
-  }
-
-  // Compute principal moments and axes
-  VectorType                              principalMoments;
-  const vnl_symmetric_eigensystem<double> eigen{ centralMoments.GetVnlMatrix().as_matrix() };
-  vnl_diag_matrix<double>                 pm = eigen.D;
-  for (unsigned int i = 0; i < ImageDimension; ++i)
-  {
-    principalMoments[i] = pm(i);
-  }
-  MatrixType principalAxes(eigen.V.transpose());
-
-  // Add a final reflection if needed for a proper rotation,
-  // by multiplying the last row by the determinant
-  const vnl_real_eigensystem            eigenrot{ principalAxes.GetVnlMatrix().as_matrix() };
-  vnl_diag_matrix<std::complex<double>> eigenval{ eigenrot.D };
-  std::complex<double>                  det(1.0, 0.0);
+    return a[0] < b[0];
+  };
+  const auto samePlane = [](const IndexType & a, const IndexType & b, unsigned int k) {
+    for (unsigned int i = 1; i < ImageDimension; ++i)
+    {
+      if (i != k && a[i] != b[i])
+      {
+        return false;
+      }
+    }
+    return true;
+  };
 
-  for (unsigned int i = 0; i < ImageDimension; ++i)
+  const SizeValueType                               numberOfLines = labelObject->GetNumberOfLines();
+  std::vector<std::pair<IndexType, IndexValueType>> lines(numberOfLines);
+  for (SizeValueType l = 0; l < numberOfLines; ++l)
   {
-    det *= eigenval(i);
+    const typename LabelObjectType::LineType & line = labelObject->GetLine(l);
+    lines[l] = { line.GetIndex(), line.GetIndex()[0] + static_cast<IndexValueType>(line.GetLength()) - 1 };
   }
+  std::sort(lines.begin(), lines.end(), [&comparePoints](const auto & a, const auto & b) {
+    return comparePoints(a.first, b.first, 1);
+  });
 
-  for (unsigned int i = 0; i < ImageDimension; ++i)
+  // The first and last pixels of the rows, sorted along the axis 1
+  std::vector<IndexType> points;
+  for (SizeValueType l = 0; l < numberOfLines;)
   {
-    principalAxes[ImageDimension - 1][i] *= std::real(det);
+    IndexType      first = lines[l].first;
+    IndexValueType last = lines[l].second;
+    for (++l; l < numberOfLines && samePlane(first, lines[l].first, 0); ++l)
+    {
+      last = std::max(last, lines[l].second);
+    }
+    points.push_back(first);
+    if (last != first[0])
+    {
+      first[0] = last;
+      points.push_back(first);
+    }
   }
 
-  double elongation = 0;
-  double flatness = 0;
-  if constexpr (ImageDimension < 2)
+  const auto                              numberOfPoints = static_cast<SizeValueType>(points.size());
+  const typename ImageType::SpacingType & spacing = this->GetOutput()->GetSpacing();
+  const auto                              squaredDistance = [&points, &spacing](SizeValueType i, SizeValueType j) {
+    double length = 0;
+    for (unsigned int d = 0; d < ImageDimension; ++d)
+    {
+      const OffsetValueType indexDifference = points[i][d] - points[j][d];
+      length += std::pow(indexDifference * spacing[d], 2);
+    }
+    return length;
+  };
+
+  double                     feretDiameter = 0;
+  std::vector<SizeValueType> order(numberOfPoints);
+  std::iota(order.begin(), order.end(), SizeValueType{ 0 });
+  std::vector<SizeValueType> hull;
+  if constexpr (ImageDimension == 2)
   {
-    elongation = 1;
-    flatness = 1;
+    // Rotating calipers: the farthest vertex from each edge of the hull is
+    // antipodal to both ends of the edge
+    ComputePlaneConvexHull(points, order, 0, numberOfPoints, 1, hull);
+    const auto numberOfVertices = static_cast<SizeValueType>(hull.size());
+    const auto area = [&points, &hull, numberOfVertices](SizeValueType i, SizeValueType j) {
+      const IndexType & a = points[hull[i]];
+      const IndexType & b = points[hull[(i + 1) % numberOfVertices]];
+      const IndexType & c = points[hull[j]];
+      return itk::Math::abs((b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]));
+    };
+    if (numberOfVertices < 4)
+    {
+      for (SizeValueType i = 0; i < numberOfVertices; ++i)
+      {
+        for (SizeValueType j = i + 1; j < numberOfVertices; ++j)
+        {
+          feretDiameter = std::max(feretDiameter, squaredDistance(hull[i], hull[j]));
+        }
+      }
+    }
+    else
+    {
+      SizeValueType j = 1;
+      for (SizeValueType i = 0; i < numberOfVertices; ++i)
+      {
+        while (area(i, (j + 1) % numberOfVertices) > area(i, j))
+        {
+          j = (j + 1) % numberOfVertices;
+        }
+        feretDiameter = std::max(feretDiameter, squaredDistance(hull[i], hull[j]));
+        feretDiameter = std::max(feretDiameter, squaredDistance(hull[(i + 1) % numberOfVertices], hull[j]));
+      }
+    }
   }
   else
   {
-    if (Math::NotAlmostEquals(principalMoments[0], typename VectorType::ValueType{}))
+    // Keep the points that are vertices of their convex hull in all the
+    // planes
+    std::vector<unsigned int> numberOfHulls(numberOfPoints, 0);
+    for (unsigned int k = 1; k < ImageDimension; ++k)
     {
-      const double flatnessRatio = principalMoments[1] / principalMoments[0];
-      flatness = 0.0;
-      if (flatnessRatio > 0.0)
+      if (k > 1)
       {
-        flatness = std::sqrt(flatnessRatio);
+        std::sort(order.begin(), order.end(), [&points, &comparePoints, k](SizeValueType a, SizeValueType b) {
+          return comparePoints(points[a], points[b], k);
+        });
+      }
+      for (SizeValueType begin = 0; begin < numberOfPoints;)
+      {
+        SizeValueType end = begin + 1;
+        while (end < numberOfPoints && samePlane(points[order[begin]], points[order[end]], k))
+        {
+          ++end;
+        }
+        ComputePlaneConvexHull(points, order, begin, end, k, hull);
+        for (const SizeValueType vertex : hull)
+        {
+          ++numberOfHulls[vertex];
+        }
+        begin = end;
       }
     }
-    if (Math::NotAlmostEquals(principalMoments[ImageDimension - 2], typename VectorType::ValueType{}))
+    std::vector<SizeValueType> candidates;
+    for (SizeValueType i = 0; i < numberOfPoints; ++i)
     {
-      const double elongationRatio = principalMoments[ImageDimension - 1] / principalMoments[ImageDimension - 2];
-      elongation = 0.0;
-      if (elongationRatio > 0.0)
+      if (numberOfHulls[i] == ImageDimension - 1)
       {
-        elongation = std::sqrt(elongationRatio);
+        candidates.push_back(i);
       }
     }
-  }
-
-  const double physicalSize = nbOfPixels * sizePerPixel;
-  const double equivalentRadius = GeometryUtilities::HyperSphereRadiusFromVolume(ImageDimension, physicalSize);
-  const double equivalentPerimeter = GeometryUtilities::HyperSpherePerimeter(ImageDimension, equivalentRadius);
 
-  // Compute equivalent ellipsoid radius
-  VectorType ellipsoidDiameter;
-  double     edet = 1.0;
-  for (unsigned int i = 0; i < ImageDimension; ++i)
-  {
-    edet *= principalMoments[i];
-  }
-  edet = std::pow(edet, 1.0 / ImageDimension);
-  for (unsigned int i = 0; i < ImageDimension; ++i)
-  {
-    ellipsoidDiameter[i] = 0.0;
-    if (edet != 0.0 && principalMoments[i] / edet > 0.0)
+    // Search the farthest candidates. The rows of the pairs are processed two
+    // by two, from both ends, to balance the work of the work units.
+    const auto          numberOfCandidates = static_cast<SizeValueType>(candidates.size());
+    std::vector<double> maxima((numberOfCandidates + 1) / 2, 0.0);
+    const auto          searchRows = [&](SizeValueType r) {
+      for (const SizeValueType i : { r, numberOfCandidates - 1 - r })
+      {
+        for (SizeValueType j = i + 1; j < numberOfCandidates; ++j)
+        {
+          maxima[r] = std::max(maxima[r], squaredDistance(candidates[i], candidates[j]));
+        }
+        if (i == numberOfCandidates - 1 - r)
+        {
+          break;
+        }
+      }
+    };
+    if (m_ParallelizeLabelObject)
     {
-      ellipsoidDiameter[i] = 2.0 * equivalentRadius * std::sqrt(principalMoments[i] / edet);
+      this->GetMultiThreader()->ParallelizeArray(0, maxima.size(), searchRows, nullptr);
+    }
+    else
+    {
+      for (SizeValueType r = 0; r < maxima.size(); ++r)
+      {
+        searchRows(r);
+      }
+    }
+    for (const double maximum : maxima)
+    {
+      feretDiameter = std::max(feretDiameter, maximum);
     }
   }
 
-  // Set the values in the object
-  labelObject->SetNumberOfPixels(nbOfPixels);
-  labelObject->SetPhysicalSize(physicalSize);
-  labelObject->SetBoundingBox(boundingBox);
-  labelObject->SetCentroid(physicalCentroid);
-  labelObject->SetNumberOfPixelsOnBorder(nbOfPixelsOnBorder);
-  labelObject->SetPerimeterOnBorder(perimeterOnBorder);
-  labelObject->SetPrincipalMoments(principalMoments);
-  labelObject->SetPrincipalAxes(principalAxes);
-  labelObject->SetElongation(elongation);
-  labelObject->SetEquivalentSphericalRadius(equivalentRadius);
-  labelObject->SetEquivalentSphericalPerimeter(equivalentPerimeter);
-  labelObject->SetEquivalentEllipsoidDiameter(ellipsoidDiameter);
-  labelObject->SetFlatness(flatness);
-
-  if (m_ComputeFeretDiameter)
-  {
-    this->ComputeFeretDiameter(labelObject);
-  }
-
-  if (m_ComputePerimeter)
-  {
-    this->ComputePerimeter(labelObject);
-  }
+  // Final computation
+  feretDiameter = std::sqrt(feretDiameter);
 
-  if (m_ComputeOrientedBoundingBox)
-  {
-    this->ComputeOrientedBoundingBox(labelObject);
-  }
+  // Finally put the values in the label object
+  labelObject->SetFeretDiameter(feretDiameter);
 }
 
 template <typename TImage, typename TLabelImage>
 void
-ShapeLabelMapFilter<TImage, TLabelImage>::ComputeFeretDiameter(LabelObjectType * labelObject)
+ShapeLabelMapFilter<TImage, TLabelImage>::ComputePlaneConvexHull(const std::vector<IndexType> &     points,
+                                                                 const std::vector<SizeValueType> & order,
+                                                                 SizeValueType                      begin,
+                                                                 SizeValueType                      end,
+                                                                 unsigned int                       k,
+                                                                 std::vector<SizeValueType> &       hull)
 {
-  const LabelPixelType & label = labelObject->GetLabel();
-
-  using IndexListType = typename std::deque<IndexType>;
-  IndexListType idxList;
-
-  using NeighborIteratorType = typename itk::ConstNeighborhoodIterator<LabelImageType>;
-  auto                                      neighborHoodRadius = SizeType::Filled(1);
-  NeighborIteratorType                      it(neighborHoodRadius, m_LabelImage, m_LabelImage->GetBufferedRegion());
-  ConstantBoundaryCondition<LabelImageType> lcbc;
-  // Use label + 1 to have a label different of the current label on the border
-  lcbc.SetConstant(label + 1);
-  it.OverrideBoundaryCondition(&lcbc);
-  it.GoToBegin();
-
-  using NeighborIndexType = typename NeighborIteratorType::NeighborIndexType;
-
-  // Iterate over all the indexes
-  typename LabelObjectType::ConstIndexIterator iit(labelObject);
-  while (!iit.IsAtEnd())
+  hull.clear();
+  if (end - begin < 3)
   {
-    // Move the iterator to the new location
-    it += iit.GetIndex() - it.GetIndex();
+    hull.assign(order.begin() + begin, order.begin() + end);
+    return;
+  }
 
-    // Push the pixel in the list if it is on the border of the object
-    for (NeighborIndexType i = 0; i < it.Size(); ++i)
+  // Monotone chain, with the points sorted along the axis k
+  const auto turn = [&points, k](SizeValueType o, SizeValueType a, SizeValueType b) {
+    return (points[a][k] - points[o][k]) * (points[b][0] - points[o][0]) -
+           (points[a][0] - points[o][0]) * (points[b][k] - points[o][k]);
+  };
+  hull.resize(2 * (end - begin));
+  SizeValueType numberOfVertices = 0;
+  for (SizeValueType i = begin; i < end; ++i)
+  {
+    while (numberOfVertices >= 2 && turn(hull[numberOfVertices - 2], hull[numberOfVertices - 1], order[i]) <= 0)
     {
-      if (it.GetPixel(i) != label)
-      {
-        idxList.push_back(iit.GetIndex());
-        break;
-      }
+      --numberOfVertices;
     }
-    ++iit;
+    hull[numberOfVertices++] = order[i];
   }
-
-  ImageType * output = this->GetOutput();
-
-  const typename ImageType::SpacingType & spacing = output->GetSpacing();
-
-  // We can now search the feret diameter
-  double feretDiameter = 0;
-  for (auto iIt1 = idxList.begin(); iIt1 != idxList.end(); ++iIt1)
+  const SizeValueType lowerChainSize = numberOfVertices + 1;
+  for (SizeValueType i = end - 1; i-- > begin;)
   {
-    auto iIt2 = iIt1;
-    for (iIt2++; iIt2 != idxList.end(); ++iIt2)
+    while (numberOfVertices >= lowerChainSize &&
+           turn(hull[numberOfVertices - 2], hull[numberOfVertices - 1], order[i]) <= 0)
     {
-      // Compute the length between the 2 indexes
-      double length = 0;
-      for (unsigned int i = 0; i < ImageDimension; ++i)
-      {
-        const OffsetValueType indexDifference = (iIt1->operator[](i) - iIt2->operator[](i));
-        length += std::pow(indexDifference * spacing[i], 2);
-      }
-      if (feretDiameter < length)
-      {
-        feretDiameter = length;
-      }
+      --numberOfVertices;
     }
+    hull[numberOfVertices++] = order[i];
   }
-  // Final computation
-  feretDiameter = std::sqrt(feretDiameter);
-
-  // Finally put the values in the label object
-  labelObject->SetFeretDiameter(feretDiameter);
+  // The first point is also the last one
+  hull.resize(numberOfVertices - 1);
 }
 
 template <typename TImage, typename TLabelImage>
@@ -533,118 +829,142 @@ ShapeLabelMapFilter<TImage, TLabelImage>::ComputePerimeter(LabelObjectType * lab
 
   // a data structure to store the number of intercepts on each direction
   using MapInterceptType = typename std::map<OffsetType, SizeValueType, Functor::LexicographicCompare>;
-  MapInterceptType intercepts;
   // int nbOfDirections = static_cast<int>(std::pow(2.0, static_cast<int>(ImageDimension))) - 1;
   // intercepts.resize(nbOfDirections + 1);  // code begins at position 1
 
-  // now iterate over the vectors of lines
-  using LineImageIteratorType = ConstShapedNeighborhoodIterator<LineImageType>;
-  LineImageIteratorType lIt(lSize, lineImage, lRegion); // the original, non padded region
-  setConnectivity(&lIt, true);
-  for (lIt.GoToBegin(); !lIt.IsAtEnd(); ++lIt)
-  {
-    const VectorLineType & ls = lIt.GetCenterPixel();
+  // now iterate over the vectors of lines of a part of the original, non
+  // padded region
+  const auto countIntercepts = [&lineImage, &lSize](const typename LineImageType::RegionType & region,
+                                                    MapInterceptType &                         intercepts) {
+    using LineImageIteratorType = ConstShapedNeighborhoodIterator<LineImageType>;
+    LineImageIteratorType lIt(lSize, lineImage, region);
+    setConnectivity(&lIt, true);
+    for (lIt.GoToBegin(); !lIt.IsAtEnd(); ++lIt)
+    {
+      const VectorLineType & ls = lIt.GetCenterPixel();
 
-    // there are two intercepts on the 0 axis for each line
-    OffsetType no{};
-    no[0] = 1;
-    // std::cout << no << "-> " << 2 * ls.size() << std::endl;
-    intercepts[no] += 2 * static_cast<SizeValueType>(ls.size());
-
-    // and look at the neighbors
-    typename LineImageIteratorType::ConstIterator ci;
-    for (ci = lIt.Begin(); ci != lIt.End(); ++ci)
-    {
-      // std::cout << "-------------" << std::endl;
-      // the vector of lines in the neighbor
-      const VectorLineType & ns = ci.Get();
-      // prepare the offset to be stored in the intercepts map
-      typename LineImageType::OffsetType lno = ci.GetNeighborhoodOffset();
-      no[0] = 0;
-      for (unsigned int i = 0; i < ImageDimension - 1; ++i)
-      {
-        no[i + 1] = itk::Math::abs(lno[i]);
-      }
-      OffsetType dno = no; // offset for the diagonal
-      dno[0] = 1;
+      // there are two intercepts on the 0 axis for each line
+      OffsetType no{};
+      no[0] = 1;
+      // std::cout << no << "-> " << 2 * ls.size() << std::endl;
+      intercepts[no] += 2 * static_cast<SizeValueType>(ls.size());
 
-      // now process the two lines to search the pixels on the contour of the object
-      if (ls.empty())
-      {
-        // std::cout << "ls.empty()" << std::endl;
-        // nothing to do
-      }
-      if (ns.empty())
+      // and look at the neighbors
+      typename LineImageIteratorType::ConstIterator ci;
+      for (ci = lIt.Begin(); ci != lIt.End(); ++ci)
       {
-        // no line in the neighbors - all the lines in ls are on the contour
-        for (auto li = ls.begin(); li != ls.end(); ++li)
+        // std::cout << "-------------" << std::endl;
+        // the vector of lines in the neighbor
+        const VectorLineType & ns = ci.Get();
+        // prepare the offset to be stored in the intercepts map
+        typename LineImageType::OffsetType lno = ci.GetNeighborhoodOffset();
+        no[0] = 0;
+        for (unsigned int i = 0; i < ImageDimension - 1; ++i)
         {
-          // std::cout << "ns.empty()" << std::endl;
-          const typename LabelObjectType::LineType & l = *li;
-          // add as much intercepts as the line size
-          intercepts[no] += l.GetLength();
-          // and 2 times as much diagonal intercepts as the line size
-          intercepts[dno] += l.GetLength() * 2;
+          no[i + 1] = itk::Math::abs(lno[i]);
         }
-      }
-      else
-      {
-        // std::cout << "else" << std::endl;
-        // TODO - fix the code when the line starts at  NumericTraits<IndexValueType>::NonpositiveMin()
-        // or end at  NumericTraits<IndexValueType>::max()
-        auto li = ls.begin();
-        auto ni = ns.begin();
-
-        constexpr IndexValueType lZero = 0;
-        IndexValueType           lMin = 0;
-        IndexValueType           lMax = 0;
+        OffsetType dno = no; // offset for the diagonal
+        dno[0] = 1;
 
-        IndexValueType nMin = NumericTraits<IndexValueType>::NonpositiveMin() + 1;
-        IndexValueType nMax = ni->GetIndex()[0] - 1;
-
-        while (li != ls.end())
+        // now process the two lines to search the pixels on the contour of the object
+        if (ls.empty())
+        {
+          // std::cout << "ls.empty()" << std::endl;
+          // nothing to do
+        }
+        if (ns.empty())
         {
-          // update the current line min and max. Neighbor line data is already up to date.
-          lMin = li->GetIndex()[0];
-          lMax = lMin + li->GetLength() - 1;
-
-          // add as much intercepts as intersections of the 2 lines
-          intercepts[no] += std::max(lZero, std::min(lMax, nMax) - std::max(lMin, nMin) + 1);
-          // std::cout << "============" << std::endl;
-          // std::cout << "  lMin:" << lMin << " lMax:" << lMax << " nMin:" << nMin << " nMax:" << nMax;
-          // std::cout << " count: " << std::max( 0l, std::min(lMax, nMax) - std::max(lMin, nMin) + 1 ) << std::endl;
-          // std::cout << "  " << no << ": " << intercepts[no] << std::endl;
-          // std::cout << std::max( lZero, std::min(lMax, nMax+1) - std::max(lMin, nMin+1) + 1 ) << std::endl;
-          // std::cout << std::max( lZero, std::min(lMax, nMax-1) - std::max(lMin, nMin-1) + 1 ) << std::endl;
-          // left diagonal intercepts
-          intercepts[dno] += std::max(lZero, std::min(lMax, nMax + 1) - std::max(lMin, nMin + 1) + 1);
-          // right diagonal intercepts
-          intercepts[dno] += std::max(lZero, std::min(lMax, nMax - 1) - std::max(lMin, nMin - 1) + 1);
-
-          // go to the next line or the next neighbor depending on where we are
-          if (nMax <= lMax)
+          // no line in the neighbors - all the lines in ls are on the contour
+          for (auto li = ls.begin(); li != ls.end(); ++li)
           {
-            // go to next neighbor
-            nMin = ni->GetIndex()[0] + ni->GetLength();
-            ++ni;
+            // std::cout << "ns.empty()" << std::endl;
+            const typename LabelObjectType::LineType & l = *li;
+            // add as much intercepts as the line size
+            intercepts[no] += l.GetLength();
+            // and 2 times as much diagonal intercepts as the line size
+            intercepts[dno] += l.GetLength() * 2;
+          }
+        }
+        else
+        {
+          // std::cout << "else" << std::endl;
+          // TODO - fix the code when the line starts at  NumericTraits<IndexValueType>::NonpositiveMin()
+          // or end at  NumericTraits<IndexValueType>::max()
+          auto li = ls.begin();
+          auto ni = ns.begin();
 
-            if (ni != ns.end())
+          constexpr IndexValueType lZero = 0;
+          IndexValueType           lMin = 0;
+          IndexValueType           lMax = 0;
+
+          IndexValueType nMin = NumericTraits<IndexValueType>::NonpositiveMin() + 1;
+          IndexValueType nMax = ni->GetIndex()[0] - 1;
+
+          while (li != ls.end())
+          {
+            // update the current line min and max. Neighbor line data is already up to date.
+            lMin = li->GetIndex()[0];
+            lMax = lMin + li->GetLength() - 1;
+
+            // add as much intercepts as intersections of the 2 lines
+            intercepts[no] += std::max(lZero, std::min(lMax, nMax) - std::max(lMin, nMin) + 1);
+            // std::cout << "============" << std::endl;
+            // std::cout << "  lMin:" << lMin << " lMax:" << lMax << " nMin:" << nMin << " nMax:" << nMax;
+            // std::cout << " count: " << std::max( 0l, std::min(lMax, nMax) - std::max(lMin, nMin) + 1 ) << std::endl;
+            // std::cout << "  " << no << ": " << intercepts[no] << std::endl;
+            // std::cout << std::max( lZero, std::min(lMax, nMax+1) - std::max(lMin, nMin+1) + 1 ) << std::endl;
+            // std::cout << std::max( lZero, std::min(lMax, nMax-1) - std::max(lMin, nMin-1) + 1 ) << std::endl;
+            // left diagonal intercepts
+            intercepts[dno] += std::max(lZero, std::min(lMax, nMax + 1) - std::max(lMin, nMin + 1) + 1);
+            // right diagonal intercepts
+            intercepts[dno] += std::max(lZero, std::min(lMax, nMax - 1) - std::max(lMin, nMin - 1) + 1);
+
+            // go to the next line or the next neighbor depending on where we are
+            if (nMax <= lMax)
             {
-              nMax = ni->GetIndex()[0] - 1;
+              // go to next neighbor
+              nMin = ni->GetIndex()[0] + ni->GetLength();
+              ++ni;
+
+              if (ni != ns.end())
+              {
+                nMax = ni->GetIndex()[0] - 1;
+              }
+              else
+              {
+                nMax = NumericTraits<IndexValueType>::max() - 1;
+              }
             }
             else
             {
-              nMax = NumericTraits<IndexValueType>::max() - 1;
+              // go to next line
+              ++li;
             }
           }
-          else
-          {
-            // go to next line
-            ++li;
-          }
         }
       }
     }
+  };
+  MapInterceptType intercepts;
+  if (m_ParallelizeLabelObject)
+  {
+    std::mutex mutex;
+    this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension - 1>(
+      lRegion,
+      [&countIntercepts, &intercepts, &mutex](const typename LineImageType::RegionType & region) {
+        MapInterceptType regionIntercepts;
+        countIntercepts(region, regionIntercepts);
+        const std::lock_guard<std::mutex> lockGuard(mutex);
+        for (const auto & intercept : regionIntercepts)
+        {
+          intercepts[intercept.first] += intercept.second;
+        }
+      },
+      nullptr);
+  }
+  else
+  {
+    countIntercepts(lRegion, intercepts);
   }
 
   // compute the perimeter based on the intercept counts
@@ -901,6 +1221,7 @@ ShapeLabelMapFilter<TImage, TLabelImage>::AfterThreadedGenerateData()
 
   // Release the label image
   m_LabelImage = nullptr;
+  m_LabelObjects.clear();
 }
 
 template <typename TImage, typename TLabelImage>
@@ -19,7 +19,9 @@
 #include "itkGTest.h"
 
 #include "itkImage.h"
+#include "itkImageRegionIterator.h"
 #include "itkLabelImageToShapeLabelMapFilter.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
 #include "itkTestingMacros.h"
 
 
@@ -117,6 +119,131 @@ protected:
 
       return EXIT_SUCCESS;
     }
+
+    // A large object made of random balls with random holes, and small
+    // balls with other labels. The large object is processed by all the work
+    // units together, with several ranges of lines.
+    static typename ImageType::Pointer
+    CreateRandomImage(const typename ImageType::SizeType & size, const typename ImageType::SpacingType & spacing)
+    {
+      auto randomGenerator = itk::Statistics::MersenneTwisterRandomVariateGenerator::New();
+      randomGenerator->Initialize(20250701);
+
+      auto image = ImageType::New();
+      image->SetRegions(typename ImageType::RegionType(size));
+      image->SetSpacing(spacing);
+      image->AllocateInitialized();
+
+      const auto addBall = [&image, &size, &randomGenerator](PixelType label, double radius, double holeProbability) {
+        typename ImageType::IndexType center;
+        for (unsigned int i = 0; i < Dimension; ++i)
+        {
+          center[i] = randomGenerator->GetIntegerVariate(size[i] - 1);
+        }
+        for (itk::ImageRegionIterator<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+        {
+          double squaredDistance = 0.0;
+          for (unsigned int i = 0; i < Dimension; ++i)
+          {
+            squaredDistance += itk::Math::sqr(static_cast<double>(it.GetIndex()[i] - center[i]));
+          }
+          if (squaredDistance <= radius * radius && randomGenerator->GetVariate() >= holeProbability)
+          {
+            it.Set(label);
+          }
+        }
+      };
+      for (unsigned int ball = 0; ball < 6; ++ball)
+      {
+        addBall(1, 0.3 * size[0], 0.3);
+      }
+      for (PixelType label = 2; label < 12; ++label)
+      {
+        addBall(label, 1.0 + 0.5 * label, 0.0);
+      }
+      return image;
+    }
+
+    // The Feret diameter is the largest distance between two pixels of the
+    // object on its border, and the attributes do not depend on the number
+    // of work units.
+    static void
+    CheckFeretDiameterAndWorkUnits(const typename ImageType::SizeType &    size,
+                                   const typename ImageType::SpacingType & spacing)
+    {
+      const typename ImageType::Pointer image = CreateRandomImage(size, spacing);
+
+      std::map<PixelType, std::vector<typename ImageType::IndexType>> borders;
+      for (itk::ImageRegionIterator<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+      {
+        if (it.Get() == 0)
+        {
+          continue;
+        }
+        bool isOnBorder = false;
+        for (unsigned int i = 0; i < Dimension; ++i)
+        {
+          for (const int step : { -1, 1 })
+          {
+            typename ImageType::IndexType neighbor = it.GetIndex();
+            neighbor[i] += step;
+            isOnBorder = isOnBorder || !image->GetLargestPossibleRegion().IsInside(neighbor) ||
+                         image->GetPixel(neighbor) != it.Get();
+          }
+        }
+        if (isOnBorder)
+        {
+          borders[it.Get()].push_back(it.GetIndex());
+        }
+      }
+
+      using L2SType = itk::LabelImageToShapeLabelMapFilter<ImageType>;
+      std::vector<typename ShapeLabelMapType::Pointer> outputs;
+      for (const unsigned int numberOfWorkUnits : { 1, 4 })
+      {
+        auto l2s = L2SType::New();
+        l2s->SetInput(image);
+        l2s->SetNumberOfWorkUnits(numberOfWorkUnits);
+        l2s->ComputeFeretDiameterOn();
+        l2s->ComputePerimeterOn();
+        l2s->Update();
+        outputs.push_back(l2s->GetOutput());
+        outputs.back()->DisconnectPipeline();
+      }
+      EXPECT_GE(outputs[0]->GetLabelObject(1)->GetNumberOfPixels(), 16384u);
+      EXPECT_GT(outputs[0]->GetLabelObject(1)->GetNumberOfLines(), 4096u);
+
+      ASSERT_EQ(outputs[0]->GetNumberOfLabelObjects(), borders.size());
+      for (const auto & border : borders)
+      {
+        double feretDiameter = 0.0;
+        for (auto it1 = border.second.begin(); it1 != border.second.end(); ++it1)
+        {
+          for (auto it2 = it1 + 1; it2 != border.second.end(); ++it2)
+          {
+            double squaredDistance = 0.0;
+            for (unsigned int i = 0; i < Dimension; ++i)
+            {
+              squaredDistance += itk::Math::sqr(((*it1)[i] - (*it2)[i]) * spacing[i]);
+            }
+            feretDiameter = std::max(feretDiameter, squaredDistance);
+          }
+        }
+        feretDiameter = std::sqrt(feretDiameter);
+
+        const LabelObjectType * labelObject = outputs[0]->GetLabelObject(border.first);
+        const LabelObjectType * otherLabelObject = outputs[1]->GetLabelObject(border.first);
+        EXPECT_NEAR(labelObject->GetFeretDiameter(), feretDiameter, 1e-12 * feretDiameter);
+        EXPECT_EQ(otherLabelObject->GetFeretDiameter(), labelObject->GetFeretDiameter());
+        EXPECT_EQ(otherLabelObject->GetNumberOfPixels(), labelObject->GetNumberOfPixels());
+        EXPECT_EQ(otherLabelObject->GetBoundingBox(), labelObject->GetBoundingBox());
+        EXPECT_EQ(otherLabelObject->GetCentroid(), labelObject->GetCentroid());
+        EXPECT_EQ(otherLabelObject->GetNumberOfPixelsOnBorder(), labelObject->GetNumberOfPixelsOnBorder());
+        EXPECT_EQ(otherLabelObject->GetPerimeterOnBorder(), labelObject->GetPerimeterOnBorder());
+        EXPECT_EQ(otherLabelObject->GetPrincipalMoments(), labelObject->GetPrincipalMoments());
+        EXPECT_EQ(otherLabelObject->GetPerimeter(), labelObject->GetPerimeter());
+      }
+    }
   };
 };
 } // namespace
@@ -535,3 +662,19 @@ TEST_F(ShapeLabelMapFixture, 2D_T2x4)
     labelObject->Print(std::cout);
   }
 }
+
+
+TEST_F(ShapeLabelMapFixture, 2D_FeretDiameterAndWorkUnits)
+{
+  using Utils = FixtureUtilities<2>;
+
+  Utils::CheckFeretDiameterAndWorkUnits(itk::MakeSize(260, 190), itk::MakeVector(0.7, 1.3));
+}
+
+
+TEST_F(ShapeLabelMapFixture, 3D_FeretDiameterAndWorkUnits)
+{
+  using Utils = FixtureUtilities<3>;
+
+  Utils::CheckFeretDiameterAndWorkUnits(itk::MakeSize(48, 44, 30), itk::MakeVector(1.0, 0.6, 2.1));
+}
@@ -117,6 +117,17 @@ public:
   using LType = Vector<float, VDimension>;
   using DecompType = std::vector<LType>;
 
+  /** A periodic line: the offsets k * Step, for k from First to Last, with
+   * First <= 0 <= Last. */
+  struct PeriodicLineType
+  {
+    OffsetType      Step;
+    OffsetValueType First;
+    OffsetValueType Last;
+  };
+  using PeriodicLineContainerType = std::vector<PeriodicLineType>;
+  using OffsetContainerType = std::vector<OffsetType>;
+
   /** ImageType used in constructors */
   using ImageType = typename itk::Image<PixelType, VDimension>;
 
@@ -219,6 +230,21 @@ public:
   static Self
   FromImage(const ImageType * image);
 
+  /**
+   * Decompose the structuring element, as the Minkowski sum of periodic lines
+   * and of a residual set of offsets. The steps of the lines are the offsets
+   * whose components are between -2 and 2, and they are peeled greedily from
+   * the structuring element, the shortest ones first, as long as the
+   * structuring element is the Minkowski sum of the remainder and of the
+   * pair made of the null offset and of the step. Convex polygons and
+   * polyhedra whose edges are along those steps, like octagons or hexagons
+   * built with FromImage(), are decomposed in one line per edge direction
+   * and a residual set of a few offsets.
+   * Return false, with empty containers, when no line can be extracted.
+   */
+  bool
+  ComputePeriodicLineDecomposition(PeriodicLineContainerType & lines, OffsetContainerType & residual) const;
+
 protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
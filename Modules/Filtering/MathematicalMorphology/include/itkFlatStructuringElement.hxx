@@ -18,6 +18,7 @@
 #ifndef itkFlatStructuringElement_hxx
 #define itkFlatStructuringElement_hxx
 #include "itkMath.h"
+#include <algorithm>
 #include <cmath>
 #include <vector>
 
@@ -1310,6 +1311,154 @@ FlatStructuringElement<VDimension>::FromImage(const typename FlatStructuringElem
   return res;
 }
 
+template <unsigned int VDimension>
+bool
+FlatStructuringElement<VDimension>::ComputePeriodicLineDecomposition(PeriodicLineContainerType & lines,
+                                                                      OffsetContainerType &       residual) const
+{
+  lines.clear();
+  residual.clear();
+
+  const SizeValueType numberOfOffsets = this->Size();
+  const RadiusType    radius = this->GetRadius();
+
+  std::vector<OffsetType> offsets(numberOfOffsets);
+  for (SizeValueType i = 0; i < numberOfOffsets; ++i)
+  {
+    offsets[i] = this->GetOffset(i);
+  }
+  const auto isInside = [&radius](const OffsetType & offset) {
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      if (itk::Math::abs(offset[d]) > static_cast<OffsetValueType>(radius[d]))
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // the candidate steps, with components between -2 and 2 and with a positive
+  // last non zero component, the shortest ones first
+  std::vector<OffsetType> steps;
+  SizeValueType           numberOfCandidates = 1;
+  for (unsigned int d = 0; d < VDimension; ++d)
+  {
+    numberOfCandidates *= 5;
+  }
+  for (SizeValueType k = 0; k < numberOfCandidates; ++k)
+  {
+    OffsetType    step;
+    SizeValueType digits = k;
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      step[d] = static_cast<OffsetValueType>(digits % 5) - 2;
+      digits /= 5;
+    }
+    unsigned int last = VDimension;
+    while (last > 0 && step[last - 1] == 0)
+    {
+      --last;
+    }
+    if (last > 0 && step[last - 1] > 0 && isInside(step))
+    {
+      steps.push_back(step);
+    }
+  }
+  const auto length = [](const OffsetType & step) {
+    OffsetValueType maximum = 0;
+    OffsetValueType sum = 0;
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      maximum = std::max(maximum, itk::Math::abs(step[d]));
+      sum += itk::Math::abs(step[d]);
+    }
+    return std::make_pair(maximum, sum);
+  };
+  std::stable_sort(steps.begin(), steps.end(), [&length](const OffsetType & a, const OffsetType & b) {
+    return length(a) < length(b);
+  });
+
+  // peel the pairs {0, step} one at a time from the remainder of the
+  // structuring element: the remainder R is replaced by its erosion E by the
+  // pair when the dilation of E by the pair is R
+  std::vector<char> remainder(numberOfOffsets);
+  for (SizeValueType i = 0; i < numberOfOffsets; ++i)
+  {
+    remainder[i] = (*this)[i];
+  }
+  std::vector<char> eroded(numberOfOffsets);
+  const auto        peel = [&](const OffsetType & step) {
+    OffsetValueType stepOffset = 0;
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      stepOffset += step[d] * static_cast<OffsetValueType>(this->GetStride(d));
+    }
+    bool isEmpty = true;
+    for (SizeValueType i = 0; i < numberOfOffsets; ++i)
+    {
+      eroded[i] = remainder[i] && isInside(offsets[i] + step) && remainder[i + stepOffset];
+      isEmpty = isEmpty && !eroded[i];
+    }
+    if (isEmpty)
+    {
+      return false;
+    }
+    for (SizeValueType i = 0; i < numberOfOffsets; ++i)
+    {
+      const bool dilated = eroded[i] || (isInside(offsets[i] - step) && eroded[i - stepOffset]);
+      if (dilated != static_cast<bool>(remainder[i]))
+      {
+        return false;
+      }
+    }
+    remainder.swap(eroded);
+    return true;
+  };
+
+  std::vector<OffsetValueType> counts(steps.size(), 0);
+  for (bool peeled = true; peeled;)
+  {
+    peeled = false;
+    for (unsigned int s = 0; s < steps.size() && !peeled; ++s)
+    {
+      if (peel(steps[s]))
+      {
+        ++counts[s];
+        peeled = true;
+      }
+    }
+  }
+
+  // the sum of n pairs {0, step} is the line {0, ..., n} * step, which is
+  // centered by shifting it, and the residual, by n / 2 steps
+  OffsetType shift{};
+  for (unsigned int s = 0; s < steps.size(); ++s)
+  {
+    if (counts[s] > 0)
+    {
+      const OffsetValueType half = counts[s] / 2;
+      lines.push_back(PeriodicLineType{ steps[s], -half, counts[s] - half });
+      for (unsigned int d = 0; d < VDimension; ++d)
+      {
+        shift[d] += half * steps[s][d];
+      }
+    }
+  }
+  if (lines.empty())
+  {
+    return false;
+  }
+  for (SizeValueType i = 0; i < numberOfOffsets; ++i)
+  {
+    if (remainder[i])
+    {
+      residual.push_back(offsets[i] + shift);
+    }
+  }
+  return true;
+}
+
 } // namespace itk
 
 #endif
@@ -24,6 +24,7 @@
 #include "itkBasicDilateImageFilter.h"
 #include "itkAnchorDilateImageFilter.h"
 #include "itkVanHerkGilWermanDilateImageFilter.h"
+#include "itkPeriodicLineDilateImageFilter.h"
 #include "itkCastImageFilter.h"
 #include "itkConstantBoundaryCondition.h"
 #include "itkNeighborhood.h"
@@ -41,6 +42,17 @@ namespace itk
  * values (zero or one). Only elements of the structuring element
  * having values > 0 are candidates for affecting the center pixel.
  *
+ * The algorithm is selected when the kernel is set. Decomposable flat
+ * structuring elements use the anchor algorithm. Other structuring elements
+ * use the basic or moving histogram algorithms. Unless the algorithm is then
+ * set explicitly, the other flat structuring elements are decomposed in
+ * periodic lines (see FlatStructuringElement::ComputePeriodicLineDecomposition())
+ * when the filter is updated, and use the PERIODICLINE algorithm, whose cost
+ * per pixel does not depend on the length of the lines, if the decomposition
+ * is cheap enough. The decomposition is not attempted for kernels with fewer
+ * than four pixels, and is postponed while the kernel is larger than the
+ * output requested region.
+ *
  * \sa MorphologyImageFilter, GrayscaleFunctionDilateImageFilter, BinaryDilateImageFilter
  * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
  * \ingroup ITKMathematicalMorphology
@@ -88,6 +100,7 @@ public:
 
   using AnchorFilterType = AnchorDilateImageFilter<TInputImage, FlatKernelType>;
   using VHGWFilterType = VanHerkGilWermanDilateImageFilter<TInputImage, FlatKernelType>;
+  using PeriodicLineFilterType = PeriodicLineDilateImageFilter<TInputImage, FlatKernelType>;
   using CastFilterType = CastImageFilter<TInputImage, TOutputImage>;
 
   /** Typedef for boundary conditions. */
@@ -145,6 +158,11 @@ protected:
   GenerateData() override;
 
 private:
+  /** Select the PERIODICLINE algorithm if the kernel is decomposed in periodic
+   * lines at a lower cost than with the selected algorithm. */
+  void
+  SelectPeriodicLineAlgorithm();
+
   PixelType m_Boundary{};
 
   // the filters used internally
@@ -156,9 +174,14 @@ private:
 
   typename VHGWFilterType::Pointer m_VHGWFilter{};
 
+  typename PeriodicLineFilterType::Pointer m_PeriodicLineFilter{};
+
   // and the name of the filter
   AlgorithmEnum m_Algorithm{};
 
+  // whether the PERIODICLINE algorithm may be selected in GenerateData()
+  bool m_PeriodicLineIsCandidate{ false };
+
   // the boundary condition need to be stored here
   DefaultBoundaryConditionType m_BoundaryCondition{};
 }; // end of class
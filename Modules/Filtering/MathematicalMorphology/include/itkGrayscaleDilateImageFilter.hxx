@@ -20,6 +20,7 @@
 
 #include "itkNumericTraits.h"
 #include "itkProgressAccumulator.h"
+#include <algorithm>
 #include <string>
 
 namespace itk
@@ -31,6 +32,7 @@ GrayscaleDilateImageFilter<TInputImage, TOutputImage, TKernel>::GrayscaleDilateI
   m_HistogramFilter = HistogramFilterType::New();
   m_AnchorFilter = AnchorFilterType::New();
   m_VHGWFilter = VHGWFilterType::New();
+  m_PeriodicLineFilter = PeriodicLineFilterType::New();
   m_Algorithm = AlgorithmEnum::HISTO;
 
   this->SetBoundary(NumericTraits<PixelType>::NonpositiveMin());
@@ -44,6 +46,7 @@ GrayscaleDilateImageFilter<TInputImage, TOutputImage, TKernel>::SetNumberOfWorkU
   m_HistogramFilter->SetNumberOfWorkUnits(nb);
   m_AnchorFilter->SetNumberOfWorkUnits(nb);
   m_VHGWFilter->SetNumberOfWorkUnits(nb);
+  m_PeriodicLineFilter->SetNumberOfWorkUnits(nb);
   m_BasicFilter->SetNumberOfWorkUnits(nb);
 }
 
@@ -87,6 +90,10 @@ GrayscaleDilateImageFilter<TInputImage, TOutputImage, TKernel>::SetKernel(const
     }
   }
 
+  // the decomposition in periodic lines is only computed if the kernel is
+  // used with the automatically selected algorithm
+  m_PeriodicLineIsCandidate = flatKernel != nullptr && !flatKernel->GetDecomposable();
+
   Superclass::SetKernel(kernel);
 }
 
@@ -98,6 +105,7 @@ GrayscaleDilateImageFilter<TInputImage, TOutputImage, TKernel>::SetBoundary(cons
   m_HistogramFilter->SetBoundary(value);
   m_AnchorFilter->SetBoundary(value);
   m_VHGWFilter->SetBoundary(value);
+  m_PeriodicLineFilter->SetBoundary(value);
   m_BoundaryCondition.SetConstant(value);
   m_BasicFilter->OverrideBoundaryCondition(&m_BoundaryCondition);
 }
@@ -108,6 +116,8 @@ GrayscaleDilateImageFilter<TInputImage, TOutputImage, TKernel>::SetAlgorithm(Alg
 {
   const auto * flatKernel = dynamic_cast<const FlatKernelType *>(&this->GetKernel());
 
+  m_PeriodicLineIsCandidate = false;
+
   if (m_Algorithm != algo)
   {
     if (algo == AlgorithmEnum::BASIC)
@@ -126,6 +136,10 @@ GrayscaleDilateImageFilter<TInputImage, TOutputImage, TKernel>::SetAlgorithm(Alg
     {
       m_VHGWFilter->SetKernel(*flatKernel);
     }
+    else if (flatKernel != nullptr && algo == AlgorithmEnum::PERIODICLINE)
+    {
+      m_PeriodicLineFilter->SetKernel(*flatKernel);
+    }
     else
     {
       itkExceptionMacro("Invalid algorithm");
@@ -136,6 +150,45 @@ GrayscaleDilateImageFilter<TInputImage, TOutputImage, TKernel>::SetAlgorithm(Alg
   }
 }
 
+template <typename TInputImage, typename TOutputImage, typename TKernel>
+void
+GrayscaleDilateImageFilter<TInputImage, TOutputImage, TKernel>::SelectPeriodicLineAlgorithm()
+{
+  const auto & flatKernel = dynamic_cast<const FlatKernelType &>(this->GetKernel());
+  const auto   basicCost = static_cast<SizeValueType>(std::count(flatKernel.Begin(), flatKernel.End(), true));
+
+  // computing the decomposition takes several passes over the kernel: it is
+  // postponed while the kernel is larger than the output
+  if (flatKernel.Size() > this->GetOutput()->GetRequestedRegion().GetNumberOfPixels())
+  {
+    return;
+  }
+  m_PeriodicLineIsCandidate = false;
+
+  // a decomposition has at least one line and one residual offset
+  if (basicCost < 4)
+  {
+    return;
+  }
+
+  // the periodic lines use about three comparisons per pixel and per line,
+  // while the basic algorithm uses one comparison per pixel of the kernel, and
+  // the histogram algorithm updates the histogram twice per pixel added by a
+  // translation of the kernel
+  typename FlatKernelType::PeriodicLineContainerType lines;
+  typename FlatKernelType::OffsetContainerType       residual;
+  if (flatKernel.ComputePeriodicLineDecomposition(lines, residual))
+  {
+    const auto periodicLineCost = static_cast<SizeValueType>(3 * lines.size() + residual.size());
+    if (periodicLineCost < basicCost && periodicLineCost < 2 * m_HistogramFilter->GetPixelsPerTranslation())
+    {
+      itkDebugMacro("Selecting the PERIODICLINE algorithm");
+      m_PeriodicLineFilter->SetKernel(flatKernel);
+      m_Algorithm = AlgorithmEnum::PERIODICLINE;
+    }
+  }
+}
+
 template <typename TInputImage, typename TOutputImage, typename TKernel>
 void
 GrayscaleDilateImageFilter<TInputImage, TOutputImage, TKernel>::GenerateData()
@@ -148,6 +201,11 @@ GrayscaleDilateImageFilter<TInputImage, TOutputImage, TKernel>::GenerateData()
   // Allocate the output
   this->AllocateOutputs();
 
+  if (m_PeriodicLineIsCandidate)
+  {
+    this->SelectPeriodicLineAlgorithm();
+  }
+
   // Delegate to the appropriate dilation filter
   if (m_Algorithm == AlgorithmEnum::BASIC)
   {
@@ -193,6 +251,20 @@ GrayscaleDilateImageFilter<TInputImage, TOutputImage, TKernel>::GenerateData()
     cast->SetInput(m_VHGWFilter->GetOutput());
     progress->RegisterInternalFilter(cast, 0.1f);
 
+    cast->GraftOutput(this->GetOutput());
+    cast->Update();
+    this->GraftOutput(cast->GetOutput());
+  }
+  else if (m_Algorithm == AlgorithmEnum::PERIODICLINE)
+  {
+    itkDebugMacro("Running PeriodicLineDilateImageFilter");
+    m_PeriodicLineFilter->SetInput(this->GetInput());
+    progress->RegisterInternalFilter(m_PeriodicLineFilter, 0.9f);
+
+    auto cast = CastFilterType::New();
+    cast->SetInput(m_PeriodicLineFilter->GetOutput());
+    progress->RegisterInternalFilter(cast, 0.1f);
+
     cast->GraftOutput(this->GetOutput());
     cast->Update();
     this->GraftOutput(cast->GetOutput());
@@ -208,6 +280,7 @@ GrayscaleDilateImageFilter<TInputImage, TOutputImage, TKernel>::Modified() const
   m_HistogramFilter->Modified();
   m_AnchorFilter->Modified();
   m_VHGWFilter->Modified();
+  m_PeriodicLineFilter->Modified();
 }
 
 template <typename TInputImage, typename TOutputImage, typename TKernel>
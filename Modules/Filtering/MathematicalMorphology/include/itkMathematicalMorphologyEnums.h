@@ -44,7 +44,8 @@ public:
     BASIC = 0,
     HISTO = 1,
     ANCHOR = 2,
-    VHGW = 3
+    VHGW = 3,
+    PERIODICLINE = 4
   };
 };
 
@@ -0,0 +1,61 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkPeriodicLineDilateImageFilter_h
+#define itkPeriodicLineDilateImageFilter_h
+
+#include "itkPeriodicLineErodeDilateImageFilter.h"
+// for MaxFunctor
+#include "itkVanHerkGilWermanDilateImageFilter.h"
+
+namespace itk
+{
+/**
+ * \class PeriodicLineDilateImageFilter
+ * \brief Grayscale dilation by a flat structuring element decomposed in
+ * periodic lines, in constant time per pixel and per line.
+ *
+ * \sa PeriodicLineErodeDilateImageFilter
+ * \ingroup ITKMathematicalMorphology
+ */
+template <typename TImage, typename TKernel>
+class PeriodicLineDilateImageFilter
+  : public PeriodicLineErodeDilateImageFilter<TImage, TKernel, MaxFunctor<typename TImage::PixelType>>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(PeriodicLineDilateImageFilter);
+
+  using Self = PeriodicLineDilateImageFilter;
+  using Superclass = PeriodicLineErodeDilateImageFilter<TImage, TKernel, MaxFunctor<typename TImage::PixelType>>;
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(PeriodicLineDilateImageFilter);
+
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+  using PixelType = typename TImage::PixelType;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+protected:
+  PeriodicLineDilateImageFilter() { this->m_Boundary = NumericTraits<PixelType>::NonpositiveMin(); }
+  ~PeriodicLineDilateImageFilter() override = default;
+};
+} // namespace itk
+
+#endif
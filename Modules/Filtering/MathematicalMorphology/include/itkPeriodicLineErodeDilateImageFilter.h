@@ -0,0 +1,163 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkPeriodicLineErodeDilateImageFilter_h
+#define itkPeriodicLineErodeDilateImageFilter_h
+
+#include "itkKernelImageFilter.h"
+
+#include <vector>
+
+namespace itk
+{
+/**
+ * \class PeriodicLineErodeDilateImageFilter
+ * \brief Erosions and dilations by flat structuring elements decomposed in
+ * periodic lines, in constant time per pixel and per line.
+ *
+ * The structuring element is decomposed, with
+ * FlatStructuringElement::ComputePeriodicLineDecomposition(), as the Minkowski
+ * sum of periodic lines and of a small residual set of offsets. The residual
+ * set is applied directly, then each line is applied with the van
+ * Herk/Gil-Werman algorithm, which uses three comparisons per pixel whatever
+ * the length of the line. Unlike VanHerkGilWermanErodeDilateImageFilter, the
+ * lines are not limited to the lines of decomposable structuring elements,
+ * and the pixels outside of the image are given the boundary value, so that
+ * the result is the same as the one of BasicDilateImageFilter or
+ * BasicErodeImageFilter with a constant boundary condition.
+ *
+ * Each work unit copies its output region, padded by the radius of the
+ * kernel, in a buffer. The pixels of a line which are in the same row of the
+ * buffer are on different periodic lines, so that the passes along a line
+ * whose step is not along the first dimension process whole rows at once, in
+ * loops that the compiler vectorizes.
+ *
+ * This is the base class that must be instantiated with the function
+ * computing the maximum (for dilations) or minimum (for erosions) of two
+ * pixels.
+ *
+ * \sa FlatStructuringElement, VanHerkGilWermanErodeDilateImageFilter
+ * \ingroup ITKMathematicalMorphology
+ */
+template <typename TImage, typename TKernel, typename TFunction1>
+class ITK_TEMPLATE_EXPORT PeriodicLineErodeDilateImageFilter : public KernelImageFilter<TImage, TImage, TKernel>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(PeriodicLineErodeDilateImageFilter);
+
+  /** Standard class type aliases. */
+  using Self = PeriodicLineErodeDilateImageFilter;
+  using Superclass = KernelImageFilter<TImage, TImage, TKernel>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Kernel type alias. */
+  using KernelType = TKernel;
+
+  using InputImageType = TImage;
+  using InputImagePointer = typename InputImageType::Pointer;
+  using InputImageConstPointer = typename InputImageType::ConstPointer;
+  using InputImageRegionType = typename InputImageType::RegionType;
+  using InputImagePixelType = typename InputImageType::PixelType;
+  using IndexType = typename TImage::IndexType;
+  using SizeType = typename TImage::SizeType;
+  using OffsetType = typename TImage::OffsetType;
+
+  using PeriodicLineType = typename KernelType::PeriodicLineType;
+  using PeriodicLineContainerType = typename KernelType::PeriodicLineContainerType;
+  using OffsetContainerType = typename KernelType::OffsetContainerType;
+
+  /** ImageDimension constants */
+  static constexpr unsigned int InputImageDimension = TImage::ImageDimension;
+  static constexpr unsigned int OutputImageDimension = TImage::ImageDimension;
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(PeriodicLineErodeDilateImageFilter);
+
+  /** Set/Get the boundary value. */
+  itkSetMacro(Boundary, InputImagePixelType);
+  itkGetConstMacro(Boundary, InputImagePixelType);
+
+protected:
+  PeriodicLineErodeDilateImageFilter();
+  ~PeriodicLineErodeDilateImageFilter() override = default;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** Decompose the kernel. */
+  void
+  BeforeThreadedGenerateData() override;
+
+  /** Multi-thread version GenerateData. */
+  void
+  DynamicThreadedGenerateData(const InputImageRegionType & outputRegionForThread) override;
+
+  // should be set by the meta filter
+  InputImagePixelType m_Boundary{};
+
+private:
+  /** Geometry of the buffer of a work unit, whose rows are along the first
+   * dimension. */
+  struct BufferGeometryType
+  {
+    SizeType        m_Size;
+    OffsetValueType m_Stride[InputImageDimension];
+    SizeValueType   m_NumberOfRows;
+
+    /** Position of a row in the buffer along each dimension but the first. */
+    void
+    ComputeRowPosition(SizeValueType row, OffsetType & position) const;
+
+    /** Whether the row shifted by an offset is in the buffer. */
+    bool
+    IsRowInside(const OffsetType & position, const OffsetType & offset) const;
+
+    /** Range of the positions x along the first dimension such that x + shift
+     * is in the buffer. */
+    void
+    ComputeColumnRange(OffsetValueType shift, OffsetValueType & begin, OffsetValueType & end) const;
+  };
+
+  /** Replace each pixel of the buffer by the result of the function over the
+   * pixels at the offsets of the residual set. */
+  void
+  ApplyResidual(const BufferGeometryType &         geometry,
+                std::vector<InputImagePixelType> & buffer,
+                std::vector<InputImagePixelType> & work) const;
+
+  /** Replace each pixel of the buffer by the result of the function over the
+   * pixels of the periodic line. */
+  void
+  ApplyLine(const BufferGeometryType &         geometry,
+            const PeriodicLineType &           line,
+            std::vector<InputImagePixelType> & buffer,
+            std::vector<InputImagePixelType> & forward,
+            std::vector<InputImagePixelType> & backward) const;
+
+  PeriodicLineContainerType m_Lines{};
+  OffsetContainerType       m_Residual{};
+}; // end of class
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkPeriodicLineErodeDilateImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,396 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkPeriodicLineErodeDilateImageFilter_hxx
+#define itkPeriodicLineErodeDilateImageFilter_hxx
+
+#include "itkImageScanlineIterator.h"
+#include "itkTotalProgressReporter.h"
+
+#include <algorithm>
+
+namespace itk
+{
+template <typename TImage, typename TKernel, typename TFunction1>
+PeriodicLineErodeDilateImageFilter<TImage, TKernel, TFunction1>::PeriodicLineErodeDilateImageFilter()
+  : m_Boundary(InputImagePixelType{})
+{
+  this->DynamicMultiThreadingOn();
+  this->ThreaderUpdateProgressOff();
+}
+
+template <typename TImage, typename TKernel, typename TFunction1>
+void
+PeriodicLineErodeDilateImageFilter<TImage, TKernel, TFunction1>::BeforeThreadedGenerateData()
+{
+  if (!this->GetKernel().ComputePeriodicLineDecomposition(m_Lines, m_Residual))
+  {
+    itkExceptionMacro("The structuring element can not be decomposed in periodic lines");
+  }
+}
+
+template <typename TImage, typename TKernel, typename TFunction1>
+void
+PeriodicLineErodeDilateImageFilter<TImage, TKernel, TFunction1>::DynamicThreadedGenerateData(
+  const InputImageRegionType & outputRegionForThread)
+{
+  const InputImageType * input = this->GetInput();
+  InputImageType *       output = this->GetOutput();
+
+  const bool applyResidual = m_Residual.size() != 1 || m_Residual[0] != OffsetType{};
+  const auto numberOfPasses = static_cast<SizeValueType>(m_Lines.size() + (applyResidual ? 1 : 0));
+  TotalProgressReporter progress(this, numberOfPasses * output->GetRequestedRegion().GetNumberOfPixels());
+
+  // the buffer holds the output region padded by the radius of the kernel,
+  // which is enough for the output region to be exact, whatever the order of
+  // the passes; the margin of the buffer is only partially computed
+  InputImageRegionType bufferRegion = outputRegionForThread;
+  bufferRegion.PadByRadius(this->GetKernel().GetRadius());
+
+  BufferGeometryType geometry;
+  geometry.m_Size = bufferRegion.GetSize();
+  geometry.m_Stride[0] = 1;
+  for (unsigned int d = 1; d < InputImageDimension; ++d)
+  {
+    geometry.m_Stride[d] = geometry.m_Stride[d - 1] * static_cast<OffsetValueType>(geometry.m_Size[d - 1]);
+  }
+  const SizeValueType numberOfPixels = bufferRegion.GetNumberOfPixels();
+  geometry.m_NumberOfRows = numberOfPixels / geometry.m_Size[0];
+
+  const auto computeBufferOffset = [&bufferRegion, &geometry](const IndexType & index) {
+    OffsetValueType offset = 0;
+    for (unsigned int d = 0; d < InputImageDimension; ++d)
+    {
+      offset += (index[d] - bufferRegion.GetIndex(d)) * geometry.m_Stride[d];
+    }
+    return offset;
+  };
+
+  // the pixels outside of the input are set to the boundary value
+  std::vector<InputImagePixelType> buffer(numberOfPixels, m_Boundary);
+  InputImageRegionType             inputRegion = bufferRegion;
+  if (inputRegion.Crop(input->GetRequestedRegion()))
+  {
+    ImageScanlineConstIterator<InputImageType> inputIt(input, inputRegion);
+    while (!inputIt.IsAtEnd())
+    {
+      InputImagePixelType * bufferIt = buffer.data() + computeBufferOffset(inputIt.GetIndex());
+      while (!inputIt.IsAtEndOfLine())
+      {
+        *bufferIt++ = inputIt.Get();
+        ++inputIt;
+      }
+      inputIt.NextLine();
+    }
+  }
+
+  std::vector<InputImagePixelType> forward(numberOfPixels);
+  std::vector<InputImagePixelType> backward(numberOfPixels);
+  if (applyResidual)
+  {
+    this->ApplyResidual(geometry, buffer, forward);
+    progress.Completed(outputRegionForThread.GetNumberOfPixels());
+  }
+  for (const PeriodicLineType & line : m_Lines)
+  {
+    this->ApplyLine(geometry, line, buffer, forward, backward);
+    progress.Completed(outputRegionForThread.GetNumberOfPixels());
+  }
+
+  ImageScanlineIterator<InputImageType> outputIt(output, outputRegionForThread);
+  while (!outputIt.IsAtEnd())
+  {
+    const InputImagePixelType * bufferIt = buffer.data() + computeBufferOffset(outputIt.GetIndex());
+    while (!outputIt.IsAtEndOfLine())
+    {
+      outputIt.Set(*bufferIt++);
+      ++outputIt;
+    }
+    outputIt.NextLine();
+  }
+}
+
+template <typename TImage, typename TKernel, typename TFunction1>
+void
+PeriodicLineErodeDilateImageFilter<TImage, TKernel, TFunction1>::ApplyResidual(
+  const BufferGeometryType &         geometry,
+  std::vector<InputImagePixelType> & buffer,
+  std::vector<InputImagePixelType> & work) const
+{
+  const TFunction1    function{};
+  const auto          width = static_cast<OffsetValueType>(geometry.m_Size[0]);
+  const SizeValueType numberOfRows = geometry.m_NumberOfRows;
+
+  work = buffer;
+  OffsetType position;
+  for (unsigned int k = 0; k < m_Residual.size(); ++k)
+  {
+    const OffsetType & offset = m_Residual[k];
+    OffsetValueType    linearOffset = 0;
+    for (unsigned int d = 0; d < InputImageDimension; ++d)
+    {
+      linearOffset += offset[d] * geometry.m_Stride[d];
+    }
+    OffsetValueType begin;
+    OffsetValueType end;
+    geometry.ComputeColumnRange(offset[0], begin, end);
+
+    for (SizeValueType row = 0; row < numberOfRows; ++row)
+    {
+      geometry.ComputeRowPosition(row, position);
+      if (!geometry.IsRowInside(position, offset))
+      {
+        continue;
+      }
+      InputImagePixelType * const       out = buffer.data() + row * width;
+      const InputImagePixelType * const in = work.data() + row * width + linearOffset;
+      if (k == 0)
+      {
+        std::copy(in + begin, in + end, out + begin);
+      }
+      else
+      {
+        for (OffsetValueType x = begin; x < end; ++x)
+        {
+          out[x] = function(out[x], in[x]);
+        }
+      }
+    }
+  }
+}
+
+template <typename TImage, typename TKernel, typename TFunction1>
+void
+PeriodicLineErodeDilateImageFilter<TImage, TKernel, TFunction1>::ApplyLine(
+  const BufferGeometryType &         geometry,
+  const PeriodicLineType &           line,
+  std::vector<InputImagePixelType> & buffer,
+  std::vector<InputImagePixelType> & forward,
+  std::vector<InputImagePixelType> & backward) const
+{
+  const TFunction1    function{};
+  const auto          width = static_cast<OffsetValueType>(geometry.m_Size[0]);
+  const SizeValueType numberOfRows = geometry.m_NumberOfRows;
+
+  // orient the line so that the last non zero component of its step is
+  // positive: the pixel before a pixel on a periodic line is then before it
+  // in the buffer
+  OffsetType      step = line.Step;
+  OffsetValueType first = line.First;
+  OffsetValueType last = line.Last;
+  unsigned int    lastDimension = InputImageDimension - 1;
+  while (lastDimension > 0 && step[lastDimension] == 0)
+  {
+    --lastDimension;
+  }
+  if (step[lastDimension] < 0)
+  {
+    for (unsigned int d = 0; d < InputImageDimension; ++d)
+    {
+      step[d] = -step[d];
+    }
+    std::swap(first, last);
+    first = -first;
+    last = -last;
+  }
+  const OffsetValueType blockLength = last - first + 1;
+  if (blockLength <= 1)
+  {
+    return;
+  }
+  OffsetValueType linearStep = 0;
+  OffsetType      backStep;
+  OffsetType      firstStep;
+  OffsetType      lastStep;
+  for (unsigned int d = 0; d < InputImageDimension; ++d)
+  {
+    linearStep += step[d] * geometry.m_Stride[d];
+    backStep[d] = -step[d];
+    firstStep[d] = first * step[d];
+    lastStep[d] = last * step[d];
+  }
+
+  // each periodic line is cut in blocks of blockLength pixels; forward holds
+  // the result of the function from the start of the block of each pixel, and
+  // backward the result of the function up to the end of the block
+  InputImagePixelType * const f = buffer.data();
+  InputImagePixelType * const g = forward.data();
+  InputImagePixelType * const h = backward.data();
+  OffsetType                  position;
+  if (lastDimension > 0)
+  {
+    // all the pixels of a row are at the same position on their periodic
+    // line, so that the rows are processed at once
+    const OffsetValueType stepAlongLastDimension = step[lastDimension];
+    OffsetValueType       begin;
+    OffsetValueType       end;
+
+    geometry.ComputeColumnRange(-step[0], begin, end);
+    for (SizeValueType row = 0; row < numberOfRows; ++row)
+    {
+      geometry.ComputeRowPosition(row, position);
+      const OffsetValueType       t = position[lastDimension] / stepAlongLastDimension;
+      const InputImagePixelType * fRow = f + row * width;
+      InputImagePixelType *       gRow = g + row * width;
+      if (t % blockLength == 0 || !geometry.IsRowInside(position, backStep))
+      {
+        std::copy(fRow, fRow + width, gRow);
+        continue;
+      }
+      std::copy(fRow, fRow + begin, gRow);
+      for (OffsetValueType x = begin; x < end; ++x)
+      {
+        gRow[x] = function(gRow[x - linearStep], fRow[x]);
+      }
+      std::copy(fRow + end, fRow + width, gRow + end);
+    }
+
+    geometry.ComputeColumnRange(step[0], begin, end);
+    for (SizeValueType row = numberOfRows; row > 0; --row)
+    {
+      geometry.ComputeRowPosition(row - 1, position);
+      const OffsetValueType       t = position[lastDimension] / stepAlongLastDimension;
+      const InputImagePixelType * fRow = f + (row - 1) * width;
+      InputImagePixelType *       hRow = h + (row - 1) * width;
+      if ((t + 1) % blockLength == 0 || !geometry.IsRowInside(position, step))
+      {
+        std::copy(fRow, fRow + width, hRow);
+        continue;
+      }
+      std::copy(fRow, fRow + begin, hRow);
+      for (OffsetValueType x = begin; x < end; ++x)
+      {
+        hRow[x] = function(hRow[x + linearStep], fRow[x]);
+      }
+      std::copy(fRow + end, fRow + width, hRow + end);
+    }
+  }
+  else
+  {
+    // the periodic lines are in the rows, and interleaved when the step is
+    // larger than one
+    const OffsetValueType period = step[0];
+    for (SizeValueType row = 0; row < numberOfRows; ++row)
+    {
+      const InputImagePixelType * fRow = f + row * width;
+      InputImagePixelType *       gRow = g + row * width;
+      InputImagePixelType *       hRow = h + row * width;
+      for (OffsetValueType start = 0; start < std::min(period, width); ++start)
+      {
+        const OffsetValueType lastIndex = (width - 1 - start) / period;
+        OffsetValueType       positionInBlock = 0;
+        for (OffsetValueType j = 0, x = start; j <= lastIndex; ++j, x += period)
+        {
+          gRow[x] = positionInBlock == 0 ? fRow[x] : function(gRow[x - period], fRow[x]);
+          positionInBlock = positionInBlock + 1 == blockLength ? 0 : positionInBlock + 1;
+        }
+        positionInBlock = (lastIndex + 1) % blockLength;
+        for (OffsetValueType j = lastIndex, x = start + lastIndex * period; j >= 0; --j, x -= period)
+        {
+          hRow[x] = (j == lastIndex || positionInBlock == 0) ? fRow[x] : function(hRow[x + period], fRow[x]);
+          positionInBlock = positionInBlock == 0 ? blockLength - 1 : positionInBlock - 1;
+        }
+      }
+    }
+  }
+
+  // the window of a pixel covers the end of the block of its first pixel,
+  // and the start of the block of its last pixel
+  OffsetValueType firstBegin;
+  OffsetValueType firstEnd;
+  OffsetValueType lastBegin;
+  OffsetValueType lastEnd;
+  geometry.ComputeColumnRange(firstStep[0], firstBegin, firstEnd);
+  geometry.ComputeColumnRange(lastStep[0], lastBegin, lastEnd);
+  const OffsetValueType begin = std::max(firstBegin, lastBegin);
+  const OffsetValueType end = std::min(firstEnd, lastEnd);
+  const OffsetValueType firstOffset = first * linearStep;
+  const OffsetValueType lastOffset = last * linearStep;
+  for (SizeValueType row = 0; row < numberOfRows; ++row)
+  {
+    geometry.ComputeRowPosition(row, position);
+    if (!geometry.IsRowInside(position, firstStep) || !geometry.IsRowInside(position, lastStep))
+    {
+      continue;
+    }
+    InputImagePixelType * const       fRow = f + row * width;
+    const InputImagePixelType * const hRow = h + row * width + firstOffset;
+    const InputImagePixelType * const gRow = g + row * width + lastOffset;
+    for (OffsetValueType x = begin; x < end; ++x)
+    {
+      fRow[x] = function(hRow[x], gRow[x]);
+    }
+  }
+}
+
+template <typename TImage, typename TKernel, typename TFunction1>
+void
+PeriodicLineErodeDilateImageFilter<TImage, TKernel, TFunction1>::BufferGeometryType::ComputeRowPosition(
+  SizeValueType row,
+  OffsetType &  position) const
+{
+  position[0] = 0;
+  for (unsigned int d = 1; d < InputImageDimension; ++d)
+  {
+    position[d] = static_cast<OffsetValueType>(row % m_Size[d]);
+    row /= m_Size[d];
+  }
+}
+
+template <typename TImage, typename TKernel, typename TFunction1>
+bool
+PeriodicLineErodeDilateImageFilter<TImage, TKernel, TFunction1>::BufferGeometryType::IsRowInside(
+  const OffsetType & position,
+  const OffsetType & offset) const
+{
+  for (unsigned int d = 1; d < InputImageDimension; ++d)
+  {
+    const OffsetValueType p = position[d] + offset[d];
+    if (p < 0 || p >= static_cast<OffsetValueType>(m_Size[d]))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename TImage, typename TKernel, typename TFunction1>
+void
+PeriodicLineErodeDilateImageFilter<TImage, TKernel, TFunction1>::BufferGeometryType::ComputeColumnRange(
+  OffsetValueType   shift,
+  OffsetValueType & begin,
+  OffsetValueType & end) const
+{
+  const auto width = static_cast<OffsetValueType>(m_Size[0]);
+  begin = std::max(OffsetValueType{ 0 }, -shift);
+  end = std::max(begin, std::min(width, width - shift));
+}
+
+template <typename TImage, typename TKernel, typename TFunction1>
+void
+PeriodicLineErodeDilateImageFilter<TImage, TKernel, TFunction1>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Boundary: " << static_cast<typename NumericTraits<InputImagePixelType>::PrintType>(m_Boundary)
+     << std::endl;
+  os << indent << "Number of periodic lines: " << m_Lines.size() << std::endl;
+  os << indent << "Number of residual offsets: " << m_Residual.size() << std::endl;
+}
+
+} // end namespace itk
+
+#endif
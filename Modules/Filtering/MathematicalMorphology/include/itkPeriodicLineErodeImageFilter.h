@@ -0,0 +1,61 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkPeriodicLineErodeImageFilter_h
+#define itkPeriodicLineErodeImageFilter_h
+
+#include "itkPeriodicLineErodeDilateImageFilter.h"
+// for MinFunctor
+#include "itkVanHerkGilWermanErodeImageFilter.h"
+
+namespace itk
+{
+/**
+ * \class PeriodicLineErodeImageFilter
+ * \brief Grayscale erosion by a flat structuring element decomposed in
+ * periodic lines, in constant time per pixel and per line.
+ *
+ * \sa PeriodicLineErodeDilateImageFilter
+ * \ingroup ITKMathematicalMorphology
+ */
+template <typename TImage, typename TKernel>
+class PeriodicLineErodeImageFilter
+  : public PeriodicLineErodeDilateImageFilter<TImage, TKernel, MinFunctor<typename TImage::PixelType>>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(PeriodicLineErodeImageFilter);
+
+  using Self = PeriodicLineErodeImageFilter;
+  using Superclass = PeriodicLineErodeDilateImageFilter<TImage, TKernel, MinFunctor<typename TImage::PixelType>>;
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(PeriodicLineErodeImageFilter);
+
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+  using PixelType = typename TImage::PixelType;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+protected:
+  PeriodicLineErodeImageFilter() { this->m_Boundary = NumericTraits<PixelType>::max(); }
+  ~PeriodicLineErodeImageFilter() override = default;
+};
+} // namespace itk
+
+#endif
@@ -22,7 +22,7 @@
 #include "itkShapedNeighborhoodIterator.h"
 #include "itkImageRegionIterator.h"
 #include "itkProgressReporter.h"
-#include <queue>
+#include <vector>
 
 // #define BASIC
 #define COPY
@@ -43,6 +43,13 @@ namespace itk
  * applications and efficient algorithms" -- IEEE Transactions on
  * Image processing, Vol 2, No 2, pp 176-201, April 1993
  *
+ * When more than one work unit is available and UseInternalCopy is on, the
+ * image is split in slabs along its last dimension. The raster, antiraster
+ * and FIFO steps are run on every slab in parallel, then the values are
+ * propagated across the slab boundaries and the FIFO step is run again on
+ * the slabs that changed, until no value changes anymore. The result is the
+ * same as the one of the sequential algorithm.
+ *
  * \author Richard Beare. Department of Medicine, Monash University,
  * Melbourne, Australia.
  *
@@ -150,6 +157,11 @@ protected:
   void
   GenerateData() override;
 
+  /** Reconstructs the padded marker image in place, in numberOfSlabs slabs
+   * along the last dimension which are processed in parallel. */
+  void
+  ParallelReconstruction(MarkerImageType * marker, const MaskImageType * mask, unsigned int numberOfSlabs);
+
   /**
    * the value of the border - used in boundary condition.
    */
@@ -171,6 +183,53 @@ private:
   using InIndexType = typename InputImageType::IndexType;
   using CNInputIterator = ConstShapedNeighborhoodIterator<InputImageType>;
   using NOutputIterator = ShapedNeighborhoodIterator<OutputImageType>;
+
+  /** FIFO stored in a flat array. The array is kept when the FIFO is drained,
+   * so that its storage is reused by the following pushes. */
+  template <typename TValue>
+  class FlatFifo
+  {
+  public:
+    void
+    Push(const TValue & value)
+    {
+      m_Values.push_back(value);
+    }
+
+    bool
+    Empty() const
+    {
+      return m_Head == m_Values.size();
+    }
+
+    const TValue &
+    Front() const
+    {
+      return m_Values[m_Head];
+    }
+
+    void
+    Pop()
+    {
+      ++m_Head;
+      if (m_Head == m_Values.size())
+      {
+        m_Values.clear();
+        m_Head = 0;
+      }
+      else if (m_Head >= 4096 && 2 * m_Head >= m_Values.size())
+      {
+        // drop the values already popped so that the array does not grow
+        // while the FIFO is never drained
+        m_Values.erase(m_Values.begin(), m_Values.begin() + m_Head);
+        m_Head = 0;
+      }
+    }
+
+  private:
+    std::vector<TValue> m_Values{};
+    size_t              m_Head{ 0 };
+  };
 }; // end of class
 } // end namespace itk
 
@@ -24,6 +24,9 @@
 
 #include "itkConstantPadImageFilter.h"
 #include "itkCropImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkTotalProgressReporter.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -71,11 +74,6 @@ ReconstructionImageFilter<TInputImage, TOutputImage, TCompare>::GenerateData()
 {
   // Allocate the output
   this->AllocateOutputs();
-  // there are 2 passes that use all pixels and a 3rd that uses some
-  // subset of the pixels. We'll just pretend that the third pass
-  // takes the same as each of the others. Is it OK to update more
-  // often than pixels?
-  ProgressReporter progress(this, 0, this->GetOutput()->GetRequestedRegion().GetNumberOfPixels() * 3);
 
   TCompare compare;
 
@@ -134,187 +132,206 @@ ReconstructionImageFilter<TInputImage, TOutputImage, TCompare>::GenerateData()
     markerImageP = output;
   }
 
-  // declare our queue type
-  using FifoType = typename std::queue<OutputImageIndexType>;
-  FifoType IndexFifo;
+  // the slabs along the last dimension reconstructed in parallel
+  constexpr unsigned int lastDimension = OutputImageDimension - 1;
+  const unsigned int     numberOfSlabs = static_cast<unsigned int>(std::min<SizeValueType>(
+    this->GetNumberOfWorkUnits(), output->GetRequestedRegion().GetSize(lastDimension)));
 
-  NOutputIterator   outNIt;
-  InputIteratorType mskIt;
-  CNInputIterator   mskNIt;
-  auto              kernelRadius = ISizeType::Filled(1);
-  if (m_UseInternalCopy)
+  if (OutputImageDimension > 1 && m_UseInternalCopy && numberOfSlabs > 1)
   {
-    FaceCalculatorType faceCalculator;
-
-    FaceListTypeIt fit;
-
-    FaceListType faceList = faceCalculator(maskImageP, maskImageP->GetLargestPossibleRegion(), kernelRadius);
-    // we will only be processing the body region
-    fit = faceList.begin();
-    // must be a better way of doing this
-    const NOutputIterator tt(kernelRadius, markerImageP, *fit);
-    outNIt = tt;
-
-    const InputIteratorType ttt(maskImageP, *fit);
-    mskIt = ttt;
-    const CNInputIterator tttt(kernelRadius, maskImageP, *fit);
-    mskNIt = tttt;
+    this->ParallelReconstruction(
+      const_cast<MarkerImageType *>(markerImageP.GetPointer()), maskImageP.GetPointer(), numberOfSlabs);
   }
   else
   {
-    const NOutputIterator tt(kernelRadius, markerImageP, output->GetRequestedRegion());
-    outNIt = tt;
+    // there are 2 passes that use all pixels and a 3rd that uses some
+    // subset of the pixels. We'll just pretend that the third pass
+    // takes the same as each of the others. Is it OK to update more
+    // often than pixels?
+    ProgressReporter progress(this, 0, output->GetRequestedRegion().GetNumberOfPixels() * 3);
+
+    // declare our queue type
+    using FifoType = FlatFifo<OutputImageIndexType>;
+    FifoType IndexFifo;
+
+    NOutputIterator   outNIt;
+    InputIteratorType mskIt;
+    CNInputIterator   mskNIt;
+    auto              kernelRadius = ISizeType::Filled(1);
+    if (m_UseInternalCopy)
+    {
+      FaceCalculatorType faceCalculator;
 
-    const InputIteratorType ttt(maskImageP, output->GetRequestedRegion());
-    mskIt = ttt;
-    const CNInputIterator tttt(kernelRadius, maskImageP, output->GetRequestedRegion());
-    mskNIt = tttt;
-  }
+      FaceListTypeIt fit;
 
-  setConnectivityPrevious(&outNIt, m_FullyConnected);
+      FaceListType faceList = faceCalculator(maskImageP, maskImageP->GetLargestPossibleRegion(), kernelRadius);
+      // we will only be processing the body region
+      fit = faceList.begin();
+      // must be a better way of doing this
+      const NOutputIterator tt(kernelRadius, markerImageP, *fit);
+      outNIt = tt;
 
-  ConstantBoundaryCondition<OutputImageType> oBC;
-  oBC.SetConstant(m_MarkerValue);
-  outNIt.OverrideBoundaryCondition(&oBC);
+      const InputIteratorType ttt(maskImageP, *fit);
+      mskIt = ttt;
+      const CNInputIterator tttt(kernelRadius, maskImageP, *fit);
+      mskNIt = tttt;
+    }
+    else
+    {
+      const NOutputIterator tt(kernelRadius, markerImageP, output->GetRequestedRegion());
+      outNIt = tt;
 
-  mskIt.GoToBegin();
-  // scan in forward raster order
-  for (outNIt.GoToBegin(), mskIt.GoToBegin(); !outNIt.IsAtEnd(); ++outNIt, ++mskIt)
-  {
-    InputImagePixelType V = outNIt.GetCenterPixel();
-    auto                iV = static_cast<OutputImagePixelType>(mskIt.Get());
+      const InputIteratorType ttt(maskImageP, output->GetRequestedRegion());
+      mskIt = ttt;
+      const CNInputIterator tttt(kernelRadius, maskImageP, output->GetRequestedRegion());
+      mskNIt = tttt;
+    }
+
+    setConnectivityPrevious(&outNIt, m_FullyConnected);
+
+    ConstantBoundaryCondition<OutputImageType> oBC;
+    oBC.SetConstant(m_MarkerValue);
+    outNIt.OverrideBoundaryCondition(&oBC);
 
-    // be sure that the pixels in the images follow the preconditions
-    if (compare(V, iV))
+    mskIt.GoToBegin();
+    // scan in forward raster order
+    for (outNIt.GoToBegin(), mskIt.GoToBegin(); !outNIt.IsAtEnd(); ++outNIt, ++mskIt)
     {
-      if (compare(0, 1))
+      InputImagePixelType V = outNIt.GetCenterPixel();
+      auto                iV = static_cast<OutputImagePixelType>(mskIt.Get());
+
+      // be sure that the pixels in the images follow the preconditions
+      if (compare(V, iV))
       {
-        itkExceptionMacro("Marker pixels must be <= mask pixels.");
+        if (compare(0, 1))
+        {
+          itkExceptionMacro("Marker pixels must be <= mask pixels.");
+        }
+        else
+        {
+          itkExceptionMacro("Marker pixels must be >= mask pixels.");
+        }
       }
-      else
+
+      // visit the previous neighbours
+      typename NOutputIterator::ConstIterator sIt;
+      for (sIt = outNIt.Begin(); !sIt.IsAtEnd(); ++sIt)
       {
-        itkExceptionMacro("Marker pixels must be >= mask pixels.");
+        const InputImagePixelType VN = sIt.Get();
+        if (compare(VN, V))
+        {
+          outNIt.SetCenterPixel(VN);
+          V = VN;
+        }
       }
-    }
 
-    // visit the previous neighbours
-    typename NOutputIterator::ConstIterator sIt;
-    for (sIt = outNIt.Begin(); !sIt.IsAtEnd(); ++sIt)
-    {
-      const InputImagePixelType VN = sIt.Get();
-      if (compare(VN, V))
+      // this step clamps to the mask
+      if (compare(V, iV))
       {
-        outNIt.SetCenterPixel(VN);
-        V = VN;
+        outNIt.SetCenterPixel(iV);
       }
-    }
 
-    // this step clamps to the mask
-    if (compare(V, iV))
-    {
-      outNIt.SetCenterPixel(iV);
+      progress.CompletedPixel();
     }
 
-    progress.CompletedPixel();
-  }
-
-  // now for the reverse raster order pass
-  // reset the neighborhood
-  setConnectivityLater(&outNIt, m_FullyConnected);
-  outNIt.OverrideBoundaryCondition(&oBC);
-  outNIt.GoToEnd();
-  // mskIt.GoToEnd();
+    // now for the reverse raster order pass
+    // reset the neighborhood
+    setConnectivityLater(&outNIt, m_FullyConnected);
+    outNIt.OverrideBoundaryCondition(&oBC);
+    outNIt.GoToEnd();
+    // mskIt.GoToEnd();
 
-  ConstantBoundaryCondition<InputImageType> iBC;
-  iBC.SetConstant(m_MarkerValue);
+    ConstantBoundaryCondition<InputImageType> iBC;
+    iBC.SetConstant(m_MarkerValue);
 
-  setConnectivityLater(&mskNIt, m_FullyConnected);
-  mskNIt.OverrideBoundaryCondition(&iBC);
+    setConnectivityLater(&mskNIt, m_FullyConnected);
+    mskNIt.OverrideBoundaryCondition(&iBC);
 
-  typename NOutputIterator::IndexListType oIndexList = outNIt.GetActiveIndexList();
-  typename NOutputIterator::IndexListType mIndexList = mskNIt.GetActiveIndexList();
+    typename NOutputIterator::IndexListType oIndexList = outNIt.GetActiveIndexList();
+    typename NOutputIterator::IndexListType mIndexList = mskNIt.GetActiveIndexList();
 
-  mskNIt.GoToEnd();
-  while (!outNIt.IsAtBegin())
-  {
-    --outNIt;
-    --mskNIt;
-    InputImagePixelType                     V = outNIt.GetCenterPixel();
-    typename NOutputIterator::ConstIterator sIt;
-    for (sIt = outNIt.Begin(); !sIt.IsAtEnd(); ++sIt)
+    mskNIt.GoToEnd();
+    while (!outNIt.IsAtBegin())
     {
-      const InputImagePixelType VN = sIt.Get();
-      if (compare(VN, V))
+      --outNIt;
+      --mskNIt;
+      InputImagePixelType                     V = outNIt.GetCenterPixel();
+      typename NOutputIterator::ConstIterator sIt;
+      for (sIt = outNIt.Begin(); !sIt.IsAtEnd(); ++sIt)
+      {
+        const InputImagePixelType VN = sIt.Get();
+        if (compare(VN, V))
+        {
+          outNIt.SetCenterPixel(VN);
+          V = VN;
+        }
+      }
+      const InputImagePixelType iV = mskNIt.GetCenterPixel();
+      if (compare(V, iV))
       {
-        outNIt.SetCenterPixel(VN);
-        V = VN;
+        outNIt.SetCenterPixel(iV);
+        V = iV;
       }
-    }
-    const InputImagePixelType iV = mskNIt.GetCenterPixel();
-    if (compare(V, iV))
-    {
-      outNIt.SetCenterPixel(iV);
-      V = iV;
-    }
 
-    // now put indexes in the fifo
-    // typename CNInputIterator::ConstIterator mIt;
-    auto mLIt = mIndexList.begin();
-    for (auto oLIt = oIndexList.begin(); oLIt != oIndexList.end(); ++oLIt, ++mLIt)
-    {
-      const InputImagePixelType VN = outNIt.GetPixel(*oLIt);
-      const InputImagePixelType iN = mskNIt.GetPixel(*mLIt);
-      if (compare(V, VN) && compare(iN, VN))
+      // now put indexes in the fifo
+      // typename CNInputIterator::ConstIterator mIt;
+      auto mLIt = mIndexList.begin();
+      for (auto oLIt = oIndexList.begin(); oLIt != oIndexList.end(); ++oLIt, ++mLIt)
       {
-        IndexFifo.push(outNIt.GetIndex());
-        break;
+        const InputImagePixelType VN = outNIt.GetPixel(*oLIt);
+        const InputImagePixelType iN = mskNIt.GetPixel(*mLIt);
+        if (compare(V, VN) && compare(iN, VN))
+        {
+          IndexFifo.Push(outNIt.GetIndex());
+          break;
+        }
       }
+      progress.CompletedPixel();
     }
-    progress.CompletedPixel();
-  }
 
-  // Now we want to check the full neighborhood
-  setConnectivity(&outNIt, m_FullyConnected);
-  setConnectivity(&mskNIt, m_FullyConnected);
-  mskNIt.OverrideBoundaryCondition(&iBC);
-  outNIt.OverrideBoundaryCondition(&oBC);
-  oIndexList = outNIt.GetActiveIndexList();
-  mIndexList = mskNIt.GetActiveIndexList();
-  // now process the fifo - this fill the parts that weren't dealt
-  // with by the raster and anti-raster passes
-  // typename NOutputIterator::Iterator sIt;
-  const typename CNInputIterator::ConstIterator mIt;
-
-  while (!IndexFifo.empty())
-  {
-    const InputImageIndexType I = IndexFifo.front();
-    IndexFifo.pop();
-    // reposition the iterators
-    outNIt += I - outNIt.GetIndex();
-    mskNIt += I - mskNIt.GetIndex();
-    const InputImagePixelType V = outNIt.GetCenterPixel();
-    auto                      mLIt = mIndexList.begin();
-    for (auto oLIt = oIndexList.begin(); oLIt != oIndexList.end(); ++oLIt, ++mLIt)
+    // Now we want to check the full neighborhood
+    setConnectivity(&outNIt, m_FullyConnected);
+    setConnectivity(&mskNIt, m_FullyConnected);
+    mskNIt.OverrideBoundaryCondition(&iBC);
+    outNIt.OverrideBoundaryCondition(&oBC);
+    oIndexList = outNIt.GetActiveIndexList();
+    mIndexList = mskNIt.GetActiveIndexList();
+    // now process the fifo - this fill the parts that weren't dealt
+    // with by the raster and anti-raster passes
+    // typename NOutputIterator::Iterator sIt;
+    const typename CNInputIterator::ConstIterator mIt;
+
+    while (!IndexFifo.Empty())
     {
-      const InputImagePixelType VN = outNIt.GetPixel(*oLIt);
-      const InputImagePixelType iN = mskNIt.GetPixel(*mLIt);
-      // candidate for dilation via flooding
-      if (compare(V, VN) && Math::NotAlmostEquals(iN, VN))
+      const InputImageIndexType I = IndexFifo.Front();
+      IndexFifo.Pop();
+      // reposition the iterators
+      outNIt += I - outNIt.GetIndex();
+      mskNIt += I - mskNIt.GetIndex();
+      const InputImagePixelType V = outNIt.GetCenterPixel();
+      auto                      mLIt = mIndexList.begin();
+      for (auto oLIt = oIndexList.begin(); oLIt != oIndexList.end(); ++oLIt, ++mLIt)
       {
-        if (compare(iN, V))
+        const InputImagePixelType VN = outNIt.GetPixel(*oLIt);
+        const InputImagePixelType iN = mskNIt.GetPixel(*mLIt);
+        // candidate for dilation via flooding
+        if (compare(V, VN) && Math::NotAlmostEquals(iN, VN))
         {
-          // not clamped by the mask, propagate the center value
-          outNIt.SetPixel(*oLIt, V);
+          if (compare(iN, V))
+          {
+            // not clamped by the mask, propagate the center value
+            outNIt.SetPixel(*oLIt, V);
+          }
+          else
+          {
+            // apply the clamping
+            outNIt.SetPixel(*oLIt, iN);
+          }
+          IndexFifo.Push(outNIt.GetIndex(*oLIt));
         }
-        else
-        {
-          // apply the clamping
-          outNIt.SetPixel(*oLIt, iN);
-        }
-        IndexFifo.push(outNIt.GetIndex(*oLIt));
       }
+      progress.CompletedPixel();
     }
-    progress.CompletedPixel();
   }
 
   if (m_UseInternalCopy)
@@ -334,6 +351,272 @@ ReconstructionImageFilter<TInputImage, TOutputImage, TCompare>::GenerateData()
   }
 }
 
+template <typename TInputImage, typename TOutputImage, typename TCompare>
+void
+ReconstructionImageFilter<TInputImage, TOutputImage, TCompare>::ParallelReconstruction(MarkerImageType *     marker,
+                                                                                       const MaskImageType * mask,
+                                                                                       unsigned int numberOfSlabs)
+{
+  constexpr unsigned int lastDimension = OutputImageDimension - 1;
+
+  TCompare compare;
+
+  // The images are padded by one pixel with m_MarkerValue, which never
+  // propagates, so the neighbors can be visited with linear offsets.
+  const OutputImageRegionType paddedRegion = marker->GetLargestPossibleRegion();
+  OutputImageRegionType       region = paddedRegion;
+  region.ShrinkByRadius(1);
+
+  InputImagePixelType *       out = marker->GetBufferPointer();
+  const InputImagePixelType * msk = mask->GetBufferPointer();
+
+  const OffsetValueType * offsetTable = marker->GetOffsetTable();
+  const OffsetValueType   sliceSize = offsetTable[lastDimension];
+  const OffsetValueType   lineSize = region.GetSize(0);
+
+  // the linear offsets of the neighbors, and the ones which change the
+  // coordinate along the last dimension
+  std::vector<OffsetValueType> previousOffsets;
+  std::vector<OffsetValueType> laterOffsets;
+  std::vector<OffsetValueType> lowerSliceOffsets;
+  std::vector<OffsetValueType> upperSliceOffsets;
+  auto                         kernelRadius = ISizeType::Filled(1);
+  NOutputIterator              nIt(kernelRadius, marker, region);
+  setConnectivity(&nIt, m_FullyConnected);
+  for (typename NOutputIterator::ConstIterator sIt = nIt.Begin(); !sIt.IsAtEnd(); ++sIt)
+  {
+    const typename NOutputIterator::OffsetType offset = sIt.GetNeighborhoodOffset();
+    OffsetValueType                            linearOffset = 0;
+    for (unsigned int d = 0; d < OutputImageDimension; ++d)
+    {
+      linearOffset += offset[d] * offsetTable[d];
+    }
+    (linearOffset < 0 ? previousOffsets : laterOffsets).push_back(linearOffset);
+    if (offset[lastDimension] < 0)
+    {
+      lowerSliceOffsets.push_back(linearOffset);
+    }
+    else if (offset[lastDimension] > 0)
+    {
+      upperSliceOffsets.push_back(linearOffset);
+    }
+  }
+  std::vector<OffsetValueType> neighborOffsets = previousOffsets;
+  neighborOffsets.insert(neighborOffsets.end(), laterOffsets.begin(), laterOffsets.end());
+
+  // the slabs are sets of whole slices of the padded image, so a neighbor
+  // belongs to the slab when its linear offset is in the range of the slab
+  const SizeValueType         numberOfSlices = region.GetSize(lastDimension);
+  const IndexValueType        firstSlice = region.GetIndex(lastDimension) - paddedRegion.GetIndex(lastDimension);
+  std::vector<IndexValueType> slabBegin(numberOfSlabs + 1);
+  for (unsigned int s = 0; s <= numberOfSlabs; ++s)
+  {
+    slabBegin[s] = firstSlice + static_cast<IndexValueType>(numberOfSlices * s / numberOfSlabs);
+  }
+
+  // the offsets of the beginning of the lines of a slice
+  std::vector<OffsetValueType> lineBegins;
+  OutputImageRegionType        lineRegion = region;
+  lineRegion.SetSize(0, 1);
+  lineRegion.SetSize(lastDimension, 1);
+  for (ImageRegionConstIteratorWithIndex<OutputImageType> it(marker, lineRegion); !it.IsAtEnd(); ++it)
+  {
+    lineBegins.push_back(marker->ComputeOffset(it.GetIndex()) - firstSlice * sliceSize);
+  }
+
+  std::vector<FlatFifo<OffsetValueType>> fifos(numberOfSlabs);
+
+  // the raster and antiraster steps use all the pixels and the FIFO steps use
+  // some subset of the pixels, which we count as a third pass
+  const SizeValueType numberOfPixelsToProcess = region.GetNumberOfPixels() * 3;
+
+  // propagates the values of the pixels in the FIFO of the slab, inside the
+  // slab
+  auto propagate = [&](SizeValueType s, TotalProgressReporter & progress) {
+    const OffsetValueType       begin = slabBegin[s] * sliceSize;
+    const OffsetValueType       end = slabBegin[s + 1] * sliceSize;
+    FlatFifo<OffsetValueType> & fifo = fifos[s];
+    while (!fifo.Empty())
+    {
+      const OffsetValueType p = fifo.Front();
+      fifo.Pop();
+      const InputImagePixelType V = out[p];
+      for (const OffsetValueType offset : neighborOffsets)
+      {
+        const OffsetValueType q = p + offset;
+        if (q < begin || q >= end)
+        {
+          continue;
+        }
+        const InputImagePixelType VN = out[q];
+        const InputImagePixelType iN = msk[q];
+        // candidate for dilation via flooding
+        if (compare(V, VN) && Math::NotAlmostEquals(iN, VN))
+        {
+          out[q] = compare(iN, V) ? V : iN;
+          fifo.Push(q);
+        }
+      }
+      progress.CompletedPixel();
+    }
+  };
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+
+  // raster, antiraster and FIFO steps inside every slab
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfSlabs,
+    [&](SizeValueType s) {
+      TotalProgressReporter progress(this, numberOfPixelsToProcess);
+      const OffsetValueType begin = slabBegin[s] * sliceSize;
+      const OffsetValueType end = slabBegin[s + 1] * sliceSize;
+
+      // scan in forward raster order
+      for (OffsetValueType slice = begin; slice < end; slice += sliceSize)
+      {
+        for (const OffsetValueType lineBegin : lineBegins)
+        {
+          for (OffsetValueType p = slice + lineBegin; p < slice + lineBegin + lineSize; ++p)
+          {
+            InputImagePixelType       V = out[p];
+            const InputImagePixelType iV = msk[p];
+
+            // be sure that the pixels in the images follow the preconditions
+            if (compare(V, iV))
+            {
+              if (compare(0, 1))
+              {
+                itkExceptionMacro("Marker pixels must be <= mask pixels.");
+              }
+              else
+              {
+                itkExceptionMacro("Marker pixels must be >= mask pixels.");
+              }
+            }
+
+            for (const OffsetValueType offset : previousOffsets)
+            {
+              const OffsetValueType q = p + offset;
+              if (q >= begin && compare(out[q], V))
+              {
+                V = out[q];
+              }
+            }
+            // this step clamps to the mask
+            out[p] = compare(V, iV) ? iV : V;
+          }
+          progress.Completed(lineSize);
+        }
+      }
+
+      // now for the reverse raster order pass
+      for (OffsetValueType slice = end - sliceSize; slice >= begin; slice -= sliceSize)
+      {
+        for (auto lineIt = lineBegins.rbegin(); lineIt != lineBegins.rend(); ++lineIt)
+        {
+          for (OffsetValueType p = slice + *lineIt + lineSize - 1; p >= slice + *lineIt; --p)
+          {
+            InputImagePixelType V = out[p];
+            for (const OffsetValueType offset : laterOffsets)
+            {
+              const OffsetValueType q = p + offset;
+              if (q < end && compare(out[q], V))
+              {
+                V = out[q];
+              }
+            }
+            const InputImagePixelType iV = msk[p];
+            if (compare(V, iV))
+            {
+              V = iV;
+            }
+            out[p] = V;
+
+            // now put indexes in the fifo
+            for (const OffsetValueType offset : laterOffsets)
+            {
+              const OffsetValueType q = p + offset;
+              if (q < end && compare(V, out[q]) && compare(msk[q], out[q]))
+              {
+                fifos[s].Push(p);
+                break;
+              }
+            }
+          }
+          progress.Completed(lineSize);
+        }
+      }
+
+      propagate(s, progress);
+    },
+    nullptr);
+
+  // Propagate the values across the slab boundaries until they don't change
+  // anymore. The boundary slices are copied first, so that a slab reads the
+  // values of its neighbors while they are updating their own boundaries.
+  std::vector<std::vector<InputImagePixelType>> lowerSlices(numberOfSlabs);
+  std::vector<std::vector<InputImagePixelType>> upperSlices(numberOfSlabs);
+  std::vector<char>                             changed(numberOfSlabs, 1);
+  while (std::find(changed.begin(), changed.end(), 1) != changed.end())
+  {
+    this->GetMultiThreader()->ParallelizeArray(
+      0,
+      numberOfSlabs,
+      [&](SizeValueType s) {
+        const InputImagePixelType * lower = out + slabBegin[s] * sliceSize;
+        const InputImagePixelType * upper = out + (slabBegin[s + 1] - 1) * sliceSize;
+        lowerSlices[s].assign(lower, lower + sliceSize);
+        upperSlices[s].assign(upper, upper + sliceSize);
+      },
+      nullptr);
+
+    this->GetMultiThreader()->ParallelizeArray(
+      0,
+      numberOfSlabs,
+      [&](SizeValueType s) {
+        TotalProgressReporter progress(this, numberOfPixelsToProcess);
+        changed[s] = 0;
+        // pull the values of the boundary slice of the neighbor slab
+        auto pull = [&](OffsetValueType                          slice,
+                        const std::vector<OffsetValueType> &     offsets,
+                        const std::vector<InputImagePixelType> & neighborSlice,
+                        OffsetValueType                          neighborSliceBegin) {
+          for (const OffsetValueType lineBegin : lineBegins)
+          {
+            for (OffsetValueType q = slice + lineBegin; q < slice + lineBegin + lineSize; ++q)
+            {
+              const InputImagePixelType iN = msk[q];
+              for (const OffsetValueType offset : offsets)
+              {
+                const InputImagePixelType V = neighborSlice[q + offset - neighborSliceBegin];
+                const InputImagePixelType VN = out[q];
+                if (compare(V, VN) && Math::NotAlmostEquals(iN, VN))
+                {
+                  out[q] = compare(iN, V) ? V : iN;
+                  fifos[s].Push(q);
+                  changed[s] = 1;
+                }
+              }
+            }
+          }
+        };
+        if (s > 0)
+        {
+          const OffsetValueType slice = slabBegin[s] * sliceSize;
+          pull(slice, lowerSliceOffsets, upperSlices[s - 1], slice - sliceSize);
+        }
+        if (s + 1 < numberOfSlabs)
+        {
+          const OffsetValueType slice = (slabBegin[s + 1] - 1) * sliceSize;
+          pull(slice, upperSliceOffsets, lowerSlices[s + 1], slice + sliceSize);
+        }
+        propagate(s, progress);
+      },
+      nullptr);
+  }
+}
+
 template <typename TInputImage, typename TOutputImage, typename TCompare>
 void
 ReconstructionImageFilter<TInputImage, TOutputImage, TCompare>::PrintSelf(std::ostream & os, Indent indent) const
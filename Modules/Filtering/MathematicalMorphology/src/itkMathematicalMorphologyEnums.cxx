@@ -36,6 +36,8 @@ operator<<(std::ostream & out, const MathematicalMorphologyEnums::Algorithm valu
         return "itk::MathematicalMorphologyEnums::Algorithm::ANCHOR";
       case MathematicalMorphologyEnums::Algorithm::VHGW:
         return "itk::MathematicalMorphologyEnums::Algorithm::VHGW";
+      case MathematicalMorphologyEnums::Algorithm::PERIODICLINE:
+        return "itk::MathematicalMorphologyEnums::Algorithm::PERIODICLINE";
       default:
         return "INVALID VALUE FOR itk::MathematicalMorphologyEnums::Algorithm";
     }
@@ -29,7 +29,8 @@ itkMathematicalMorphologyEnumsTest(int, char *[])
     itk::MathematicalMorphologyEnums::Algorithm::BASIC,
     itk::MathematicalMorphologyEnums::Algorithm::HISTO,
     itk::MathematicalMorphologyEnums::Algorithm::ANCHOR,
-    itk::MathematicalMorphologyEnums::Algorithm::VHGW
+    itk::MathematicalMorphologyEnums::Algorithm::VHGW,
+    itk::MathematicalMorphologyEnums::Algorithm::PERIODICLINE
   };
   for (const auto & ee : allAlgorithm)
   {
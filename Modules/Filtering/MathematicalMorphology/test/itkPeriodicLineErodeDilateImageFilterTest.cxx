@@ -0,0 +1,295 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFlatStructuringElement.h"
+#include "itkGrayscaleDilateImageFilter.h"
+#include "itkGrayscaleErodeImageFilter.h"
+#include "itkPeriodicLineDilateImageFilter.h"
+#include "itkPeriodicLineErodeImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkTestingMacros.h"
+
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+// Build the structuring element which is the Minkowski sum of the lines
+// {-n, ..., n} * step.
+template <unsigned int VDimension>
+itk::FlatStructuringElement<VDimension>
+MakeKernel(const std::vector<std::pair<itk::Offset<VDimension>, int>> & lines)
+{
+  using KernelType = itk::FlatStructuringElement<VDimension>;
+  using OffsetType = itk::Offset<VDimension>;
+
+  std::vector<OffsetType> offsets(1, OffsetType{});
+  for (const auto & line : lines)
+  {
+    std::vector<OffsetType> sum;
+    for (const OffsetType & offset : offsets)
+    {
+      for (int k = -line.second; k <= line.second; ++k)
+      {
+        OffsetType shifted = offset;
+        for (unsigned int d = 0; d < VDimension; ++d)
+        {
+          shifted[d] += k * line.first[d];
+        }
+        sum.push_back(shifted);
+      }
+    }
+    offsets = sum;
+  }
+
+  typename KernelType::RadiusType radius{};
+  for (const OffsetType & offset : offsets)
+  {
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      radius[d] = std::max(radius[d], static_cast<itk::SizeValueType>(itk::Math::abs(offset[d])));
+    }
+  }
+  using ImageType = typename KernelType::ImageType;
+  auto                          image = ImageType::New();
+  typename ImageType::SizeType  size;
+  typename ImageType::IndexType center;
+  for (unsigned int d = 0; d < VDimension; ++d)
+  {
+    size[d] = 2 * radius[d] + 1;
+    center[d] = radius[d];
+  }
+  image->SetRegions(size);
+  image->Allocate();
+  image->FillBuffer(false);
+  for (const OffsetType & offset : offsets)
+  {
+    image->SetPixel(center + offset, true);
+  }
+  return KernelType::FromImage(image);
+}
+
+template <typename TImage>
+typename TImage::Pointer
+MakeRandomImage(const typename TImage::RegionType & region, std::mt19937 & generator)
+{
+  auto image = TImage::New();
+  image->SetRegions(region);
+  image->Allocate();
+  std::uniform_int_distribution<int> distribution(-1000, 1000);
+  for (itk::ImageRegionIterator<TImage> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    it.Set(static_cast<typename TImage::PixelType>(distribution(generator)));
+  }
+  return image;
+}
+
+template <typename TImage>
+bool
+CompareImages(const TImage * expected, const TImage * actual, const char * description)
+{
+  itk::ImageRegionConstIterator<TImage> expectedIt(expected, expected->GetBufferedRegion());
+  itk::ImageRegionConstIterator<TImage> actualIt(actual, expected->GetBufferedRegion());
+  for (; !expectedIt.IsAtEnd(); ++expectedIt, ++actualIt)
+  {
+    if (expectedIt.Get() != actualIt.Get())
+    {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << description << ": error at index " << expectedIt.GetIndex() << std::endl;
+      std::cerr << "Expected value " << expectedIt.Get() << ", but got " << actualIt.Get() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Compare the dilation and erosion by the periodic lines with the basic
+// algorithm, with the default boundary values and with another one.
+template <typename TImage>
+bool
+CompareWithBasic(const TImage * image, const itk::FlatStructuringElement<TImage::ImageDimension> & kernel)
+{
+  using KernelType = itk::FlatStructuringElement<TImage::ImageDimension>;
+  using DilateType = itk::GrayscaleDilateImageFilter<TImage, TImage, KernelType>;
+  using ErodeType = itk::GrayscaleErodeImageFilter<TImage, TImage, KernelType>;
+  using AlgorithmEnum = itk::MathematicalMorphologyEnums::Algorithm;
+
+  for (const bool defaultBoundary : { true, false })
+  {
+    auto dilate = DilateType::New();
+    dilate->SetInput(image);
+    dilate->SetKernel(kernel);
+    dilate->SetNumberOfWorkUnits(3);
+    auto erode = ErodeType::New();
+    erode->SetInput(image);
+    erode->SetKernel(kernel);
+    erode->SetNumberOfWorkUnits(3);
+    if (!defaultBoundary)
+    {
+      dilate->SetBoundary(100);
+      erode->SetBoundary(-100);
+    }
+
+    dilate->SetAlgorithm(AlgorithmEnum::BASIC);
+    erode->SetAlgorithm(AlgorithmEnum::BASIC);
+    ITK_TRY_EXPECT_NO_EXCEPTION(dilate->Update());
+    ITK_TRY_EXPECT_NO_EXCEPTION(erode->Update());
+    const typename TImage::Pointer basicDilation = dilate->GetOutput();
+    const typename TImage::Pointer basicErosion = erode->GetOutput();
+    basicDilation->DisconnectPipeline();
+    basicErosion->DisconnectPipeline();
+
+    dilate->SetAlgorithm(AlgorithmEnum::PERIODICLINE);
+    erode->SetAlgorithm(AlgorithmEnum::PERIODICLINE);
+    ITK_TRY_EXPECT_NO_EXCEPTION(dilate->Update());
+    ITK_TRY_EXPECT_NO_EXCEPTION(erode->Update());
+    if (!CompareImages<TImage>(basicDilation, dilate->GetOutput(), "Dilation") ||
+        !CompareImages<TImage>(basicErosion, erode->GetOutput(), "Erosion"))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkPeriodicLineErodeDilateImageFilterTest(int, char *[])
+{
+  constexpr unsigned int Dimension2D = 2;
+  constexpr unsigned int Dimension3D = 3;
+  using ShortImageType = itk::Image<short, Dimension2D>;
+  using FloatImageType = itk::Image<float, Dimension3D>;
+  using KernelType2D = itk::FlatStructuringElement<Dimension2D>;
+  using KernelType3D = itk::FlatStructuringElement<Dimension3D>;
+  using Offset2D = itk::Offset<Dimension2D>;
+  using Offset3D = itk::Offset<Dimension3D>;
+
+  using DilateFilterType = itk::PeriodicLineDilateImageFilter<ShortImageType, KernelType2D>;
+  auto dilateFilter = DilateFilterType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(dilateFilter, PeriodicLineDilateImageFilter, PeriodicLineErodeDilateImageFilter);
+  ITK_TEST_SET_GET_VALUE(itk::NumericTraits<short>::NonpositiveMin(), dilateFilter->GetBoundary());
+
+  using ErodeFilterType = itk::PeriodicLineErodeImageFilter<ShortImageType, KernelType2D>;
+  auto erodeFilter = ErodeFilterType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(erodeFilter, PeriodicLineErodeImageFilter, PeriodicLineErodeDilateImageFilter);
+  constexpr short boundary = 255;
+  erodeFilter->SetBoundary(boundary);
+  ITK_TEST_SET_GET_VALUE(boundary, erodeFilter->GetBoundary());
+
+  std::mt19937 generator(1234);
+
+  // An octagon is decomposed in four periodic lines, and a small diamond.
+  const KernelType2D octagon = MakeKernel<Dimension2D>({ { Offset2D{ { 1, 0 } }, 4 },
+                                                         { Offset2D{ { 0, 1 } }, 4 },
+                                                         { Offset2D{ { 1, 1 } }, 2 },
+                                                         { Offset2D{ { 1, -1 } }, 2 } });
+  KernelType2D::PeriodicLineContainerType lines;
+  KernelType2D::OffsetContainerType       residual;
+  ITK_TEST_EXPECT_TRUE(octagon.ComputePeriodicLineDecomposition(lines, residual));
+  ITK_TEST_EXPECT_EQUAL(lines.size(), 4);
+  ITK_TEST_EXPECT_EQUAL(residual.size(), 5);
+
+  // A hexagon with steps of length two.
+  const KernelType2D hexagon = MakeKernel<Dimension2D>(
+    { { Offset2D{ { 1, 0 } }, 3 }, { Offset2D{ { 1, 2 } }, 2 }, { Offset2D{ { -1, 2 } }, 2 } });
+
+  // A comb, whose teeth are interleaved with holes along the rows.
+  const KernelType2D comb = MakeKernel<Dimension2D>({ { Offset2D{ { 2, 0 } }, 3 }, { Offset2D{ { 0, 1 } }, 2 } });
+  ITK_TEST_EXPECT_TRUE(comb.ComputePeriodicLineDecomposition(lines, residual));
+  ITK_TEST_EXPECT_EQUAL(lines.size(), 2);
+  ITK_TEST_EXPECT_EQUAL(lines[1].Step, (Offset2D{ { 2, 0 } }));
+
+  // The decomposition of a ball has a residual set.
+  const KernelType2D ball = KernelType2D::Ball(KernelType2D::RadiusType{ { 5, 4 } });
+
+  // A single pixel can not be decomposed.
+  const KernelType2D point = KernelType2D::Ball(KernelType2D::RadiusType{ { 0, 0 } });
+  ITK_TEST_EXPECT_TRUE(!point.ComputePeriodicLineDecomposition(lines, residual));
+  ITK_TEST_EXPECT_TRUE(lines.empty());
+  ITK_TEST_EXPECT_TRUE(residual.empty());
+  dilateFilter->SetKernel(point);
+  const ShortImageType::RegionType pointRegion(ShortImageType::SizeType{ { 5, 5 } });
+  dilateFilter->SetInput(MakeRandomImage<ShortImageType>(pointRegion, generator));
+  ITK_TRY_EXPECT_EXCEPTION(dilateFilter->Update());
+
+  // The algorithm is selected automatically for large kernels, when the filter
+  // is updated with an image larger than the kernel, unless it is set
+  // explicitly.
+  const ShortImageType::Pointer selectionImage =
+    MakeRandomImage<ShortImageType>(ShortImageType::RegionType(ShortImageType::SizeType{ { 32, 32 } }), generator);
+  const ShortImageType::Pointer tinyImage =
+    MakeRandomImage<ShortImageType>(ShortImageType::RegionType(ShortImageType::SizeType{ { 4, 4 } }), generator);
+
+  using GrayscaleDilateType = itk::GrayscaleDilateImageFilter<ShortImageType, ShortImageType, KernelType2D>;
+  auto grayscaleDilate = GrayscaleDilateType::New();
+  grayscaleDilate->SetKernel(octagon);
+  ITK_TEST_EXPECT_TRUE(grayscaleDilate->GetAlgorithm() != itk::MathematicalMorphologyEnums::Algorithm::PERIODICLINE);
+  grayscaleDilate->SetInput(tinyImage);
+  ITK_TRY_EXPECT_NO_EXCEPTION(grayscaleDilate->Update());
+  ITK_TEST_EXPECT_TRUE(grayscaleDilate->GetAlgorithm() != itk::MathematicalMorphologyEnums::Algorithm::PERIODICLINE);
+  grayscaleDilate->SetInput(selectionImage);
+  ITK_TRY_EXPECT_NO_EXCEPTION(grayscaleDilate->UpdateLargestPossibleRegion());
+  ITK_TEST_EXPECT_EQUAL(grayscaleDilate->GetAlgorithm(), itk::MathematicalMorphologyEnums::Algorithm::PERIODICLINE);
+
+  using GrayscaleErodeType = itk::GrayscaleErodeImageFilter<ShortImageType, ShortImageType, KernelType2D>;
+  auto grayscaleErode = GrayscaleErodeType::New();
+  grayscaleErode->SetKernel(octagon);
+  grayscaleErode->SetInput(selectionImage);
+  ITK_TRY_EXPECT_NO_EXCEPTION(grayscaleErode->Update());
+  ITK_TEST_EXPECT_EQUAL(grayscaleErode->GetAlgorithm(), itk::MathematicalMorphologyEnums::Algorithm::PERIODICLINE);
+  grayscaleErode->SetKernel(octagon);
+  grayscaleErode->SetAlgorithm(itk::MathematicalMorphologyEnums::Algorithm::HISTO);
+  ITK_TRY_EXPECT_NO_EXCEPTION(grayscaleErode->Update());
+  ITK_TEST_EXPECT_EQUAL(grayscaleErode->GetAlgorithm(), itk::MathematicalMorphologyEnums::Algorithm::HISTO);
+
+  // Images smaller and larger than the kernels, not starting at the origin.
+  const ShortImageType::RegionType smallRegion({ { -3, 4 } }, { { 6, 9 } });
+  const ShortImageType::RegionType largeRegion({ { 7, -2 } }, { { 61, 47 } });
+  for (const ShortImageType::RegionType & region : { smallRegion, largeRegion })
+  {
+    const ShortImageType::Pointer image = MakeRandomImage<ShortImageType>(region, generator);
+    for (const KernelType2D * kernel : { &octagon, &hexagon, &comb, &ball })
+    {
+      if (!CompareWithBasic<ShortImageType>(image, *kernel))
+      {
+        std::cerr << "With kernel of radius " << kernel->GetRadius() << " on region " << region << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  // A polyhedron in 3D, on a float image.
+  const KernelType3D polyhedron = MakeKernel<Dimension3D>({ { Offset3D{ { 1, 0, 0 } }, 2 },
+                                                            { Offset3D{ { 0, 1, 0 } }, 1 },
+                                                            { Offset3D{ { 0, 0, 1 } }, 1 },
+                                                            { Offset3D{ { 1, 1, 0 } }, 1 },
+                                                            { Offset3D{ { 0, -1, 1 } }, 2 },
+                                                            { Offset3D{ { 2, 0, 1 } }, 1 } });
+  const FloatImageType::RegionType region3D({ { 1, -4, 2 } }, { { 23, 17, 13 } });
+  const FloatImageType::Pointer    image3D = MakeRandomImage<FloatImageType>(region3D, generator);
+  if (!CompareWithBasic<FloatImageType>(image3D, polyhedron))
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
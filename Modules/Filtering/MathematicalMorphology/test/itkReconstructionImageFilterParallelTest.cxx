@@ -0,0 +1,188 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkReconstructionByDilationImageFilter.h"
+#include "itkReconstructionByErosionImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+// Mask with large regions of random values, and a marker made of a few seeds
+// below (for the dilation) or above (for the erosion) the mask.
+template <typename TImage>
+void
+MakeImages(const typename TImage::SizeType & size, bool dilation, TImage * mask, TImage * marker)
+{
+  using PixelType = typename TImage::PixelType;
+  auto random = itk::Statistics::MersenneTwisterRandomVariateGenerator::New();
+  random->SetSeed(17);
+
+  mask->SetRegions(size);
+  mask->Allocate();
+  marker->SetRegions(size);
+  marker->Allocate();
+  itk::ImageRegionIterator<TImage> maskIt(mask, mask->GetLargestPossibleRegion());
+  itk::ImageRegionIterator<TImage> markerIt(marker, marker->GetLargestPossibleRegion());
+  for (; !maskIt.IsAtEnd(); ++maskIt, ++markerIt)
+  {
+    const auto value = static_cast<PixelType>(random->GetIntegerVariate(200) + 20);
+    maskIt.Set(value);
+    if (random->GetIntegerVariate(300) == 0)
+    {
+      markerIt.Set(value);
+    }
+    else
+    {
+      markerIt.Set(dilation ? PixelType{ 0 } : PixelType{ 255 });
+    }
+  }
+}
+
+// Mask made of a path which goes back and forth along the last dimension,
+// with a single seed at its beginning, so that the values cross the slab
+// boundaries many times.
+template <typename TImage>
+void
+MakeSerpentine(const typename TImage::SizeType & size, bool dilation, TImage * mask, TImage * marker)
+{
+  using PixelType = typename TImage::PixelType;
+  const PixelType background = dilation ? PixelType{ 0 } : PixelType{ 255 };
+
+  mask->SetRegions(size);
+  mask->Allocate();
+  mask->FillBuffer(background);
+  marker->SetRegions(size);
+  marker->Allocate();
+  marker->FillBuffer(background);
+
+  constexpr unsigned int     lastDimension = TImage::ImageDimension - 1;
+  typename TImage::IndexType index{};
+  for (index[0] = 0; index[0] < static_cast<itk::IndexValueType>(size[0]); index[0] += 2)
+  {
+    for (index[lastDimension] = 0; index[lastDimension] < static_cast<itk::IndexValueType>(size[lastDimension]);
+         ++index[lastDimension])
+    {
+      mask->SetPixel(index, PixelType{ 120 });
+    }
+    // connect to the next column at alternating ends
+    if (index[0] + 1 < static_cast<itk::IndexValueType>(size[0]))
+    {
+      index[lastDimension] = (index[0] / 2) % 2 == 0 ? size[lastDimension] - 1 : 0;
+      ++index[0];
+      mask->SetPixel(index, PixelType{ 120 });
+      --index[0];
+    }
+  }
+  marker->SetPixel(typename TImage::IndexType{}, PixelType{ 120 });
+}
+
+template <typename TFilter>
+bool
+TestFilter(const typename TFilter::InputImageType::SizeType & size, bool dilation, bool serpentine = false)
+{
+  using ImageType = typename TFilter::InputImageType;
+
+  auto mask = ImageType::New();
+  auto marker = ImageType::New();
+  if (serpentine)
+  {
+    MakeSerpentine<ImageType>(size, dilation, mask, marker);
+  }
+  else
+  {
+    MakeImages<ImageType>(size, dilation, mask, marker);
+  }
+
+  bool success = true;
+  for (const bool fullyConnected : { false, true })
+  {
+    auto sequential = TFilter::New();
+    sequential->SetMarkerImage(marker);
+    sequential->SetMaskImage(mask);
+    sequential->SetFullyConnected(fullyConnected);
+    sequential->SetNumberOfWorkUnits(1);
+    sequential->Update();
+
+    for (const unsigned int numberOfWorkUnits : { 2, 3, 7, 100 })
+    {
+      auto parallel = TFilter::New();
+      parallel->SetMarkerImage(marker);
+      parallel->SetMaskImage(mask);
+      parallel->SetFullyConnected(fullyConnected);
+      parallel->SetNumberOfWorkUnits(numberOfWorkUnits);
+      parallel->Update();
+
+      const ImageType *                        expected = sequential->GetOutput();
+      itk::ImageRegionConstIterator<ImageType> sIt(expected, expected->GetBufferedRegion());
+      itk::ImageRegionConstIterator<ImageType> pIt(parallel->GetOutput(), expected->GetBufferedRegion());
+      for (; !sIt.IsAtEnd(); ++sIt, ++pIt)
+      {
+        if (sIt.Get() != pIt.Get())
+        {
+          std::cerr << "Reconstruction with " << numberOfWorkUnits << " work units, fully connected " << fullyConnected
+                    << " differs: " << static_cast<int>(pIt.Get()) << " != " << static_cast<int>(sIt.Get())
+                    << std::endl;
+          success = false;
+          break;
+        }
+      }
+    }
+  }
+  return success;
+}
+} // namespace
+
+int
+itkReconstructionImageFilterParallelTest(int, char *[])
+{
+  using Image2DType = itk::Image<unsigned char, 2>;
+  using Image3DType = itk::Image<short, 3>;
+
+  bool success = true;
+  success &= TestFilter<itk::ReconstructionByDilationImageFilter<Image2DType, Image2DType>>({ { 73, 41 } }, true);
+  success &= TestFilter<itk::ReconstructionByErosionImageFilter<Image2DType, Image2DType>>({ { 73, 41 } }, false);
+  success &= TestFilter<itk::ReconstructionByDilationImageFilter<Image3DType, Image3DType>>({ { 23, 19, 17 } }, true);
+  success &= TestFilter<itk::ReconstructionByErosionImageFilter<Image3DType, Image3DType>>({ { 23, 19, 17 } }, false);
+  success &=
+    TestFilter<itk::ReconstructionByDilationImageFilter<Image2DType, Image2DType>>({ { 31, 20 } }, true, true);
+  success &=
+    TestFilter<itk::ReconstructionByErosionImageFilter<Image3DType, Image3DType>>({ { 15, 3, 12 } }, false, true);
+
+  // The marker must be below the mask.
+  using FilterType = itk::ReconstructionByDilationImageFilter<Image3DType, Image3DType>;
+  auto mask = Image3DType::New();
+  auto marker = Image3DType::New();
+  MakeImages<Image3DType>({ { 8, 8, 8 } }, true, mask, marker);
+  marker->SetPixel({ { 3, 3, 5 } }, 250);
+  auto filter = FilterType::New();
+  filter->SetMarkerImage(marker);
+  filter->SetMaskImage(mask);
+  filter->SetNumberOfWorkUnits(4);
+  ITK_TRY_EXPECT_EXCEPTION(filter->Update());
+
+  if (!success)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
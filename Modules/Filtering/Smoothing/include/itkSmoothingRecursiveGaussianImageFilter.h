@@ -41,7 +41,6 @@ namespace itk
  * RealImageType.
  *
  * \ingroup IntensityImageFilters
- * \ingroup SingleThreaded
  * \ingroup ITKSmoothing
  *
  */
@@ -27,6 +27,8 @@
 #include "itkImageRegion.h"
 #include "itkDefaultConvertPixelTraits.h"
 #include "itkSimpleDataObjectDecorator.h"
+#include <future>
+#include <memory>
 
 namespace itk
 {
@@ -118,6 +120,19 @@ public:
   itkGetConstReferenceMacro(UseStreaming, bool);
   itkBooleanMacro(UseStreaming);
 
+  /** Set/Get whether the next region is read ahead while the current one
+   * is processed downstream. When streaming with a streamable ImageIO,
+   * the region following the one just read is predicted from the last two
+   * requests (e.g. consecutive slabs requested by a StreamingImageFilter
+   * or an ImageFileWriter), and read on a background thread by a second
+   * instance of the ImageIO. If the next request matches the prediction
+   * the prefetched buffer is used, otherwise it is discarded. The ImageIO
+   * must support reading a file from two instances concurrently. Off by
+   * default. */
+  itkSetMacro(UseReadAhead, bool);
+  itkGetConstReferenceMacro(UseReadAhead, bool);
+  itkBooleanMacro(UseReadAhead);
+
 protected:
   ImageFileReader();
   ~ImageFileReader() override = default;
@@ -160,12 +175,35 @@ protected:
 
   bool m_UseStreaming{};
 
+  bool m_UseReadAhead{};
+
 private:
+  /** Reads m_ActualIORegion into the buffer, using the read ahead buffer
+   * when it holds that region. */
+  void
+  ReadActualIORegion(void * buffer, size_t numberOfBytes);
+
+  /** Predicts the region requested next and starts reading it in the
+   * background. */
+  void
+  StartReadAhead();
+
   std::string m_ExceptionMessage{};
 
   // The region that the ImageIO class will return when we ask to
   // produce the requested region.
   ImageIORegion m_ActualIORegion{};
+
+  // The region read by the previous call to GenerateData().
+  ImageIORegion m_PreviousIORegion{};
+
+  ImageIOBase::Pointer    m_ReadAheadImageIO{};
+  std::string             m_ReadAheadFileName{};
+  ImageIORegion           m_ReadAheadIORegion{};
+  std::unique_ptr<char[]> m_ReadAheadBuffer{};
+  // Declared last so that a pending read is waited for before the
+  // buffer and the ImageIO are destroyed.
+  std::future<void> m_ReadAheadFuture{};
 };
 
 
@@ -27,6 +27,7 @@
 
 #include "itksys/SystemTools.hxx"
 #include "itkMakeUniqueForOverwrite.h"
+#include <algorithm>
 #include <fstream>
 
 namespace itk
@@ -50,6 +51,7 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::PrintSelf(std::ostream & os,
 
   itkPrintSelfBooleanMacro(UserSpecifiedImageIO);
   itkPrintSelfBooleanMacro(UseStreaming);
+  itkPrintSelfBooleanMacro(UseReadAhead);
 
   os << indent << "ExceptionMessage: " << m_ExceptionMessage << std::endl;
   os << indent << "ActualIORegion: " << m_ActualIORegion << std::endl;
@@ -403,7 +405,7 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
                   << m_ImageIO->GetNumberOfComponents());
 
     const auto loadBuffer = make_unique_for_overwrite<char[]>(sizeOfActualIORegion);
-    m_ImageIO->Read(static_cast<void *>(loadBuffer.get()));
+    this->ReadActualIORegion(static_cast<void *>(loadBuffer.get()), sizeOfActualIORegion);
 
     // See note below as to why the buffered region is needed and
     // not actualIORegion
@@ -421,7 +423,7 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
     OutputImagePixelType * outputBuffer = output->GetPixelContainer()->GetBufferPointer();
 
     const auto loadBuffer = make_unique_for_overwrite<char[]>(sizeOfActualIORegion);
-    m_ImageIO->Read(static_cast<void *>(loadBuffer.get()));
+    this->ReadActualIORegion(static_cast<void *>(loadBuffer.get()), sizeOfActualIORegion);
 
     // we use std::copy_n here as it should be optimized to memcpy for
     // plain old data, but still is object oriented programming
@@ -434,12 +436,161 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
     itkDebugMacro("No buffer conversion required.");
 
     OutputImagePixelType * outputBuffer = output->GetPixelContainer()->GetBufferPointer();
-    m_ImageIO->Read(outputBuffer);
+    this->ReadActualIORegion(outputBuffer, sizeOfActualIORegion);
   }
 
+  if (m_UseReadAhead && m_UseStreaming && m_ImageIO->CanStreamRead())
+  {
+    this->StartReadAhead();
+  }
+  m_PreviousIORegion = m_ActualIORegion;
+
   this->UpdateProgress(1.0f);
 }
 
+template <typename TOutputImage, typename ConvertPixelTraits>
+void
+ImageFileReader<TOutputImage, ConvertPixelTraits>::ReadActualIORegion(void * buffer, size_t numberOfBytes)
+{
+  if (m_ReadAheadFuture.valid())
+  {
+    bool useReadAhead = m_ReadAheadIORegion == m_ActualIORegion && m_ReadAheadFileName == this->GetFileName() &&
+                        strcmp(m_ReadAheadImageIO->GetNameOfClass(), m_ImageIO->GetNameOfClass()) == 0;
+    try
+    {
+      m_ReadAheadFuture.get();
+    }
+    catch (const std::exception & err)
+    {
+      // The region is read again below, which reports the error if it
+      // persists.
+      itkDebugMacro("Read ahead failed: " << err.what());
+      useReadAhead = false;
+    }
+    if (useReadAhead)
+    {
+      itkDebugMacro("Using the region read ahead: " << m_ReadAheadIORegion);
+      std::copy_n(m_ReadAheadBuffer.get(), numberOfBytes, static_cast<char *>(buffer));
+      return;
+    }
+  }
+  m_ImageIO->Read(buffer);
+}
+
+template <typename TOutputImage, typename ConvertPixelTraits>
+void
+ImageFileReader<TOutputImage, ConvertPixelTraits>::StartReadAhead()
+{
+  const unsigned int ioDimension = m_ActualIORegion.GetImageDimension();
+  if (ioDimension == 0 || ioDimension > m_ImageIO->GetNumberOfDimensions())
+  {
+    return;
+  }
+
+  // If the previous region was shifted along a single dimension, the
+  // next region is expected to be shifted again by the same amount.
+  // Otherwise, if the region covers the file along all but one dimension,
+  // the adjacent region along that dimension is expected next.
+  ImageIORegion  nextIORegion = m_ActualIORegion;
+  int            shiftedDimension = -1;
+  IndexValueType shift = 0;
+  if (m_PreviousIORegion.GetImageDimension() == ioDimension &&
+      m_PreviousIORegion.GetSize() == m_ActualIORegion.GetSize())
+  {
+    for (unsigned int i = 0; i < ioDimension; ++i)
+    {
+      const IndexValueType delta = m_ActualIORegion.GetIndex(i) - m_PreviousIORegion.GetIndex(i);
+      if (delta != 0)
+      {
+        shiftedDimension = (shiftedDimension == -1 && delta > 0) ? static_cast<int>(i) : -2;
+        shift = delta;
+      }
+    }
+  }
+  if (shiftedDimension < 0)
+  {
+    shiftedDimension = -1;
+    for (unsigned int i = 0; i < ioDimension; ++i)
+    {
+      if (m_ActualIORegion.GetSize(i) != m_ImageIO->GetDimensions(i))
+      {
+        if (shiftedDimension != -1)
+        {
+          return;
+        }
+        shiftedDimension = static_cast<int>(i);
+        shift = static_cast<IndexValueType>(m_ActualIORegion.GetSize(i));
+      }
+    }
+    if (shiftedDimension == -1)
+    {
+      return;
+    }
+  }
+
+  const auto           dimension = static_cast<unsigned int>(shiftedDimension);
+  const IndexValueType nextIndex = m_ActualIORegion.GetIndex(dimension) + shift;
+  const auto           end = static_cast<IndexValueType>(m_ImageIO->GetDimensions(dimension));
+  if (nextIndex >= end)
+  {
+    return;
+  }
+  nextIORegion.SetIndex(dimension, nextIndex);
+  nextIORegion.SetSize(dimension,
+                       std::min(m_ActualIORegion.GetSize(dimension), static_cast<SizeValueType>(end - nextIndex)));
+
+  // A second ImageIO reads the file concurrently, so that the state of
+  // m_ImageIO is left untouched.
+  if (m_ReadAheadImageIO.IsNull() || m_ReadAheadFileName != this->GetFileName() ||
+      strcmp(m_ReadAheadImageIO->GetNameOfClass(), m_ImageIO->GetNameOfClass()) != 0)
+  {
+    m_ReadAheadImageIO = dynamic_cast<ImageIOBase *>(m_ImageIO->CreateAnother().GetPointer());
+    if (m_ReadAheadImageIO.IsNull())
+    {
+      return;
+    }
+    m_ReadAheadFileName = this->GetFileName();
+    try
+    {
+      m_ReadAheadImageIO->SetFileName(m_ReadAheadFileName);
+      m_ReadAheadImageIO->ReadImageInformation();
+    }
+    catch (const ExceptionObject &)
+    {
+      m_ReadAheadImageIO = nullptr;
+      return;
+    }
+  }
+
+  // The prefetched data is only valid if both instances agree on the
+  // layout of the file.
+  bool sameLayout = m_ReadAheadImageIO->GetNumberOfDimensions() == m_ImageIO->GetNumberOfDimensions() &&
+                    m_ReadAheadImageIO->GetComponentType() == m_ImageIO->GetComponentType() &&
+                    m_ReadAheadImageIO->GetNumberOfComponents() == m_ImageIO->GetNumberOfComponents();
+  for (unsigned int i = 0; sameLayout && i < m_ImageIO->GetNumberOfDimensions(); ++i)
+  {
+    sameLayout = m_ReadAheadImageIO->GetDimensions(i) == m_ImageIO->GetDimensions(i);
+  }
+  if (!sameLayout)
+  {
+    m_ReadAheadImageIO = nullptr;
+    return;
+  }
+
+  m_ReadAheadImageIO->SetUseStreamedReading(true);
+  m_ReadAheadIORegion = m_ReadAheadImageIO->GenerateStreamableReadRegionFromRequestedRegion(nextIORegion);
+  m_ReadAheadImageIO->SetIORegion(m_ReadAheadIORegion);
+
+  itkDebugMacro("Reading ahead the IORegion: " << m_ReadAheadIORegion);
+
+  const size_t numberOfBytes = m_ReadAheadIORegion.GetNumberOfPixels() * m_ReadAheadImageIO->GetComponentSize() *
+                               m_ReadAheadImageIO->GetNumberOfComponents();
+  m_ReadAheadBuffer = make_unique_for_overwrite<char[]>(numberOfBytes);
+  m_ReadAheadFuture = std::async(std::launch::async, [imageIO = m_ReadAheadImageIO, buffer = m_ReadAheadBuffer.get()]() {
+    imageIO->Read(buffer);
+  });
+}
+
 template <typename TOutputImage, typename ConvertPixelTraits>
 void
 ImageFileReader<TOutputImage, ConvertPixelTraits>::DoConvertBuffer(const void * inputData, size_t numberOfPixels)
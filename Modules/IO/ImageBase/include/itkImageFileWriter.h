@@ -23,6 +23,7 @@
 #include "itkImageIOBase.h"
 #include "itkMacro.h"
 #include "itkMetaProgrammingLibrary.h"
+#include <future>
 
 namespace itk
 {
@@ -213,6 +214,15 @@ public:
   itkGetConstReferenceMacro(UseInputMetaDataDictionary, bool);
   itkBooleanMacro(UseInputMetaDataDictionary);
 
+  /** Set/Get whether a streamed piece is written in the background while
+   * the upstream pipeline computes the next piece. The piece is copied
+   * before it is written, so that the upstream buffer can be reused. Only
+   * used when the image is written in more than one piece. Off by
+   * default. */
+  itkSetMacro(UseWriteBehind, bool);
+  itkGetConstReferenceMacro(UseWriteBehind, bool);
+  itkBooleanMacro(UseWriteBehind);
+
 protected:
   ImageFileWriter() = default;
   ~ImageFileWriter() override = default;
@@ -237,6 +247,11 @@ private:
   bool m_UseCompression{ false };
   int  m_CompressionLevel{ -1 };
   bool m_UseInputMetaDataDictionary{ true };
+  bool m_UseWriteBehind{ false };
+
+  // Set while streaming with write behind.
+  bool              m_WritingBehind{ false };
+  std::future<void> m_PendingWrite{};
 };
 
 
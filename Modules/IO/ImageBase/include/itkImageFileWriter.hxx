@@ -32,6 +32,7 @@
 #include "itkMatrix.h"
 #include "itkImageAlgorithm.h"
 #include <complex>
+#include <vector>
 
 namespace itk
 {
@@ -259,60 +260,95 @@ ImageFileWriter<TInputImage>::Write()
    * piece, and copy the results into the output image.
    */
 
-  for (unsigned int piece = 0; piece < numDivisions && !this->GetAbortGenerateData(); ++piece)
+  // The split regions are computed before a write can be pending, since the
+  // ImageIO is not used concurrently with its background write.
+  std::vector<ImageIORegion> streamIORegions;
+  streamIORegions.reserve(numDivisions);
+  for (unsigned int piece = 0; piece < numDivisions; ++piece)
   {
-    // get the actual piece to write
-    ImageIORegion streamIORegion =
-      m_ImageIO->GetSplitRegionForWriting(piece, numDivisions, pasteIORegion, largestIORegion);
+    streamIORegions.push_back(m_ImageIO->GetSplitRegionForWriting(piece, numDivisions, pasteIORegion, largestIORegion));
+  }
+
+  m_WritingBehind = m_UseWriteBehind && numDivisions > 1;
 
-    // Check whether the paste region is fully contained inside the
-    // largest region or not.
-    if (!pasteIORegion.IsInside(streamIORegion))
+  try
+  {
+    for (unsigned int piece = 0; piece < numDivisions && !this->GetAbortGenerateData(); ++piece)
     {
-      itkExceptionMacro(
-        << "ImageIO returns streamable region that is not fully contain in paste IO region. Paste IO region: "
-        << pasteIORegion << "Streamable region: " << streamIORegion);
-    }
+      // get the actual piece to write
+      ImageIORegion streamIORegion = streamIORegions[piece];
 
-    InputImageRegionType streamRegion;
-    ImageIORegionAdaptor<TInputImage::ImageDimension>::Convert(streamIORegion, streamRegion, largestRegion.GetIndex());
+      // Check whether the paste region is fully contained inside the
+      // largest region or not.
+      if (!pasteIORegion.IsInside(streamIORegion))
+      {
+        itkExceptionMacro(
+          << "ImageIO returns streamable region that is not fully contain in paste IO region. Paste IO region: "
+          << pasteIORegion << "Streamable region: " << streamIORegion);
+      }
 
-    // execute the upstream pipeline with the requested
-    // region for streaming
-    nonConstInput->SetRequestedRegion(streamRegion);
-    nonConstInput->PropagateRequestedRegion();
-    nonConstInput->UpdateOutputData();
+      InputImageRegionType streamRegion;
+      ImageIORegionAdaptor<TInputImage::ImageDimension>::Convert(
+        streamIORegion, streamRegion, largestRegion.GetIndex());
 
-    if (piece == 0)
-    {
-      // initialize the progress here to mimic the progress behavior of the non
-      // streaming filters, where the progress changes only when the other filters
-      // are done.
-      this->UpdateProgress(0.0f);
-    }
+      // execute the upstream pipeline with the requested
+      // region for streaming
+      nonConstInput->SetRequestedRegion(streamRegion);
+      nonConstInput->PropagateRequestedRegion();
+      nonConstInput->UpdateOutputData();
 
-    // check to see if we tried to stream but got the largest possible region
-    if (piece == 0 && streamRegion != largestRegion)
-    {
-      const InputImageRegionType bufferedRegion = input->GetBufferedRegion();
-      if (bufferedRegion == largestRegion)
+      if (piece == 0)
       {
-        // if so, then just write the entire image
-        itkDebugMacro("Requested stream region  matches largest region input filter may not support streaming well.");
-        itkDebugMacro("Writer is not streaming now!");
-        numDivisions = 1;
-        streamRegion = largestRegion;
-        ImageIORegionAdaptor<TInputImage::ImageDimension>::Convert(
-          streamRegion, streamIORegion, largestRegion.GetIndex());
+        // initialize the progress here to mimic the progress behavior of the non
+        // streaming filters, where the progress changes only when the other filters
+        // are done.
+        this->UpdateProgress(0.0f);
       }
-    }
 
-    m_ImageIO->SetIORegion(streamIORegion);
+      // check to see if we tried to stream but got the largest possible region
+      if (piece == 0 && streamRegion != largestRegion)
+      {
+        const InputImageRegionType bufferedRegion = input->GetBufferedRegion();
+        if (bufferedRegion == largestRegion)
+        {
+          // if so, then just write the entire image
+          itkDebugMacro("Requested stream region  matches largest region input filter may not support streaming well.");
+          itkDebugMacro("Writer is not streaming now!");
+          numDivisions = 1;
+          streamRegion = largestRegion;
+          ImageIORegionAdaptor<TInputImage::ImageDimension>::Convert(
+            streamRegion, streamIORegion, largestRegion.GetIndex());
+        }
+      }
 
-    // write the data
-    this->GenerateData();
+      // the previous piece must be written before the IORegion changes
+      if (m_PendingWrite.valid())
+      {
+        m_PendingWrite.get();
+      }
+      m_ImageIO->SetIORegion(streamIORegion);
+
+      // write the data
+      this->GenerateData();
 
-    this->UpdateProgress(static_cast<float>(piece + 1) / static_cast<float>(numDivisions));
+      this->UpdateProgress(static_cast<float>(piece + 1) / static_cast<float>(numDivisions));
+    }
+  }
+  catch (...)
+  {
+    // the pending write is completed before leaving; if it failed too, its
+    // exception is the one reported since it concerns an earlier piece
+    m_WritingBehind = false;
+    if (m_PendingWrite.valid())
+    {
+      m_PendingWrite.get();
+    }
+    throw;
+  }
+  m_WritingBehind = false;
+  if (m_PendingWrite.valid())
+  {
+    m_PendingWrite.get();
   }
 
   // Notify end event observers
@@ -343,6 +379,23 @@ ImageFileWriter<TInputImage>::GenerateData()
     m_ImageIO->GetIORegion(), ioRegion, largestRegion.GetIndex());
   const InputImageRegionType bufferedRegion = input->GetBufferedRegion();
 
+  if (m_WritingBehind)
+  {
+    // the upstream buffer is overwritten while the piece is written, so
+    // the piece is written from a copy
+    cacheImage = InputImageType::New();
+    cacheImage->CopyInformation(input);
+    cacheImage->SetBufferedRegion(ioRegion);
+    cacheImage->Allocate();
+
+    ImageAlgorithm::Copy(input, cacheImage.GetPointer(), ioRegion, ioRegion);
+
+    m_PendingWrite = std::async(std::launch::async, [imageIO = m_ImageIO, cacheImage]() {
+      imageIO->Write(cacheImage->GetBufferPointer());
+    });
+    return;
+  }
+
   // before this test, bad stuff would happened when they don't match
   if (bufferedRegion != ioRegion)
   {
@@ -393,6 +446,7 @@ ImageFileWriter<TInputImage>::PrintSelf(std::ostream & os, Indent indent) const
   os << indent << "CompressionLevel: " << m_CompressionLevel << std::endl;
   itkPrintSelfBooleanMacro(UseCompression);
   itkPrintSelfBooleanMacro(UseInputMetaDataDictionary);
+  itkPrintSelfBooleanMacro(UseWriteBehind);
   itkPrintSelfBooleanMacro(FactorySpecifiedImageIO);
 }
 } // end namespace itk
@@ -0,0 +1,194 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkPipelineMonitorImageFilter.h"
+#include "itkRGBPixel.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+template <typename TPixel>
+TPixel
+ExpectedValue(const itk::Index<3> & index)
+{
+  return static_cast<TPixel>(index[0] + 5 * index[1] + 97 * index[2]);
+}
+
+template <typename TPixel>
+TPixel
+ExpectedValue(const itk::Index<2> & index)
+{
+  TPixel value;
+  for (unsigned int c = 0; c < TPixel::Dimension; ++c)
+  {
+    value[c] = static_cast<typename TPixel::ValueType>(index[0] + 3 * index[1] + 40 * c);
+  }
+  return value;
+}
+
+template <typename TImage>
+bool
+HasExpectedValues(const TImage * image, const typename TImage::RegionType & pasteRegion = {})
+{
+  using PixelType = typename TImage::PixelType;
+  for (itk::ImageRegionConstIteratorWithIndex<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const PixelType expected =
+      pasteRegion.IsInside(it.GetIndex()) ? PixelType(7) : ExpectedValue<PixelType>(it.GetIndex());
+    if (it.Get() != expected)
+    {
+      std::cerr << "Unexpected value " << it.Get() << " at " << it.GetIndex() << ", expected " << expected
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Writes the image in pieces from a streaming reader, reads it back as a
+// whole and by region, and pastes a region into it.
+template <typename TImage>
+int
+TestStreaming(const std::string & prefix, const std::string & extension, const typename TImage::SizeType & size)
+{
+  using ImageType = TImage;
+  using RegionType = typename ImageType::RegionType;
+  constexpr unsigned int Dimension = ImageType::ImageDimension;
+
+  const RegionType region(size);
+  auto             image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    it.Set(ExpectedValue<typename ImageType::PixelType>(it.GetIndex()));
+  }
+
+  const std::string inputFileName = prefix + "Input" + extension;
+  const std::string outputFileName = prefix + "Output" + extension;
+  ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(image, inputFileName));
+
+  // Write the image in pieces.
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(inputFileName);
+  reader->UseStreamingOn();
+
+  auto monitor = itk::PipelineMonitorImageFilter<ImageType>::New();
+  monitor->SetInput(reader->GetOutput());
+
+  constexpr unsigned int numberOfStreamDivisions = 4;
+  auto                   writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(monitor->GetOutput());
+  writer->SetFileName(outputFileName);
+  writer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  if (!monitor->VerifyAllInputCanStream(numberOfStreamDivisions))
+  {
+    std::cerr << "Writing " << outputFileName << " was not streamed." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const auto written = itk::ReadImage<ImageType>(outputFileName);
+  ITK_TEST_EXPECT_EQUAL(written->GetLargestPossibleRegion(), region);
+  if (!HasExpectedValues(written.GetPointer()))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Read a region.
+  RegionType readRegion = region;
+  for (unsigned int d = 0; d < Dimension; ++d)
+  {
+    readRegion.SetIndex(d, 1);
+    readRegion.SetSize(d, size[d] - 3);
+  }
+  auto regionReader = itk::ImageFileReader<ImageType>::New();
+  regionReader->SetFileName(outputFileName);
+  regionReader->UseStreamingOn();
+  regionReader->GetOutput()->SetRequestedRegion(readRegion);
+  ITK_TRY_EXPECT_NO_EXCEPTION(regionReader->Update());
+  ITK_TEST_EXPECT_EQUAL(regionReader->GetOutput()->GetBufferedRegion(), readRegion);
+  if (!HasExpectedValues(regionReader->GetOutput()))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Paste a region into the file.
+  RegionType pasteRegion = region;
+  pasteRegion.SetIndex(0, 2);
+  pasteRegion.SetSize(0, size[0] - 4);
+  pasteRegion.SetIndex(Dimension - 1, 1);
+  pasteRegion.SetSize(Dimension - 1, 2);
+
+  auto pasteImage = ImageType::New();
+  pasteImage->CopyInformation(image);
+  pasteImage->SetBufferedRegion(pasteRegion);
+  pasteImage->SetRequestedRegion(pasteRegion);
+  pasteImage->Allocate();
+  pasteImage->FillBuffer(typename ImageType::PixelType(7));
+
+  itk::ImageIORegion pasteIORegion(Dimension);
+  for (unsigned int d = 0; d < Dimension; ++d)
+  {
+    pasteIORegion.SetIndex(d, pasteRegion.GetIndex(d));
+    pasteIORegion.SetSize(d, pasteRegion.GetSize(d));
+  }
+  auto pasteWriter = itk::ImageFileWriter<ImageType>::New();
+  pasteWriter->SetInput(pasteImage);
+  pasteWriter->SetFileName(outputFileName);
+  pasteWriter->SetIORegion(pasteIORegion);
+  ITK_TRY_EXPECT_NO_EXCEPTION(pasteWriter->Update());
+
+  const auto pasted = itk::ReadImage<ImageType>(outputFileName);
+  if (!HasExpectedValues(pasted.GetPointer(), pasteRegion))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+// Writes images in pieces and pastes regions into them, with the format of
+// the given file name extension.
+int
+itkImageFileWriterStreamingRoundTripTest(int argc, char * argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputPrefix extension" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string prefix = argv[1];
+  const std::string extension = argv[2];
+
+  using ScalarImageType = itk::Image<unsigned short, 3>;
+  using RGBImageType = itk::Image<itk::RGBPixel<unsigned char>, 2>;
+
+  int status = EXIT_SUCCESS;
+  status |= TestStreaming<ScalarImageType>(prefix + "Scalar", extension, { { 17, 13, 11 } });
+  status |= TestStreaming<RGBImageType>(prefix + "RGB", extension, { { 19, 23 } });
+
+  std::cout << "Test finished." << std::endl;
+  return status;
+}
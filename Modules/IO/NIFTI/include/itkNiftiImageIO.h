@@ -23,7 +23,7 @@
 
 #include <fstream>
 #include <memory>
-#include "itkImageIOBase.h"
+#include "itkStreamingImageIOBase.h"
 
 namespace itk
 {
@@ -91,17 +91,21 @@ extern ITKIONIFTI_EXPORT std::ostream &
  * The specification for this file format is taken from the
  * web site https://analyzedirect.com/support/10.0Documents/Analyze_Resource_01.pdf
  *
+ * Regions can be written into uncompressed files, which allows streamed
+ * and pasted writing, unless the components of the pixels are stored in
+ * separate volumes (vector and tensor images).
+ *
  * \ingroup IOFilters
  * \ingroup ITKIONIFTI
  */
-class ITKIONIFTI_EXPORT NiftiImageIO : public ImageIOBase
+class ITKIONIFTI_EXPORT NiftiImageIO : public StreamingImageIOBase
 {
 public:
   ITK_DISALLOW_COPY_AND_MOVE(NiftiImageIO);
 
   /** Standard class type aliases. */
   using Self = NiftiImageIO;
-  using Superclass = ImageIOBase;
+  using Superclass = StreamingImageIOBase;
   using Pointer = SmartPointer<Self>;
 
   /** Method for creation through the object factory. */
@@ -177,6 +181,19 @@ public:
   ImageIORegion
   GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const override;
 
+  /** Regions can be written into uncompressed files when the pixels are
+   * stored contiguously. */
+  bool
+  CanStreamWrite() override;
+
+  /** Verifies that an existing file is compatible when pasting. As the
+   * geometry is stored in single precision, it is compared with a
+   * tolerance. */
+  unsigned int
+  GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                    const ImageIORegion & pasteRegion,
+                                    const ImageIORegion & largestPossibleRegion) override;
+
   /** Set the slope and intercept for voxel value rescaling. */
   itkSetMacro(RescaleSlope, double);
   itkSetMacro(RescaleIntercept, double);
@@ -236,7 +253,19 @@ protected:
     return false;
   }
 
+  /** Returns the offset of the data in the data file. */
+  SizeType
+  GetHeaderSize() const override
+  {
+    return m_DataPosition;
+  }
+
 private:
+  /** Writes the IORegion of the buffer into the data file, writing the
+   * header first if the file does not exist. */
+  void
+  StreamWrite(const void * buffer);
+
   // Try to use the Q and S form codes from MetaDataDictionary if they are specified
   // there, otherwise default to the backwards compatible values from earlier
   // versions of ITK. The qform guess would probably been better to have
@@ -284,6 +313,8 @@ private:
 
   bool m_SFORM_Permissive;
   bool m_SFORM_Corrected{ false };
+
+  SizeType m_DataPosition{ 0 };
 };
 
 
@@ -24,6 +24,7 @@
 #include "itkMakeUniqueForOverwrite.h"
 #include "itksys/SystemTools.hxx"
 #include "itksys/SystemInformation.hxx"
+#include <algorithm>
 
 namespace itk
 {
@@ -2383,6 +2384,12 @@ NiftiImageIO::SetNIfTIOrientationFromImageIO(unsigned short origdims, unsigned s
 void
 NiftiImageIO::Write(const void * buffer)
 {
+  if (this->RequestedToStream())
+  {
+    this->StreamWrite(buffer);
+    return;
+  }
+
   // Write the image Information before writing data
   this->WriteImageInformation();
   const unsigned int numComponents = this->GetNumberOfComponents();
@@ -2511,6 +2518,138 @@ NiftiImageIO::Write(const void * buffer)
   }
 }
 
+bool
+NiftiImageIO::CanStreamWrite()
+{
+  if (nifti_is_gzfile(this->GetFileName()))
+  {
+    return false;
+  }
+  const unsigned int numComponents = this->GetNumberOfComponents();
+  return numComponents == 1 || (numComponents == 2 && this->GetPixelType() == IOPixelEnum::COMPLEX) ||
+         (numComponents == 3 && this->GetPixelType() == IOPixelEnum::RGB) ||
+         (numComponents == 4 && this->GetPixelType() == IOPixelEnum::RGBA);
+}
+
+unsigned int
+NiftiImageIO::GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                                const ImageIORegion & pasteRegion,
+                                                const ImageIORegion & largestPossibleRegion)
+{
+  if (pasteRegion == largestPossibleRegion || !this->CanStreamWrite() ||
+      !itksys::SystemTools::FileExists(this->GetFileName()))
+  {
+    return Superclass::GetActualNumberOfSplitsForWriting(numberOfRequestedSplits, pasteRegion, largestPossibleRegion);
+  }
+
+  // we are going to be pasting into an existing file, which must be
+  // compatible
+  std::string errorMessage;
+  const auto  headerImageIO = Self::New();
+  headerImageIO->SetLegacyAnalyze75Mode(m_LegacyAnalyze75Mode);
+  headerImageIO->SetSFORM_Permissive(m_SFORM_Permissive);
+  try
+  {
+    headerImageIO->SetFileName(this->GetFileName());
+    headerImageIO->ReadImageInformation();
+  }
+  catch (const ExceptionObject &)
+  {
+    errorMessage = "Unable to read information from file: " + m_FileName;
+  }
+
+  const auto notClose = [](double a, double b) {
+    return itk::Math::abs(a - b) > 1e-5 * std::max({ 1.0, itk::Math::abs(a), itk::Math::abs(b) });
+  };
+  if (!errorMessage.empty())
+  {
+    // 0) Can't read file
+  }
+  else if (headerImageIO->GetNumberOfComponents() != this->GetNumberOfComponents() ||
+           headerImageIO->GetComponentType() != this->GetComponentType())
+  {
+    errorMessage = "Component type does not match in file: " + m_FileName;
+  }
+  else if (headerImageIO->GetNumberOfDimensions() != this->GetNumberOfDimensions())
+  {
+    errorMessage = "Dimensions does not match in file: " + m_FileName;
+  }
+  else
+  {
+    for (unsigned int i = 0; i < this->GetNumberOfDimensions() && errorMessage.empty(); ++i)
+    {
+      if (headerImageIO->GetDimensions(i) != this->GetDimensions(i) ||
+          notClose(headerImageIO->GetSpacing(i), this->GetSpacing(i)) ||
+          notClose(headerImageIO->GetOrigin(i), this->GetOrigin(i)))
+      {
+        errorMessage = "Size, spacing or origin does not match in file: " + m_FileName;
+      }
+      for (unsigned int j = 0; j < this->GetNumberOfDimensions() && errorMessage.empty(); ++j)
+      {
+        if (notClose(headerImageIO->GetDirection(i)[j], this->GetDirection(i)[j]))
+        {
+          errorMessage = "Direction cosines does not match in file: " + m_FileName;
+        }
+      }
+    }
+  }
+  if (!errorMessage.empty())
+  {
+    itkExceptionMacro("Unable to paste because pasting file exists and is different. " << errorMessage);
+  }
+
+  return this->GetActualNumberOfSplitsForWritingCanStreamWrite(numberOfRequestedSplits, pasteRegion);
+}
+
+void
+NiftiImageIO::StreamWrite(const void * buffer)
+{
+  if (!itksys::SystemTools::FileExists(this->GetFileName()))
+  {
+    // write the header, and allocate the data which follows it or is
+    // stored in the separate image file
+    this->WriteImageInformation();
+    nifti_image_write_hdr_img(this->m_NiftiImage, 0, "wb");
+    if (!itksys::SystemTools::FileExists(this->GetFileName()))
+    {
+      itkExceptionMacro("ERROR: nifti library failed to write header: " << this->GetFileName());
+    }
+
+    const std::string dataFileName = this->m_NiftiImage->iname;
+    const auto        dataSize = static_cast<std::streamoff>(this->m_NiftiImage->nvox) * this->m_NiftiImage->nbyper;
+
+    std::ofstream dataFile;
+    this->OpenFileForWriting(dataFile, dataFileName, dataFileName != this->GetFileName());
+    dataFile.seekp(static_cast<std::streamoff>(this->m_NiftiImage->iname_offset) + dataSize - 1, std::ios::beg);
+    dataFile.put('\0');
+    if (dataFile.fail())
+    {
+      itkExceptionMacro("ERROR: Unable to allocate the data in " << dataFileName);
+    }
+  }
+
+  // the header of the file tells where the data is
+  nifti_image * header = nifti_image_read(this->GetFileName(), false);
+  if (header == nullptr)
+  {
+    itkExceptionMacro("nifti_image_read (just header) failed for file: " << this->GetFileName());
+  }
+  const std::string dataFileName = header->iname;
+  const bool        nativeByteOrder = header->byteorder == nifti_short_order() || header->swapsize < 2;
+  const int         dataPosition = header->iname_offset;
+  nifti_image_free(header);
+  if (nifti_is_gzfile(dataFileName.c_str()) || !nativeByteOrder || dataPosition < 0)
+  {
+    itkExceptionMacro("Unable to write a region into " << this->GetFileName()
+                                                       << ", which is compressed or has a different byte order");
+  }
+  m_DataPosition = static_cast<SizeType>(dataPosition);
+
+  std::ofstream file;
+  this->OpenFileForWriting(file, dataFileName, false);
+  this->StreamWriteBufferAsBinary(file, buffer);
+}
+
 std::ostream &
 operator<<(std::ostream & out, const NiftiImageIOEnums::Analyze75Flavor value)
 {
@@ -0,0 +1,188 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkNiftiImageIO.h"
+#include "itkPipelineMonitorImageFilter.h"
+#include "itkTestingMacros.h"
+#include "itksys/SystemTools.hxx"
+
+namespace
+{
+using PixelType = short;
+using ImageType = itk::Image<PixelType, 3>;
+
+PixelType
+ExpectedValue(const ImageType::IndexType & index)
+{
+  return static_cast<PixelType>(index[0] + 5 * index[1] - 97 * index[2]);
+}
+
+bool
+HasExpectedValues(const ImageType * image)
+{
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() != ExpectedValue(it.GetIndex()))
+    {
+      std::cerr << "Unexpected value " << it.Get() << " at " << it.GetIndex() << ", expected "
+                << ExpectedValue(it.GetIndex()) << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Writes the image in four pieces from a streaming reader.
+bool
+StreamWrite(const std::string & inputFileName, const std::string & outputFileName)
+{
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(inputFileName);
+  reader->UseStreamingOn();
+
+  auto monitor = itk::PipelineMonitorImageFilter<ImageType>::New();
+  monitor->SetInput(reader->GetOutput());
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(monitor->GetOutput());
+  writer->SetFileName(outputFileName);
+  writer->SetNumberOfStreamDivisions(4);
+  writer->Update();
+
+  return monitor->VerifyAllInputCanStream(4);
+}
+} // namespace
+
+// Checks the NIfTI specific parts of streamed writing: the header written
+// with the first piece, the layout of the single file and of the header and
+// image pair, and the check of the geometry of the file into which a region
+// is pasted.
+int
+itkNiftiImageIOStreamingTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string prefix = std::string(argv[1]) + "/itkNiftiImageIOStreamingTest";
+
+  const ImageType::RegionType region(ImageType::SizeType{ { 17, 13, 11 } });
+  const auto                  dataSize = static_cast<unsigned long>(region.GetNumberOfPixels() * sizeof(PixelType));
+
+  ImageType::DirectionType direction{};
+  direction(0, 1) = 1.0;
+  direction(1, 0) = -1.0;
+  direction(2, 2) = 1.0;
+
+  auto image = ImageType::New();
+  image->SetRegions(region);
+  image->SetSpacing(itk::MakeVector(0.5, 2.0, 3.0));
+  image->SetOrigin(itk::MakePoint(10.0, -20.0, 5.0));
+  image->SetDirection(direction);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    it.Set(ExpectedValue(it.GetIndex()));
+  }
+  const std::string inputFileName = prefix + "Input.nii";
+  ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(image, inputFileName));
+
+  // The header written with the first piece describes the whole image, and
+  // the data follows it in the single file.
+  const std::string singleFileName = prefix + "Single.nii";
+  ITK_TEST_EXPECT_TRUE(StreamWrite(inputFileName, singleFileName));
+
+  auto niftiIO = itk::NiftiImageIO::New();
+  niftiIO->SetFileName(singleFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(niftiIO->ReadImageInformation());
+  for (unsigned int i = 0; i < ImageType::ImageDimension; ++i)
+  {
+    ITK_TEST_EXPECT_EQUAL(niftiIO->GetDimensions(i), region.GetSize(i));
+    ITK_TEST_EXPECT_TRUE(itk::Math::FloatAlmostEqual(niftiIO->GetSpacing(i), image->GetSpacing()[i], 4, 1e-6));
+    ITK_TEST_EXPECT_TRUE(itk::Math::FloatAlmostEqual(niftiIO->GetOrigin(i), image->GetOrigin()[i], 4, 1e-6));
+    for (unsigned int j = 0; j < ImageType::ImageDimension; ++j)
+    {
+      ITK_TEST_EXPECT_TRUE(itk::Math::FloatAlmostEqual(niftiIO->GetDirection(i)[j], direction(j, i), 4, 1e-6));
+    }
+  }
+  ITK_TEST_EXPECT_EQUAL(itksys::SystemTools::FileLength(singleFileName),
+                        itksys::SystemTools::FileLength(inputFileName));
+  if (!HasExpectedValues(itk::ReadImage<ImageType>(singleFileName)))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // The image file of a header and image pair holds only the data.
+  const std::string pairFileName = prefix + "Pair.hdr";
+  ITK_TEST_EXPECT_TRUE(StreamWrite(inputFileName, pairFileName));
+  ITK_TEST_EXPECT_EQUAL(itksys::SystemTools::FileLength(prefix + "Pair.img"), dataSize);
+  if (!HasExpectedValues(itk::ReadImage<ImageType>(pairFileName)))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // A region is only pasted into a file with the same geometry.
+  ImageType::RegionType pasteRegion = region;
+  pasteRegion.SetIndex(2, 3);
+  pasteRegion.SetSize(2, 2);
+
+  auto pasteImage = ImageType::New();
+  pasteImage->CopyInformation(image);
+  pasteImage->SetSpacing(itk::MakeVector(0.5, 2.0, 3.5));
+  pasteImage->SetBufferedRegion(pasteRegion);
+  pasteImage->SetRequestedRegion(pasteRegion);
+  pasteImage->Allocate();
+  pasteImage->FillBuffer(7);
+
+  itk::ImageIORegion pasteIORegion(ImageType::ImageDimension);
+  for (unsigned int i = 0; i < ImageType::ImageDimension; ++i)
+  {
+    pasteIORegion.SetIndex(i, pasteRegion.GetIndex(i));
+    pasteIORegion.SetSize(i, pasteRegion.GetSize(i));
+  }
+  auto pasteWriter = itk::ImageFileWriter<ImageType>::New();
+  pasteWriter->SetInput(pasteImage);
+  pasteWriter->SetFileName(singleFileName);
+  pasteWriter->SetIORegion(pasteIORegion);
+  ITK_TRY_EXPECT_EXCEPTION(pasteWriter->Update());
+  if (!HasExpectedValues(itk::ReadImage<ImageType>(singleFileName)))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Compressed files and vector images cannot be streamed.
+  niftiIO = itk::NiftiImageIO::New();
+  niftiIO->SetNumberOfDimensions(3);
+  niftiIO->SetPixelType(itk::IOPixelEnum::SCALAR);
+  niftiIO->SetFileName(prefix + "Streamable.nii");
+  ITK_TEST_EXPECT_TRUE(niftiIO->CanStreamWrite());
+  niftiIO->SetFileName(prefix + "Compressed.nii.gz");
+  ITK_TEST_EXPECT_TRUE(!niftiIO->CanStreamWrite());
+  niftiIO->SetFileName(prefix + "Vector.nii");
+  niftiIO->SetPixelType(itk::IOPixelEnum::VECTOR);
+  niftiIO->SetNumberOfComponents(3);
+  ITK_TEST_EXPECT_TRUE(!niftiIO->CanStreamWrite());
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -20,7 +20,7 @@
 #include "ITKIONRRDExport.h"
 
 
-#include "itkImageIOBase.h"
+#include "itkStreamingImageIOBase.h"
 #include <fstream>
 
 struct NrrdEncoding_t;
@@ -38,17 +38,23 @@ namespace itk
  * "bzip2".  Only the "gzip" compressor support the compression level
  * in the range 0-9.
  *
+ * Uncompressed files with raw encoding can be streamed: regions of the
+ * image are read from, or pasted into, the data at their offsets in the
+ * file. This requires a single data file (attached or detached), data in
+ * the native byte order, and the components of the pixels on the fastest
+ * axis.
+ *
  *  \ingroup IOFilters
  * \ingroup ITKIONRRD
  */
-class ITKIONRRD_EXPORT NrrdImageIO : public ImageIOBase
+class ITKIONRRD_EXPORT NrrdImageIO : public StreamingImageIOBase
 {
 public:
   ITK_DISALLOW_COPY_AND_MOVE(NrrdImageIO);
 
   /** Standard class type aliases. */
   using Self = NrrdImageIO;
-  using Superclass = ImageIOBase;
+  using Superclass = StreamingImageIOBase;
   using Pointer = SmartPointer<Self>;
 
   /** Method for creation through the object factory. */
@@ -92,6 +98,19 @@ public:
   void
   Write(const void * buffer) override;
 
+  /** Determine if the data of the file read by ReadImageInformation()
+   * can be read by region. */
+  bool
+  CanStreamRead() override
+  {
+    return m_CanStreamRead;
+  }
+
+  /** Regions can be written unless the data is compressed or written as
+   * ASCII. */
+  bool
+  CanStreamWrite() override;
+
 protected:
   NrrdImageIO();
   ~NrrdImageIO() override;
@@ -109,7 +128,24 @@ protected:
   IOComponentEnum
   NrrdToITKComponentType(const int) const;
 
+  /** Returns the offset of the data in the data file. */
+  SizeType
+  GetHeaderSize() const override
+  {
+    return m_DataPosition;
+  }
+
   const NrrdEncoding_t * m_NrrdCompressionEncoding{ nullptr };
+
+private:
+  /** Writes the IORegion of the buffer into the data file, writing the
+   * header first if the file does not exist. */
+  void
+  StreamWrite(const void * buffer);
+
+  std::string m_DataFileName{};
+  SizeType    m_DataPosition{ 0 };
+  bool        m_CanStreamRead{ false };
 };
 } // end namespace itk
 
@@ -22,7 +22,9 @@
 #include "itkMetaDataObject.h"
 #include "itkIOCommon.h"
 #include "itkFloatingPointExceptions.h"
+#include "itksys/SystemTools.hxx"
 
+#include <cstdio>
 #include <sstream>
 
 namespace itk
@@ -278,8 +280,13 @@ NrrdImageIO::ReadImageInformation()
     }
 
     // this is the mechanism by which we tell nrrdLoad to read
-    // just the header, and none of the data
+    // just the header, and none of the data. The data file is kept
+    // open to find where the data starts.
     nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+    nrrdIoStateSet(nio, nrrdIoStateKeepNrrdDataFileOpen, 1);
+    m_DataFileName.clear();
+    m_DataPosition = 0;
+    m_CanStreamRead = false;
     if (nrrdLoad(nrrd, this->GetFileName(), nio) != 0)
     {
       char * err = biffGetDone(NRRD);
@@ -300,6 +307,25 @@ NrrdImageIO::ReadImageInformation()
       FloatingPointExceptions::SetEnabled(saveFPEState);
     }
 
+    if (nio->dataFile != nullptr)
+    {
+      // the data file is only kept open when there is a single one
+      if (nio->dataFNArr->len == 0)
+      {
+        m_DataFileName = this->GetFileName();
+      }
+      else if (itksys::SystemTools::FileIsFullPath(nio->dataFN[0]) || airStrlen(nio->path) == 0)
+      {
+        m_DataFileName = nio->dataFN[0];
+      }
+      else
+      {
+        m_DataFileName = std::string(nio->path) + '/' + nio->dataFN[0];
+      }
+      const long dataPosition = std::ftell(nio->dataFile);
+      m_DataPosition = dataPosition > 0 ? static_cast<SizeType>(dataPosition) : 0;
+      nio->dataFile = airFclose(nio->dataFile);
+    }
 
     if (nrrdTypeBlock == nrrd->type)
     {
@@ -448,6 +474,13 @@ NrrdImageIO::ReadImageInformation()
                                                           << " dependent axis (not 1); not currently handled");
     }
 
+    // regions can be read at their offsets when the raw data is laid out
+    // as in the ITK buffer
+    m_CanStreamRead = !m_DataFileName.empty() && nio->encoding == nrrdEncodingRaw &&
+                      (nrrdElementSize(nrrd) == 1 || nio->endian == airMyEndian()) &&
+                      (0 == rangeAxisNum ||
+                       (0 == rangeAxisIdx[0] && nrrdKind3DMaskedSymMatrix != nrrd->axis[0].kind));
+
     ;
 
     int iFlipFactors[3]; // used to flip the measurement frame later on
@@ -715,6 +748,14 @@ NrrdImageIO::ReadImageInformation()
 void
 NrrdImageIO::Read(void * buffer)
 {
+  if (m_CanStreamRead && this->RequestedToStream())
+  {
+    std::ifstream file;
+    this->OpenFileForReading(file, m_DataFileName);
+    this->StreamReadBufferAsBinary(file, buffer);
+    return;
+  }
+
   Nrrd * nrrd = nrrdNew();
   bool   nrrdAllocated;
 
@@ -886,9 +927,55 @@ _dump_metadata_to_stream(MetaDataDictionary & thisDic, const std::string & key,
   return false;
 }
 
+bool
+NrrdImageIO::CanStreamWrite()
+{
+  if (this->GetUseCompression() && this->m_NrrdCompressionEncoding != nullptr &&
+      this->m_NrrdCompressionEncoding->available())
+  {
+    return false;
+  }
+  const IOByteOrderEnum byteOrder = this->GetByteOrder();
+  if ((byteOrder == IOByteOrderEnum::BigEndian && airMyEndian() != airEndianBig) ||
+      (byteOrder == IOByteOrderEnum::LittleEndian && airMyEndian() != airEndianLittle))
+  {
+    return false;
+  }
+  return this->GetFileType() != IOFileEnum::ASCII;
+}
+
+void
+NrrdImageIO::StreamWrite(const void * buffer)
+{
+  // the header of the file tells where the data is
+  const auto headerImageIO = Self::New();
+  headerImageIO->SetFileName(this->GetFileName());
+  headerImageIO->ReadImageInformation();
+  if (!headerImageIO->CanStreamRead())
+  {
+    itkExceptionMacro("Write: Unable to write a region into " << this->GetFileName()
+                                                              << ", which does not have raw data in a single file");
+  }
+  m_DataFileName = headerImageIO->m_DataFileName;
+  m_DataPosition = headerImageIO->m_DataPosition;
+
+  std::ofstream file;
+  this->OpenFileForWriting(file, m_DataFileName, false);
+  this->StreamWriteBufferAsBinary(file, buffer);
+}
+
 void
 NrrdImageIO::Write(const void * buffer)
 {
+  // when streaming, the header is written along with the first region,
+  // and the following regions are written into the existing data
+  const bool streamWrite = this->RequestedToStream();
+  if (streamWrite && itksys::SystemTools::FileExists(this->GetFileName()))
+  {
+    this->StreamWrite(buffer);
+    return;
+  }
+
   Nrrd *        nrrd = nrrdNew();
   NrrdIoState * nio = nrrdIoStateNew();
   int           kind[NRRD_DIM_MAX];
@@ -1141,6 +1228,14 @@ NrrdImageIO::Write(const void * buffer)
       break;
   }
 
+  // When streaming, only the header is written here. The buffer only
+  // holds the IORegion, so it must not be read by nrrdSave.
+  if (streamWrite)
+  {
+    nio->endian = airMyEndian();
+    nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+  }
+
   // Write the nrrd to file.
   if (nrrdSave(this->GetFileName(), nrrd, nio))
   {
@@ -1148,9 +1243,45 @@ NrrdImageIO::Write(const void * buffer)
     itkExceptionMacro("Write: Error writing " << this->GetFileName() << ":\n" << err);
   }
 
+  if (streamWrite)
+  {
+    // allocate the data following the attached header, or in the detached
+    // data file, before the region is written into it
+    std::string dataFileName = this->GetFileName();
+    if (nio->dataFNArr->len > 0)
+    {
+      dataFileName = nio->dataFN[0];
+      if (!itksys::SystemTools::FileIsFullPath(dataFileName) && airStrlen(nio->path) != 0)
+      {
+        dataFileName = std::string(nio->path) + '/' + dataFileName;
+      }
+    }
+    const bool         attached = (dataFileName == this->GetFileName());
+    const std::streamoff dataSize = static_cast<std::streamoff>(nrrdElementNumber(nrrd) * nrrdElementSize(nrrd));
+
+    std::ofstream dataFile;
+    this->OpenFileForWriting(dataFile, dataFileName, !attached);
+    dataFile.seekp(0, std::ios::end);
+    if (dataSize > 0)
+    {
+      dataFile.seekp(dataSize - 1, std::ios::cur);
+      dataFile.put('\0');
+    }
+    if (dataFile.fail())
+    {
+      itkExceptionMacro("Write: Unable to allocate the data in " << dataFileName);
+    }
+    dataFile.close();
+  }
+
   // Free the nrrd struct but don't touch nrrd->data
   nrrdNix(nrrd);
   nrrdIoStateNix(nio);
+
+  if (streamWrite)
+  {
+    this->StreamWrite(buffer);
+  }
 }
 
 } // end namespace itk
@@ -0,0 +1,219 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkNrrdImageIO.h"
+#include "itkPipelineMonitorImageFilter.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+using PixelType = unsigned short;
+using ImageType = itk::Image<PixelType, 3>;
+
+// Records the regions read by all its instances, including the ones created
+// by the reader to read ahead.
+class CountingNrrdImageIO : public itk::NrrdImageIO
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(CountingNrrdImageIO);
+
+  using Self = CountingNrrdImageIO;
+  using Superclass = itk::NrrdImageIO;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+
+  itkOverrideGetNameOfClassMacro(CountingNrrdImageIO);
+
+  void
+  Read(void * buffer) override
+  {
+    {
+      const std::lock_guard<std::mutex> lock(m_ReadRegionsMutex);
+      m_ReadRegions.push_back(this->GetIORegion());
+    }
+    Superclass::Read(buffer);
+  }
+
+  static std::vector<itk::ImageIORegion>
+  GetReadRegions()
+  {
+    const std::lock_guard<std::mutex> lock(m_ReadRegionsMutex);
+    return m_ReadRegions;
+  }
+
+  static void
+  ClearReadRegions()
+  {
+    const std::lock_guard<std::mutex> lock(m_ReadRegionsMutex);
+    m_ReadRegions.clear();
+  }
+
+protected:
+  CountingNrrdImageIO() = default;
+  ~CountingNrrdImageIO() override = default;
+
+private:
+  static inline std::mutex                      m_ReadRegionsMutex{};
+  static inline std::vector<itk::ImageIORegion> m_ReadRegions{};
+};
+
+itk::ImageIORegion
+ToIORegion(const ImageType::RegionType & region)
+{
+  itk::ImageIORegion ioRegion(ImageType::ImageDimension);
+  itk::ImageIORegionAdaptor<ImageType::ImageDimension>::Convert(region, ioRegion, ImageType::IndexType{});
+  return ioRegion;
+}
+
+PixelType
+ExpectedValue(const ImageType::IndexType & index)
+{
+  return static_cast<PixelType>(index[0] + 7 * index[1] + 131 * index[2]);
+}
+
+bool
+HasExpectedValues(const ImageType * image)
+{
+  itk::ImageRegionConstIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() != ExpectedValue(it.GetIndex()))
+    {
+      std::cerr << "Unexpected value " << it.Get() << " at " << it.GetIndex() << ", expected "
+                << ExpectedValue(it.GetIndex()) << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+// Streams an image from a reader reading ahead to a writer writing behind,
+// checks that each region is read from the file exactly once, and checks the
+// written file.
+int
+itkNrrdImageIOReadAheadWriteBehindTest(int argc, char * argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv);
+    std::cerr << " input output" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const ImageType::RegionType region({ { 0, 0, 0 } }, { { 23, 17, 19 } });
+
+  auto image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    it.Set(ExpectedValue(it.GetIndex()));
+  }
+  ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(image, argv[1]));
+
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(argv[1]);
+  reader->SetImageIO(CountingNrrdImageIO::New());
+  reader->UseStreamingOn();
+
+  ITK_TEST_SET_GET_BOOLEAN(reader, UseReadAhead, true);
+
+  using MonitorFilterType = itk::PipelineMonitorImageFilter<ImageType>;
+  auto monitor = MonitorFilterType::New();
+  monitor->SetInput(reader->GetOutput());
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(monitor->GetOutput());
+  writer->SetFileName(argv[2]);
+  writer->SetNumberOfStreamDivisions(5);
+
+  ITK_TEST_SET_GET_BOOLEAN(writer, UseWriteBehind, true);
+
+  CountingNrrdImageIO::ClearReadRegions();
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  if (!monitor->VerifyAllInputCanStream(5))
+  {
+    std::cerr << "Test failed! The pipeline did not stream as expected." << std::endl;
+    std::cerr << monitor;
+    return EXIT_FAILURE;
+  }
+
+  // Each region but the first one was read ahead while the previous one was
+  // written, and is not read again.
+  const MonitorFilterType::RegionVectorType updatedRegions = monitor->GetUpdatedBufferedRegions();
+  const std::vector<itk::ImageIORegion>     readRegions = CountingNrrdImageIO::GetReadRegions();
+  ITK_TEST_EXPECT_EQUAL(readRegions.size(), updatedRegions.size());
+  for (const ImageType::RegionType & updatedRegion : updatedRegions)
+  {
+    if (std::count(readRegions.cbegin(), readRegions.cend(), ToIORegion(updatedRegion)) != 1)
+    {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "The region " << updatedRegion << " was not read exactly once." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Reading the pieces again in reverse order does not match the prediction
+  // of the read ahead, which must then be discarded and the piece read.
+  ImageType::RegionType pieceRegion = region;
+  pieceRegion.SetSize(2, 4);
+  for (itk::IndexValueType z = 15; z >= 0; z -= 5)
+  {
+    pieceRegion.SetIndex(2, z);
+    reader->GetOutput()->SetRequestedRegion(pieceRegion);
+    CountingNrrdImageIO::ClearReadRegions();
+    ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+    ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetBufferedRegion(), pieceRegion);
+    const std::vector<itk::ImageIORegion> pieceReadRegions = CountingNrrdImageIO::GetReadRegions();
+    ITK_TEST_EXPECT_TRUE(std::count(pieceReadRegions.cbegin(), pieceReadRegions.cend(), ToIORegion(pieceRegion)) == 1);
+    if (!HasExpectedValues(reader->GetOutput()))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  // A failure of a write in the background is reported by the update, and
+  // does not affect the next one.
+  const std::string outputFileName = argv[2];
+  writer->SetFileName(outputFileName + ".missing/output.nhdr");
+  ITK_TRY_EXPECT_EXCEPTION(writer->Update());
+  writer->SetFileName(outputFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  const auto written = itk::ReadImage<ImageType>(argv[2]);
+  ITK_TEST_EXPECT_EQUAL(written->GetLargestPossibleRegion(), region);
+  if (!HasExpectedValues(written))
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
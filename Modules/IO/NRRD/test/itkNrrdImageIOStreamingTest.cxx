@@ -0,0 +1,185 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkByteSwapper.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkNrrdImageIO.h"
+#include "itkPipelineMonitorImageFilter.h"
+#include "itkTestingMacros.h"
+#include "itksys/SystemTools.hxx"
+
+#include <fstream>
+
+namespace
+{
+using PixelType = unsigned short;
+using ImageType = itk::Image<PixelType, 3>;
+
+PixelType
+ExpectedValue(const ImageType::IndexType & index)
+{
+  return static_cast<PixelType>(index[0] + 5 * index[1] + 97 * index[2]);
+}
+
+bool
+HasExpectedValues(const ImageType * image)
+{
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() != ExpectedValue(it.GetIndex()))
+    {
+      std::cerr << "Unexpected value " << it.Get() << " at " << it.GetIndex() << ", expected "
+                << ExpectedValue(it.GetIndex()) << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the text of the header of a NRRD file, which ends with an empty
+// line when the data is attached.
+std::string
+ReadHeader(const std::string & fileName)
+{
+  std::ifstream file(fileName, std::ios::binary);
+  std::string   header;
+  for (std::string line; std::getline(file, line) && !line.empty();)
+  {
+    header += line + '\n';
+  }
+  return header;
+}
+
+// Writes the image from a streaming reader in four stream divisions, and
+// returns the number of pieces in which the input was updated.
+unsigned int
+StreamWrite(const std::string & inputFileName, const std::string & outputFileName, bool useCompression)
+{
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(inputFileName);
+  reader->UseStreamingOn();
+
+  auto monitor = itk::PipelineMonitorImageFilter<ImageType>::New();
+  monitor->SetInput(reader->GetOutput());
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(monitor->GetOutput());
+  writer->SetFileName(outputFileName);
+  writer->SetUseCompression(useCompression);
+  writer->SetNumberOfStreamDivisions(4);
+  writer->Update();
+
+  return monitor->GetNumberOfUpdates();
+}
+} // namespace
+
+// Checks the NRRD specific parts of streamed writing: the layout of the
+// attached and detached data, and the fallback to writing the whole image for
+// the encodings which cannot be streamed.
+int
+itkNrrdImageIOStreamingTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string prefix = std::string(argv[1]) + "/itkNrrdImageIOStreamingTest";
+
+  const ImageType::RegionType region(ImageType::SizeType{ { 17, 13, 11 } });
+  const auto                  dataSize = static_cast<unsigned long>(region.GetNumberOfPixels() * sizeof(PixelType));
+
+  auto image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    it.Set(ExpectedValue(it.GetIndex()));
+  }
+  const std::string inputFileName = prefix + "Input.nrrd";
+  ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(image, inputFileName));
+
+  // The attached data follows the header.
+  const std::string attachedFileName = prefix + "Attached.nrrd";
+  ITK_TEST_EXPECT_EQUAL(StreamWrite(inputFileName, attachedFileName, false), 4u);
+  ITK_TEST_EXPECT_EQUAL(itksys::SystemTools::FileLength(attachedFileName),
+                        ReadHeader(attachedFileName).size() + 1 + dataSize);
+  if (!HasExpectedValues(itk::ReadImage<ImageType>(attachedFileName)))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // The detached data file replaces a larger stale data file, and the header
+  // refers to it.
+  const std::string detachedFileName = prefix + "Detached.nhdr";
+  const std::string dataFileName = prefix + "Detached.raw";
+  {
+    std::ofstream staleDataFile(dataFileName, std::ios::binary);
+    staleDataFile << std::string(2 * dataSize, 'x');
+  }
+  ITK_TEST_EXPECT_EQUAL(StreamWrite(inputFileName, detachedFileName, false), 4u);
+  ITK_TEST_EXPECT_TRUE(ReadHeader(detachedFileName).find("data file: itkNrrdImageIOStreamingTestDetached.raw") !=
+                       std::string::npos);
+  ITK_TEST_EXPECT_EQUAL(itksys::SystemTools::FileLength(dataFileName), dataSize);
+  if (!HasExpectedValues(itk::ReadImage<ImageType>(detachedFileName)))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Compressed data cannot be streamed, and the image is written in one
+  // piece.
+  auto nrrdIO = itk::NrrdImageIO::New();
+  nrrdIO->SetUseCompression(false);
+  ITK_TEST_EXPECT_TRUE(nrrdIO->CanStreamWrite());
+  nrrdIO->SetUseCompression(true);
+  ITK_TEST_EXPECT_TRUE(!nrrdIO->CanStreamWrite());
+
+  const std::string compressedFileName = prefix + "Compressed.nrrd";
+  ITK_TEST_EXPECT_EQUAL(StreamWrite(inputFileName, compressedFileName, true), 1u);
+  ITK_TEST_EXPECT_TRUE(ReadHeader(compressedFileName).find("encoding: gzip") != std::string::npos);
+  if (!HasExpectedValues(itk::ReadImage<ImageType>(compressedFileName)))
+  {
+    return EXIT_FAILURE;
+  }
+
+  nrrdIO->SetFileName(compressedFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(nrrdIO->ReadImageInformation());
+  ITK_TEST_EXPECT_TRUE(!nrrdIO->CanStreamRead());
+
+  // Neither can the ASCII encoding, nor a byte order other than the native
+  // one.
+  nrrdIO->SetUseCompression(false);
+  nrrdIO->SetFileTypeToASCII();
+  ITK_TEST_EXPECT_TRUE(!nrrdIO->CanStreamWrite());
+  nrrdIO->SetFileTypeToBinary();
+  if (itk::ByteSwapper<PixelType>::SystemIsBigEndian())
+  {
+    nrrdIO->SetByteOrderToLittleEndian();
+  }
+  else
+  {
+    nrrdIO->SetByteOrderToBigEndian();
+  }
+  ITK_TEST_EXPECT_TRUE(!nrrdIO->CanStreamWrite());
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,253 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkZarrImageIO_h
+#define itkZarrImageIO_h
+#include "ITKIOZarrExport.h"
+
+#include "itkImageIOBase.h"
+#include "itkMultiThreaderBase.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+/**
+ * \class ZarrImageIO
+ *
+ * \brief ImageIO for chunked arrays stored in a Zarr directory store.
+ *
+ * Both Zarr v2 (".zarray"/".zgroup"/".zattrs") and Zarr v3 ("zarr.json")
+ * metadata are supported. The file name is the path of the store
+ * directory, usually ending in ".zarr" or ".ome.zarr". The directory may
+ * either hold a single array, or an OME-Zarr (NGFF) multiscale group in
+ * which case SetLevel() selects the resolution level that is read or
+ * written. Spacing and origin are stored as the "scale" and "translation"
+ * coordinate transformations of the multiscale dataset; the direction
+ * cosines cannot be represented and are read as identity. Writing a level
+ * only replaces the array of that level, and keeps the rest of the store,
+ * such as the other levels or OME-Zarr labels.
+ *
+ * Chunks may be uncompressed, or compressed with the "zlib" or "gzip"
+ * codecs. Arrays encoded with codecs that are not available in ITK
+ * (e.g. blosc, zstd) are reported with an exception.
+ *
+ * The array is stored in C order, so the last Zarr axis corresponds to
+ * the first (fastest) ITK dimension. Multi-component pixels are stored on
+ * a separate "channel" axis preceding the spatial axes. A channel axis which
+ * is split in several chunks is read as an additional spatial dimension of
+ * unit spacing.
+ *
+ * Any region can be read or written, so this ImageIO supports streaming
+ * and pasting. Only the chunks intersecting the requested region are
+ * touched, and these are encoded or decoded concurrently by a
+ * MultiThreaderBase owned by the ImageIO, in NumberOfWorkUnits work units.
+ * Chunks that are only partially covered by a written
+ * region are read back and merged.
+ *
+ * \sa ImageFileWriter ImageFileReader ImageIOBase
+ * \ingroup IOFilters
+ * \ingroup ITKIOZarr
+ */
+class ITKIOZarr_EXPORT ZarrImageIO : public ImageIOBase
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ZarrImageIO);
+
+  /** Standard class type aliases. */
+  using Self = ZarrImageIO;
+  using Superclass = ImageIOBase;
+  using Pointer = SmartPointer<Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(ZarrImageIO);
+
+  /** Zarr arrays are n-dimensional. */
+  bool
+  SupportsDimension(unsigned long) override
+  {
+    return true;
+  }
+
+  /** Set/Get the Zarr format version (2 or 3) used when writing. When
+   * reading, the version is set from the metadata found in the store. */
+  itkSetClampMacro(ZarrFormat, unsigned int, 2, 3);
+  itkGetConstMacro(ZarrFormat, unsigned int);
+
+  /** Set/Get the edge length of the chunks along every dimension used when
+   * writing. Chunks are clipped to the size of the image. */
+  itkSetClampMacro(ChunkSize, SizeValueType, 1, NumericTraits<SizeValueType>::max());
+  itkGetConstMacro(ChunkSize, SizeValueType);
+
+  /** Set/Get the multiscale level which is read or written. Level 0 is
+   * the full resolution. Writing a level greater than 0 requires that the
+   * lower levels already exist in the store. */
+  itkSetMacro(Level, unsigned int);
+  itkGetConstMacro(Level, unsigned int);
+
+  /** Get the number of multiscale levels found by ReadImageInformation(). */
+  itkGetConstMacro(NumberOfLevels, unsigned int);
+
+  /** Set/Get the number of work units in which the chunks are read or
+   * written. Defaults to the global default number of threads. */
+  itkSetClampMacro(NumberOfWorkUnits, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfWorkUnits, ThreadIdType);
+
+  /*-------- This part of the interfaces deals with reading data. ----- */
+
+  /** Determine if the directory is a Zarr store which can be read. */
+  bool
+  CanReadFile(const char *) override;
+
+  /** Read the array metadata of the selected level. */
+  void
+  ReadImageInformation() override;
+
+  /** Read the IORegion from the chunks into the buffer. */
+  void
+  Read(void * buffer) override;
+
+  /** Any region can be read. */
+  bool
+  CanStreamRead() override
+  {
+    return true;
+  }
+
+  /** Returns the requested region when streamed reading is enabled. */
+  ImageIORegion
+  GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const override;
+
+  /*-------- This part of the interfaces deals with writing data. ----- */
+
+  /** Determine if the file name has a Zarr extension. */
+  bool
+  CanWriteFile(const char *) override;
+
+  /** The metadata is written along with the data by Write(). */
+  void
+  WriteImageInformation() override
+  {}
+
+  /** Write the metadata and the chunks intersecting the IORegion. */
+  void
+  Write(const void * buffer) override;
+
+  /** Any region can be written. */
+  bool
+  CanStreamWrite() override
+  {
+    return true;
+  }
+
+  /** Verifies that an existing array is compatible when pasting. When a
+   * new image is written, removes the metadata and chunks of the previous
+   * array of the level, and throws if its directory holds other files. */
+  unsigned int
+  GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                    const ImageIORegion & pasteRegion,
+                                    const ImageIORegion & largestPossibleRegion) override;
+
+protected:
+  ZarrImageIO();
+  ~ZarrImageIO() override;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  void
+  InternalSetCompressor(const std::string & _compressor) override;
+
+private:
+  enum class CodecEnum : uint8_t
+  {
+    None,
+    Zlib,
+    Gzip
+  };
+
+  /** Description of the on-disk layout of one Zarr array. */
+  struct ArrayLayout
+  {
+    std::string                m_Path;
+    std::vector<SizeValueType> m_Shape;
+    std::vector<SizeValueType> m_Chunks;
+    /** ITK dimension of each Zarr axis, or -1 for the channel axis. */
+    std::vector<int> m_AxisToDimension;
+    std::string      m_KeyPrefix;
+    char             m_KeySeparator{ '.' };
+    CodecEnum        m_Codec{ CodecEnum::None };
+    int              m_CodecLevel{ 1 };
+    bool             m_BigEndian{ false };
+    double           m_FillValue{ 0.0 };
+  };
+
+  /** Path of the store directory, without trailing separators. */
+  std::string
+  GetStorePath(const char * fileName) const;
+
+  void
+  ReadArrayMetadata(const std::string & arrayPath, unsigned int version);
+
+  void
+  WriteMetadata();
+
+  /** Builds m_Layout for writing from the image information. */
+  void
+  InitializeLayoutForWriting(const std::string & arrayPath);
+
+  std::string
+  GetChunkFileName(const std::vector<SizeValueType> & chunkIndex) const;
+
+  /** Returns false if the chunk does not exist. */
+  bool
+  ReadChunk(const std::string & fileName, std::vector<char> & chunk) const;
+
+  void
+  WriteChunk(const std::string & fileName, std::vector<char> & chunk) const;
+
+  void
+  FillChunk(std::vector<char> & chunk) const;
+
+  /** Calls func with the index of every chunk intersecting the IORegion,
+   * in parallel. */
+  void
+  ProcessChunksInIORegion(const std::function<void(const std::vector<SizeValueType> &)> & func) const;
+
+  /** Copies the intersection of the chunk and the IORegion between the
+   * chunk and the region buffer. */
+  void
+  CopyChunkRegion(const std::vector<SizeValueType> & chunkIndex, char * chunk, char * buffer, bool toChunk) const;
+
+  unsigned int  m_ZarrFormat{ 2 };
+  SizeValueType m_ChunkSize{ 64 };
+  unsigned int  m_Level{ 0 };
+  unsigned int  m_NumberOfLevels{ 0 };
+  CodecEnum     m_WriteCodec{ CodecEnum::Zlib };
+  ArrayLayout   m_Layout{};
+
+  MultiThreaderBase::Pointer m_MultiThreader{};
+  ThreadIdType               m_NumberOfWorkUnits{};
+};
+} // end namespace itk
+
+#endif // itkZarrImageIO_h
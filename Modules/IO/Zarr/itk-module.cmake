@@ -0,0 +1,19 @@
+set(DOCUMENTATION "This module contains an ImageIO class for reading and
+writing chunked arrays stored in the Zarr (v2 and v3) directory store format,
+including OME-Zarr multiscale groups. Chunks are encoded and decoded
+concurrently and arbitrary regions can be streamed.")
+
+itk_module(
+  ITKIOZarr
+  ENABLE_SHARED
+  DEPENDS
+  ITKIOImageBase
+  PRIVATE_DEPENDS
+  ITKZLIB
+  TEST_DEPENDS
+  ITKTestKernel
+  ITKImageSources
+  FACTORY_NAMES
+  ImageIO::Zarr
+  DESCRIPTION
+  "${DOCUMENTATION}")
@@ -0,0 +1,1975 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkZarrImageIO.h"
+#include "itkByteSwapper.h"
+#include "itkMultiThreaderBase.h"
+#include "itksys/Directory.hxx"
+#include "itksys/SystemTools.hxx"
+#include "itk_zlib.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <locale>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+namespace itk
+{
+namespace
+{
+/** Minimal JSON document model, sufficient for the Zarr and OME-Zarr
+ * metadata. Object members keep their order so that rewritten metadata
+ * stays close to the original. */
+class JsonValue
+{
+public:
+  enum class KindEnum : uint8_t
+  {
+    Null,
+    Bool,
+    Number,
+    String,
+    Array,
+    Object
+  };
+
+  JsonValue() = default;
+
+  static JsonValue
+  MakeNumber(double value)
+  {
+    JsonValue v;
+    v.m_Kind = KindEnum::Number;
+    v.m_Number = value;
+    return v;
+  }
+
+  static JsonValue
+  MakeString(const std::string & value)
+  {
+    JsonValue v;
+    v.m_Kind = KindEnum::String;
+    v.m_String = value;
+    return v;
+  }
+
+  static JsonValue
+  MakeArray()
+  {
+    JsonValue v;
+    v.m_Kind = KindEnum::Array;
+    return v;
+  }
+
+  static JsonValue
+  MakeObject()
+  {
+    JsonValue v;
+    v.m_Kind = KindEnum::Object;
+    return v;
+  }
+
+  template <typename TContainer>
+  static JsonValue
+  MakeNumberArray(const TContainer & values)
+  {
+    JsonValue v = MakeArray();
+    for (const auto & value : values)
+    {
+      v.m_Array.push_back(MakeNumber(static_cast<double>(value)));
+    }
+    return v;
+  }
+
+  KindEnum
+  GetKind() const
+  {
+    return m_Kind;
+  }
+
+  bool
+  IsNull() const
+  {
+    return m_Kind == KindEnum::Null;
+  }
+
+  double
+  GetNumber() const
+  {
+    if (m_Kind != KindEnum::Number)
+    {
+      throw std::runtime_error("JSON number expected");
+    }
+    return m_Number;
+  }
+
+  const std::string &
+  GetString() const
+  {
+    if (m_Kind != KindEnum::String)
+    {
+      throw std::runtime_error("JSON string expected");
+    }
+    return m_String;
+  }
+
+  const std::vector<JsonValue> &
+  GetArray() const
+  {
+    if (m_Kind != KindEnum::Array)
+    {
+      throw std::runtime_error("JSON array expected");
+    }
+    return m_Array;
+  }
+
+  std::vector<JsonValue> &
+  GetArray()
+  {
+    if (m_Kind != KindEnum::Array)
+    {
+      throw std::runtime_error("JSON array expected");
+    }
+    return m_Array;
+  }
+
+  std::vector<SizeValueType>
+  GetSizeArray() const
+  {
+    std::vector<SizeValueType> result;
+    for (const auto & element : this->GetArray())
+    {
+      const double value = element.GetNumber();
+      if (value < 0.0)
+      {
+        throw std::runtime_error("Non-negative JSON integer expected");
+      }
+      result.push_back(static_cast<SizeValueType>(value));
+    }
+    return result;
+  }
+
+  std::vector<double>
+  GetNumberArray() const
+  {
+    std::vector<double> result;
+    for (const auto & element : this->GetArray())
+    {
+      result.push_back(element.GetNumber());
+    }
+    return result;
+  }
+
+  /** Returns the member named key, or nullptr if this is not an object or
+   * the member does not exist. */
+  const JsonValue *
+  Find(const std::string & key) const
+  {
+    if (m_Kind == KindEnum::Object)
+    {
+      for (const auto & member : m_Object)
+      {
+        if (member.first == key)
+        {
+          return &member.second;
+        }
+      }
+    }
+    return nullptr;
+  }
+
+  JsonValue *
+  Find(const std::string & key)
+  {
+    return const_cast<JsonValue *>(static_cast<const JsonValue *>(this)->Find(key));
+  }
+
+  const JsonValue &
+  Get(const std::string & key) const
+  {
+    const JsonValue * member = this->Find(key);
+    if (member == nullptr)
+    {
+      throw std::runtime_error("Missing JSON member \"" + key + '"');
+    }
+    return *member;
+  }
+
+  /** Sets or replaces the member named key. */
+  void
+  Set(const std::string & key, JsonValue value)
+  {
+    if (m_Kind != KindEnum::Object)
+    {
+      throw std::runtime_error("JSON object expected");
+    }
+    if (JsonValue * member = this->Find(key))
+    {
+      *member = std::move(value);
+      return;
+    }
+    m_Object.emplace_back(key, std::move(value));
+  }
+
+  void
+  Append(JsonValue value)
+  {
+    this->GetArray().push_back(std::move(value));
+  }
+
+  static JsonValue
+  Parse(const std::string & text)
+  {
+    size_t     pos = 0;
+    JsonValue  result = ParseValue(text, pos);
+    SkipSpace(text, pos);
+    if (pos != text.size())
+    {
+      throw std::runtime_error("Unexpected trailing characters in JSON");
+    }
+    return result;
+  }
+
+  void
+  Serialize(std::ostream & os) const
+  {
+    switch (m_Kind)
+    {
+      case KindEnum::Null:
+        os << "null";
+        break;
+      case KindEnum::Bool:
+        os << (m_Bool ? "true" : "false");
+        break;
+      case KindEnum::Number:
+        if (std::isnan(m_Number))
+        {
+          os << "\"NaN\"";
+        }
+        else if (std::isinf(m_Number))
+        {
+          os << (m_Number > 0 ? "\"Infinity\"" : "\"-Infinity\"");
+        }
+        else if (m_Number == std::floor(m_Number) && std::abs(m_Number) < 1e15)
+        {
+          os << static_cast<long long>(m_Number);
+        }
+        else
+        {
+          os << std::setprecision(std::numeric_limits<double>::max_digits10) << m_Number;
+        }
+        break;
+      case KindEnum::String:
+        SerializeString(os, m_String);
+        break;
+      case KindEnum::Array:
+      {
+        os << '[';
+        for (size_t i = 0; i < m_Array.size(); ++i)
+        {
+          os << (i ? ", " : "");
+          m_Array[i].Serialize(os);
+        }
+        os << ']';
+        break;
+      }
+      case KindEnum::Object:
+      {
+        os << '{';
+        for (size_t i = 0; i < m_Object.size(); ++i)
+        {
+          os << (i ? ", " : "");
+          SerializeString(os, m_Object[i].first);
+          os << ": ";
+          m_Object[i].second.Serialize(os);
+        }
+        os << '}';
+        break;
+      }
+    }
+  }
+
+private:
+  static void
+  SkipSpace(const std::string & text, size_t & pos)
+  {
+    while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos])))
+    {
+      ++pos;
+    }
+  }
+
+  static void
+  Expect(const std::string & text, size_t & pos, const char * literal)
+  {
+    const size_t length = std::strlen(literal);
+    if (text.compare(pos, length, literal) != 0)
+    {
+      throw std::runtime_error(std::string("Expected \"") + literal + "\" in JSON");
+    }
+    pos += length;
+  }
+
+  static std::string
+  ParseString(const std::string & text, size_t & pos)
+  {
+    Expect(text, pos, "\"");
+    std::string result;
+    while (pos < text.size() && text[pos] != '"')
+    {
+      char c = text[pos++];
+      if (c == '\\')
+      {
+        if (pos >= text.size())
+        {
+          break;
+        }
+        c = text[pos++];
+        switch (c)
+        {
+          case 'b':
+            c = '\b';
+            break;
+          case 'f':
+            c = '\f';
+            break;
+          case 'n':
+            c = '\n';
+            break;
+          case 'r':
+            c = '\r';
+            break;
+          case 't':
+            c = '\t';
+            break;
+          case 'u':
+          {
+            // Only code points of the Basic Latin block are expected in the
+            // metadata, others are replaced.
+            const unsigned long codePoint = std::stoul(text.substr(pos, 4), nullptr, 16);
+            pos += 4;
+            c = codePoint < 0x80 ? static_cast<char>(codePoint) : '?';
+            break;
+          }
+          default:
+            break;
+        }
+      }
+      result += c;
+    }
+    Expect(text, pos, "\"");
+    return result;
+  }
+
+  static JsonValue
+  ParseValue(const std::string & text, size_t & pos)
+  {
+    SkipSpace(text, pos);
+    if (pos >= text.size())
+    {
+      throw std::runtime_error("Unexpected end of JSON");
+    }
+
+    JsonValue  result;
+    const char c = text[pos];
+    if (c == '{')
+    {
+      result.m_Kind = KindEnum::Object;
+      ++pos;
+      SkipSpace(text, pos);
+      if (pos < text.size() && text[pos] == '}')
+      {
+        ++pos;
+        return result;
+      }
+      while (true)
+      {
+        SkipSpace(text, pos);
+        std::string key = ParseString(text, pos);
+        SkipSpace(text, pos);
+        Expect(text, pos, ":");
+        result.m_Object.emplace_back(std::move(key), ParseValue(text, pos));
+        SkipSpace(text, pos);
+        if (pos < text.size() && text[pos] == ',')
+        {
+          ++pos;
+          continue;
+        }
+        Expect(text, pos, "}");
+        return result;
+      }
+    }
+    if (c == '[')
+    {
+      result.m_Kind = KindEnum::Array;
+      ++pos;
+      SkipSpace(text, pos);
+      if (pos < text.size() && text[pos] == ']')
+      {
+        ++pos;
+        return result;
+      }
+      while (true)
+      {
+        result.m_Array.push_back(ParseValue(text, pos));
+        SkipSpace(text, pos);
+        if (pos < text.size() && text[pos] == ',')
+        {
+          ++pos;
+          continue;
+        }
+        Expect(text, pos, "]");
+        return result;
+      }
+    }
+    if (c == '"')
+    {
+      result.m_Kind = KindEnum::String;
+      result.m_String = ParseString(text, pos);
+      return result;
+    }
+    if (c == 't' || c == 'f')
+    {
+      result.m_Kind = KindEnum::Bool;
+      result.m_Bool = (c == 't');
+      Expect(text, pos, result.m_Bool ? "true" : "false");
+      return result;
+    }
+    if (c == 'n')
+    {
+      Expect(text, pos, "null");
+      return result;
+    }
+
+    // Numbers are parsed in the classic locale, since JSON always uses a
+    // period as decimal separator.
+    const size_t       end = std::min(text.find_first_not_of("+-.0123456789Ee", pos), text.size());
+    std::istringstream number(text.substr(pos, end - pos));
+    number.imbue(std::locale::classic());
+    result.m_Kind = KindEnum::Number;
+    number >> result.m_Number;
+    if (end == pos || number.fail() || !number.eof())
+    {
+      throw std::runtime_error("Invalid JSON value");
+    }
+    pos = end;
+    return result;
+  }
+
+  static void
+  SerializeString(std::ostream & os, const std::string & value)
+  {
+    os << '"';
+    for (const char c : value)
+    {
+      if (c == '"' || c == '\\')
+      {
+        os << '\\';
+      }
+      os << c;
+    }
+    os << '"';
+  }
+
+  KindEnum                                      m_Kind{ KindEnum::Null };
+  bool                                          m_Bool{ false };
+  double                                        m_Number{ 0.0 };
+  std::string                                   m_String{};
+  std::vector<JsonValue>                        m_Array{};
+  std::vector<std::pair<std::string, JsonValue>> m_Object{};
+};
+
+bool
+ReadTextFile(const std::string & fileName, std::string & text)
+{
+  std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  if (!file.is_open())
+  {
+    return false;
+  }
+  std::ostringstream contents;
+  contents << file.rdbuf();
+  text = contents.str();
+  return true;
+}
+
+JsonValue
+ReadJsonFile(const std::string & fileName)
+{
+  std::string text;
+  if (!ReadTextFile(fileName, text))
+  {
+    throw std::runtime_error("Unable to open " + fileName);
+  }
+  return JsonValue::Parse(text);
+}
+
+void
+WriteJsonFile(const std::string & fileName, const JsonValue & value)
+{
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file.is_open())
+  {
+    throw std::runtime_error("Unable to open " + fileName + " for writing");
+  }
+  file.imbue(std::locale::classic());
+  value.Serialize(file);
+  file << '\n';
+  if (file.fail())
+  {
+    throw std::runtime_error("Unable to write " + fileName);
+  }
+}
+
+double
+ParseFillValue(const JsonValue & value)
+{
+  if (value.GetKind() == JsonValue::KindEnum::String)
+  {
+    const std::string & s = value.GetString();
+    if (s == "NaN")
+    {
+      return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (s == "Infinity")
+    {
+      return std::numeric_limits<double>::infinity();
+    }
+    if (s == "-Infinity")
+    {
+      return -std::numeric_limits<double>::infinity();
+    }
+    return 0.0;
+  }
+  if (value.GetKind() == JsonValue::KindEnum::Number)
+  {
+    return value.GetNumber();
+  }
+  return 0.0;
+}
+
+/** Finds the OME-Zarr multiscales description in the group attributes,
+ * either at the top level (NGFF <= 0.4) or in the "ome" member (NGFF 0.5). */
+const JsonValue *
+FindMultiscales(const JsonValue & attributes)
+{
+  if (const JsonValue * ome = attributes.Find("ome"))
+  {
+    if (const JsonValue * multiscales = ome->Find("multiscales"))
+    {
+      return multiscales;
+    }
+  }
+  return attributes.Find("multiscales");
+}
+
+/** Returns whether the directory holds a Zarr array, rather than a group. */
+bool
+IsArrayDirectory(const std::string & path)
+{
+  if (itksys::SystemTools::FileExists(path + "/.zarray", true))
+  {
+    return true;
+  }
+  if (!itksys::SystemTools::FileExists(path + "/zarr.json", true))
+  {
+    return false;
+  }
+  try
+  {
+    const JsonValue * nodeType = ReadJsonFile(path + "/zarr.json").Find("node_type");
+    return nodeType != nullptr && nodeType->GetKind() == JsonValue::KindEnum::String &&
+           nodeType->GetString() == "array";
+  }
+  catch (const std::runtime_error &)
+  {
+    return false;
+  }
+}
+
+/** Collects the metadata and chunk files of the Zarr array stored in the
+ * directory, and the directories of its nested chunk keys, children before
+ * their parents. Returns false if the directory holds anything else. */
+bool
+CollectArrayEntries(const std::string &        path,
+                    bool                       isArrayRoot,
+                    std::vector<std::string> & files,
+                    std::vector<std::string> & directories)
+{
+  itksys::Directory directory;
+  if (!directory.Load(path))
+  {
+    return false;
+  }
+  for (unsigned long i = 0; i < directory.GetNumberOfFiles(); ++i)
+  {
+    const std::string name = directory.GetFile(i);
+    if (name == "." || name == "..")
+    {
+      continue;
+    }
+    const std::string entry = path + '/' + name;
+    if (isArrayRoot && (name == ".zarray" || name == ".zattrs" || name == "zarr.json"))
+    {
+      files.push_back(entry);
+      continue;
+    }
+
+    // Chunk keys are made of chunk indices, with the "c" prefix of Zarr v3.
+    if (name != "c" && name.find_first_not_of("0123456789.") != std::string::npos)
+    {
+      return false;
+    }
+    if (itksys::SystemTools::FileIsDirectory(entry) && !itksys::SystemTools::FileIsSymlink(entry))
+    {
+      if (!CollectArrayEntries(entry, false, files, directories))
+      {
+        return false;
+      }
+      directories.push_back(entry);
+    }
+    else
+    {
+      files.push_back(entry);
+    }
+  }
+  return true;
+}
+
+template <typename T>
+void
+FillBuffer(std::vector<char> & chunk, double value)
+{
+  const T      typedValue = static_cast<T>(value);
+  const size_t n = chunk.size() / sizeof(T);
+  auto *       p = reinterpret_cast<T *>(chunk.data());
+  std::fill(p, p + n, typedValue);
+}
+
+void
+SwapBytes(char * data, size_t size, unsigned int componentSize)
+{
+  if (componentSize <= 1)
+  {
+    return;
+  }
+  for (char * p = data; p + componentSize <= data + size; p += componentSize)
+  {
+    std::reverse(p, p + componentSize);
+  }
+}
+
+void
+DecompressZlib(const std::vector<char> & source, std::vector<char> & destination)
+{
+  z_stream stream{};
+  stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(source.data()));
+  stream.avail_in = static_cast<uInt>(source.size());
+  stream.next_out = reinterpret_cast<Bytef *>(destination.data());
+  stream.avail_out = static_cast<uInt>(destination.size());
+
+  // 15 + 32 enables the automatic detection of the zlib and gzip headers
+  if (inflateInit2(&stream, 15 + 32) != Z_OK)
+  {
+    throw std::runtime_error("Unable to initialize zlib decompression");
+  }
+  const int    status = inflate(&stream, Z_FINISH);
+  const size_t decodedSize = stream.total_out;
+  inflateEnd(&stream);
+  if (status != Z_STREAM_END || decodedSize != destination.size())
+  {
+    throw std::runtime_error("Corrupted compressed chunk");
+  }
+}
+
+void
+CompressZlib(const std::vector<char> & source, std::vector<char> & destination, int level, bool gzip)
+{
+  z_stream stream{};
+  if (deflateInit2(&stream, level, Z_DEFLATED, gzip ? 15 + 16 : 15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+  {
+    throw std::runtime_error("Unable to initialize zlib compression");
+  }
+  destination.resize(deflateBound(&stream, static_cast<uLong>(source.size())));
+  stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(source.data()));
+  stream.avail_in = static_cast<uInt>(source.size());
+  stream.next_out = reinterpret_cast<Bytef *>(destination.data());
+  stream.avail_out = static_cast<uInt>(destination.size());
+  const int status = deflate(&stream, Z_FINISH);
+  destination.resize(stream.total_out);
+  deflateEnd(&stream);
+  if (status != Z_STREAM_END)
+  {
+    throw std::runtime_error("Unable to compress chunk");
+  }
+}
+} // namespace
+
+ZarrImageIO::ZarrImageIO()
+{
+  this->SetNumberOfDimensions(3);
+
+  const char * extensions[] = { ".zarr" };
+
+  for (auto ext : extensions)
+  {
+    this->AddSupportedWriteExtension(ext);
+    this->AddSupportedReadExtension(ext);
+  }
+
+  this->Self::SetCompressor("");
+  this->Self::SetMaximumCompressionLevel(9);
+  this->Self::SetCompressionLevel(2);
+
+  m_MultiThreader = MultiThreaderBase::New();
+  m_NumberOfWorkUnits = m_MultiThreader->GetNumberOfWorkUnits();
+}
+
+ZarrImageIO::~ZarrImageIO() = default;
+
+void
+ZarrImageIO::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "ZarrFormat: " << m_ZarrFormat << std::endl;
+  os << indent << "ChunkSize: " << m_ChunkSize << std::endl;
+  os << indent << "Level: " << m_Level << std::endl;
+  os << indent << "NumberOfLevels: " << m_NumberOfLevels << std::endl;
+  os << indent << "NumberOfWorkUnits: " << m_NumberOfWorkUnits << std::endl;
+}
+
+void
+ZarrImageIO::InternalSetCompressor(const std::string & _compressor)
+{
+  if (_compressor.empty() || _compressor == "ZLIB")
+  {
+    m_WriteCodec = CodecEnum::Zlib;
+  }
+  else if (_compressor == "GZIP")
+  {
+    m_WriteCodec = CodecEnum::Gzip;
+  }
+  else
+  {
+    this->Superclass::InternalSetCompressor(_compressor);
+  }
+}
+
+std::string
+ZarrImageIO::GetStorePath(const char * fileName) const
+{
+  std::string path = fileName ? fileName : "";
+  itksys::SystemTools::ConvertToUnixSlashes(path);
+  while (path.size() > 1 && path.back() == '/')
+  {
+    path.pop_back();
+  }
+  return path;
+}
+
+bool
+ZarrImageIO::CanReadFile(const char * fileName)
+{
+  const std::string store = this->GetStorePath(fileName);
+  if (store.empty() || !itksys::SystemTools::FileIsDirectory(store))
+  {
+    return false;
+  }
+  return itksys::SystemTools::FileExists(store + "/zarr.json", true) ||
+         itksys::SystemTools::FileExists(store + "/.zarray", true) ||
+         itksys::SystemTools::FileExists(store + "/.zgroup", true);
+}
+
+bool
+ZarrImageIO::CanWriteFile(const char * fileName)
+{
+  const std::string store = this->GetStorePath(fileName);
+  if (store.empty())
+  {
+    return false;
+  }
+  return this->HasSupportedWriteExtension(store.c_str());
+}
+
+void
+ZarrImageIO::ReadImageInformation()
+{
+  const std::string store = this->GetStorePath(m_FileName.c_str());
+
+  try
+  {
+    unsigned int version = 0;
+    JsonValue    attributes = JsonValue::MakeObject();
+    bool         isGroup = false;
+
+    if (itksys::SystemTools::FileExists(store + "/zarr.json", true))
+    {
+      version = 3;
+      const JsonValue node = ReadJsonFile(store + "/zarr.json");
+      isGroup = (node.Get("node_type").GetString() == "group");
+      if (const JsonValue * nodeAttributes = node.Find("attributes"))
+      {
+        attributes = *nodeAttributes;
+      }
+    }
+    else
+    {
+      version = 2;
+      isGroup = !itksys::SystemTools::FileExists(store + "/.zarray", true);
+      if (itksys::SystemTools::FileExists(store + "/.zattrs", true))
+      {
+        attributes = ReadJsonFile(store + "/.zattrs");
+      }
+    }
+    m_ZarrFormat = version;
+
+    std::string         arrayPath = store;
+    std::vector<double> scale;
+    std::vector<double> translation;
+    int                 channelAxis = -1;
+
+    const JsonValue * multiscales = FindMultiscales(attributes);
+    if (isGroup)
+    {
+      if (multiscales == nullptr || multiscales->GetArray().empty())
+      {
+        itkExceptionMacro("The Zarr group " << store << " does not hold OME-Zarr multiscales.");
+      }
+      const JsonValue & multiscale = multiscales->GetArray().front();
+      const auto &      datasets = multiscale.Get("datasets").GetArray();
+      m_NumberOfLevels = static_cast<unsigned int>(datasets.size());
+      if (m_Level >= m_NumberOfLevels)
+      {
+        itkExceptionMacro("Level " << m_Level << " requested, but " << store << " only has " << m_NumberOfLevels
+                                   << " levels.");
+      }
+      const JsonValue & dataset = datasets[m_Level];
+      arrayPath = store + '/' + dataset.Get("path").GetString();
+
+      if (const JsonValue * axes = multiscale.Find("axes"))
+      {
+        const auto & axesArray = axes->GetArray();
+        for (size_t i = 0; i < axesArray.size(); ++i)
+        {
+          const JsonValue * type = axesArray[i].Find("type");
+          const bool isChannel = (type != nullptr) ? (type->GetString() == "channel")
+                                                   : (axesArray[i].GetKind() == JsonValue::KindEnum::String &&
+                                                      axesArray[i].GetString() == "c");
+          if (isChannel)
+          {
+            channelAxis = static_cast<int>(i);
+          }
+        }
+      }
+
+      // The transformations of the multiscale apply after those of the dataset.
+      const JsonValue * transformationLists[] = { dataset.Find("coordinateTransformations"),
+                                                  multiscale.Find("coordinateTransformations") };
+      for (const JsonValue * transformations : transformationLists)
+      {
+        if (transformations == nullptr)
+        {
+          continue;
+        }
+        for (const auto & transformation : transformations->GetArray())
+        {
+          const std::string & type = transformation.Get("type").GetString();
+          if (type == "scale")
+          {
+            const std::vector<double> s = transformation.Get("scale").GetNumberArray();
+            if (scale.empty())
+            {
+              scale = s;
+              translation.assign(s.size(), 0.0);
+            }
+            else
+            {
+              for (size_t i = 0; i < s.size() && i < scale.size(); ++i)
+              {
+                scale[i] *= s[i];
+                translation[i] *= s[i];
+              }
+            }
+          }
+          else if (type == "translation")
+          {
+            const std::vector<double> t = transformation.Get("translation").GetNumberArray();
+            translation.resize(std::max(translation.size(), t.size()), 0.0);
+            for (size_t i = 0; i < t.size(); ++i)
+            {
+              translation[i] += t[i];
+            }
+          }
+        }
+      }
+    }
+    else
+    {
+      m_NumberOfLevels = 1;
+      if (m_Level != 0)
+      {
+        itkExceptionMacro("Level " << m_Level << " requested, but " << store << " is a single array.");
+      }
+    }
+
+    this->ReadArrayMetadata(arrayPath, version);
+
+    // Assign the ITK dimensions to the Zarr axes, in reverse order.
+    const size_t numberOfAxes = m_Layout.m_Shape.size();
+    if (channelAxis >= static_cast<int>(numberOfAxes))
+    {
+      channelAxis = -1;
+    }
+    // Each pixel is expected to be found in a single chunk; otherwise each
+    // channel is read as a separate spatial dimension, of unit spacing.
+    const bool splitChannel = channelAxis >= 0 && m_Layout.m_Shape[channelAxis] > 1 &&
+                              m_Layout.m_Chunks[channelAxis] != m_Layout.m_Shape[channelAxis];
+    const unsigned int numberOfDimensions =
+      static_cast<unsigned int>(numberOfAxes) - (channelAxis >= 0 && !splitChannel ? 1 : 0);
+    if (numberOfDimensions == (splitChannel ? 1u : 0u))
+    {
+      itkExceptionMacro("The Zarr array " << arrayPath << " has no spatial axis.");
+    }
+
+    this->SetNumberOfDimensions(numberOfDimensions);
+    m_Layout.m_AxisToDimension.assign(numberOfAxes, -1);
+    int dimension = 0;
+    for (size_t a = numberOfAxes; a-- > 0;)
+    {
+      if (static_cast<int>(a) == channelAxis)
+      {
+        continue;
+      }
+      m_Layout.m_AxisToDimension[a] = dimension;
+      this->SetDimensions(dimension, m_Layout.m_Shape[a]);
+      this->SetSpacing(dimension, a < scale.size() ? scale[a] : 1.0);
+      this->SetOrigin(dimension, a < translation.size() ? translation[a] : 0.0);
+      ++dimension;
+    }
+
+    if (splitChannel)
+    {
+      m_Layout.m_AxisToDimension[channelAxis] = dimension;
+      this->SetDimensions(dimension, m_Layout.m_Shape[channelAxis]);
+      this->SetSpacing(dimension, 1.0);
+      this->SetOrigin(dimension, 0.0);
+      this->SetNumberOfComponents(1);
+      this->SetPixelType(IOPixelEnum::SCALAR);
+    }
+    else if (channelAxis >= 0 && m_Layout.m_Shape[channelAxis] > 1)
+    {
+      this->SetNumberOfComponents(static_cast<unsigned int>(m_Layout.m_Shape[channelAxis]));
+      this->SetPixelType(IOPixelEnum::VECTOR);
+    }
+    else
+    {
+      this->SetNumberOfComponents(1);
+      this->SetPixelType(IOPixelEnum::SCALAR);
+    }
+  }
+  catch (const std::runtime_error & e)
+  {
+    itkExceptionMacro("Unable to read Zarr metadata from " << store << ": " << e.what());
+  }
+}
+
+void
+ZarrImageIO::ReadArrayMetadata(const std::string & arrayPath, unsigned int version)
+{
+  m_Layout = ArrayLayout();
+  m_Layout.m_Path = arrayPath;
+
+  std::string dataType;
+  if (version == 2)
+  {
+    const JsonValue array = ReadJsonFile(arrayPath + "/.zarray");
+    m_Layout.m_Shape = array.Get("shape").GetSizeArray();
+    m_Layout.m_Chunks = array.Get("chunks").GetSizeArray();
+
+    const std::string & dtype = array.Get("dtype").GetString();
+    if (dtype.size() < 3)
+    {
+      itkExceptionMacro("Unsupported Zarr dtype: " << dtype);
+    }
+    m_Layout.m_BigEndian = (dtype[0] == '>');
+    dataType = dtype.substr(1);
+
+    if (const JsonValue * order = array.Find("order"))
+    {
+      if (order->GetString() != "C")
+      {
+        itkExceptionMacro("Only the C order of Zarr chunks is supported.");
+      }
+    }
+    if (const JsonValue * filters = array.Find("filters"))
+    {
+      if (!filters->IsNull() && !filters->GetArray().empty())
+      {
+        itkExceptionMacro("Zarr filters are not supported.");
+      }
+    }
+    if (const JsonValue * compressor = array.Find("compressor"))
+    {
+      if (!compressor->IsNull())
+      {
+        const std::string & id = compressor->Get("id").GetString();
+        if (id == "zlib")
+        {
+          m_Layout.m_Codec = CodecEnum::Zlib;
+        }
+        else if (id == "gzip")
+        {
+          m_Layout.m_Codec = CodecEnum::Gzip;
+        }
+        else
+        {
+          itkExceptionMacro("The Zarr compressor \"" << id << "\" is not supported.");
+        }
+      }
+    }
+    if (const JsonValue * separator = array.Find("dimension_separator"))
+    {
+      m_Layout.m_KeySeparator = separator->GetString().empty() ? '.' : separator->GetString()[0];
+    }
+    if (const JsonValue * fillValue = array.Find("fill_value"))
+    {
+      m_Layout.m_FillValue = ParseFillValue(*fillValue);
+    }
+  }
+  else
+  {
+    const JsonValue array = ReadJsonFile(arrayPath + "/zarr.json");
+    if (array.Get("node_type").GetString() != "array")
+    {
+      itkExceptionMacro("The Zarr node " << arrayPath << " is not an array.");
+    }
+    m_Layout.m_Shape = array.Get("shape").GetSizeArray();
+    m_Layout.m_Chunks = array.Get("chunk_grid").Get("configuration").Get("chunk_shape").GetSizeArray();
+
+    static const std::pair<const char *, const char *> dataTypes[] = {
+      { "bool", "b1" },   { "int8", "i1" },   { "uint8", "u1" },   { "int16", "i2" },   { "uint16", "u2" },
+      { "int32", "i4" },  { "uint32", "u4" }, { "int64", "i8" },   { "uint64", "u8" },  { "float32", "f4" },
+      { "float64", "f8" }
+    };
+    const std::string & name = array.Get("data_type").GetString();
+    for (const auto & entry : dataTypes)
+    {
+      if (name == entry.first)
+      {
+        dataType = entry.second;
+      }
+    }
+    if (dataType.empty())
+    {
+      itkExceptionMacro("Unsupported Zarr data type: " << name);
+    }
+
+    m_Layout.m_KeyPrefix = "c/";
+    m_Layout.m_KeySeparator = '/';
+    if (const JsonValue * keyEncoding = array.Find("chunk_key_encoding"))
+    {
+      char separator = keyEncoding->Get("name").GetString() == "v2" ? '.' : '/';
+      if (const JsonValue * configuration = keyEncoding->Find("configuration"))
+      {
+        if (const JsonValue * s = configuration->Find("separator"))
+        {
+          separator = s->GetString().empty() ? separator : s->GetString()[0];
+        }
+      }
+      m_Layout.m_KeySeparator = separator;
+      m_Layout.m_KeyPrefix =
+        keyEncoding->Get("name").GetString() == "v2" ? std::string() : std::string("c") + separator;
+    }
+
+    for (const auto & codec : array.Get("codecs").GetArray())
+    {
+      const std::string & codecName = codec.Get("name").GetString();
+      const JsonValue *   configuration = codec.Find("configuration");
+      if (codecName == "bytes")
+      {
+        if (configuration != nullptr && configuration->Find("endian") != nullptr)
+        {
+          m_Layout.m_BigEndian = (configuration->Get("endian").GetString() == "big");
+        }
+      }
+      else if (codecName == "gzip" || codecName == "zlib")
+      {
+        m_Layout.m_Codec = (codecName == "gzip") ? CodecEnum::Gzip : CodecEnum::Zlib;
+      }
+      else
+      {
+        itkExceptionMacro("The Zarr codec \"" << codecName << "\" is not supported.");
+      }
+    }
+    if (const JsonValue * fillValue = array.Find("fill_value"))
+    {
+      m_Layout.m_FillValue = ParseFillValue(*fillValue);
+    }
+  }
+
+  if (m_Layout.m_Shape.empty() || m_Layout.m_Shape.size() != m_Layout.m_Chunks.size())
+  {
+    itkExceptionMacro("Invalid shape or chunk shape in " << arrayPath);
+  }
+  for (const auto chunk : m_Layout.m_Chunks)
+  {
+    if (chunk == 0)
+    {
+      itkExceptionMacro("Invalid chunk shape in " << arrayPath);
+    }
+  }
+
+  static const std::pair<const char *, IOComponentEnum> componentTypes[] = {
+    { "b1", IOComponentEnum::UCHAR },    { "u1", IOComponentEnum::UCHAR },     { "i1", IOComponentEnum::CHAR },
+    { "u2", IOComponentEnum::USHORT },   { "i2", IOComponentEnum::SHORT },     { "u4", IOComponentEnum::UINT },
+    { "i4", IOComponentEnum::INT },      { "u8", IOComponentEnum::ULONGLONG }, { "i8", IOComponentEnum::LONGLONG },
+    { "f4", IOComponentEnum::FLOAT },    { "f8", IOComponentEnum::DOUBLE }
+  };
+  m_ComponentType = IOComponentEnum::UNKNOWNCOMPONENTTYPE;
+  for (const auto & entry : componentTypes)
+  {
+    if (dataType == entry.first)
+    {
+      m_ComponentType = entry.second;
+    }
+  }
+  if (m_ComponentType == IOComponentEnum::UNKNOWNCOMPONENTTYPE)
+  {
+    itkExceptionMacro("Unsupported Zarr data type: " << dataType);
+  }
+}
+
+ImageIORegion
+ZarrImageIO::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const
+{
+  if (!m_UseStreamedReading)
+  {
+    return ImageIOBase::GenerateStreamableReadRegionFromRequestedRegion(requestedRegion);
+  }
+  return requestedRegion;
+}
+
+std::string
+ZarrImageIO::GetChunkFileName(const std::vector<SizeValueType> & chunkIndex) const
+{
+  std::ostringstream key;
+  key.imbue(std::locale::classic());
+  key << m_Layout.m_Path << '/' << m_Layout.m_KeyPrefix;
+  for (size_t a = 0; a < chunkIndex.size(); ++a)
+  {
+    if (a > 0)
+    {
+      key << m_Layout.m_KeySeparator;
+    }
+    key << chunkIndex[a];
+  }
+  return key.str();
+}
+
+bool
+ZarrImageIO::ReadChunk(const std::string & fileName, std::vector<char> & chunk) const
+{
+  std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  if (!file.is_open())
+  {
+    return false;
+  }
+
+  if (m_Layout.m_Codec == CodecEnum::None)
+  {
+    file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    if (static_cast<size_t>(file.gcount()) != chunk.size())
+    {
+      itkExceptionMacro("Truncated Zarr chunk: " << fileName);
+    }
+  }
+  else
+  {
+    std::vector<char> encoded((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    try
+    {
+      DecompressZlib(encoded, chunk);
+    }
+    catch (const std::runtime_error & e)
+    {
+      itkExceptionMacro(<< e.what() << ": " << fileName);
+    }
+  }
+
+  if (m_Layout.m_BigEndian != ByteSwapper<int>::SystemIsBigEndian())
+  {
+    SwapBytes(chunk.data(), chunk.size(), this->GetComponentSize());
+  }
+  return true;
+}
+
+void
+ZarrImageIO::WriteChunk(const std::string & fileName, std::vector<char> & chunk) const
+{
+  if (m_Layout.m_BigEndian != ByteSwapper<int>::SystemIsBigEndian())
+  {
+    SwapBytes(chunk.data(), chunk.size(), this->GetComponentSize());
+  }
+
+  std::vector<char>         encoded;
+  const std::vector<char> * data = &chunk;
+  if (m_Layout.m_Codec != CodecEnum::None)
+  {
+    try
+    {
+      CompressZlib(chunk, encoded, m_Layout.m_CodecLevel, m_Layout.m_Codec == CodecEnum::Gzip);
+    }
+    catch (const std::runtime_error & e)
+    {
+      itkExceptionMacro(<< e.what() << ": " << fileName);
+    }
+    data = &encoded;
+  }
+
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file.is_open())
+  {
+    itkExceptionMacro("Unable to open Zarr chunk for writing: " << fileName);
+  }
+  file.write(data->data(), static_cast<std::streamsize>(data->size()));
+  if (file.fail())
+  {
+    itkExceptionMacro("Unable to write Zarr chunk: " << fileName);
+  }
+}
+
+void
+ZarrImageIO::FillChunk(std::vector<char> & chunk) const
+{
+  const double value = m_Layout.m_FillValue;
+  switch (m_ComponentType)
+  {
+    case IOComponentEnum::UCHAR:
+      FillBuffer<unsigned char>(chunk, value);
+      break;
+    case IOComponentEnum::CHAR:
+      FillBuffer<char>(chunk, value);
+      break;
+    case IOComponentEnum::USHORT:
+      FillBuffer<unsigned short>(chunk, value);
+      break;
+    case IOComponentEnum::SHORT:
+      FillBuffer<short>(chunk, value);
+      break;
+    case IOComponentEnum::UINT:
+      FillBuffer<unsigned int>(chunk, value);
+      break;
+    case IOComponentEnum::INT:
+      FillBuffer<int>(chunk, value);
+      break;
+    case IOComponentEnum::ULONG:
+      FillBuffer<unsigned long>(chunk, value);
+      break;
+    case IOComponentEnum::LONG:
+      FillBuffer<long>(chunk, value);
+      break;
+    case IOComponentEnum::ULONGLONG:
+      FillBuffer<unsigned long long>(chunk, value);
+      break;
+    case IOComponentEnum::LONGLONG:
+      FillBuffer<long long>(chunk, value);
+      break;
+    case IOComponentEnum::FLOAT:
+      FillBuffer<float>(chunk, value);
+      break;
+    case IOComponentEnum::DOUBLE:
+      FillBuffer<double>(chunk, value);
+      break;
+    default:
+      std::fill(chunk.begin(), chunk.end(), 0);
+      break;
+  }
+}
+
+void
+ZarrImageIO::ProcessChunksInIORegion(const std::function<void(const std::vector<SizeValueType> &)> & func) const
+{
+  const size_t numberOfAxes = m_Layout.m_Shape.size();
+
+  std::vector<SizeValueType> firstChunk(numberOfAxes);
+  std::vector<SizeValueType> numberOfChunks(numberOfAxes);
+  SizeValueType              totalNumberOfChunks = 1;
+  for (size_t a = 0; a < numberOfAxes; ++a)
+  {
+    SizeValueType begin = 0;
+    SizeValueType end = m_Layout.m_Shape[a];
+    const int     dimension = m_Layout.m_AxisToDimension[a];
+    if (dimension >= 0 && static_cast<unsigned int>(dimension) < m_IORegion.GetImageDimension())
+    {
+      begin = static_cast<SizeValueType>(m_IORegion.GetIndex(dimension));
+      end = begin + m_IORegion.GetSize(dimension);
+    }
+    else if (dimension >= 0)
+    {
+      end = 1;
+    }
+    if (end <= begin || end > m_Layout.m_Shape[a])
+    {
+      itkExceptionMacro("The IORegion is outside of the Zarr array " << m_Layout.m_Path);
+    }
+    firstChunk[a] = begin / m_Layout.m_Chunks[a];
+    numberOfChunks[a] = (end - 1) / m_Layout.m_Chunks[a] - firstChunk[a] + 1;
+    totalNumberOfChunks *= numberOfChunks[a];
+  }
+
+  m_MultiThreader->SetNumberOfWorkUnits(m_NumberOfWorkUnits);
+  m_MultiThreader->ParallelizeArray(
+    0,
+    totalNumberOfChunks,
+    [&](SizeValueType linearIndex) {
+      std::vector<SizeValueType> chunkIndex(numberOfAxes);
+      for (size_t a = numberOfAxes; a-- > 0;)
+      {
+        chunkIndex[a] = firstChunk[a] + linearIndex % numberOfChunks[a];
+        linearIndex /= numberOfChunks[a];
+      }
+      func(chunkIndex);
+    },
+    nullptr);
+}
+
+void
+ZarrImageIO::CopyChunkRegion(const std::vector<SizeValueType> & chunkIndex,
+                             char *                             chunk,
+                             char *                             buffer,
+                             bool                               toChunk) const
+{
+  const size_t       numberOfAxes = m_Layout.m_Shape.size();
+  const unsigned int componentSize = this->GetComponentSize();
+
+  // Strides are expressed in components.
+  std::vector<SizeValueType> dimensionStrides(m_NumberOfDimensions);
+  SizeValueType              stride = this->GetNumberOfComponents();
+  for (unsigned int d = 0; d < m_NumberOfDimensions; ++d)
+  {
+    dimensionStrides[d] = stride;
+    stride *= (d < m_IORegion.GetImageDimension()) ? m_IORegion.GetSize(d) : 1;
+  }
+
+  std::vector<SizeValueType> begin(numberOfAxes);
+  std::vector<SizeValueType> end(numberOfAxes);
+  std::vector<SizeValueType> regionBegin(numberOfAxes);
+  std::vector<SizeValueType> chunkBegin(numberOfAxes);
+  std::vector<SizeValueType> chunkStrides(numberOfAxes);
+  std::vector<SizeValueType> bufferStrides(numberOfAxes);
+  SizeValueType              chunkStride = 1;
+  for (size_t a = numberOfAxes; a-- > 0;)
+  {
+    chunkStrides[a] = chunkStride;
+    chunkStride *= m_Layout.m_Chunks[a];
+
+    const int     dimension = m_Layout.m_AxisToDimension[a];
+    SizeValueType regionEnd = m_Layout.m_Shape[a];
+    regionBegin[a] = 0;
+    bufferStrides[a] = 1;
+    if (dimension >= 0)
+    {
+      regionEnd = 1;
+      if (static_cast<unsigned int>(dimension) < m_IORegion.GetImageDimension())
+      {
+        regionBegin[a] = static_cast<SizeValueType>(m_IORegion.GetIndex(dimension));
+        regionEnd = regionBegin[a] + m_IORegion.GetSize(dimension);
+      }
+      bufferStrides[a] = dimensionStrides[dimension];
+    }
+    chunkBegin[a] = chunkIndex[a] * m_Layout.m_Chunks[a];
+    begin[a] = std::max(chunkBegin[a], regionBegin[a]);
+    end[a] = std::min({ chunkBegin[a] + m_Layout.m_Chunks[a], regionEnd, m_Layout.m_Shape[a] });
+    if (begin[a] >= end[a])
+    {
+      return;
+    }
+  }
+
+  const size_t        innerAxis = numberOfAxes - 1;
+  const SizeValueType runLength = end[innerAxis] - begin[innerAxis];
+  const bool          contiguous = (bufferStrides[innerAxis] == 1);
+
+  std::vector<SizeValueType> position(begin);
+  while (true)
+  {
+    SizeValueType chunkOffset = 0;
+    SizeValueType bufferOffset = 0;
+    for (size_t a = 0; a < numberOfAxes; ++a)
+    {
+      chunkOffset += (position[a] - chunkBegin[a]) * chunkStrides[a];
+      bufferOffset += (position[a] - regionBegin[a]) * bufferStrides[a];
+    }
+    char * chunkPointer = chunk + chunkOffset * componentSize;
+    char * bufferPointer = buffer + bufferOffset * componentSize;
+
+    if (contiguous)
+    {
+      if (toChunk)
+      {
+        std::memcpy(chunkPointer, bufferPointer, runLength * componentSize);
+      }
+      else
+      {
+        std::memcpy(bufferPointer, chunkPointer, runLength * componentSize);
+      }
+    }
+    else
+    {
+      const SizeValueType bufferStep = bufferStrides[innerAxis] * componentSize;
+      for (SizeValueType i = 0; i < runLength; ++i)
+      {
+        if (toChunk)
+        {
+          std::memcpy(chunkPointer, bufferPointer, componentSize);
+        }
+        else
+        {
+          std::memcpy(bufferPointer, chunkPointer, componentSize);
+        }
+        chunkPointer += componentSize;
+        bufferPointer += bufferStep;
+      }
+    }
+
+    // advance to the next run along the outer axes
+    size_t a = innerAxis;
+    while (a-- > 0)
+    {
+      if (++position[a] < end[a])
+      {
+        break;
+      }
+      position[a] = begin[a];
+    }
+    if (a == static_cast<size_t>(-1))
+    {
+      break;
+    }
+  }
+}
+
+void
+ZarrImageIO::Read(void * buffer)
+{
+  auto * const  outBuffer = static_cast<char *>(buffer);
+  SizeValueType chunkSize = this->GetComponentSize();
+  for (const auto c : m_Layout.m_Chunks)
+  {
+    chunkSize *= c;
+  }
+
+  this->ProcessChunksInIORegion([&](const std::vector<SizeValueType> & chunkIndex) {
+    std::vector<char> chunk(chunkSize);
+    if (!this->ReadChunk(this->GetChunkFileName(chunkIndex), chunk))
+    {
+      this->FillChunk(chunk);
+    }
+    this->CopyChunkRegion(chunkIndex, chunk.data(), outBuffer, false);
+  });
+}
+
+void
+ZarrImageIO::InitializeLayoutForWriting(const std::string & arrayPath)
+{
+  const unsigned int numberOfDimensions = this->GetNumberOfDimensions();
+  const unsigned int numberOfComponents = this->GetNumberOfComponents();
+  const bool         hasChannelAxis = numberOfComponents > 1;
+  const size_t       numberOfAxes = numberOfDimensions + (hasChannelAxis ? 1 : 0);
+
+  // OME-Zarr orders the axes as (t, c, z, y, x).
+  const size_t channelAxis = numberOfDimensions > 3 ? numberOfDimensions - 3 : 0;
+
+  m_Layout = ArrayLayout();
+  m_Layout.m_Path = arrayPath;
+  m_Layout.m_Shape.resize(numberOfAxes);
+  m_Layout.m_Chunks.resize(numberOfAxes);
+  m_Layout.m_AxisToDimension.resize(numberOfAxes);
+  int dimension = 0;
+  for (size_t a = numberOfAxes; a-- > 0;)
+  {
+    if (hasChannelAxis && a == channelAxis)
+    {
+      m_Layout.m_AxisToDimension[a] = -1;
+      m_Layout.m_Shape[a] = numberOfComponents;
+      m_Layout.m_Chunks[a] = numberOfComponents;
+      continue;
+    }
+    m_Layout.m_AxisToDimension[a] = dimension;
+    m_Layout.m_Shape[a] = this->GetDimensions(dimension);
+    m_Layout.m_Chunks[a] = std::max<SizeValueType>(1, std::min(m_ChunkSize, m_Layout.m_Shape[a]));
+    ++dimension;
+  }
+
+  if (m_ZarrFormat == 3)
+  {
+    m_Layout.m_KeyPrefix = "c/";
+    m_Layout.m_KeySeparator = '/';
+  }
+  if (m_UseCompression)
+  {
+    // Zarr v3 only defines the gzip codec.
+    m_Layout.m_Codec = (m_ZarrFormat == 3) ? CodecEnum::Gzip : m_WriteCodec;
+    m_Layout.m_CodecLevel = this->GetCompressionLevel();
+  }
+}
+
+void
+ZarrImageIO::WriteMetadata()
+{
+  const std::string store = this->GetStorePath(m_FileName.c_str());
+  const size_t      numberOfAxes = m_Layout.m_Shape.size();
+
+  // data type
+  const unsigned int componentSize = this->GetComponentSize();
+  char               kind = 'u';
+  switch (m_ComponentType)
+  {
+    case IOComponentEnum::CHAR:
+    case IOComponentEnum::SHORT:
+    case IOComponentEnum::INT:
+    case IOComponentEnum::LONG:
+    case IOComponentEnum::LONGLONG:
+      kind = 'i';
+      break;
+    case IOComponentEnum::FLOAT:
+    case IOComponentEnum::DOUBLE:
+      kind = 'f';
+      break;
+    case IOComponentEnum::UCHAR:
+    case IOComponentEnum::USHORT:
+    case IOComponentEnum::UINT:
+    case IOComponentEnum::ULONG:
+    case IOComponentEnum::ULONGLONG:
+      break;
+    default:
+      itkExceptionMacro("Unsupported component type for Zarr: " << m_ComponentType);
+  }
+
+  // axes and coordinate transformations of the multiscale dataset
+  JsonValue axes = JsonValue::MakeArray();
+  JsonValue dimensionNames = JsonValue::MakeArray();
+  JsonValue scale = JsonValue::MakeArray();
+  JsonValue translation = JsonValue::MakeArray();
+  for (size_t a = 0; a < numberOfAxes; ++a)
+  {
+    JsonValue   axis = JsonValue::MakeObject();
+    const int   dimension = m_Layout.m_AxisToDimension[a];
+    std::string name;
+    std::string type = "space";
+    if (dimension < 0)
+    {
+      name = "c";
+      type = "channel";
+      scale.Append(JsonValue::MakeNumber(1.0));
+      translation.Append(JsonValue::MakeNumber(0.0));
+    }
+    else
+    {
+      static const char * const names[] = { "x", "y", "z", "t" };
+      name = dimension < 4 ? names[dimension] : "d" + std::to_string(dimension);
+      type = dimension == 3 ? "time" : "space";
+      scale.Append(JsonValue::MakeNumber(this->GetSpacing(dimension)));
+      translation.Append(JsonValue::MakeNumber(this->GetOrigin(dimension)));
+    }
+    axis.Set("name", JsonValue::MakeString(name));
+    axis.Set("type", JsonValue::MakeString(type));
+    axes.Append(axis);
+    dimensionNames.Append(JsonValue::MakeString(name));
+  }
+
+  JsonValue scaleTransformation = JsonValue::MakeObject();
+  scaleTransformation.Set("type", JsonValue::MakeString("scale"));
+  scaleTransformation.Set("scale", scale);
+  JsonValue translationTransformation = JsonValue::MakeObject();
+  translationTransformation.Set("type", JsonValue::MakeString("translation"));
+  translationTransformation.Set("translation", translation);
+  JsonValue transformations = JsonValue::MakeArray();
+  transformations.Append(scaleTransformation);
+  transformations.Append(translationTransformation);
+
+  JsonValue dataset = JsonValue::MakeObject();
+  dataset.Set("path", JsonValue::MakeString(std::to_string(m_Level)));
+  dataset.Set("coordinateTransformations", transformations);
+
+  // Update the multiscales of an existing group, so that the levels can
+  // be written one after the other.
+  const std::string groupFileName = store + (m_ZarrFormat == 3 ? "/zarr.json" : "/.zattrs");
+  JsonValue         group = JsonValue::MakeObject();
+  if (itksys::SystemTools::FileExists(groupFileName, true))
+  {
+    try
+    {
+      group = ReadJsonFile(groupFileName);
+    }
+    catch (const std::runtime_error &)
+    {
+      group = JsonValue::MakeObject();
+    }
+  }
+  else if (m_Level > 0)
+  {
+    itkExceptionMacro("Level " << m_Level << " can only be written to an existing multiscale group: " << store);
+  }
+
+  JsonValue * attributes = &group;
+  if (m_ZarrFormat == 3)
+  {
+    group.Set("zarr_format", JsonValue::MakeNumber(3));
+    group.Set("node_type", JsonValue::MakeString("group"));
+    if (group.Find("attributes") == nullptr)
+    {
+      group.Set("attributes", JsonValue::MakeObject());
+    }
+    attributes = group.Find("attributes");
+    if (attributes->Find("ome") == nullptr)
+    {
+      JsonValue ome = JsonValue::MakeObject();
+      ome.Set("version", JsonValue::MakeString("0.5"));
+      attributes->Set("ome", ome);
+    }
+    attributes = attributes->Find("ome");
+  }
+
+  JsonValue datasets = JsonValue::MakeArray();
+  if (const JsonValue * multiscales = attributes->Find("multiscales"))
+  {
+    if (multiscales->GetKind() == JsonValue::KindEnum::Array && !multiscales->GetArray().empty())
+    {
+      if (const JsonValue * existing = multiscales->GetArray().front().Find("datasets"))
+      {
+        datasets = *existing;
+      }
+    }
+  }
+  if (datasets.GetArray().size() < m_Level)
+  {
+    itkExceptionMacro("Level " << m_Level << " can not be written before the lower levels: " << store);
+  }
+  datasets.GetArray().resize(std::max<size_t>(datasets.GetArray().size(), m_Level + 1));
+  datasets.GetArray()[m_Level] = dataset;
+
+  JsonValue multiscale = JsonValue::MakeObject();
+  if (m_ZarrFormat == 2)
+  {
+    multiscale.Set("version", JsonValue::MakeString("0.4"));
+  }
+  multiscale.Set("name", JsonValue::MakeString(itksys::SystemTools::GetFilenameWithoutLastExtension(store)));
+  multiscale.Set("axes", axes);
+  multiscale.Set("datasets", datasets);
+  JsonValue multiscales = JsonValue::MakeArray();
+  multiscales.Append(multiscale);
+  attributes->Set("multiscales", multiscales);
+
+  JsonValue array = JsonValue::MakeObject();
+  if (m_ZarrFormat == 2)
+  {
+    JsonValue format = JsonValue::MakeObject();
+    format.Set("zarr_format", JsonValue::MakeNumber(2));
+    WriteJsonFile(store + "/.zgroup", format);
+    WriteJsonFile(groupFileName, group);
+
+    std::ostringstream dtype;
+    dtype << (componentSize == 1 ? '|' : '<') << kind << componentSize;
+
+    JsonValue compressor;
+    if (m_Layout.m_Codec != CodecEnum::None)
+    {
+      compressor = JsonValue::MakeObject();
+      compressor.Set("id", JsonValue::MakeString(m_Layout.m_Codec == CodecEnum::Gzip ? "gzip" : "zlib"));
+      compressor.Set("level", JsonValue::MakeNumber(m_Layout.m_CodecLevel));
+    }
+
+    array.Set("zarr_format", JsonValue::MakeNumber(2));
+    array.Set("shape", JsonValue::MakeNumberArray(m_Layout.m_Shape));
+    array.Set("chunks", JsonValue::MakeNumberArray(m_Layout.m_Chunks));
+    array.Set("dtype", JsonValue::MakeString(dtype.str()));
+    array.Set("compressor", compressor);
+    array.Set("fill_value", JsonValue::MakeNumber(m_Layout.m_FillValue));
+    array.Set("order", JsonValue::MakeString("C"));
+    array.Set("filters", JsonValue());
+    array.Set("dimension_separator", JsonValue::MakeString(std::string(1, m_Layout.m_KeySeparator)));
+    WriteJsonFile(m_Layout.m_Path + "/.zarray", array);
+  }
+  else
+  {
+    WriteJsonFile(groupFileName, group);
+
+    std::string dataType = (kind == 'f') ? "float" : (kind == 'i' ? "int" : "uint");
+    dataType += std::to_string(8 * componentSize);
+
+    JsonValue chunkGridConfiguration = JsonValue::MakeObject();
+    chunkGridConfiguration.Set("chunk_shape", JsonValue::MakeNumberArray(m_Layout.m_Chunks));
+    JsonValue chunkGrid = JsonValue::MakeObject();
+    chunkGrid.Set("name", JsonValue::MakeString("regular"));
+    chunkGrid.Set("configuration", chunkGridConfiguration);
+
+    JsonValue keyEncodingConfiguration = JsonValue::MakeObject();
+    keyEncodingConfiguration.Set("separator", JsonValue::MakeString(std::string(1, m_Layout.m_KeySeparator)));
+    JsonValue keyEncoding = JsonValue::MakeObject();
+    keyEncoding.Set("name", JsonValue::MakeString("default"));
+    keyEncoding.Set("configuration", keyEncodingConfiguration);
+
+    JsonValue codecs = JsonValue::MakeArray();
+    JsonValue bytesConfiguration = JsonValue::MakeObject();
+    bytesConfiguration.Set("endian", JsonValue::MakeString("little"));
+    JsonValue bytes = JsonValue::MakeObject();
+    bytes.Set("name", JsonValue::MakeString("bytes"));
+    bytes.Set("configuration", bytesConfiguration);
+    codecs.Append(bytes);
+    if (m_Layout.m_Codec != CodecEnum::None)
+    {
+      JsonValue gzipConfiguration = JsonValue::MakeObject();
+      gzipConfiguration.Set("level", JsonValue::MakeNumber(m_Layout.m_CodecLevel));
+      JsonValue gzip = JsonValue::MakeObject();
+      gzip.Set("name", JsonValue::MakeString("gzip"));
+      gzip.Set("configuration", gzipConfiguration);
+      codecs.Append(gzip);
+    }
+
+    array.Set("zarr_format", JsonValue::MakeNumber(3));
+    array.Set("node_type", JsonValue::MakeString("array"));
+    array.Set("shape", JsonValue::MakeNumberArray(m_Layout.m_Shape));
+    array.Set("data_type", JsonValue::MakeString(dataType));
+    array.Set("chunk_grid", chunkGrid);
+    array.Set("chunk_key_encoding", keyEncoding);
+    array.Set("fill_value", JsonValue::MakeNumber(m_Layout.m_FillValue));
+    array.Set("codecs", codecs);
+    array.Set("dimension_names", dimensionNames);
+    WriteJsonFile(m_Layout.m_Path + "/zarr.json", array);
+  }
+}
+
+void
+ZarrImageIO::Write(const void * buffer)
+{
+  const std::string store = this->GetStorePath(m_FileName.c_str());
+  const std::string arrayPath = store + '/' + std::to_string(m_Level);
+
+  if (!itksys::SystemTools::MakeDirectory(arrayPath))
+  {
+    itkExceptionMacro("Unable to create the Zarr array directory " << arrayPath);
+  }
+
+  // When streaming or pasting, the chunks are written into the existing
+  // array with its own layout.
+  bool useExistingArray = false;
+  for (unsigned int d = 0; d < m_NumberOfDimensions; ++d)
+  {
+    const SizeValueType size = (d < m_IORegion.GetImageDimension()) ? m_IORegion.GetSize(d) : 1;
+    useExistingArray = useExistingArray || (size != this->GetDimensions(d));
+  }
+  if (useExistingArray)
+  {
+    const auto existing = Self::New();
+    existing->SetFileName(m_FileName);
+    existing->SetLevel(m_Level);
+    try
+    {
+      existing->ReadImageInformation();
+    }
+    catch (const ExceptionObject &)
+    {
+      useExistingArray = false;
+    }
+    useExistingArray = useExistingArray && existing->GetComponentType() == this->GetComponentType() &&
+                       existing->GetNumberOfComponents() == this->GetNumberOfComponents() &&
+                       existing->GetNumberOfDimensions() == this->GetNumberOfDimensions();
+    for (unsigned int d = 0; useExistingArray && d < m_NumberOfDimensions; ++d)
+    {
+      useExistingArray = (existing->GetDimensions(d) == this->GetDimensions(d));
+    }
+    if (useExistingArray)
+    {
+      m_Layout = existing->m_Layout;
+      m_ZarrFormat = existing->m_ZarrFormat;
+    }
+  }
+
+  if (!useExistingArray)
+  {
+    this->InitializeLayoutForWriting(arrayPath);
+    try
+    {
+      this->WriteMetadata();
+    }
+    catch (const std::runtime_error & e)
+    {
+      itkExceptionMacro("Unable to write Zarr metadata to " << store << ": " << e.what());
+    }
+  }
+
+  SizeValueType chunkSize = this->GetComponentSize();
+  for (const auto c : m_Layout.m_Chunks)
+  {
+    chunkSize *= c;
+  }
+
+  // Nested chunk keys require directories, which are created before
+  // the chunks are written concurrently.
+  if (m_Layout.m_KeySeparator == '/')
+  {
+    std::set<std::string> directories;
+    std::mutex            directoriesMutex;
+    this->ProcessChunksInIORegion([&](const std::vector<SizeValueType> & chunkIndex) {
+      const std::string directory = itksys::SystemTools::GetFilenamePath(this->GetChunkFileName(chunkIndex));
+      const std::lock_guard<std::mutex> lock(directoriesMutex);
+      directories.insert(directory);
+    });
+    for (const auto & directory : directories)
+    {
+      if (!itksys::SystemTools::MakeDirectory(directory))
+      {
+        itkExceptionMacro("Unable to create the Zarr chunk directory " << directory);
+      }
+    }
+  }
+
+  auto * const inBuffer = static_cast<char *>(const_cast<void *>(buffer));
+  this->ProcessChunksInIORegion([&](const std::vector<SizeValueType> & chunkIndex) {
+    // A chunk only partially covered by the IORegion is merged with the
+    // chunk already in the store.
+    bool covered = true;
+    for (size_t a = 0; a < chunkIndex.size() && covered; ++a)
+    {
+      const int dimension = m_Layout.m_AxisToDimension[a];
+      if (dimension < 0)
+      {
+        continue;
+      }
+      const SizeValueType chunkBegin = chunkIndex[a] * m_Layout.m_Chunks[a];
+      const SizeValueType chunkEnd = std::min(chunkBegin + m_Layout.m_Chunks[a], m_Layout.m_Shape[a]);
+      SizeValueType       regionBegin = 0;
+      SizeValueType       regionEnd = 1;
+      if (static_cast<unsigned int>(dimension) < m_IORegion.GetImageDimension())
+      {
+        regionBegin = static_cast<SizeValueType>(m_IORegion.GetIndex(dimension));
+        regionEnd = regionBegin + m_IORegion.GetSize(dimension);
+      }
+      covered = (regionBegin <= chunkBegin && chunkEnd <= regionEnd);
+    }
+
+    const std::string fileName = this->GetChunkFileName(chunkIndex);
+    std::vector<char> chunk(chunkSize);
+    if (covered || !this->ReadChunk(fileName, chunk))
+    {
+      this->FillChunk(chunk);
+    }
+    this->CopyChunkRegion(chunkIndex, chunk.data(), inBuffer, true);
+    this->WriteChunk(fileName, chunk);
+  });
+}
+
+unsigned int
+ZarrImageIO::GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                               const ImageIORegion & pasteRegion,
+                                               const ImageIORegion & largestPossibleRegion)
+{
+  const std::string store = this->GetStorePath(m_FileName.c_str());
+  // A store holding a single array is replaced by a multiscale group when
+  // level 0 is written.
+  const std::string arrayPath =
+    (m_Level == 0 && IsArrayDirectory(store)) ? store : store + '/' + std::to_string(m_Level);
+
+  if (!itksys::SystemTools::FileIsDirectory(arrayPath))
+  {
+    // nothing to paste into or to clean up
+  }
+  else if (pasteRegion != largestPossibleRegion)
+  {
+    // we are going to be pasting, the existing array must be compatible
+    std::string errorMessage;
+    const auto  headerReader = Self::New();
+    headerReader->SetLevel(m_Level);
+    try
+    {
+      headerReader->SetFileName(m_FileName);
+      headerReader->ReadImageInformation();
+    }
+    catch (...)
+    {
+      errorMessage = "Unable to read information from file: " + m_FileName;
+    }
+
+    if (!errorMessage.empty())
+    {
+    }
+    else if (headerReader->GetNumberOfComponents() != this->GetNumberOfComponents() ||
+             headerReader->GetComponentType() != this->GetComponentType())
+    {
+      errorMessage = "Component type does not match in file: " + m_FileName;
+    }
+    else if (headerReader->GetNumberOfDimensions() != this->GetNumberOfDimensions())
+    {
+      errorMessage = "Dimensions does not match in file: " + m_FileName;
+    }
+    else
+    {
+      for (unsigned int i = 0; i < this->GetNumberOfDimensions(); ++i)
+      {
+        if (headerReader->GetDimensions(i) != this->GetDimensions(i))
+        {
+          errorMessage = "Size does not match in file: " + m_FileName;
+          break;
+        }
+      }
+    }
+
+    if (!errorMessage.empty())
+    {
+      itkExceptionMacro("Unable to paste because pasting file exists and is different. " << errorMessage);
+    }
+  }
+  else
+  {
+    // A new image is written; chunks of a previous array must not be
+    // merged with it. Only the files of that array are removed, so that the
+    // rest of the store, e.g. other levels or OME-Zarr labels, is kept.
+    std::vector<std::string> files;
+    std::vector<std::string> directories;
+    if (!CollectArrayEntries(arrayPath, true, files, directories))
+    {
+      itkExceptionMacro("Unable to write the Zarr array " << arrayPath
+                                                          << ", which exists and holds content that is not Zarr.");
+    }
+    for (const auto & file : files)
+    {
+      if (!itksys::SystemTools::RemoveFile(file))
+      {
+        itkExceptionMacro("Unable to remove existing Zarr chunk for writing: " << file);
+      }
+    }
+    for (const auto & directory : directories)
+    {
+      if (!itksys::SystemTools::RemoveADirectory(directory))
+      {
+        itkExceptionMacro("Unable to remove existing Zarr chunk directory for writing: " << directory);
+      }
+    }
+  }
+
+  return GetActualNumberOfSplitsForWritingCanStreamWrite(numberOfRequestedSplits, pasteRegion);
+}
+} // end namespace itk
@@ -0,0 +1,371 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkZarrImageIO.h"
+#include "itkZarrImageIOFactory.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkRandomImageSource.h"
+#include "itkVector.h"
+#include "itkTestingMacros.h"
+#include "itksys/SystemTools.hxx"
+
+#include <fstream>
+#include <locale>
+#include <sstream>
+
+namespace
+{
+template <typename TImage>
+bool
+RegionsEqual(const TImage * image1, const TImage * image2, const typename TImage::RegionType & region)
+{
+  itk::ImageRegionConstIterator<TImage> it1(image1, region);
+  itk::ImageRegionConstIterator<TImage> it2(image2, region);
+  for (; !it1.IsAtEnd(); ++it1, ++it2)
+  {
+    if (it1.Get() != it2.Get())
+    {
+      std::cerr << "Pixel mismatch at " << it1.GetIndex() << ": " << it1.Get() << " != " << it2.Get() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename TPixel, unsigned int VDimension>
+int
+TestScalarRoundTrip(const std::string & fileName, unsigned int zarrFormat, bool useCompression, unsigned int streams)
+{
+  using ImageType = itk::Image<TPixel, VDimension>;
+
+  typename ImageType::SizeType      size;
+  typename ImageType::SpacingType   spacing;
+  typename ImageType::PointType     origin;
+  constexpr itk::SizeValueType      sizes[] = { 37, 29, 11, 7 };
+  for (unsigned int d = 0; d < VDimension; ++d)
+  {
+    size[d] = sizes[d];
+    spacing[d] = 0.5 + d;
+    origin[d] = -3.25 * d;
+  }
+
+  auto source = itk::RandomImageSource<ImageType>::New();
+  source->SetSize(size);
+  source->SetSpacing(spacing);
+  source->SetOrigin(origin);
+  source->Update();
+  const typename ImageType::Pointer image = source->GetOutput();
+
+  auto zarrIO = itk::ZarrImageIO::New();
+  zarrIO->SetZarrFormat(zarrFormat);
+  zarrIO->SetChunkSize(8);
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(zarrIO);
+  writer->SetUseCompression(useCompression);
+  writer->SetNumberOfStreamDivisions(streams);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  // Read the whole image back
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(fileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+
+  const ImageType * readImage = reader->GetOutput();
+  ITK_TEST_EXPECT_EQUAL(readImage->GetLargestPossibleRegion().GetSize(), size);
+  ITK_TEST_EXPECT_EQUAL(readImage->GetSpacing(), spacing);
+  ITK_TEST_EXPECT_EQUAL(readImage->GetOrigin(), origin);
+  ITK_TEST_EXPECT_TRUE(RegionsEqual<ImageType>(image, readImage, image->GetLargestPossibleRegion()));
+
+  auto readIO = dynamic_cast<itk::ZarrImageIO *>(reader->GetImageIO());
+  ITK_TEST_EXPECT_TRUE(readIO != nullptr);
+  ITK_TEST_EXPECT_EQUAL(readIO->GetZarrFormat(), zarrFormat);
+  ITK_TEST_EXPECT_EQUAL(readIO->GetNumberOfLevels(), 1u);
+
+  // Read a region which is not aligned to the chunks
+  typename ImageType::RegionType region = image->GetLargestPossibleRegion();
+  for (unsigned int d = 0; d < VDimension; ++d)
+  {
+    region.SetIndex(d, 3);
+    region.SetSize(d, size[d] - 5);
+  }
+  auto streamingReader = itk::ImageFileReader<ImageType>::New();
+  streamingReader->SetFileName(fileName);
+  streamingReader->SetUseStreaming(true);
+  streamingReader->GetOutput()->SetRequestedRegion(region);
+  ITK_TRY_EXPECT_NO_EXCEPTION(streamingReader->Update());
+  ITK_TEST_EXPECT_EQUAL(streamingReader->GetOutput()->GetBufferedRegion(), region);
+  ITK_TEST_EXPECT_TRUE(RegionsEqual<ImageType>(image, streamingReader->GetOutput(), region));
+
+  // Paste a constant region into the existing store
+  auto constantImage = ImageType::New();
+  constantImage->CopyInformation(image);
+  constantImage->SetBufferedRegion(region);
+  constantImage->SetRequestedRegion(region);
+  constantImage->Allocate();
+  constantImage->FillBuffer(TPixel{ 7 });
+
+  itk::ImageIORegion pasteRegion(VDimension);
+  for (unsigned int d = 0; d < VDimension; ++d)
+  {
+    pasteRegion.SetIndex(d, region.GetIndex(d));
+    pasteRegion.SetSize(d, region.GetSize(d));
+  }
+  auto pasteWriter = itk::ImageFileWriter<ImageType>::New();
+  pasteWriter->SetInput(constantImage);
+  pasteWriter->SetFileName(fileName);
+  pasteWriter->SetImageIO(itk::ZarrImageIO::New());
+  pasteWriter->SetIORegion(pasteRegion);
+  pasteWriter->SetUseCompression(useCompression);
+  ITK_TRY_EXPECT_NO_EXCEPTION(pasteWriter->Update());
+
+  auto pastedReader = itk::ImageFileReader<ImageType>::New();
+  pastedReader->SetFileName(fileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(pastedReader->Update());
+  itk::ImageRegionConstIterator<ImageType> it(pastedReader->GetOutput(), image->GetLargestPossibleRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    const TPixel expected = region.IsInside(it.GetIndex()) ? TPixel{ 7 } : image->GetPixel(it.GetIndex());
+    if (it.Get() != expected)
+    {
+      std::cerr << "Pasted pixel mismatch at " << it.GetIndex() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+int
+TestVectorAndMultiscale(const std::string & fileName, unsigned int zarrFormat)
+{
+  using PixelType = itk::Vector<float, 3>;
+  using ImageType = itk::Image<PixelType, 2>;
+
+  ImageType::SizeType size = { { 20, 13 } };
+  auto                image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  float                                value = 0.0f;
+  itk::ImageRegionIterator<ImageType> it(image, image->GetLargestPossibleRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    PixelType pixel;
+    for (unsigned int c = 0; c < 3; ++c)
+    {
+      pixel[c] = value;
+      value += 0.25f;
+    }
+    it.Set(pixel);
+  }
+
+  auto zarrIO = itk::ZarrImageIO::New();
+  zarrIO->SetZarrFormat(zarrFormat);
+  zarrIO->SetChunkSize(6);
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(zarrIO, ZarrImageIO, ImageIOBase);
+
+  zarrIO->SetNumberOfWorkUnits(3);
+  ITK_TEST_SET_GET_VALUE(3, zarrIO->GetNumberOfWorkUnits());
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(zarrIO);
+  writer->SetUseCompression(true);
+  writer->SetNumberOfStreamDivisions(3);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  // Write a second level of the pyramid
+  ImageType::SizeType halfSize = { { 10, 7 } };
+  auto                level1 = ImageType::New();
+  level1->SetRegions(halfSize);
+  level1->SetSpacing(2.0);
+  level1->Allocate();
+  level1->FillBuffer(PixelType(1.5f));
+
+  auto levelIO = itk::ZarrImageIO::New();
+  levelIO->SetZarrFormat(zarrFormat);
+  levelIO->SetLevel(1);
+  auto levelWriter = itk::ImageFileWriter<ImageType>::New();
+  levelWriter->SetInput(level1);
+  levelWriter->SetFileName(fileName);
+  levelWriter->SetImageIO(levelIO);
+  ITK_TRY_EXPECT_NO_EXCEPTION(levelWriter->Update());
+
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(fileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+  ITK_TEST_EXPECT_TRUE(RegionsEqual<ImageType>(image, reader->GetOutput(), image->GetLargestPossibleRegion()));
+
+  auto readIO = dynamic_cast<itk::ZarrImageIO *>(reader->GetImageIO());
+  ITK_TEST_EXPECT_TRUE(readIO != nullptr);
+  ITK_TEST_EXPECT_EQUAL(readIO->GetNumberOfLevels(), 2u);
+  ITK_TEST_EXPECT_EQUAL(readIO->GetNumberOfComponents(), 3u);
+
+  auto level1IO = itk::ZarrImageIO::New();
+  level1IO->SetLevel(1);
+  auto level1Reader = itk::ImageFileReader<ImageType>::New();
+  level1Reader->SetFileName(fileName);
+  level1Reader->SetImageIO(level1IO);
+  ITK_TRY_EXPECT_NO_EXCEPTION(level1Reader->Update());
+  ITK_TEST_EXPECT_EQUAL(level1Reader->GetOutput()->GetLargestPossibleRegion().GetSize(), halfSize);
+  ITK_TEST_EXPECT_EQUAL(level1Reader->GetOutput()->GetSpacing(), level1->GetSpacing());
+  ITK_TEST_EXPECT_TRUE(RegionsEqual<ImageType>(level1, level1Reader->GetOutput(), level1->GetLargestPossibleRegion()));
+
+  // A level which does not exist
+  level1IO->SetLevel(2);
+  level1Reader->Modified();
+  ITK_TRY_EXPECT_EXCEPTION(level1Reader->Update());
+
+  return EXIT_SUCCESS;
+}
+
+// Decimal comma, as used by many locales.
+class CommaNumpunct : public std::numpunct<char>
+{
+protected:
+  char
+  do_decimal_point() const override
+  {
+    return ',';
+  }
+};
+
+std::string
+ReadText(const std::string & fileName)
+{
+  std::ifstream     file(fileName.c_str(), std::ios::in | std::ios::binary);
+  std::stringstream text;
+  text << file.rdbuf();
+  return text.str();
+}
+
+void
+WriteText(const std::string & fileName, const std::string & text)
+{
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  file << text;
+}
+
+int
+TestStoreContents(const std::string & directory)
+{
+  using ImageType = itk::Image<unsigned char, 3>;
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 5, 4, 3 } });
+  image->SetSpacing(itk::MakeVector(0.5, 0.25, 3.0));
+  image->Allocate();
+  image->FillBuffer(5);
+
+  const std::string fileName = directory + "/itkZarrImageIOTest_contents.ome.zarr";
+  const auto        writeImage = [&fileName](const ImageType * input) {
+    auto zarrIO = itk::ZarrImageIO::New();
+    zarrIO->SetChunkSize(2);
+    auto writer = itk::ImageFileWriter<ImageType>::New();
+    writer->SetInput(input);
+    writer->SetFileName(fileName);
+    writer->SetImageIO(zarrIO);
+    writer->Update();
+  };
+
+  // The metadata is written and read with a period as decimal separator,
+  // whatever the global locale.
+  const std::locale previousLocale = std::locale::global(std::locale(std::locale::classic(), new CommaNumpunct));
+  ITK_TRY_EXPECT_NO_EXCEPTION(writeImage(image));
+  ImageType::Pointer readImage;
+  ITK_TRY_EXPECT_NO_EXCEPTION(readImage = itk::ReadImage<ImageType>(fileName));
+  std::locale::global(previousLocale);
+  ITK_TEST_EXPECT_EQUAL(readImage->GetSpacing(), image->GetSpacing());
+  ITK_TEST_EXPECT_TRUE(ReadText(fileName + "/.zattrs").find("0.5") != std::string::npos);
+
+  // Writing a new image keeps the rest of the store, such as the labels.
+  itksys::SystemTools::MakeDirectory(fileName + "/labels");
+  WriteText(fileName + "/labels/.zattrs", "{}");
+  image->FillBuffer(9);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writeImage(image));
+  ITK_TEST_EXPECT_TRUE(itksys::SystemTools::FileExists(fileName + "/labels/.zattrs", true));
+  ITK_TEST_EXPECT_TRUE(RegionsEqual<ImageType>(
+    image, itk::ReadImage<ImageType>(fileName).GetPointer(), image->GetLargestPossibleRegion()));
+
+  // The array of the level is not replaced if it holds other files.
+  WriteText(fileName + "/0/notes.txt", "not a chunk");
+  ITK_TRY_EXPECT_EXCEPTION(writeImage(image));
+  ITK_TEST_EXPECT_TRUE(itksys::SystemTools::FileExists(fileName + "/0/notes.txt", true));
+  itksys::SystemTools::RemoveFile(fileName + "/0/notes.txt");
+
+  // A channel axis split in several chunks is read as a spatial dimension of
+  // unit spacing.
+  ITK_TRY_EXPECT_NO_EXCEPTION(writeImage(image));
+  std::string       attributes = ReadText(fileName + "/.zattrs");
+  const std::string zAxis = "{\"name\": \"z\", \"type\": \"space\"}";
+  ITK_TEST_EXPECT_TRUE(attributes.find(zAxis) != std::string::npos);
+  attributes.replace(attributes.find(zAxis), zAxis.size(), "{\"name\": \"c\", \"type\": \"channel\"}");
+  WriteText(fileName + "/.zattrs", attributes);
+
+  const auto channelIO = itk::ZarrImageIO::New();
+  channelIO->SetFileName(fileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(channelIO->ReadImageInformation());
+  ITK_TEST_EXPECT_EQUAL(channelIO->GetNumberOfDimensions(), 3u);
+  ITK_TEST_EXPECT_EQUAL(channelIO->GetNumberOfComponents(), 1u);
+  ITK_TEST_EXPECT_EQUAL(channelIO->GetDimensions(2), 3u);
+  ITK_TEST_EXPECT_EQUAL(channelIO->GetSpacing(2), 1.0);
+  ITK_TEST_EXPECT_EQUAL(channelIO->GetSpacing(0), 0.5);
+
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+int
+itkZarrImageIOTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory = argv[1];
+
+  itk::ZarrImageIOFactory::RegisterOneFactory();
+
+  auto zarrIO = itk::ZarrImageIO::New();
+  ITK_TEST_EXPECT_TRUE(zarrIO->CanWriteFile((directory + "/image.zarr").c_str()));
+  ITK_TEST_EXPECT_TRUE(zarrIO->CanWriteFile((directory + "/image.ome.zarr/").c_str()));
+  ITK_TEST_EXPECT_TRUE(!zarrIO->CanWriteFile((directory + "/image.nrrd").c_str()));
+  ITK_TEST_EXPECT_TRUE(!zarrIO->CanReadFile((directory + "/missing.zarr").c_str()));
+
+  int status = EXIT_SUCCESS;
+  status |= TestScalarRoundTrip<unsigned short, 3>(directory + "/itkZarrImageIOTest_v2.zarr", 2, false, 1);
+  status |= TestScalarRoundTrip<unsigned short, 3>(directory + "/itkZarrImageIOTest_v2z.zarr", 2, true, 4);
+  status |= TestScalarRoundTrip<float, 2>(directory + "/itkZarrImageIOTest_v3.zarr", 3, false, 3);
+  status |= TestScalarRoundTrip<short, 4>(directory + "/itkZarrImageIOTest_v3z.zarr", 3, true, 5);
+  status |= TestVectorAndMultiscale(directory + "/itkZarrImageIOTest_vector_v2.ome.zarr", 2);
+  status |= TestVectorAndMultiscale(directory + "/itkZarrImageIOTest_vector_v3.ome.zarr", 3);
+  status |= TestStoreContents(directory);
+
+  ITK_TEST_EXPECT_TRUE(zarrIO->CanReadFile((directory + "/itkZarrImageIOTest_v2.zarr").c_str()));
+
+  std::cout << "Test finished." << std::endl;
+  return status;
+}
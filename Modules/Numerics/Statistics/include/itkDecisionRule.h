@@ -74,6 +74,19 @@ public:
   virtual ClassIdentifierType
   Evaluate(const MembershipVectorType & discriminantScores) const = 0;
 
+  /**
+   * Evaluate the decision rule for numberOfMeasurementVectors measurement
+   * vectors, whose discriminant scores are stored class after class: the
+   * score of the class k of the measurement vector i is
+   * discriminantScores[k * numberOfMeasurementVectors + i]. The default
+   * calls Evaluate() for each measurement vector.
+   */
+  virtual void
+  BatchEvaluate(const MembershipValueType * discriminantScores,
+                unsigned int                numberOfClasses,
+                SizeValueType               numberOfMeasurementVectors,
+                ClassIdentifierType *       classIdentifiers) const;
+
 protected:
   DecisionRule();
   ~DecisionRule() override;
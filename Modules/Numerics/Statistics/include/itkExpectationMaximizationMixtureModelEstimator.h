@@ -18,6 +18,8 @@
 #ifndef itkExpectationMaximizationMixtureModelEstimator_h
 #define itkExpectationMaximizationMixtureModelEstimator_h
 
+#include <vector>
+
 #include "ITKStatisticsExport.h"
 #include "itkMixtureModelComponentBase.h"
 #include "itkGaussianMembershipFunction.h"
@@ -71,6 +73,15 @@ operator<<(std::ostream & out, const ExpectationMaximizationMixtureModelEstimato
  * sample set as input. Please use the function
  * GetMeasurementVectorSize() to get the length.
  *
+ * The measurement vectors and frequencies of the sample are copied once in
+ * contiguous buffers, which are shared with the components during Update().
+ * The expectation step then evaluates the logarithms of the component
+ * densities of blocks of contiguous measurement vectors in parallel, and
+ * normalizes the memberships of each measurement vector from them. The
+ * proportions, and the parameters of GaussianMixtureModelComponent, are
+ * updated from sums over the same blocks, which are added in the order of the
+ * blocks, so that the estimates do not depend on the number of work units.
+ *
  * \sa MixtureModelComponentBase, GaussianMixtureModelComponent
  * \ingroup ITKStatistics
  *
@@ -177,6 +188,11 @@ public:
   unsigned int
   GetNumberOfComponents() const;
 
+  /** Set/Get the number of work units, which is also set to the components
+   * during Update(). */
+  itkSetClampMacro(NumberOfWorkUnits, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfWorkUnits, ThreadIdType);
+
   /** Runs the optimization process. */
   void
   Update();
@@ -238,6 +254,14 @@ private:
 
   MembershipFunctionVectorObjectPointer  m_MembershipFunctionsObject{};
   MembershipFunctionsWeightsArrayPointer m_MembershipFunctionsWeightArrayObject{};
+
+  /** Measurement vectors of the sample, one after the other, and their
+   * frequencies, during Update(). */
+  std::vector<double> m_MeasurementVectorBuffer{};
+  std::vector<double> m_FrequencyBuffer{};
+
+  ThreadIdType               m_NumberOfWorkUnits{};
+  MultiThreaderBase::Pointer m_MultiThreader{};
 }; // end of class
 } // end of namespace Statistics
 } // end of namespace itk
@@ -18,6 +18,10 @@
 #ifndef itkExpectationMaximizationMixtureModelEstimator_hxx
 #define itkExpectationMaximizationMixtureModelEstimator_hxx
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include "itkNumericTraits.h"
 #include "itkMath.h"
 
@@ -30,6 +34,8 @@ ExpectationMaximizationMixtureModelEstimator<TSample>::ExpectationMaximizationMi
   : m_Sample(nullptr)
   , m_MembershipFunctionsObject(MembershipFunctionVectorObjectType::New())
   , m_MembershipFunctionsWeightArrayObject(MembershipFunctionsWeightsArrayObjectType::New())
+  , m_NumberOfWorkUnits(MultiThreaderBase::GetGlobalDefaultNumberOfThreads())
+  , m_MultiThreader(MultiThreaderBase::New())
 {}
 
 template <typename TSample>
@@ -48,6 +54,7 @@ ExpectationMaximizationMixtureModelEstimator<TSample>::PrintSelf(std::ostream &
   os << indent << "Termination Code: " << this->GetTerminationCode() << std::endl;
   os << indent << "Initial Proportions: " << this->GetInitialProportions() << std::endl;
   os << indent << "Proportions: " << this->GetProportions() << std::endl;
+  os << indent << "NumberOfWorkUnits: " << m_NumberOfWorkUnits << std::endl;
   os << indent << "Calculated Expectation: " << this->CalculateExpectation() << std::endl;
 }
 
@@ -151,57 +158,103 @@ ExpectationMaximizationMixtureModelEstimator<TSample>::CalculateDensities()
   }
 
   const size_t        numberOfComponents = m_ComponentVector.size();
-  std::vector<double> tempWeights(numberOfComponents, 0.);
-
-  typename TSample::ConstIterator       iter = m_Sample->Begin();
-  const typename TSample::ConstIterator last = m_Sample->End();
-  // Note: The data type of componentIndex should be unsigned int
-  //       because itk::Array only supports 'unsigned int' number of elements.
-
-  using FrequencyType = typename TSample::AbsoluteFrequencyType;
-
-  constexpr FrequencyType zeroFrequency{};
-  constexpr double        minDouble = NumericTraits<double>::epsilon();
-  SizeValueType           measurementVectorIndex = 0;
-  while (iter != last)
+  const SizeValueType numberOfMeasurementVectors = m_FrequencyBuffer.size();
+  for (size_t componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex)
   {
-    typename TSample::MeasurementVectorType mvector = iter.GetMeasurementVector();
-    const FrequencyType                     frequency = iter.GetFrequency();
-    double                                  densitySum = 0.0;
-    if (frequency > zeroFrequency)
+    if (m_ComponentVector[componentIndex]->GetWeights().Size() != numberOfMeasurementVectors)
     {
-      for (unsigned int componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex)
+      itkExceptionMacro("Weight array is not allocated.");
+    }
+  }
+
+  // The densities are weighted by the proportions in the log domain, and the
+  // memberships are normalized by the sum of the weighted densities when it
+  // is larger than epsilon, as without logarithms.
+  std::vector<double> logProportions(numberOfComponents);
+  for (size_t componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex)
+  {
+    logProportions[componentIndex] = std::log(m_Proportions[static_cast<unsigned int>(componentIndex)]);
+  }
+  const double     logEpsilon = std::log(NumericTraits<double>::epsilon());
+  constexpr double minDouble = NumericTraits<double>::epsilon();
+
+  const SizeValueType blockSize = ComponentType::GetBlockSize(numberOfMeasurementVectors);
+  const SizeValueType numberOfBlocks = (numberOfMeasurementVectors + blockSize - 1) / blockSize;
+
+  m_MultiThreader->SetNumberOfWorkUnits(m_NumberOfWorkUnits);
+  m_MultiThreader->ParallelizeArray(
+    0,
+    numberOfBlocks,
+    [&](SizeValueType block) {
+      const SizeValueType begin = block * blockSize;
+      const SizeValueType end = std::min(numberOfMeasurementVectors, begin + blockSize);
+      const SizeValueType count = end - begin;
+
+      // Log densities of the block, component after component.
+      std::vector<double> logDensities(numberOfComponents * count);
+      for (size_t componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex)
       {
-        const double t_prop = m_Proportions[componentIndex];
-        const double t_value = m_ComponentVector[componentIndex]->Evaluate(mvector);
-        const double density = t_prop * t_value;
-        tempWeights[componentIndex] = density;
-        densitySum += density;
+        m_ComponentVector[componentIndex]->EvaluateLogDensities(
+          begin, end, logDensities.data() + componentIndex * count);
       }
 
-      for (unsigned int componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex)
+      std::vector<double> logWeightedDensities(numberOfComponents);
+      std::vector<double> scaledDensities(numberOfComponents);
+      for (SizeValueType i = begin; i < end; ++i)
       {
-        double temp = tempWeights[static_cast<unsigned int>(componentIndex)];
+        if (!(m_FrequencyBuffer[i] > 0.0))
+        {
+          for (unsigned int componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex)
+          {
+            m_ComponentVector[componentIndex]->SetWeight(i, minDouble);
+          }
+          continue;
+        }
 
-        // just to make sure temp does not blow up!
-        if (densitySum > NumericTraits<double>::epsilon())
+        double maximum = -std::numeric_limits<double>::infinity();
+        for (size_t componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex)
         {
-          temp /= densitySum;
+          logWeightedDensities[componentIndex] =
+            logProportions[componentIndex] + logDensities[componentIndex * count + (i - begin)];
+          maximum = std::max(maximum, logWeightedDensities[componentIndex]);
         }
-        m_ComponentVector[static_cast<unsigned int>(componentIndex)]->SetWeight(measurementVectorIndex, temp);
-      }
-    }
-    else
-    {
-      for (unsigned int componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex)
-      {
-        m_ComponentVector[componentIndex]->SetWeight(measurementVectorIndex, minDouble);
-      }
-    }
 
-    ++iter;
-    ++measurementVectorIndex;
-  }
+        if (!(maximum > -std::numeric_limits<double>::infinity()))
+        {
+          for (unsigned int componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex)
+          {
+            m_ComponentVector[componentIndex]->SetWeight(i, 0.0);
+          }
+          continue;
+        }
+
+        double sum = 0.0;
+        for (size_t componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex)
+        {
+          scaledDensities[componentIndex] = std::exp(logWeightedDensities[componentIndex] - maximum);
+          sum += scaledDensities[componentIndex];
+        }
+
+        // just to make sure the weights do not blow up! The sum of the
+        // densities, exp(maximum) * sum, is larger than epsilon whenever the
+        // maximum is, since sum >= 1.
+        if (maximum > logEpsilon || maximum + std::log(sum) > logEpsilon)
+        {
+          for (unsigned int componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex)
+          {
+            m_ComponentVector[componentIndex]->SetWeight(i, scaledDensities[componentIndex] / sum);
+          }
+        }
+        else
+        {
+          for (unsigned int componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex)
+          {
+            m_ComponentVector[componentIndex]->SetWeight(i, std::exp(logWeightedDensities[componentIndex]));
+          }
+        }
+      }
+    },
+    nullptr);
 
   return true;
 }
@@ -267,9 +320,38 @@ template <typename TSample>
 bool
 ExpectationMaximizationMixtureModelEstimator<TSample>::UpdateProportions()
 {
-  const size_t numberOfComponents = m_ComponentVector.size();
-  const size_t sampleSize = m_Sample->Size();
-  auto         totalFrequency = static_cast<double>(m_Sample->GetTotalFrequency());
+  const size_t        numberOfComponents = m_ComponentVector.size();
+  const SizeValueType numberOfMeasurementVectors = m_FrequencyBuffer.size();
+  auto                totalFrequency = static_cast<double>(m_Sample->GetTotalFrequency());
+
+  std::vector<const double *> weights(numberOfComponents);
+  for (size_t i = 0; i < numberOfComponents; ++i)
+  {
+    weights[i] = m_ComponentVector[i]->GetWeights().data_block();
+  }
+
+  // Sums of the weighted frequencies of the blocks, added in the order of the
+  // blocks.
+  const SizeValueType blockSize = ComponentType::GetBlockSize(numberOfMeasurementVectors);
+  const SizeValueType numberOfBlocks = (numberOfMeasurementVectors + blockSize - 1) / blockSize;
+  std::vector<double> blockSums(numberOfBlocks * numberOfComponents, 0.0);
+
+  m_MultiThreader->SetNumberOfWorkUnits(m_NumberOfWorkUnits);
+  m_MultiThreader->ParallelizeArray(
+    0,
+    numberOfBlocks,
+    [&](SizeValueType block) {
+      double * const      sums = blockSums.data() + block * numberOfComponents;
+      const SizeValueType end = std::min(numberOfMeasurementVectors, (block + 1) * blockSize);
+      for (SizeValueType j = block * blockSize; j < end; ++j)
+      {
+        for (size_t i = 0; i < numberOfComponents; ++i)
+        {
+          sums[i] += weights[i][j] * m_FrequencyBuffer[j];
+        }
+      }
+    },
+    nullptr);
 
   bool updated = false;
 
@@ -279,10 +361,9 @@ ExpectationMaximizationMixtureModelEstimator<TSample>::UpdateProportions()
 
     if (totalFrequency > NumericTraits<double>::epsilon())
     {
-      for (size_t j = 0; j < sampleSize; ++j)
+      for (SizeValueType block = 0; block < numberOfBlocks; ++block)
       {
-        tempSum += (m_ComponentVector[static_cast<unsigned int>(i)]->GetWeight(static_cast<unsigned int>(j)) *
-                    m_Sample->GetFrequency(static_cast<unsigned int>(j)));
+        tempSum += blockSums[block * numberOfComponents + i];
       }
 
       tempSum /= totalFrequency;
@@ -304,23 +385,63 @@ ExpectationMaximizationMixtureModelEstimator<TSample>::GenerateData()
 {
   m_Proportions = m_InitialProportions;
 
-  int iteration = 0;
-  m_CurrentIteration = 0;
-  while (iteration < m_MaxIteration)
+  // Copy the measurement vectors and frequencies of the sample, and share
+  // them with the components during the iterations.
+  const unsigned int  measurementVectorSize = m_Sample->GetMeasurementVectorSize();
+  const SizeValueType numberOfMeasurementVectors = m_Sample->Size();
+  m_MeasurementVectorBuffer.resize(numberOfMeasurementVectors * measurementVectorSize);
+  m_FrequencyBuffer.resize(numberOfMeasurementVectors);
+  SizeValueType measurementVectorIndex = 0;
+  for (typename TSample::ConstIterator iter = m_Sample->Begin(); iter != m_Sample->End(); ++iter)
   {
-    m_CurrentIteration = iteration;
-    if (this->CalculateDensities())
+    const MeasurementVectorType & measurementVector = iter.GetMeasurementVector();
+    double * const measurements = m_MeasurementVectorBuffer.data() + measurementVectorIndex * measurementVectorSize;
+    for (unsigned int d = 0; d < measurementVectorSize; ++d)
+    {
+      measurements[d] = static_cast<double>(measurementVector[d]);
+    }
+    m_FrequencyBuffer[measurementVectorIndex] = static_cast<double>(iter.GetFrequency());
+    ++measurementVectorIndex;
+  }
+
+  const auto setBuffers = [this](const double * measurementVectors, const double * frequencies) {
+    for (ComponentType * component : m_ComponentVector)
     {
-      this->UpdateComponentParameters();
-      this->UpdateProportions();
+      component->SetMeasurementVectorBuffers(measurementVectors, frequencies);
+      component->SetNumberOfWorkUnits(m_NumberOfWorkUnits);
     }
-    else
+  };
+  setBuffers(m_MeasurementVectorBuffer.data(), m_FrequencyBuffer.data());
+
+  int iteration = 0;
+  m_CurrentIteration = 0;
+  try
+  {
+    while (iteration < m_MaxIteration)
     {
-      m_TerminationCode = TERMINATION_CODE_ENUM::CONVERGED;
-      break;
+      m_CurrentIteration = iteration;
+      if (this->CalculateDensities())
+      {
+        this->UpdateComponentParameters();
+        this->UpdateProportions();
+      }
+      else
+      {
+        m_TerminationCode = TERMINATION_CODE_ENUM::CONVERGED;
+        break;
+      }
+      ++iteration;
     }
-    ++iteration;
   }
+  catch (...)
+  {
+    setBuffers(nullptr, nullptr);
+    throw;
+  }
+
+  setBuffers(nullptr, nullptr);
+  m_MeasurementVectorBuffer = std::vector<double>();
+  m_FrequencyBuffer = std::vector<double>();
 
   m_TerminationCode = TERMINATION_CODE_ENUM::NOT_CONVERGED;
 }
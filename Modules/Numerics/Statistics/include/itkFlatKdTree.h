@@ -0,0 +1,258 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFlatKdTree_h
+#define itkFlatKdTree_h
+
+#include "itkObject.h"
+#include "itkMultiThreaderBase.h"
+
+#include <utility>
+#include <vector>
+
+namespace itk
+{
+namespace Statistics
+{
+/**
+ * \class FlatKdTree
+ * \brief Static k-d tree stored in flat arrays, for k-nearest neighbor and
+ * radius searches of many query points.
+ *
+ * Unlike KdTree, whose nodes are allocated one by one and whose terminal
+ * nodes access the measurement vectors through the sample, the tree is
+ * balanced and implicit: the children of the node k are the nodes 2k+1 and
+ * 2k+2, each nonterminal node only stores its partition dimension and value,
+ * and each terminal node is a contiguous range of the measurement vectors.
+ * The measurement vectors are copied by Build(), in the order of the terminal
+ * nodes, with the components along each dimension stored contiguously, so
+ * that the distances to the measurement vectors of a terminal node are
+ * computed in loops that the compiler vectorizes.
+ *
+ * The measurement vectors of a node are split at their median along the
+ * dimension of largest spread, until the number of measurement vectors of the
+ * nodes is less than or equal to the bucket size. The subtrees below the first
+ * levels are built in parallel.
+ *
+ * The Search() methods answer one query, and the BatchSearch() methods answer
+ * many queries in parallel. As in KdTree, the distances are Euclidean
+ * distances; the k nearest neighbors are sorted by increasing distance.
+ *
+ * The tree does not observe the sample: Build() must be called again when the
+ * sample is modified.
+ *
+ * \sa KdTree, KdTreeGenerator
+ * \ingroup ITKStatistics
+ */
+template <typename TSample>
+class ITK_TEMPLATE_EXPORT FlatKdTree : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(FlatKdTree);
+
+  /** Standard class type aliases */
+  using Self = FlatKdTree;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(FlatKdTree);
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** type alias alias for the source data container */
+  using SampleType = TSample;
+  using MeasurementVectorType = typename TSample::MeasurementVectorType;
+  using MeasurementType = typename TSample::MeasurementType;
+  using InstanceIdentifier = typename TSample::InstanceIdentifier;
+
+  using MeasurementVectorSizeType = unsigned int;
+
+  using InstanceIdentifierVectorType = std::vector<InstanceIdentifier>;
+  using DistanceVectorType = std::vector<double>;
+  using MeasurementVectorContainerType = std::vector<MeasurementVectorType>;
+
+  /** Set/Get the sample whose measurement vectors are searched. */
+  itkSetConstObjectMacro(Sample, SampleType);
+  itkGetConstObjectMacro(Sample, SampleType);
+
+  /** Set/Get the largest number of measurement vectors of a terminal node. */
+  itkSetClampMacro(BucketSize, unsigned int, 1, NumericTraits<unsigned int>::max());
+  itkGetConstMacro(BucketSize, unsigned int);
+
+  /** Set/Get the number of work units used to build the tree and to answer
+   * batches of queries. */
+  itkSetClampMacro(NumberOfWorkUnits, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfWorkUnits, ThreadIdType);
+
+  /** Copy the measurement vectors of the sample and build the tree. */
+  void
+  Build();
+
+  /** Get the length of the measurement vectors of the tree. */
+  itkGetConstMacro(MeasurementVectorSize, MeasurementVectorSizeType);
+
+  /** Get the number of measurement vectors of the tree. */
+  SizeValueType
+  Size() const
+  {
+    return static_cast<SizeValueType>(m_Identifiers.size());
+  }
+
+  /** Get the number of levels of nonterminal nodes. */
+  itkGetConstMacro(NumberOfLevels, unsigned int);
+
+  /** Search the k nearest neighbors of a query point. An exception is thrown
+   * if k is larger than the number of measurement vectors. */
+  void
+  Search(const MeasurementVectorType & query, unsigned int k, InstanceIdentifierVectorType & result) const;
+
+  /** Search the k nearest neighbors of a query point, and return their
+   * distances to the query point. */
+  void
+  Search(const MeasurementVectorType &  query,
+         unsigned int                   k,
+         InstanceIdentifierVectorType & result,
+         DistanceVectorType &           distances) const;
+
+  /** Search the measurement vectors whose distance to a query point is less
+   * than or equal to a radius. */
+  void
+  Search(const MeasurementVectorType & query, double radius, InstanceIdentifierVectorType & result) const;
+
+  /** Search in parallel the k nearest neighbors of each query point. The k
+   * neighbors of the query point i are stored from the position i * k of the
+   * results and of the distances. */
+  void
+  BatchSearch(const MeasurementVectorContainerType & queries,
+              unsigned int                           k,
+              InstanceIdentifierVectorType &         results,
+              DistanceVectorType &                   distances) const;
+
+  /** Search in parallel the measurement vectors whose distance to each query
+   * point is less than or equal to a radius. */
+  void
+  BatchSearch(const MeasurementVectorContainerType &      queries,
+              double                                      radius,
+              std::vector<InstanceIdentifierVectorType> & results) const;
+
+protected:
+  FlatKdTree();
+  ~FlatKdTree() override = default;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** Neighbor of a query point: squared distance and position in the tree. */
+  using NeighborType = std::pair<double, SizeValueType>;
+
+  /** Buffers of a search, reused between the queries of a work unit. */
+  struct SearchContextType
+  {
+    std::vector<double>       m_Query;
+    std::vector<double>       m_CellOffsets;
+    std::vector<double>       m_SquaredDistances;
+    std::vector<NeighborType> m_Neighbors;
+  };
+
+  /** Range of the measurement vectors of a node. */
+  struct NodeRangeType
+  {
+    SizeValueType m_Node;
+    SizeValueType m_Begin;
+    SizeValueType m_End;
+    unsigned int  m_Level;
+  };
+
+  /** Split the range of a node of the permutation of the measurement vectors,
+   * and the ranges of its descendants, at their median along the dimension of
+   * largest spread. The nodes of the level stopLevel are not split but
+   * appended to the pending nodes. */
+  void
+  BuildNode(const NodeRangeType &                range,
+            unsigned int                         stopLevel,
+            const std::vector<MeasurementType> & coordinates,
+            std::vector<SizeValueType> &         permutation,
+            std::vector<NodeRangeType> &         pendingNodes);
+
+  /** Copy the query point in the context and clear its buffers. */
+  void
+  InitializeContext(SearchContextType & context, const MeasurementVectorType & query) const;
+
+  /** Compute in the context the squared distances from the query point to the
+   * measurement vectors of a terminal node. */
+  void
+  ComputeLeafSquaredDistances(SearchContextType & context, const NodeRangeType & range) const;
+
+  /** Search the nearest neighbors in a node, whose squared distance to the
+   * query point is at least cellDistance. */
+  void
+  SearchNearestNeighborsInNode(SearchContextType &   context,
+                               unsigned int          k,
+                               const NodeRangeType & range,
+                               double                cellDistance) const;
+
+  /** Search the measurement vectors of a node within a radius. */
+  void
+  SearchRadiusInNode(SearchContextType &            context,
+                     double                         squaredRadius,
+                     const NodeRangeType &          range,
+                     double                         cellDistance,
+                     InstanceIdentifierVectorType & result) const;
+
+  /** Search the k nearest neighbors of a query point, and store them sorted
+   * in the neighbors of the context. */
+  void
+  ComputeNearestNeighbors(SearchContextType & context, const MeasurementVectorType & query, unsigned int k) const;
+
+  /** Get the range of the root node. */
+  NodeRangeType
+  GetRootRange() const
+  {
+    return NodeRangeType{ 0, 0, this->Size(), 0 };
+  }
+
+  typename SampleType::ConstPointer m_Sample{};
+  unsigned int                      m_BucketSize{ 16 };
+  ThreadIdType                      m_NumberOfWorkUnits{};
+  MeasurementVectorSizeType         m_MeasurementVectorSize{};
+  unsigned int                      m_NumberOfLevels{};
+
+  /** Components of the measurement vectors in the order of the tree: the
+   * component d of the measurement vector at position i is at the position
+   * d * Size() + i. */
+  std::vector<MeasurementType> m_Coordinates{};
+
+  /** Instance identifiers of the measurement vectors in the order of the tree. */
+  InstanceIdentifierVectorType m_Identifiers{};
+
+  /** Partition dimensions and values of the nonterminal nodes. */
+  std::vector<unsigned int> m_PartitionDimensions{};
+  std::vector<double>       m_PartitionValues{};
+
+  MultiThreaderBase::Pointer m_MultiThreader{};
+}; // end of class
+} // end of namespace Statistics
+} // end of namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkFlatKdTree.hxx"
+#endif
+
+#endif
@@ -0,0 +1,466 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFlatKdTree_hxx
+#define itkFlatKdTree_hxx
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace itk
+{
+namespace Statistics
+{
+template <typename TSample>
+FlatKdTree<TSample>::FlatKdTree()
+  : m_NumberOfWorkUnits(MultiThreaderBase::GetGlobalDefaultNumberOfThreads())
+  , m_MultiThreader(MultiThreaderBase::New())
+{}
+
+template <typename TSample>
+void
+FlatKdTree<TSample>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Input Sample: ";
+  if (this->m_Sample != nullptr)
+  {
+    os << this->m_Sample << std::endl;
+  }
+  else
+  {
+    os << "not set." << std::endl;
+  }
+  os << indent << "Bucket Size: " << this->m_BucketSize << std::endl;
+  os << indent << "NumberOfWorkUnits: " << this->m_NumberOfWorkUnits << std::endl;
+  os << indent << "MeasurementVectorSize: " << this->m_MeasurementVectorSize << std::endl;
+  os << indent << "NumberOfLevels: " << this->m_NumberOfLevels << std::endl;
+  os << indent << "Size: " << this->Size() << std::endl;
+}
+
+template <typename TSample>
+void
+FlatKdTree<TSample>::Build()
+{
+  if (this->m_Sample == nullptr)
+  {
+    itkExceptionMacro("Sample is not set.");
+  }
+
+  const MeasurementVectorSizeType dimension = this->m_Sample->GetMeasurementVectorSize();
+  const auto                      numberOfVectors = static_cast<SizeValueType>(this->m_Sample->Size());
+
+  // Components of the measurement vectors in the order of the sample.
+  std::vector<MeasurementType> coordinates(dimension * numberOfVectors);
+  InstanceIdentifierVectorType identifiers(numberOfVectors);
+  SizeValueType                position = 0;
+  for (auto it = this->m_Sample->Begin(); it != this->m_Sample->End(); ++it, ++position)
+  {
+    identifiers[position] = it.GetInstanceIdentifier();
+    const MeasurementVectorType & measurementVector = it.GetMeasurementVector();
+    for (unsigned int d = 0; d < dimension; ++d)
+    {
+      coordinates[d * numberOfVectors + position] = measurementVector[d];
+    }
+  }
+
+  this->m_MeasurementVectorSize = dimension;
+  this->m_NumberOfLevels = 0;
+  for (SizeValueType leafSize = numberOfVectors; leafSize > this->m_BucketSize; leafSize = (leafSize + 1) / 2)
+  {
+    ++this->m_NumberOfLevels;
+  }
+  const SizeValueType numberOfNonterminalNodes = (SizeValueType{ 1 } << this->m_NumberOfLevels) - 1;
+  this->m_PartitionDimensions.assign(numberOfNonterminalNodes, 0);
+  this->m_PartitionValues.assign(numberOfNonterminalNodes, 0.0);
+  this->m_Identifiers.resize(numberOfVectors);
+
+  // The first levels are built serially, until there are enough subtrees to
+  // keep the work units busy, and the subtrees are built in parallel.
+  unsigned int stopLevel = this->m_NumberOfLevels;
+  if (this->m_NumberOfWorkUnits > 1)
+  {
+    stopLevel = 0;
+    while (stopLevel < this->m_NumberOfLevels && (SizeValueType{ 1 } << stopLevel) < 4 * this->m_NumberOfWorkUnits)
+    {
+      ++stopLevel;
+    }
+  }
+
+  std::vector<SizeValueType> permutation(numberOfVectors);
+  std::iota(permutation.begin(), permutation.end(), SizeValueType{ 0 });
+  std::vector<NodeRangeType> subtrees;
+  this->BuildNode(this->GetRootRange(), stopLevel, coordinates, permutation, subtrees);
+
+  this->m_MultiThreader->SetNumberOfWorkUnits(this->m_NumberOfWorkUnits);
+  this->m_MultiThreader->ParallelizeArray(
+    0,
+    subtrees.size(),
+    [this, &subtrees, &coordinates, &permutation](SizeValueType subtree) {
+      std::vector<NodeRangeType> pendingNodes;
+      this->BuildNode(subtrees[subtree], this->m_NumberOfLevels, coordinates, permutation, pendingNodes);
+    },
+    nullptr);
+
+  this->m_Coordinates.resize(dimension * numberOfVectors);
+  for (SizeValueType i = 0; i < numberOfVectors; ++i)
+  {
+    this->m_Identifiers[i] = identifiers[permutation[i]];
+  }
+  for (unsigned int d = 0; d < dimension; ++d)
+  {
+    const MeasurementType * source = coordinates.data() + d * numberOfVectors;
+    MeasurementType *       destination = this->m_Coordinates.data() + d * numberOfVectors;
+    for (SizeValueType i = 0; i < numberOfVectors; ++i)
+    {
+      destination[i] = source[permutation[i]];
+    }
+  }
+}
+
+template <typename TSample>
+void
+FlatKdTree<TSample>::BuildNode(const NodeRangeType &                range,
+                               unsigned int                         stopLevel,
+                               const std::vector<MeasurementType> & coordinates,
+                               std::vector<SizeValueType> &         permutation,
+                               std::vector<NodeRangeType> &         pendingNodes)
+{
+  if (range.m_Level == this->m_NumberOfLevels)
+  {
+    return;
+  }
+  if (range.m_Level == stopLevel)
+  {
+    pendingNodes.push_back(range);
+    return;
+  }
+
+  const SizeValueType numberOfVectors = permutation.size();
+  const SizeValueType middle = range.m_Begin + (range.m_End - range.m_Begin) / 2;
+
+  unsigned int partitionDimension = 0;
+  double       partitionValue = 0.0;
+  if (range.m_Begin < range.m_End)
+  {
+    double largestSpread = -1.0;
+    for (unsigned int d = 0; d < this->m_MeasurementVectorSize; ++d)
+    {
+      const MeasurementType * component = coordinates.data() + d * numberOfVectors;
+      MeasurementType         lower = component[permutation[range.m_Begin]];
+      MeasurementType         upper = lower;
+      for (SizeValueType i = range.m_Begin + 1; i < range.m_End; ++i)
+      {
+        lower = std::min(lower, component[permutation[i]]);
+        upper = std::max(upper, component[permutation[i]]);
+      }
+      const double spread = static_cast<double>(upper) - static_cast<double>(lower);
+      if (spread > largestSpread)
+      {
+        largestSpread = spread;
+        partitionDimension = d;
+      }
+    }
+
+    const MeasurementType * component = coordinates.data() + partitionDimension * numberOfVectors;
+    std::nth_element(permutation.begin() + range.m_Begin,
+                     permutation.begin() + middle,
+                     permutation.begin() + range.m_End,
+                     [component](SizeValueType a, SizeValueType b) { return component[a] < component[b]; });
+    partitionValue = component[permutation[middle]];
+  }
+  this->m_PartitionDimensions[range.m_Node] = partitionDimension;
+  this->m_PartitionValues[range.m_Node] = partitionValue;
+
+  const NodeRangeType lowerChild{ 2 * range.m_Node + 1, range.m_Begin, middle, range.m_Level + 1 };
+  const NodeRangeType upperChild{ 2 * range.m_Node + 2, middle, range.m_End, range.m_Level + 1 };
+  this->BuildNode(lowerChild, stopLevel, coordinates, permutation, pendingNodes);
+  this->BuildNode(upperChild, stopLevel, coordinates, permutation, pendingNodes);
+}
+
+template <typename TSample>
+void
+FlatKdTree<TSample>::InitializeContext(SearchContextType & context, const MeasurementVectorType & query) const
+{
+  context.m_Query.resize(this->m_MeasurementVectorSize);
+  for (unsigned int d = 0; d < this->m_MeasurementVectorSize; ++d)
+  {
+    context.m_Query[d] = query[d];
+  }
+  context.m_CellOffsets.assign(this->m_MeasurementVectorSize, 0.0);
+  context.m_Neighbors.clear();
+}
+
+template <typename TSample>
+void
+FlatKdTree<TSample>::ComputeLeafSquaredDistances(SearchContextType & context, const NodeRangeType & range) const
+{
+  const SizeValueType numberOfVectors = this->Size();
+  const SizeValueType count = range.m_End - range.m_Begin;
+
+  context.m_SquaredDistances.assign(count, 0.0);
+  double * squaredDistances = context.m_SquaredDistances.data();
+  for (unsigned int d = 0; d < this->m_MeasurementVectorSize; ++d)
+  {
+    const MeasurementType * component = this->m_Coordinates.data() + d * numberOfVectors + range.m_Begin;
+    const double            queryComponent = context.m_Query[d];
+    for (SizeValueType i = 0; i < count; ++i)
+    {
+      const double difference = static_cast<double>(component[i]) - queryComponent;
+      squaredDistances[i] += difference * difference;
+    }
+  }
+}
+
+template <typename TSample>
+void
+FlatKdTree<TSample>::SearchNearestNeighborsInNode(SearchContextType &   context,
+                                                  unsigned int          k,
+                                                  const NodeRangeType & range,
+                                                  double                cellDistance) const
+{
+  std::vector<NeighborType> & neighbors = context.m_Neighbors;
+
+  if (range.m_Level == this->m_NumberOfLevels)
+  {
+    this->ComputeLeafSquaredDistances(context, range);
+    for (SizeValueType i = 0; i < range.m_End - range.m_Begin; ++i)
+    {
+      const NeighborType neighbor(context.m_SquaredDistances[i], range.m_Begin + i);
+      if (neighbors.size() < k)
+      {
+        neighbors.push_back(neighbor);
+        std::push_heap(neighbors.begin(), neighbors.end());
+      }
+      else if (neighbor < neighbors.front())
+      {
+        std::pop_heap(neighbors.begin(), neighbors.end());
+        neighbors.back() = neighbor;
+        std::push_heap(neighbors.begin(), neighbors.end());
+      }
+    }
+    return;
+  }
+
+  const unsigned int  partitionDimension = this->m_PartitionDimensions[range.m_Node];
+  const double        difference = context.m_Query[partitionDimension] - this->m_PartitionValues[range.m_Node];
+  const SizeValueType middle = range.m_Begin + (range.m_End - range.m_Begin) / 2;
+  const NodeRangeType lowerChild{ 2 * range.m_Node + 1, range.m_Begin, middle, range.m_Level + 1 };
+  const NodeRangeType upperChild{ 2 * range.m_Node + 2, middle, range.m_End, range.m_Level + 1 };
+
+  this->SearchNearestNeighborsInNode(context, k, difference < 0.0 ? lowerChild : upperChild, cellDistance);
+
+  // The far child is beyond the partition value along the partition dimension.
+  const double oldOffset = context.m_CellOffsets[partitionDimension];
+  const double newOffset = std::max(oldOffset, std::abs(difference));
+  const double farCellDistance = cellDistance - oldOffset * oldOffset + newOffset * newOffset;
+  if (neighbors.size() < k || farCellDistance <= neighbors.front().first)
+  {
+    context.m_CellOffsets[partitionDimension] = newOffset;
+    this->SearchNearestNeighborsInNode(context, k, difference < 0.0 ? upperChild : lowerChild, farCellDistance);
+    context.m_CellOffsets[partitionDimension] = oldOffset;
+  }
+}
+
+template <typename TSample>
+void
+FlatKdTree<TSample>::SearchRadiusInNode(SearchContextType &            context,
+                                        double                         squaredRadius,
+                                        const NodeRangeType &          range,
+                                        double                         cellDistance,
+                                        InstanceIdentifierVectorType & result) const
+{
+  if (range.m_Level == this->m_NumberOfLevels)
+  {
+    this->ComputeLeafSquaredDistances(context, range);
+    for (SizeValueType i = 0; i < range.m_End - range.m_Begin; ++i)
+    {
+      if (context.m_SquaredDistances[i] <= squaredRadius)
+      {
+        result.push_back(this->m_Identifiers[range.m_Begin + i]);
+      }
+    }
+    return;
+  }
+
+  const unsigned int  partitionDimension = this->m_PartitionDimensions[range.m_Node];
+  const double        difference = context.m_Query[partitionDimension] - this->m_PartitionValues[range.m_Node];
+  const SizeValueType middle = range.m_Begin + (range.m_End - range.m_Begin) / 2;
+  const NodeRangeType lowerChild{ 2 * range.m_Node + 1, range.m_Begin, middle, range.m_Level + 1 };
+  const NodeRangeType upperChild{ 2 * range.m_Node + 2, middle, range.m_End, range.m_Level + 1 };
+
+  this->SearchRadiusInNode(context, squaredRadius, difference < 0.0 ? lowerChild : upperChild, cellDistance, result);
+
+  const double oldOffset = context.m_CellOffsets[partitionDimension];
+  const double newOffset = std::max(oldOffset, std::abs(difference));
+  const double farCellDistance = cellDistance - oldOffset * oldOffset + newOffset * newOffset;
+  if (farCellDistance <= squaredRadius)
+  {
+    context.m_CellOffsets[partitionDimension] = newOffset;
+    this->SearchRadiusInNode(
+      context, squaredRadius, difference < 0.0 ? upperChild : lowerChild, farCellDistance, result);
+    context.m_CellOffsets[partitionDimension] = oldOffset;
+  }
+}
+
+template <typename TSample>
+void
+FlatKdTree<TSample>::ComputeNearestNeighbors(SearchContextType &           context,
+                                             const MeasurementVectorType & query,
+                                             unsigned int                  k) const
+{
+  if (k > this->Size())
+  {
+    itkExceptionMacro("The numberOfNeighborsRequested for the nearest "
+                      << "neighbor search should be less than or equal to the number of "
+                      << "the measurement vectors.");
+  }
+
+  this->InitializeContext(context, query);
+  if (k > 0)
+  {
+    this->SearchNearestNeighborsInNode(context, k, this->GetRootRange(), 0.0);
+  }
+  std::sort_heap(context.m_Neighbors.begin(), context.m_Neighbors.end());
+}
+
+template <typename TSample>
+void
+FlatKdTree<TSample>::Search(const MeasurementVectorType &  query,
+                            unsigned int                   k,
+                            InstanceIdentifierVectorType & result) const
+{
+  DistanceVectorType distances;
+  this->Search(query, k, result, distances);
+}
+
+template <typename TSample>
+void
+FlatKdTree<TSample>::Search(const MeasurementVectorType &  query,
+                            unsigned int                   k,
+                            InstanceIdentifierVectorType & result,
+                            DistanceVectorType &           distances) const
+{
+  SearchContextType context;
+  this->ComputeNearestNeighbors(context, query, k);
+
+  result.resize(k);
+  distances.resize(k);
+  for (unsigned int i = 0; i < k; ++i)
+  {
+    result[i] = this->m_Identifiers[context.m_Neighbors[i].second];
+    distances[i] = std::sqrt(context.m_Neighbors[i].first);
+  }
+}
+
+template <typename TSample>
+void
+FlatKdTree<TSample>::Search(const MeasurementVectorType &  query,
+                            double                         radius,
+                            InstanceIdentifierVectorType & result) const
+{
+  result.clear();
+  if (this->Size() == 0 || radius < 0.0)
+  {
+    return;
+  }
+
+  SearchContextType context;
+  this->InitializeContext(context, query);
+  this->SearchRadiusInNode(context, radius * radius, this->GetRootRange(), 0.0, result);
+}
+
+template <typename TSample>
+void
+FlatKdTree<TSample>::BatchSearch(const MeasurementVectorContainerType & queries,
+                                 unsigned int                           k,
+                                 InstanceIdentifierVectorType &         results,
+                                 DistanceVectorType &                   distances) const
+{
+  if (k > this->Size())
+  {
+    itkExceptionMacro("The numberOfNeighborsRequested for the nearest "
+                      << "neighbor search should be less than or equal to the number of "
+                      << "the measurement vectors.");
+  }
+
+  const SizeValueType numberOfQueries = queries.size();
+  results.resize(numberOfQueries * k);
+  distances.resize(numberOfQueries * k);
+
+  // The queries are processed in blocks, so that the buffers of a search are
+  // reused between the queries of a block.
+  constexpr SizeValueType blockSize = 64;
+  const SizeValueType     numberOfBlocks = (numberOfQueries + blockSize - 1) / blockSize;
+
+  this->m_MultiThreader->SetNumberOfWorkUnits(this->m_NumberOfWorkUnits);
+  this->m_MultiThreader->ParallelizeArray(
+    0,
+    numberOfBlocks,
+    [this, &queries, k, &results, &distances, numberOfQueries](SizeValueType block) {
+      SearchContextType   context;
+      const SizeValueType end = std::min(numberOfQueries, (block + 1) * blockSize);
+      for (SizeValueType query = block * blockSize; query < end; ++query)
+      {
+        this->ComputeNearestNeighbors(context, queries[query], k);
+        for (unsigned int i = 0; i < k; ++i)
+        {
+          results[query * k + i] = this->m_Identifiers[context.m_Neighbors[i].second];
+          distances[query * k + i] = std::sqrt(context.m_Neighbors[i].first);
+        }
+      }
+    },
+    nullptr);
+}
+
+template <typename TSample>
+void
+FlatKdTree<TSample>::BatchSearch(const MeasurementVectorContainerType &      queries,
+                                 double                                      radius,
+                                 std::vector<InstanceIdentifierVectorType> & results) const
+{
+  const SizeValueType numberOfQueries = queries.size();
+  results.resize(numberOfQueries);
+
+  constexpr SizeValueType blockSize = 64;
+  const SizeValueType     numberOfBlocks = (numberOfQueries + blockSize - 1) / blockSize;
+
+  this->m_MultiThreader->SetNumberOfWorkUnits(this->m_NumberOfWorkUnits);
+  this->m_MultiThreader->ParallelizeArray(
+    0,
+    numberOfBlocks,
+    [this, &queries, radius, &results, numberOfQueries](SizeValueType block) {
+      SearchContextType   context;
+      const SizeValueType end = std::min(numberOfQueries, (block + 1) * blockSize);
+      for (SizeValueType query = block * blockSize; query < end; ++query)
+      {
+        results[query].clear();
+        if (this->Size() > 0 && radius >= 0.0)
+        {
+          this->InitializeContext(context, queries[query]);
+          this->SearchRadiusInNode(context, radius * radius, this->GetRootRange(), 0.0, results[query]);
+        }
+      }
+    },
+    nullptr);
+}
+} // end of namespace Statistics
+} // end of namespace itk
+
+#endif
@@ -18,6 +18,8 @@
 #ifndef itkGaussianMembershipFunction_h
 #define itkGaussianMembershipFunction_h
 
+#include <vector>
+
 #include "itkMatrix.h"
 #include "itkMembershipFunctionBase.h"
 
@@ -49,6 +51,12 @@ namespace Statistics
  * will return small but differentiable values everywhere and increase
  * sharply near the mean.
  *
+ * BatchEvaluate() and BatchEvaluateLogDensities() evaluate a block of
+ * measurement vectors together: the differences to the mean are transposed
+ * in chunks, so that each term of the quadratic form of the inverse
+ * covariance, whose coefficients are computed with the inverse covariance, is
+ * accumulated over a chunk of contiguous values.
+ *
  * \ingroup ITKStatistics
  */
 
@@ -109,10 +117,28 @@ public:
   VariableSizeMatrix of doubles. */
   itkGetConstReferenceMacro(InverseCovariance, CovarianceMatrixType);
 
+  /** Get the normalization term of the density, computed whenever the
+   * covariance matrix is changed. */
+  itkGetConstMacro(PreFactor, double);
+
   /** Evaluate the probability density of a measurement vector. */
   double
   Evaluate(const MeasurementVectorType & measurement) const override;
 
+  /** Evaluate the probability densities of contiguous measurement vectors. */
+  void
+  BatchEvaluate(const double * measurementVectors,
+                SizeValueType  numberOfMeasurementVectors,
+                double *       densities) const override;
+
+  /** Evaluate the natural logarithms of the probability densities of
+   * contiguous measurement vectors, which do not underflow far from the
+   * mean. */
+  void
+  BatchEvaluateLogDensities(const double * measurementVectors,
+                            SizeValueType  numberOfMeasurementVectors,
+                            double *       logDensities) const;
+
   /** Method to clone a membership function, i.e. create a new instance of
    * the same type of membership function and configure its ivars to
    * match. */
@@ -139,6 +165,21 @@ private:
 
   /** Boolean to cache whether the covariance is singular or nearly singular */
   bool m_CovarianceNonsingular{};
+
+  /** Coefficients of the quadratic form of the inverse covariance: for
+   * r <= c, row after row, InverseCovariance(r, r), or
+   * InverseCovariance(r, c) + InverseCovariance(c, r). */
+  std::vector<double> m_QuadraticFormCoefficients{};
+
+  void
+  UpdateQuadraticFormCoefficients();
+
+  /** Compute (x - m)^t InverseCovariance (x - m) for contiguous measurement
+   * vectors. */
+  void
+  BatchEvaluateQuadraticForms(const double * measurementVectors,
+                              SizeValueType  numberOfMeasurementVectors,
+                              double *       quadraticForms) const;
 };
 } // end of namespace Statistics
 } // end namespace itk
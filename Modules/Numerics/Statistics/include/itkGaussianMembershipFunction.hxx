@@ -18,6 +18,8 @@
 #ifndef itkGaussianMembershipFunction_hxx
 #define itkGaussianMembershipFunction_hxx
 
+#include <algorithm>
+#include <cmath>
 
 namespace itk
 {
@@ -37,6 +39,8 @@ GaussianMembershipFunction<TMeasurementVector>::GaussianMembershipFunction()
   m_InverseCovariance = m_Covariance;
 
   m_CovarianceNonsingular = true;
+
+  this->UpdateQuadraticFormCoefficients();
 }
 
 template <typename TMeasurementVector>
@@ -141,10 +145,28 @@ GaussianMembershipFunction<TMeasurementVector>::SetCovariance(const CovarianceMa
 
     m_PreFactor = 1.0;
   }
+  this->UpdateQuadraticFormCoefficients();
 
   this->Modified();
 }
 
+template <typename TMeasurementVector>
+void
+GaussianMembershipFunction<TMeasurementVector>::UpdateQuadraticFormCoefficients()
+{
+  const unsigned int size = m_InverseCovariance.Rows();
+
+  m_QuadraticFormCoefficients.clear();
+  for (unsigned int r = 0; r < size; ++r)
+  {
+    m_QuadraticFormCoefficients.push_back(m_InverseCovariance(r, r));
+    for (unsigned int c = r + 1; c < size; ++c)
+    {
+      m_QuadraticFormCoefficients.push_back(m_InverseCovariance(r, c) + m_InverseCovariance(c, r));
+    }
+  }
+}
+
 template <typename TMeasurementVector>
 inline double
 GaussianMembershipFunction<TMeasurementVector>::Evaluate(const MeasurementVectorType & measurement) const
@@ -172,6 +194,80 @@ GaussianMembershipFunction<TMeasurementVector>::Evaluate(const MeasurementVector
   return m_PreFactor * temp;
 }
 
+template <typename TMeasurementVector>
+void
+GaussianMembershipFunction<TMeasurementVector>::BatchEvaluateQuadraticForms(const double * measurementVectors,
+                                                                            SizeValueType  numberOfMeasurementVectors,
+                                                                            double *       quadraticForms) const
+{
+  const MeasurementVectorSizeType measurementVectorSize = this->GetMeasurementVectorSize();
+  itkAssertInDebugAndIgnoreInReleaseMacro(m_QuadraticFormCoefficients.size() ==
+                                          measurementVectorSize * (measurementVectorSize + 1) / 2);
+
+  // The differences of a chunk of measurement vectors are stored dimension
+  // after dimension.
+  constexpr SizeValueType chunkSize = 64;
+  std::vector<double>     differences(measurementVectorSize * chunkSize);
+
+  for (SizeValueType chunkBegin = 0; chunkBegin < numberOfMeasurementVectors; chunkBegin += chunkSize)
+  {
+    const SizeValueType count = std::min(chunkSize, numberOfMeasurementVectors - chunkBegin);
+
+    for (SizeValueType j = 0; j < count; ++j)
+    {
+      const double * const measurements = measurementVectors + (chunkBegin + j) * measurementVectorSize;
+      for (MeasurementVectorSizeType d = 0; d < measurementVectorSize; ++d)
+      {
+        differences[d * chunkSize + j] = measurements[d] - m_Mean[d];
+      }
+    }
+
+    double * const chunkQuadraticForms = quadraticForms + chunkBegin;
+    std::fill_n(chunkQuadraticForms, count, 0.0);
+    const double * coefficient = m_QuadraticFormCoefficients.data();
+    for (MeasurementVectorSizeType r = 0; r < measurementVectorSize; ++r)
+    {
+      const double * const rowDifferences = differences.data() + r * chunkSize;
+      for (MeasurementVectorSizeType c = r; c < measurementVectorSize; ++c, ++coefficient)
+      {
+        const double * const columnDifferences = differences.data() + c * chunkSize;
+        const double         a = *coefficient;
+        for (SizeValueType j = 0; j < count; ++j)
+        {
+          chunkQuadraticForms[j] += a * rowDifferences[j] * columnDifferences[j];
+        }
+      }
+    }
+  }
+}
+
+template <typename TMeasurementVector>
+void
+GaussianMembershipFunction<TMeasurementVector>::BatchEvaluateLogDensities(const double * measurementVectors,
+                                                                          SizeValueType  numberOfMeasurementVectors,
+                                                                          double *       logDensities) const
+{
+  this->BatchEvaluateQuadraticForms(measurementVectors, numberOfMeasurementVectors, logDensities);
+  const double logPreFactor = std::log(m_PreFactor);
+  for (SizeValueType i = 0; i < numberOfMeasurementVectors; ++i)
+  {
+    logDensities[i] = logPreFactor - 0.5 * logDensities[i];
+  }
+}
+
+template <typename TMeasurementVector>
+void
+GaussianMembershipFunction<TMeasurementVector>::BatchEvaluate(const double * measurementVectors,
+                                                              SizeValueType  numberOfMeasurementVectors,
+                                                              double *       densities) const
+{
+  this->BatchEvaluateQuadraticForms(measurementVectors, numberOfMeasurementVectors, densities);
+  for (SizeValueType i = 0; i < numberOfMeasurementVectors; ++i)
+  {
+    densities[i] = m_PreFactor * std::exp(-0.5 * densities[i]);
+  }
+}
+
 template <typename TVector>
 typename LightObject::Pointer
 GaussianMembershipFunction<TVector>::InternalClone() const
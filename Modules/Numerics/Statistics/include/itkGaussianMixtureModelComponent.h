@@ -36,6 +36,12 @@ namespace Statistics
  * On every iteration of EM estimation, this class's GenerateData
  * method is called to compute the new distribution parameters.
  *
+ * When the measurement vector buffers are set, the weighted mean and
+ * covariance are computed from the sums of blocks of measurement vectors in
+ * parallel, and the logarithms of the densities of a block of measurement
+ * vectors are evaluated together with
+ * GaussianMembershipFunction::BatchEvaluateLogDensities().
+ *
  * <b>Recent API changes:</b>
  * The static const macro to get the length of a measurement vector,
  * \c MeasurementVectorSize  has been removed to allow the length of a measurement
@@ -90,6 +96,11 @@ public:
   void
   SetParameters(const ParametersType & parameters) override;
 
+  /** Computes the logarithms of the Gaussian densities of the measurement
+   * vectors [begin, end) of the measurement vector buffer. */
+  void
+  EvaluateLogDensities(SizeValueType begin, SizeValueType end, double * logDensities) const override;
+
 protected:
   GaussianMixtureModelComponent();
   ~GaussianMixtureModelComponent() override = default;
@@ -106,6 +117,13 @@ protected:
   GenerateData() override;
 
 private:
+  /** Computes the weighted mean and covariance of the measurement vector
+   * buffer, as WeightedMeanSampleFilter and WeightedCovarianceSampleFilter,
+   * from sums over blocks of measurement vectors. */
+  void
+  ComputeWeightedMeanAndCovariance(typename MeanEstimatorType::MeasurementVectorType & mean,
+                                   typename CovarianceEstimatorType::MatrixType &      covariance) const;
+
   typename NativeMembershipFunctionType::Pointer m_GaussianMembershipFunction{};
 
   typename MeanEstimatorType::MeasurementVectorType m_Mean{};
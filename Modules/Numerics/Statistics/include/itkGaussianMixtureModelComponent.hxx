@@ -18,6 +18,8 @@
 #ifndef itkGaussianMixtureModelComponent_hxx
 #define itkGaussianMixtureModelComponent_hxx
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 #include "itkMath.h"
@@ -131,6 +133,142 @@ GaussianMixtureModelComponent<TSample>::SetParameters(const ParametersType & par
   this->AreParametersModified(changed);
 }
 
+template <typename TSample>
+void
+GaussianMixtureModelComponent<TSample>::EvaluateLogDensities(SizeValueType begin,
+                                                             SizeValueType end,
+                                                             double *      logDensities) const
+{
+  const MeasurementVectorSizeType measurementVectorSize = this->GetSample()->GetMeasurementVectorSize();
+
+  m_GaussianMembershipFunction->BatchEvaluateLogDensities(
+    this->GetMeasurementVectorBuffer() + begin * measurementVectorSize, end - begin, logDensities);
+}
+
+template <typename TSample>
+void
+GaussianMixtureModelComponent<TSample>::ComputeWeightedMeanAndCovariance(
+  typename MeanEstimatorType::MeasurementVectorType & mean,
+  typename CovarianceEstimatorType::MatrixType &      covariance) const
+{
+  const MeasurementVectorSizeType measurementVectorSize = this->GetSample()->GetMeasurementVectorSize();
+  const SizeValueType             numberOfMeasurementVectors = this->GetSample()->Size();
+  const double * const            measurementVectors = this->GetMeasurementVectorBuffer();
+  const double * const            frequencies = this->GetFrequencyBuffer();
+  const double * const            weights = this->GetWeights().data_block();
+
+  const SizeValueType blockSize = Superclass::GetBlockSize(numberOfMeasurementVectors);
+  const SizeValueType numberOfBlocks = (numberOfMeasurementVectors + blockSize - 1) / blockSize;
+
+  // The sums of the blocks are added in the order of the blocks, so that
+  // they do not depend on the number of work units.
+  const auto reduce = [numberOfBlocks](const std::vector<double> & blockSums, std::vector<double> & sums) {
+    const size_t numberOfSums = sums.size();
+    std::fill(sums.begin(), sums.end(), 0.0);
+    for (SizeValueType block = 0; block < numberOfBlocks; ++block)
+    {
+      for (size_t k = 0; k < numberOfSums; ++k)
+      {
+        sums[k] += blockSums[block * numberOfSums + k];
+      }
+    }
+  };
+
+  // Weighted sums of the measurement vectors, and total weight.
+  const unsigned int  numberOfMeanSums = measurementVectorSize + 1;
+  std::vector<double> blockSums(numberOfBlocks * numberOfMeanSums, 0.0);
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfBlocks,
+    [&](SizeValueType block) {
+      double * const      sums = blockSums.data() + block * numberOfMeanSums;
+      const SizeValueType blockEnd = std::min(numberOfMeasurementVectors, (block + 1) * blockSize);
+      for (SizeValueType i = block * blockSize; i < blockEnd; ++i)
+      {
+        const double         weight = weights[i] * frequencies[i];
+        const double * const measurements = measurementVectors + i * measurementVectorSize;
+        for (MeasurementVectorSizeType d = 0; d < measurementVectorSize; ++d)
+        {
+          sums[d] += weight * measurements[d];
+        }
+        sums[measurementVectorSize] += weight;
+      }
+    },
+    nullptr);
+
+  std::vector<double> meanSums(numberOfMeanSums);
+  reduce(blockSums, meanSums);
+  const double totalWeight = meanSums[measurementVectorSize];
+  if (!(totalWeight > itk::Math::eps))
+  {
+    itkExceptionMacro("Total weight was too close to zero. Value = " << totalWeight);
+  }
+  std::vector<double> meanValues(measurementVectorSize);
+  for (MeasurementVectorSizeType d = 0; d < measurementVectorSize; ++d)
+  {
+    meanValues[d] = meanSums[d] / totalWeight;
+  }
+
+  // Weighted sums of the products of the differences to the mean, for the
+  // lower triangle of the covariance, and total squared weight.
+  const unsigned int numberOfCovarianceSums = measurementVectorSize * (measurementVectorSize + 1) / 2 + 1;
+  blockSums.assign(numberOfBlocks * numberOfCovarianceSums, 0.0);
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfBlocks,
+    [&](SizeValueType block) {
+      double * const      sums = blockSums.data() + block * numberOfCovarianceSums;
+      std::vector<double> differences(measurementVectorSize);
+      const SizeValueType blockEnd = std::min(numberOfMeasurementVectors, (block + 1) * blockSize);
+      for (SizeValueType i = block * blockSize; i < blockEnd; ++i)
+      {
+        const double         weight = weights[i] * frequencies[i];
+        const double * const measurements = measurementVectors + i * measurementVectorSize;
+        for (MeasurementVectorSizeType d = 0; d < measurementVectorSize; ++d)
+        {
+          differences[d] = measurements[d] - meanValues[d];
+        }
+        unsigned int k = 0;
+        for (MeasurementVectorSizeType row = 0; row < measurementVectorSize; ++row)
+        {
+          const double weightedDifference = weight * differences[row];
+          for (MeasurementVectorSizeType col = 0; col <= row; ++col, ++k)
+          {
+            sums[k] += weightedDifference * differences[col];
+          }
+        }
+        sums[k] += weight * weight;
+      }
+    },
+    nullptr);
+
+  std::vector<double> covarianceSums(numberOfCovarianceSums);
+  reduce(blockSums, covarianceSums);
+  const double totalSquaredWeight = covarianceSums[numberOfCovarianceSums - 1];
+  const double normalizationFactor = totalWeight - (totalSquaredWeight / totalWeight);
+  if (!(normalizationFactor > itk::Math::eps))
+  {
+    itkExceptionMacro("Normalization factor was too close to zero. Value = " << normalizationFactor);
+  }
+
+  NumericTraits<typename MeanEstimatorType::MeasurementVectorType>::SetLength(mean, measurementVectorSize);
+  for (MeasurementVectorSizeType d = 0; d < measurementVectorSize; ++d)
+  {
+    mean[d] = static_cast<typename TSample::MeasurementType>(meanValues[d]);
+  }
+
+  covariance.SetSize(measurementVectorSize, measurementVectorSize);
+  unsigned int k = 0;
+  for (MeasurementVectorSizeType row = 0; row < measurementVectorSize; ++row)
+  {
+    for (MeasurementVectorSizeType col = 0; col <= row; ++col, ++k)
+    {
+      covariance(row, col) = covarianceSums[k] / normalizationFactor;
+      covariance(col, row) = covariance(row, col);
+    }
+  }
+}
+
 template <typename TSample>
 double
 GaussianMixtureModelComponent<TSample>::CalculateParametersChange()
@@ -170,28 +308,27 @@ GaussianMixtureModelComponent<TSample>::GenerateData()
 
   this->AreParametersModified(false);
 
-  const WeightArrayType & weights = this->GetWeights();
-
-  typename TSample::ConstIterator       iter = this->GetSample()->Begin();
-  const typename TSample::ConstIterator end = this->GetSample()->End();
-
-  typename TSample::MeasurementVectorType measurements;
-
-  // why these lines???
-  while (iter != end)
+  typename MeanEstimatorType::MeasurementVectorType meanEstimate;
+  typename CovarianceEstimatorType::MatrixType      covEstimate;
+  if (this->GetMeasurementVectorBuffer() != nullptr)
   {
-    measurements = iter.GetMeasurementVector();
-    ++iter;
+    this->ComputeWeightedMeanAndCovariance(meanEstimate, covEstimate);
+  }
+  else
+  {
+    const WeightArrayType & weights = this->GetWeights();
+    m_MeanEstimator->SetWeights(weights);
+    m_MeanEstimator->Update();
+    meanEstimate = m_MeanEstimator->GetMean();
+    m_CovarianceEstimator->SetWeights(weights);
+    m_CovarianceEstimator->Update();
+    covEstimate = m_CovarianceEstimator->GetCovarianceMatrix();
   }
-
-  m_MeanEstimator->SetWeights(weights);
-  m_MeanEstimator->Update();
 
   bool                      changed = false;
   ParametersType            parameters = this->GetFullParameters();
   MeasurementVectorSizeType paramIndex = 0;
 
-  typename MeanEstimatorType::MeasurementVectorType meanEstimate = m_MeanEstimator->GetMean();
   for (MeasurementVectorSizeType i = 0; i < measurementVectorSize; ++i)
   {
     const double changes = itk::Math::abs(m_Mean[i] - meanEstimate[i]);
@@ -217,10 +354,6 @@ GaussianMixtureModelComponent<TSample>::GenerateData()
     paramIndex = measurementVectorSize;
   }
 
-  m_CovarianceEstimator->SetWeights(weights);
-  m_CovarianceEstimator->Update();
-  typename CovarianceEstimatorType::MatrixType covEstimate = m_CovarianceEstimator->GetCovarianceMatrix();
-
   changed = false;
   for (MeasurementVectorSizeType i = 0; i < measurementVectorSize; ++i)
   {
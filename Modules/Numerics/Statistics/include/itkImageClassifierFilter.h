@@ -41,6 +41,12 @@ namespace Statistics
  *  This class is templated over the type of input and output image and
  *  sample type.
  *
+ *  The pixels are classified in parallel, in blocks of contiguous pixels of
+ *  the same line: each membership function evaluates a whole block with
+ *  MembershipFunctionBase::BatchEvaluate(), and the decision rule labels the
+ *  block with DecisionRule::BatchEvaluate(). The length of the pixels must be
+ *  the measurement vector size of the membership functions.
+ *
  * \sa SampleClassifierFilter
  * \ingroup ITKStatistics
  */
@@ -151,13 +157,25 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
-  /** Starts the classification process */
+  /** Check the inputs of the classification */
+  void
+  BeforeThreadedGenerateData() override;
+
+  /** Classify the pixels of a region */
   void
-  GenerateData() override;
+  DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
 
 private:
+  /** Number of pixels of the blocks */
+  static constexpr SizeValueType BlockSize = 256;
+
   unsigned int m_NumberOfClasses{};
 
+  /** Weights of the membership functions and length of the pixels, set
+   * before the pixels are classified. */
+  MembershipFunctionsWeightsArrayType m_MembershipFunctionsWeights{};
+  unsigned int                        m_MeasurementVectorSize{};
+
   /** Decision Rule */
   DecisionRulePointer m_DecisionRule{};
 }; // end of class
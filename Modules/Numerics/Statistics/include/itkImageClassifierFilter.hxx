@@ -18,7 +18,7 @@
 #ifndef itkImageClassifierFilter_hxx
 #define itkImageClassifierFilter_hxx
 
-#include "itkImageRegionIterator.h"
+#include "itkImageScanlineIterator.h"
 
 namespace itk
 {
@@ -30,6 +30,7 @@ ImageClassifierFilter<TSample, TInputImage, TOutputImage>::ImageClassifierFilter
   this->m_NumberOfClasses = 0;
   this->SetNumberOfRequiredInputs(3);
   this->SetNumberOfRequiredOutputs(1);
+  this->DynamicMultiThreadingOn();
 
   /** Initialize decision rule */
   m_DecisionRule = nullptr;
@@ -91,7 +92,7 @@ ImageClassifierFilter<TSample, TInputImage, TOutputImage>::SetMembershipFunction
 
 template <typename TSample, typename TInputImage, typename TOutputImage>
 void
-ImageClassifierFilter<TSample, TInputImage, TOutputImage>::GenerateData()
+ImageClassifierFilter<TSample, TInputImage, TOutputImage>::BeforeThreadedGenerateData()
 {
   const auto * classLabelsDecorated = static_cast<const ClassLabelVectorObjectType *>(this->ProcessObject::GetInput(1));
 
@@ -141,41 +142,87 @@ ImageClassifierFilter<TSample, TInputImage, TOutputImage>::GenerateData()
     itkExceptionMacro("Membership functions weight array size does not match the number of classes ");
   }
 
+  m_MembershipFunctionsWeights = membershipFunctionsWeightsArray;
+
   const auto * inputImage = static_cast<const InputImageType *>(this->ProcessObject::GetInput(0));
+  m_MeasurementVectorSize = inputImage->GetNumberOfComponentsPerPixel();
+}
+
+template <typename TSample, typename TInputImage, typename TOutputImage>
+void
+ImageClassifierFilter<TSample, TInputImage, TOutputImage>::DynamicThreadedGenerateData(
+  const OutputImageRegionType & outputRegionForThread)
+{
+  const auto & classLabels = static_cast<const ClassLabelVectorObjectType *>(this->ProcessObject::GetInput(1))->Get();
+  const auto & membershipFunctions =
+    static_cast<const MembershipFunctionVectorObjectType *>(this->ProcessObject::GetInput(2))->Get();
 
-  std::vector<double> discriminantScores;
-  discriminantScores.resize(this->m_NumberOfClasses);
+  const auto * inputImage = static_cast<const InputImageType *>(this->ProcessObject::GetInput(0));
+  auto *       outputImage = this->GetOutput();
 
-  auto * outputImage = dynamic_cast<OutputImageType *>(this->ProcessObject::GetOutput(0));
+  const unsigned int numberOfClasses = this->m_NumberOfClasses;
+  const unsigned int measurementVectorSize = m_MeasurementVectorSize;
 
-  outputImage->CopyInformation(inputImage);
-  outputImage->SetRegions(inputImage->GetBufferedRegion());
-  outputImage->Allocate();
+  // Measurement vectors of a block, one after the other, and their scores,
+  // class after class.
+  std::vector<double>                                measurementVectors(BlockSize * measurementVectorSize);
+  std::vector<double>                                discriminantScores(BlockSize * numberOfClasses);
+  std::vector<DecisionRuleType::ClassIdentifierType> classIndices(BlockSize);
 
-  ImageRegionConstIterator<InputImageType> inpItr(inputImage, inputImage->GetBufferedRegion());
-  ImageRegionIterator<OutputImageType>     outItr(outputImage, outputImage->GetBufferedRegion());
+  MeasurementVectorType measurements;
 
-  inpItr.GoToBegin();
-  outItr.GoToBegin();
+  ImageScanlineConstIterator<InputImageType> inpItr(inputImage, outputRegionForThread);
+  ImageScanlineIterator<OutputImageType>     outItr(outputImage, outputRegionForThread);
 
   while (!inpItr.IsAtEnd())
   {
-    MeasurementVectorType measurements;
-
-    MeasurementVectorTraits::Assign(measurements, inpItr.Get());
-
-    for (unsigned int i = 0; i < this->m_NumberOfClasses; ++i)
+    while (!inpItr.IsAtEndOfLine())
     {
-      discriminantScores[i] = membershipFunctionsWeightsArray[i] * membershipFunctions[i]->Evaluate(measurements);
+      SizeValueType count = 0;
+      for (; count < BlockSize && !inpItr.IsAtEndOfLine(); ++count, ++inpItr)
+      {
+        MeasurementVectorTraits::Assign(measurements, inpItr.Get());
+        for (unsigned int d = 0; d < measurementVectorSize; ++d)
+        {
+          measurementVectors[count * measurementVectorSize + d] = static_cast<double>(measurements[d]);
+        }
+      }
+
+      for (unsigned int i = 0; i < numberOfClasses; ++i)
+      {
+        double * const scores = discriminantScores.data() + i * count;
+        if (membershipFunctions[i]->GetMeasurementVectorSize() == measurementVectorSize)
+        {
+          membershipFunctions[i]->BatchEvaluate(measurementVectors.data(), count, scores);
+        }
+        else
+        {
+          // The measurement vector size of the membership function was not
+          // set: evaluate it one pixel at a time.
+          for (SizeValueType j = 0; j < count; ++j)
+          {
+            for (unsigned int d = 0; d < measurementVectorSize; ++d)
+            {
+              measurements[d] = static_cast<MeasurementType>(measurementVectors[j * measurementVectorSize + d]);
+            }
+            scores[j] = membershipFunctions[i]->Evaluate(measurements);
+          }
+        }
+        for (SizeValueType j = 0; j < count; ++j)
+        {
+          scores[j] *= m_MembershipFunctionsWeights[i];
+        }
+      }
+
+      m_DecisionRule->BatchEvaluate(discriminantScores.data(), numberOfClasses, count, classIndices.data());
+
+      for (SizeValueType j = 0; j < count; ++j, ++outItr)
+      {
+        outItr.Set(static_cast<OutputPixelType>(classLabels[classIndices[j]]));
+      }
     }
-
-    const auto classIndex = static_cast<unsigned int>(m_DecisionRule->Evaluate(discriminantScores));
-
-    auto value = static_cast<OutputPixelType>(classLabels[classIndex]);
-    outItr.Set(value);
-
-    ++inpItr;
-    ++outItr;
+    inpItr.NextLine();
+    outItr.NextLine();
   }
 }
 } // end of namespace Statistics
@@ -18,7 +18,9 @@
 #ifndef itkImageToHistogramFilter_h
 #define itkImageToHistogramFilter_h
 
+#include <memory>
 #include <mutex>
+#include <vector>
 
 #include "itkHistogram.h"
 #include "itkImageSink.h"
@@ -40,8 +42,18 @@ namespace Statistics
  * This filter is automatically multi-threaded. When
  * AutoMinimumMaximum is off and the NumberOfStreamDivisions is set to more than
  * one, then this filter streams its input in a series of requested
- * regions. A histogram is computed for each streamed and threaded
- * region then merged.
+ * regions. The frequencies of each streamed and threaded region are
+ * accumulated in the frequencies of a work unit, which are added to the
+ * output histogram once the whole input is processed.
+ *
+ * The bins of the output histogram are uniform, so the bin of each component
+ * of a pixel is computed arithmetically, and only checked against the bin
+ * minimum and maximum, instead of being searched in the bins. For scalar
+ * images, the bins of a whole line of pixels are computed at once. The frequencies
+ * of a work unit are stored in a dense array, except for the joint histograms
+ * of three or more components, whose number of bins is usually much larger
+ * than the number of pixels, where they are stored in a
+ * SparseFrequencyContainer2.
  *
  * \ingroup ITKStatistics
  */
@@ -76,6 +88,9 @@ public:
   using HistogramSizeType = typename HistogramType::SizeType;
   using HistogramMeasurementType = typename HistogramType::MeasurementType;
   using HistogramMeasurementVectorType = typename HistogramType::MeasurementVectorType;
+  using HistogramIndexType = typename HistogramType::IndexType;
+  using InstanceIdentifier = typename HistogramType::InstanceIdentifier;
+  using AbsoluteFrequencyType = typename HistogramType::AbsoluteFrequencyType;
 
 public:
   /** Return the output histogram. */
@@ -170,12 +185,52 @@ protected:
   ThreadedComputeMinimumAndMaximum(const RegionType & inputRegionForThread);
 
 
+  /** Add the frequencies of a histogram, with the bins of the output
+   * histogram, to the output histogram. */
   virtual void
   ThreadedMergeHistogram(HistogramPointer && histogram);
 
-  std::mutex m_Mutex{};
+  /** Frequencies of the bins of the output histogram accumulated by a work
+   * unit, either in a dense array or in a sparse container. */
+  struct ThreadFrequencies
+  {
+    std::vector<AbsoluteFrequencyType> m_Dense{};
+    SparseFrequencyContainer2::Pointer m_Sparse{};
+
+    void
+    IncreaseFrequency(InstanceIdentifier id, AbsoluteFrequencyType value)
+    {
+      if (m_Sparse)
+      {
+        m_Sparse->IncreaseFrequency(id, value);
+      }
+      else
+      {
+        m_Dense[id] += value;
+      }
+    }
+  };
+  using ThreadFrequenciesPointer = std::unique_ptr<ThreadFrequencies>;
+
+  /** Get frequencies which are not used by another work unit, to accumulate
+   * the frequencies of a region, and give them back once the region is
+   * processed. They are added to the output histogram after the last
+   * streamed region. */
+  ThreadFrequenciesPointer
+  AcquireThreadFrequencies();
+  void
+  ReleaseThreadFrequencies(ThreadFrequenciesPointer && frequencies);
 
-  HistogramPointer m_MergeHistogram{};
+  /** Compute the instance identifier of the output histogram bin of a
+   * measurement vector. Return false when the measurement vector is outside
+   * of the histogram bins clipped at their ends. The index is a work array,
+   * only used when the bins of a component are not contiguous. */
+  bool
+  ComputeInstanceIdentifier(const HistogramMeasurementVectorType & measurement,
+                            HistogramIndexType &                   index,
+                            InstanceIdentifier &                   id) const;
+
+  std::mutex m_Mutex{};
 
   HistogramMeasurementVectorType m_Minimum{};
   HistogramMeasurementVectorType m_Maximum{};
@@ -185,6 +240,44 @@ private:
   ApplyMarginalScale(HistogramMeasurementVectorType & min,
                      HistogramMeasurementVectorType & max,
                      HistogramSizeType &              size);
+
+  /** Cache the bins of the output histogram to compute the bins of the
+   * measurement vectors. */
+  void
+  InitializeBins();
+
+  /** Bin of a component of a measurement vector, computed arithmetically,
+   * which may be off by one because of the rounding of the bin bounds. */
+  IndexValueType
+  ComputeApproximateBin(unsigned int component, HistogramMeasurementType value) const
+  {
+    HistogramMeasurementType bin = (value - m_BinMinimums[component][0]) * m_BinScales[component];
+    bin = bin > 0 ? bin : 0;
+    bin = bin < m_LastBins[component] ? bin : m_LastBins[component];
+    return static_cast<IndexValueType>(bin);
+  }
+
+  /** Bin of a component of a measurement vector, as Histogram::GetIndex()
+   * finds it, from its approximate bin. Return false when the component is
+   * clipped. */
+  bool
+  CorrectBin(unsigned int component, HistogramMeasurementType value, IndexValueType & bin) const;
+
+  /** Compute the frequencies of the pixels of a region of a scalar image, a
+   * line at a time. */
+  void
+  ThreadedComputeScalarFrequencies(const RegionType & inputRegionForThread, ThreadFrequencies & frequencies);
+
+  std::vector<ThreadFrequenciesPointer> m_ThreadFrequencies{};
+  bool                                  m_UseSparseFrequencies{ false };
+
+  std::vector<std::vector<HistogramMeasurementType>> m_BinMinimums{};
+  std::vector<std::vector<HistogramMeasurementType>> m_BinMaximums{};
+  std::vector<HistogramMeasurementType>              m_BinScales{};
+  std::vector<HistogramMeasurementType>              m_LastBins{};
+  std::vector<InstanceIdentifier>                    m_BinOffsets{};
+  bool                                               m_ContiguousBins{ false };
+  bool                                               m_ClipBinsAtEnds{ true };
 };
 } // end of namespace Statistics
 } // end of namespace itk
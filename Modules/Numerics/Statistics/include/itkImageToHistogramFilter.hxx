@@ -19,6 +19,10 @@
 #define itkImageToHistogramFilter_hxx
 
 #include "itkImageRegionConstIterator.h"
+#include "itkImageScanlineConstIterator.h"
+#include "itkMath.h"
+
+#include <type_traits>
 
 namespace itk
 {
@@ -121,7 +125,8 @@ ImageToHistogramFilter<TImage>::InitializeOutputHistogram()
   m_Minimum.Fill(NumericTraits<ValueType>::max());
   m_Maximum.Fill(NumericTraits<ValueType>::NonpositiveMin());
 
-  m_MergeHistogram = nullptr;
+  m_ThreadFrequencies.clear();
+  m_UseSparseFrequencies = nbOfComponents >= 3;
 
   HistogramType * outputHistogram = this->GetOutput();
   outputHistogram->SetClipBinsAtEnds(true);
@@ -178,6 +183,166 @@ ImageToHistogramFilter<TImage>::InitializeOutputHistogram()
 
   outputHistogram->SetMeasurementVectorSize(nbOfComponents);
   outputHistogram->Initialize(size, m_Minimum, m_Maximum);
+
+  this->InitializeBins();
+}
+
+
+template <typename TImage>
+void
+ImageToHistogramFilter<TImage>::InitializeBins()
+{
+  const HistogramType * histogram = this->GetOutput();
+  const unsigned int    nbOfComponents = histogram->GetMeasurementVectorSize();
+
+  m_ClipBinsAtEnds = histogram->GetClipBinsAtEnds();
+  m_BinMinimums.resize(nbOfComponents);
+  m_BinMaximums.resize(nbOfComponents);
+  m_BinScales.assign(nbOfComponents, 0);
+  m_LastBins.assign(nbOfComponents, 0);
+  m_BinOffsets.resize(nbOfComponents);
+
+  // The bins of a component are contiguous when each bin is not empty, and
+  // starts at the end of the previous bin.
+  m_ContiguousBins = true;
+  InstanceIdentifier offset = 1;
+  for (unsigned int i = 0; i < nbOfComponents; ++i)
+  {
+    m_BinMinimums[i] = histogram->GetDimensionMins(i);
+    m_BinMaximums[i] = histogram->GetDimensionMaxs(i);
+    m_BinOffsets[i] = offset;
+    const SizeValueType size = histogram->GetSize(i);
+    offset *= size;
+    if (size == 0)
+    {
+      m_ContiguousBins = false;
+      continue;
+    }
+    for (SizeValueType j = 0; j < size; ++j)
+    {
+      if (!(m_BinMinimums[i][j] < m_BinMaximums[i][j]) || (j > 0 && m_BinMinimums[i][j] != m_BinMaximums[i][j - 1]))
+      {
+        m_ContiguousBins = false;
+      }
+    }
+    m_BinScales[i] = static_cast<HistogramMeasurementType>(size) / (m_BinMaximums[i][size - 1] - m_BinMinimums[i][0]);
+    m_LastBins[i] = static_cast<HistogramMeasurementType>(size - 1);
+  }
+}
+
+
+template <typename TImage>
+bool
+ImageToHistogramFilter<TImage>::CorrectBin(unsigned int             component,
+                                           HistogramMeasurementType value,
+                                           IndexValueType &         bin) const
+{
+  const std::vector<HistogramMeasurementType> & minimums = m_BinMinimums[component];
+  const std::vector<HistogramMeasurementType> & maximums = m_BinMaximums[component];
+  const auto                                    last = static_cast<IndexValueType>(minimums.size()) - 1;
+
+  if (value < minimums[0])
+  {
+    if (m_ClipBinsAtEnds)
+    {
+      return false;
+    }
+    bin = 0;
+    return true;
+  }
+  if (value >= maximums[last])
+  {
+    // Need to include the last endpoint in the last bin.
+    if (!m_ClipBinsAtEnds || Math::AlmostEquals(value, maximums[last]))
+    {
+      bin = last;
+      return true;
+    }
+    return false;
+  }
+  if (Math::isnan(value))
+  {
+    // The bin where the binary search of Histogram::GetIndex() stops
+    bin = (last + 1) / 2;
+    return true;
+  }
+
+  while (value < minimums[bin])
+  {
+    --bin;
+  }
+  while (value >= maximums[bin])
+  {
+    ++bin;
+  }
+  return true;
+}
+
+
+template <typename TImage>
+bool
+ImageToHistogramFilter<TImage>::ComputeInstanceIdentifier(const HistogramMeasurementVectorType & measurement,
+                                                          HistogramIndexType &                   index,
+                                                          InstanceIdentifier &                   id) const
+{
+  if (!m_ContiguousBins)
+  {
+    const HistogramType * histogram = this->GetOutput();
+    if (!histogram->GetIndex(measurement, index))
+    {
+      return false;
+    }
+    id = histogram->GetInstanceIdentifier(index);
+    return true;
+  }
+
+  id = 0;
+  for (unsigned int i = 0; i < m_BinOffsets.size(); ++i)
+  {
+    IndexValueType bin = this->ComputeApproximateBin(i, measurement[i]);
+    if (!this->CorrectBin(i, measurement[i], bin))
+    {
+      return false;
+    }
+    id += static_cast<InstanceIdentifier>(bin) * m_BinOffsets[i];
+  }
+  return true;
+}
+
+
+template <typename TImage>
+auto
+ImageToHistogramFilter<TImage>::AcquireThreadFrequencies() -> ThreadFrequenciesPointer
+{
+  {
+    const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+    if (!m_ThreadFrequencies.empty())
+    {
+      ThreadFrequenciesPointer frequencies = std::move(m_ThreadFrequencies.back());
+      m_ThreadFrequencies.pop_back();
+      return frequencies;
+    }
+  }
+
+  auto frequencies = std::make_unique<ThreadFrequencies>();
+  if (m_UseSparseFrequencies)
+  {
+    frequencies->m_Sparse = SparseFrequencyContainer2::New();
+  }
+  else
+  {
+    frequencies->m_Dense.assign(this->GetOutput()->Size(), 0);
+  }
+  return frequencies;
+}
+
+
+template <typename TImage>
+void
+ImageToHistogramFilter<TImage>::ReleaseThreadFrequencies(ThreadFrequenciesPointer && frequencies)
+{
+  const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+  m_ThreadFrequencies.push_back(std::move(frequencies));
 }
 
 
@@ -188,8 +353,48 @@ ImageToHistogramFilter<TImage>::AfterStreamedGenerateData()
   Superclass::AfterStreamedGenerateData();
 
   HistogramType * outputHistogram = this->GetOutput();
-  outputHistogram->Graft(m_MergeHistogram);
-  m_MergeHistogram = nullptr;
+  if (m_UseSparseFrequencies)
+  {
+    for (const ThreadFrequenciesPointer & frequencies : m_ThreadFrequencies)
+    {
+      for (auto it = frequencies->m_Sparse->Begin(); it != frequencies->m_Sparse->End(); ++it)
+      {
+        outputHistogram->IncreaseFrequency(it->first, it->second);
+      }
+    }
+  }
+  else if (!m_ThreadFrequencies.empty())
+  {
+    // The frequencies of the work units are added in parallel, by blocks of
+    // bins, to the frequencies of the first work unit.
+    std::vector<AbsoluteFrequencyType> & frequencies = m_ThreadFrequencies[0]->m_Dense;
+    const SizeValueType                  numberOfBins = frequencies.size();
+    constexpr SizeValueType              blockSize = 4096;
+    this->GetMultiThreader()->ParallelizeArray(
+      0,
+      (numberOfBins + blockSize - 1) / blockSize,
+      [this, &frequencies, numberOfBins](SizeValueType block) {
+        const SizeValueType end = std::min(numberOfBins, (block + 1) * blockSize);
+        for (size_t i = 1; i < m_ThreadFrequencies.size(); ++i)
+        {
+          const std::vector<AbsoluteFrequencyType> & threadFrequencies = m_ThreadFrequencies[i]->m_Dense;
+          for (SizeValueType id = block * blockSize; id < end; ++id)
+          {
+            frequencies[id] += threadFrequencies[id];
+          }
+        }
+      },
+      nullptr);
+
+    for (SizeValueType id = 0; id < numberOfBins; ++id)
+    {
+      if (frequencies[id] != 0)
+      {
+        outputHistogram->IncreaseFrequency(id, frequencies[id]);
+      }
+    }
+  }
+  m_ThreadFrequencies.clear();
 }
 
 
@@ -231,69 +436,101 @@ template <typename TImage>
 void
 ImageToHistogramFilter<TImage>::ThreadedStreamedGenerateData(const RegionType & inputRegionForThread)
 {
-  const unsigned int    nbOfComponents = this->GetInput()->GetNumberOfComponentsPerPixel();
-  const HistogramType * outputHistogram = this->GetOutput();
-
-  HistogramPointer histogram = HistogramType::New();
-  histogram->SetClipBinsAtEnds(outputHistogram->GetClipBinsAtEnds());
-  histogram->SetMeasurementVectorSize(nbOfComponents);
-  histogram->Initialize(outputHistogram->GetSize(), m_Minimum, m_Maximum);
+  ThreadFrequenciesPointer frequencies = this->AcquireThreadFrequencies();
 
+  if constexpr (std::is_arithmetic_v<PixelType>)
+  {
+    if (m_ContiguousBins)
+    {
+      this->ThreadedComputeScalarFrequencies(inputRegionForThread, *frequencies);
+      this->ReleaseThreadFrequencies(std::move(frequencies));
+      return;
+    }
+  }
 
+  const unsigned int               nbOfComponents = this->GetInput()->GetNumberOfComponentsPerPixel();
   ImageRegionConstIterator<TImage> inputIt(this->GetInput(), inputRegionForThread);
   inputIt.GoToBegin();
   HistogramMeasurementVectorType m(nbOfComponents);
 
-  typename HistogramType::IndexType index;
+  HistogramIndexType index(nbOfComponents);
+  InstanceIdentifier id;
   while (!inputIt.IsAtEnd())
   {
     const PixelType & p = inputIt.Get();
     NumericTraits<PixelType>::AssignToArray(p, m);
-    histogram->GetIndex(m, index);
-    histogram->IncreaseFrequencyOfIndex(index, 1);
+    if (this->ComputeInstanceIdentifier(m, index, id))
+    {
+      frequencies->IncreaseFrequency(id, 1);
+    }
     ++inputIt;
   }
 
-  this->ThreadedMergeHistogram(std::move(histogram));
+  this->ReleaseThreadFrequencies(std::move(frequencies));
 }
 
 template <typename TImage>
 void
-ImageToHistogramFilter<TImage>::ThreadedMergeHistogram(HistogramPointer && histogram)
+ImageToHistogramFilter<TImage>::ThreadedComputeScalarFrequencies(const RegionType &  inputRegionForThread,
+                                                                 ThreadFrequencies & frequencies)
 {
-  while (true)
+  const SizeValueType                   lineLength = inputRegionForThread.GetSize(0);
+  std::vector<HistogramMeasurementType> values(lineLength);
+  std::vector<HistogramMeasurementType> approximateBins(lineLength);
+
+  const HistogramMeasurementType minimum = m_BinMinimums[0][0];
+  const HistogramMeasurementType scale = m_BinScales[0];
+  const HistogramMeasurementType lastBin = m_LastBins[0];
+
+  ImageScanlineConstIterator<TImage> inputIt(this->GetInput(), inputRegionForThread);
+  while (!inputIt.IsAtEnd())
   {
-    HistogramPointer tomergeHistogram{};
+    SizeValueType n = 0;
+    while (!inputIt.IsAtEndOfLine())
     {
-      const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+      values[n++] = static_cast<HistogramMeasurementType>(inputIt.Get());
+      ++inputIt;
+    }
 
-      if (m_MergeHistogram.IsNull())
+    // Approximate bins of the line, as ComputeApproximateBin(), in a loop
+    // without branches, calls nor integer conversions so that the compiler
+    // can vectorize it.
+    for (SizeValueType i = 0; i < n; ++i)
+    {
+      HistogramMeasurementType bin = (values[i] - minimum) * scale;
+      bin = bin > 0 ? bin : 0;
+      approximateBins[i] = bin < lastBin ? bin : lastBin;
+    }
+
+    for (SizeValueType i = 0; i < n; ++i)
+    {
+      auto bin = static_cast<IndexValueType>(approximateBins[i]);
+      if (this->CorrectBin(0, values[i], bin))
       {
-        m_MergeHistogram = std::move(histogram);
-        return;
+        ++frequencies.m_Dense[bin];
       }
+    }
+    inputIt.NextLine();
+  }
+}
 
-      // merge/reduce the local results with current values in m_MergeHistogram
-
-      // take ownership locally
-      swap(m_MergeHistogram, tomergeHistogram);
-
-    } // release lock, allow other threads to merge data
-
-    using HistogramIterator = typename HistogramType::ConstIterator;
-
-    HistogramIterator       hit = tomergeHistogram->Begin();
-    const HistogramIterator end = tomergeHistogram->End();
-
-    typename HistogramType::IndexType index;
+template <typename TImage>
+void
+ImageToHistogramFilter<TImage>::ThreadedMergeHistogram(HistogramPointer && histogram)
+{
+  ThreadFrequenciesPointer frequencies = this->AcquireThreadFrequencies();
 
-    while (hit != end)
+  const InstanceIdentifier numberOfBins = histogram->Size();
+  for (InstanceIdentifier id = 0; id < numberOfBins; ++id)
+  {
+    const AbsoluteFrequencyType frequency = histogram->GetFrequency(id);
+    if (frequency != 0)
     {
-      histogram->GetIndex(hit.GetMeasurementVector(), index);
-      histogram->IncreaseFrequencyOfIndex(index, hit.GetFrequency());
-      ++hit;
+      frequencies->IncreaseFrequency(id, frequency);
     }
   }
+
+  this->ReleaseThreadFrequencies(std::move(frequencies));
 }
 
 template <typename TImage>
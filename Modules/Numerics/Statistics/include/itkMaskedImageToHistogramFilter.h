@@ -72,6 +72,8 @@ public:
   using HistogramSizeType = typename HistogramType::SizeType;
   using HistogramMeasurementType = typename HistogramType::MeasurementType;
   using HistogramMeasurementVectorType = typename HistogramType::MeasurementVectorType;
+  using HistogramIndexType = typename HistogramType::IndexType;
+  using InstanceIdentifier = typename HistogramType::InstanceIdentifier;
 
   using MaskImageType = TMaskImage;
   using MaskPixelType = typename MaskImageType::PixelType;
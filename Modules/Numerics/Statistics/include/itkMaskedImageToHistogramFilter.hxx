@@ -78,13 +78,8 @@ template <typename TImage, typename TMaskImage>
 void
 MaskedImageToHistogramFilter<TImage, TMaskImage>::ThreadedStreamedGenerateData(const RegionType & inputRegionForThread)
 {
-  const unsigned int    nbOfComponents = this->GetInput()->GetNumberOfComponentsPerPixel();
-  const HistogramType * outputHistogram = this->GetOutput();
-
-  HistogramPointer histogram = HistogramType::New();
-  histogram->SetClipBinsAtEnds(outputHistogram->GetClipBinsAtEnds());
-  histogram->SetMeasurementVectorSize(nbOfComponents);
-  histogram->Initialize(outputHistogram->GetSize(), this->m_Minimum, this->m_Maximum);
+  const unsigned int nbOfComponents = this->GetInput()->GetNumberOfComponentsPerPixel();
+  auto               frequencies = this->AcquireThreadFrequencies();
 
   ImageRegionConstIterator<TImage>     inputIt(this->GetInput(), inputRegionForThread);
   ImageRegionConstIterator<TMaskImage> maskIt(this->GetMaskImage(), inputRegionForThread);
@@ -93,22 +88,24 @@ MaskedImageToHistogramFilter<TImage, TMaskImage>::ThreadedStreamedGenerateData(c
   HistogramMeasurementVectorType m(nbOfComponents);
   const MaskPixelType            maskValue = this->GetMaskValue();
 
-  typename HistogramType::IndexType index;
+  HistogramIndexType index(nbOfComponents);
+  InstanceIdentifier id;
   while (!inputIt.IsAtEnd())
   {
     if (maskIt.Get() == maskValue)
     {
       const PixelType & p = inputIt.Get();
       NumericTraits<PixelType>::AssignToArray(p, m);
-      histogram->GetIndex(m, index);
-      histogram->IncreaseFrequencyOfIndex(index, 1);
+      if (this->ComputeInstanceIdentifier(m, index, id))
+      {
+        frequencies->IncreaseFrequency(id, 1);
+      }
     }
     ++inputIt;
     ++maskIt;
   }
 
-
-  this->ThreadedMergeHistogram(std::move(histogram));
+  this->ReleaseThreadFrequencies(std::move(frequencies));
 }
 
 } // end of namespace Statistics
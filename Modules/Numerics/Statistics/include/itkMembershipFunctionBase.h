@@ -51,6 +51,10 @@ namespace Statistics
  * can then be passed to a DecisionRule in order to establish
  * class (or group) assignment.
  *
+ * BatchEvaluate() computes the membership scores of a block of contiguous
+ * measurement vectors. It evaluates each of them with Evaluate() by default,
+ * and subclasses may override it with a faster evaluation of the whole block.
+ *
  * \ingroup ITKStatistics
  */
 
@@ -81,6 +85,25 @@ public:
   double
   Evaluate(const MeasurementVectorType & x) const override = 0;
 
+  /** Compute the membership scores of numberOfMeasurementVectors
+   * measurement vectors, whose MeasurementVectorSize components are stored
+   * one after the other in measurementVectors. */
+  virtual void
+  BatchEvaluate(const double * measurementVectors, SizeValueType numberOfMeasurementVectors, double * scores) const
+  {
+    MeasurementVectorType measurementVector;
+    NumericTraits<MeasurementVectorType>::SetLength(measurementVector, m_MeasurementVectorSize);
+    for (SizeValueType i = 0; i < numberOfMeasurementVectors; ++i)
+    {
+      for (MeasurementVectorSizeType d = 0; d < m_MeasurementVectorSize; ++d)
+      {
+        measurementVector[d] = static_cast<typename MeasurementVectorTraitsTypes<MeasurementVectorType>::ValueType>(
+          measurementVectors[i * m_MeasurementVectorSize + d]);
+      }
+      scores[i] = this->Evaluate(measurementVector);
+    }
+  }
+
   /** Set the length of the measurement vector. If this membership
    * function is templated over a vector type that can be resized,
    * the new size is set. If the vector type has a fixed size and an
@@ -64,6 +64,17 @@ public:
   ClassIdentifierType
   Evaluate(const MembershipVectorType & discriminantScores) const override;
 
+  /**
+   * Evaluate the decision rule for several measurement vectors, returning
+   * for each of them the class label associated with the smallest
+   * discriminant score, as Evaluate().
+   */
+  void
+  BatchEvaluate(const MembershipValueType * discriminantScores,
+                unsigned int                numberOfClasses,
+                SizeValueType               numberOfMeasurementVectors,
+                ClassIdentifierType *       classIdentifiers) const override;
+
 protected:
   MinimumDecisionRule() = default;
   ~MinimumDecisionRule() override = default;
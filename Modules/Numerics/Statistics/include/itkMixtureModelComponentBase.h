@@ -18,12 +18,15 @@
 #ifndef itkMixtureModelComponentBase_h
 #define itkMixtureModelComponentBase_h
 
+#include <algorithm>
+
 #include "vnl/vnl_vector.h"
 #include "vnl/vnl_matrix.h"
 
 #include "itkArray.h"
 #include "itkObject.h"
 #include "itkMembershipFunctionBase.h"
+#include "itkMultiThreaderBase.h"
 
 namespace itk
 {
@@ -49,6 +52,15 @@ namespace Statistics
  * MembershipFunctionBase object. By doing that, users can get pointers
  * to membership functions from different distributional model
  *
+ * ExpectationMaximizationMixtureModelEstimator copies the measurement vectors
+ * and frequencies of the sample once in contiguous buffers, and sets them to
+ * its components with SetMeasurementVectorBuffers(), so that the membership
+ * scores and the parameters are computed in parallel over blocks of
+ * contiguous measurement vectors. EvaluateLogDensities() evaluates the
+ * membership function of a block with MembershipFunctionBase::BatchEvaluate()
+ * by default, and subclasses may override it, for instance to evaluate the
+ * logarithms directly.
+ *
  * \sa ExpectationMaximizationMixtureModelEstimator
  * \ingroup ITKStatistics
  */
@@ -77,6 +89,21 @@ public:
 
   using ParametersType = Array<double>;
 
+  /** The measurement vectors are processed in blocks of at least
+   * MinimumBlockSize measurement vectors, and in at most
+   * MaximumNumberOfBlocks blocks, whatever the number of work units, so that
+   * the sums over the blocks do not depend on the number of work units. */
+  static constexpr SizeValueType MinimumBlockSize = 1024;
+  static constexpr SizeValueType MaximumNumberOfBlocks = 256;
+
+  /** Number of measurement vectors of the blocks of a sample of the given
+   * size. */
+  static SizeValueType
+  GetBlockSize(SizeValueType numberOfMeasurementVectors)
+  {
+    return std::max(MinimumBlockSize, (numberOfMeasurementVectors + MaximumNumberOfBlocks - 1) / MaximumNumberOfBlocks);
+  }
+
   /** stores the sample pointer */
   virtual void
   SetSample(const TSample * sample);
@@ -137,6 +164,37 @@ public:
   /** returns the pointer to the weights array */
   itkGetConstReferenceMacro(Weights, WeightArrayType);
 
+  /** Set the measurement vectors of the sample, one after the other, and
+   * their frequencies. The buffers are not owned by the component, and must
+   * be valid until they are reset to nullptr. */
+  void
+  SetMeasurementVectorBuffers(const double * measurementVectors, const double * frequencies);
+
+  /** Get the measurement vector and frequency buffers, or nullptr when they
+   * are not set. */
+  const double *
+  GetMeasurementVectorBuffer() const
+  {
+    return m_MeasurementVectorBuffer;
+  }
+
+  const double *
+  GetFrequencyBuffer() const
+  {
+    return m_FrequencyBuffer;
+  }
+
+  /** Compute the natural logarithms of the membership scores of the
+   * measurement vectors [begin, end) of the measurement vector buffer. This
+   * method is called concurrently on disjoint ranges, and must not modify the
+   * component. */
+  virtual void
+  EvaluateLogDensities(SizeValueType begin, SizeValueType end, double * logDensities) const;
+
+  /** Set/Get the number of work units. */
+  itkSetClampMacro(NumberOfWorkUnits, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfWorkUnits, ThreadIdType);
+
   virtual void
   Update();
 
@@ -155,6 +213,11 @@ protected:
   virtual void
   GenerateData() = 0;
 
+  /** Get the multi-threader which processes the blocks of measurement
+   * vectors, with NumberOfWorkUnits work units. */
+  MultiThreaderBase *
+  GetMultiThreader() const;
+
 private:
   /** target sample data pointer */
   const TSample * m_Sample{};
@@ -171,6 +234,12 @@ private:
 
   /** indicative flag of membership function's parameter changes */
   bool m_ParametersModified{};
+
+  const double * m_MeasurementVectorBuffer{};
+  const double * m_FrequencyBuffer{};
+
+  ThreadIdType               m_NumberOfWorkUnits{};
+  MultiThreaderBase::Pointer m_MultiThreader{};
 }; // end of class
 } // end of namespace Statistics
 } // end of namespace itk
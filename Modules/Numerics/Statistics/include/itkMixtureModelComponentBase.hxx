@@ -18,6 +18,7 @@
 #ifndef itkMixtureModelComponentBase_hxx
 #define itkMixtureModelComponentBase_hxx
 
+#include <cmath>
 
 namespace itk
 {
@@ -25,6 +26,8 @@ namespace Statistics
 {
 template <typename TSample>
 MixtureModelComponentBase<TSample>::MixtureModelComponentBase()
+  : m_NumberOfWorkUnits(MultiThreaderBase::GetGlobalDefaultNumberOfThreads())
+  , m_MultiThreader(MultiThreaderBase::New())
 {
   m_Sample = nullptr;
   m_MembershipFunction = nullptr;
@@ -62,6 +65,7 @@ MixtureModelComponentBase<TSample>::PrintSelf(std::ostream & os, Indent indent)
   os << m_Weights << std::endl;
 
   os << indent << "Parameters are modified: " << m_ParametersModified << std::endl;
+  os << indent << "NumberOfWorkUnits: " << m_NumberOfWorkUnits << std::endl;
 }
 
 template <typename TSample>
@@ -151,6 +155,39 @@ MixtureModelComponentBase<TSample>::GetWeight(unsigned int index) const
   itkExceptionMacro("Weight array is not allocated.");
 }
 
+template <typename TSample>
+void
+MixtureModelComponentBase<TSample>::SetMeasurementVectorBuffers(const double * measurementVectors,
+                                                                const double * frequencies)
+{
+  m_MeasurementVectorBuffer = measurementVectors;
+  m_FrequencyBuffer = frequencies;
+}
+
+template <typename TSample>
+void
+MixtureModelComponentBase<TSample>::EvaluateLogDensities(SizeValueType begin,
+                                                         SizeValueType end,
+                                                         double *      logDensities) const
+{
+  const MeasurementVectorSizeType measurementVectorSize = m_Sample->GetMeasurementVectorSize();
+
+  m_MembershipFunction->BatchEvaluate(
+    m_MeasurementVectorBuffer + begin * measurementVectorSize, end - begin, logDensities);
+  for (SizeValueType i = 0; i < end - begin; ++i)
+  {
+    logDensities[i] = std::log(logDensities[i]);
+  }
+}
+
+template <typename TSample>
+MultiThreaderBase *
+MixtureModelComponentBase<TSample>::GetMultiThreader() const
+{
+  m_MultiThreader->SetNumberOfWorkUnits(m_NumberOfWorkUnits);
+  return m_MultiThreader;
+}
+
 template <typename TSample>
 void
 MixtureModelComponentBase<TSample>::Update()
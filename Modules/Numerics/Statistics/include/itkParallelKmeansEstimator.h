@@ -0,0 +1,275 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkParallelKmeansEstimator_h
+#define itkParallelKmeansEstimator_h
+
+#include <vector>
+
+#include "itkObject.h"
+#include "itkArray.h"
+#include "itkDistanceToCentroidMembershipFunction.h"
+#include "itkSimpleDataObjectDecorator.h"
+#include "itkMultiThreaderBase.h"
+
+namespace itk
+{
+namespace Statistics
+{
+/**
+ * \class ParallelKmeansEstimator
+ * \brief Multi-threaded k-means algorithm working directly on a sample.
+ *
+ * It returns k mean vectors that are centroids of k-clusters, like
+ * KdTreeBasedKmeansEstimator, but does not need a k-d tree of the sample.
+ *
+ * By default, the measurement vectors of the sample are copied once in a
+ * contiguous buffer, and each iteration of the Lloyd algorithm assigns them
+ * to their closest centroid in parallel. The distances to the closest and
+ * second closest centroids are kept as bounds, updated with the moves of the
+ * centroids, so that, following Hamerly's variant of Elkan's algorithm, the
+ * distances of a measurement vector to the centroids are only computed again
+ * when the bounds do not prove that its closest centroid is unchanged. The
+ * sums of the clusters are accumulated in blocks of measurement vectors which
+ * do not depend on the number of work units, so that the result does not
+ * either.
+ *
+ * When the mini-batch size is not zero, each iteration instead draws a
+ * mini-batch of random measurement vectors, assigns them in parallel to
+ * their closest centroid, and moves each centroid towards its measurement
+ * vectors with a learning rate which is the inverse of the number of
+ * measurement vectors assigned to it so far (Sculley, "Web-Scale K-Means
+ * Clustering", 2010). The measurement vectors are then read through
+ * Sample::GetMeasurementVector() and the sample is never copied, which
+ * requires the instance identifiers of the sample to be 0 to Size() - 1, as
+ * for ListSample and ImageToListSampleAdaptor.
+ *
+ * The iterations stop, as in KdTreeBasedKmeansEstimator, after the maximum
+ * number of iterations, or when the sum of the changes in centroid positions
+ * is less than or equal to the threshold. When cluster labels are used, the
+ * label of each measurement vector, in the order of the sample, is its
+ * closest final centroid.
+ *
+ * \sa KdTreeBasedKmeansEstimator
+ * \ingroup ITKStatistics
+ */
+template <typename TSample>
+class ITK_TEMPLATE_EXPORT ParallelKmeansEstimator : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ParallelKmeansEstimator);
+
+  /** Standard class type aliases. */
+  using Self = ParallelKmeansEstimator;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(ParallelKmeansEstimator);
+
+  /** Types of the sample */
+  using SampleType = TSample;
+  using MeasurementType = typename TSample::MeasurementType;
+  using MeasurementVectorType = typename TSample::MeasurementVectorType;
+  using InstanceIdentifier = typename TSample::InstanceIdentifier;
+
+  /** Typedef for the length of a measurement vector */
+  using MeasurementVectorSizeType = unsigned int;
+
+  /** Parameters type: the k means, one after the other. */
+  using ParametersType = Array<double>;
+
+  /** Typedef required to generate dataobject decorated output that can
+   * be plugged into SampleClassifierFilter */
+  using DistanceToCentroidMembershipFunctionType = DistanceToCentroidMembershipFunction<MeasurementVectorType>;
+  using DistanceToCentroidMembershipFunctionPointer = typename DistanceToCentroidMembershipFunctionType::Pointer;
+
+  using MembershipFunctionType = MembershipFunctionBase<MeasurementVectorType>;
+  using MembershipFunctionPointer = typename MembershipFunctionType::ConstPointer;
+  using MembershipFunctionVectorType = std::vector<MembershipFunctionPointer>;
+  using MembershipFunctionVectorObjectType = SimpleDataObjectDecorator<MembershipFunctionVectorType>;
+  using MembershipFunctionVectorObjectPointer = typename MembershipFunctionVectorObjectType::Pointer;
+
+  /** Labels of the measurement vectors, in the order of the sample. */
+  using ClusterLabelsType = std::vector<unsigned int>;
+
+  /** Output Membership function vector containing the membership functions with
+   * the final optimized parameters */
+  const MembershipFunctionVectorObjectType *
+  GetOutput() const;
+
+  /** Set/Get the sample to cluster. */
+  itkSetConstObjectMacro(Sample, SampleType);
+  itkGetConstObjectMacro(Sample, SampleType);
+
+  /** Set the position to initialize the optimization, and get the means
+   * after the optimization. */
+  itkSetMacro(Parameters, ParametersType);
+  itkGetConstMacro(Parameters, ParametersType);
+
+  /** Set/Get maximum iteration limit. */
+  itkSetMacro(MaximumIteration, int);
+  itkGetConstMacro(MaximumIteration, int);
+
+  /** Set/Get the termination threshold for the sum of the changes in
+   * centroid positions after one iteration */
+  itkSetMacro(CentroidPositionChangesThreshold, double);
+  itkGetConstMacro(CentroidPositionChangesThreshold, double);
+
+  /** Set/Get whether the bounds of the distances to the centroids are used
+   * to skip the measurement vectors whose closest centroid is unchanged. The
+   * result is the same, up to ties, as without the bounds. Default is true. */
+  itkSetMacro(UseDistanceBounds, bool);
+  itkGetConstMacro(UseDistanceBounds, bool);
+  itkBooleanMacro(UseDistanceBounds);
+
+  /** Set/Get the number of measurement vectors of the mini-batches. Zero, the
+   * default, uses all the measurement vectors at each iteration. */
+  itkSetMacro(MiniBatchSize, SizeValueType);
+  itkGetConstMacro(MiniBatchSize, SizeValueType);
+
+  /** Set/Get the seed of the random generator drawing the mini-batches. */
+  itkSetMacro(Seed, unsigned int);
+  itkGetConstMacro(Seed, unsigned int);
+
+  /** Set/Get the number of work units. */
+  itkSetClampMacro(NumberOfWorkUnits, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfWorkUnits, ThreadIdType);
+
+  /** Set/Get whether the cluster labels are computed. */
+  itkSetMacro(UseClusterLabels, bool);
+  itkGetConstMacro(UseClusterLabels, bool);
+  itkBooleanMacro(UseClusterLabels);
+
+  /** Get the length of the measurement vectors of the sample */
+  itkGetConstMacro(MeasurementVectorSize, MeasurementVectorSizeType);
+
+  itkGetConstMacro(CurrentIteration, int);
+  itkGetConstMacro(CentroidPositionChanges, double);
+
+  /** Start optimization
+   * Optimization will stop when it meets either of two termination conditions,
+   * the maximum iteration limit or epsilon (minimal changes in centroid
+   * positions) */
+  void
+  StartOptimization();
+
+  /** Get the labels of the measurement vectors computed when cluster labels
+   * are used. */
+  const ClusterLabelsType &
+  GetClusterLabels() const
+  {
+    return m_ClusterLabels;
+  }
+
+protected:
+  ParallelKmeansEstimator();
+  ~ParallelKmeansEstimator() override = default;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** Centroids, one after the other. */
+  using CentroidContainerType = std::vector<double>;
+
+  /** The measurement vectors are processed in blocks of at least
+   * MinimumBlockSize measurement vectors, and in at most
+   * MaximumNumberOfBlocks blocks, whatever the number of work units. */
+  static constexpr SizeValueType MinimumBlockSize = 1024;
+  static constexpr SizeValueType MaximumNumberOfBlocks = 256;
+
+  /** Squared distance between a measurement vector and a centroid. */
+  double
+  ComputeSquaredDistance(const MeasurementType * measurementVector, const double * centroid) const
+  {
+    double squaredDistance = 0.0;
+    for (unsigned int d = 0; d < m_MeasurementVectorSize; ++d)
+    {
+      const double difference = static_cast<double>(measurementVector[d]) - centroid[d];
+      squaredDistance += difference * difference;
+    }
+    return squaredDistance;
+  }
+
+  /** Find the closest centroid of a measurement vector, and the squared
+   * distances to the closest and second closest centroids. */
+  unsigned int
+  FindClosestCentroid(const MeasurementType *       measurementVector,
+                      const CentroidContainerType & centroids,
+                      double &                      closestSquaredDistance,
+                      double &                      secondSquaredDistance) const;
+
+  /** Label in parallel contiguous measurement vectors with their closest
+   * centroid. */
+  void
+  LabelMeasurementVectors(const MeasurementType *       measurementVectors,
+                          SizeValueType                 numberOfMeasurementVectors,
+                          const CentroidContainerType & centroids,
+                          unsigned int *                labels) const;
+
+  /** Sum of the distances between the previous and current centroids. */
+  double
+  ComputeCentroidPositionChanges(const CentroidContainerType & previous, const CentroidContainerType & current) const;
+
+  /** Iterations using all the measurement vectors. */
+  void
+  RunFullBatch(CentroidContainerType & centroids);
+
+  /** Iterations using mini-batches. */
+  void
+  RunMiniBatch(CentroidContainerType & centroids);
+
+  /** Compute the labels of all the measurement vectors, reading the sample in
+   * chunks. */
+  void
+  ComputeClusterLabels(const CentroidContainerType & centroids);
+
+  typename SampleType::ConstPointer m_Sample{};
+  ParametersType                    m_Parameters{};
+
+  int    m_CurrentIteration{ 0 };
+  int    m_MaximumIteration{ 100 };
+  double m_CentroidPositionChanges{ 0.0 };
+  double m_CentroidPositionChangesThreshold{ 0.0 };
+
+  bool          m_UseDistanceBounds{ true };
+  SizeValueType m_MiniBatchSize{ 0 };
+  unsigned int  m_Seed{ 121212 };
+
+  bool              m_UseClusterLabels{ false };
+  ClusterLabelsType m_ClusterLabels{};
+
+  MeasurementVectorSizeType m_MeasurementVectorSize{ 0 };
+  unsigned int              m_NumberOfClasses{ 0 };
+
+  ThreadIdType               m_NumberOfWorkUnits{};
+  MultiThreaderBase::Pointer m_MultiThreader{};
+
+  MembershipFunctionVectorObjectPointer m_MembershipFunctionsObject{};
+}; // end of class
+} // end of namespace Statistics
+} // end of namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkParallelKmeansEstimator.hxx"
+#endif
+
+#endif
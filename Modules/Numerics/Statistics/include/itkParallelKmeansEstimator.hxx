@@ -0,0 +1,481 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkParallelKmeansEstimator_hxx
+#define itkParallelKmeansEstimator_hxx
+
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace itk
+{
+namespace Statistics
+{
+template <typename TSample>
+ParallelKmeansEstimator<TSample>::ParallelKmeansEstimator()
+  : m_NumberOfWorkUnits(MultiThreaderBase::GetGlobalDefaultNumberOfThreads())
+  , m_MultiThreader(MultiThreaderBase::New())
+  , m_MembershipFunctionsObject(MembershipFunctionVectorObjectType::New())
+{}
+
+template <typename TSample>
+void
+ParallelKmeansEstimator<TSample>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Sample: ";
+  if (m_Sample != nullptr)
+  {
+    os << m_Sample << std::endl;
+  }
+  else
+  {
+    os << "not set." << std::endl;
+  }
+  os << indent << "Parameters: " << m_Parameters << std::endl;
+  os << indent << "Current Iteration: " << m_CurrentIteration << std::endl;
+  os << indent << "Maximum Iteration: " << m_MaximumIteration << std::endl;
+  os << indent << "Sum of Centroid Position Changes: " << m_CentroidPositionChanges << std::endl;
+  os << indent << "Threshold for the Sum of Centroid Position Changes: " << m_CentroidPositionChangesThreshold
+     << std::endl;
+  os << indent << "UseDistanceBounds: " << m_UseDistanceBounds << std::endl;
+  os << indent << "MiniBatchSize: " << m_MiniBatchSize << std::endl;
+  os << indent << "Seed: " << m_Seed << std::endl;
+  os << indent << "NumberOfWorkUnits: " << m_NumberOfWorkUnits << std::endl;
+  os << indent << "UseClusterLabels: " << m_UseClusterLabels << std::endl;
+  os << indent << "MeasurementVectorSize: " << m_MeasurementVectorSize << std::endl;
+}
+
+template <typename TSample>
+unsigned int
+ParallelKmeansEstimator<TSample>::FindClosestCentroid(const MeasurementType *       measurementVector,
+                                                      const CentroidContainerType & centroids,
+                                                      double &                      closestSquaredDistance,
+                                                      double &                      secondSquaredDistance) const
+{
+  unsigned int closest = 0;
+  closestSquaredDistance = NumericTraits<double>::max();
+  secondSquaredDistance = NumericTraits<double>::max();
+  for (unsigned int j = 0; j < m_NumberOfClasses; ++j)
+  {
+    const double squaredDistance =
+      this->ComputeSquaredDistance(measurementVector, centroids.data() + j * m_MeasurementVectorSize);
+    if (squaredDistance < closestSquaredDistance)
+    {
+      secondSquaredDistance = closestSquaredDistance;
+      closestSquaredDistance = squaredDistance;
+      closest = j;
+    }
+    else if (squaredDistance < secondSquaredDistance)
+    {
+      secondSquaredDistance = squaredDistance;
+    }
+  }
+  return closest;
+}
+
+template <typename TSample>
+void
+ParallelKmeansEstimator<TSample>::LabelMeasurementVectors(const MeasurementType *       measurementVectors,
+                                                          SizeValueType                 numberOfMeasurementVectors,
+                                                          const CentroidContainerType & centroids,
+                                                          unsigned int *                labels) const
+{
+  const SizeValueType numberOfBlocks = (numberOfMeasurementVectors + MinimumBlockSize - 1) / MinimumBlockSize;
+
+  m_MultiThreader->SetNumberOfWorkUnits(m_NumberOfWorkUnits);
+  m_MultiThreader->ParallelizeArray(
+    0,
+    numberOfBlocks,
+    [this, measurementVectors, numberOfMeasurementVectors, &centroids, labels](SizeValueType block) {
+      const SizeValueType end = std::min(numberOfMeasurementVectors, (block + 1) * MinimumBlockSize);
+      for (SizeValueType i = block * MinimumBlockSize; i < end; ++i)
+      {
+        double closestSquaredDistance;
+        double secondSquaredDistance;
+        labels[i] = this->FindClosestCentroid(
+          measurementVectors + i * m_MeasurementVectorSize, centroids, closestSquaredDistance, secondSquaredDistance);
+      }
+    },
+    nullptr);
+}
+
+template <typename TSample>
+double
+ParallelKmeansEstimator<TSample>::ComputeCentroidPositionChanges(const CentroidContainerType & previous,
+                                                                 const CentroidContainerType & current) const
+{
+  double sum = 0.0;
+  for (unsigned int j = 0; j < m_NumberOfClasses; ++j)
+  {
+    double squaredChange = 0.0;
+    for (unsigned int d = 0; d < m_MeasurementVectorSize; ++d)
+    {
+      const double change = current[j * m_MeasurementVectorSize + d] - previous[j * m_MeasurementVectorSize + d];
+      squaredChange += change * change;
+    }
+    sum += std::sqrt(squaredChange);
+  }
+  return sum;
+}
+
+template <typename TSample>
+void
+ParallelKmeansEstimator<TSample>::RunFullBatch(CentroidContainerType & centroids)
+{
+  const MeasurementVectorSizeType dimension = m_MeasurementVectorSize;
+  const unsigned int              numberOfClasses = m_NumberOfClasses;
+  const auto                      numberOfMeasurementVectors = static_cast<SizeValueType>(m_Sample->Size());
+
+  // Contiguous copy of the measurement vectors.
+  std::vector<MeasurementType> measurementVectors(numberOfMeasurementVectors * dimension);
+  SizeValueType                position = 0;
+  for (auto it = m_Sample->Begin(); it != m_Sample->End(); ++it, ++position)
+  {
+    const MeasurementVectorType & measurementVector = it.GetMeasurementVector();
+    for (unsigned int d = 0; d < dimension; ++d)
+    {
+      measurementVectors[position * dimension + d] = measurementVector[d];
+    }
+  }
+
+  // Closest centroid of each measurement vector, upper bound of the distance
+  // to it, and lower bound of the distance to the other centroids.
+  std::vector<unsigned int> labels(numberOfMeasurementVectors, 0);
+  std::vector<double>       upperBounds(numberOfMeasurementVectors, 0.0);
+  std::vector<double>       lowerBounds(numberOfMeasurementVectors, 0.0);
+
+  const SizeValueType blockSize =
+    std::max(MinimumBlockSize,
+             (numberOfMeasurementVectors + MaximumNumberOfBlocks - 1) / MaximumNumberOfBlocks);
+  const SizeValueType numberOfBlocks = (numberOfMeasurementVectors + blockSize - 1) / blockSize;
+  std::vector<double> blockSums(numberOfBlocks * numberOfClasses * dimension);
+  std::vector<double> blockCounts(numberOfBlocks * numberOfClasses);
+
+  // Half of the distance of each centroid to the closest other centroid, and
+  // moves of the centroids at the previous iteration.
+  std::vector<double> halfSeparations(numberOfClasses);
+  std::vector<double> moves(numberOfClasses, 0.0);
+  unsigned int        largestMoveClass = 0;
+  double              largestMove = 0.0;
+  double              secondLargestMove = 0.0;
+  bool                boundsAreValid = false;
+
+  CentroidContainerType previousCentroids;
+  m_CurrentIteration = 0;
+  m_MultiThreader->SetNumberOfWorkUnits(m_NumberOfWorkUnits);
+
+  while (true)
+  {
+    previousCentroids = centroids;
+
+    const bool useBounds = m_UseDistanceBounds && boundsAreValid;
+    if (useBounds)
+    {
+      std::fill(halfSeparations.begin(), halfSeparations.end(), NumericTraits<double>::max());
+      for (unsigned int j = 0; j < numberOfClasses; ++j)
+      {
+        for (unsigned int l = j + 1; l < numberOfClasses; ++l)
+        {
+          double squaredDistance = 0.0;
+          for (unsigned int d = 0; d < dimension; ++d)
+          {
+            const double difference = centroids[j * dimension + d] - centroids[l * dimension + d];
+            squaredDistance += difference * difference;
+          }
+          const double halfSeparation = 0.5 * std::sqrt(squaredDistance);
+          halfSeparations[j] = std::min(halfSeparations[j], halfSeparation);
+          halfSeparations[l] = std::min(halfSeparations[l], halfSeparation);
+        }
+      }
+    }
+
+    m_MultiThreader->ParallelizeArray(
+      0,
+      numberOfBlocks,
+      [&, useBounds](SizeValueType block) {
+        double * sums = blockSums.data() + block * numberOfClasses * dimension;
+        double * counts = blockCounts.data() + block * numberOfClasses;
+        std::fill(sums, sums + numberOfClasses * dimension, 0.0);
+        std::fill(counts, counts + numberOfClasses, 0.0);
+
+        const SizeValueType end = std::min(numberOfMeasurementVectors, (block + 1) * blockSize);
+        for (SizeValueType i = block * blockSize; i < end; ++i)
+        {
+          const MeasurementType * measurementVector = measurementVectors.data() + i * dimension;
+          unsigned int            label = labels[i];
+          bool                    searchAllCentroids = true;
+          if (useBounds)
+          {
+            upperBounds[i] += moves[label];
+            lowerBounds[i] -= (label == largestMoveClass ? secondLargestMove : largestMove);
+            const double bound = std::max(halfSeparations[label], lowerBounds[i]);
+            if (upperBounds[i] > bound)
+            {
+              upperBounds[i] = std::sqrt(
+                this->ComputeSquaredDistance(measurementVector, centroids.data() + label * dimension));
+            }
+            searchAllCentroids = upperBounds[i] > bound;
+          }
+          if (searchAllCentroids)
+          {
+            double closestSquaredDistance;
+            double secondSquaredDistance;
+            label = this->FindClosestCentroid(
+              measurementVector, centroids, closestSquaredDistance, secondSquaredDistance);
+            labels[i] = label;
+            upperBounds[i] = std::sqrt(closestSquaredDistance);
+            lowerBounds[i] = std::sqrt(secondSquaredDistance);
+          }
+
+          counts[label] += 1.0;
+          double * sum = sums + label * dimension;
+          for (unsigned int d = 0; d < dimension; ++d)
+          {
+            sum[d] += static_cast<double>(measurementVector[d]);
+          }
+        }
+      },
+      nullptr);
+
+    // The sums of the blocks are added in the order of the blocks.
+    std::vector<double> sums(numberOfClasses * dimension, 0.0);
+    std::vector<double> counts(numberOfClasses, 0.0);
+    for (SizeValueType block = 0; block < numberOfBlocks; ++block)
+    {
+      for (unsigned int j = 0; j < numberOfClasses; ++j)
+      {
+        counts[j] += blockCounts[block * numberOfClasses + j];
+      }
+      for (unsigned int i = 0; i < numberOfClasses * dimension; ++i)
+      {
+        sums[i] += blockSums[block * numberOfClasses * dimension + i];
+      }
+    }
+
+    largestMoveClass = 0;
+    largestMove = 0.0;
+    secondLargestMove = 0.0;
+    for (unsigned int j = 0; j < numberOfClasses; ++j)
+    {
+      if (counts[j] > 0.0)
+      {
+        for (unsigned int d = 0; d < dimension; ++d)
+        {
+          centroids[j * dimension + d] = sums[j * dimension + d] / counts[j];
+        }
+      }
+      double squaredMove = 0.0;
+      for (unsigned int d = 0; d < dimension; ++d)
+      {
+        const double difference = centroids[j * dimension + d] - previousCentroids[j * dimension + d];
+        squaredMove += difference * difference;
+      }
+      moves[j] = std::sqrt(squaredMove);
+      if (moves[j] > largestMove)
+      {
+        secondLargestMove = largestMove;
+        largestMove = moves[j];
+        largestMoveClass = j;
+      }
+      else if (moves[j] > secondLargestMove)
+      {
+        secondLargestMove = moves[j];
+      }
+    }
+    boundsAreValid = true;
+
+    if (m_CurrentIteration >= m_MaximumIteration)
+    {
+      break;
+    }
+
+    m_CentroidPositionChanges = this->ComputeCentroidPositionChanges(previousCentroids, centroids);
+    if (m_CentroidPositionChanges <= m_CentroidPositionChangesThreshold)
+    {
+      break;
+    }
+
+    ++m_CurrentIteration;
+  }
+}
+
+template <typename TSample>
+void
+ParallelKmeansEstimator<TSample>::RunMiniBatch(CentroidContainerType & centroids)
+{
+  const MeasurementVectorSizeType dimension = m_MeasurementVectorSize;
+  const auto                      numberOfMeasurementVectors = static_cast<SizeValueType>(m_Sample->Size());
+
+  auto randomGenerator = MersenneTwisterRandomVariateGenerator::New();
+  randomGenerator->SetSeed(m_Seed);
+
+  std::vector<MeasurementType> batch(m_MiniBatchSize * dimension);
+  std::vector<unsigned int>    batchLabels(m_MiniBatchSize);
+  std::vector<double>          counts(m_NumberOfClasses, 0.0);
+
+  CentroidContainerType previousCentroids;
+  m_CurrentIteration = 0;
+
+  while (true)
+  {
+    previousCentroids = centroids;
+
+    for (SizeValueType i = 0; i < m_MiniBatchSize; ++i)
+    {
+      const double randomPosition = randomGenerator->Get53BitVariate() * static_cast<double>(numberOfMeasurementVectors);
+      const auto   id = std::min(numberOfMeasurementVectors - 1, static_cast<SizeValueType>(randomPosition));
+      const MeasurementVectorType & measurementVector =
+        m_Sample->GetMeasurementVector(static_cast<InstanceIdentifier>(id));
+      for (unsigned int d = 0; d < dimension; ++d)
+      {
+        batch[i * dimension + d] = measurementVector[d];
+      }
+    }
+
+    this->LabelMeasurementVectors(batch.data(), m_MiniBatchSize, centroids, batchLabels.data());
+
+    // The centroids move towards the measurement vectors in the order of the
+    // mini-batch.
+    for (SizeValueType i = 0; i < m_MiniBatchSize; ++i)
+    {
+      const unsigned int label = batchLabels[i];
+      counts[label] += 1.0;
+      const double learningRate = 1.0 / counts[label];
+      for (unsigned int d = 0; d < dimension; ++d)
+      {
+        double & centroid = centroids[label * dimension + d];
+        centroid += learningRate * (static_cast<double>(batch[i * dimension + d]) - centroid);
+      }
+    }
+
+    if (m_CurrentIteration >= m_MaximumIteration)
+    {
+      break;
+    }
+
+    m_CentroidPositionChanges = this->ComputeCentroidPositionChanges(previousCentroids, centroids);
+    if (m_CentroidPositionChanges <= m_CentroidPositionChangesThreshold)
+    {
+      break;
+    }
+
+    ++m_CurrentIteration;
+  }
+}
+
+template <typename TSample>
+void
+ParallelKmeansEstimator<TSample>::ComputeClusterLabels(const CentroidContainerType & centroids)
+{
+  const MeasurementVectorSizeType dimension = m_MeasurementVectorSize;
+  const auto                      numberOfMeasurementVectors = static_cast<SizeValueType>(m_Sample->Size());
+
+  m_ClusterLabels.resize(numberOfMeasurementVectors);
+
+  // The sample is read in chunks, which are labeled in parallel.
+  const SizeValueType          chunkSize = MinimumBlockSize * MaximumNumberOfBlocks;
+  std::vector<MeasurementType> chunk(std::min(chunkSize, numberOfMeasurementVectors) * dimension);
+  SizeValueType                chunkBegin = 0;
+  SizeValueType                position = 0;
+  for (auto it = m_Sample->Begin(); it != m_Sample->End(); ++it, ++position)
+  {
+    const MeasurementVectorType & measurementVector = it.GetMeasurementVector();
+    for (unsigned int d = 0; d < dimension; ++d)
+    {
+      chunk[(position - chunkBegin) * dimension + d] = measurementVector[d];
+    }
+    if (position + 1 - chunkBegin == chunkSize || position + 1 == numberOfMeasurementVectors)
+    {
+      this->LabelMeasurementVectors(chunk.data(), position + 1 - chunkBegin, centroids, &m_ClusterLabels[chunkBegin]);
+      chunkBegin = position + 1;
+    }
+  }
+}
+
+template <typename TSample>
+void
+ParallelKmeansEstimator<TSample>::StartOptimization()
+{
+  if (m_Sample == nullptr)
+  {
+    itkExceptionMacro("Sample is not set.");
+  }
+  m_MeasurementVectorSize = m_Sample->GetMeasurementVectorSize();
+  if (m_MeasurementVectorSize == 0 || m_Parameters.size() == 0 || m_Parameters.size() % m_MeasurementVectorSize != 0)
+  {
+    itkExceptionMacro("The number of parameters " << m_Parameters.size()
+                                                  << " is not a nonzero multiple of the measurement vector size "
+                                                  << m_MeasurementVectorSize << '.');
+  }
+  if (m_Sample->Size() == 0)
+  {
+    itkExceptionMacro("The sample is empty.");
+  }
+  m_NumberOfClasses = static_cast<unsigned int>(m_Parameters.size() / m_MeasurementVectorSize);
+
+  CentroidContainerType centroids(m_Parameters.begin(), m_Parameters.end());
+  m_CentroidPositionChanges = 0.0;
+  if (m_MiniBatchSize > 0)
+  {
+    this->RunMiniBatch(centroids);
+  }
+  else
+  {
+    this->RunFullBatch(centroids);
+  }
+  std::copy(centroids.begin(), centroids.end(), m_Parameters.begin());
+
+  m_ClusterLabels.clear();
+  if (m_UseClusterLabels)
+  {
+    this->ComputeClusterLabels(centroids);
+  }
+}
+
+template <typename TSample>
+auto
+ParallelKmeansEstimator<TSample>::GetOutput() const -> const MembershipFunctionVectorObjectType *
+{
+  const unsigned int numberOfClasses = m_MeasurementVectorSize > 0 ? m_Parameters.size() / m_MeasurementVectorSize : 0;
+  MembershipFunctionVectorType & membershipFunctionsVector = m_MembershipFunctionsObject->Get();
+
+  membershipFunctionsVector.clear();
+  for (unsigned int i = 0; i < numberOfClasses; ++i)
+  {
+    const DistanceToCentroidMembershipFunctionPointer membershipFunction =
+      DistanceToCentroidMembershipFunctionType::New();
+    membershipFunction->SetMeasurementVectorSize(m_MeasurementVectorSize);
+    typename DistanceToCentroidMembershipFunctionType::CentroidType centroid;
+    centroid.SetSize(m_MeasurementVectorSize);
+    for (unsigned int j = 0; j < m_MeasurementVectorSize; ++j)
+    {
+      centroid[j] = m_Parameters[i * m_MeasurementVectorSize + j];
+    }
+    membershipFunction->SetCentroid(centroid);
+    membershipFunctionsVector.push_back(membershipFunction);
+  }
+
+  return static_cast<const MembershipFunctionVectorObjectType *>(m_MembershipFunctionsObject);
+}
+} // end of namespace Statistics
+} // end of namespace itk
+
+#endif
@@ -38,6 +38,12 @@ namespace Statistics
  *  This filter takes as input a Sample and produces as output a
  *  classification in the form of a MembershipSample object.
  *
+ *  The sample is read in chunks of measurement vectors, which are classified
+ *  in parallel, in blocks: each membership function evaluates a whole block
+ *  with MembershipFunctionBase::BatchEvaluate(), and the decision rule labels
+ *  the block with DecisionRule::BatchEvaluate(). The instances are then added
+ *  to the output in the order of the sample.
+ *
  * \ingroup ITKStatistics
  */
 
@@ -150,6 +156,22 @@ protected:
   MakeOutput(DataObjectPointerArraySizeType idx) override;
 
 private:
+  using ClassIdentifierType = DecisionRuleType::ClassIdentifierType;
+
+  /** Number of measurement vectors of the blocks, and of the chunks of the
+   * sample */
+  static constexpr SizeValueType BlockSize = 1024;
+  static constexpr SizeValueType ChunkSize = 256 * BlockSize;
+
+  /** Classify consecutive measurement vectors, stored one after the other,
+   * in parallel blocks. */
+  void
+  ClassifyMeasurementVectors(const double *                              measurementVectors,
+                             SizeValueType                               numberOfMeasurementVectors,
+                             const MembershipFunctionVectorType &        membershipFunctions,
+                             const MembershipFunctionsWeightsArrayType & membershipFunctionsWeightsArray,
+                             ClassIdentifierType *                       classIndices);
+
   unsigned int m_NumberOfClasses{};
 
   /** Decision Rule */
@@ -18,6 +18,8 @@
 #ifndef itkSampleClassifierFilter_hxx
 #define itkSampleClassifierFilter_hxx
 
+#include <algorithm>
+#include "itkMultiThreaderBase.h"
 
 namespace itk
 {
@@ -146,31 +148,112 @@ SampleClassifierFilter<TSample>::GenerateData()
   }
 
   const auto * sample = static_cast<const SampleType *>(this->ProcessObject::GetInput(0));
-
-  std::vector<double> discriminantScores;
-  discriminantScores.resize(this->m_NumberOfClasses);
+  const unsigned int measurementVectorSize = sample->GetMeasurementVectorSize();
 
   auto * output = dynamic_cast<MembershipSampleType *>(this->ProcessObject::GetOutput(0));
 
   output->SetSample(this->GetInput());
   output->SetNumberOfClasses(this->m_NumberOfClasses);
 
-  typename TSample::ConstIterator       iter = sample->Begin();
-  const typename TSample::ConstIterator end = sample->End();
+  const auto numberOfMeasurementVectors = static_cast<SizeValueType>(sample->Size());
+  if (numberOfMeasurementVectors == 0)
+  {
+    return;
+  }
 
-  while (iter != end)
+  // The sample is read in chunks, which are classified in parallel, and whose
+  // instances are added to the output in order.
+  const SizeValueType                               bufferSize = std::min(ChunkSize, numberOfMeasurementVectors);
+  std::vector<double>                               measurementVectors(bufferSize * measurementVectorSize);
+  std::vector<typename TSample::InstanceIdentifier> instanceIdentifiers(bufferSize);
+  std::vector<ClassIdentifierType>                  classIndices(bufferSize);
+
+  SizeValueType count = 0;
+  for (auto iter = sample->Begin(); iter != sample->End(); ++iter)
   {
     const typename TSample::MeasurementVectorType measurements = iter.GetMeasurementVector();
-    for (unsigned int i = 0; i < this->m_NumberOfClasses; ++i)
+    for (unsigned int d = 0; d < measurementVectorSize; ++d)
     {
-      discriminantScores[i] = membershipFunctionsWeightsArray[i] * membershipFunctions[i]->Evaluate(measurements);
+      measurementVectors[count * measurementVectorSize + d] = static_cast<double>(measurements[d]);
+    }
+    instanceIdentifiers[count] = iter.GetInstanceIdentifier();
+    if (++count == bufferSize)
+    {
+      this->ClassifyMeasurementVectors(
+        measurementVectors.data(), count, membershipFunctions, membershipFunctionsWeightsArray, classIndices.data());
+      for (SizeValueType j = 0; j < count; ++j)
+      {
+        output->AddInstance(classLabels[classIndices[j]], instanceIdentifiers[j]);
+      }
+      count = 0;
     }
-
-    const size_t classIndex = m_DecisionRule->Evaluate(discriminantScores);
-
-    output->AddInstance(classLabels[classIndex], iter.GetInstanceIdentifier());
-    ++iter;
   }
+  if (count > 0)
+  {
+    this->ClassifyMeasurementVectors(
+      measurementVectors.data(), count, membershipFunctions, membershipFunctionsWeightsArray, classIndices.data());
+    for (SizeValueType j = 0; j < count; ++j)
+    {
+      output->AddInstance(classLabels[classIndices[j]], instanceIdentifiers[j]);
+    }
+  }
+}
+
+template <typename TSample>
+void
+SampleClassifierFilter<TSample>::ClassifyMeasurementVectors(
+  const double *                              measurementVectors,
+  SizeValueType                               numberOfMeasurementVectors,
+  const MembershipFunctionVectorType &        membershipFunctions,
+  const MembershipFunctionsWeightsArrayType & membershipFunctionsWeightsArray,
+  ClassIdentifierType *                       classIndices)
+{
+  const unsigned int  numberOfClasses = this->m_NumberOfClasses;
+  const unsigned int  measurementVectorSize = this->GetInput()->GetMeasurementVectorSize();
+  const SizeValueType numberOfBlocks = (numberOfMeasurementVectors + BlockSize - 1) / BlockSize;
+
+  MultiThreaderBase * multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfBlocks,
+    [&](SizeValueType block) {
+      const SizeValueType begin = block * BlockSize;
+      const SizeValueType count = std::min(BlockSize, numberOfMeasurementVectors - begin);
+
+      // Scores of the block, class after class.
+      std::vector<double>   discriminantScores(count * numberOfClasses);
+      MeasurementVectorType measurements;
+      NumericTraits<MeasurementVectorType>::SetLength(measurements, measurementVectorSize);
+      for (unsigned int i = 0; i < numberOfClasses; ++i)
+      {
+        double * const scores = discriminantScores.data() + i * count;
+        if (membershipFunctions[i]->GetMeasurementVectorSize() == measurementVectorSize)
+        {
+          membershipFunctions[i]->BatchEvaluate(measurementVectors + begin * measurementVectorSize, count, scores);
+        }
+        else
+        {
+          // The measurement vector size of the membership function was not
+          // set: evaluate it one measurement vector at a time.
+          for (SizeValueType j = 0; j < count; ++j)
+          {
+            for (unsigned int d = 0; d < measurementVectorSize; ++d)
+            {
+              measurements[d] =
+                static_cast<MeasurementType>(measurementVectors[(begin + j) * measurementVectorSize + d]);
+            }
+            scores[j] = membershipFunctions[i]->Evaluate(measurements);
+          }
+        }
+        for (SizeValueType j = 0; j < count; ++j)
+        {
+          scores[j] *= membershipFunctionsWeightsArray[i];
+        }
+      }
+      m_DecisionRule->BatchEvaluate(discriminantScores.data(), numberOfClasses, count, classIndices + begin);
+    },
+    nullptr);
 }
 
 template <typename TSample>
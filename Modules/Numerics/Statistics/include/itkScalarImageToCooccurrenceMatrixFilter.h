@@ -23,6 +23,7 @@
 #include "itkVectorContainer.h"
 #include "itkNumericTraits.h"
 #include "itkProcessObject.h"
+#include <vector>
 
 namespace itk
 {
@@ -74,6 +75,12 @@ namespace Statistics
  * texture or in cases where the user wants more histogram bins, a sparse container
  * can be used for the histogram instead.
  *
+ * The requested region is split in pieces processed in parallel by the work
+ * units of the filter. Each piece counts its co-occurrence pairs in its own
+ * dense array of frequencies, and these counts are then added to the
+ * histogram, so that the histogram does not depend on the number of work
+ * units.
+ *
  * WARNING: This probably won't work for pixels of double or long-double type
  * unless you set the histogram min and max manually. This is because the largest
  * histogram bin by default has max value of the largest possible pixel value
@@ -212,6 +219,25 @@ private:
   void
   NormalizeHistogram();
 
+  /** Frequencies of the co-occurrence pairs of a piece of the region, indexed
+   * by the instance identifiers of the histogram. */
+  using PieceFrequencyContainerType = std::vector<typename HistogramType::AbsoluteFrequencyType>;
+
+  /** Split the region in pieces, call countPairs(piece, frequencies) for each
+   * piece in parallel, and add the frequencies of all the pieces to the
+   * output histogram. */
+  template <typename TCountPairs>
+  void
+  ParallelFillHistogram(const RegionType & region, const TCountPairs & countPairs);
+
+  /** Count both combinations of a co-occurrence pair of pixel values. */
+  void
+  CountPair(const PixelType                     centerPixelIntensity,
+            const PixelType                     pixelIntensity,
+            MeasurementVectorType &             cooccur,
+            typename HistogramType::IndexType & index,
+            PieceFrequencyContainerType &       frequencies) const;
+
   OffsetVectorConstPointer m_Offsets{};
   PixelType                m_Min{};
   PixelType                m_Max{};
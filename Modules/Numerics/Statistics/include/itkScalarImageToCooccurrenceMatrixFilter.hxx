@@ -20,6 +20,8 @@
 
 
 #include "itkConstNeighborhoodIterator.h"
+#include "itkImageRegionSplitterSlowDimension.h"
+#include "itkMultiThreaderBase.h"
 #include "itkMath.h"
 
 namespace itk
@@ -193,53 +195,43 @@ ScalarImageToCooccurrenceMatrixFilter<TImageType, THistogramFrequencyContainer,
 
   const ImageType * input = this->GetInput();
 
-  auto * output = static_cast<HistogramType *>(this->ProcessObject::GetOutput(0));
-
   using NeighborhoodIteratorType = ConstNeighborhoodIterator<ImageType>;
 
-  MeasurementVectorType cooccur(output->GetMeasurementVectorSize());
-
-  for (NeighborhoodIteratorType neighborIt(radius, input, region); !neighborIt.IsAtEnd(); ++neighborIt)
-  {
-    const PixelType centerPixelIntensity = neighborIt.GetCenterPixel();
-    if (centerPixelIntensity < m_Min || centerPixelIntensity > m_Max)
-    {
-      continue; // don't put a pixel in the histogram if the value
-                // is out-of-bounds.
-    }
+  this->ParallelFillHistogram(region, [this, input, radius](const RegionType &            piece,
+                                                            PieceFrequencyContainerType & frequencies) {
+    MeasurementVectorType             cooccur(2);
+    typename HistogramType::IndexType index;
 
-    typename OffsetVector::ConstIterator offsets;
-    typename HistogramType::IndexType    index;
-    for (offsets = m_Offsets->Begin(); offsets != m_Offsets->End(); ++offsets)
+    for (NeighborhoodIteratorType neighborIt(radius, input, piece); !neighborIt.IsAtEnd(); ++neighborIt)
     {
-      bool            pixelInBounds;
-      const PixelType pixelIntensity = neighborIt.GetPixel(offsets.Value(), pixelInBounds);
-
-      if (!pixelInBounds)
-      {
-        continue; // don't put a pixel in the histogram if it's out-of-bounds.
-      }
-
-      if (pixelIntensity < m_Min || pixelIntensity > m_Max)
+      const PixelType centerPixelIntensity = neighborIt.GetCenterPixel();
+      if (centerPixelIntensity < m_Min || centerPixelIntensity > m_Max)
       {
         continue; // don't put a pixel in the histogram if the value
                   // is out-of-bounds.
       }
 
-      // Now make both possible co-occurrence combinations and increment the
-      // histogram with them.
+      typename OffsetVector::ConstIterator offsets;
+      for (offsets = m_Offsets->Begin(); offsets != m_Offsets->End(); ++offsets)
+      {
+        bool            pixelInBounds;
+        const PixelType pixelIntensity = neighborIt.GetPixel(offsets.Value(), pixelInBounds);
+
+        if (!pixelInBounds)
+        {
+          continue; // don't put a pixel in the histogram if it's out-of-bounds.
+        }
 
-      cooccur[0] = centerPixelIntensity;
-      cooccur[1] = pixelIntensity;
-      output->GetIndex(cooccur, index);
-      output->IncreaseFrequencyOfIndex(index, 1);
+        if (pixelIntensity < m_Min || pixelIntensity > m_Max)
+        {
+          continue; // don't put a pixel in the histogram if the value
+                    // is out-of-bounds.
+        }
 
-      cooccur[1] = centerPixelIntensity;
-      cooccur[0] = pixelIntensity;
-      output->GetIndex(cooccur, index);
-      output->IncreaseFrequencyOfIndex(index, 1);
+        this->CountPair(centerPixelIntensity, pixelIntensity, cooccur, index, frequencies);
+      }
     }
-  }
+  });
 }
 
 template <typename TImageType, typename THistogramFrequencyContainer, typename TMaskImageType>
@@ -254,69 +246,121 @@ ScalarImageToCooccurrenceMatrixFilter<TImageType, THistogramFrequencyContainer,
 
   const ImageType * input = this->GetInput();
 
-  auto * output = static_cast<HistogramType *>(this->ProcessObject::GetOutput(0));
-
-  // Iterate over all of those pixels and offsets, adding each
-  // co-occurrence pair to the histogram
   using NeighborhoodIteratorType = ConstNeighborhoodIterator<ImageType>;
-  NeighborhoodIteratorType neighborIt(radius, input, region);
   using MaskNeighborhoodIteratorType = ConstNeighborhoodIterator<MaskImageType>;
-  MaskNeighborhoodIteratorType maskNeighborIt(radius, maskImage, region);
 
-  MeasurementVectorType             cooccur(output->GetMeasurementVectorSize());
-  typename HistogramType::IndexType index;
-  for (neighborIt.GoToBegin(), maskNeighborIt.GoToBegin(); !neighborIt.IsAtEnd(); ++neighborIt, ++maskNeighborIt)
-  {
-    if (maskNeighborIt.GetCenterPixel() != m_InsidePixelValue)
-    {
-      continue; // Go to the next loop if we're not in the mask
-    }
-
-    const PixelType centerPixelIntensity = neighborIt.GetCenterPixel();
-
-    if (centerPixelIntensity < this->GetMin() || centerPixelIntensity > this->GetMax())
-    {
-      continue; // don't put a pixel in the histogram if the value
-                // is out-of-bounds.
-    }
+  this->ParallelFillHistogram(region, [this, input, maskImage, radius](const RegionType &            piece,
+                                                                       PieceFrequencyContainerType & frequencies) {
+    NeighborhoodIteratorType     neighborIt(radius, input, piece);
+    MaskNeighborhoodIteratorType maskNeighborIt(radius, maskImage, piece);
 
-    typename OffsetVector::ConstIterator offsets;
-    for (offsets = this->GetOffsets()->Begin(); offsets != this->GetOffsets()->End(); ++offsets)
+    MeasurementVectorType             cooccur(2);
+    typename HistogramType::IndexType index;
+    for (neighborIt.GoToBegin(), maskNeighborIt.GoToBegin(); !neighborIt.IsAtEnd(); ++neighborIt, ++maskNeighborIt)
     {
-      if (maskNeighborIt.GetPixel(offsets.Value()) != m_InsidePixelValue)
+      if (maskNeighborIt.GetCenterPixel() != m_InsidePixelValue)
       {
         continue; // Go to the next loop if we're not in the mask
       }
 
-      bool            pixelInBounds;
-      const PixelType pixelIntensity = neighborIt.GetPixel(offsets.Value(), pixelInBounds);
-
-      if (!pixelInBounds)
-      {
-        continue; // don't put a pixel in the histogram if it's out-of-bounds.
-      }
+      const PixelType centerPixelIntensity = neighborIt.GetCenterPixel();
 
-      if (pixelIntensity < this->GetMin() || pixelIntensity > this->GetMax())
+      if (centerPixelIntensity < m_Min || centerPixelIntensity > m_Max)
       {
         continue; // don't put a pixel in the histogram if the value
                   // is out-of-bounds.
       }
 
-      // Now make both possible co-occurrence combinations and increment the
-      // histogram with them.
-
-      cooccur[0] = centerPixelIntensity;
-      cooccur[1] = pixelIntensity;
-      output->GetIndex(cooccur, index);
-      output->IncreaseFrequencyOfIndex(index, 1);
+      typename OffsetVector::ConstIterator offsets;
+      for (offsets = m_Offsets->Begin(); offsets != m_Offsets->End(); ++offsets)
+      {
+        if (maskNeighborIt.GetPixel(offsets.Value()) != m_InsidePixelValue)
+        {
+          continue; // Go to the next loop if we're not in the mask
+        }
+
+        bool            pixelInBounds;
+        const PixelType pixelIntensity = neighborIt.GetPixel(offsets.Value(), pixelInBounds);
+
+        if (!pixelInBounds)
+        {
+          continue; // don't put a pixel in the histogram if it's out-of-bounds.
+        }
+
+        if (pixelIntensity < m_Min || pixelIntensity > m_Max)
+        {
+          continue; // don't put a pixel in the histogram if the value
+                    // is out-of-bounds.
+        }
+
+        this->CountPair(centerPixelIntensity, pixelIntensity, cooccur, index, frequencies);
+      }
+    }
+  });
+}
 
+template <typename TImageType, typename THistogramFrequencyContainer, typename TMaskImageType>
+template <typename TCountPairs>
+void
+ScalarImageToCooccurrenceMatrixFilter<TImageType, THistogramFrequencyContainer, TMaskImageType>::ParallelFillHistogram(
+  const RegionType &  region,
+  const TCountPairs & countPairs)
+{
+  auto * output = static_cast<HistogramType *>(this->ProcessObject::GetOutput(0));
 
-      cooccur[1] = centerPixelIntensity;
-      cooccur[0] = pixelIntensity;
-      output->GetIndex(cooccur, index);
-      output->IncreaseFrequencyOfIndex(index, 1);
+  const auto         splitter = ImageRegionSplitterSlowDimension::New();
+  const unsigned int numberOfPieces = splitter->GetNumberOfSplits(region, this->GetNumberOfWorkUnits());
+
+  std::vector<PieceFrequencyContainerType> pieceFrequencies(numberOfPieces);
+
+  MultiThreaderBase * multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(numberOfPieces);
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfPieces,
+    [&](SizeValueType i) {
+      RegionType piece = region;
+      splitter->GetSplit(static_cast<unsigned int>(i), numberOfPieces, piece);
+      pieceFrequencies[i].assign(output->Size(), 0);
+      countPairs(piece, pieceFrequencies[i]);
+    },
+    nullptr);
+
+  // Add the frequencies of the pieces in a fixed order.
+  for (typename HistogramType::InstanceIdentifier id = 0; id < output->Size(); ++id)
+  {
+    typename HistogramType::AbsoluteFrequencyType frequency{};
+    for (const PieceFrequencyContainerType & frequencies : pieceFrequencies)
+    {
+      frequency += frequencies[id];
     }
+    if (frequency != 0)
+    {
+      output->IncreaseFrequency(id, frequency);
+    }
+  }
+}
+
+template <typename TImageType, typename THistogramFrequencyContainer, typename TMaskImageType>
+void
+ScalarImageToCooccurrenceMatrixFilter<TImageType, THistogramFrequencyContainer, TMaskImageType>::CountPair(
+  const PixelType                     centerPixelIntensity,
+  const PixelType                     pixelIntensity,
+  MeasurementVectorType &             cooccur,
+  typename HistogramType::IndexType & index,
+  PieceFrequencyContainerType &       frequencies) const
+{
+  // Both axes have the same bins, so that the index of the pair (pixel,
+  // center) is the transposed index of the pair (center, pixel).
+  cooccur[0] = centerPixelIntensity;
+  cooccur[1] = pixelIntensity;
+  if (!this->GetOutput()->GetIndex(cooccur, index))
+  {
+    return;
   }
+  const auto numberOfBinsPerAxis = static_cast<typename HistogramType::InstanceIdentifier>(m_NumberOfBinsPerAxis);
+  ++frequencies[index[0] + index[1] * numberOfBinsPerAxis];
+  ++frequencies[index[1] + index[0] * numberOfBinsPerAxis];
 }
 
 template <typename TImageType, typename THistogramFrequencyContainer, typename TMaskImageType>
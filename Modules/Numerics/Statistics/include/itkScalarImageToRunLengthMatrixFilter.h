@@ -23,6 +23,7 @@
 #include "itkNumericTraits.h"
 #include "itkVectorContainer.h"
 #include "itkProcessObject.h"
+#include <vector>
 
 namespace itk
 {
@@ -86,6 +87,11 @@ namespace Statistics
  * with little texture or in cases where the user wants more histogram bins,
  * a sparse container can be used for the histogram instead.
  *
+ * The runs of the lines following each offset are independent, so that the
+ * lines are followed in parallel by the work units of the filter, each one
+ * counting its runs in its own dense array of frequencies. The histogram does
+ * not depend on the number of work units.
+ *
  * WARNING: This probably won't work for pixels of double or long-double type
  * unless you set the histogram min and max manually. This is because the largest
  * histogram bin by default has max value of the largest possible pixel value
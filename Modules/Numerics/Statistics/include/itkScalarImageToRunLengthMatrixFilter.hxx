@@ -19,7 +19,11 @@
 #define itkScalarImageToRunLengthMatrixFilter_hxx
 
 
-#include "itkConstNeighborhoodIterator.h"
+#include <algorithm>
+
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionSplitterSlowDimension.h"
+#include "itkMultiThreaderBase.h"
 #include "itkNeighborhood.h"
 #include "itkMacro.h"
 #include "itkMath.h"
@@ -139,129 +143,177 @@ ScalarImageToRunLengthMatrixFilter<TImageType, THistogramFrequencyContainer>::Ge
   this->m_UpperBound[1] = this->m_MaxDistance;
   output->Initialize(size, this->m_LowerBound, this->m_UpperBound);
 
-  MeasurementVectorType             run(output->GetMeasurementVectorSize());
-  typename HistogramType::IndexType hIndex;
-
-  // Iterate over all of those pixels and offsets, adding each
-  // distance/intensity pair to the histogram
-
-  using NeighborhoodIteratorType = ConstNeighborhoodIterator<ImageType>;
-  auto                     radius = MakeFilled<typename NeighborhoodIteratorType::RadiusType>(1);
-  NeighborhoodIteratorType neighborIt(radius, inputImage, inputImage->GetRequestedRegion());
-
-
-  // this temp image has the same dimension for each offset
-  // moving the allocation out of loop of offsets
-  // while keeping FillBuffer with boolean false in each loop
-  using BoolImageType = Image<bool, ImageDimension>;
-  auto alreadyVisitedImage = BoolImageType::New();
-  alreadyVisitedImage->CopyInformation(inputImage);
-  alreadyVisitedImage->SetRegions(inputImage->GetRequestedRegion());
-  alreadyVisitedImage->Allocate();
+  const RegionType  region = inputImage->GetRequestedRegion();
+  const ImageType * maskImage = this->GetMaskImage();
 
+  // The offsets are normalized once for all the work units. A null offset
+  // does not define any run.
+  std::vector<OffsetType>              normalizedOffsets;
   typename OffsetVector::ConstIterator offsets;
   for (offsets = this->GetOffsets()->Begin(); offsets != this->GetOffsets()->End(); ++offsets)
   {
-
-    alreadyVisitedImage->FillBuffer(false);
-
-    neighborIt.GoToBegin();
     OffsetType offset = offsets.Value();
-
     this->NormalizeOffsetDirection(offset);
-
-
-    for (neighborIt.GoToBegin(); !neighborIt.IsAtEnd(); ++neighborIt)
+    if (offset != OffsetType{})
     {
-      const PixelType centerPixelIntensity = neighborIt.GetCenterPixel();
-      const IndexType centerIndex = neighborIt.GetIndex();
-      if (centerPixelIntensity < this->m_Min || centerPixelIntensity > this->m_Max ||
-          alreadyVisitedImage->GetPixel(centerIndex) ||
-          (this->GetMaskImage() && this->GetMaskImage()->GetPixel(centerIndex) != this->m_InsidePixelValue))
-      {
-        continue; // don't put a pixel in the histogram if the value
-                  // is out-of-bounds or is outside the mask.
-      }
-
-      itkDebugMacro("===> offset = " << offset << std::endl);
-
-      const MeasurementType centerBinMin = this->GetOutput()->GetBinMinFromValue(0, centerPixelIntensity);
-      const MeasurementType centerBinMax = this->GetOutput()->GetBinMaxFromValue(0, centerPixelIntensity);
-      const MeasurementType lastBinMax = this->GetOutput()->GetDimensionMaxs(0)[this->GetOutput()->GetSize(0) - 1];
-
-      auto      pixelIntensity(PixelType{});
-      IndexType index = centerIndex + offset;
-      IndexType lastGoodIndex = centerIndex;
-      bool      runLengthSegmentAlreadyVisited = false;
+      normalizedOffsets.push_back(offset);
+    }
+  }
 
-      // Scan from the current pixel at index, following
-      // the direction of offset. Run length is computed as the
-      // length of continuous pixels whose pixel values are
-      // in the same bin.
+  const MeasurementType lastBinMax = output->GetDimensionMaxs(0)[output->GetSize(0) - 1];
 
-      while (inputImage->GetRequestedRegion().IsInside(index))
-      {
-        // For the same offset, each run length segment can
-        // only be visited once
-        if (alreadyVisitedImage->GetPixel(index))
+  // The bins of the intensities are contiguous, so that the bounds returned
+  // by Histogram::GetBinMinFromValue() and Histogram::GetBinMaxFromValue()
+  // are found by binary searches instead of linear ones.
+  const std::vector<MeasurementType> & binMins = output->GetDimensionMins(0);
+  const std::vector<MeasurementType> & binMaxs = output->GetDimensionMaxs(0);
+  const auto getBinMinFromValue = [&binMins](const float value) -> MeasurementType {
+    if (value <= binMins.front())
+    {
+      return binMins.front();
+    }
+    if (value >= binMins.back())
+    {
+      return binMins.back();
+    }
+    return *(std::upper_bound(binMins.begin(), binMins.end(), value) - 1);
+  };
+  const auto getBinMaxFromValue = [&binMaxs](const float value) -> MeasurementType {
+    if (value <= binMaxs.front())
+    {
+      return binMaxs.front();
+    }
+    if (value >= binMaxs.back())
+    {
+      return binMaxs.back();
+    }
+    return *std::upper_bound(binMaxs.begin(), binMaxs.end(), value);
+  };
+
+  // Since the last non-zero component of a normalized offset is positive,
+  // the pixels of the requested region are, along each line following the
+  // offset, visited in the order of the line. Each run then starts at a pixel
+  // which is in the requested region, has a value in [min, max] and is in the
+  // mask, and is not in the bin of the pixel starting the previous run of the
+  // line, and the run goes on as long as the pixels of the line are in that
+  // bin. The lines do not depend on each other: the requested region is split
+  // in pieces, and the lines starting in each piece are followed in parallel,
+  // counting their runs in the dense array of frequencies of the piece.
+
+  using FrequencyContainerType = std::vector<typename HistogramType::AbsoluteFrequencyType>;
+
+  const auto         splitter = ImageRegionSplitterSlowDimension::New();
+  const unsigned int numberOfPieces = splitter->GetNumberOfSplits(region, this->GetNumberOfWorkUnits());
+
+  std::vector<FrequencyContainerType> pieceFrequencies(numberOfPieces);
+
+  MultiThreaderBase * multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(numberOfPieces);
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfPieces,
+    [&](SizeValueType i) {
+      RegionType piece = region;
+      splitter->GetSplit(static_cast<unsigned int>(i), numberOfPieces, piece);
+
+      FrequencyContainerType & frequencies = pieceFrequencies[i];
+      frequencies.assign(output->Size(), 0);
+
+      MeasurementVectorType             run(output->GetMeasurementVectorSize());
+      typename HistogramType::IndexType hIndex;
+
+      const auto addRun = [&](const IndexType & centerIndex, const IndexType & lastGoodIndex, PixelType intensity) {
+        PointType centerPoint;
+        inputImage->TransformIndexToPhysicalPoint(centerIndex, centerPoint);
+        PointType point;
+        inputImage->TransformIndexToPhysicalPoint(lastGoodIndex, point);
+
+        run[0] = intensity;
+        run[1] = centerPoint.EuclideanDistanceTo(point);
+
+        if (run[1] >= this->m_MinDistance && run[1] <= this->m_MaxDistance && output->GetIndex(run, hIndex))
         {
-          runLengthSegmentAlreadyVisited = true;
-          break;
+          ++frequencies[output->GetInstanceIdentifier(hIndex)];
         }
+      };
 
-        pixelIntensity = inputImage->GetPixel(index);
-
-        // Special attention paid to boundaries of bins.
-        // For the last bin,
-        // it is left close and right close (following the previous
-        // gerrit patch).
-        // For all
-        // other bins,
-        // the bin is left close and right open.
-
-        if (pixelIntensity >= centerBinMin &&
-            (pixelIntensity < centerBinMax ||
-             (Math::ExactlyEquals(pixelIntensity, centerBinMax) && Math::ExactlyEquals(centerBinMax, lastBinMax))))
-        {
-          alreadyVisitedImage->SetPixel(index, true);
-          lastGoodIndex = index;
-          index += offset;
-        }
-        else
+      for (const OffsetType & offset : normalizedOffsets)
+      {
+        for (ImageRegionConstIteratorWithIndex<ImageType> it(inputImage, piece); !it.IsAtEnd(); ++it)
         {
-          break;
+          if (region.IsInside(it.GetIndex() - offset))
+          {
+            continue; // the line of the offset does not start at this pixel.
+          }
+
+          bool            inRun = false;
+          IndexType       centerIndex{};
+          IndexType       lastGoodIndex{};
+          auto            centerPixelIntensity(PixelType{});
+          MeasurementType centerBinMin{};
+          MeasurementType centerBinMax{};
+
+          for (IndexType index = it.GetIndex(); region.IsInside(index); index += offset)
+          {
+            const PixelType pixelIntensity = inputImage->GetPixel(index);
+
+            if (inRun)
+            {
+              // Special attention paid to boundaries of bins.
+              // For the last bin,
+              // it is left close and right close (following the previous
+              // gerrit patch).
+              // For all
+              // other bins,
+              // the bin is left close and right open.
+
+              if (pixelIntensity >= centerBinMin &&
+                  (pixelIntensity < centerBinMax ||
+                   (Math::ExactlyEquals(pixelIntensity, centerBinMax) &&
+                    Math::ExactlyEquals(centerBinMax, lastBinMax))))
+              {
+                lastGoodIndex = index;
+                continue;
+              }
+              addRun(centerIndex, lastGoodIndex, centerPixelIntensity);
+              inRun = false;
+            }
+
+            if (pixelIntensity < this->m_Min || pixelIntensity > this->m_Max ||
+                (maskImage && maskImage->GetPixel(index) != this->m_InsidePixelValue))
+            {
+              continue; // don't start a run at a pixel if the value
+                        // is out-of-bounds or is outside the mask.
+            }
+
+            inRun = true;
+            centerIndex = index;
+            lastGoodIndex = index;
+            centerPixelIntensity = pixelIntensity;
+            centerBinMin = getBinMinFromValue(pixelIntensity);
+            centerBinMax = getBinMaxFromValue(pixelIntensity);
+          }
+
+          if (inRun)
+          {
+            addRun(centerIndex, lastGoodIndex, centerPixelIntensity);
+          }
         }
       }
+    },
+    nullptr);
 
-      if (runLengthSegmentAlreadyVisited)
-      {
-        continue;
-      }
-
-      PointType centerPoint;
-      inputImage->TransformIndexToPhysicalPoint(centerIndex, centerPoint);
-      PointType point;
-      inputImage->TransformIndexToPhysicalPoint(lastGoodIndex, point);
-
-      run[0] = centerPixelIntensity;
-      run[1] = centerPoint.EuclideanDistanceTo(point);
-
-      if (run[1] >= this->m_MinDistance && run[1] <= this->m_MaxDistance)
-      {
-        output->GetIndex(run, hIndex);
-        output->IncreaseFrequencyOfIndex(hIndex, 1);
-
-        itkDebugStatement(typename HistogramType::IndexType tempMeasurementIndex);
-        itkDebugStatement(output->GetIndex(run, tempMeasurementIndex));
-        itkDebugMacro("centerIndex<->index: " << static_cast<int>(centerPixelIntensity) << '@' << centerIndex << "<->"
-                                              << static_cast<int>(pixelIntensity) << '@' << index << ", Bin# "
-                                              << tempMeasurementIndex << ", Measurement: (" << run[0] << ", " << run[1]
-                                              << ')' << ", Center bin ["
-                                              << this->GetOutput()->GetBinMinFromValue(0, run[0]) << ','
-                                              << this->GetOutput()->GetBinMaxFromValue(0, run[0]) << ']' << "~["
-                                              << this->GetOutput()->GetBinMinFromValue(1, run[1]) << ','
-                                              << this->GetOutput()->GetBinMaxFromValue(1, run[1]) << ']' << std::endl);
-      }
+  // Add the frequencies of the pieces in a fixed order.
+  for (typename HistogramType::InstanceIdentifier id = 0; id < output->Size(); ++id)
+  {
+    typename HistogramType::AbsoluteFrequencyType frequency{};
+    for (const FrequencyContainerType & frequencies : pieceFrequencies)
+    {
+      frequency += frequencies[id];
+    }
+    if (frequency != 0)
+    {
+      output->IncreaseFrequency(id, frequency);
     }
   }
 }
@@ -0,0 +1,229 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkScalarImageToTextureFeaturesImageFilter_h
+#define itkScalarImageToTextureFeaturesImageFilter_h
+
+#include <vector>
+
+#include "itkImageToImageFilter.h"
+#include "itkVector.h"
+#include "itkVectorContainer.h"
+
+namespace itk
+{
+namespace Statistics
+{
+/**
+ * \class ScalarImageToTextureFeaturesImageFilter
+ *  \brief This class computes, for each pixel of an image, the texture
+ * features of the co-occurrence matrix of the neighborhood of the pixel.
+ *
+ * For each pixel, the co-occurrence matrix of its neighborhood, a box of the
+ * given radius clipped at the largest possible region of the input image, is
+ * the one that ScalarImageToCooccurrenceMatrixFilter computes for an image
+ * made of this neighborhood only, with the same offsets, number of bins,
+ * pixel value min and max, and mask. The output pixel is made of the eight
+ * features that HistogramToTextureFeaturesFilter computes for this matrix, in
+ * the order of HistogramToTextureFeaturesFilterEnums::TextureFeature: Energy,
+ * Entropy, Correlation, InverseDifferenceMoment, Inertia, ClusterShade,
+ * ClusterProminence and HaralickCorrelation. The features of a neighborhood
+ * without any co-occurrence pair are zero.
+ *
+ * The co-occurrence matrices are not computed from scratch for each pixel.
+ * As in MovingHistogramImageFilter, the matrix of a pixel is updated from
+ * the matrix of the previous pixel of the same line, by removing the pairs
+ * whose first pixel leaves the neighborhood and adding the pairs whose first
+ * pixel enters the neighborhood, so that the cost of a pixel is proportional
+ * to a face of the neighborhood instead of its volume. The bins of the input
+ * pixels are computed once, before the lines of the output image are
+ * processed in parallel.
+ *
+ * As for ScalarImageToCooccurrenceMatrixFilter, all the offsets are added to
+ * the same matrix. By default, the offsets are, as in
+ * ScalarImageToTextureFeaturesFilter, all the neighbors of a pixel with a
+ * radius of one which precede it. Since the features of each pixel are
+ * computed from a matrix of NumberOfBinsPerAxis * NumberOfBinsPerAxis bins,
+ * the default number of bins is 8.
+ *
+ * The run length matrices are not computed in neighborhoods:
+ * a run crossing a face of the neighborhood changes its length as the
+ * neighborhood moves, so that they cannot be updated in the same way.
+ *
+ * The output pixel type must be a fixed array of eight components, as
+ * Vector<float, 8>.
+ *
+ * \sa ScalarImageToCooccurrenceMatrixFilter
+ * \sa HistogramToTextureFeaturesFilter
+ * \sa ScalarImageToTextureFeaturesFilter
+ *
+ * \ingroup ITKStatistics
+ */
+template <typename TInputImage,
+          typename TOutputImage = Image<Vector<float, 8>, TInputImage::ImageDimension>,
+          typename TMaskImage = TInputImage>
+class ITK_TEMPLATE_EXPORT ScalarImageToTextureFeaturesImageFilter : public ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ScalarImageToTextureFeaturesImageFilter);
+
+  /** Standard class type aliases. */
+  using Self = ScalarImageToTextureFeaturesImageFilter;
+  using Superclass = ImageToImageFilter<TInputImage, TOutputImage>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(ScalarImageToTextureFeaturesImageFilter);
+
+  /** standard New() method support */
+  itkNewMacro(Self);
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using MaskImageType = TMaskImage;
+  using InputPixelType = typename InputImageType::PixelType;
+  using OutputPixelType = typename OutputImageType::PixelType;
+  using MaskPixelType = typename MaskImageType::PixelType;
+
+  using IndexType = typename InputImageType::IndexType;
+  using RegionType = typename InputImageType::RegionType;
+  using RadiusType = typename InputImageType::SizeType;
+  using OffsetType = typename InputImageType::OffsetType;
+  using OffsetVector = VectorContainer<unsigned char, OffsetType>;
+  using OffsetVectorPointer = typename OffsetVector::Pointer;
+  using OffsetVectorConstPointer = typename OffsetVector::ConstPointer;
+  using OutputImageRegionType = typename OutputImageType::RegionType;
+
+  using MeasurementType = typename NumericTraits<InputPixelType>::RealType;
+
+  /** ImageDimension constant */
+  static constexpr unsigned int ImageDimension = TInputImage::ImageDimension;
+
+  /** Number of features of an output pixel. */
+  static constexpr unsigned int NumberOfFeatures = 8;
+
+  static_assert(OutputPixelType::Length == NumberOfFeatures, "The output pixels must have eight components.");
+
+  static constexpr unsigned int DefaultBinsPerAxis = 8;
+
+  /** Set/Get the offsets of the co-occurrence pairs. */
+  itkSetConstObjectMacro(Offsets, OffsetVector);
+  itkGetConstObjectMacro(Offsets, OffsetVector);
+
+  /** Set a single offset of the co-occurrence pairs. */
+  void
+  SetOffset(const OffsetType offset);
+
+  /** Set/Get the radius of the neighborhoods. Default is 2. */
+  itkSetMacro(NeighborhoodRadius, RadiusType);
+  itkGetConstReferenceMacro(NeighborhoodRadius, RadiusType);
+
+  /** Set/Get the number of bins of each axis of the co-occurrence matrices. */
+  itkSetMacro(NumberOfBinsPerAxis, unsigned int);
+  itkGetConstMacro(NumberOfBinsPerAxis, unsigned int);
+
+  /** Set the min and max (inclusive) pixel value of the co-occurrence
+   * matrices. */
+  void
+  SetPixelValueMinMax(InputPixelType min, InputPixelType max);
+
+  itkGetConstMacro(Min, InputPixelType);
+  itkGetConstMacro(Max, InputPixelType);
+
+  /** Set/Get the mask image. Only the pixels whose mask value is the inside
+   * pixel value are part of co-occurrence pairs. */
+  void
+  SetMaskImage(const MaskImageType * image);
+
+  const MaskImageType *
+  GetMaskImage() const;
+
+  /** Set/Get the pixel value of the mask that should be considered "inside"
+   * the object. Defaults to one. */
+  itkSetMacro(InsidePixelValue, MaskPixelType);
+  itkGetConstMacro(InsidePixelValue, MaskPixelType);
+
+protected:
+  ScalarImageToTextureFeaturesImageFilter();
+  ~ScalarImageToTextureFeaturesImageFilter() override = default;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** The input and mask requested regions are the output requested region
+   * padded by the radius of the neighborhoods. */
+  void
+  GenerateInputRequestedRegion() override;
+
+  /** Compute the bins of the input pixels, and the logarithms of the possible
+   * frequencies. */
+  void
+  BeforeThreadedGenerateData() override;
+
+  void
+  DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
+
+  void
+  AfterThreadedGenerateData() override;
+
+private:
+  /** Bins of the input pixels, or -1 for the pixels which are not part of
+   * co-occurrence pairs. */
+  using BinImageType = Image<int, ImageDimension>;
+
+  /** Frequencies of a co-occurrence matrix, indexed by i + j * bins. */
+  using FrequencyContainerType = std::vector<OffsetValueType>;
+
+  /** Add delta to the frequencies of the pairs whose first pixel is in the
+   * given box of the bin image, and whose second pixel is at the given offset
+   * in the buffer. */
+  void
+  AccumulatePairs(const IndexType &        first,
+                  const IndexType &        last,
+                  OffsetValueType          pairOffset,
+                  OffsetValueType          delta,
+                  FrequencyContainerType & frequencies,
+                  OffsetValueType &        totalFrequency) const;
+
+  /** Compute the features of a co-occurrence matrix, as
+   * HistogramToTextureFeaturesFilter. */
+  void
+  ComputeFeatures(const FrequencyContainerType & frequencies,
+                  OffsetValueType                totalFrequency,
+                  std::vector<double> &          marginalSums,
+                  OutputPixelType &              features) const;
+
+  OffsetVectorConstPointer m_Offsets{};
+  RadiusType               m_NeighborhoodRadius{};
+  unsigned int             m_NumberOfBinsPerAxis{ DefaultBinsPerAxis };
+  InputPixelType           m_Min{};
+  InputPixelType           m_Max{};
+  MaskPixelType            m_InsidePixelValue{};
+
+  typename BinImageType::Pointer m_BinImage{};
+
+  /** Natural logarithms of the possible absolute frequencies. */
+  std::vector<double> m_Logarithms{};
+};
+} // end of namespace Statistics
+} // end of namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkScalarImageToTextureFeaturesImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,505 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkScalarImageToTextureFeaturesImageFilter_hxx
+#define itkScalarImageToTextureFeaturesImageFilter_hxx
+
+#include <algorithm>
+
+#include "itkHistogram.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageScanlineIterator.h"
+#include "itkNeighborhood.h"
+#include "itkMath.h"
+
+namespace itk
+{
+namespace Statistics
+{
+template <typename TInputImage, typename TOutputImage, typename TMaskImage>
+ScalarImageToTextureFeaturesImageFilter<TInputImage, TOutputImage, TMaskImage>::
+  ScalarImageToTextureFeaturesImageFilter()
+  : m_Min(NumericTraits<InputPixelType>::NonpositiveMin())
+  , m_Max(NumericTraits<InputPixelType>::max())
+  , m_InsidePixelValue(NumericTraits<MaskPixelType>::OneValue())
+{
+  m_NeighborhoodRadius.Fill(2);
+
+  // Set the offset directions to their defaults: half of all the possible
+  // directions 1 pixel away. (The other half is included by symmetry.)
+  using NeighborhoodType = Neighborhood<InputPixelType, ImageDimension>;
+  NeighborhoodType hood;
+  hood.SetRadius(1);
+
+  const unsigned int        centerIndex = hood.GetCenterNeighborhoodIndex();
+  const OffsetVectorPointer offsets = OffsetVector::New();
+  for (unsigned int d = 0; d < centerIndex; ++d)
+  {
+    offsets->push_back(hood.GetOffset(d));
+  }
+  m_Offsets = offsets;
+
+  this->DynamicMultiThreadingOn();
+  this->ThreaderUpdateProgressOff();
+}
+
+template <typename TInputImage, typename TOutputImage, typename TMaskImage>
+void
+ScalarImageToTextureFeaturesImageFilter<TInputImage, TOutputImage, TMaskImage>::SetOffset(const OffsetType offset)
+{
+  const OffsetVectorPointer offsetVector = OffsetVector::New();
+  offsetVector->push_back(offset);
+  this->SetOffsets(offsetVector);
+}
+
+template <typename TInputImage, typename TOutputImage, typename TMaskImage>
+void
+ScalarImageToTextureFeaturesImageFilter<TInputImage, TOutputImage, TMaskImage>::SetPixelValueMinMax(
+  InputPixelType min,
+  InputPixelType max)
+{
+  itkDebugMacro("setting Min to " << min << "and Max to " << max);
+  m_Min = min;
+  m_Max = max;
+  this->Modified();
+}
+
+template <typename TInputImage, typename TOutputImage, typename TMaskImage>
+void
+ScalarImageToTextureFeaturesImageFilter<TInputImage, TOutputImage, TMaskImage>::SetMaskImage(
+  const MaskImageType * image)
+{
+  // Process object is not const-correct so the const_cast is required here
+  this->ProcessObject::SetNthInput(1, const_cast<MaskImageType *>(image));
+}
+
+template <typename TInputImage, typename TOutputImage, typename TMaskImage>
+auto
+ScalarImageToTextureFeaturesImageFilter<TInputImage, TOutputImage, TMaskImage>::GetMaskImage() const
+  -> const MaskImageType *
+{
+  return static_cast<const MaskImageType *>(this->ProcessObject::GetInput(1));
+}
+
+template <typename TInputImage, typename TOutputImage, typename TMaskImage>
+void
+ScalarImageToTextureFeaturesImageFilter<TInputImage, TOutputImage, TMaskImage>::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  auto * input = const_cast<InputImageType *>(this->GetInput());
+  if (!input)
+  {
+    return;
+  }
+
+  // pad the output requested region by the radius of the neighborhoods, and
+  // crop it at the input's largest possible region
+  RegionType requestedRegion = this->GetOutput()->GetRequestedRegion();
+  requestedRegion.PadByRadius(m_NeighborhoodRadius);
+  if (!requestedRegion.Crop(input->GetLargestPossibleRegion()))
+  {
+    input->SetRequestedRegion(requestedRegion);
+
+    InvalidRequestedRegionError e(__FILE__, __LINE__);
+    e.SetLocation(ITK_LOCATION);
+    e.SetDescription("Requested region is (at least partially) outside the largest possible region.");
+    e.SetDataObject(input);
+    throw e;
+  }
+  input->SetRequestedRegion(requestedRegion);
+
+  auto * mask = const_cast<MaskImageType *>(this->GetMaskImage());
+  if (mask)
+  {
+    mask->SetRequestedRegion(requestedRegion);
+  }
+}
+
+template <typename TInputImage, typename TOutputImage, typename TMaskImage>
+void
+ScalarImageToTextureFeaturesImageFilter<TInputImage, TOutputImage, TMaskImage>::BeforeThreadedGenerateData()
+{
+  const InputImageType * input = this->GetInput();
+  const MaskImageType *  mask = this->GetMaskImage();
+
+  if (m_NumberOfBinsPerAxis == 0)
+  {
+    itkExceptionMacro("The number of bins per axis must be positive.");
+  }
+
+  // The bins of the pixels are the ones of the first axis of the histogram
+  // of ScalarImageToCooccurrenceMatrixFilter.
+  using HistogramType = Histogram<MeasurementType>;
+  auto histogram = HistogramType::New();
+  histogram->SetMeasurementVectorSize(1);
+  typename HistogramType::SizeType              size(1);
+  typename HistogramType::MeasurementVectorType lowerBound(1);
+  typename HistogramType::MeasurementVectorType upperBound(1);
+  size.Fill(m_NumberOfBinsPerAxis);
+  lowerBound.Fill(m_Min);
+  upperBound.Fill(m_Max + 1);
+  histogram->Initialize(size, lowerBound, upperBound);
+
+  // The total frequency of a co-occurrence matrix is at most twice the number
+  // of pixels of a neighborhood times the number of offsets.
+  SizeValueType maximumTotalFrequency = 2 * m_Offsets->size();
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+  {
+    maximumTotalFrequency *= 2 * m_NeighborhoodRadius[d] + 1;
+  }
+  m_Logarithms.resize(maximumTotalFrequency + 1);
+  m_Logarithms[0] = 0.0;
+  for (SizeValueType i = 1; i <= maximumTotalFrequency; ++i)
+  {
+    m_Logarithms[i] = std::log(static_cast<double>(i));
+  }
+
+  const RegionType region = input->GetRequestedRegion();
+  m_BinImage = BinImageType::New();
+  m_BinImage->SetRegions(region);
+  m_BinImage->Allocate();
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    region,
+    [this, input, mask, &histogram](const RegionType & piece) {
+      typename HistogramType::MeasurementVectorType measurement(1);
+      typename HistogramType::IndexType             index(1);
+
+      ImageRegionConstIterator<InputImageType> inputIt(input, piece);
+      ImageRegionIterator<BinImageType>        binIt(m_BinImage, piece);
+      for (; !inputIt.IsAtEnd(); ++inputIt, ++binIt)
+      {
+        const InputPixelType value = inputIt.Get();
+        int                  bin = -1;
+        if (!(value < m_Min || value > m_Max) &&
+            (mask == nullptr || mask->GetPixel(inputIt.GetIndex()) == m_InsidePixelValue))
+        {
+          measurement[0] = value;
+          if (histogram->GetIndex(measurement, index))
+          {
+            bin = static_cast<int>(index[0]);
+          }
+        }
+        binIt.Set(bin);
+      }
+    },
+    nullptr);
+}
+
+template <typename TInputImage, typename TOutputImage, typename TMaskImage>
+void
+ScalarImageToTextureFeaturesImageFilter<TInputImage, TOutputImage, TMaskImage>::DynamicThreadedGenerateData(
+  const OutputImageRegionType & outputRegionForThread)
+{
+  OutputImageType * output = this->GetOutput();
+
+  const RegionType binRegion = m_BinImage->GetBufferedRegion();
+  const IndexType  binStart = binRegion.GetIndex();
+  const IndexType  binEnd = binRegion.GetUpperIndex();
+
+  const std::size_t numberOfOffsets = m_Offsets->size();
+  const unsigned    binsPerAxis = m_NumberOfBinsPerAxis;
+
+  // Offsets of the pairs in the buffer of the bins.
+  const OffsetValueType *      offsetTable = m_BinImage->GetOffsetTable();
+  std::vector<OffsetValueType> pairOffsets(numberOfOffsets, 0);
+  for (std::size_t k = 0; k < numberOfOffsets; ++k)
+  {
+    for (unsigned int d = 0; d < ImageDimension; ++d)
+    {
+      pairOffsets[k] += m_Offsets->ElementAt(k)[d] * offsetTable[d];
+    }
+  }
+
+  FrequencyContainerType frequencies(binsPerAxis * binsPerAxis);
+  std::vector<double>    marginalSums(binsPerAxis);
+  OffsetValueType        totalFrequency = 0;
+
+  // For each offset, the first pixels of the pairs of the neighborhood of the
+  // current pixel are in a box, whose range along the first dimension
+  // increases with the pixels of the line.
+  std::vector<IndexType> first(numberOfOffsets);
+  std::vector<IndexType> last(numberOfOffsets);
+
+  OutputPixelType features;
+
+  ImageScanlineIterator<OutputImageType> outputIt(output, outputRegionForThread);
+  while (!outputIt.IsAtEnd())
+  {
+    const IndexType lineIndex = outputIt.GetIndex();
+
+    std::fill(frequencies.begin(), frequencies.end(), 0);
+    totalFrequency = 0;
+
+    // The neighborhood of a pixel of the line, but along the first dimension.
+    IndexType neighborhoodStart;
+    IndexType neighborhoodEnd;
+    for (unsigned int d = 1; d < ImageDimension; ++d)
+    {
+      const auto radius = static_cast<IndexValueType>(m_NeighborhoodRadius[d]);
+      neighborhoodStart[d] = std::max(lineIndex[d] - radius, binStart[d]);
+      neighborhoodEnd[d] = std::min(lineIndex[d] + radius, binEnd[d]);
+    }
+
+    const auto radius = static_cast<IndexValueType>(m_NeighborhoodRadius[0]);
+    bool       firstPixel = true;
+    while (!outputIt.IsAtEndOfLine())
+    {
+      const IndexValueType x = outputIt.GetIndex()[0];
+      neighborhoodStart[0] = std::max(x - radius, binStart[0]);
+      neighborhoodEnd[0] = std::min(x + radius, binEnd[0]);
+
+      for (std::size_t k = 0; k < numberOfOffsets; ++k)
+      {
+        const OffsetType & offset = m_Offsets->ElementAt(k);
+
+        // Both pixels of a pair are in the neighborhood.
+        IndexType pairStart;
+        IndexType pairEnd;
+        for (unsigned int d = 0; d < ImageDimension; ++d)
+        {
+          pairStart[d] = std::max(neighborhoodStart[d], neighborhoodStart[d] - offset[d]);
+          pairEnd[d] = std::min(neighborhoodEnd[d], neighborhoodEnd[d] - offset[d]);
+        }
+
+        if (firstPixel)
+        {
+          this->AccumulatePairs(pairStart, pairEnd, pairOffsets[k], 1, frequencies, totalFrequency);
+        }
+        else
+        {
+          // Remove the pairs whose first pixel leaves the box, and add the
+          // pairs whose first pixel enters it.
+          IndexType removedEnd = last[k];
+          removedEnd[0] = std::min(last[k][0], pairStart[0] - 1);
+          this->AccumulatePairs(first[k], removedEnd, pairOffsets[k], -1, frequencies, totalFrequency);
+
+          IndexType addedStart = pairStart;
+          addedStart[0] = std::max(pairStart[0], last[k][0] + 1);
+          this->AccumulatePairs(addedStart, pairEnd, pairOffsets[k], 1, frequencies, totalFrequency);
+        }
+        first[k] = pairStart;
+        last[k] = pairEnd;
+      }
+      firstPixel = false;
+
+      this->ComputeFeatures(frequencies, totalFrequency, marginalSums, features);
+      outputIt.Set(features);
+      ++outputIt;
+    }
+    outputIt.NextLine();
+  }
+}
+
+template <typename TInputImage, typename TOutputImage, typename TMaskImage>
+void
+ScalarImageToTextureFeaturesImageFilter<TInputImage, TOutputImage, TMaskImage>::AfterThreadedGenerateData()
+{
+  m_BinImage = nullptr;
+  m_Logarithms.clear();
+  m_Logarithms.shrink_to_fit();
+}
+
+template <typename TInputImage, typename TOutputImage, typename TMaskImage>
+void
+ScalarImageToTextureFeaturesImageFilter<TInputImage, TOutputImage, TMaskImage>::AccumulatePairs(
+  const IndexType &        first,
+  const IndexType &        last,
+  OffsetValueType          pairOffset,
+  OffsetValueType          delta,
+  FrequencyContainerType & frequencies,
+  OffsetValueType &        totalFrequency) const
+{
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+  {
+    if (first[d] > last[d])
+    {
+      return;
+    }
+  }
+
+  const OffsetValueType * offsetTable = m_BinImage->GetOffsetTable();
+  const std::size_t       binsPerAxis = m_NumberOfBinsPerAxis;
+  const IndexValueType    length = last[0] - first[0] + 1;
+
+  const int * firstBins = m_BinImage->GetBufferPointer() + m_BinImage->ComputeOffset(first);
+  IndexType   index = first;
+  while (true)
+  {
+    const int * secondBins = firstBins + pairOffset;
+    for (IndexValueType i = 0; i < length; ++i)
+    {
+      const int firstBin = firstBins[i];
+      const int secondBin = secondBins[i];
+      if (firstBin >= 0 && secondBin >= 0)
+      {
+        // Both combinations of the pair, as in
+        // ScalarImageToCooccurrenceMatrixFilter.
+        frequencies[firstBin + secondBin * binsPerAxis] += delta;
+        frequencies[secondBin + firstBin * binsPerAxis] += delta;
+        totalFrequency += 2 * delta;
+      }
+    }
+
+    // Next line of the box.
+    unsigned int d = 1;
+    for (; d < ImageDimension; ++d)
+    {
+      if (index[d] < last[d])
+      {
+        ++index[d];
+        firstBins += offsetTable[d];
+        break;
+      }
+      firstBins -= (last[d] - first[d]) * offsetTable[d];
+      index[d] = first[d];
+    }
+    if (d == ImageDimension)
+    {
+      return;
+    }
+  }
+}
+
+template <typename TInputImage, typename TOutputImage, typename TMaskImage>
+void
+ScalarImageToTextureFeaturesImageFilter<TInputImage, TOutputImage, TMaskImage>::ComputeFeatures(
+  const FrequencyContainerType & frequencies,
+  OffsetValueType                totalFrequency,
+  std::vector<double> &          marginalSums,
+  OutputPixelType &              features) const
+{
+  using ValueType = typename OutputPixelType::ValueType;
+
+  if (totalFrequency == 0)
+  {
+    features.Fill(ValueType{});
+    return;
+  }
+
+  const unsigned int binsPerAxis = m_NumberOfBinsPerAxis;
+  const double       inverseTotal = 1.0 / static_cast<double>(totalFrequency);
+
+  // Means and variances, as HistogramToTextureFeaturesFilter computes them.
+  double pixelMean = 0.0;
+  std::fill(marginalSums.begin(), marginalSums.end(), 0.0);
+  for (unsigned int j = 0; j < binsPerAxis; ++j)
+  {
+    for (unsigned int i = 0; i < binsPerAxis; ++i)
+    {
+      const double frequency = frequencies[i + j * binsPerAxis] * inverseTotal;
+      pixelMean += i * frequency;
+      marginalSums[i] += frequency;
+    }
+  }
+
+  // Incremental mean and deviation of the marginal sums (Knuth).
+  double marginalMean = marginalSums[0];
+  double marginalDevSquared = 0.0;
+  for (unsigned int i = 1; i < binsPerAxis; ++i)
+  {
+    const double previousMean = marginalMean;
+    marginalMean += (marginalSums[i] - previousMean) / (i + 1);
+    marginalDevSquared += (marginalSums[i] - previousMean) * (marginalSums[i] - marginalMean);
+  }
+  marginalDevSquared /= binsPerAxis;
+
+  double pixelVariance = 0.0;
+  for (unsigned int j = 0; j < binsPerAxis; ++j)
+  {
+    for (unsigned int i = 0; i < binsPerAxis; ++i)
+    {
+      const double frequency = frequencies[i + j * binsPerAxis] * inverseTotal;
+      pixelVariance += (i - pixelMean) * (i - pixelMean) * frequency;
+    }
+  }
+
+  double pixelVarianceSquared = pixelVariance * pixelVariance;
+  if (Math::FloatAlmostEqual(pixelVarianceSquared, 0.0, 4, 2 * NumericTraits<double>::epsilon()))
+  {
+    pixelVarianceSquared = 1.;
+  }
+  // The logarithms of the frequencies are the differences of the logarithms
+  // of the absolute frequencies and of the total frequency.
+  const double inverseLog2 = 1.0 / std::log(2.0);
+  const double logTotal = m_Logarithms[totalFrequency];
+
+  double energy = 0.0;
+  double entropy = 0.0;
+  double correlation = 0.0;
+  double inverseDifferenceMoment = 0.0;
+  double inertia = 0.0;
+  double clusterShade = 0.0;
+  double clusterProminence = 0.0;
+  double haralickCorrelation = 0.0;
+  for (unsigned int j = 0; j < binsPerAxis; ++j)
+  {
+    for (unsigned int i = 0; i < binsPerAxis; ++i)
+    {
+      const OffsetValueType absoluteFrequency = frequencies[i + j * binsPerAxis];
+      if (absoluteFrequency == 0)
+      {
+        continue;
+      }
+      const double frequency = absoluteFrequency * inverseTotal;
+      const double difference = static_cast<double>(i) - static_cast<double>(j);
+      const double sum = (i - pixelMean) + (j - pixelMean);
+
+      energy += frequency * frequency;
+      entropy -= (frequency > 0.0001) ? frequency * (m_Logarithms[absoluteFrequency] - logTotal) * inverseLog2 : 0;
+      correlation += ((i - pixelMean) * (j - pixelMean) * frequency) / pixelVarianceSquared;
+      inverseDifferenceMoment += frequency / (1.0 + difference * difference);
+      inertia += difference * difference * frequency;
+      clusterShade += sum * sum * sum * frequency;
+      clusterProminence += sum * sum * sum * sum * frequency;
+      haralickCorrelation += static_cast<double>(i) * j * frequency;
+    }
+  }
+  haralickCorrelation = (haralickCorrelation - marginalMean * marginalMean) / marginalDevSquared;
+
+  features[0] = static_cast<ValueType>(energy);
+  features[1] = static_cast<ValueType>(entropy);
+  features[2] = static_cast<ValueType>(correlation);
+  features[3] = static_cast<ValueType>(inverseDifferenceMoment);
+  features[4] = static_cast<ValueType>(inertia);
+  features[5] = static_cast<ValueType>(clusterShade);
+  features[6] = static_cast<ValueType>(clusterProminence);
+  features[7] = static_cast<ValueType>(haralickCorrelation);
+}
+
+template <typename TInputImage, typename TOutputImage, typename TMaskImage>
+void
+ScalarImageToTextureFeaturesImageFilter<TInputImage, TOutputImage, TMaskImage>::PrintSelf(std::ostream & os,
+                                                                                         Indent         indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  itkPrintSelfObjectMacro(Offsets);
+  os << indent << "NeighborhoodRadius: " << m_NeighborhoodRadius << std::endl;
+  os << indent << "NumberOfBinsPerAxis: " << m_NumberOfBinsPerAxis << std::endl;
+  os << indent << "Min: " << static_cast<typename NumericTraits<InputPixelType>::PrintType>(m_Min) << std::endl;
+  os << indent << "Max: " << static_cast<typename NumericTraits<InputPixelType>::PrintType>(m_Max) << std::endl;
+  os << indent
+     << "InsidePixelValue: " << static_cast<typename NumericTraits<MaskPixelType>::PrintType>(m_InsidePixelValue)
+     << std::endl;
+}
+} // end of namespace Statistics
+} // end of namespace itk
+
+#endif
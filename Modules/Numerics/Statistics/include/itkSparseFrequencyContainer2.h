@@ -18,7 +18,7 @@
 #ifndef itkSparseFrequencyContainer2_h
 #define itkSparseFrequencyContainer2_h
 
-#include <map>
+#include <unordered_map>
 #include "itkObjectFactory.h"
 #include "itkObject.h"
 #include "itkNumericTraits.h"
@@ -33,8 +33,10 @@ namespace Statistics
  * \class SparseFrequencyContainer2
  *  \brief his class is a container for an histogram.
  *
- *  This class uses an map to store histogram. If your histogram is dense
- *  use DenseHistogram.  You should access each bin by
+ *  This class uses a hash map to store histogram, so that only the bins
+ *  whose frequency has been set use memory, and each bin is accessed in
+ *  constant time on average. If your histogram is dense use
+ *  DenseFrequencyContainer2.  You should access each bin by
  * (InstanceIdentifier)index or measurement vector.
  * \ingroup ITKStatistics
  */
@@ -70,7 +72,7 @@ public:
   using TotalRelativeFrequencyType = MeasurementVectorTraits::TotalRelativeFrequencyType;
 
   /** Histogram type alias support */
-  using FrequencyContainerType = std::map<InstanceIdentifier, AbsoluteFrequencyType>;
+  using FrequencyContainerType = std::unordered_map<InstanceIdentifier, AbsoluteFrequencyType>;
   using FrequencyContainerConstIterator = FrequencyContainerType::const_iterator;
 
   /** prepares the frequency container */
@@ -103,6 +105,19 @@ public:
     return m_TotalFrequency;
   }
 
+  /** Iterators over the bins whose frequency has been set, in no particular
+   * order, as pairs of instance identifier and frequency. */
+  FrequencyContainerConstIterator
+  Begin() const
+  {
+    return m_FrequencyContainer.begin();
+  }
+  FrequencyContainerConstIterator
+  End() const
+  {
+    return m_FrequencyContainer.end();
+  }
+
 protected:
   SparseFrequencyContainer2();
   ~SparseFrequencyContainer2() override = default;
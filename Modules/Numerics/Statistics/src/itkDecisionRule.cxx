@@ -25,5 +25,22 @@ DecisionRule::DecisionRule() = default;
 
 DecisionRule::~DecisionRule() = default;
 
+void
+DecisionRule::BatchEvaluate(const MembershipValueType * discriminantScores,
+                            unsigned int                numberOfClasses,
+                            SizeValueType               numberOfMeasurementVectors,
+                            ClassIdentifierType *       classIdentifiers) const
+{
+  MembershipVectorType scores(numberOfClasses);
+  for (SizeValueType i = 0; i < numberOfMeasurementVectors; ++i)
+  {
+    for (unsigned int k = 0; k < numberOfClasses; ++k)
+    {
+      scores[k] = discriminantScores[k * numberOfMeasurementVectors + i];
+    }
+    classIdentifiers[i] = this->Evaluate(scores);
+  }
+}
+
 } // end of namespace Statistics
 } // end of namespace itk
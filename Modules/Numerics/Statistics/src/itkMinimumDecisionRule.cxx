@@ -17,6 +17,8 @@
  *=========================================================================*/
 #include "itkMinimumDecisionRule.h"
 
+#include <algorithm>
+
 namespace itk
 {
 namespace Statistics
@@ -41,5 +43,34 @@ MinimumDecisionRule::Evaluate(const MembershipVectorType & discriminantScores) c
   }
   return minIndex;
 }
+
+void
+MinimumDecisionRule::BatchEvaluate(const MembershipValueType * discriminantScores,
+                                  unsigned int                numberOfClasses,
+                                  SizeValueType               numberOfMeasurementVectors,
+                                  ClassIdentifierType *       classIdentifiers) const
+{
+  if (numberOfClasses == 0)
+  {
+    std::fill_n(classIdentifiers, numberOfMeasurementVectors, 0);
+    return;
+  }
+
+  // The best scores are updated class after class, over contiguous scores.
+  std::vector<MembershipValueType> bestScores(discriminantScores, discriminantScores + numberOfMeasurementVectors);
+  std::fill_n(classIdentifiers, numberOfMeasurementVectors, 0);
+  for (unsigned int k = 1; k < numberOfClasses; ++k)
+  {
+    const MembershipValueType * const scores = discriminantScores + k * numberOfMeasurementVectors;
+    for (SizeValueType i = 0; i < numberOfMeasurementVectors; ++i)
+    {
+      if (scores[i] < bestScores[i])
+      {
+        bestScores[i] = scores[i];
+        classIdentifiers[i] = k;
+      }
+    }
+  }
+}
 } // end of namespace Statistics
 } // end of namespace itk
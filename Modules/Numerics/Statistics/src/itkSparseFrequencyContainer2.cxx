@@ -32,13 +32,8 @@ SparseFrequencyContainer2::Initialize(SizeValueType)
 void
 SparseFrequencyContainer2::SetToZero()
 {
-  auto iter = m_FrequencyContainer.begin();
-  auto end = m_FrequencyContainer.end();
-  while (iter != end)
-  {
-    iter->second = AbsoluteFrequencyType{};
-    ++iter;
-  }
+  // The frequency of the bins which are not in the map is zero
+  m_FrequencyContainer.clear();
   m_TotalFrequency = TotalAbsoluteFrequencyType{};
 }
 
@@ -47,10 +42,10 @@ SparseFrequencyContainer2::SetFrequency(const InstanceIdentifier id, const Absol
 {
   // No need to test for bounds because in a map container the
   // element is allocated if the key doesn't exist yet
-  const AbsoluteFrequencyType frequency = this->GetFrequency(id);
+  AbsoluteFrequencyType & frequency = m_FrequencyContainer[id];
 
-  m_FrequencyContainer[id] = value;
   m_TotalFrequency += (value - frequency);
+  frequency = value;
   return true;
 }
 
@@ -72,9 +67,7 @@ SparseFrequencyContainer2::IncreaseFrequency(const InstanceIdentifier id, const
 {
   // No need to test for bounds because in a map container the
   // element is allocated if the key doesn't exist yet
-  const AbsoluteFrequencyType frequency = this->GetFrequency(id);
-
-  m_FrequencyContainer[id] = frequency + value;
+  m_FrequencyContainer[id] += value;
   m_TotalFrequency += value;
   return true;
 }
@@ -0,0 +1,240 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkExpectationMaximizationMixtureModelEstimator.h"
+#include "itkGaussianMixtureModelComponent.h"
+#include "itkListSample.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkMath.h"
+#include "itkTestingMacros.h"
+
+/* Estimate a mixture of three Gaussians of a three-dimensional sample with
+ * outliers. Compare the memberships of the first iteration, and the
+ * parameters they give, with the ones of the membership functions and of the
+ * weighted mean and covariance filters, and check that the estimates do not
+ * depend on the number of work units. */
+int
+itkExpectationMaximizationMixtureModelEstimatorTest2(int, char *[])
+{
+  constexpr unsigned int measurementVectorSize = 3;
+  constexpr unsigned int numberOfClasses = 3;
+  constexpr unsigned int numberOfMeasurementVectors = 12000;
+  constexpr unsigned int numberOfOutliers = 5;
+
+  using MeasurementVectorType = itk::Vector<float, measurementVectorSize>;
+  using SampleType = itk::Statistics::ListSample<MeasurementVectorType>;
+  using EstimatorType = itk::Statistics::ExpectationMaximizationMixtureModelEstimator<SampleType>;
+  using ComponentType = itk::Statistics::GaussianMixtureModelComponent<SampleType>;
+  using ParametersType = ComponentType::ParametersType;
+
+  const double trueMeans[numberOfClasses][measurementVectorSize] = { { 100.0, 200.0, 50.0 },
+                                                                     { 150.0, 120.0, 90.0 },
+                                                                     { 60.0, 90.0, 140.0 } };
+  const double trueVariances[numberOfClasses] = { 100.0, 225.0, 400.0 };
+
+  using NumberGeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  const NumberGeneratorType::Pointer randomNumberGenerator = NumberGeneratorType::GetInstance();
+  randomNumberGenerator->Initialize(20250401);
+
+  auto sample = SampleType::New();
+  sample->SetMeasurementVectorSize(measurementVectorSize);
+  for (unsigned int i = 0; i < numberOfMeasurementVectors; ++i)
+  {
+    MeasurementVectorType measurementVector;
+    for (unsigned int d = 0; d < measurementVectorSize; ++d)
+    {
+      measurementVector[d] = static_cast<float>(
+        randomNumberGenerator->GetNormalVariate(trueMeans[i % numberOfClasses][d], trueVariances[i % numberOfClasses]));
+    }
+    sample->PushBack(measurementVector);
+  }
+  // Outliers, whose densities are too small to be normalized, or zero.
+  for (unsigned int i = 0; i < numberOfOutliers; ++i)
+  {
+    MeasurementVectorType measurementVector;
+    measurementVector.Fill(static_cast<float>(i + 1 < numberOfOutliers ? 350.0 + 20.0 * i : 5000.0));
+    sample->PushBack(measurementVector);
+  }
+
+  std::vector<ParametersType> initialParameters(numberOfClasses,
+                                                ParametersType(measurementVectorSize * (measurementVectorSize + 1)));
+  for (unsigned int j = 0; j < numberOfClasses; ++j)
+  {
+    initialParameters[j].Fill(0.0);
+    for (unsigned int d = 0; d < measurementVectorSize; ++d)
+    {
+      initialParameters[j][d] = trueMeans[j][d] + 15.0 - 10.0 * d;
+      initialParameters[j][measurementVectorSize + d * (measurementVectorSize + 1)] = 300.0;
+    }
+  }
+  EstimatorType::ProportionVectorType initialProportions(numberOfClasses);
+  initialProportions[0] = 0.5;
+  initialProportions[1] = 0.3;
+  initialProportions[2] = 0.2;
+
+  std::vector<ComponentType::Pointer> components;
+  auto                                estimator = EstimatorType::New();
+  estimator->SetSample(sample);
+  for (unsigned int j = 0; j < numberOfClasses; ++j)
+  {
+    components.push_back(ComponentType::New());
+    components[j]->SetSample(sample);
+    estimator->AddComponent(components[j]);
+  }
+
+  const auto initialize = [&](itk::ThreadIdType numberOfWorkUnits, int maximumIteration) {
+    for (unsigned int j = 0; j < numberOfClasses; ++j)
+    {
+      components[j]->SetParameters(initialParameters[j]);
+    }
+    estimator->SetInitialProportions(initialProportions);
+    estimator->SetMaximumIteration(maximumIteration);
+    estimator->SetNumberOfWorkUnits(numberOfWorkUnits);
+  };
+
+  // The memberships of the first iteration are the normalized densities of
+  // the membership functions, unless their sum is too small.
+  initialize(8, 1);
+  ITK_TEST_SET_GET_VALUE(8, estimator->GetNumberOfWorkUnits());
+  ITK_TRY_EXPECT_NO_EXCEPTION(estimator->Update());
+
+  std::vector<itk::Statistics::GaussianMembershipFunction<MeasurementVectorType>::Pointer> membershipFunctions;
+  for (unsigned int j = 0; j < numberOfClasses; ++j)
+  {
+    membershipFunctions.push_back(itk::Statistics::GaussianMembershipFunction<MeasurementVectorType>::New());
+    itk::Statistics::GaussianMembershipFunction<MeasurementVectorType>::MeanVectorType mean;
+    itk::Statistics::GaussianMembershipFunction<MeasurementVectorType>::CovarianceMatrixType covariance;
+    covariance.SetSize(measurementVectorSize, measurementVectorSize);
+    for (unsigned int d = 0; d < measurementVectorSize; ++d)
+    {
+      mean[d] = initialParameters[j][d];
+      for (unsigned int e = 0; e < measurementVectorSize; ++e)
+      {
+        covariance(d, e) = initialParameters[j][measurementVectorSize + d * measurementVectorSize + e];
+      }
+    }
+    membershipFunctions[j]->SetMean(mean);
+    membershipFunctions[j]->SetCovariance(covariance);
+  }
+  for (unsigned int i = 0; i < sample->Size(); ++i)
+  {
+    double densities[numberOfClasses];
+    double densitySum = 0.0;
+    for (unsigned int j = 0; j < numberOfClasses; ++j)
+    {
+      densities[j] = initialProportions[j] * membershipFunctions[j]->Evaluate(sample->GetMeasurementVector(i));
+      densitySum += densities[j];
+    }
+    for (unsigned int j = 0; j < numberOfClasses; ++j)
+    {
+      const double expected =
+        densitySum > itk::NumericTraits<double>::epsilon() ? densities[j] / densitySum : densities[j];
+      const double weight = components[j]->GetWeight(i);
+      if (itk::Math::abs(weight - expected) > 1e-9 * itk::Math::abs(expected) + 1e-300)
+      {
+        std::cerr << "Test failed!" << std::endl;
+        std::cerr << "Error in the membership of the measurement vector " << i << " in the component " << j
+                  << std::endl;
+        std::cerr << "Expected " << expected << ", but got " << weight << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  // The parameters are the weighted mean and covariance of the memberships.
+  for (unsigned int j = 0; j < numberOfClasses; ++j)
+  {
+    using CovarianceFilterType = itk::Statistics::WeightedCovarianceSampleFilter<SampleType>;
+    auto covarianceFilter = CovarianceFilterType::New();
+    covarianceFilter->SetInput(sample);
+    covarianceFilter->SetWeights(components[j]->GetWeights());
+    ITK_TRY_EXPECT_NO_EXCEPTION(covarianceFilter->Update());
+
+    const ParametersType parameters = components[j]->GetFullParameters();
+    for (unsigned int d = 0; d < measurementVectorSize; ++d)
+    {
+      const double expectedMean = covarianceFilter->GetMean()[d];
+      if (itk::Math::abs(parameters[d] - expectedMean) > 1e-4)
+      {
+        std::cerr << "Test failed!" << std::endl;
+        std::cerr << "Error in the mean " << d << " of the component " << j << std::endl;
+        std::cerr << "Expected " << expectedMean << ", but got " << parameters[d] << std::endl;
+        return EXIT_FAILURE;
+      }
+      for (unsigned int e = 0; e < measurementVectorSize; ++e)
+      {
+        const double expectedCovariance = covarianceFilter->GetCovarianceMatrix()(d, e);
+        const double covariance = parameters[measurementVectorSize + d * measurementVectorSize + e];
+        if (itk::Math::abs(covariance - expectedCovariance) > 1e-9 * itk::Math::abs(expectedCovariance) + 1e-9)
+        {
+          std::cerr << "Test failed!" << std::endl;
+          std::cerr << "Error in the covariance (" << d << ", " << e << ") of the component " << j << std::endl;
+          std::cerr << "Expected " << expectedCovariance << ", but got " << covariance << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  // The estimates do not depend on the number of work units, and are close
+  // to the true means and proportions.
+  std::vector<ParametersType>         firstParameters;
+  EstimatorType::ProportionVectorType firstProportions;
+  for (const itk::ThreadIdType numberOfWorkUnits : { 1, 8 })
+  {
+    initialize(numberOfWorkUnits, 100);
+    ITK_TRY_EXPECT_NO_EXCEPTION(estimator->Update());
+
+    if (firstParameters.empty())
+    {
+      for (unsigned int j = 0; j < numberOfClasses; ++j)
+      {
+        firstParameters.push_back(components[j]->GetFullParameters());
+      }
+      firstProportions = estimator->GetProportions();
+      std::cout << "Proportions: " << firstProportions << " after " << estimator->GetCurrentIteration()
+                << " iterations" << std::endl;
+    }
+    for (unsigned int j = 0; j < numberOfClasses; ++j)
+    {
+      const ParametersType parameters = components[j]->GetFullParameters();
+      std::cout << "Parameters of the component " << j << ": " << parameters << std::endl;
+      if (parameters != firstParameters[j] || estimator->GetProportions()[j] != firstProportions[j])
+      {
+        std::cerr << "Test failed!" << std::endl;
+        std::cerr << "Error in the estimates of the component " << j << " with " << numberOfWorkUnits
+                  << " work units" << std::endl;
+        return EXIT_FAILURE;
+      }
+      for (unsigned int d = 0; d < measurementVectorSize; ++d)
+      {
+        if (itk::Math::abs(parameters[d] - trueMeans[j][d]) > 1.0)
+        {
+          std::cerr << "Test failed!" << std::endl;
+          std::cerr << "Error in the mean " << d << " of the component " << j << std::endl;
+          std::cerr << "Expected " << trueMeans[j][d] << ", but got " << parameters[d] << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+      ITK_TEST_EXPECT_TRUE(itk::Math::abs(firstProportions[j] - 1.0 / numberOfClasses) < 0.01);
+    }
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,205 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFlatKdTree.h"
+#include "itkListSample.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkMath.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+#include <cmath>
+
+/* Compare the searches of a FlatKdTree with exhaustive searches, for random
+ * measurement vectors including duplicates. */
+int
+itkFlatKdTreeTest(int, char *[])
+{
+  using MeasurementVectorType = itk::Array<float>;
+  using SampleType = itk::Statistics::ListSample<MeasurementVectorType>;
+  using TreeType = itk::Statistics::FlatKdTree<SampleType>;
+
+  constexpr unsigned int measurementVectorSize = 3;
+  constexpr unsigned int numberOfVectors = 1000;
+  constexpr unsigned int numberOfQueries = 200;
+
+  using NumberGeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  const NumberGeneratorType::Pointer randomNumberGenerator = NumberGeneratorType::GetInstance();
+  randomNumberGenerator->Initialize(20250101);
+
+  auto sample = SampleType::New();
+  sample->SetMeasurementVectorSize(measurementVectorSize);
+  MeasurementVectorType measurementVector(measurementVectorSize);
+  for (unsigned int i = 0; i < numberOfVectors; ++i)
+  {
+    if (i % 10 == 9)
+    {
+      // Duplicate of a previous measurement vector.
+      measurementVector = sample->GetMeasurementVector(i - 5);
+    }
+    else
+    {
+      for (unsigned int d = 0; d < measurementVectorSize; ++d)
+      {
+        measurementVector[d] = static_cast<float>(randomNumberGenerator->GetNormalVariate(0.0, (d + 1) * 10.0));
+      }
+    }
+    sample->PushBack(measurementVector);
+  }
+
+  TreeType::MeasurementVectorContainerType queries;
+  for (unsigned int i = 0; i < numberOfQueries; ++i)
+  {
+    for (unsigned int d = 0; d < measurementVectorSize; ++d)
+    {
+      measurementVector[d] = static_cast<float>(randomNumberGenerator->GetUniformVariate(-40.0, 40.0));
+    }
+    queries.push_back(measurementVector);
+  }
+
+  auto tree = TreeType::New();
+
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(tree, FlatKdTree, Object);
+
+  ITK_TRY_EXPECT_EXCEPTION(tree->Build());
+
+  tree->SetSample(sample);
+  ITK_TEST_SET_GET_VALUE(sample.GetPointer(), tree->GetSample());
+  constexpr unsigned int bucketSize = 5;
+  tree->SetBucketSize(bucketSize);
+  ITK_TEST_SET_GET_VALUE(bucketSize, tree->GetBucketSize());
+  constexpr itk::ThreadIdType numberOfWorkUnits = 8;
+  tree->SetNumberOfWorkUnits(numberOfWorkUnits);
+  ITK_TEST_SET_GET_VALUE(numberOfWorkUnits, tree->GetNumberOfWorkUnits());
+
+  ITK_TRY_EXPECT_NO_EXCEPTION(tree->Build());
+  ITK_TEST_EXPECT_EQUAL(tree->Size(), numberOfVectors);
+  ITK_TEST_EXPECT_EQUAL(tree->GetMeasurementVectorSize(), measurementVectorSize);
+  // 1000 -> 500 -> 250 -> 125 -> 63 -> 32 -> 16 -> 8 -> 4
+  ITK_TEST_EXPECT_EQUAL(tree->GetNumberOfLevels(), 8);
+
+  auto computeDistance = [&sample](const MeasurementVectorType & query, TreeType::InstanceIdentifier id) {
+    const MeasurementVectorType & vector = sample->GetMeasurementVector(id);
+    double                        squaredDistance = 0.0;
+    for (unsigned int d = 0; d < measurementVectorSize; ++d)
+    {
+      const double difference = static_cast<double>(vector[d]) - static_cast<double>(query[d]);
+      squaredDistance += difference * difference;
+    }
+    return std::sqrt(squaredDistance);
+  };
+
+  constexpr double tolerance = 1e-9;
+
+  for (const unsigned int k : { 1u, 7u, numberOfVectors })
+  {
+    TreeType::InstanceIdentifierVectorType batchResults;
+    TreeType::DistanceVectorType           batchDistances;
+    tree->BatchSearch(queries, k, batchResults, batchDistances);
+    ITK_TEST_EXPECT_EQUAL(batchResults.size(), numberOfQueries * k);
+
+    for (unsigned int q = 0; q < numberOfQueries; ++q)
+    {
+      std::vector<double> expectedDistances;
+      for (TreeType::InstanceIdentifier id = 0; id < numberOfVectors; ++id)
+      {
+        expectedDistances.push_back(computeDistance(queries[q], id));
+      }
+      std::sort(expectedDistances.begin(), expectedDistances.end());
+
+      TreeType::InstanceIdentifierVectorType result;
+      TreeType::DistanceVectorType           distances;
+      tree->Search(queries[q], k, result, distances);
+      ITK_TEST_EXPECT_EQUAL(result.size(), k);
+
+      for (unsigned int i = 0; i < k; ++i)
+      {
+        if (!itk::Math::FloatAlmostEqual(distances[i], expectedDistances[i], 4, tolerance) ||
+            !itk::Math::FloatAlmostEqual(distances[i], computeDistance(queries[q], result[i]), 4, tolerance) ||
+            result[i] != batchResults[q * k + i] || distances[i] != batchDistances[q * k + i])
+        {
+          std::cerr << "Test failed!" << std::endl;
+          std::cerr << "Error in neighbor " << i << " of " << k << " of the query " << queries[q] << std::endl;
+          std::cerr << "Expected distance " << expectedDistances[i] << ", but got " << distances[i] << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  TreeType::InstanceIdentifierVectorType result;
+  ITK_TRY_EXPECT_EXCEPTION(tree->Search(queries[0], numberOfVectors + 1, result));
+
+  // A query equal to a duplicated measurement vector finds both copies.
+  tree->Search(sample->GetMeasurementVector(9), 2u, result);
+  ITK_TEST_EXPECT_EQUAL(result.size(), 2);
+  ITK_TEST_EXPECT_EQUAL(std::min(result[0], result[1]), 4);
+  ITK_TEST_EXPECT_EQUAL(std::max(result[0], result[1]), 9);
+
+  constexpr double                                    radius = 6.0;
+  std::vector<TreeType::InstanceIdentifierVectorType> batchResults;
+  tree->BatchSearch(queries, radius, batchResults);
+  ITK_TEST_EXPECT_EQUAL(batchResults.size(), numberOfQueries);
+  for (unsigned int q = 0; q < numberOfQueries; ++q)
+  {
+    TreeType::InstanceIdentifierVectorType expected;
+    for (TreeType::InstanceIdentifier id = 0; id < numberOfVectors; ++id)
+    {
+      if (computeDistance(queries[q], id) <= radius)
+      {
+        expected.push_back(id);
+      }
+    }
+
+    tree->Search(queries[q], radius, result);
+    std::sort(result.begin(), result.end());
+    std::sort(batchResults[q].begin(), batchResults[q].end());
+    if (result != expected || batchResults[q] != expected)
+    {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Error in the radius search of the query " << queries[q] << std::endl;
+      std::cerr << "Expected " << expected.size() << " measurement vectors, but got " << result.size() << " and "
+                << batchResults[q].size() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // A tree with a single terminal node, built serially.
+  tree->SetBucketSize(numberOfVectors);
+  tree->SetNumberOfWorkUnits(1);
+  tree->Build();
+  ITK_TEST_EXPECT_EQUAL(tree->GetNumberOfLevels(), 0);
+  TreeType::DistanceVectorType distances;
+  tree->Search(queries[0], 3u, result, distances);
+  ITK_TEST_EXPECT_EQUAL(result.size(), 3);
+  ITK_TEST_EXPECT_TRUE(distances[0] <= distances[1] && distances[1] <= distances[2]);
+
+  // An empty sample.
+  auto emptySample = SampleType::New();
+  emptySample->SetMeasurementVectorSize(measurementVectorSize);
+  tree->SetSample(emptySample);
+  tree->Build();
+  ITK_TEST_EXPECT_EQUAL(tree->Size(), 0);
+  tree->Search(queries[0], 0u, result);
+  ITK_TEST_EXPECT_TRUE(result.empty());
+  tree->Search(queries[0], radius, result);
+  ITK_TEST_EXPECT_TRUE(result.empty());
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,228 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageToHistogramFilter.h"
+#include "itkMaskedImageToHistogramFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkVectorImage.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+#include <limits>
+
+namespace
+{
+// Compare the frequencies of a histogram with the frequencies of its bins
+// found by Histogram::GetIndex() for each pixel of the image, or for each
+// pixel of the mask.
+template <typename THistogram, typename TImage, typename TMaskImage>
+bool
+CheckFrequencies(const THistogram * histogram, const TImage * image, const TMaskImage * mask, const char * name)
+{
+  std::vector<typename THistogram::AbsoluteFrequencyType> expectedFrequencies(histogram->Size(), 0);
+
+  typename THistogram::MeasurementVectorType measurement(histogram->GetMeasurementVectorSize());
+  typename THistogram::IndexType             index;
+  itk::ImageRegionConstIterator<TImage>      it(image, image->GetBufferedRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    if (mask != nullptr && mask->GetPixel(it.GetIndex()) == 0)
+    {
+      continue;
+    }
+    itk::NumericTraits<typename TImage::PixelType>::AssignToArray(it.Get(), measurement);
+    if (histogram->GetIndex(measurement, index))
+    {
+      ++expectedFrequencies[histogram->GetInstanceIdentifier(index)];
+    }
+  }
+
+  for (typename THistogram::InstanceIdentifier id = 0; id < histogram->Size(); ++id)
+  {
+    if (histogram->GetFrequency(id) != expectedFrequencies[id])
+    {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Error in the frequency of the bin " << id << " of the " << name << " histogram" << std::endl;
+      std::cerr << "Expected " << expectedFrequencies[id] << ", but got " << histogram->GetFrequency(id) << std::endl;
+      return false;
+    }
+  }
+  std::cout << "The " << name << " histogram has a total frequency of " << histogram->GetTotalFrequency() << std::endl;
+  return true;
+}
+} // namespace
+
+/* Compare the histograms of scalar and vector images, computed with several
+ * work units and stream divisions, with the bins of their pixels found by
+ * Histogram::GetIndex(). */
+int
+itkImageToHistogramFilterTest3(int, char *[])
+{
+  constexpr unsigned int Dimension = 2;
+  using ScalarImageType = itk::Image<float, Dimension>;
+  using VectorImageType = itk::VectorImage<float, Dimension>;
+  using MaskImageType = itk::Image<unsigned char, Dimension>;
+
+  using NumberGeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  const NumberGeneratorType::Pointer randomNumberGenerator = NumberGeneratorType::GetInstance();
+  randomNumberGenerator->Initialize(20250301);
+
+  const ScalarImageType::RegionType region({ 0, 0 }, { 173, 151 });
+
+  // Random values, partly outside of the bins, and some values on the bin
+  // bounds, or not a number.
+  auto scalarImage = ScalarImageType::New();
+  scalarImage->SetRegions(region);
+  scalarImage->Allocate();
+  for (itk::ImageRegionIterator<ScalarImageType> it(scalarImage, region); !it.IsAtEnd(); ++it)
+  {
+    const unsigned int choice = randomNumberGenerator->GetIntegerVariate(19);
+    if (choice == 0)
+    {
+      it.Set(std::numeric_limits<float>::quiet_NaN());
+    }
+    else if (choice < 4)
+    {
+      it.Set(static_cast<float>(100.0 / 37.0 * randomNumberGenerator->GetIntegerVariate(37)));
+    }
+    else
+    {
+      it.Set(static_cast<float>(randomNumberGenerator->GetUniformVariate(-10.0, 110.0)));
+    }
+  }
+
+  constexpr unsigned int numberOfComponents = 3;
+  auto                   vectorImage = VectorImageType::New();
+  vectorImage->SetRegions(region);
+  vectorImage->SetNumberOfComponentsPerPixel(numberOfComponents);
+  vectorImage->Allocate();
+  VectorImageType::PixelType pixel(numberOfComponents);
+  for (itk::ImageRegionIterator<VectorImageType> it(vectorImage, region); !it.IsAtEnd(); ++it)
+  {
+    for (unsigned int i = 0; i < numberOfComponents; ++i)
+    {
+      pixel[i] = static_cast<float>(randomNumberGenerator->GetNormalVariate(50.0 * i, 400.0));
+    }
+    it.Set(pixel);
+  }
+
+  auto mask = MaskImageType::New();
+  mask->SetRegions(region);
+  mask->Allocate();
+  for (itk::ImageRegionIterator<MaskImageType> it(mask, region); !it.IsAtEnd(); ++it)
+  {
+    it.Set(randomNumberGenerator->GetIntegerVariate(2) == 0 ? 0 : 1);
+  }
+
+  const MaskImageType * noMask = nullptr;
+
+  for (const itk::ThreadIdType numberOfWorkUnits : { 1, 8 })
+  {
+    std::cout << "Number of work units: " << numberOfWorkUnits << std::endl;
+
+    // Scalar image.
+    using ScalarHistogramFilterType = itk::Statistics::ImageToHistogramFilter<ScalarImageType>;
+    auto scalarHistogramFilter = ScalarHistogramFilterType::New();
+    scalarHistogramFilter->SetInput(scalarImage);
+    scalarHistogramFilter->SetNumberOfWorkUnits(numberOfWorkUnits);
+    scalarHistogramFilter->SetNumberOfStreamDivisions(3);
+    scalarHistogramFilter->SetAutoMinimumMaximum(false);
+    ScalarHistogramFilterType::HistogramSizeType scalarSize(1);
+    scalarSize.Fill(37);
+    scalarHistogramFilter->SetHistogramSize(scalarSize);
+    ScalarHistogramFilterType::HistogramMeasurementVectorType scalarMinimum(1);
+    ScalarHistogramFilterType::HistogramMeasurementVectorType scalarMaximum(1);
+    scalarMinimum.Fill(0.0);
+    scalarMaximum.Fill(100.0);
+    scalarHistogramFilter->SetHistogramBinMinimum(scalarMinimum);
+    scalarHistogramFilter->SetHistogramBinMaximum(scalarMaximum);
+    ITK_TRY_EXPECT_NO_EXCEPTION(scalarHistogramFilter->Update());
+    if (!CheckFrequencies(scalarHistogramFilter->GetOutput(), scalarImage.GetPointer(), noMask, "scalar"))
+    {
+      return EXIT_FAILURE;
+    }
+
+    // The default bins of a double image, whose bounds are not finite.
+    using DoubleImageType = itk::Image<double, Dimension>;
+    auto doubleImage = DoubleImageType::New();
+    doubleImage->SetRegions(region);
+    doubleImage->Allocate();
+    doubleImage->FillBuffer(3.0);
+    using DoubleHistogramFilterType = itk::Statistics::ImageToHistogramFilter<DoubleImageType>;
+    auto doubleHistogramFilter = DoubleHistogramFilterType::New();
+    doubleHistogramFilter->SetInput(doubleImage);
+    doubleHistogramFilter->SetNumberOfWorkUnits(numberOfWorkUnits);
+    doubleHistogramFilter->SetAutoMinimumMaximum(false);
+    ITK_TRY_EXPECT_NO_EXCEPTION(doubleHistogramFilter->Update());
+    if (!CheckFrequencies(doubleHistogramFilter->GetOutput(), doubleImage.GetPointer(), noMask, "double"))
+    {
+      return EXIT_FAILURE;
+    }
+
+    // Joint histogram of three components, whose frequencies are sparse.
+    using VectorHistogramFilterType = itk::Statistics::ImageToHistogramFilter<VectorImageType>;
+    auto vectorHistogramFilter = VectorHistogramFilterType::New();
+    vectorHistogramFilter->SetInput(vectorImage);
+    vectorHistogramFilter->SetNumberOfWorkUnits(numberOfWorkUnits);
+    VectorHistogramFilterType::HistogramSizeType vectorSize(numberOfComponents);
+    vectorSize[0] = 64;
+    vectorSize[1] = 50;
+    vectorSize[2] = 70;
+    vectorHistogramFilter->SetHistogramSize(vectorSize);
+    vectorHistogramFilter->SetAutoMinimumMaximum(true);
+    ITK_TRY_EXPECT_NO_EXCEPTION(vectorHistogramFilter->Update());
+    if (!CheckFrequencies(vectorHistogramFilter->GetOutput(), vectorImage.GetPointer(), noMask, "vector"))
+    {
+      return EXIT_FAILURE;
+    }
+    ITK_TEST_EXPECT_EQUAL(vectorHistogramFilter->GetOutput()->GetTotalFrequency(), region.GetNumberOfPixels());
+
+    // The bins are clipped at the ends of all the components.
+    VectorHistogramFilterType::HistogramMeasurementVectorType vectorMinimum(numberOfComponents);
+    VectorHistogramFilterType::HistogramMeasurementVectorType vectorMaximum(numberOfComponents);
+    vectorMinimum.Fill(0.0);
+    vectorMaximum.Fill(80.0);
+    vectorHistogramFilter->SetAutoMinimumMaximum(false);
+    vectorHistogramFilter->SetHistogramBinMinimum(vectorMinimum);
+    vectorHistogramFilter->SetHistogramBinMaximum(vectorMaximum);
+    vectorHistogramFilter->SetNumberOfStreamDivisions(4);
+    ITK_TRY_EXPECT_NO_EXCEPTION(vectorHistogramFilter->Update());
+    if (!CheckFrequencies(
+          vectorHistogramFilter->GetOutput(), vectorImage.GetPointer(), noMask, "clipped vector"))
+    {
+      return EXIT_FAILURE;
+    }
+
+    using MaskedHistogramFilterType = itk::Statistics::MaskedImageToHistogramFilter<VectorImageType, MaskImageType>;
+    auto maskedHistogramFilter = MaskedHistogramFilterType::New();
+    maskedHistogramFilter->SetInput(vectorImage);
+    maskedHistogramFilter->SetMaskImage(mask);
+    maskedHistogramFilter->SetMaskValue(1);
+    maskedHistogramFilter->SetNumberOfWorkUnits(numberOfWorkUnits);
+    maskedHistogramFilter->SetHistogramSize(vectorSize);
+    maskedHistogramFilter->SetAutoMinimumMaximum(true);
+    ITK_TRY_EXPECT_NO_EXCEPTION(maskedHistogramFilter->Update());
+    if (!CheckFrequencies(maskedHistogramFilter->GetOutput(), vectorImage.GetPointer(), mask.GetPointer(), "masked"))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,226 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkParallelKmeansEstimator.h"
+#include "itkListSample.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkMath.h"
+#include "itkTestingMacros.h"
+
+/* Cluster a sample of three Gaussian clusters, and compare the means with the
+ * ones of exhaustive Lloyd iterations. */
+int
+itkParallelKmeansEstimatorTest(int, char *[])
+{
+  constexpr unsigned int measurementVectorSize = 3;
+  constexpr unsigned int numberOfClasses = 3;
+  constexpr unsigned int numberOfMeasurementVectors = 6000;
+
+  using MeasurementVectorType = itk::Vector<float, measurementVectorSize>;
+  using SampleType = itk::Statistics::ListSample<MeasurementVectorType>;
+  using EstimatorType = itk::Statistics::ParallelKmeansEstimator<SampleType>;
+
+  const double trueMeans[numberOfClasses][measurementVectorSize] = { { 10.0, 10.0, 10.0 },
+                                                                     { 50.0, 20.0, 10.0 },
+                                                                     { 20.0, 60.0, 40.0 } };
+
+  using NumberGeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  const NumberGeneratorType::Pointer randomNumberGenerator = NumberGeneratorType::GetInstance();
+  randomNumberGenerator->Initialize(20250201);
+
+  auto sample = SampleType::New();
+  sample->SetMeasurementVectorSize(measurementVectorSize);
+  for (unsigned int i = 0; i < numberOfMeasurementVectors; ++i)
+  {
+    MeasurementVectorType measurementVector;
+    for (unsigned int d = 0; d < measurementVectorSize; ++d)
+    {
+      measurementVector[d] =
+        static_cast<float>(randomNumberGenerator->GetNormalVariate(trueMeans[i % numberOfClasses][d], 225.0));
+    }
+    sample->PushBack(measurementVector);
+  }
+
+  EstimatorType::ParametersType initialMeans(numberOfClasses * measurementVectorSize);
+  for (unsigned int j = 0; j < numberOfClasses; ++j)
+  {
+    for (unsigned int d = 0; d < measurementVectorSize; ++d)
+    {
+      initialMeans[j * measurementVectorSize + d] = trueMeans[(j + 1) % numberOfClasses][d] * 0.5 + 5.0 * j;
+    }
+  }
+
+  // Reference means, computed by exhaustive Lloyd iterations.
+  std::vector<double> expectedMeans(initialMeans.begin(), initialMeans.end());
+  for (bool changed = true; changed;)
+  {
+    std::vector<double>       sums(expectedMeans.size(), 0.0);
+    std::vector<unsigned int> counts(numberOfClasses, 0);
+    for (unsigned int i = 0; i < numberOfMeasurementVectors; ++i)
+    {
+      const MeasurementVectorType & measurementVector = sample->GetMeasurementVector(i);
+      unsigned int                  closest = 0;
+      double                        closestSquaredDistance = itk::NumericTraits<double>::max();
+      for (unsigned int j = 0; j < numberOfClasses; ++j)
+      {
+        double squaredDistance = 0.0;
+        for (unsigned int d = 0; d < measurementVectorSize; ++d)
+        {
+          squaredDistance += itk::Math::sqr(measurementVector[d] - expectedMeans[j * measurementVectorSize + d]);
+        }
+        if (squaredDistance < closestSquaredDistance)
+        {
+          closest = j;
+          closestSquaredDistance = squaredDistance;
+        }
+      }
+      ++counts[closest];
+      for (unsigned int d = 0; d < measurementVectorSize; ++d)
+      {
+        sums[closest * measurementVectorSize + d] += measurementVector[d];
+      }
+    }
+    changed = false;
+    for (unsigned int i = 0; i < expectedMeans.size(); ++i)
+    {
+      const double mean = sums[i] / counts[i / measurementVectorSize];
+      changed = changed || mean != expectedMeans[i];
+      expectedMeans[i] = mean;
+    }
+  }
+
+  auto estimator = EstimatorType::New();
+
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(estimator, ParallelKmeansEstimator, Object);
+
+  ITK_TRY_EXPECT_EXCEPTION(estimator->StartOptimization());
+
+  estimator->SetSample(sample);
+  ITK_TEST_SET_GET_VALUE(sample.GetPointer(), estimator->GetSample());
+  estimator->SetMaximumIteration(200);
+  ITK_TEST_SET_GET_VALUE(200, estimator->GetMaximumIteration());
+  estimator->SetCentroidPositionChangesThreshold(0.0);
+  ITK_TEST_SET_GET_VALUE(0.0, estimator->GetCentroidPositionChangesThreshold());
+  ITK_TEST_SET_GET_BOOLEAN(estimator, UseDistanceBounds, true);
+  ITK_TEST_SET_GET_BOOLEAN(estimator, UseClusterLabels, true);
+
+  // The parameters are not a multiple of the measurement vector size.
+  estimator->SetParameters(EstimatorType::ParametersType(4));
+  ITK_TRY_EXPECT_EXCEPTION(estimator->StartOptimization());
+
+  // The means do not depend on the number of work units, nor on the use of
+  // the distance bounds, and are the ones of the exhaustive iterations.
+  EstimatorType::ParametersType firstMeans;
+  for (const itk::ThreadIdType numberOfWorkUnits : { 1, 8 })
+  {
+    for (const bool useDistanceBounds : { true, false })
+    {
+      estimator->SetParameters(initialMeans);
+      estimator->SetNumberOfWorkUnits(numberOfWorkUnits);
+      estimator->SetUseDistanceBounds(useDistanceBounds);
+      ITK_TRY_EXPECT_NO_EXCEPTION(estimator->StartOptimization());
+
+      const EstimatorType::ParametersType means = estimator->GetParameters();
+      if (firstMeans.empty())
+      {
+        firstMeans = means;
+      }
+      for (unsigned int i = 0; i < means.size(); ++i)
+      {
+        if (means[i] != firstMeans[i] || itk::Math::abs(means[i] - expectedMeans[i]) > 1e-6)
+        {
+          std::cerr << "Test failed!" << std::endl;
+          std::cerr << "Error with " << numberOfWorkUnits << " work units and useDistanceBounds "
+                    << useDistanceBounds << std::endl;
+          std::cerr << "Expected means " << EstimatorType::ParametersType(expectedMeans.data(), expectedMeans.size())
+                    << ", but got " << means << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+  std::cout << "Means: " << firstMeans << " after " << estimator->GetCurrentIteration() << " iterations"
+            << std::endl;
+
+  // The labels are the closest means.
+  const EstimatorType::ClusterLabelsType & labels = estimator->GetClusterLabels();
+  ITK_TEST_EXPECT_EQUAL(labels.size(), numberOfMeasurementVectors);
+  const EstimatorType::MembershipFunctionVectorType & membershipFunctions = estimator->GetOutput()->Get();
+  ITK_TEST_EXPECT_EQUAL(membershipFunctions.size(), numberOfClasses);
+  for (unsigned int i = 0; i < numberOfMeasurementVectors; ++i)
+  {
+    const MeasurementVectorType & measurementVector = sample->GetMeasurementVector(i);
+    unsigned int                  closest = 0;
+    for (unsigned int j = 1; j < numberOfClasses; ++j)
+    {
+      if (membershipFunctions[j]->Evaluate(measurementVector) <
+          membershipFunctions[closest]->Evaluate(measurementVector))
+      {
+        closest = j;
+      }
+    }
+    if (labels[i] != closest)
+    {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Error in the label of the measurement vector " << i << std::endl;
+      std::cerr << "Expected " << closest << ", but got " << labels[i] << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // The mini-batch means are close to the means, and do not depend on the
+  // number of work units.
+  constexpr itk::SizeValueType miniBatchSize = 500;
+  estimator->SetMiniBatchSize(miniBatchSize);
+  ITK_TEST_SET_GET_VALUE(miniBatchSize, estimator->GetMiniBatchSize());
+  estimator->SetSeed(7);
+  ITK_TEST_SET_GET_VALUE(7, estimator->GetSeed());
+  estimator->SetMaximumIteration(100);
+  estimator->UseClusterLabelsOff();
+
+  EstimatorType::ParametersType firstMiniBatchMeans;
+  for (const itk::ThreadIdType numberOfWorkUnits : { 1, 8 })
+  {
+    estimator->SetParameters(initialMeans);
+    estimator->SetNumberOfWorkUnits(numberOfWorkUnits);
+    ITK_TRY_EXPECT_NO_EXCEPTION(estimator->StartOptimization());
+    ITK_TEST_EXPECT_TRUE(estimator->GetClusterLabels().empty());
+
+    const EstimatorType::ParametersType means = estimator->GetParameters();
+    if (firstMiniBatchMeans.empty())
+    {
+      firstMiniBatchMeans = means;
+    }
+    for (unsigned int i = 0; i < means.size(); ++i)
+    {
+      if (means[i] != firstMiniBatchMeans[i] || itk::Math::abs(means[i] - expectedMeans[i]) > 1.5)
+      {
+        std::cerr << "Test failed!" << std::endl;
+        std::cerr << "Error in the mini-batch means with " << numberOfWorkUnits << " work units" << std::endl;
+        std::cerr << "Expected means close to "
+                  << EstimatorType::ParametersType(expectedMeans.data(), expectedMeans.size()) << ", but got " << means
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  std::cout << "Mini-batch means: " << firstMiniBatchMeans << std::endl;
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,315 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkScalarImageToTextureFeaturesImageFilter.h"
+#include "itkScalarImageToCooccurrenceMatrixFilter.h"
+#include "itkScalarImageToRunLengthMatrixFilter.h"
+#include "itkHistogramToTextureFeaturesFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkMath.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using NumberGeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+
+// Random image whose values are mostly close to the ones of the previous
+// pixel, so that the co-occurrence matrices are not uniform.
+template <typename TImage>
+typename TImage::Pointer
+CreateRandomImage(const typename TImage::RegionType & region, NumberGeneratorType * randomNumberGenerator)
+{
+  auto image = TImage::New();
+  image->SetRegions(region);
+  image->Allocate();
+  int value = 128;
+  for (itk::ImageRegionIterator<TImage> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    value = (value + static_cast<int>(randomNumberGenerator->GetIntegerVariate(80)) - 40 + 256) % 256;
+    it.Set(static_cast<typename TImage::PixelType>(value));
+  }
+  return image;
+}
+
+// Copy of a region of an image, as a new image.
+template <typename TImage>
+typename TImage::Pointer
+CopyRegion(const TImage * image, const typename TImage::RegionType & region)
+{
+  auto copy = TImage::New();
+  copy->SetRegions(region);
+  copy->Allocate();
+  itk::ImageRegionConstIterator<TImage> inputIt(image, region);
+  itk::ImageRegionIterator<TImage>      copyIt(copy, region);
+  for (; !inputIt.IsAtEnd(); ++inputIt, ++copyIt)
+  {
+    copyIt.Set(inputIt.Get());
+  }
+  return copy;
+}
+
+// Compare the features of each pixel of the output region with the features
+// of the co-occurrence matrix of its neighborhood.
+template <typename TFilter>
+bool
+CheckFeatures(TFilter * filter, const typename TFilter::OutputImageType::RegionType & outputRegion)
+{
+  using InputImageType = typename TFilter::InputImageType;
+  using MatrixFilterType = itk::Statistics::ScalarImageToCooccurrenceMatrixFilter<InputImageType>;
+  using FeaturesFilterType =
+    itk::Statistics::HistogramToTextureFeaturesFilter<typename MatrixFilterType::HistogramType>;
+  using TextureFeatureEnum = itk::Statistics::HistogramToTextureFeaturesFilterEnums::TextureFeature;
+
+  const InputImageType *                      input = filter->GetInput();
+  const typename TFilter::MaskImageType *     mask = filter->GetMaskImage();
+  const typename TFilter::OutputImageType *   output = filter->GetOutput();
+  const typename InputImageType::RegionType & largestRegion = input->GetLargestPossibleRegion();
+
+  auto matrixFilter = MatrixFilterType::New();
+  matrixFilter->SetOffsets(filter->GetOffsets());
+  matrixFilter->SetNumberOfBinsPerAxis(filter->GetNumberOfBinsPerAxis());
+  matrixFilter->SetPixelValueMinMax(filter->GetMin(), filter->GetMax());
+  auto featuresFilter = FeaturesFilterType::New();
+  featuresFilter->SetInput(matrixFilter->GetOutput());
+
+  for (itk::ImageRegionConstIteratorWithIndex<typename TFilter::OutputImageType> it(output, outputRegion);
+       !it.IsAtEnd();
+       ++it)
+  {
+    auto                                size = itk::MakeFilled<typename InputImageType::SizeType>(1);
+    typename InputImageType::RegionType neighborhood(it.GetIndex(), size);
+    neighborhood.PadByRadius(filter->GetNeighborhoodRadius());
+    neighborhood.Crop(largestRegion);
+
+    matrixFilter->SetInput(CopyRegion(input, neighborhood));
+    if (mask != nullptr)
+    {
+      matrixFilter->SetMaskImage(CopyRegion(mask, neighborhood));
+    }
+    featuresFilter->Update();
+
+    for (unsigned int k = 0; k < TFilter::NumberOfFeatures; ++k)
+    {
+      const double expected = featuresFilter->GetFeature(static_cast<TextureFeatureEnum>(k));
+      const double actual = it.Get()[k];
+      if (itk::Math::abs(expected - actual) > 1e-4 * (1.0 + itk::Math::abs(expected)))
+      {
+        std::cerr << "Test failed!" << std::endl;
+        std::cerr << "Error in the feature " << k << " of the pixel " << it.GetIndex() << std::endl;
+        std::cerr << "Expected " << expected << ", but got " << actual << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// The matrices of ScalarImageToCooccurrenceMatrixFilter and
+// ScalarImageToRunLengthMatrixFilter do not depend on the number of work
+// units.
+template <typename TMatrixFilter>
+bool
+CheckWorkUnits(TMatrixFilter * matrixFilter, const char * name)
+{
+  using HistogramType = typename TMatrixFilter::HistogramType;
+
+  matrixFilter->SetNumberOfWorkUnits(1);
+  matrixFilter->Update();
+  std::vector<typename HistogramType::AbsoluteFrequencyType> expectedFrequencies;
+  for (typename HistogramType::InstanceIdentifier id = 0; id < matrixFilter->GetOutput()->Size(); ++id)
+  {
+    expectedFrequencies.push_back(matrixFilter->GetOutput()->GetFrequency(id));
+  }
+
+  matrixFilter->SetNumberOfWorkUnits(8);
+  matrixFilter->Update();
+  const HistogramType * actual = matrixFilter->GetOutput();
+
+  if (actual->Size() != expectedFrequencies.size() || actual->GetTotalFrequency() == 0)
+  {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "Error in the size or the total frequency of the " << name << " matrix" << std::endl;
+    return false;
+  }
+  for (typename HistogramType::InstanceIdentifier id = 0; id < actual->Size(); ++id)
+  {
+    if (actual->GetFrequency(id) != expectedFrequencies[id])
+    {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Error in the frequency of the bin " << id << " of the " << name << " matrix" << std::endl;
+      std::cerr << "Expected " << expectedFrequencies[id] << ", but got " << actual->GetFrequency(id) << std::endl;
+      return false;
+    }
+  }
+  std::cout << "The " << name << " matrix has a total frequency of " << actual->GetTotalFrequency() << std::endl;
+  return true;
+}
+} // namespace
+
+/* Compare the texture features of the neighborhoods of the pixels of 2-D and
+ * 3-D images, with and without a mask, with the features of their
+ * co-occurrence matrices. */
+int
+itkScalarImageToTextureFeaturesImageFilterTest(int, char *[])
+{
+  using ImageType2D = itk::Image<unsigned char, 2>;
+  using ImageType3D = itk::Image<unsigned char, 3>;
+  using FilterType2D = itk::Statistics::ScalarImageToTextureFeaturesImageFilter<ImageType2D>;
+  using FilterType3D = itk::Statistics::ScalarImageToTextureFeaturesImageFilter<ImageType3D>;
+
+  const NumberGeneratorType::Pointer randomNumberGenerator = NumberGeneratorType::GetInstance();
+  randomNumberGenerator->Initialize(20250315);
+
+  const ImageType2D::RegionType region2D({ 3, -2 }, { 37, 29 });
+  const ImageType2D::Pointer    image2D = CreateRandomImage<ImageType2D>(region2D, randomNumberGenerator);
+
+  auto mask2D = ImageType2D::New();
+  mask2D->SetRegions(region2D);
+  mask2D->Allocate();
+  for (itk::ImageRegionIterator<ImageType2D> it(mask2D, region2D); !it.IsAtEnd(); ++it)
+  {
+    it.Set(randomNumberGenerator->GetIntegerVariate(3) == 0 ? 0 : 1);
+  }
+
+  auto filter2D = FilterType2D::New();
+
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(filter2D, ScalarImageToTextureFeaturesImageFilter, ImageToImageFilter);
+
+  ITK_TEST_EXPECT_EQUAL(filter2D->GetOffsets()->size(), 4);
+  ITK_TEST_EXPECT_EQUAL(filter2D->GetNumberOfBinsPerAxis(), FilterType2D::DefaultBinsPerAxis);
+
+  FilterType2D::RadiusType radius2D;
+  radius2D[0] = 2;
+  radius2D[1] = 3;
+  filter2D->SetNeighborhoodRadius(radius2D);
+  ITK_TEST_SET_GET_VALUE(radius2D, filter2D->GetNeighborhoodRadius());
+  filter2D->SetNumberOfBinsPerAxis(6);
+  ITK_TEST_SET_GET_VALUE(6, filter2D->GetNumberOfBinsPerAxis());
+  filter2D->SetPixelValueMinMax(20, 230);
+  ITK_TEST_SET_GET_VALUE(20, filter2D->GetMin());
+  ITK_TEST_SET_GET_VALUE(230, filter2D->GetMax());
+  filter2D->SetInsidePixelValue(1);
+  ITK_TEST_SET_GET_VALUE(1, filter2D->GetInsidePixelValue());
+  filter2D->SetInput(image2D);
+
+  for (const itk::ThreadIdType numberOfWorkUnits : { 1, 8 })
+  {
+    std::cout << "Number of work units: " << numberOfWorkUnits << std::endl;
+    filter2D->SetNumberOfWorkUnits(numberOfWorkUnits);
+
+    ITK_TRY_EXPECT_NO_EXCEPTION(filter2D->Update());
+    if (!CheckFeatures(filter2D.GetPointer(), region2D))
+    {
+      return EXIT_FAILURE;
+    }
+
+    filter2D->SetMaskImage(mask2D);
+    ITK_TEST_SET_GET_VALUE(mask2D.GetPointer(), filter2D->GetMaskImage());
+    ITK_TRY_EXPECT_NO_EXCEPTION(filter2D->Update());
+    if (!CheckFeatures(filter2D.GetPointer(), region2D))
+    {
+      return EXIT_FAILURE;
+    }
+    filter2D->SetMaskImage(nullptr);
+  }
+
+  // A single offset, and a requested region smaller than the image.
+  FilterType2D::OffsetType offset2D;
+  offset2D[0] = 2;
+  offset2D[1] = -1;
+  filter2D->SetOffset(offset2D);
+  ITK_TEST_EXPECT_EQUAL(filter2D->GetOffsets()->size(), 1);
+  const ImageType2D::RegionType requestedRegion2D({ 10, 5 }, { 12, 7 });
+  filter2D->GetOutput()->SetRequestedRegion(requestedRegion2D);
+  ITK_TRY_EXPECT_NO_EXCEPTION(filter2D->Update());
+  ITK_TEST_EXPECT_EQUAL(filter2D->GetInput()->GetRequestedRegion(), ImageType2D::RegionType({ 8, 2 }, { 16, 13 }));
+  if (!CheckFeatures(filter2D.GetPointer(), requestedRegion2D))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // No pixel value is in [min, max].
+  filter2D->SetPixelValueMinMax(0, 0);
+  image2D->FillBuffer(255);
+  image2D->Modified();
+  filter2D->GetOutput()->SetRequestedRegion(requestedRegion2D);
+  ITK_TRY_EXPECT_NO_EXCEPTION(filter2D->Update());
+  ITK_TEST_EXPECT_EQUAL(filter2D->GetOutput()->GetPixel({ 15, 7 }), FilterType2D::OutputPixelType{});
+
+  // 3-D image with the default offsets.
+  const ImageType3D::RegionType region3D({ 0, 0, 0 }, { 11, 9, 8 });
+  const ImageType3D::Pointer    image3D = CreateRandomImage<ImageType3D>(region3D, randomNumberGenerator);
+
+  auto filter3D = FilterType3D::New();
+  filter3D->SetInput(image3D);
+  filter3D->SetNeighborhoodRadius(FilterType3D::RadiusType{ { 1, 2, 1 } });
+  filter3D->SetNumberOfWorkUnits(8);
+  ITK_TEST_EXPECT_EQUAL(filter3D->GetOffsets()->size(), 13);
+  ITK_TRY_EXPECT_NO_EXCEPTION(filter3D->Update());
+  if (!CheckFeatures(filter3D.GetPointer(), region3D))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Threaded co-occurrence and run length matrices.
+  using CooccurrenceFilterType = itk::Statistics::ScalarImageToCooccurrenceMatrixFilter<ImageType3D>;
+  auto cooccurrenceFilter = CooccurrenceFilterType::New();
+  cooccurrenceFilter->SetInput(image3D);
+  cooccurrenceFilter->SetOffsets(filter3D->GetOffsets());
+  cooccurrenceFilter->SetNumberOfBinsPerAxis(16);
+  if (!CheckWorkUnits(cooccurrenceFilter.GetPointer(), "co-occurrence"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  auto mask3D = ImageType3D::New();
+  mask3D->SetRegions(region3D);
+  mask3D->Allocate();
+  for (itk::ImageRegionIterator<ImageType3D> it(mask3D, region3D); !it.IsAtEnd(); ++it)
+  {
+    it.Set(randomNumberGenerator->GetIntegerVariate(3) == 0 ? 0 : 1);
+  }
+  cooccurrenceFilter->SetMaskImage(mask3D);
+  if (!CheckWorkUnits(cooccurrenceFilter.GetPointer(), "masked co-occurrence"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  using RunLengthFilterType = itk::Statistics::ScalarImageToRunLengthMatrixFilter<ImageType3D>;
+  auto runLengthFilter = RunLengthFilterType::New();
+  runLengthFilter->SetInput(image3D);
+  runLengthFilter->SetMaskImage(mask3D);
+  auto runLengthOffsets = RunLengthFilterType::OffsetVector::New();
+  for (const auto & offset : *filter3D->GetOffsets())
+  {
+    runLengthOffsets->push_back(offset);
+  }
+  runLengthFilter->SetOffsets(runLengthOffsets);
+  runLengthFilter->SetNumberOfBinsPerAxis(8);
+  runLengthFilter->SetPixelValueMinMax(0, 255);
+  runLengthFilter->SetDistanceValueMinMax(0, 8);
+  if (!CheckWorkUnits(runLengthFilter.GetPointer(), "run length"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
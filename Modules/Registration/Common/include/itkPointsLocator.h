@@ -22,7 +22,7 @@
 
 #include "itkPoint.h"
 #include "itkIntTypes.h"
-#include "itkKdTree.h"
+#include "itkFlatKdTree.h"
 #include "itkKdTreeGenerator.h"
 #include "itkVectorContainer.h"
 #include "itkVectorContainerToListSampleAdaptor.h"
@@ -35,6 +35,11 @@ namespace itk
  *
  * This class accelerates the search for the closest point to a user-provided
  * point, by using constructing a Kd-Tree structure for the PointSetContainer.
+ * The tree is a Statistics::FlatKdTree, which is built in parallel and stores
+ * the coordinates of the points contiguously. The closest N points are
+ * returned sorted by increasing distance, and the queries of a container of
+ * points are answered in parallel by the methods taking a container of
+ * points.
  *
  * \ingroup ITKRegistrationCommon
  */
@@ -74,13 +79,20 @@ public:
   using SampleAdaptorType = Statistics::VectorContainerToListSampleAdaptor<PointsContainer>;
   using SampleAdaptorPointer = typename SampleAdaptorType::Pointer;
 
-  /** Types of the KdTreeGenerator */
+#if !defined(ITK_LEGACY_REMOVE)
+  /** Types of the KdTreeGenerator, which is no longer used to build the tree. */
   using TreeGeneratorType = Statistics::KdTreeGenerator<SampleAdaptorType>;
   using TreeGeneratorPointer = typename TreeGeneratorType::Pointer;
-  using TreeType = typename TreeGeneratorType::KdTreeType;
+#endif
+
+  /** Types of the Kd-Tree */
+  using TreeType = Statistics::FlatKdTree<SampleAdaptorType>;
   using TreeConstPointer = typename TreeType::ConstPointer;
   using NeighborsIdentifierType = typename TreeType::InstanceIdentifierVectorType;
 
+  /** Container of query points. */
+  using QueryPointContainerType = std::vector<PointType>;
+
   /** Set/Get the points from which the bounding box should be computed. */
   itkSetObjectMacro(Points, PointsContainer);
 
@@ -107,6 +119,24 @@ public:
   void
   FindPointsWithinRadius(const PointType &, double, NeighborsIdentifierType &) const;
 
+  /** Find in parallel the closest point of each query point. */
+  void
+  FindClosestPoints(const QueryPointContainerType &, NeighborsIdentifierType &) const;
+
+  /** Find in parallel the closest N points of each query point.  The ids and
+   * distances of the points closest to the query point i are saved from the
+   * position i * N. */
+  void
+  FindClosestNPoints(const QueryPointContainerType &,
+                     unsigned int,
+                     NeighborsIdentifierType &,
+                     std::vector<double> &) const;
+
+  /** Find in parallel all the points within a specified radius of each query
+   * point. */
+  void
+  FindPointsWithinRadius(const QueryPointContainerType &, double, std::vector<NeighborsIdentifierType> &) const;
+
 protected:
   PointsLocator();
   ~PointsLocator() override = default;
@@ -116,7 +146,6 @@ protected:
 private:
   PointsContainerPointer m_Points{};
   SampleAdaptorPointer   m_SampleAdaptor{};
-  TreeGeneratorPointer   m_KdTreeGenerator{};
   TreeConstPointer       m_Tree{};
 };
 
@@ -25,7 +25,6 @@ template <typename TPointsContainer>
 PointsLocator<TPointsContainer>::PointsLocator()
 {
   this->m_SampleAdaptor = SampleAdaptorType::New();
-  this->m_KdTreeGenerator = TreeGeneratorType::New();
 }
 
 template <typename TPointsContainer>
@@ -42,19 +41,18 @@ PointsLocator<TPointsContainer>::Initialize()
   }
 
   this->m_SampleAdaptor = SampleAdaptorType::New();
-  this->m_KdTreeGenerator = TreeGeneratorType::New();
 
   // Lack of const-correctness in the PointSetAdaptor should be fixed.
   this->m_SampleAdaptor->SetVectorContainer(const_cast<PointsContainer *>(this->m_Points.GetPointer()));
 
   this->m_SampleAdaptor->SetMeasurementVectorSize(PointDimension);
 
-  this->m_KdTreeGenerator->SetSample(this->m_SampleAdaptor);
-  this->m_KdTreeGenerator->SetBucketSize(16);
+  auto tree = TreeType::New();
+  tree->SetSample(this->m_SampleAdaptor);
+  tree->SetBucketSize(16);
+  tree->Build();
 
-  this->m_KdTreeGenerator->Update();
-
-  this->m_Tree = this->m_KdTreeGenerator->GetOutput();
+  this->m_Tree = tree;
 }
 
 template <typename TPointsContainer>
@@ -112,6 +110,42 @@ PointsLocator<TPointsContainer>::FindPointsWithinRadius(const PointType &
   this->m_Tree->Search(query, radius, identifiers);
 }
 
+template <typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>::FindClosestPoints(const QueryPointContainerType & queries,
+                                                   NeighborsIdentifierType &       identifiers) const
+{
+  std::vector<double> distances;
+  this->m_Tree->BatchSearch(queries, 1u, identifiers, distances);
+}
+
+template <typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>::FindClosestNPoints(const QueryPointContainerType & queries,
+                                                    unsigned int                    numberOfNeighborsRequested,
+                                                    NeighborsIdentifierType &       identifiers,
+                                                    std::vector<double> &           distances) const
+{
+  unsigned int N = numberOfNeighborsRequested;
+  if (N > this->m_Points->Size())
+  {
+    N = this->m_Points->Size();
+
+    itkWarningMacro("The number of requested neighbors is greater than the "
+                    << "total number of points.  Only returning " << N << " points.");
+  }
+  this->m_Tree->BatchSearch(queries, N, identifiers, distances);
+}
+
+template <typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>::FindPointsWithinRadius(const QueryPointContainerType &        queries,
+                                                        double                                 radius,
+                                                        std::vector<NeighborsIdentifierType> & identifiers) const
+{
+  this->m_Tree->BatchSearch(queries, radius, identifiers);
+}
+
 /**
  * Print out internals
  */
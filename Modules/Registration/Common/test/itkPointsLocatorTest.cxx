@@ -128,6 +128,48 @@ testPointsLocatorTest()
     return EXIT_FAILURE;
   }
 
+  std::cout << "Test:  FindClosestPoints()" << std::endl;
+
+  typename PointsLocatorType::QueryPointContainerType queries(3, coords);
+  queries[1].Fill(-3.0);
+  queries[2].Fill(99.8);
+
+  pointsLocator->FindClosestPoints(queries, neighborhood);
+  ITK_TEST_EXPECT_EQUAL(neighborhood.size(), 3);
+  ITK_TEST_EXPECT_EQUAL(neighborhood[0], 49);
+  ITK_TEST_EXPECT_EQUAL(neighborhood[1], 0);
+  ITK_TEST_EXPECT_EQUAL(neighborhood[2], 99);
+
+  std::cout << "Test:  FindClosestNPoints() with a container of points" << std::endl;
+
+  typename PointsLocatorType::NeighborsIdentifierType batchNeighborhood;
+  std::vector<double>                                 batchDistances;
+  pointsLocator->FindClosestNPoints(queries, 10u, batchNeighborhood, batchDistances);
+  if (batchNeighborhood.size() != 30 || batchDistances.size() != 30)
+  {
+    std::cerr << "Error with FindClosestNPoints(), size of returned points or distances does not match" << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (unsigned int q = 0; q < queries.size(); ++q)
+  {
+    pointsLocator->FindClosestNPoints(queries[q], 10u, neighborhood, distances);
+    for (unsigned int i = 0; i < neighborhood.size(); ++i)
+    {
+      ITK_TEST_EXPECT_EQUAL(neighborhood[i], batchNeighborhood[q * 10 + i]);
+      ITK_TEST_EXPECT_EQUAL(distances[i], batchDistances[q * 10 + i]);
+      ITK_TEST_EXPECT_TRUE(i == 0 || distances[i - 1] <= distances[i]);
+    }
+  }
+
+  std::cout << "Test:  FindPointsWithinRadius() with a container of points" << std::endl;
+
+  std::vector<typename PointsLocatorType::NeighborsIdentifierType> batchNeighborhoods;
+  pointsLocator->FindPointsWithinRadius(queries, radius, batchNeighborhoods);
+  ITK_TEST_EXPECT_EQUAL(batchNeighborhoods.size(), 3);
+  ITK_TEST_EXPECT_EQUAL(batchNeighborhoods[0].size(), 11);
+  ITK_TEST_EXPECT_EQUAL(batchNeighborhoods[1].size(), 2);
+  ITK_TEST_EXPECT_EQUAL(batchNeighborhoods[2].size(), 6);
+
   return EXIT_SUCCESS;
 }
 
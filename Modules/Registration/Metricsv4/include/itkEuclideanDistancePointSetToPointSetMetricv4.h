@@ -66,6 +66,7 @@ public:
   using typename Superclass::PointType;
   using typename Superclass::PixelType;
   using typename Superclass::PointIdentifier;
+  using typename Superclass::NeighborsIdentifierType;
 
   using RealType = MeasureType;
   /**
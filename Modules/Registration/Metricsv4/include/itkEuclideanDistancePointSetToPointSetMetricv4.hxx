@@ -28,12 +28,19 @@ typename EuclideanDistancePointSetToPointSetMetricv4<TFixedPointSet, TMovingPoin
   EuclideanDistancePointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>::
     GetLocalNeighborhoodValue(const PointType & point, const PixelType & itkNotUsed(pixel)) const
 {
-  PointType closestPoint{};
-
-  const PointIdentifier pointId = this->m_MovingTransformedPointsLocator->FindClosestPoint(point);
-  closestPoint = this->m_MovingTransformedPointSet->GetPoint(pointId);
+  // The distance to the closest point is returned by the locator, so that the
+  // closest point is not fetched from the moving point set.
+  NeighborsIdentifierType neighborhood;
+  std::vector<double>     neighborDistances;
+  this->m_MovingTransformedPointsLocator->FindClosestNPoints(point, 1u, neighborhood, neighborDistances);
+  if (neighborDistances.empty())
+  {
+    // Without a moving point, the point contributes as a point beyond the
+    // threshold.
+    return 0;
+  }
 
-  const MeasureType distance = point.EuclideanDistanceTo(closestPoint);
+  const auto distance = static_cast<MeasureType>(neighborDistances[0]);
   if (this->m_DistanceThreshold <= 0 || distance < this->m_DistanceThreshold)
   {
     return distance;
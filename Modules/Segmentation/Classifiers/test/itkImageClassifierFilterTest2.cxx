@@ -0,0 +1,255 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageClassifierFilter.h"
+#include "itkSampleClassifierFilter.h"
+#include "itkGaussianMembershipFunction.h"
+#include "itkDistanceToCentroidMembershipFunction.h"
+#include "itkMaximumDecisionRule.h"
+#include "itkMinimumDecisionRule.h"
+#include "itkMaximumRatioDecisionRule.h"
+#include "itkListSample.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkMath.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+constexpr unsigned int MeasurementVectorSize = 3;
+constexpr unsigned int NumberOfClasses = 3;
+
+using MeasurementVectorType = itk::Vector<float, MeasurementVectorSize>;
+using SampleType = itk::Statistics::ListSample<MeasurementVectorType>;
+using InputImageType = itk::Image<MeasurementVectorType, 2>;
+using OutputImageType = itk::Image<unsigned char, 2>;
+using ImageClassifierFilterType = itk::Statistics::ImageClassifierFilter<SampleType, InputImageType, OutputImageType>;
+using SampleClassifierFilterType = itk::Statistics::SampleClassifierFilter<SampleType>;
+using MembershipFunctionVectorType = ImageClassifierFilterType::MembershipFunctionVectorType;
+using WeightsArrayType = ImageClassifierFilterType::MembershipFunctionsWeightsArrayType;
+
+// Check that the label of a measurement vector is the one of the class that
+// the decision rule chooses from its weighted scores, unless the scores of
+// both classes are equal up to rounding.
+bool
+CheckLabel(const MeasurementVectorType &         measurementVector,
+           unsigned int                          label,
+           const MembershipFunctionVectorType &  membershipFunctions,
+           const WeightsArrayType &              weights,
+           const itk::Statistics::DecisionRule * decisionRule,
+           const char *                          name)
+{
+  itk::Statistics::DecisionRule::MembershipVectorType scores(NumberOfClasses);
+  for (unsigned int i = 0; i < NumberOfClasses; ++i)
+  {
+    scores[i] = weights[i] * membershipFunctions[i]->Evaluate(measurementVector);
+  }
+  const unsigned int expectedClass = decisionRule->Evaluate(scores);
+  const unsigned int actualClass = label / 10 - 1;
+  if (actualClass != expectedClass &&
+      itk::Math::abs(scores[actualClass] - scores[expectedClass]) >
+        1e-9 * std::max(itk::Math::abs(scores[actualClass]), itk::Math::abs(scores[expectedClass])))
+  {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "Error in the " << name << " label of the measurement vector " << measurementVector << std::endl;
+    std::cerr << "Expected " << 10 * (expectedClass + 1) << ", but got " << label << std::endl;
+    return false;
+  }
+  return true;
+}
+} // namespace
+
+/* Classify the pixels of a vector image, and the measurement vectors of a
+ * sample, with Gaussian and distance to centroid membership functions and
+ * several decision rules, with one or several work units, and compare the
+ * labels with the ones of the decision rules for the scores of each
+ * measurement vector. */
+int
+itkImageClassifierFilterTest2(int, char *[])
+{
+  using NumberGeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  const NumberGeneratorType::Pointer randomNumberGenerator = NumberGeneratorType::GetInstance();
+  randomNumberGenerator->Initialize(20250501);
+
+  const double means[NumberOfClasses][MeasurementVectorSize] = { { 100.0, 200.0, 50.0 },
+                                                                 { 150.0, 120.0, 90.0 },
+                                                                 { 60.0, 90.0, 140.0 } };
+
+  // Lines longer than the blocks of the image classifier.
+  const InputImageType::RegionType region({ 0, 0 }, { 601, 23 });
+  auto                             image = InputImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  auto sample = SampleType::New();
+  sample->SetMeasurementVectorSize(MeasurementVectorSize);
+  for (itk::ImageRegionIterator<InputImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    const unsigned int    i = randomNumberGenerator->GetIntegerVariate(NumberOfClasses - 1);
+    MeasurementVectorType measurementVector;
+    for (unsigned int d = 0; d < MeasurementVectorSize; ++d)
+    {
+      measurementVector[d] = static_cast<float>(randomNumberGenerator->GetNormalVariate(means[i][d], 900.0));
+    }
+    it.Set(measurementVector);
+    sample->PushBack(measurementVector);
+  }
+
+  // Gaussian membership functions, with correlated components.
+  using GaussianMembershipFunctionType = itk::Statistics::GaussianMembershipFunction<MeasurementVectorType>;
+  MembershipFunctionVectorType gaussianMembershipFunctions;
+  for (unsigned int i = 0; i < NumberOfClasses; ++i)
+  {
+    auto                                                 membershipFunction = GaussianMembershipFunctionType::New();
+    GaussianMembershipFunctionType::MeanVectorType       mean;
+    GaussianMembershipFunctionType::CovarianceMatrixType covariance;
+    covariance.SetSize(MeasurementVectorSize, MeasurementVectorSize);
+    for (unsigned int d = 0; d < MeasurementVectorSize; ++d)
+    {
+      mean[d] = means[i][d];
+      for (unsigned int e = 0; e < MeasurementVectorSize; ++e)
+      {
+        covariance(d, e) = d == e ? 400.0 + 200.0 * i : 100.0 - 40.0 * (d + e + i);
+      }
+    }
+    membershipFunction->SetMean(mean);
+    membershipFunction->SetCovariance(covariance);
+    gaussianMembershipFunctions.push_back(membershipFunction.GetPointer());
+
+    // The batched densities are the ones of Evaluate().
+    double densities[4];
+    double measurementVectors[4 * MeasurementVectorSize];
+    for (unsigned int j = 0; j < 4; ++j)
+    {
+      for (unsigned int d = 0; d < MeasurementVectorSize; ++d)
+      {
+        measurementVectors[j * MeasurementVectorSize + d] = sample->GetMeasurementVector(j)[d];
+      }
+    }
+    membershipFunction->BatchEvaluate(measurementVectors, 4, densities);
+    for (unsigned int j = 0; j < 4; ++j)
+    {
+      const double expected = membershipFunction->Evaluate(sample->GetMeasurementVector(j));
+      ITK_TEST_EXPECT_TRUE(itk::Math::abs(densities[j] - expected) <= 1e-12 * expected);
+    }
+  }
+
+  using DistanceMembershipFunctionType = itk::Statistics::DistanceToCentroidMembershipFunction<MeasurementVectorType>;
+  MembershipFunctionVectorType distanceMembershipFunctions;
+  for (unsigned int i = 0; i < NumberOfClasses; ++i)
+  {
+    auto                                         membershipFunction = DistanceMembershipFunctionType::New();
+    DistanceMembershipFunctionType::CentroidType centroid(MeasurementVectorSize);
+    for (unsigned int d = 0; d < MeasurementVectorSize; ++d)
+    {
+      centroid[d] = means[i][d];
+    }
+    membershipFunction->SetCentroid(centroid);
+    distanceMembershipFunctions.push_back(membershipFunction.GetPointer());
+  }
+
+  auto maximumRatioDecisionRule = itk::Statistics::MaximumRatioDecisionRule::New();
+  const itk::Statistics::MaximumRatioDecisionRule::PriorProbabilityVectorType priors{ 0.5, 0.3, 0.2 };
+  maximumRatioDecisionRule->SetPriorProbabilities(priors);
+
+  struct Configuration
+  {
+    const char *                                name;
+    const MembershipFunctionVectorType &        membershipFunctions;
+    itk::Statistics::DecisionRule::ConstPointer decisionRule;
+  };
+  const Configuration configurations[] = {
+    { "maximum", gaussianMembershipFunctions, itk::Statistics::MaximumDecisionRule::New().GetPointer() },
+    { "minimum", distanceMembershipFunctions, itk::Statistics::MinimumDecisionRule::New().GetPointer() },
+    { "maximum ratio", gaussianMembershipFunctions, maximumRatioDecisionRule.GetPointer() }
+  };
+
+  auto classLabels = ImageClassifierFilterType::ClassLabelVectorObjectType::New();
+  for (unsigned int i = 0; i < NumberOfClasses; ++i)
+  {
+    classLabels->Get().push_back(10 * (i + 1));
+  }
+  auto weights = ImageClassifierFilterType::MembershipFunctionsWeightsArrayObjectType::New();
+  weights->Get().SetSize(NumberOfClasses);
+  weights->Get()[0] = 1.0;
+  weights->Get()[1] = 0.8;
+  weights->Get()[2] = 1.3;
+
+  for (const Configuration & configuration : configurations)
+  {
+    auto membershipFunctions = ImageClassifierFilterType::MembershipFunctionVectorObjectType::New();
+    membershipFunctions->Set(configuration.membershipFunctions);
+
+    for (const itk::ThreadIdType numberOfWorkUnits : { 1, 8 })
+    {
+      std::cout << "Decision rule: " << configuration.name << ", number of work units: " << numberOfWorkUnits
+                << std::endl;
+
+      auto imageClassifier = ImageClassifierFilterType::New();
+      imageClassifier->SetImage(image);
+      imageClassifier->SetNumberOfClasses(NumberOfClasses);
+      imageClassifier->SetClassLabels(classLabels);
+      imageClassifier->SetMembershipFunctions(membershipFunctions);
+      imageClassifier->SetMembershipFunctionsWeightsArray(weights);
+      imageClassifier->SetDecisionRule(configuration.decisionRule);
+      imageClassifier->SetNumberOfWorkUnits(numberOfWorkUnits);
+      ITK_TRY_EXPECT_NO_EXCEPTION(imageClassifier->Update());
+
+      itk::ImageRegionConstIterator<OutputImageType> outputIt(imageClassifier->GetOutput(), region);
+      for (itk::ImageRegionConstIterator<InputImageType> it(image, region); !it.IsAtEnd(); ++it, ++outputIt)
+      {
+        if (!CheckLabel(it.Get(),
+                        outputIt.Get(),
+                        configuration.membershipFunctions,
+                        weights->Get(),
+                        configuration.decisionRule,
+                        "image"))
+        {
+          return EXIT_FAILURE;
+        }
+      }
+
+      auto sampleClassifier = SampleClassifierFilterType::New();
+      sampleClassifier->SetInput(sample);
+      sampleClassifier->SetNumberOfClasses(NumberOfClasses);
+      sampleClassifier->SetClassLabels(classLabels);
+      sampleClassifier->SetMembershipFunctions(membershipFunctions);
+      sampleClassifier->SetMembershipFunctionsWeightsArray(weights);
+      sampleClassifier->SetDecisionRule(configuration.decisionRule);
+      sampleClassifier->SetNumberOfWorkUnits(numberOfWorkUnits);
+      ITK_TRY_EXPECT_NO_EXCEPTION(sampleClassifier->Update());
+
+      const SampleClassifierFilterType::MembershipSampleType * membershipSample = sampleClassifier->GetOutput();
+      ITK_TEST_EXPECT_EQUAL(membershipSample->GetClassLabelHolder().size(), sample->Size());
+      for (SampleType::InstanceIdentifier id = 0; id < sample->Size(); ++id)
+      {
+        if (!CheckLabel(sample->GetMeasurementVector(id),
+                        membershipSample->GetClassLabel(id),
+                        configuration.membershipFunctions,
+                        weights->Get(),
+                        configuration.decisionRule,
+                        "sample"))
+        {
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
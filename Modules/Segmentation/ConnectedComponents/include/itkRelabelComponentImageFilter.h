@@ -22,6 +22,7 @@
 #include "itkImage.h"
 #include <vector>
 #include <mutex>
+#include <type_traits>
 
 namespace itk
 {
@@ -68,9 +69,14 @@ namespace itk
  * controlled via methods in the superclass,
  * InPlaceImageFilter::InPlaceOn() and InPlaceImageFilter::InPlaceOff().
  *
+ * The objects are counted and relabeled in parallel. When the labels are
+ * integers spanning a range no larger than the image, each work unit counts
+ * the pixels in its own dense table, the tables are summed in parallel, and
+ * the relabeling is done through a dense lookup table. Other labels are
+ * counted in ordered maps.
+ *
  * \sa ConnectedComponentImageFilter, BinaryThresholdImageFilter, ThresholdImageFilter
  *
- * \ingroup SingleThreaded
  * \ingroup ITKConnectedComponents
  *
  * \sphinx
@@ -254,6 +260,17 @@ protected:
   void
   ParallelComputeLabels(const RegionType & inputRegionForThread);
 
+  /** Computes the range of the integer labels of the input. Returns false
+   * when the labels are not integers or span too large a range to be
+   * counted in dense tables. */
+  bool
+  ComputeDenseLabelRange(LabelType & minimumLabel, SizeValueType & numberOfLabels);
+
+  /** Counts the pixels of each label of the range starting at minimumLabel
+   * in per work unit dense tables, and returns their sum. */
+  std::vector<ObjectSizeType>
+  ParallelCountDenseLabels(LabelType minimumLabel, SizeValueType numberOfLabels);
+
   /** RelabelComponentImageFilter needs the entire input. Therefore
    * it must provide an implementation GenerateInputRequestedRegion().
    * \sa ProcessObject::GenerateInputRequestedRegion(). */
@@ -290,6 +307,22 @@ private:
 
   ObjectSizeInPixelsContainerType        m_SizeOfObjectsInPixels{};
   ObjectSizeInPhysicalUnitsContainerType m_SizeOfObjectsInPhysicalUnits{};
+
+  /** Offset of a label in a dense table starting at minimumLabel. */
+  static SizeValueType
+  GetDenseLabelOffset(const LabelType & label, const LabelType & minimumLabel)
+  {
+    if constexpr (std::is_integral_v<LabelType> && !std::is_same_v<LabelType, bool>)
+    {
+      using UnsignedLabelType = std::make_unsigned_t<LabelType>;
+      return static_cast<SizeValueType>(static_cast<UnsignedLabelType>(label) -
+                                        static_cast<UnsignedLabelType>(minimumLabel));
+    }
+    else
+    {
+      return 0;
+    }
+  }
 };
 } // end namespace itk
 
@@ -23,6 +23,7 @@
 #include "itkProgressReporter.h"
 #include "itkProgressTransformer.h"
 #include "itkImageScanlineIterator.h"
+#include <algorithm>
 #include <map>
 #include <utility>
 #include "itkTotalProgressReporter.h"
@@ -120,6 +121,138 @@ RelabelComponentImageFilter<TInputImage, TOutputImage>::ParallelComputeLabels(co
 }
 
 
+template <typename TInputImage, typename TOutputImage>
+bool
+RelabelComponentImageFilter<TInputImage, TOutputImage>::ComputeDenseLabelRange(LabelType &     minimumLabel,
+                                                                               SizeValueType & numberOfLabels)
+{
+  if constexpr (std::is_integral_v<LabelType> && !std::is_same_v<LabelType, bool>)
+  {
+    const RegionType &  inputRegion = this->GetInput()->GetRequestedRegion();
+    const SizeValueType numberOfPixels = inputRegion.GetNumberOfPixels();
+    if (numberOfPixels == 0)
+    {
+      return false;
+    }
+
+    LabelType minimum = NumericTraits<LabelType>::max();
+    LabelType maximum = NumericTraits<LabelType>::NonpositiveMin();
+
+    this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+    this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+      inputRegion,
+      [this, &minimum, &maximum](const RegionType & inputRegionForThread) {
+        LabelType localMinimum = NumericTraits<LabelType>::max();
+        LabelType localMaximum = NumericTraits<LabelType>::NonpositiveMin();
+
+        ImageScanlineConstIterator it(this->GetInput(), inputRegionForThread);
+        while (!it.IsAtEnd())
+        {
+          while (!it.IsAtEndOfLine())
+          {
+            const LabelType inputValue = it.Get();
+            localMinimum = std::min(localMinimum, inputValue);
+            localMaximum = std::max(localMaximum, inputValue);
+            ++it;
+          }
+          it.NextLine();
+        }
+
+        const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+        minimum = std::min(minimum, localMinimum);
+        maximum = std::max(maximum, localMaximum);
+      },
+      nullptr);
+
+    // The per work unit tables must not be much larger than the image.
+    const SizeValueType range = GetDenseLabelOffset(maximum, minimum);
+    if (range >= std::max<SizeValueType>(SizeValueType{ 1 } << 16, numberOfPixels))
+    {
+      return false;
+    }
+    minimumLabel = minimum;
+    numberOfLabels = range + 1;
+    return true;
+  }
+  else
+  {
+    (void)minimumLabel;
+    (void)numberOfLabels;
+    return false;
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage>
+auto
+RelabelComponentImageFilter<TInputImage, TOutputImage>::ParallelCountDenseLabels(LabelType     minimumLabel,
+                                                                                 SizeValueType numberOfLabels)
+  -> std::vector<ObjectSizeType>
+{
+  const RegionType &  inputRegion = this->GetInput()->GetRequestedRegion();
+  const SizeValueType numberOfPixels = inputRegion.GetNumberOfPixels();
+
+  // Every work unit fills a table of all the labels, so there are no more
+  // work units than the image has pixels per label.
+  const auto numberOfWorkUnits = static_cast<ThreadIdType>(
+    std::clamp<SizeValueType>(numberOfPixels / numberOfLabels, 1, this->GetNumberOfWorkUnits()));
+
+  std::vector<std::vector<ObjectSizeType>> tables;
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits(numberOfWorkUnits);
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    inputRegion,
+    [this, &tables, minimumLabel, numberOfLabels, numberOfPixels](const RegionType & inputRegionForThread) {
+      std::vector<ObjectSizeType> counts(numberOfLabels);
+      TotalProgressReporter       report(this, numberOfPixels, 100, 0.5f);
+
+      ImageScanlineConstIterator it(this->GetInput(), inputRegionForThread);
+      while (!it.IsAtEnd())
+      {
+        while (!it.IsAtEndOfLine())
+        {
+          ++counts[GetDenseLabelOffset(it.Get(), minimumLabel)];
+          ++it;
+        }
+        report.Completed(inputRegionForThread.GetSize(0));
+        it.NextLine();
+      }
+
+      const std::lock_guard<std::mutex> lockGuard(m_Mutex);
+      tables.push_back(std::move(counts));
+    },
+    nullptr);
+
+  // Sum the tables into the first one, each work unit summing a block of
+  // labels.
+  constexpr SizeValueType blockSize = 4096;
+  const SizeValueType     numberOfBlocks = (numberOfLabels + blockSize - 1) / blockSize;
+  if (tables.size() > 1)
+  {
+    this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+    this->GetMultiThreader()->ParallelizeArray(
+      0,
+      numberOfBlocks,
+      [&tables, numberOfLabels](SizeValueType block) {
+        const SizeValueType begin = block * blockSize;
+        const SizeValueType end = std::min(begin + blockSize, numberOfLabels);
+        ObjectSizeType *    sum = tables[0].data();
+        for (size_t t = 1; t < tables.size(); ++t)
+        {
+          const ObjectSizeType * counts = tables[t].data();
+          for (SizeValueType label = begin; label < end; ++label)
+          {
+            sum[label] += counts[label];
+          }
+        }
+      },
+      nullptr);
+  }
+
+  return std::move(tables[0]);
+}
+
+
 template <typename TInputImage, typename TOutputImage>
 void
 RelabelComponentImageFilter<TInputImage, TOutputImage>::GenerateData()
@@ -138,17 +271,39 @@ RelabelComponentImageFilter<TInputImage, TOutputImage>::GenerateData()
   }
 
   // Walk the entire input image and compute used labels and the number of each label.
-  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
-    input->GetRequestedRegion(),
-    [this](const RegionType & inputRegion) { this->ParallelComputeLabels(inputRegion); },
-    nullptr);
+  LabelType                           minimumLabel{};
+  SizeValueType                       numberOfLabels = 0;
+  const bool                          useDenseLabels = this->ComputeDenseLabelRange(minimumLabel, numberOfLabels);
+  std::vector<LabelComponentPairType> sizeVector;
+  if (useDenseLabels)
+  {
+    const std::vector<ObjectSizeType> counts = this->ParallelCountDenseLabels(minimumLabel, numberOfLabels);
 
+    // Construct an array of the label, component information pair to sort,
+    // in increasing label order like the map.
+    for (SizeValueType offset = 0; offset < numberOfLabels; ++offset)
+    {
+      const auto label = static_cast<LabelType>(minimumLabel + static_cast<LabelType>(offset));
+      if (counts[offset] > 0 && label != LabelType{})
+      {
+        sizeVector.push_back({ label, { counts[offset] } });
+      }
+    }
+  }
+  else
+  {
+    this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+    this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+      input->GetRequestedRegion(),
+      [this](const RegionType & inputRegion) { this->ParallelComputeLabels(inputRegion); },
+      nullptr);
 
-  // Construct an array of the label, component information pair to sort
-  auto sizeVector = std::vector<LabelComponentPairType>(m_SizeMap.begin(), m_SizeMap.end());
+    // Construct an array of the label, component information pair to sort
+    sizeVector.assign(m_SizeMap.begin(), m_SizeMap.end());
 
-  // free memory by swapping to a default constructed object.
-  MapType().swap(m_SizeMap);
+    // free memory by swapping to a default constructed object.
+    MapType().swap(m_SizeMap);
+  }
 
   // Sort the objects by size by default, unless m_SortByObjectSize
   // is set to false.
@@ -219,6 +374,22 @@ RelabelComponentImageFilter<TInputImage, TOutputImage>::GenerateData()
   // After the objects stats are computed add in the background label so the relabelMap can be directly applied.
   relabelMap.insert({ LabelType{}, OutputPixelType{} });
 
+  // With dense labels, the relabeling is looked up in a table.
+  std::vector<OutputPixelType> relabelTable;
+  if (useDenseLabels)
+  {
+    relabelTable.resize(numberOfLabels);
+    for (const auto & relabelPair : relabelMap)
+    {
+      // The background may be outside of the range of the labels.
+      const SizeValueType offset = GetDenseLabelOffset(relabelPair.first, minimumLabel);
+      if (!(relabelPair.first < minimumLabel) && offset < numberOfLabels)
+      {
+        relabelTable[offset] = relabelPair.second;
+      }
+    }
+  }
+
   // Second pass: walk just the output requested region and relabel
   // the necessary pixels.
   //
@@ -227,9 +398,10 @@ RelabelComponentImageFilter<TInputImage, TOutputImage>::GenerateData()
   this->AllocateOutputs();
 
   // In parallel apply the relabeling map
+  this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
   this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
     output->GetRequestedRegion(),
-    [this, &relabelMap](const RegionType & outputRegionForThread) {
+    [this, &relabelMap, &relabelTable, minimumLabel](const RegionType & outputRegionForThread) {
       auto                  outputRequestedRegion = this->GetOutput()->GetRequestedRegion();
       TotalProgressReporter report(this, outputRequestedRegion.GetNumberOfPixels(), 100, 0.5f);
 
@@ -244,15 +416,22 @@ RelabelComponentImageFilter<TInputImage, TOutputImage>::GenerateData()
         {
           const auto && inputValue = it.Get();
 
-          if (mapIt->first != inputValue)
+          if (!relabelTable.empty())
           {
-            mapIt = relabelMap.find(inputValue);
+            oit.Set(relabelTable[GetDenseLabelOffset(inputValue, minimumLabel)]);
           }
+          else
+          {
+            if (mapIt->first != inputValue)
+            {
+              mapIt = relabelMap.find(inputValue);
+            }
 
-          // no new labels should be encountered in the input
-          assert(mapIt != relabelMap.cend());
+            // no new labels should be encountered in the input
+            assert(mapIt != relabelMap.cend());
 
-          oit.Set(mapIt->second);
+            oit.Set(mapIt->second);
+          }
 
           ++oit;
           ++it;
@@ -173,3 +173,82 @@ TEST(RelabelComponentImageFilter, big_random)
 
   filter->Update();
 }
+
+
+TEST(RelabelComponentImageFilter, dense_and_sparse_labels)
+{
+  using ImageType = itk::Image<int, 2>;
+
+  // Labels spanning a small range are counted in dense tables, labels
+  // spanning a large range in maps. Both must give the same objects.
+  const auto createImage = [](int scale) {
+    auto image = ImageType::New();
+    image->SetRegions(ImageType::RegionType(itk::MakeSize(41u, 29u)));
+    image->Allocate();
+    for (int y = 0; y < 29; ++y)
+    {
+      for (int x = 0; x < 41; ++x)
+      {
+        const int label = (x * x + 7 * y) % 23 - 11;
+        image->SetPixel({ { x, y } }, label * scale);
+      }
+    }
+    return image;
+  };
+
+  for (const bool sort : { false, true })
+  {
+    for (const unsigned int numberOfWorkUnits : { 1u, 3u, 8u })
+    {
+      auto denseFilter = itk::RelabelComponentImageFilter<ImageType, ImageType>::New();
+      denseFilter->SetInput(createImage(1));
+      denseFilter->SetSortByObjectSize(sort);
+      denseFilter->SetMinimumObjectSize(50);
+      denseFilter->SetNumberOfWorkUnits(numberOfWorkUnits);
+      denseFilter->Update();
+
+      auto sparseFilter = itk::RelabelComponentImageFilter<ImageType, ImageType>::New();
+      sparseFilter->SetInput(createImage(100003));
+      sparseFilter->SetSortByObjectSize(sort);
+      sparseFilter->SetMinimumObjectSize(50);
+      sparseFilter->SetNumberOfWorkUnits(numberOfWorkUnits);
+      sparseFilter->Update();
+
+      EXPECT_EQ(denseFilter->GetOriginalNumberOfObjects(), 22u);
+      EXPECT_EQ(denseFilter->GetNumberOfObjects(), sparseFilter->GetNumberOfObjects());
+      EXPECT_EQ(denseFilter->GetSizeOfObjectsInPixels(), sparseFilter->GetSizeOfObjectsInPixels());
+
+      const std::vector<int> denseOutput(denseFilter->GetOutput()->GetBufferPointer(),
+                                         denseFilter->GetOutput()->GetBufferPointer() + 41 * 29);
+      const std::vector<int> sparseOutput(sparseFilter->GetOutput()->GetBufferPointer(),
+                                          sparseFilter->GetOutput()->GetBufferPointer() + 41 * 29);
+      EXPECT_EQ(denseOutput, sparseOutput);
+    }
+  }
+}
+
+
+TEST(RelabelComponentImageFilter, dense_labels_without_background)
+{
+  using ImageType = itk::Image<unsigned char, 2>;
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::RegionType(itk::MakeSize(4u, 3u)));
+  image->Allocate();
+  image->FillBuffer(7);
+  image->SetPixel({ { 0, 0 } }, 5);
+  image->SetPixel({ { 1, 0 } }, 5);
+  image->SetPixel({ { 2, 2 } }, 9);
+
+  auto filter = itk::RelabelComponentImageFilter<ImageType, ImageType>::New();
+  filter->SetInput(image);
+  filter->SetNumberOfWorkUnits(3);
+  filter->Update();
+
+  EXPECT_EQ(filter->GetNumberOfObjects(), 3u);
+  const std::vector<itk::SizeValueType> expected({ 9u, 2u, 1u });
+  EXPECT_EQ(filter->GetSizeOfObjectsInPixels(), expected);
+  EXPECT_EQ(filter->GetOutput()->GetPixel({ { 0, 0 } }), 2);
+  EXPECT_EQ(filter->GetOutput()->GetPixel({ { 3, 1 } }), 1);
+  EXPECT_EQ(filter->GetOutput()->GetPixel({ { 2, 2 } }), 3);
+}
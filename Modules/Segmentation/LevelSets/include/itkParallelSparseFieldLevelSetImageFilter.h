@@ -25,6 +25,7 @@
 #include "itkNeighborhoodIterator.h"
 #include "itkMultiThreaderBase.h"
 #include <condition_variable>
+#include <functional>
 #include <vector>
 
 namespace itk
@@ -337,6 +338,32 @@ public:
     return m_Data[ThreadNum].m_Layers[0];
   }
 
+  /** Set/Get the minimum number of active layer nodes per block. At each
+   *  iteration, the change at the nodes of the active layers of all the work
+   *  units is calculated in blocks of consecutive nodes, which are picked by
+   *  the threads as they become idle, so that a front concentrated in a few
+   *  slabs keeps all the threads busy. The default is 256. */
+  itkSetClampMacro(MinimumNumberOfNodesPerBlock, SizeValueType, 1, NumericTraits<SizeValueType>::max());
+  itkGetConstMacro(MinimumNumberOfNodesPerBlock, SizeValueType);
+
+  /** Number of nodes of the active layer at the last iteration. The counters
+   *  of the last iteration are up to date when IterationEvent is invoked. */
+  itkGetConstMacro(NumberOfActiveLayerNodes, SizeValueType);
+
+  /** Number of blocks in which the change was calculated at the last
+   *  iteration. */
+  itkGetConstMacro(NumberOfActiveLayerBlocks, SizeValueType);
+
+  /** Largest number of active layer nodes owned by a work unit at the last
+   *  iteration. The sparse field of each work unit is updated by the work unit
+   *  itself, so the update takes longer when this number is large compared to
+   *  NumberOfActiveLayerNodes / NumberOfWorkUnits. */
+  itkGetConstMacro(MaximumNumberOfActiveLayerNodesPerWorkUnit, SizeValueType);
+
+  /** Number of times the slabs of the work units were moved to balance the
+   *  load since the filter was initialized. */
+  itkGetConstMacro(NumberOfLoadBalancings, SizeValueType);
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   // Begin concept checking
   itkConceptMacro(OutputEqualityComparableCheck, (Concept::EqualityComparable<PixelType>));
@@ -576,10 +603,27 @@ protected:
     return TimeStepType{};
   }
 
-  /** This method does the actual work of calculating change over a region
-   *  supplied by the multithreading mechanism.  */
+  /** This method does the actual work of calculating change at the active
+   *  layer nodes [firstNode, lastNode) of all the work units, using
+   *  globalData to accumulate the values needed by the time step. Iterate()
+   *  calls it for each block of nodes, from the threads of the multi-threader. */
   virtual TimeStepType
+  ThreadedCalculateChangeOfActiveLayerNodes(SizeValueType firstNode, SizeValueType lastNode, void * globalData);
+
+#ifndef ITK_FUTURE_LEGACY_REMOVE
+  /** Calculate the change at the active layer nodes of a work unit.
+   *  \deprecated Iterate() no longer calls this method, since the change is
+   *  calculated in blocks of nodes which do not follow the work units.
+   *  Override ThreadedCalculateChangeOfActiveLayerNodes() instead. */
+  [[deprecated("Override ThreadedCalculateChangeOfActiveLayerNodes() instead.")]] virtual TimeStepType
   ThreadedCalculateChange(ThreadIdType ThreadId);
+#endif
+
+  /** Calculate the change at the active layer nodes in [first, last), using
+   *  globalData to accumulate the values needed by the time step. */
+  template <typename TNodeIterator>
+  TimeStepType
+  CalculateChangeOfNodes(TNodeIterator first, TNodeIterator last, void * globalData);
 
   /** 1. Updates the values (in the output-image) of the nodes in the active layer
    *  that are moving OUT of the active layer. These values are used in the
@@ -799,6 +843,22 @@ protected:
    *  stop iterating. */
   bool m_Stop{ false };
 
+  /** The nodes of the active layers of all the work units, gathered at each
+   *  iteration to calculate their change in blocks. */
+  std::vector<std::reference_wrapper<LayerNodeType>> m_ActiveLayerNodes{};
+
+  /** Global data of the difference function for each block of active layer
+   *  nodes. */
+  std::vector<void *> m_BlockGlobalData{};
+
+  SizeValueType m_MinimumNumberOfNodesPerBlock{ 256 };
+
+  /** Counters of the last iteration */
+  SizeValueType m_NumberOfActiveLayerNodes{ 0 };
+  SizeValueType m_NumberOfActiveLayerBlocks{ 0 };
+  SizeValueType m_MaximumNumberOfActiveLayerNodesPerWorkUnit{ 0 };
+  SizeValueType m_NumberOfLoadBalancings{ 0 };
+
   /** This flag tells the solver whether or not to interpolate for the actual
       surface location when calculating change at each active layer node.  By
       default this is turned on. Subclasses which do not sample propagation
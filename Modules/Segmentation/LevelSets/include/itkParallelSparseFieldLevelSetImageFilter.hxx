@@ -888,6 +888,13 @@ ParallelSparseFieldLevelSetImageFilter<TInputImage, TOutputImage>::DeallocateDat
   // Deallocate the status image.
   m_StatusImage = nullptr;
 
+  m_ActiveLayerNodes.clear();
+  for (void * globalData : m_BlockGlobalData)
+  {
+    this->GetDifferenceFunction()->ReleaseGlobalDataPointer(globalData);
+  }
+  m_BlockGlobalData.clear();
+
   // Remove the barrier from the system.
   //  m_Barrier->Remove ();
 
@@ -1024,11 +1031,7 @@ ParallelSparseFieldLevelSetImageFilter<TInputImage, TOutputImage>::Iterate()
   MultiThreaderBase * mt = this->GetMultiThreader();
   mt->SetNumberOfWorkUnits(m_NumOfWorkUnits);
 
-  // Initialize the list of time step values that will be generated by the
-  // various threads.  There is one distinct slot for each possible thread,
-  // so this data structure is thread-safe.
-  m_TimeStepList.resize(m_NumOfWorkUnits);
-  m_ValidTimeStepList.resize(m_NumOfWorkUnits, true);
+  const typename FiniteDifferenceFunctionType::Pointer df = this->GetDifferenceFunction();
 
   const typename TOutputImage::RegionType reqRegion = m_OutputImage->GetRequestedRegion();
 
@@ -1072,6 +1075,7 @@ ParallelSparseFieldLevelSetImageFilter<TInputImage, TOutputImage>::Iterate()
 
     this->GraftOutput(this->m_OutputImage);
 
+    this->m_NumberOfLoadBalancings = 0;
     this->m_IsInitialized = true;
   }
 
@@ -1079,16 +1083,70 @@ ParallelSparseFieldLevelSetImageFilter<TInputImage, TOutputImage>::Iterate()
   unsigned int iter = this->GetElapsedIterations();
   while (!(this->Halt()))
   {
+    // Gather the nodes of the active layers of all the work units.
+    this->m_ActiveLayerNodes.clear();
+    this->m_MaximumNumberOfActiveLayerNodesPerWorkUnit = 0;
+    for (ThreadIdType threadId = 0; threadId < this->m_NumOfWorkUnits; ++threadId)
+    {
+      this->ThreadedInitializeIteration(threadId);
+
+      const LayerPointerType & activeLayer = this->m_Data[threadId].m_Layers[0];
+      for (typename LayerType::Iterator layerIt = activeLayer->Begin(); layerIt != activeLayer->End(); ++layerIt)
+      {
+        this->m_ActiveLayerNodes.emplace_back(*layerIt);
+      }
+      this->m_MaximumNumberOfActiveLayerNodesPerWorkUnit =
+        std::max<SizeValueType>(this->m_MaximumNumberOfActiveLayerNodesPerWorkUnit, activeLayer->Size());
+    }
+    this->m_NumberOfActiveLayerNodes = this->m_ActiveLayerNodes.size();
+
+    // Calculate the change in blocks of consecutive nodes. There are a few
+    // blocks per work unit, so that the threads done early pick the blocks
+    // left, whatever the slabs the nodes belong to.
+    constexpr SizeValueType BlocksPerWorkUnit = 4;
+    SizeValueType           numberOfBlocks = 1;
+    if (this->m_NumOfWorkUnits > 1)
+    {
+      numberOfBlocks = std::min({ this->m_NumberOfActiveLayerNodes / this->m_MinimumNumberOfNodesPerBlock,
+                                  BlocksPerWorkUnit * this->m_NumOfWorkUnits,
+                                  SizeValueType{ MultiThreaderBase::GetGlobalMaximumNumberOfThreads() } });
+      numberOfBlocks = std::max<SizeValueType>(numberOfBlocks, 1);
+    }
+    this->m_NumberOfActiveLayerBlocks = numberOfBlocks;
+
+    while (this->m_BlockGlobalData.size() < numberOfBlocks)
+    {
+      this->m_BlockGlobalData.push_back(df->GetGlobalDataPointer());
+    }
+    m_TimeStepList.resize(numberOfBlocks);
+
+    mt->SetNumberOfWorkUnits(static_cast<ThreadIdType>(numberOfBlocks));
     mt->ParallelizeArray(
       0,
-      m_NumOfWorkUnits,
-      [this](SizeValueType threadId) {
-        this->ThreadedInitializeIteration(threadId);
-        this->m_Data[threadId].TimeStep = this->ThreadedCalculateChange(threadId);
+      numberOfBlocks,
+      [this, numberOfBlocks](SizeValueType block) {
+        const SizeValueType numberOfNodes = this->m_NumberOfActiveLayerNodes;
+        this->m_TimeStepList[block] =
+          this->ThreadedCalculateChangeOfActiveLayerNodes(block * numberOfNodes / numberOfBlocks,
+                                                          (block + 1) * numberOfNodes / numberOfBlocks,
+                                                          this->m_BlockGlobalData[block]);
       },
       nullptr);
+    mt->SetNumberOfWorkUnits(m_NumOfWorkUnits);
 
-    // Calculate the timestep (no need to do this when there is just 1 thread)
+    // The time step of a block without motion is null: it must not stop the
+    // evolution of the other blocks.
+    m_ValidTimeStepList.assign(numberOfBlocks, true);
+    bool hasValidTimeStep = false;
+    for (SizeValueType block = 0; block < numberOfBlocks; ++block)
+    {
+      m_ValidTimeStepList[block] = Math::NotExactlyEquals(m_TimeStepList[block], TimeStepType{});
+      hasValidTimeStep = hasValidTimeStep || m_ValidTimeStepList[block];
+    }
+    m_TimeStep = hasValidTimeStep ? this->ResolveTimeStep(m_TimeStepList, m_ValidTimeStepList) : TimeStepType{};
+
+    // Gather the results of the work units (no need to do this when there is
+    // just 1 thread)
     if (this->m_NumOfWorkUnits == 1)
     {
       if (iter != 0)
@@ -1106,9 +1164,6 @@ ParallelSparseFieldLevelSetImageFilter<TInputImage, TOutputImage>::Iterate()
       this->InvokeEvent(IterationEvent());
       this->InvokeEvent(ProgressEvent());
       this->SetElapsedIterations(++iter);
-
-      // (works for the 1-thread case else redefined below)
-      m_TimeStep = this->m_Data[0].TimeStep;
     }
     else
     {
@@ -1143,12 +1198,6 @@ ParallelSparseFieldLevelSetImageFilter<TInputImage, TOutputImage>::Iterate()
       this->InvokeEvent(IterationEvent());
       this->InvokeEvent(ProgressEvent());
       this->SetElapsedIterations(++iter);
-
-      for (unsigned int i = 0; i < this->m_NumOfWorkUnits; ++i)
-      {
-        m_TimeStepList[i] = this->m_Data[i].TimeStep;
-      }
-      m_TimeStep = this->ResolveTimeStep(m_TimeStepList, m_ValidTimeStepList);
     }
 
     // The active layer is too small => stop iterating
@@ -1175,6 +1224,8 @@ ParallelSparseFieldLevelSetImageFilter<TInputImage, TOutputImage>::Iterate()
 
       if (this->m_BoundaryChanged)
       {
+        ++this->m_NumberOfLoadBalancings;
+
         // the situation at this point in time:
         // the OPTIMAL boundaries (that divide work equally) have changed but ...
         // the thread data lags behind the boundaries (it is still following the old
@@ -1207,10 +1258,35 @@ ParallelSparseFieldLevelSetImageFilter<TInputImage, TOutputImage>::Iterate()
     nullptr);
 }
 
+template <typename TInputImage, typename TOutputImage>
+auto
+ParallelSparseFieldLevelSetImageFilter<TInputImage, TOutputImage>::ThreadedCalculateChangeOfActiveLayerNodes(
+  SizeValueType firstNode,
+  SizeValueType lastNode,
+  void *        globalData) -> TimeStepType
+{
+  return this->CalculateChangeOfNodes(
+    m_ActiveLayerNodes.cbegin() + firstNode, m_ActiveLayerNodes.cbegin() + lastNode, globalData);
+}
+
+#ifndef ITK_FUTURE_LEGACY_REMOVE
 template <typename TInputImage, typename TOutputImage>
 auto
 ParallelSparseFieldLevelSetImageFilter<TInputImage, TOutputImage>::ThreadedCalculateChange(ThreadIdType ThreadId)
   -> TimeStepType
+{
+  return this->CalculateChangeOfNodes(
+    m_Data[ThreadId].m_Layers[0]->Begin(), m_Data[ThreadId].m_Layers[0]->End(), m_Data[ThreadId].globalData);
+}
+#endif
+
+template <typename TInputImage, typename TOutputImage>
+template <typename TNodeIterator>
+auto
+ParallelSparseFieldLevelSetImageFilter<TInputImage, TOutputImage>::CalculateChangeOfNodes(TNodeIterator first,
+                                                                                          TNodeIterator last,
+                                                                                          void *        globalData)
+  -> TimeStepType
 {
   const typename FiniteDifferenceFunctionType::Pointer df = this->GetDifferenceFunction();
   ValueType                                            centerValue = 0.0;
@@ -1242,12 +1318,10 @@ ParallelSparseFieldLevelSetImageFilter<TInputImage, TOutputImage>::ThreadedCalcu
   // the level set function to the output image (level set image) at each
   // index.
 
-  typename LayerType::Iterator       layerIt = m_Data[ThreadId].m_Layers[0]->Begin();
-  const typename LayerType::Iterator layerEnd = m_Data[ThreadId].m_Layers[0]->End();
-
-  for (; layerIt != layerEnd; ++layerIt)
+  for (TNodeIterator nodeIt = first; nodeIt != last; ++nodeIt)
   {
-    outputIt.SetLocation(layerIt->m_Index);
+    LayerNodeType & node = *nodeIt;
+    outputIt.SetLocation(node.m_Index);
     // Calculate the offset to the surface from the center of this
     // neighborhood.  This is used by some level set functions in sampling a
     // speed, advection, or curvature term.
@@ -1306,15 +1380,15 @@ ParallelSparseFieldLevelSetImageFilter<TInputImage, TOutputImage>::ThreadedCalcu
         offset[i] = (offset[i] * outputIt.GetCenterPixel()) / (norm_grad_phi_squared + MIN_NORM);
       }
 
-      layerIt->m_Value = df->ComputeUpdate(outputIt, (void *)m_Data[ThreadId].globalData, offset);
+      node.m_Value = df->ComputeUpdate(outputIt, globalData, offset);
     }
     else // Don't do interpolation
     {
-      layerIt->m_Value = df->ComputeUpdate(outputIt, (void *)m_Data[ThreadId].globalData);
+      node.m_Value = df->ComputeUpdate(outputIt, globalData);
     }
   }
 
-  const TimeStepType timeStep = df->ComputeGlobalTimeStep((void *)m_Data[ThreadId].globalData);
+  const TimeStepType timeStep = df->ComputeGlobalTimeStep(globalData);
 
   return timeStep;
 }
@@ -2513,6 +2587,13 @@ ParallelSparseFieldLevelSetImageFilter<TInputImage, TOutputImage>::PrintSelf(std
   }
   os << std::endl;
 
+  os << indent << "MinimumNumberOfNodesPerBlock: " << m_MinimumNumberOfNodesPerBlock << std::endl;
+  os << indent << "NumberOfActiveLayerNodes: " << m_NumberOfActiveLayerNodes << std::endl;
+  os << indent << "NumberOfActiveLayerBlocks: " << m_NumberOfActiveLayerBlocks << std::endl;
+  os << indent << "MaximumNumberOfActiveLayerNodesPerWorkUnit: " << m_MaximumNumberOfActiveLayerNodesPerWorkUnit
+     << std::endl;
+  os << indent << "NumberOfLoadBalancings: " << m_NumberOfLoadBalancings << std::endl;
+
   itkPrintSelfBooleanMacro(Stop);
   itkPrintSelfBooleanMacro(InterpolateSurfaceLocation);
   itkPrintSelfBooleanMacro(BoundsCheckingActive);
@@ -22,6 +22,8 @@
 #include "itkImageFileWriter.h"
 #include "itkTestingMacros.h"
 
+#include <atomic>
+
 /*
  * This test exercises the dense p.d.e. solver framework
  * itkParallelSparseFieldLevelSetImageFilter and the three-dimensional level
@@ -157,6 +159,7 @@ public:
   ITK_DISALLOW_COPY_AND_MOVE(MorphFilter);
 
   using Self = MorphFilter;
+  using Superclass = itk::ParallelSparseFieldLevelSetImageFilter<itk::Image<float, 3>, itk::Image<float, 3>>;
 
   /**
    * Smart pointer support for this class.
@@ -187,6 +190,14 @@ public:
     func->SetDistanceTransform(im);
   }
 
+  /** Number of active layer nodes whose change was calculated, over all the
+   * iterations. */
+  itk::SizeValueType
+  GetNumberOfCalculatedNodes() const
+  {
+    return m_NumberOfCalculatedNodes;
+  }
+
 protected:
   ~MorphFilter() override = default;
   MorphFilter()
@@ -199,8 +210,18 @@ protected:
     m_Iterations = 0;
   }
 
+  TimeStepType
+  ThreadedCalculateChangeOfActiveLayerNodes(itk::SizeValueType firstNode,
+                                            itk::SizeValueType lastNode,
+                                            void *             globalData) override
+  {
+    m_NumberOfCalculatedNodes += lastNode - firstNode;
+    return Superclass::ThreadedCalculateChangeOfActiveLayerNodes(firstNode, lastNode, globalData);
+  }
+
 private:
-  unsigned int m_Iterations;
+  unsigned int                    m_Iterations;
+  std::atomic<itk::SizeValueType> m_NumberOfCalculatedNodes{ 0 };
 
   bool
   Halt() override
@@ -309,8 +330,25 @@ itkParallelSparseFieldLevelSetImageFilterTest(int argc, char * argv[])
   mf->SetIsoSurfaceValue(isoSurfaceValue);
   ITK_TEST_SET_GET_VALUE(isoSurfaceValue, mf->GetIsoSurfaceValue());
 
+  constexpr itk::SizeValueType minimumNumberOfNodesPerBlock = 64;
+  mf->SetMinimumNumberOfNodesPerBlock(minimumNumberOfNodesPerBlock);
+  ITK_TEST_SET_GET_VALUE(minimumNumberOfNodesPerBlock, mf->GetMinimumNumberOfNodesPerBlock());
+
   ITK_TRY_EXPECT_NO_EXCEPTION(mf->Update());
 
+  // Counters of the last iteration
+  ITK_TEST_EXPECT_TRUE(mf->GetNumberOfActiveLayerNodes() > 0);
+  ITK_TEST_EXPECT_TRUE(mf->GetNumberOfActiveLayerBlocks() >= 1);
+  ITK_TEST_EXPECT_TRUE(mf->GetNumberOfActiveLayerBlocks() <=
+                       std::max<itk::SizeValueType>(1, mf->GetNumberOfActiveLayerNodes() / minimumNumberOfNodesPerBlock));
+  ITK_TEST_EXPECT_TRUE(mf->GetMaximumNumberOfActiveLayerNodesPerWorkUnit() <= mf->GetNumberOfActiveLayerNodes());
+  ITK_TEST_EXPECT_TRUE(mf->GetMaximumNumberOfActiveLayerNodesPerWorkUnit() * mf->GetNumberOfWorkUnits() >=
+                       mf->GetNumberOfActiveLayerNodes());
+  std::cout << "NumberOfLoadBalancings: " << mf->GetNumberOfLoadBalancings() << std::endl;
+
+  // The change is calculated through the overridable method.
+  ITK_TEST_EXPECT_TRUE(mf->GetNumberOfCalculatedNodes() >= mf->GetNumberOfActiveLayerNodes());
+
 
   mf->GetOutput()->Print(std::cout);
 
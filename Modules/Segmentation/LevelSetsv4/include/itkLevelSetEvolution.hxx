@@ -276,7 +276,7 @@ LevelSetEvolution<TEquationContainer, WhitakerSparseLevelSetImage<TOutput, VDime
   {
     const typename LevelSetType::ConstPointer levelSet =
       this->m_LevelSetContainerIteratorToProcessWhenThreading->GetLevelSet();
-    const LevelSetLayerType                                 zeroLayer = levelSet->GetLayer(0);
+    const LevelSetLayerType &                               zeroLayer = levelSet->GetLayer(0);
     auto                                                    layerBegin = zeroLayer.begin();
     auto                                                    layerEnd = zeroLayer.end();
     const typename SplitLevelSetPartitionerType::DomainType completeDomain(layerBegin, layerEnd);
@@ -336,6 +336,7 @@ LevelSetEvolution<TEquationContainer, WhitakerSparseLevelSetImage<TOutput, VDime
     updateLevelSet->SetEquationContainer(this->m_EquationContainer);
     updateLevelSet->SetTimeStep(this->m_Dt);
     updateLevelSet->SetCurrentLevelSetId(it->GetIdentifier());
+    updateLevelSet->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
     updateLevelSet->Update();
 
     levelSet->Graft(updateLevelSet->GetOutputLevelSet());
@@ -0,0 +1,239 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSparseBlockGrid_h
+#define itkSparseBlockGrid_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkImageRegion.h"
+#include "itkNumericTraits.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+namespace itk
+{
+/** \class SparseBlockGrid
+ * \brief Pixel container tiling a region in blocks which are only allocated
+ * when a pixel of the block is set.
+ *
+ * The region is tiled in cubic blocks of 2^VBlockSizeLog2 pixels along each
+ * dimension (8x8x8 pixels in 3D by default). A block is allocated, and filled
+ * with the background value, the first time one of its pixels is set, or when
+ * it is explicitly allocated with AllocateBlock(). The pixels of the blocks
+ * which are not allocated have the background value.
+ *
+ * The memory used is proportional to the number of allocated blocks, plus one
+ * table entry per block of the region. This makes the grid suited to store
+ * values which only differ from the background close to a surface, like the
+ * status of the nodes of a narrow band level set. Since the pixels of a block
+ * are contiguous in memory, the neighbors of a pixel are most often in the same
+ * block.
+ *
+ * The pixels of a block are ordered like the pixels of an image, the first
+ * dimension varying the fastest. The blocks are numbered in the order of their
+ * allocation.
+ *
+ * Reading pixels is thread safe. Setting pixels, or allocating blocks, is not
+ * thread safe.
+ *
+ * It stores the labels of the layers in UpdateWhitakerSparseLevelSet.
+ *
+ * \tparam TPixel type of the pixels.
+ * \tparam VDimension dimension of the region.
+ * \tparam VBlockSizeLog2 base 2 logarithm of the number of pixels of a block along each dimension.
+ *
+ * \ingroup ITKLevelSetsv4
+ */
+template <typename TPixel, unsigned int VDimension, unsigned int VBlockSizeLog2 = 3>
+class ITK_TEMPLATE_EXPORT SparseBlockGrid : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(SparseBlockGrid);
+
+  /** Standard type alias. */
+  using Self = SparseBlockGrid;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(SparseBlockGrid);
+
+  static constexpr unsigned int Dimension = VDimension;
+  static constexpr unsigned int BlockSizeLog2 = VBlockSizeLog2;
+
+  /** Number of pixels of a block along each dimension. */
+  static constexpr SizeValueType BlockSize = SizeValueType{ 1 } << VBlockSizeLog2;
+
+  /** Number of pixels of a block. */
+  static constexpr SizeValueType NumberOfPixelsPerBlock = SizeValueType{ 1 } << (VBlockSizeLog2 * VDimension);
+
+  static_assert(VBlockSizeLog2 * VDimension < 8 * sizeof(SizeValueType) - 1, "The blocks are too large.");
+  static_assert(!std::is_same_v<TPixel, bool>, "The pixels are stored in a std::vector, which is packed for bool.");
+
+  using PixelType = TPixel;
+  using IndexType = Index<VDimension>;
+  using SizeType = Size<VDimension>;
+  using RegionType = ImageRegion<VDimension>;
+  using BlockIdentifierType = SizeValueType;
+
+  /** Set the region tiled by the grid. All the blocks are released. */
+  void
+  SetRegion(const RegionType & region);
+  itkGetConstReferenceMacro(Region, RegionType);
+
+  /** Set/Get the value of the pixels which do not belong to an allocated
+   * block. Blocks allocated afterwards are filled with the new value. */
+  itkSetMacro(BackgroundValue, PixelType);
+  itkGetConstReferenceMacro(BackgroundValue, PixelType);
+
+  /** Whether the index is inside the region of the grid. */
+  bool
+  IsInside(const IndexType & index) const
+  {
+    return m_Region.IsInside(index);
+  }
+
+  /** Value of the pixel at the given index, which must be inside the region
+   * of the grid. */
+  const PixelType &
+  GetPixel(const IndexType & index) const
+  {
+    const BlockIdentifierType block = m_BlockTable[this->ComputeBlockOffset(index)];
+    if (block == NoBlock)
+    {
+      return m_BackgroundValue;
+    }
+    return m_Pixels[block * NumberOfPixelsPerBlock + this->ComputeOffsetInBlock(index)];
+  }
+
+  /** Set the pixel at the given index, which must be inside the region of the
+   * grid, allocating its block if needed. */
+  void
+  SetPixel(const IndexType & index, const PixelType & value)
+  {
+    const BlockIdentifierType block = this->AllocateBlock(index);
+    m_Pixels[block * NumberOfPixelsPerBlock + this->ComputeOffsetInBlock(index)] = value;
+  }
+
+  /** Allocate the block containing the index, which must be inside the region
+   * of the grid, if it is not allocated yet. Return the identifier of the
+   * block. */
+  BlockIdentifierType
+  AllocateBlock(const IndexType & index);
+
+  /** Whether the block containing the index, which must be inside the region
+   * of the grid, is allocated. */
+  bool
+  IsBlockAllocated(const IndexType & index) const
+  {
+    return m_BlockTable[this->ComputeBlockOffset(index)] != NoBlock;
+  }
+
+  /** Number of allocated blocks. */
+  BlockIdentifierType
+  GetNumberOfAllocatedBlocks() const
+  {
+    return static_cast<BlockIdentifierType>(m_BlockOffsets.size());
+  }
+
+  /** Region of an allocated block, cropped by the region of the grid. */
+  RegionType
+  GetBlockRegion(BlockIdentifierType block) const;
+
+  /** Pointer to the pixels of an allocated block. They are ordered as if the
+   * block was not cropped by the region of the grid. The pointer is
+   * invalidated when another block is allocated. */
+  PixelType *
+  GetBlockBuffer(BlockIdentifierType block)
+  {
+    return m_Pixels.data() + block * NumberOfPixelsPerBlock;
+  }
+  const PixelType *
+  GetBlockBuffer(BlockIdentifierType block) const
+  {
+    return m_Pixels.data() + block * NumberOfPixelsPerBlock;
+  }
+
+  /** Offset of a pixel in the buffer of its block. */
+  SizeValueType
+  ComputeOffsetInBlock(const IndexType & index) const
+  {
+    SizeValueType offset = 0;
+    for (unsigned int i = 0; i < VDimension; ++i)
+    {
+      const auto position = static_cast<SizeValueType>(index[i] - m_Region.GetIndex(i));
+      offset |= (position & (BlockSize - 1)) << (VBlockSizeLog2 * i);
+    }
+    return offset;
+  }
+
+  /** Release all the blocks. */
+  void
+  ReleaseBlocks();
+
+protected:
+  SparseBlockGrid() = default;
+  ~SparseBlockGrid() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  static constexpr BlockIdentifierType NoBlock = NumericTraits<BlockIdentifierType>::max();
+
+  /** Offset of the block containing the index in the block table. */
+  SizeValueType
+  ComputeBlockOffset(const IndexType & index) const
+  {
+    SizeValueType offset = 0;
+    for (unsigned int i = VDimension; i > 0; --i)
+    {
+      const auto position = static_cast<SizeValueType>(index[i - 1] - m_Region.GetIndex(i - 1));
+      offset = offset * m_NumberOfBlocks[i - 1] + (position >> VBlockSizeLog2);
+    }
+    return offset;
+  }
+
+  RegionType m_Region{};
+  PixelType  m_BackgroundValue{};
+
+  /** Number of blocks along each dimension. */
+  SizeType m_NumberOfBlocks{};
+
+  /** Identifier of the block at each block offset, or NoBlock. */
+  std::vector<BlockIdentifierType> m_BlockTable{};
+
+  /** Block offset of each allocated block. */
+  std::vector<SizeValueType> m_BlockOffsets{};
+
+  /** Pixels of the allocated blocks, one block after the other. */
+  std::vector<PixelType> m_Pixels{};
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkSparseBlockGrid.hxx"
+#endif
+
+#endif
@@ -0,0 +1,103 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSparseBlockGrid_hxx
+#define itkSparseBlockGrid_hxx
+
+#include "itkPrintHelper.h"
+
+namespace itk
+{
+template <typename TPixel, unsigned int VDimension, unsigned int VBlockSizeLog2>
+void
+SparseBlockGrid<TPixel, VDimension, VBlockSizeLog2>::SetRegion(const RegionType & region)
+{
+  m_Region = region;
+
+  SizeValueType numberOfBlocks = 1;
+  for (unsigned int i = 0; i < VDimension; ++i)
+  {
+    m_NumberOfBlocks[i] = (region.GetSize(i) + BlockSize - 1) >> VBlockSizeLog2;
+    numberOfBlocks *= m_NumberOfBlocks[i];
+  }
+
+  std::vector<BlockIdentifierType>(numberOfBlocks, NoBlock).swap(m_BlockTable);
+  std::vector<SizeValueType>().swap(m_BlockOffsets);
+  std::vector<PixelType>().swap(m_Pixels);
+  this->Modified();
+}
+
+template <typename TPixel, unsigned int VDimension, unsigned int VBlockSizeLog2>
+auto
+SparseBlockGrid<TPixel, VDimension, VBlockSizeLog2>::AllocateBlock(const IndexType & index) -> BlockIdentifierType
+{
+  const SizeValueType   blockOffset = this->ComputeBlockOffset(index);
+  BlockIdentifierType & block = m_BlockTable[blockOffset];
+  if (block == NoBlock)
+  {
+    block = static_cast<BlockIdentifierType>(m_BlockOffsets.size());
+    m_BlockOffsets.push_back(blockOffset);
+    m_Pixels.resize(m_Pixels.size() + NumberOfPixelsPerBlock, m_BackgroundValue);
+  }
+  return block;
+}
+
+template <typename TPixel, unsigned int VDimension, unsigned int VBlockSizeLog2>
+auto
+SparseBlockGrid<TPixel, VDimension, VBlockSizeLog2>::GetBlockRegion(BlockIdentifierType block) const -> RegionType
+{
+  SizeValueType blockOffset = m_BlockOffsets[block];
+
+  RegionType blockRegion;
+  for (unsigned int i = 0; i < VDimension; ++i)
+  {
+    const SizeValueType start = (blockOffset % m_NumberOfBlocks[i]) << VBlockSizeLog2;
+    blockOffset /= m_NumberOfBlocks[i];
+
+    blockRegion.SetIndex(i, m_Region.GetIndex(i) + static_cast<OffsetValueType>(start));
+    blockRegion.SetSize(i, std::min<SizeValueType>(BlockSize, m_Region.GetSize(i) - start));
+  }
+  return blockRegion;
+}
+
+template <typename TPixel, unsigned int VDimension, unsigned int VBlockSizeLog2>
+void
+SparseBlockGrid<TPixel, VDimension, VBlockSizeLog2>::ReleaseBlocks()
+{
+  std::fill(m_BlockTable.begin(), m_BlockTable.end(), NoBlock);
+  std::vector<SizeValueType>().swap(m_BlockOffsets);
+  std::vector<PixelType>().swap(m_Pixels);
+  this->Modified();
+}
+
+template <typename TPixel, unsigned int VDimension, unsigned int VBlockSizeLog2>
+void
+SparseBlockGrid<TPixel, VDimension, VBlockSizeLog2>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  using namespace print_helper;
+
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Region: " << m_Region << std::endl;
+  os << indent << "BackgroundValue: " << static_cast<typename NumericTraits<PixelType>::PrintType>(m_BackgroundValue)
+     << std::endl;
+  os << indent << "NumberOfBlocks: " << m_NumberOfBlocks << std::endl;
+  os << indent << "NumberOfAllocatedBlocks: " << this->GetNumberOfAllocatedBlocks() << std::endl;
+}
+} // end namespace itk
+
+#endif
@@ -27,6 +27,12 @@
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkLabelMapToLabelImageFilter.h"
 #include "itkLabelImageToLabelMapFilter.h"
+#include "itkMultiThreaderBase.h"
+#include "itkSparseBlockGrid.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
 
 namespace itk
 {
@@ -34,6 +40,23 @@ namespace itk
  *  \class UpdateWhitakerSparseLevelSet
  *  \brief Base class for updating the level-set function
  *
+ *  The labels of the nodes are only stored, during the update, in the blocks of
+ *  a SparseBlockGrid touching the layers, so that the memory used and the time
+ *  spent converting the label map of the level set are proportional to the
+ *  size of the band rather than to the size of the domain. The values of the
+ *  nodes of the layers are looked up in a hash table keyed by the offset of the
+ *  node in the domain.
+ *  Each layer is updated in two passes over contiguous blocks of its nodes.
+ *  The first pass, run in parallel, computes the new value of each node and
+ *  whether it leaves its layer: it reads the values and labels of the
+ *  neighbors, and finds the value of the node in the hash table. The nodes of
+ *  the zero layer may only move if no neighbor in the zero layer moves in the
+ *  opposite direction before them; this is decided in parallel unless it
+ *  depends on the order in which the neighbors are processed. The second pass
+ *  updates the terms, which are not thread safe, and moves the nodes between
+ *  layers serially in the order of the layers, so that the result does not
+ *  depend on the number of work units.
+ *
  *  \tparam VDimension Dimension of the input space
  *  \tparam TLevelSetValueType Output type (float or double) of the levelset function
  *  \tparam TEquationContainer Container of the system of levelset equations
@@ -124,6 +147,10 @@ public:
   void
   SetUpdate(const LevelSetLayerType & update);
 
+  /** Set/Get the number of work units used to analyze the layers */
+  itkSetClampMacro(NumberOfWorkUnits, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfWorkUnits, ThreadIdType);
+
 protected:
   UpdateWhitakerSparseLevelSet();
   ~UpdateWhitakerSparseLevelSet() override = default;
@@ -179,19 +206,115 @@ private:
   LevelSetPointer   m_InputLevelSet{};
   LevelSetPointer   m_OutputLevelSet{};
 
-  LevelSetPointer   m_TempLevelSet{};
-  LevelSetLayerType m_TempPhi{};
+  LevelSetPointer m_TempLevelSet{};
+
+  /** Values of the nodes of the layers, keyed by their offset in the domain */
+  using TempPhiType = std::unordered_map<OffsetValueType, LevelSetOutputType>;
+  TempPhiType m_TempPhi{};
 
   LevelSetLayerIdType m_MinStatus{};
   LevelSetLayerIdType m_MaxStatus{};
 
-  LabelImagePointer m_InternalImage{};
+  /** Labels of the nodes of the layers and of their neighbors */
+  using LabelGridType = SparseBlockGrid<LevelSetLayerIdType, ImageDimension>;
+  typename LabelGridType::Pointer m_LabelGrid{};
 
   LevelSetOffsetType m_Offset{};
 
-  using NeighborhoodIteratorType = ShapedNeighborhoodIterator<LabelImageType>;
-
   using NodePairType = std::pair<LevelSetInputType, LevelSetOutputType>;
+
+  ThreadIdType               m_NumberOfWorkUnits{};
+  MultiThreaderBase::Pointer m_MultiThreader{};
+
+  /** Summary of the neighborhood of a node computed by
+   * ComputeNeighborhoodSummaries() */
+  struct NeighborhoodSummaryType
+  {
+    LevelSetOutputType   m_Value;
+    bool                 m_HasNeighborInCloserLayer;
+    LevelSetOutputType * m_Phi;
+  };
+
+  /** Change of a node of the zero layer computed by ComputeZeroLayerChanges() */
+  struct ZeroLayerChangeType
+  {
+    LevelSetOutputType   m_Update;
+    LevelSetOutputType   m_Value;
+    LevelSetOutputType * m_Phi;
+    bool                 m_SameDirection;
+    bool                 m_SameDirectionIsKnown;
+  };
+
+  /** Key of a node of the domain in m_TempPhi */
+  OffsetValueType
+  GetTempPhiKey(const LevelSetInputType & index) const
+  {
+    const typename LabelGridType::RegionType & region = this->m_LabelGrid->GetRegion();
+
+    OffsetValueType key = 0;
+    for (unsigned int dim = ImageDimension; dim > 0; --dim)
+    {
+      key = key * static_cast<OffsetValueType>(region.GetSize(dim - 1)) + index[dim - 1] - region.GetIndex(dim - 1);
+    }
+    return key;
+  }
+
+  /** Call a function on each face connected neighbor of a node which is
+   * inside the domain. */
+  template <typename TFunction>
+  void
+  ForEachNeighbor(const LevelSetInputType & index, TFunction && function) const
+  {
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+      for (const OffsetValueType step : { OffsetValueType{ -1 }, OffsetValueType{ 1 } })
+      {
+        LevelSetInputType neighborIndex = index;
+        neighborIndex[dim] += step;
+        if (this->m_LabelGrid->IsInside(neighborIndex))
+        {
+          function(neighborIndex);
+        }
+      }
+    }
+  }
+
+  /** Copy the labels of the label map of the input level set in the blocks of
+   * m_LabelGrid touching the layers. */
+  void
+  CopyLabelMapToLabelGrid();
+
+  /** Copy the labels of m_LabelGrid to the label map of the output level set.
+   * The label map of the input level set is used outside of the blocks of
+   * m_LabelGrid. */
+  void
+  CopyLabelGridToLabelMap();
+
+  /** Find the value of a node in m_TempPhi. Nodes outside of the domain are
+   * never found. */
+  typename TempPhiType::iterator
+  FindTempPhi(const LevelSetInputType & index);
+  typename TempPhiType::const_iterator
+  FindTempPhi(const LevelSetInputType & index) const;
+
+  /** Analyze in parallel the neighborhood of the nodes of a layer. For each
+   * node, in the order of the layer, tell whether a neighbor is in the closer
+   * layer, and compute the largest value (if the closer layer is above the
+   * layer of the nodes) or the smallest value (otherwise) of the neighbors in
+   * the closer layer or beyond. The value of the node in m_TempPhi, if any,
+   * is also found. */
+  void
+  ComputeNeighborhoodSummaries(const LevelSetLayerType &              layer,
+                               LevelSetLayerIdType                    closerLayerId,
+                               bool                                   closerLayerIsAbove,
+                               std::vector<NeighborhoodSummaryType> & summaries);
+
+  /** Compute in parallel the new value of the nodes of the zero layer, in the
+   * order of the layer. For the nodes leaving the zero layer, tell whether
+   * they move in the same direction as their neighbors in the zero layer,
+   * when it does not depend on the neighbors processed before them. */
+  void
+  ComputeZeroLayerChanges(const LevelSetLayerType & layer, std::vector<ZeroLayerChangeType> & changes);
 };
 } // namespace itk
 
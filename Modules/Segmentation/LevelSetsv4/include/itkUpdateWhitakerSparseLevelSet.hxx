@@ -19,7 +19,7 @@
 #ifndef itkUpdateWhitakerSparseLevelSet_hxx
 #define itkUpdateWhitakerSparseLevelSet_hxx
 
-#include "itkConnectedImageNeighborhoodShape.h"
+#include <map>
 
 namespace itk
 {
@@ -30,10 +30,13 @@ UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>
   , m_CurrentLevelSetId(IdentifierType{})
   , m_MinStatus(LevelSetType::MinusThreeLayer())
   , m_MaxStatus(LevelSetType::PlusThreeLayer())
+  , m_NumberOfWorkUnits(MultiThreaderBase::GetGlobalDefaultNumberOfThreads())
 {
   this->m_Offset.Fill(0);
   this->m_TempLevelSet = LevelSetType::New();
   this->m_OutputLevelSet = LevelSetType::New();
+  this->m_MultiThreader = MultiThreaderBase::New();
+  this->m_LabelGrid = LabelGridType::New();
 }
 
 template <unsigned int VDimension, typename TLevelSetValueType, typename TEquationContainer>
@@ -77,78 +80,62 @@ UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>
 
   this->m_OutputLevelSet->SetLabelMap(this->m_InputLevelSet->GetModifiableLabelMap());
 
-  auto labelMapToLabelImageFilter = LabelMapToLabelImageFilterType::New();
-  labelMapToLabelImageFilter->SetInput(this->m_InputLevelSet->GetLabelMap());
-  labelMapToLabelImageFilter->Update();
-
-  this->m_InternalImage = labelMapToLabelImageFilter->GetOutput();
-  this->m_InternalImage->DisconnectPipeline();
+  this->CopyLabelMapToLabelGrid();
 
   this->m_TempPhi.clear();
+  this->m_TempPhi.reserve(this->m_InputLevelSet->GetLayer(LevelSetType::MinusTwoLayer()).size() +
+                          this->m_InputLevelSet->GetLayer(LevelSetType::MinusOneLayer()).size() +
+                          this->m_InputLevelSet->GetLayer(LevelSetType::ZeroLayer()).size() +
+                          this->m_InputLevelSet->GetLayer(LevelSetType::PlusOneLayer()).size() +
+                          this->m_InputLevelSet->GetLayer(LevelSetType::PlusTwoLayer()).size());
 
   // TODO: ARNAUD: Why is 2 not included here?
   // Arnaud: Being iterated upon later, so no need to do it here.
   // Here, we are adding all pairs of indices and levelset values to a map
   for (LevelSetLayerIdType status = LevelSetType::MinusOneLayer(); status < LevelSetType::PlusTwoLayer(); ++status)
   {
-    const LevelSetLayerType layer = this->m_InputLevelSet->GetLayer(status);
+    const LevelSetLayerType & layer = this->m_InputLevelSet->GetLayer(status);
 
     auto it = layer.begin();
     while (it != layer.end())
     {
-      this->m_TempPhi[it->first] = it->second;
+      this->m_TempPhi[this->GetTempPhiKey(it->first)] = it->second;
       ++it;
     }
   }
 
-  /** todo: put neighborhood creation in protected method */
-  ZeroFluxNeumannBoundaryCondition<LabelImageType> spNBC;
-
-  constexpr auto radius = MakeFilled<typename NeighborhoodIteratorType::RadiusType>(1);
-
-  NeighborhoodIteratorType neighIt(radius, this->m_InternalImage, this->m_InternalImage->GetLargestPossibleRegion());
-
-  neighIt.OverrideBoundaryCondition(&spNBC);
-  neighIt.ActivateOffsets(GenerateConnectedImageNeighborhoodShapeOffsets<ImageDimension, 1, false>());
-
   const LevelSetLayerType & layerMinus2 = this->m_InputLevelSet->GetLayer(LevelSetType::MinusTwoLayer());
 
   auto it = layerMinus2.begin();
   while (it != layerMinus2.end())
   {
     const LevelSetInputType currentIndex = it->first;
-    this->m_TempPhi[currentIndex] = LevelSetType::MinusTwoLayer();
-    neighIt.SetLocation(currentIndex);
+    this->m_TempPhi[this->GetTempPhiKey(currentIndex)] = LevelSetType::MinusTwoLayer();
 
-    for (typename NeighborhoodIteratorType::Iterator nIt = neighIt.Begin(); !nIt.IsAtEnd(); ++nIt)
-    {
-      if (nIt.Get() == LevelSetType::MinusThreeLayer())
+    this->ForEachNeighbor(currentIndex, [this](const LevelSetInputType & neighborIndex) {
+      if (this->m_LabelGrid->GetPixel(neighborIndex) == LevelSetType::MinusThreeLayer())
       {
-        const LevelSetInputType neighborIndex = neighIt.GetIndex(nIt.GetNeighborhoodOffset());
-        this->m_TempPhi[neighborIndex] = LevelSetType::MinusThreeLayer();
+        this->m_TempPhi[this->GetTempPhiKey(neighborIndex)] = LevelSetType::MinusThreeLayer();
       }
-    }
+    });
 
     ++it;
   }
 
-  LevelSetLayerType layerPlus2 = this->m_InputLevelSet->GetLayer(LevelSetType::PlusTwoLayer());
+  const LevelSetLayerType & layerPlus2 = this->m_InputLevelSet->GetLayer(LevelSetType::PlusTwoLayer());
 
   it = layerPlus2.begin();
   while (it != layerPlus2.end())
   {
     const LevelSetInputType currentIndex = it->first;
-    this->m_TempPhi[currentIndex] = LevelSetType::PlusTwoLayer();
-    neighIt.SetLocation(currentIndex);
+    this->m_TempPhi[this->GetTempPhiKey(currentIndex)] = LevelSetType::PlusTwoLayer();
 
-    for (typename NeighborhoodIteratorType::Iterator nIt = neighIt.Begin(); !nIt.IsAtEnd(); ++nIt)
-    {
-      if (nIt.Get() == LevelSetType::PlusThreeLayer())
+    this->ForEachNeighbor(currentIndex, [this](const LevelSetInputType & neighborIndex) {
+      if (this->m_LabelGrid->GetPixel(neighborIndex) == LevelSetType::PlusThreeLayer())
       {
-        const LevelSetInputType neighborIndex = neighIt.GetIndex(nIt.GetNeighborhoodOffset());
-        this->m_TempPhi[neighborIndex] = LevelSetType::PlusThreeLayer();
+        this->m_TempPhi[this->GetTempPhiKey(neighborIndex)] = LevelSetType::PlusThreeLayer();
       }
-    }
+    });
 
     ++it;
   }
@@ -165,13 +152,10 @@ UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>
   this->MovePointFromMinus2();
   this->MovePointFromPlus2();
 
-  auto labelImageToLabelMapFilter = LabelImageToLabelMapFilterType::New();
-  labelImageToLabelMapFilter->SetInput(this->m_InternalImage);
-  labelImageToLabelMapFilter->SetBackgroundValue(LevelSetType::PlusThreeLayer());
-  labelImageToLabelMapFilter->Update();
+  this->CopyLabelGridToLabelMap();
 
-  this->m_OutputLevelSet->GetModifiableLabelMap()->Graft(labelImageToLabelMapFilter->GetOutput());
   this->m_TempPhi.clear();
+  this->m_LabelGrid->ReleaseBlocks();
 }
 
 template <unsigned int VDimension, typename TLevelSetValueType, typename TEquationContainer>
@@ -187,162 +171,93 @@ UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>
 
   itkAssertInDebugAndIgnoreInReleaseMacro(this->m_Update.size() == outputLayer0.size());
 
+  std::vector<ZeroLayerChangeType> changes;
+  this->ComputeZeroLayerChanges(outputLayer0, changes);
+
   auto nodeIt = outputLayer0.begin();
   auto nodeEnd = outputLayer0.end();
-
-  auto upIt = this->m_Update.begin();
-
-  ZeroFluxNeumannBoundaryCondition<LabelImageType> spNBC;
-
-  constexpr auto radius = MakeFilled<typename NeighborhoodIteratorType::RadiusType>(1);
-
-  NeighborhoodIteratorType neighIt(radius, this->m_InternalImage, this->m_InternalImage->GetLargestPossibleRegion());
-
-  neighIt.OverrideBoundaryCondition(&spNBC);
-  neighIt.ActivateOffsets(GenerateConnectedImageNeighborhoodShapeOffsets<ImageDimension, 1, false>());
+  auto changeIt = changes.cbegin();
 
   LevelSetInputType inputIndex;
   while (nodeIt != nodeEnd)
   {
-    itkAssertInDebugAndIgnoreInReleaseMacro(nodeIt->first == upIt->first);
-
     const LevelSetInputType currentIndex = nodeIt->first;
     inputIndex = currentIndex + this->m_Offset;
 
-    const LevelSetOutputType currentValue = nodeIt->second;
-    LevelSetOutputType       tempUpdate = this->m_TimeStep * static_cast<LevelSetOutputType>(upIt->second);
+    const ZeroLayerChangeType change = *changeIt;
+    ++changeIt;
 
-    if (tempUpdate > 0.5)
-    {
-      // what about 0.5 - itk::NumericTraits< LevelSetOutputType >::epsilon(); ?
-      tempUpdate = 0.499;
-    }
-    else if (tempUpdate < -0.5)
-    {
-      // what about - ( 0.5 - itk::NumericTraits< LevelSetOutputType >::epsilon(); ) ?
-      tempUpdate = -0.499;
-    }
+    const LevelSetOutputType tempValue = change.m_Value;
+    this->m_RMSChangeAccumulator += change.m_Update * change.m_Update;
 
-    const LevelSetOutputType tempValue = currentValue + tempUpdate;
-    this->m_RMSChangeAccumulator += tempUpdate * tempUpdate;
-
-    if (tempValue > 0.5)
+    if (tempValue > 0.5 || tempValue < -0.5)
     {
-      // is there any point moving in the opposite direction?
-      bool samedirection = true;
+      const bool isAbove = tempValue > 0.5;
 
-      neighIt.SetLocation(currentIndex);
+      // is there any point moving in the opposite direction?
+      bool samedirection = change.m_SameDirection;
 
-      for (typename NeighborhoodIteratorType::Iterator it = neighIt.Begin(); !it.IsAtEnd(); ++it)
+      if (!change.m_SameDirectionIsKnown)
       {
-        if (it.Get() == LevelSetType::ZeroLayer())
-        {
-          const LevelSetInputType tempIndex = neighIt.GetIndex(it.GetNeighborhoodOffset());
-
-          auto tit = this->m_TempPhi.find(tempIndex);
-
-          if (tit != this->m_TempPhi.end())
+        // Look at the values of the neighbors updated so far.
+        samedirection = true;
+        this->ForEachNeighbor(currentIndex, [this, &samedirection, isAbove](const LevelSetInputType & tempIndex) {
+          if (this->m_LabelGrid->GetPixel(tempIndex) == LevelSetType::ZeroLayer())
           {
-            if (tit->second < -0.5)
+            const auto tit = this->FindTempPhi(tempIndex);
+            if (tit != this->m_TempPhi.end())
             {
-              samedirection = false;
+              if (isAbove ? (tit->second < -0.5) : (tit->second > 0.5))
+              {
+                samedirection = false;
+              }
             }
           }
-        }
+        });
       }
 
       if (samedirection)
       {
-        auto tit = this->m_TempPhi.find(currentIndex);
-
-        if (tit != this->m_TempPhi.end())
-        {
-          termContainer->UpdatePixel(inputIndex, tit->second, tempValue);
-          tit->second = tempValue;
+        if (change.m_Phi != nullptr)
+        { // change values
+          termContainer->UpdatePixel(inputIndex, *change.m_Phi, tempValue);
+          *change.m_Phi = tempValue;
         }
         else
         {
           // Kishore: Never comes here?
-          this->m_TempPhi.insert(NodePairType(currentIndex, tempValue));
+          this->m_TempPhi.emplace(this->GetTempPhiKey(currentIndex), tempValue);
         }
 
         auto tempIt = nodeIt;
         ++nodeIt;
-        ++upIt;
         // remove p from Lz
         outputLayer0.erase(tempIt);
 
-        // add p to Sp1
-        layerPlus1.insert(NodePairType(currentIndex, tempValue));
-      }
-      else // samedirection == false
-      {
-        ++nodeIt;
-        ++upIt;
-      }
-    } // end of if( tempValue > 0.5 )
-    else if (tempValue < -0.5)
-    {
-      bool samedirection = true;
-
-      neighIt.SetLocation(currentIndex);
-
-      for (typename NeighborhoodIteratorType::Iterator it = neighIt.Begin(); !it.IsAtEnd(); ++it)
-      {
-        if (it.Get() == LevelSetType::ZeroLayer())
+        // add p to Sp1 or Sn1
+        if (isAbove)
         {
-          const LevelSetInputType tempIndex = neighIt.GetIndex(it.GetNeighborhoodOffset());
-
-          auto tit = this->m_TempPhi.find(tempIndex);
-          if (tit != this->m_TempPhi.end())
-          {
-            if (tit->second > 0.5)
-            {
-              samedirection = false;
-            }
-          }
-        }
-      }
-
-      if (samedirection)
-      {
-        auto tit = this->m_TempPhi.find(currentIndex);
-
-        if (tit != this->m_TempPhi.end())
-        { // change values
-          termContainer->UpdatePixel(inputIndex, tit->second, tempValue);
-          tit->second = tempValue;
+          layerPlus1.insert(NodePairType(currentIndex, tempValue));
         }
         else
-        { // Kishore: Can this happen?
-          this->m_TempPhi.insert(NodePairType(currentIndex, tempValue));
+        {
+          layerMinus1.insert(NodePairType(currentIndex, tempValue));
         }
-
-        auto tempIt = nodeIt;
-        ++nodeIt;
-        ++upIt;
-        outputLayer0.erase(tempIt);
-
-        layerMinus1.insert(NodePairType(currentIndex, tempValue));
       }
       else // samedirection == false
       {
         ++nodeIt;
-        ++upIt;
       }
     }
     else // -0.5 <= temp <= 0.5
     {
-      auto it = this->m_TempPhi.find(currentIndex);
-
-      if (it != this->m_TempPhi.end())
+      if (change.m_Phi != nullptr)
       { // change values
-        termContainer->UpdatePixel(inputIndex, it->second, tempValue);
-        it->second = tempValue;
+        termContainer->UpdatePixel(inputIndex, *change.m_Phi, tempValue);
+        *change.m_Phi = tempValue;
       }
       nodeIt->second = tempValue;
       ++nodeIt;
-      ++upIt;
     }
   } // while( nodeIt != nodeEnd )
 }
@@ -353,22 +268,18 @@ UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>
 {
   const TermContainerPointer termContainer = this->m_EquationContainer->GetEquation(this->m_CurrentLevelSetId);
 
-  ZeroFluxNeumannBoundaryCondition<LabelImageType> spNBC;
-
-  constexpr auto radius = MakeFilled<typename NeighborhoodIteratorType::RadiusType>(1);
-
-  NeighborhoodIteratorType neighIt(radius, this->m_InternalImage, this->m_InternalImage->GetLargestPossibleRegion());
-
-  neighIt.OverrideBoundaryCondition(&spNBC);
-  neighIt.ActivateOffsets(GenerateConnectedImageNeighborhoodShapeOffsets<ImageDimension, 1, false>());
-
   LevelSetLayerType & outputlayerMinus1 = this->m_OutputLevelSet->GetLayer(LevelSetType::MinusOneLayer());
 
   LevelSetLayerType & layerMinusTwo = this->m_TempLevelSet->GetLayer(LevelSetType::MinusTwoLayer());
   LevelSetLayerType & layerZero = this->m_TempLevelSet->GetLayer(LevelSetType::ZeroLayer());
 
+  // compute M and check if point with label 0 exists in the neighborhood
+  std::vector<NeighborhoodSummaryType> summaries;
+  this->ComputeNeighborhoodSummaries(outputlayerMinus1, LevelSetType::ZeroLayer(), true, summaries);
+
   auto nodeIt = outputlayerMinus1.begin();
   auto nodeEnd = outputlayerMinus1.end();
+  auto summaryIt = summaries.cbegin();
 
   LevelSetInputType inputIndex;
 
@@ -377,48 +288,24 @@ UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>
     const LevelSetInputType currentIndex = nodeIt->first;
     inputIndex = currentIndex + this->m_Offset;
 
-    neighIt.SetLocation(currentIndex);
-
-    bool thereIsAPointWithLabelEqualTo0 = false;
-
-    LevelSetOutputType max = NumericTraits<LevelSetOutputType>::NonpositiveMin();
-
-    // compute M and check if point with label 0 exists in the neighborhood
-    for (typename NeighborhoodIteratorType::Iterator it = neighIt.Begin(); !it.IsAtEnd(); ++it)
-    {
-      const LevelSetInputType tempIndex = neighIt.GetIndex(it.GetNeighborhoodOffset());
-
-      const LevelSetLayerIdType label = it.Get();
-
-      if (label >= LevelSetType::ZeroLayer())
-      {
-        if (label == LevelSetType::ZeroLayer())
-        {
-          thereIsAPointWithLabelEqualTo0 = true;
-        }
-
-        auto phiIt = this->m_TempPhi.find(tempIndex);
-        itkAssertInDebugAndIgnoreInReleaseMacro(phiIt != this->m_TempPhi.end());
-
-        max = std::max(max, phiIt->second);
-      }
-    } // end for
+    const NeighborhoodSummaryType summary = *summaryIt;
+    ++summaryIt;
 
-    if (thereIsAPointWithLabelEqualTo0)
+    if (summary.m_HasNeighborInCloserLayer)
     {
-      auto phiIt = this->m_TempPhi.find(currentIndex);
+      LevelSetOutputType * phi = summary.m_Phi;
 
-      max = max - 1.;
+      const LevelSetOutputType max = summary.m_Value - 1.;
 
-      if (phiIt != this->m_TempPhi.end())
+      if (phi != nullptr)
       { // change value
-        termContainer->UpdatePixel(inputIndex, phiIt->second, max);
-        phiIt->second = max;
+        termContainer->UpdatePixel(inputIndex, *phi, max);
+        *phi = max;
         nodeIt->second = max;
       }
       else
       { // Kishore: Can this happen?
-        this->m_TempPhi.insert(NodePairType(currentIndex, max));
+        this->m_TempPhi.emplace(this->GetTempPhiKey(currentIndex), max);
       }
 
       if (max >= -0.5)
@@ -458,15 +345,6 @@ template <unsigned int VDimension, typename TLevelSetValueType, typename TEquati
 void
 UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>::UpdateLayerPlus1()
 {
-  ZeroFluxNeumannBoundaryCondition<LabelImageType> spNBC;
-
-  constexpr auto radius = MakeFilled<typename NeighborhoodIteratorType::RadiusType>(1);
-
-  NeighborhoodIteratorType neighIt(radius, this->m_InternalImage, this->m_InternalImage->GetLargestPossibleRegion());
-
-  neighIt.OverrideBoundaryCondition(&spNBC);
-  neighIt.ActivateOffsets(GenerateConnectedImageNeighborhoodShapeOffsets<ImageDimension, 1, false>());
-
   const TermContainerPointer termContainer = this->m_EquationContainer->GetEquation(this->m_CurrentLevelSetId);
 
   LevelSetLayerType & layerPlus2 = this->m_TempLevelSet->GetLayer(LevelSetType::PlusTwoLayer());
@@ -474,59 +352,36 @@ UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>
 
   LevelSetLayerType & outputLayerPlus1 = this->m_OutputLevelSet->GetLayer(LevelSetType::PlusOneLayer());
 
+  std::vector<NeighborhoodSummaryType> summaries;
+  this->ComputeNeighborhoodSummaries(outputLayerPlus1, LevelSetType::ZeroLayer(), false, summaries);
+
   auto nodeIt = outputLayerPlus1.begin();
   auto nodeEnd = outputLayerPlus1.end();
+  auto summaryIt = summaries.cbegin();
 
   while (nodeIt != nodeEnd)
   {
     const LevelSetInputType currentIndex = nodeIt->first;
     const LevelSetInputType inputIndex = currentIndex + this->m_Offset;
 
-    neighIt.SetLocation(currentIndex);
-
-    bool thereIsAPointWithLabelEqualTo0 = false;
-
-    LevelSetOutputType max = NumericTraits<LevelSetOutputType>::max();
+    const NeighborhoodSummaryType summary = *summaryIt;
+    ++summaryIt;
 
-    for (typename NeighborhoodIteratorType::Iterator it = neighIt.Begin(); !it.IsAtEnd(); ++it)
+    if (summary.m_HasNeighborInCloserLayer)
     {
-      const LevelSetLayerIdType label = it.Get();
-
-      if (label <= LevelSetType::ZeroLayer())
-      {
-        if (label == LevelSetType::ZeroLayer())
-        {
-          thereIsAPointWithLabelEqualTo0 = true;
-        }
-        const LevelSetInputType neighborIndex = neighIt.GetIndex(it.GetNeighborhoodOffset());
+      LevelSetOutputType * phi = summary.m_Phi;
 
-        auto phiIt = this->m_TempPhi.find(neighborIndex);
-        if (phiIt != this->m_TempPhi.end())
-        {
-          max = std::min(max, phiIt->second);
-        }
-        else
-        {
-          itkDebugMacro(<< neighborIndex << "is not in this->m_TempPhi" << std::endl);
-        }
-      }
-    } // end for
+      const LevelSetOutputType max = summary.m_Value + 1.;
 
-    if (thereIsAPointWithLabelEqualTo0)
-    {
-      auto phiIt = this->m_TempPhi.find(currentIndex);
-
-      max = max + 1.;
-
-      if (phiIt != this->m_TempPhi.end())
+      if (phi != nullptr)
       { // change in value
-        termContainer->UpdatePixel(inputIndex, phiIt->second, max);
-        phiIt->second = max;
+        termContainer->UpdatePixel(inputIndex, *phi, max);
+        *phi = max;
         nodeIt->second = max;
       }
       else
       { // Kishore: can this happen?
-        this->m_TempPhi.insert(NodePairType(currentIndex, max));
+        this->m_TempPhi.emplace(this->GetTempPhiKey(currentIndex), max);
       }
 
       if (max <= 0.5)
@@ -563,68 +418,41 @@ template <unsigned int VDimension, typename TLevelSetValueType, typename TEquati
 void
 UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>::UpdateLayerMinus2()
 {
-  ZeroFluxNeumannBoundaryCondition<LabelImageType> spNBC;
-
-  constexpr auto radius = MakeFilled<typename NeighborhoodIteratorType::RadiusType>(1);
-
-  NeighborhoodIteratorType neighIt(radius, this->m_InternalImage, this->m_InternalImage->GetLargestPossibleRegion());
-
-  neighIt.OverrideBoundaryCondition(&spNBC);
-  neighIt.ActivateOffsets(GenerateConnectedImageNeighborhoodShapeOffsets<ImageDimension, 1, false>());
-
   const TermContainerPointer termContainer = this->m_EquationContainer->GetEquation(this->m_CurrentLevelSetId);
 
   LevelSetLayerType & outputLayerMinus2 = this->m_OutputLevelSet->GetLayer(LevelSetType::MinusTwoLayer());
   LevelSetLayerType & layerMinus1 = this->m_TempLevelSet->GetLayer(LevelSetType::MinusOneLayer());
 
+  std::vector<NeighborhoodSummaryType> summaries;
+  this->ComputeNeighborhoodSummaries(outputLayerMinus2, LevelSetType::MinusOneLayer(), true, summaries);
+
   auto       nodeIt = outputLayerMinus2.begin();
   const auto nodeEnd = outputLayerMinus2.end();
+  auto       summaryIt = summaries.cbegin();
 
   while (nodeIt != nodeEnd)
   {
     const LevelSetInputType currentIndex = nodeIt->first;
     const LevelSetInputType inputIndex = currentIndex + this->m_Offset;
 
-    neighIt.SetLocation(currentIndex);
-
-    bool thereIsAPointWithLabelEqualToMinus1 = false;
+    const NeighborhoodSummaryType summary = *summaryIt;
+    ++summaryIt;
 
-    LevelSetOutputType max = NumericTraits<LevelSetOutputType>::NonpositiveMin();
-
-    for (typename NeighborhoodIteratorType::Iterator it = neighIt.Begin(); !it.IsAtEnd(); ++it)
+    if (summary.m_HasNeighborInCloserLayer)
     {
-      const LevelSetLayerIdType label = it.Get();
+      LevelSetOutputType * phi = summary.m_Phi;
 
-      if (label >= LevelSetType::MinusOneLayer())
-      {
-        if (label == LevelSetType::MinusOneLayer())
-        {
-          thereIsAPointWithLabelEqualToMinus1 = true;
-        }
-        const LevelSetInputType neighborIndex = neighIt.GetIndex(it.GetNeighborhoodOffset());
-
-        const auto phiIt = this->m_TempPhi.find(neighborIndex);
-        itkAssertInDebugAndIgnoreInReleaseMacro(phiIt != this->m_TempPhi.end());
-
-        max = std::max(max, phiIt->second);
-      }
-    } // end for
+      const LevelSetOutputType max = summary.m_Value - 1.;
 
-    if (thereIsAPointWithLabelEqualToMinus1)
-    {
-      const auto phiIt = this->m_TempPhi.find(currentIndex);
-
-      max = max - 1.;
-
-      if (phiIt != this->m_TempPhi.end())
+      if (phi != nullptr)
       { // change values
-        termContainer->UpdatePixel(inputIndex, phiIt->second, max);
-        phiIt->second = max;
+        termContainer->UpdatePixel(inputIndex, *phi, max);
+        *phi = max;
         nodeIt->second = max;
       }
       else
       { // Kishore: can this happen?
-        this->m_TempPhi.insert(NodePairType(currentIndex, max));
+        this->m_TempPhi.emplace(this->GetTempPhiKey(currentIndex), max);
       }
 
       if (max >= -1.5) // change layers only
@@ -640,11 +468,11 @@ UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>
         ++nodeIt;
         outputLayerMinus2.erase(tempIt);
 
-        this->m_InternalImage->SetPixel(currentIndex, LevelSetType::MinusThreeLayer());
+        this->m_LabelGrid->SetPixel(currentIndex, LevelSetType::MinusThreeLayer());
 
         termContainer->UpdatePixel(inputIndex, max, LevelSetType::MinusThreeLayer());
 
-        this->m_TempPhi.erase(currentIndex);
+        this->m_TempPhi.erase(this->GetTempPhiKey(currentIndex));
       }
       else
       {
@@ -655,10 +483,10 @@ UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>
     {
       auto tempIt = nodeIt;
       ++nodeIt;
-      this->m_InternalImage->SetPixel(currentIndex, LevelSetType::MinusThreeLayer());
+      this->m_LabelGrid->SetPixel(currentIndex, LevelSetType::MinusThreeLayer());
       termContainer->UpdatePixel(inputIndex, tempIt->second, LevelSetType::MinusThreeLayer());
       outputLayerMinus2.erase(tempIt);
-      this->m_TempPhi.erase(currentIndex);
+      this->m_TempPhi.erase(this->GetTempPhiKey(currentIndex));
     }
   }
 }
@@ -667,71 +495,42 @@ template <unsigned int VDimension, typename TLevelSetValueType, typename TEquati
 void
 UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>::UpdateLayerPlus2()
 {
-  ZeroFluxNeumannBoundaryCondition<LabelImageType> spNBC;
-
-  constexpr auto radius = MakeFilled<typename NeighborhoodIteratorType::RadiusType>(1);
-
-  NeighborhoodIteratorType neighIt(radius, this->m_InternalImage, this->m_InternalImage->GetLargestPossibleRegion());
-
-  neighIt.OverrideBoundaryCondition(&spNBC);
-  neighIt.ActivateOffsets(GenerateConnectedImageNeighborhoodShapeOffsets<ImageDimension, 1, false>());
-
   const TermContainerPointer termContainer = this->m_EquationContainer->GetEquation(this->m_CurrentLevelSetId);
 
   LevelSetLayerType & outputLayerPlus2 = this->m_OutputLevelSet->GetLayer(LevelSetType::PlusTwoLayer());
   LevelSetLayerType & layerPlusOne = this->m_TempLevelSet->GetLayer(LevelSetType::PlusOneLayer());
 
+  std::vector<NeighborhoodSummaryType> summaries;
+  this->ComputeNeighborhoodSummaries(outputLayerPlus2, LevelSetType::PlusOneLayer(), false, summaries);
+
   auto       nodeIt = outputLayerPlus2.begin();
   const auto nodeEnd = outputLayerPlus2.end();
+  auto       summaryIt = summaries.cbegin();
 
   while (nodeIt != nodeEnd)
   {
     const LevelSetInputType currentIndex = nodeIt->first;
     const LevelSetInputType inputIndex = currentIndex + this->m_Offset;
 
-    neighIt.SetLocation(currentIndex);
-
-    bool               thereIsAPointWithLabelEqualToPlus1 = false;
-    LevelSetOutputType max = NumericTraits<LevelSetOutputType>::max();
+    const NeighborhoodSummaryType summary = *summaryIt;
+    ++summaryIt;
 
-    for (typename NeighborhoodIteratorType::Iterator it = neighIt.Begin(); !it.IsAtEnd(); ++it)
+    if (summary.m_HasNeighborInCloserLayer)
     {
-      const LevelSetLayerIdType label = it.Get();
-      if (label <= LevelSetType::PlusOneLayer())
-      {
-        if (label == LevelSetType::PlusOneLayer())
-        {
-          thereIsAPointWithLabelEqualToPlus1 = true;
-        }
-        const LevelSetInputType neighborIndex = neighIt.GetIndex(it.GetNeighborhoodOffset());
-        auto                    phiIt = this->m_TempPhi.find(neighborIndex);
-        if (phiIt != this->m_TempPhi.end())
-        {
-          max = std::min(max, phiIt->second);
-        }
-        else
-        {
-          itkDebugMacro(<< neighborIndex << " is not in this->m_TempPhi" << std::endl);
-        }
-      }
-    }
-
-    if (thereIsAPointWithLabelEqualToPlus1)
-    {
-      auto phiIt = this->m_TempPhi.find(currentIndex);
+      LevelSetOutputType * phi = summary.m_Phi;
 
-      max = max + 1.;
+      const LevelSetOutputType max = summary.m_Value + 1.;
 
-      if (phiIt != this->m_TempPhi.end()) // change values
+      if (phi != nullptr) // change values
       {
-        termContainer->UpdatePixel(inputIndex, phiIt->second, max);
-        phiIt->second = max;
+        termContainer->UpdatePixel(inputIndex, *phi, max);
+        *phi = max;
         nodeIt->second = max;
       }
       else
       // todo: remove dead code
       { // Kishore: can this happen?
-        this->m_TempPhi.insert(NodePairType(currentIndex, max));
+        this->m_TempPhi.emplace(this->GetTempPhiKey(currentIndex), max);
       }
 
       if (max <= 1.5) // change layers
@@ -746,11 +545,11 @@ UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>
         auto tempIt = nodeIt;
         ++nodeIt;
         outputLayerPlus2.erase(tempIt);
-        this->m_InternalImage->SetPixel(currentIndex, LevelSetType::PlusThreeLayer());
+        this->m_LabelGrid->SetPixel(currentIndex, LevelSetType::PlusThreeLayer());
 
         termContainer->UpdatePixel(inputIndex, max, LevelSetType::PlusThreeLayer());
 
-        this->m_TempPhi.erase(currentIndex);
+        this->m_TempPhi.erase(this->GetTempPhiKey(currentIndex));
       }
       else
       {
@@ -761,10 +560,10 @@ UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>
     {
       auto tempIt = nodeIt;
       ++nodeIt;
-      this->m_InternalImage->SetPixel(currentIndex, LevelSetType::PlusThreeLayer());
+      this->m_LabelGrid->SetPixel(currentIndex, LevelSetType::PlusThreeLayer());
       termContainer->UpdatePixel(inputIndex, tempIt->second, LevelSetType::PlusThreeLayer());
       outputLayerPlus2.erase(tempIt);
-      this->m_TempPhi.erase(currentIndex);
+      this->m_TempPhi.erase(this->GetTempPhiKey(currentIndex));
     }
   }
 }
@@ -782,7 +581,7 @@ UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>
   while (nodeIt != nodeEnd)
   {
     outputLayer0.insert(NodePairType(nodeIt->first, nodeIt->second));
-    this->m_InternalImage->SetPixel(nodeIt->first, LevelSetType::ZeroLayer());
+    this->m_LabelGrid->SetPixel(nodeIt->first, LevelSetType::ZeroLayer());
 
     auto tempIt = nodeIt;
     ++nodeIt;
@@ -794,15 +593,6 @@ template <unsigned int VDimension, typename TLevelSetValueType, typename TEquati
 void
 UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>::MovePointFromMinus1()
 {
-  ZeroFluxNeumannBoundaryCondition<LabelImageType> spNBC;
-
-  constexpr auto radius = MakeFilled<typename NeighborhoodIteratorType::RadiusType>(1);
-
-  NeighborhoodIteratorType neighIt(radius, this->m_InternalImage, this->m_InternalImage->GetLargestPossibleRegion());
-
-  neighIt.OverrideBoundaryCondition(&spNBC);
-  neighIt.ActivateOffsets(GenerateConnectedImageNeighborhoodShapeOffsets<ImageDimension, 1, false>());
-
   const TermContainerPointer termContainer = this->m_EquationContainer->GetEquation(this->m_CurrentLevelSetId);
 
   LevelSetLayerType & layerMinus1 = this->m_TempLevelSet->GetLayer(LevelSetType::MinusOneLayer());
@@ -820,30 +610,26 @@ UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>
 
     outputlayerMinus1.insert(NodePairType(currentIndex, currentValue));
 
-    this->m_InternalImage->SetPixel(currentIndex, LevelSetType::MinusOneLayer());
+    this->m_LabelGrid->SetPixel(currentIndex, LevelSetType::MinusOneLayer());
 
     auto tempIt = nodeIt;
     ++nodeIt;
     layerMinus1.erase(tempIt);
 
-    neighIt.SetLocation(currentIndex);
-
-    for (typename NeighborhoodIteratorType::Iterator it = neighIt.Begin(); !it.IsAtEnd(); ++it)
-    {
-      const LevelSetInputType tempIndex = neighIt.GetIndex(it.GetNeighborhoodOffset());
-
-      auto phiIt = this->m_TempPhi.find(tempIndex);
-      if (phiIt != this->m_TempPhi.end())
-      {
-        if (Math::ExactlyEquals(phiIt->second, -3.)) // change values
+    this->ForEachNeighbor(
+      currentIndex, [this, &termContainer, &layerMinus2, currentValue](const LevelSetInputType & tempIndex) {
+        auto phiIt = this->FindTempPhi(tempIndex);
+        if (phiIt != this->m_TempPhi.end())
         {
-          phiIt->second = currentValue - 1;
-          layerMinus2.insert(NodePairType(tempIndex, currentValue - 1));
+          if (Math::ExactlyEquals(phiIt->second, -3.)) // change values
+          {
+            phiIt->second = currentValue - 1;
+            layerMinus2.insert(NodePairType(tempIndex, currentValue - 1));
 
-          termContainer->UpdatePixel(tempIndex + m_Offset, LevelSetType::MinusThreeLayer(), phiIt->second);
+            termContainer->UpdatePixel(tempIndex + m_Offset, LevelSetType::MinusThreeLayer(), phiIt->second);
+          }
         }
-      }
-    }
+      });
   }
 }
 
@@ -851,15 +637,6 @@ template <unsigned int VDimension, typename TLevelSetValueType, typename TEquati
 void
 UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>::MovePointFromPlus1()
 {
-  ZeroFluxNeumannBoundaryCondition<LabelImageType> spNBC;
-
-  constexpr auto radius = MakeFilled<typename NeighborhoodIteratorType::RadiusType>(1);
-
-  NeighborhoodIteratorType neighIt(radius, this->m_InternalImage, this->m_InternalImage->GetLargestPossibleRegion());
-
-  neighIt.OverrideBoundaryCondition(&spNBC);
-  neighIt.ActivateOffsets(GenerateConnectedImageNeighborhoodShapeOffsets<ImageDimension, 1, false>());
-
   const TermContainerPointer termContainer = this->m_EquationContainer->GetEquation(this->m_CurrentLevelSetId);
 
   LevelSetLayerType & layerPlus1 = this->m_TempLevelSet->GetLayer(LevelSetType::PlusOneLayer());
@@ -876,31 +653,27 @@ UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>
     const LevelSetOutputType currentValue = nodeIt->second;
 
     outputLayerPlus1.insert(NodePairType(currentIndex, currentValue));
-    this->m_InternalImage->SetPixel(currentIndex, LevelSetType::PlusOneLayer());
+    this->m_LabelGrid->SetPixel(currentIndex, LevelSetType::PlusOneLayer());
 
     auto tempIt = nodeIt;
     ++nodeIt;
     layerPlus1.erase(tempIt);
 
-    neighIt.SetLocation(currentIndex);
-
-    for (typename NeighborhoodIteratorType::Iterator it = neighIt.Begin(); !it.IsAtEnd(); ++it)
-    {
-      const LevelSetInputType tempIndex = neighIt.GetIndex(it.GetNeighborhoodOffset());
-
-      auto phiIt = this->m_TempPhi.find(tempIndex);
-      if (phiIt != this->m_TempPhi.end())
-      {
-        if (phiIt->second == 3.)
-        { // change values here
-          phiIt->second = currentValue + 1;
+    this->ForEachNeighbor(
+      currentIndex, [this, &termContainer, &layerPlus2, currentValue](const LevelSetInputType & tempIndex) {
+        auto phiIt = this->FindTempPhi(tempIndex);
+        if (phiIt != this->m_TempPhi.end())
+        {
+          if (phiIt->second == 3.)
+          { // change values here
+            phiIt->second = currentValue + 1;
 
-          layerPlus2.insert(NodePairType(tempIndex, currentValue + 1));
+            layerPlus2.insert(NodePairType(tempIndex, currentValue + 1));
 
-          termContainer->UpdatePixel(tempIndex + m_Offset, 3, phiIt->second);
+            termContainer->UpdatePixel(tempIndex + m_Offset, 3, phiIt->second);
+          }
         }
-      }
-    }
+      });
   }
 }
 
@@ -920,7 +693,7 @@ UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>
 
     outputLayerMinus2.insert(NodePairType(currentIndex, nodeIt->second));
 
-    this->m_InternalImage->SetPixel(currentIndex, LevelSetType::MinusTwoLayer());
+    this->m_LabelGrid->SetPixel(currentIndex, LevelSetType::MinusTwoLayer());
 
     auto tempIt = nodeIt;
     ++nodeIt;
@@ -943,12 +716,371 @@ UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>
     const LevelSetInputType currentIndex = nodeIt->first;
 
     outputLayerPlus2.insert(NodePairType(currentIndex, nodeIt->second));
-    this->m_InternalImage->SetPixel(currentIndex, LevelSetType::PlusTwoLayer());
+    this->m_LabelGrid->SetPixel(currentIndex, LevelSetType::PlusTwoLayer());
 
     auto tempIt = nodeIt;
     ++nodeIt;
     layerPlus2.erase(tempIt);
   }
 }
+
+template <unsigned int VDimension, typename TLevelSetValueType, typename TEquationContainer>
+auto
+UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>::FindTempPhi(
+  const LevelSetInputType & index) -> typename TempPhiType::iterator
+{
+  if (!this->m_LabelGrid->IsInside(index))
+  {
+    return this->m_TempPhi.end();
+  }
+  return this->m_TempPhi.find(this->GetTempPhiKey(index));
+}
+
+template <unsigned int VDimension, typename TLevelSetValueType, typename TEquationContainer>
+auto
+UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>::FindTempPhi(
+  const LevelSetInputType & index) const -> typename TempPhiType::const_iterator
+{
+  if (!this->m_LabelGrid->IsInside(index))
+  {
+    return this->m_TempPhi.end();
+  }
+  return this->m_TempPhi.find(this->GetTempPhiKey(index));
+}
+
+template <unsigned int VDimension, typename TLevelSetValueType, typename TEquationContainer>
+void
+UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>::ComputeNeighborhoodSummaries(
+  const LevelSetLayerType &              layer,
+  LevelSetLayerIdType                    closerLayerId,
+  bool                                   closerLayerIsAbove,
+  std::vector<NeighborhoodSummaryType> & summaries)
+{
+  std::vector<LevelSetInputType> indices;
+  indices.reserve(layer.size());
+  for (const auto & node : layer)
+  {
+    indices.push_back(node.first);
+  }
+  summaries.resize(indices.size());
+
+  // Each work unit analyzes whole blocks of consecutive nodes.
+  constexpr SizeValueType blockSize = 1024;
+  const SizeValueType     numberOfBlocks = (indices.size() + blockSize - 1) / blockSize;
+
+  this->m_MultiThreader->SetNumberOfWorkUnits(this->m_NumberOfWorkUnits);
+  this->m_MultiThreader->ParallelizeArray(
+    0,
+    numberOfBlocks,
+    [this, &indices, &summaries, closerLayerId, closerLayerIsAbove](SizeValueType block) {
+      const SizeValueType end = std::min<SizeValueType>((block + 1) * blockSize, indices.size());
+      for (SizeValueType i = block * blockSize; i < end; ++i)
+      {
+        NeighborhoodSummaryType summary;
+        summary.m_Value = closerLayerIsAbove ? NumericTraits<LevelSetOutputType>::NonpositiveMin()
+                                             : NumericTraits<LevelSetOutputType>::max();
+        summary.m_HasNeighborInCloserLayer = false;
+
+        const auto nodePhiIt = this->FindTempPhi(indices[i]);
+        summary.m_Phi = nodePhiIt != this->m_TempPhi.end() ? &nodePhiIt->second : nullptr;
+
+        this->ForEachNeighbor(indices[i], [this, &summary, closerLayerId, closerLayerIsAbove](
+                                            const LevelSetInputType & neighborIndex) {
+          const LevelSetLayerIdType label = this->m_LabelGrid->GetPixel(neighborIndex);
+
+          if (closerLayerIsAbove ? (label >= closerLayerId) : (label <= closerLayerId))
+          {
+            if (label == closerLayerId)
+            {
+              summary.m_HasNeighborInCloserLayer = true;
+            }
+
+            const auto phiIt = this->FindTempPhi(neighborIndex);
+            if (phiIt != this->m_TempPhi.end())
+            {
+              summary.m_Value = closerLayerIsAbove ? std::max(summary.m_Value, phiIt->second)
+                                                   : std::min(summary.m_Value, phiIt->second);
+            }
+          }
+        });
+        summaries[i] = summary;
+      }
+    },
+    nullptr);
+}
+
+template <unsigned int VDimension, typename TLevelSetValueType, typename TEquationContainer>
+void
+UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>::ComputeZeroLayerChanges(
+  const LevelSetLayerType &          layer,
+  std::vector<ZeroLayerChangeType> & changes)
+{
+  std::vector<LevelSetInputType> indices;
+  indices.reserve(layer.size());
+  changes.resize(layer.size());
+
+  auto upIt = this->m_Update.cbegin();
+  for (const auto & node : layer)
+  {
+    itkAssertInDebugAndIgnoreInReleaseMacro(node.first == upIt->first);
+
+    ZeroLayerChangeType & change = changes[indices.size()];
+    change.m_Update = this->m_TimeStep * static_cast<LevelSetOutputType>(upIt->second);
+
+    if (change.m_Update > 0.5)
+    {
+      // what about 0.5 - itk::NumericTraits< LevelSetOutputType >::epsilon(); ?
+      change.m_Update = 0.499;
+    }
+    else if (change.m_Update < -0.5)
+    {
+      // what about - ( 0.5 - itk::NumericTraits< LevelSetOutputType >::epsilon(); ) ?
+      change.m_Update = -0.499;
+    }
+
+    change.m_Value = node.second + change.m_Update;
+    indices.push_back(node.first);
+    ++upIt;
+  }
+
+  const typename LevelSetLayerType::key_compare compare = layer.key_comp();
+
+  // Each work unit handles whole blocks of consecutive nodes.
+  constexpr SizeValueType blockSize = 1024;
+  const SizeValueType     numberOfBlocks = (indices.size() + blockSize - 1) / blockSize;
+
+  this->m_MultiThreader->SetNumberOfWorkUnits(this->m_NumberOfWorkUnits);
+  this->m_MultiThreader->ParallelizeArray(
+    0,
+    numberOfBlocks,
+    [this, &indices, &changes, &compare](SizeValueType block) {
+      const SizeValueType end = std::min<SizeValueType>((block + 1) * blockSize, indices.size());
+      for (SizeValueType i = block * blockSize; i < end; ++i)
+      {
+        ZeroLayerChangeType & change = changes[i];
+
+        const auto phiIt = this->FindTempPhi(indices[i]);
+        change.m_Phi = phiIt != this->m_TempPhi.end() ? &phiIt->second : nullptr;
+        change.m_SameDirection = true;
+        change.m_SameDirectionIsKnown = true;
+
+        if (change.m_Value <= 0.5 && change.m_Value >= -0.5)
+        {
+          continue;
+        }
+
+        const bool isAbove = change.m_Value > 0.5;
+        const auto isOpposite = [isAbove](const LevelSetOutputType value) {
+          return isAbove ? (value < -0.5) : (value > 0.5);
+        };
+
+        // When the node is processed, a neighbor in the zero layer holds either
+        // its current value or, if it was processed before, its new value.
+        this->ForEachNeighbor(indices[i], [&](const LevelSetInputType & neighborIndex) {
+          if (this->m_LabelGrid->GetPixel(neighborIndex) != LevelSetType::ZeroLayer())
+          {
+            return;
+          }
+
+          const auto neighborIt = std::lower_bound(indices.cbegin(), indices.cend(), neighborIndex, compare);
+          const bool isInLayer = neighborIt != indices.cend() && !compare(neighborIndex, *neighborIt);
+          const bool newValueIsOpposite = isInLayer && isOpposite(changes[neighborIt - indices.cbegin()].m_Value);
+
+          const auto neighborPhiIt = this->FindTempPhi(neighborIndex);
+          const bool currentValueIsOpposite =
+            neighborPhiIt != this->m_TempPhi.end() && isOpposite(neighborPhiIt->second);
+
+          if (currentValueIsOpposite && (!isInLayer || newValueIsOpposite))
+          {
+            change.m_SameDirection = false;
+          }
+          else if (currentValueIsOpposite || newValueIsOpposite)
+          {
+            change.m_SameDirectionIsKnown = false;
+          }
+        });
+
+        if (!change.m_SameDirection)
+        {
+          change.m_SameDirectionIsKnown = true;
+        }
+      }
+    },
+    nullptr);
+}
+
+template <unsigned int VDimension, typename TLevelSetValueType, typename TEquationContainer>
+void
+UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>::CopyLabelMapToLabelGrid()
+{
+  const LevelSetLabelMapType * labelMap = this->m_InputLevelSet->GetLabelMap();
+
+  this->m_LabelGrid->SetBackgroundValue(labelMap->GetBackgroundValue());
+  this->m_LabelGrid->SetRegion(labelMap->GetLargestPossibleRegion());
+
+  // Only the labels of the nodes of the layers and of their neighbors are
+  // read or written during the update.
+  for (LevelSetLayerIdType status = LevelSetType::MinusTwoLayer(); status <= LevelSetType::PlusTwoLayer(); ++status)
+  {
+    for (const auto & node : this->m_InputLevelSet->GetLayer(status))
+    {
+      this->m_LabelGrid->AllocateBlock(node.first);
+      this->ForEachNeighbor(node.first, [this](const LevelSetInputType & neighborIndex) {
+        this->m_LabelGrid->AllocateBlock(neighborIndex);
+      });
+    }
+  }
+
+  const OffsetValueType regionStart = this->m_LabelGrid->GetRegion().GetIndex(0);
+  const auto            blockSize = static_cast<OffsetValueType>(LabelGridType::BlockSize);
+
+  for (typename LevelSetLabelMapType::ConstIterator it(labelMap); !it.IsAtEnd(); ++it)
+  {
+    const LevelSetLayerIdType       label = it.GetLabel();
+    const LevelSetLabelObjectType * labelObject = it.GetLabelObject();
+
+    for (SizeValueType i = 0; i < labelObject->GetNumberOfLines(); ++i)
+    {
+      const LevelSetLabelObjectLineType & line = labelObject->GetLine(i);
+
+      LevelSetInputType     index = line.GetIndex();
+      const OffsetValueType lineEnd = index[0] + static_cast<OffsetValueType>(line.GetLength());
+
+      // Paint the line block by block, skipping the blocks which are not
+      // allocated.
+      while (index[0] < lineEnd)
+      {
+        const OffsetValueType blockEnd =
+          std::min(lineEnd, regionStart + ((index[0] - regionStart) / blockSize + 1) * blockSize);
+        if (this->m_LabelGrid->IsBlockAllocated(index))
+        {
+          for (; index[0] < blockEnd; ++index[0])
+          {
+            this->m_LabelGrid->SetPixel(index, label);
+          }
+        }
+        index[0] = blockEnd;
+      }
+    }
+  }
+}
+
+template <unsigned int VDimension, typename TLevelSetValueType, typename TEquationContainer>
+void
+UpdateWhitakerSparseLevelSet<VDimension, TLevelSetValueType, TEquationContainer>::CopyLabelGridToLabelMap()
+{
+  // The label map of the input level set is also the one of the output level
+  // set: its lines are read before the new label map is grafted.
+  const LevelSetLabelMapType * inputLabelMap = this->m_InputLevelSet->GetLabelMap();
+
+  auto labelMap = LevelSetLabelMapType::New();
+  labelMap->CopyInformation(inputLabelMap);
+  labelMap->SetRegions(inputLabelMap->GetLargestPossibleRegion());
+  labelMap->SetBackgroundValue(LevelSetType::PlusThreeLayer());
+
+  std::map<LevelSetLayerIdType, LevelSetLabelObjectPointer> labelObjects;
+
+  auto getLabelObject = [&labelObjects](const LevelSetLayerIdType label) -> LevelSetLabelObjectType * {
+    LevelSetLabelObjectPointer & labelObject = labelObjects[label];
+    if (labelObject.IsNull())
+    {
+      labelObject = LevelSetLabelObjectType::New();
+      labelObject->SetLabel(label);
+    }
+    return labelObject.GetPointer();
+  };
+
+  const OffsetValueType regionStart = this->m_LabelGrid->GetRegion().GetIndex(0);
+  const auto            blockSize = static_cast<OffsetValueType>(LabelGridType::BlockSize);
+
+  // Outside of the blocks of the grid, the labels did not change.
+  for (typename LevelSetLabelMapType::ConstIterator it(inputLabelMap); !it.IsAtEnd(); ++it)
+  {
+    const LevelSetLayerIdType       label = it.GetLabel();
+    const LevelSetLabelObjectType * inputLabelObject = it.GetLabelObject();
+
+    if (label == LevelSetType::PlusThreeLayer())
+    {
+      continue;
+    }
+
+    for (SizeValueType i = 0; i < inputLabelObject->GetNumberOfLines(); ++i)
+    {
+      const LevelSetLabelObjectLineType & line = inputLabelObject->GetLine(i);
+
+      LevelSetInputType     index = line.GetIndex();
+      const OffsetValueType lineEnd = index[0] + static_cast<OffsetValueType>(line.GetLength());
+
+      while (index[0] < lineEnd)
+      {
+        const OffsetValueType blockEnd =
+          std::min(lineEnd, regionStart + ((index[0] - regionStart) / blockSize + 1) * blockSize);
+        if (!this->m_LabelGrid->IsBlockAllocated(index))
+        {
+          getLabelObject(label)->AddLine(index, static_cast<LevelSetLabelObjectLengthType>(blockEnd - index[0]));
+        }
+        index[0] = blockEnd;
+      }
+    }
+  }
+
+  // In the blocks of the grid, add the runs of labels along the first
+  // dimension.
+  for (typename LabelGridType::BlockIdentifierType block = 0; block < this->m_LabelGrid->GetNumberOfAllocatedBlocks();
+       ++block)
+  {
+    const typename LabelGridType::RegionType blockRegion = this->m_LabelGrid->GetBlockRegion(block);
+    const LevelSetLayerIdType *              buffer = this->m_LabelGrid->GetBlockBuffer(block);
+
+    typename LabelGridType::RegionType rowRegion = blockRegion;
+    rowRegion.SetSize(0, 1);
+
+    const OffsetValueType rowStart = blockRegion.GetIndex(0);
+    const OffsetValueType rowEnd = rowStart + static_cast<OffsetValueType>(blockRegion.GetSize(0));
+
+    LevelSetInputType rowIndex = rowRegion.GetIndex();
+    const SizeValueType numberOfRows = rowRegion.GetNumberOfPixels();
+    for (SizeValueType row = 0; row < numberOfRows; ++row)
+    {
+      const LevelSetLayerIdType * rowBuffer = buffer + this->m_LabelGrid->ComputeOffsetInBlock(rowIndex);
+
+      LevelSetInputType runIndex = rowIndex;
+      OffsetValueType   x = rowStart;
+      while (x < rowEnd)
+      {
+        const LevelSetLayerIdType label = rowBuffer[x - rowStart];
+        OffsetValueType           runEnd = x + 1;
+        while (runEnd < rowEnd && rowBuffer[runEnd - rowStart] == label)
+        {
+          ++runEnd;
+        }
+        if (label != LevelSetType::PlusThreeLayer())
+        {
+          runIndex[0] = x;
+          getLabelObject(label)->AddLine(runIndex, static_cast<LevelSetLabelObjectLengthType>(runEnd - x));
+        }
+        x = runEnd;
+      }
+
+      // Go to the next row of the block.
+      for (unsigned int dim = 1; dim < ImageDimension; ++dim)
+      {
+        if (++rowIndex[dim] < blockRegion.GetIndex(dim) + static_cast<OffsetValueType>(blockRegion.GetSize(dim)))
+        {
+          break;
+        }
+        rowIndex[dim] = blockRegion.GetIndex(dim);
+      }
+    }
+  }
+
+  for (auto & labelObject : labelObjects)
+  {
+    labelObject.second->Optimize();
+    labelMap->AddLabelObject(labelObject.second);
+  }
+
+  this->m_OutputLevelSet->GetModifiableLabelMap()->Graft(labelMap);
+}
 } // namespace itk
 #endif // itkUpdateWhitakerSparseLevelSet_hxx
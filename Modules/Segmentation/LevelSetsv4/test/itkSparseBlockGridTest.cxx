@@ -0,0 +1,143 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkSparseBlockGrid.h"
+#include "itkImage.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+#include <iostream>
+
+/* Compare the pixels of a SparseBlockGrid with the pixels of an image set
+ * in the same way. */
+int
+itkSparseBlockGridTest(int, char *[])
+{
+  constexpr unsigned int Dimension = 3;
+  using PixelType = short;
+  using GridType = itk::SparseBlockGrid<PixelType, Dimension>;
+  using ImageType = itk::Image<PixelType, Dimension>;
+
+  auto grid = GridType::New();
+
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(grid, SparseBlockGrid, Object);
+
+  ITK_TEST_EXPECT_EQUAL(GridType::BlockSize, 8);
+  ITK_TEST_EXPECT_EQUAL(GridType::NumberOfPixelsPerBlock, 512);
+
+  // A region which does not start at 0, and whose size is not a multiple of
+  // the block size.
+  constexpr ImageType::IndexType regionIndex = { { -3, 5, 2 } };
+  constexpr ImageType::SizeType  regionSize = { { 19, 10, 17 } };
+  const ImageType::RegionType    region(regionIndex, regionSize);
+
+  constexpr PixelType backgroundValue = 3;
+  grid->SetBackgroundValue(backgroundValue);
+  ITK_TEST_SET_GET_VALUE(backgroundValue, grid->GetBackgroundValue());
+  grid->SetRegion(region);
+  ITK_TEST_SET_GET_VALUE(region, grid->GetRegion());
+  ITK_TEST_EXPECT_EQUAL(grid->GetNumberOfAllocatedBlocks(), 0);
+
+  auto image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  image->FillBuffer(backgroundValue);
+
+  // Set the pixels of a spherical shell.
+  PixelType value = 0;
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType index = it.GetIndex();
+    double                     squaredRadius = 0.0;
+    for (unsigned int i = 0; i < Dimension; ++i)
+    {
+      const double d = index[i] - (regionIndex[i] + 0.5 * regionSize[i]);
+      squaredRadius += d * d;
+    }
+    if (squaredRadius > 16.0 && squaredRadius < 25.0)
+    {
+      image->SetPixel(index, value);
+      grid->SetPixel(index, value);
+      value = static_cast<PixelType>((value + 7) % 101 - 50);
+    }
+  }
+
+  // Blocks: 3 along x, 2 along y, 3 along z.
+  ITK_TEST_EXPECT_TRUE(grid->GetNumberOfAllocatedBlocks() > 0);
+  ITK_TEST_EXPECT_TRUE(grid->GetNumberOfAllocatedBlocks() <= 3 * 2 * 3);
+
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    if (grid->GetPixel(it.GetIndex()) != it.Get())
+    {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Error in GetPixel at index " << it.GetIndex() << std::endl;
+      std::cerr << "Expected value " << it.Get() << ", but got " << grid->GetPixel(it.GetIndex()) << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // The block regions are cropped by the region of the grid, do not overlap,
+  // and the block buffers hold the pixels of the blocks.
+  itk::SizeValueType numberOfPixelsInBlocks = 0;
+  for (GridType::BlockIdentifierType block = 0; block < grid->GetNumberOfAllocatedBlocks(); ++block)
+  {
+    const ImageType::RegionType blockRegion = grid->GetBlockRegion(block);
+    if (!region.IsInside(blockRegion))
+    {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Block region " << blockRegion << " is not inside the grid region" << std::endl;
+      return EXIT_FAILURE;
+    }
+    numberOfPixelsInBlocks += blockRegion.GetNumberOfPixels();
+
+    const PixelType * buffer = grid->GetBlockBuffer(block);
+    for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(image, blockRegion); !it.IsAtEnd(); ++it)
+    {
+      ITK_TEST_EXPECT_TRUE(grid->IsBlockAllocated(it.GetIndex()));
+      if (buffer[grid->ComputeOffsetInBlock(it.GetIndex())] != it.Get())
+      {
+        std::cerr << "Test failed!" << std::endl;
+        std::cerr << "Error in block buffer at index " << it.GetIndex() << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  ITK_TEST_EXPECT_TRUE(numberOfPixelsInBlocks <= region.GetNumberOfPixels());
+
+  ITK_TEST_EXPECT_TRUE(grid->IsInside(regionIndex));
+  ITK_TEST_EXPECT_TRUE(!grid->IsInside(regionIndex - ImageType::OffsetType{ { 1, 0, 0 } }));
+
+  // Allocating a block fills it with the background value.
+  constexpr ImageType::IndexType cornerIndex = { { 15, 14, 18 } };
+  ITK_TEST_EXPECT_TRUE(!grid->IsBlockAllocated(cornerIndex));
+  const GridType::BlockIdentifierType cornerBlock = grid->AllocateBlock(cornerIndex);
+  ITK_TEST_EXPECT_EQUAL(cornerBlock, grid->GetNumberOfAllocatedBlocks() - 1);
+  ITK_TEST_EXPECT_EQUAL(cornerBlock, grid->AllocateBlock(cornerIndex));
+  ITK_TEST_EXPECT_EQUAL(grid->GetPixel(cornerIndex), backgroundValue);
+  const ImageType::RegionType cornerRegion = grid->GetBlockRegion(cornerBlock);
+  ITK_TEST_EXPECT_EQUAL(cornerRegion.GetIndex(), (ImageType::IndexType{ { 13, 13, 18 } }));
+  ITK_TEST_EXPECT_EQUAL(cornerRegion.GetSize(), (ImageType::SizeType{ { 3, 2, 1 } }));
+
+  grid->ReleaseBlocks();
+  ITK_TEST_EXPECT_EQUAL(grid->GetNumberOfAllocatedBlocks(), 0);
+  ITK_TEST_EXPECT_EQUAL(grid->GetPixel(cornerIndex), backgroundValue);
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
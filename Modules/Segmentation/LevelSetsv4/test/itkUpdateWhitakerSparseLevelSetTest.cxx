@@ -0,0 +1,214 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkLevelSetContainer.h"
+#include "itkLevelSetEquationChanAndVeseInternalTerm.h"
+#include "itkLevelSetEquationChanAndVeseExternalTerm.h"
+#include "itkLevelSetEquationCurvatureTerm.h"
+#include "itkLevelSetEquationTermContainer.h"
+#include "itkLevelSetEquationContainer.h"
+#include "itkSinRegularizedHeavisideStepFunction.h"
+#include "itkLevelSetEvolution.h"
+#include "itkBinaryImageToLevelSetImageAdaptor.h"
+#include "itkLevelSetEvolutionNumberOfIterationsStoppingCriterion.h"
+#include "itkUpdateWhitakerSparseLevelSet.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+
+using InputPixelType = unsigned short;
+using InputImageType = itk::Image<InputPixelType, Dimension>;
+
+using PixelType = float;
+
+using SparseLevelSetType = itk::WhitakerSparseLevelSetImage<PixelType, Dimension>;
+using BinaryToSparseAdaptorType = itk::BinaryImageToLevelSetImageAdaptor<InputImageType, SparseLevelSetType>;
+
+using LevelSetContainerType = itk::LevelSetContainer<itk::IdentifierType, SparseLevelSetType>;
+
+using ChanAndVeseInternalTermType = itk::LevelSetEquationChanAndVeseInternalTerm<InputImageType, LevelSetContainerType>;
+using ChanAndVeseExternalTermType = itk::LevelSetEquationChanAndVeseExternalTerm<InputImageType, LevelSetContainerType>;
+using CurvatureTermType = itk::LevelSetEquationCurvatureTerm<InputImageType, LevelSetContainerType>;
+using TermContainerType = itk::LevelSetEquationTermContainer<InputImageType, LevelSetContainerType>;
+
+using EquationContainerType = itk::LevelSetEquationContainer<TermContainerType>;
+
+using LevelSetEvolutionType = itk::LevelSetEvolution<EquationContainerType, SparseLevelSetType>;
+
+using LevelSetOutputRealType = SparseLevelSetType::OutputRealType;
+using HeavisideFunctionBaseType =
+  itk::SinRegularizedHeavisideStepFunction<LevelSetOutputRealType, LevelSetOutputRealType>;
+
+using StoppingCriterionType = itk::LevelSetEvolutionNumberOfIterationsStoppingCriterion<LevelSetContainerType>;
+
+// Evolves the level set initialized from the binary image with a Chan and Vese
+// and a curvature term.
+SparseLevelSetType::Pointer
+Evolve(InputImageType *  input,
+       InputImageType *  binary,
+       unsigned int      numberOfIterations,
+       itk::ThreadIdType numberOfWorkUnits)
+{
+  auto adaptor = BinaryToSparseAdaptorType::New();
+  adaptor->SetInputImage(binary);
+  adaptor->Initialize();
+
+  const SparseLevelSetType::Pointer levelSet = adaptor->GetModifiableLevelSet();
+
+  auto heaviside = HeavisideFunctionBaseType::New();
+  heaviside->SetEpsilon(1.0);
+
+  auto levelSetContainer = LevelSetContainerType::New();
+  levelSetContainer->SetHeaviside(heaviside);
+  levelSetContainer->AddLevelSet(0, levelSet, false);
+
+  auto cvInternalTerm = ChanAndVeseInternalTermType::New();
+  cvInternalTerm->SetInput(input);
+  cvInternalTerm->SetCoefficient(1.0);
+
+  auto cvExternalTerm = ChanAndVeseExternalTermType::New();
+  cvExternalTerm->SetInput(input);
+  cvExternalTerm->SetCoefficient(1.0);
+
+  auto curvatureTerm = CurvatureTermType::New();
+  curvatureTerm->SetInput(input);
+  curvatureTerm->SetCoefficient(1.0);
+
+  auto termContainer = TermContainerType::New();
+  termContainer->SetInput(input);
+  termContainer->SetCurrentLevelSetId(0);
+  termContainer->SetLevelSetContainer(levelSetContainer);
+  termContainer->AddTerm(0, cvInternalTerm);
+  termContainer->AddTerm(1, cvExternalTerm);
+  termContainer->AddTerm(2, curvatureTerm);
+
+  auto equationContainer = EquationContainerType::New();
+  equationContainer->AddEquation(0, termContainer);
+  equationContainer->SetLevelSetContainer(levelSetContainer);
+
+  auto criterion = StoppingCriterionType::New();
+  criterion->SetNumberOfIterations(numberOfIterations);
+
+  auto evolution = LevelSetEvolutionType::New();
+  evolution->SetEquationContainer(equationContainer);
+  evolution->SetStoppingCriterion(criterion);
+  evolution->SetLevelSetContainer(levelSetContainer);
+  evolution->SetNumberOfWorkUnits(numberOfWorkUnits);
+  evolution->Update();
+
+  return levelSet;
+}
+} // namespace
+
+// Checks that the layers of a Whitaker sparse level set evolved with several
+// work units, whose changes are then computed in parallel, are the same as
+// with a single work unit. The times of both evolutions are reported.
+int
+itkUpdateWhitakerSparseLevelSetTest(int, char *[])
+{
+  using UpdateLevelSetType = itk::UpdateWhitakerSparseLevelSet<Dimension, PixelType, EquationContainerType>;
+  auto updateLevelSet = UpdateLevelSetType::New();
+
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(updateLevelSet, UpdateWhitakerSparseLevelSet, Object);
+
+  constexpr itk::ThreadIdType numberOfWorkUnits = 4;
+  updateLevelSet->SetNumberOfWorkUnits(numberOfWorkUnits);
+  ITK_TEST_SET_GET_VALUE(numberOfWorkUnits, updateLevelSet->GetNumberOfWorkUnits());
+  updateLevelSet->SetNumberOfWorkUnits(0);
+  ITK_TEST_SET_GET_VALUE(1u, updateLevelSet->GetNumberOfWorkUnits());
+
+  // A bright ellipsoid on a textured background.
+  const InputImageType::RegionType region(InputImageType::SizeType{ { 40, 40, 40 } });
+
+  auto input = InputImageType::New();
+  input->SetRegions(region);
+  input->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<InputImageType> it(input, region); !it.IsAtEnd(); ++it)
+  {
+    const InputImageType::IndexType index = it.GetIndex();
+
+    const double x = (index[0] - 19.5) / 14.0;
+    const double y = (index[1] - 19.5) / 11.0;
+    const double z = (index[2] - 19.5) / 9.0;
+    const auto   texture = static_cast<InputPixelType>((7 * index[0] + 13 * index[1] + 3 * index[2]) % 17);
+    it.Set(static_cast<InputPixelType>((x * x + y * y + z * z < 1.0 ? 200 : 20) + texture));
+  }
+
+  // The layers of the initial box hold several thousand nodes, more than a
+  // single block of the parallel analysis.
+  auto binary = InputImageType::New();
+  binary->SetRegions(region);
+  binary->Allocate();
+  binary->FillBuffer(0);
+  const InputImageType::RegionType boxRegion(InputImageType::IndexType{ { 8, 8, 8 } },
+                                             InputImageType::SizeType{ { 24, 24, 24 } });
+  for (itk::ImageRegionIterator<InputImageType> it(binary, boxRegion); !it.IsAtEnd(); ++it)
+  {
+    it.Set(1);
+  }
+
+  constexpr unsigned int numberOfIterations = 5;
+
+  itk::TimeProbe serialProbe;
+  serialProbe.Start();
+  const SparseLevelSetType::Pointer serialLevelSet = Evolve(input, binary, numberOfIterations, 1);
+  serialProbe.Stop();
+
+  itk::TimeProbe parallelProbe;
+  parallelProbe.Start();
+  const SparseLevelSetType::Pointer parallelLevelSet = Evolve(input, binary, numberOfIterations, numberOfWorkUnits);
+  parallelProbe.Stop();
+
+  std::cout << "Evolution with 1 work unit: " << serialProbe.GetTotal() << serialProbe.GetUnit() << std::endl;
+  std::cout << "Evolution with " << numberOfWorkUnits << " work units: " << parallelProbe.GetTotal()
+            << parallelProbe.GetUnit() << std::endl;
+
+  ITK_TEST_EXPECT_TRUE(serialLevelSet->GetLayer(SparseLevelSetType::ZeroLayer()).size() > 2048);
+
+  for (SparseLevelSetType::LayerIdType layerId = SparseLevelSetType::MinusTwoLayer();
+       layerId <= SparseLevelSetType::PlusTwoLayer();
+       ++layerId)
+  {
+    if (serialLevelSet->GetLayer(layerId) != parallelLevelSet->GetLayer(layerId))
+    {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Error in layer " << static_cast<int>(layerId) << ": the nodes or their values differ."
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  for (itk::ImageRegionConstIteratorWithIndex<InputImageType> it(input, region); !it.IsAtEnd(); ++it)
+  {
+    if (serialLevelSet->Status(it.GetIndex()) != parallelLevelSet->Status(it.GetIndex()))
+    {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Error in status at " << it.GetIndex() << ": expected "
+                << static_cast<int>(serialLevelSet->Status(it.GetIndex())) << ", but got "
+                << static_cast<int>(parallelLevelSet->Status(it.GetIndex())) << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -19,6 +19,9 @@
 #define itkMorphologicalWatershedFromMarkersImageFilter_h
 
 #include "itkImageToImageFilter.h"
+#include <map>
+#include <queue>
+#include <vector>
 
 namespace itk
 {
@@ -61,6 +64,15 @@ namespace itk
  * the markers. The labels of the output image are the label of the marker
  * image.
  *
+ * The pixels are flooded in the order given by a hierarchical queue. Images
+ * of integer pixel type whose values span at most 65536 gray levels use a
+ * bucket queue with one FIFO per gray level. Other images use an ordered
+ * map of FIFOs, unless NumberOfQuantizationLevels is set, in which case the
+ * values are quantized to that number of levels and flooded with the bucket
+ * queue. The quantized flooding is faster for real valued images, but pixels
+ * whose values fall in the same level are flooded as if they had the same
+ * value.
+ *
  * The morphological watershed transform algorithm is described in
  * Chapter 9.2 of Pierre Soille's book "Morphological Image Analysis:
  * Principles and Applications", Second Edition, Springer, 2003.
@@ -161,6 +173,14 @@ public:
   itkGetConstReferenceMacro(MarkWatershedLine, bool);
   itkBooleanMacro(MarkWatershedLine);
 
+  /**
+   * Set/Get the number of levels the input values are quantized to when
+   * they cannot be flooded exactly with the bucket queue. Default is 0, which
+   * floods the exact values.
+   */
+  itkSetMacro(NumberOfQuantizationLevels, SizeValueType);
+  itkGetConstReferenceMacro(NumberOfQuantizationLevels, SizeValueType);
+
 protected:
   MorphologicalWatershedFromMarkersImageFilter();
   ~MorphologicalWatershedFromMarkersImageFilter() override = default;
@@ -184,9 +204,146 @@ protected:
   GenerateData() override;
 
 private:
+  /** Hierarchical queue of pixel indices ordered by gray value in an ordered
+   * map. The pixels pushed with a value lower than the one of the last front
+   * pixel are pushed at the current level. */
+  class MapHierarchicalQueue
+  {
+  public:
+    void
+    Push(const InputImagePixelType & value, const IndexType & index)
+    {
+      if (m_Flooding && !(m_Current->first < value))
+      {
+        m_Current->second.push(index);
+      }
+      else
+      {
+        m_Levels[value].push(index);
+      }
+      ++m_Size;
+    }
+
+    bool
+    Empty() const
+    {
+      return m_Size == 0;
+    }
+
+    const IndexType &
+    Front()
+    {
+      if (!m_Flooding)
+      {
+        m_Current = m_Levels.begin();
+        m_Flooding = true;
+      }
+      // the exhausted levels are only removed here, so that a level which is
+      // refilled while its last pixel is processed is not reallocated
+      while (m_Current->second.empty())
+      {
+        m_Current = m_Levels.erase(m_Current);
+      }
+      return m_Current->second.front();
+    }
+
+    void
+    Pop()
+    {
+      m_Current->second.pop();
+      --m_Size;
+    }
+
+  private:
+    using LevelMapType = std::map<InputImagePixelType, std::queue<IndexType>>;
+
+    LevelMapType                    m_Levels{};
+    typename LevelMapType::iterator m_Current{};
+    SizeValueType                   m_Size{ 0 };
+    bool                            m_Flooding{ false };
+  };
+
+  /** Hierarchical queue of pixel indices with one FIFO per level, where the
+   * level of a value is floor((value - minimum) * scale). The pixels pushed
+   * with a level lower than the one of the last front pixel are pushed at the
+   * current level. */
+  class BucketHierarchicalQueue
+  {
+  public:
+    BucketHierarchicalQueue(double minimum, double scale, SizeValueType numberOfLevels)
+      : m_Minimum(minimum)
+      , m_Scale(scale)
+      , m_Levels(numberOfLevels)
+      , m_Current(numberOfLevels)
+    {}
+
+    void
+    Push(const InputImagePixelType & value, const IndexType & index)
+    {
+      auto level = static_cast<SizeValueType>((static_cast<double>(value) - m_Minimum) * m_Scale);
+      level = std::min(level, static_cast<SizeValueType>(m_Levels.size() - 1));
+      if (level < m_Current)
+      {
+        if (m_Flooding)
+        {
+          level = m_Current;
+        }
+        else
+        {
+          m_Current = level;
+        }
+      }
+      m_Levels[level].push_back(index);
+      ++m_Size;
+    }
+
+    bool
+    Empty() const
+    {
+      return m_Size == 0;
+    }
+
+    const IndexType &
+    Front()
+    {
+      m_Flooding = true;
+      while (m_Head == m_Levels[m_Current].size())
+      {
+        // release the memory of the exhausted level
+        std::vector<IndexType>().swap(m_Levels[m_Current]);
+        ++m_Current;
+        m_Head = 0;
+      }
+      return m_Levels[m_Current][m_Head];
+    }
+
+    void
+    Pop()
+    {
+      ++m_Head;
+      --m_Size;
+    }
+
+  private:
+    double                              m_Minimum;
+    double                              m_Scale;
+    std::vector<std::vector<IndexType>> m_Levels;
+    SizeValueType                       m_Current;
+    SizeValueType                       m_Head{ 0 };
+    SizeValueType                       m_Size{ 0 };
+    bool                                m_Flooding{ false };
+  };
+
+  /** Runs the algorithm of Meyer or Beucher with the given queue. */
+  template <typename THierarchicalQueue>
+  void
+  Flood(THierarchicalQueue & fah);
+
   bool m_FullyConnected{ false };
 
   bool m_MarkWatershedLine{ true };
+
+  SizeValueType m_NumberOfQuantizationLevels{ 0 };
 }; // end of class
 } // end namespace itk
 
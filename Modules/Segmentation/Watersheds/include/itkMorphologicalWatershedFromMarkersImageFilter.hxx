@@ -23,6 +23,7 @@
 #include <list>
 #include "itkProgressReporter.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
 #include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkConstShapedNeighborhoodIterator.h"
 #include "itkConstantBoundaryCondition.h"
@@ -78,6 +79,60 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::EnlargeO
 template <typename TInputImage, typename TLabelImage>
 void
 MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::GenerateData()
+{
+  this->AllocateOutputs();
+
+  const LabelImageType * markerImage = this->GetMarkerImage();
+  const InputImageType * inputImage = this->GetInput();
+
+  // mask and marker must have the same size
+  if (markerImage->GetRequestedRegion().GetSize() != inputImage->GetRequestedRegion().GetSize())
+  {
+    itkExceptionMacro("Marker and input must have the same size.");
+  }
+
+  // FAH (in french: File d'Attente Hierarchique)
+  // Integer images of at most 65536 gray levels are flooded with a bucket
+  // queue, which keeps one FIFO per gray level and returns the pixels in the
+  // same order as the ordered map. Other images use the map, unless the user
+  // accepts to quantize the values.
+  constexpr SizeValueType maximumNumberOfExactLevels = SizeValueType{ 1 } << 16;
+  const SizeValueType     numberOfPixels = inputImage->GetRequestedRegion().GetNumberOfPixels();
+  InputImagePixelType minimum = NumericTraits<InputImagePixelType>::max();
+  InputImagePixelType maximum = NumericTraits<InputImagePixelType>::NonpositiveMin();
+  for (ImageRegionConstIterator<InputImageType> it(inputImage, inputImage->GetRequestedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const InputImagePixelType value = it.Get();
+    minimum = std::min(minimum, value);
+    maximum = std::max(maximum, value);
+  }
+  const double range = numberOfPixels > 0 ? static_cast<double>(maximum) - static_cast<double>(minimum) : 0.0;
+
+  if (std::is_integral_v<InputImagePixelType> && range < static_cast<double>(maximumNumberOfExactLevels))
+  {
+    itkDebugMacro("Flooding with " << range + 1 << " exact levels.");
+    BucketHierarchicalQueue fah(static_cast<double>(minimum), 1.0, static_cast<SizeValueType>(range) + 1);
+    this->Flood(fah);
+  }
+  else if (m_NumberOfQuantizationLevels > 0)
+  {
+    itkDebugMacro("Flooding with " << m_NumberOfQuantizationLevels << " quantized levels.");
+    const double scale = range > 0.0 ? (m_NumberOfQuantizationLevels - 1) / range : 0.0;
+    BucketHierarchicalQueue fah(static_cast<double>(minimum), scale, m_NumberOfQuantizationLevels);
+    this->Flood(fah);
+  }
+  else
+  {
+    MapHierarchicalQueue fah;
+    this->Flood(fah);
+  }
+}
+
+
+template <typename TInputImage, typename TLabelImage>
+template <typename THierarchicalQueue>
+void
+MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::Flood(THierarchicalQueue & fah)
 {
   // there is 2 possible cases: with or without watershed lines.
   // the algorithm with watershed lines is from Meyer
@@ -86,8 +141,7 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::Generate
 
   //---------------------------------------------------------------------------
   // declare the vars common to the 2 algorithms: constants, iterators,
-  // hierarchical queue, progress reporter, and status image
-  // also allocate output images and verify preconditions
+  // progress reporter, and status image
   //---------------------------------------------------------------------------
 
   // the label used to find background in the marker image
@@ -95,8 +149,6 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::Generate
   // the label used to mark the watershed line in the output image
   static const LabelImagePixelType wsLabel{};
 
-  this->AllocateOutputs();
-
   const LabelImageType * markerImage = this->GetMarkerImage();
   const InputImageType * inputImage = this->GetInput();
   LabelImageType *       outputImage = this->GetOutput();
@@ -106,17 +158,6 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::Generate
   // use the maximum number possible.
   ProgressReporter progress(this, 0, markerImage->GetRequestedRegion().GetNumberOfPixels() * 2);
 
-  // mask and marker must have the same size
-  if (markerImage->GetRequestedRegion().GetSize() != inputImage->GetRequestedRegion().GetSize())
-  {
-    itkExceptionMacro("Marker and input must have the same size.");
-  }
-
-  // FAH (in french: File d'Attente Hierarchique)
-  using QueueType = std::queue<IndexType>;
-  using MapType = std::map<InputImagePixelType, QueueType>;
-  MapType fah;
-
   // the radius which will be used for all the shaped iterators
   constexpr auto radius = Size<ImageDimension>::Filled(1);
 
@@ -213,7 +254,7 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::Generate
           {
             // this neighbor is a background pixel and is not already
             // processed; add its index to fah
-            fah[niIt.Get()].push(markerIt.GetIndex() + nmIt.GetNeighborhoodOffset());
+            fah.Push(niIt.Get(), markerIt.GetIndex() + nmIt.GetNeighborhoodOffset());
             // mark it as already in the fah to avoid adding it several times
             nsIt.Set(true);
           }
@@ -243,70 +284,55 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::Generate
     inputIt.GoToBegin();
 
     // and start flooding
-    while (!fah.empty())
+    // the pixels lower than the current level are pushed to the current level
+    // by the queue
+    while (!fah.Empty())
     {
-      // store the current vars
-      const InputImagePixelType currentValue = fah.begin()->first;
-      QueueType                 currentQueue = fah.begin()->second;
-      // and remove them from the fah
-      fah.erase(fah.begin());
-
-      while (!currentQueue.empty())
+      const IndexType idx = fah.Front();
+      fah.Pop();
+
+      // move the iterators to the right place
+      const OffsetType shift = idx - outputIt.GetIndex();
+      outputIt += shift;
+      statusIt += shift;
+      inputIt += shift;
+
+      // iterate over the neighbors. If there is only one marker value, give
+      // that value to the pixel, else keep it as is (watershed line)
+      LabelImagePixelType marker = wsLabel;
+      bool                collision = false;
+      for (noIt = outputIt.Begin(); noIt != outputIt.End(); ++noIt)
       {
-        const IndexType idx = currentQueue.front();
-        currentQueue.pop();
-
-        // move the iterators to the right place
-        const OffsetType shift = idx - outputIt.GetIndex();
-        outputIt += shift;
-        statusIt += shift;
-        inputIt += shift;
-
-        // iterate over the neighbors. If there is only one marker value, give
-        // that value to the pixel, else keep it as is (watershed line)
-        LabelImagePixelType marker = wsLabel;
-        bool                collision = false;
-        for (noIt = outputIt.Begin(); noIt != outputIt.End(); ++noIt)
+        const LabelImagePixelType o = noIt.Get();
+        if (o != wsLabel)
         {
-          const LabelImagePixelType o = noIt.Get();
-          if (o != wsLabel)
+          if (marker != wsLabel && o != marker)
           {
-            if (marker != wsLabel && o != marker)
-            {
-              collision = true;
-              break;
-            }
-
-            marker = o;
+            collision = true;
+            break;
           }
+
+          marker = o;
         }
-        if (!collision)
+      }
+      if (!collision)
+      {
+        // set the marker value
+        outputIt.SetCenterPixel(marker);
+        // and propagate to the neighbors
+        for (niIt = inputIt.Begin(), nsIt = statusIt.Begin(); niIt != inputIt.End(); ++niIt, ++nsIt)
         {
-          // set the marker value
-          outputIt.SetCenterPixel(marker);
-          // and propagate to the neighbors
-          for (niIt = inputIt.Begin(), nsIt = statusIt.Begin(); niIt != inputIt.End(); ++niIt, ++nsIt)
+          if (!nsIt.Get())
           {
-            if (!nsIt.Get())
-            {
-              // the pixel is not yet processed. add it to the fah
-              const InputImagePixelType GrayVal = niIt.Get();
-              if (GrayVal <= currentValue)
-              {
-                currentQueue.push(inputIt.GetIndex() + niIt.GetNeighborhoodOffset());
-              }
-              else
-              {
-                fah[GrayVal].push(inputIt.GetIndex() + niIt.GetNeighborhoodOffset());
-              }
-              // mark it as already in the fah
-              nsIt.Set(true);
-            }
+            // the pixel is not yet processed. add it to the fah
+            fah.Push(niIt.Get(), inputIt.GetIndex() + niIt.GetNeighborhoodOffset());
+            // mark it as already in the fah
+            nsIt.Set(true);
           }
         }
-        // one more pixel in the flooding stage
-        progress.CompletedPixel();
       }
+      // one more pixel in the flooding stage
+      progress.CompletedPixel();
     }
   }
 
@@ -351,7 +377,7 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::Generate
         if (haveBgNeighbor)
         {
           // there is a background pixel in the neighborhood; add to fah
-          fah[inputIt.GetCenterPixel()].push(markerIt.GetIndex());
+          fah.Push(inputIt.GetCenterPixel(), markerIt.GetIndex());
         }
         else
         {
@@ -374,45 +400,30 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::Generate
     inputIt.GoToBegin();
 
     // and start flooding
-    while (!fah.empty())
+    // the pixels lower than the current level are pushed to the current level
+    // by the queue
+    while (!fah.Empty())
     {
-      // store the current vars
-      const InputImagePixelType currentValue = fah.begin()->first;
-      QueueType                 currentQueue = fah.begin()->second;
-      // and remove them from the fah
-      fah.erase(fah.begin());
-
-      while (!currentQueue.empty())
+      const IndexType idx = fah.Front();
+      fah.Pop();
+
+      // move the iterators to the right place
+      const OffsetType shift = idx - outputIt.GetIndex();
+      outputIt += shift;
+      inputIt += shift;
+
+      const LabelImagePixelType currentMarker = outputIt.GetCenterPixel();
+      // get the current value of the pixel
+      // iterate over neighbors to propagate the marker
+      for (noIt = outputIt.Begin(), niIt = inputIt.Begin(); noIt != outputIt.End(); ++noIt, ++niIt)
       {
-        const IndexType idx = currentQueue.front();
-        currentQueue.pop();
-
-        // move the iterators to the right place
-        const OffsetType shift = idx - outputIt.GetIndex();
-        outputIt += shift;
-        inputIt += shift;
-
-        const LabelImagePixelType currentMarker = outputIt.GetCenterPixel();
-        // get the current value of the pixel
-        // iterate over neighbors to propagate the marker
-        for (noIt = outputIt.Begin(), niIt = inputIt.Begin(); noIt != outputIt.End(); ++noIt, ++niIt)
+        if (noIt.Get() == wsLabel)
         {
-          if (noIt.Get() == wsLabel)
-          {
-            // the pixel is not yet processed. It can be labeled with the
-            // current label
-            noIt.Set(currentMarker);
-            const InputImagePixelType GrayVal = niIt.Get();
-            if (GrayVal <= currentValue)
-            {
-              currentQueue.push(inputIt.GetIndex() + noIt.GetNeighborhoodOffset());
-            }
-            else
-            {
-              fah[GrayVal].push(inputIt.GetIndex() + noIt.GetNeighborhoodOffset());
-            }
-            progress.CompletedPixel();
-          }
+          // the pixel is not yet processed. It can be labeled with the
+          // current label
+          noIt.Set(currentMarker);
+          fah.Push(niIt.Get(), inputIt.GetIndex() + noIt.GetNeighborhoodOffset());
+          progress.CompletedPixel();
         }
       }
     }
@@ -429,6 +440,7 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::PrintSel
 
   itkPrintSelfBooleanMacro(FullyConnected);
   os << indent << "MarkWatershedLine: " << m_MarkWatershedLine << std::endl;
+  os << indent << "NumberOfQuantizationLevels: " << m_NumberOfQuantizationLevels << std::endl;
 }
 
 } // end namespace itk
@@ -0,0 +1,142 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMorphologicalWatershedFromMarkersImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using LabelImageType = itk::Image<unsigned short, Dimension>;
+using IndexType = LabelImageType::IndexType;
+
+// Gray levels with many plateaus, so that the result depends on the order in
+// which the pixels of a level are flooded.
+template <typename TImage>
+typename TImage::Pointer
+MakeInput(double scale)
+{
+  auto image = TImage::New();
+  image->SetRegions(typename TImage::SizeType{ { 31, 27, 13 } });
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    const IndexType & index = it.GetIndex();
+    const auto        value = (index[0] * index[0] + 3 * index[1] * index[2] + 7 * index[0] * index[1]) % 256;
+    it.Set(static_cast<typename TImage::PixelType>(value * scale));
+  }
+  image->SetPixel({ { 0, 0, 0 } }, 0);
+  image->SetPixel({ { 30, 26, 12 } }, static_cast<typename TImage::PixelType>(255 * scale));
+  return image;
+}
+
+LabelImageType::Pointer
+MakeMarkers()
+{
+  auto markers = LabelImageType::New();
+  markers->SetRegions(LabelImageType::SizeType{ { 31, 27, 13 } });
+  markers->AllocateInitialized();
+  markers->SetPixel({ { 2, 3, 1 } }, 1);
+  markers->SetPixel({ { 25, 4, 6 } }, 2);
+  markers->SetPixel({ { 15, 20, 11 } }, 3);
+  markers->SetPixel({ { 16, 20, 11 } }, 3);
+  markers->SetPixel({ { 7, 24, 2 } }, 4);
+  return markers;
+}
+
+template <typename TImage>
+LabelImageType::Pointer
+Flood(const TImage * input, bool markWatershedLine, bool fullyConnected, itk::SizeValueType numberOfLevels = 0)
+{
+  auto filter = itk::MorphologicalWatershedFromMarkersImageFilter<TImage, LabelImageType>::New();
+  filter->SetInput(input);
+  filter->SetMarkerImage(MakeMarkers());
+  filter->SetMarkWatershedLine(markWatershedLine);
+  filter->SetFullyConnected(fullyConnected);
+  filter->SetNumberOfQuantizationLevels(numberOfLevels);
+  filter->Update();
+  return filter->GetOutput();
+}
+
+bool
+AreEqual(const LabelImageType * image, const LabelImageType * baseline, const char * description)
+{
+  itk::ImageRegionConstIterator<LabelImageType> it(image, image->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<LabelImageType> bit(baseline, baseline->GetLargestPossibleRegion());
+  for (; !it.IsAtEnd(); ++it, ++bit)
+  {
+    if (it.Get() != bit.Get())
+    {
+      std::cerr << description << ": labels differ: " << it.Get() << " != " << bit.Get() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkMorphologicalWatershedFromMarkersImageFilterQueueTest(int, char *[])
+{
+  using CharImageType = itk::Image<unsigned char, Dimension>;
+  using IntImageType = itk::Image<int, Dimension>;
+  using FloatImageType = itk::Image<float, Dimension>;
+
+  auto filter = itk::MorphologicalWatershedFromMarkersImageFilter<FloatImageType, LabelImageType>::New();
+  ITK_TEST_SET_GET_VALUE(itk::SizeValueType{ 0 }, filter->GetNumberOfQuantizationLevels());
+  filter->SetNumberOfQuantizationLevels(256);
+  ITK_TEST_SET_GET_VALUE(itk::SizeValueType{ 256 }, filter->GetNumberOfQuantizationLevels());
+
+  const auto charInput = MakeInput<CharImageType>(1.0);
+  const auto intInput = MakeInput<IntImageType>(100000.0);
+  const auto floatInput = MakeInput<FloatImageType>(1.0);
+
+  bool success = true;
+  for (const bool markWatershedLine : { false, true })
+  {
+    for (const bool fullyConnected : { false, true })
+    {
+      std::cout << "MarkWatershedLine " << markWatershedLine << ", FullyConnected " << fullyConnected << std::endl;
+
+      // The real valued image is flooded with the ordered map.
+      const auto baseline = Flood(floatInput.GetPointer(), markWatershedLine, fullyConnected);
+
+      // Bucket queue with exact levels.
+      success &= AreEqual(Flood(charInput.GetPointer(), markWatershedLine, fullyConnected), baseline, "unsigned char");
+
+      // The range is too large for the bucket queue, unless the values are quantized.
+      success &= AreEqual(Flood(intInput.GetPointer(), markWatershedLine, fullyConnected), baseline, "int");
+      success &= AreEqual(
+        Flood(intInput.GetPointer(), markWatershedLine, fullyConnected, 256), baseline, "quantized int");
+
+      // The quantized levels match the integer values of the real image.
+      success &= AreEqual(
+        Flood(floatInput.GetPointer(), markWatershedLine, fullyConnected, 256), baseline, "quantized float");
+    }
+  }
+
+  if (!success)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}